@@ -19,7 +19,8 @@ namespace scene
 		EAC_BOX = 1,
 		EAC_FRUSTUM_BOX = 2,
 		EAC_FRUSTUM_SPHERE = 4,
-		EAC_OCC_QUERY = 8
+		EAC_OCC_QUERY = 8,
+		EAC_OCC_SOFTWARE = 16
 	};
 
 	//! Names for culling type
@@ -30,6 +31,7 @@ namespace scene
 		"frustum_box",		// camera frustum against node box
 		"frustum_sphere",	// camera frustum against node sphere
 		"occ_query",		// occlusion query
+		"occ_software",		// depth buffer of the occlusion culler
 		0
 	};
 
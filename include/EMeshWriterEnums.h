@@ -40,7 +40,10 @@ namespace scene
 		EMWT_FBX		= MAKE_IRR_ID('f', 'b', 'x', 0),
 
 		//! FBX mesh writer for .fbx mesh files
-		EMWT_GLTF		= MAKE_IRR_ID('g', 'l', 't', 'f', 0)
+		EMWT_GLTF		= MAKE_IRR_ID('g', 'l', 't', 'f', 0),
+
+		//! Irrlicht binary mesh writer for .irrbin files, used for fast loading mesh caches
+		EMWT_IRR_BINARY_MESH = MAKE_IRR_ID('i','r','b','n')
 	};
 
 
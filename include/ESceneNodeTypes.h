@@ -39,6 +39,9 @@ namespace scene
 		//! Terrain Scene Node
 		ESNT_TERRAIN        = MAKE_IRR_ID('t','e','r','r'),
 
+		//! Tiled Terrain Scene Node
+		ESNT_TILED_TERRAIN  = MAKE_IRR_ID('t','t','r','n'),
+
 		//! Sky Box Scene Node
 		ESNT_SKY_BOX        = MAKE_IRR_ID('s','k','y','_'),
 
@@ -54,6 +57,9 @@ namespace scene
 		//! Mesh Scene Node
 		ESNT_MESH           = MAKE_IRR_ID('m','e','s','h'),
 
+		//! Static Batch Scene Node
+		ESNT_STATIC_BATCH   = MAKE_IRR_ID('s','b','a','t'),
+
 		//! Light Scene Node
 		ESNT_LIGHT          = MAKE_IRR_ID('l','g','h','t'),
 
@@ -78,6 +84,9 @@ namespace scene
 		//! Quake3 Shader Scene Node
 		ESNT_Q3SHADER_SCENE_NODE  = MAKE_IRR_ID('q','3','s','h'),
 
+		//! Quake3 Level Scene Node, culls with the potentially visible set
+		ESNT_Q3_LEVEL       = MAKE_IRR_ID('q','3','l','v'),
+
 		//! Quake3 Model Scene Node ( has tag to link to )
 		ESNT_MD3_SCENE_NODE  = MAKE_IRR_ID('m','d','3','_'),
 
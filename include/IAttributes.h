@@ -37,6 +37,25 @@ namespace video
 namespace io
 {
 
+//! Pre-resolved reference to a named attribute.
+/** Created with IAttributes::getAttributeHandle(). Reading through a handle
+skips the name lookup as long as the attribute collection was not changed
+since the handle was last resolved. Otherwise the name is looked up again
+and the handle is updated. */
+struct SAttributeHandle
+{
+	SAttributeHandle() : Index(-1), Generation(0) {}
+
+	//! Name of the referenced attribute
+	core::stringc Name;
+
+	//! Cached attribute index, -1 if the attribute was not found
+	mutable s32 Index;
+
+	//! Layout generation of the attributes at the time Index was resolved
+	mutable u32 Generation;
+};
+
 //! Provides a generic interface for attributes and their values and the possibility to serialize them
 class IAttributes : public virtual IReferenceCounted
 {
@@ -73,6 +92,17 @@ public:
 	//! Returns attribute index from name, -1 if not found
 	virtual s32 findAttribute(const c8* attributeName) const = 0;
 
+	//! Returns a handle for faster repeated access to an attribute
+	/** The attribute does not have to exist yet, the handle resolves it
+	once it was added.
+	\param attributeName: Name of the attribute. */
+	virtual SAttributeHandle getAttributeHandle(const c8* attributeName) const = 0;
+
+	//! Returns attribute index from a handle, -1 if not found
+	/** Only looks up the name again when attributes were added or removed
+	since the handle was resolved the last time. */
+	virtual s32 findAttribute(const SAttributeHandle& handle) const = 0;
+
 	//! Removes all attributes
 	virtual void clear() = 0;
 
@@ -113,6 +143,11 @@ public:
 	//! \param index: Index value, must be between 0 and getAttributeCount()-1.
 	virtual s32 getAttributeAsInt(s32 index) const = 0;
 
+	//! Gets an attribute as integer value
+	//! \param handle: Handle created with getAttributeHandle().
+	//! \param defaultNotFound Value returned when the attribute was not found
+	virtual s32 getAttributeAsInt(const SAttributeHandle& handle, irr::s32 defaultNotFound=0) const = 0;
+
 	//! Sets an attribute as integer value
 	virtual void setAttribute(s32 index, s32 value) = 0;
 
@@ -138,6 +173,11 @@ public:
 	//! \param index: Index value, must be between 0 and getAttributeCount()-1.
 	virtual f32 getAttributeAsFloat(s32 index) const = 0;
 
+	//! Gets an attribute as float value
+	//! \param handle: Handle created with getAttributeHandle().
+	//! \param defaultNotFound Value returned when the attribute was not found
+	virtual f32 getAttributeAsFloat(const SAttributeHandle& handle, irr::f32 defaultNotFound=0.f) const = 0;
+
 	//! Sets an attribute as float value
 	virtual void setAttribute(s32 index, f32 value) = 0;
 
@@ -286,6 +326,11 @@ public:
 	//! \param index: Index value, must be between 0 and getAttributeCount()-1.
 	virtual bool getAttributeAsBool(s32 index) const = 0;
 
+	//! Gets an attribute as boolean value
+	//! \param handle: Handle created with getAttributeHandle().
+	//! \param defaultNotFound Value returned when the attribute was not found
+	virtual bool getAttributeAsBool(const SAttributeHandle& handle, bool defaultNotFound=false) const = 0;
+
 	//! Sets an attribute as boolean value
 	virtual void setAttribute(s32 index, bool value) = 0;
 
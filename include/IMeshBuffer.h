@@ -176,6 +176,40 @@ namespace scene
 			return 0;
 		}
 
+		//! Set the hardware buffer link of the video driver
+		/** Only used by the video driver, to find the hardware buffer of this
+		meshbuffer without a search. The link is not copied with the meshbuffer.
+		The link grabs the meshbuffer, so a meshbuffer is never destroyed while
+		a driver still has a link to it, and nothing has to be removed on
+		destruction. IVideoDriver::removeHardwareBuffer() releases the link
+		earlier, otherwise the driver releases it after a long time unused.
+		\param link Driver specific link, or 0 when the link was removed. */
+		void setHWBufferLink(void* link) const
+		{
+			HWBufferLink = link;
+		}
+
+		//! Get the hardware buffer link set by the video driver
+		/** \return Driver specific link, or 0 if there is none. */
+		void* getHWBufferLink() const
+		{
+			return HWBufferLink;
+		}
+
+	protected:
+
+		IMeshBuffer() : HWBufferLink(0) {}
+
+		IMeshBuffer(const IMeshBuffer&) : IReferenceCounted(), HWBufferLink(0) {}
+
+		IMeshBuffer& operator=(const IMeshBuffer&)
+		{
+			return *this;
+		}
+
+	private:
+
+		mutable void* HWBufferLink;
 	};
 
 } // end namespace scene
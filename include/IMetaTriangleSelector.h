@@ -16,6 +16,10 @@ namespace scene
 /** This is nothing more than a collection of one or more triangle selectors
 providing together the interface of one triangle selector. In this way,
 collision tests can be done with different triangle soups in one pass.
+Box and line queries only ask the selectors whose bounding box (see
+ITriangleSelector::getBoundingBox()) is close to the queried box, so many
+selectors, for example one for each character in a level, can be put into
+one meta selector.
 */
 class IMetaTriangleSelector : public ITriangleSelector
 {
@@ -0,0 +1,91 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_OCCLUSION_CULLER_H_INCLUDED__
+#define __I_OCCLUSION_CULLER_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+#include "aabbox3d.h"
+#include "dimension2d.h"
+
+namespace irr
+{
+namespace scene
+{
+	class ISceneNode;
+	class ICameraSceneNode;
+	class IMesh;
+
+	//! Hides scene nodes behind occluders using a depth buffer rendered on the CPU.
+	/** The triangles of all occluders are rasterized into a small depth
+	buffer once per frame, from which a pyramid of the nearest and
+	farthest depth of each 2x2 block is built. Nodes with
+	EAC_OCC_SOFTWARE in their automatic culling state are culled when
+	their bounding box is behind the depth buffer. This works with all
+	drivers, including the null driver, and does not depend on results of
+	the last frame like hardware occlusion queries do.
+
+	Occluders should be large and have few triangles, like walls,
+	buildings or terrain. Use simplified meshes which are completely
+	inside of the visible geometry, otherwise nodes which can still be
+	seen may be culled.
+	The occlusion culler is updated by ISceneManager::drawAll() with the
+	active camera. */
+	class IOcclusionCuller : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Adds a scene node whose geometry hides nodes behind it.
+		/** The triangles are copied, the occluder follows the absolute
+		transformation of the node. Invisible nodes don't occlude. Nodes
+		which were removed from the scene are released by the next update().
+		\param node Scene node which is the occluder.
+		\param mesh Geometry of the occluder in the space of the node.
+		If 0, the mesh of a mesh, octree or animated mesh scene node is
+		used.
+		\return True if the occluder was added. */
+		virtual bool addOccluder(ISceneNode* node, IMesh* mesh=0) = 0;
+
+		//! Removes all occluders of a scene node.
+		virtual void removeOccluder(ISceneNode* node) = 0;
+
+		//! Removes all occluders.
+		virtual void removeAllOccluders() = 0;
+
+		//! Returns the number of occluders.
+		virtual u32 getOccluderCount() const = 0;
+
+		//! Sets the size of the depth buffer.
+		/** Default is 256x128. Larger buffers cull more precisely but
+		need more time to render. */
+		virtual void setResolution(const core::dimension2du& size) = 0;
+
+		//! Returns the size of the depth buffer.
+		virtual const core::dimension2du& getResolution() const = 0;
+
+		//! Renders the occluders as seen by a camera.
+		/** Called by ISceneManager::drawAll() before the nodes are
+		registered for rendering. Resets the counters. */
+		virtual void update(const ICameraSceneNode* camera) = 0;
+
+		//! Checks if a box is hidden by the occluders.
+		/** \param box Box in world space.
+		\return True if the box is completely behind the occluders
+		rendered by the last update. */
+		virtual bool isOccluded(const core::aabbox3df& box) const = 0;
+
+		//! Returns how many boxes were tested since the last update.
+		virtual u32 getTestedCount() const = 0;
+
+		//! Returns how many boxes were occluded since the last update.
+		virtual u32 getOccludedCount() const = 0;
+
+		//! Returns how many occluder triangles were rasterized by the last update.
+		virtual u32 getRasterizedTriangleCount() const = 0;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
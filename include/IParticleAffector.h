@@ -51,6 +51,24 @@ public:
 	\param count Amount of particles in array. */
 	virtual void affect(u32 now, SParticle* particlearray, u32 count) = 0;
 
+	//! Prepares affecting particles stored as structure of arrays.
+	/** The particle system calls this once per update before calling
+	affectBlock for all blocks of particles. Per update state, like the time
+	since the last update, should be calculated here.
+	\param now Current time. (Same as ITimer::getTime() would return)
+	\return True if the affector implements affectBlock. Otherwise
+	affect() is used, which is slower as the particles have to be copied. */
+	virtual bool beginAffect(u32 now) { return false; }
+
+	//! Affects a block of particles stored as structure of arrays.
+	/** Can be called for different blocks from several threads at once, so
+	it must only change the particles in the given range.
+	\param now Current time. (Same as ITimer::getTime() would return)
+	\param particles Arrays of all particles.
+	\param begin Index of the first particle to affect.
+	\param end Index behind the last particle to affect. */
+	virtual void affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end) {}
+
 	//! Sets whether or not the affector is currently enabled.
 	virtual void setEnabled(bool enabled) { Enabled = enabled; }
 
@@ -12,6 +12,39 @@ namespace irr
 {
 namespace scene
 {
+namespace quake3
+{
+	//! A leaf of the bsp tree of a Quake3 level.
+	struct SBSPLeaf
+	{
+		//! Visibility cluster of the leaf, -1 if the leaf is outside of the level
+		s32 Cluster;
+
+		//! Bounding box of the leaf in mesh coordinates
+		core::aabbox3df Box;
+
+		//! First face of the leaf in IQ3LevelMesh::getLeafFaces()
+		u32 FirstFace;
+
+		//! Number of faces of the leaf
+		u32 FaceCount;
+	};
+
+	//! Where the triangles of a face of the level are stored.
+	struct SBSPFaceIndices
+	{
+		//! Mesh buffer in the E_Q3_MESH_GEOMETRY mesh, -1 if the face is not part of that mesh
+		s32 MeshBuffer;
+
+		//! First index of the face in the mesh buffer
+		u32 FirstIndex;
+
+		//! Number of indices of the face
+		u32 IndexCount;
+	};
+
+} // end namespace quake3
+
 	//! Interface for a Mesh which can be loaded directly from a Quake3 .bsp-file.
 	/** The Mesh tries to load all textures of the map.*/
 	class IQ3LevelMesh : public IAnimatedMesh
@@ -37,6 +70,30 @@ namespace scene
 
 		//! returns the requested brush entity
 		virtual IMesh* getBrushEntityMesh(quake3::IEntity &ent) const = 0;
+
+		//! Returns the leafs of the bsp tree.
+		/** Empty if the level file has no bsp tree. */
+		virtual const core::array<quake3::SBSPLeaf>& getLeafs() const = 0;
+
+		//! Returns the faces of all leafs.
+		/** Each leaf references a range of this array, the entries are
+		indices into getFaceIndices(). A face can be part of several
+		leafs. */
+		virtual const core::array<u32>& getLeafFaces() const = 0;
+
+		//! Returns where the triangles of each face of the level are stored.
+		virtual const core::array<quake3::SBSPFaceIndices>& getFaceIndices() const = 0;
+
+		//! Returns the leaf which contains a position.
+		/** \param pos Position in mesh coordinates.
+		\return Index into getLeafs(), or -1 if there is no bsp tree. */
+		virtual s32 findLeaf(const core::vector3df& pos) const = 0;
+
+		//! Returns if a cluster is potentially visible from another cluster.
+		/** Uses the visibility data of the level. Always true if there is
+		no visibility data or if 'from' is -1, which is the case when the
+		camera is outside of the level. Always false if 'to' is -1. */
+		virtual bool isClusterVisible(s32 from, s32 to) const = 0;
 	};
 
 } // end namespace scene
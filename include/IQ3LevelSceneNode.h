@@ -0,0 +1,70 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+#define __I_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+	class IQ3LevelMesh;
+
+	//! A scene node which draws a Quake3 level using its potentially visible set.
+	/** Each frame the node finds the leaf of the bsp tree which contains
+	the active camera. Only faces of leafs whose visibility cluster can be
+	seen from the cluster of the camera and which are inside the view
+	frustum are drawn. The vertex buffers of the level stay static, only
+	the index buffers are updated when the visible faces change.
+
+	The node draws the E_Q3_MESH_GEOMETRY part of the level. Faces with
+	shaders are usually drawn by scene nodes created with
+	ISceneManager::addQuake3SceneNode(). */
+	class IQ3LevelSceneNode : public ISceneNode
+	{
+	public:
+
+		//! Constructor
+		IQ3LevelSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id)
+			: ISceneNode(parent, mgr, id) {}
+
+		//! Returns the level which is drawn by this node.
+		virtual IQ3LevelMesh* getLevelMesh() const = 0;
+
+		//! Enables or disables culling with the potentially visible set.
+		/** When disabled, faces are only culled by the view frustum.
+		Enabled by default. */
+		virtual void setPVSCulling(bool enable) = 0;
+
+		//! Returns if culling with the potentially visible set is enabled.
+		virtual bool getPVSCulling() const = 0;
+
+		//! Enables or disables culling of bsp leafs against the view frustum.
+		/** Enabled by default. */
+		virtual void setFrustumCulling(bool enable) = 0;
+
+		//! Returns if culling of bsp leafs against the view frustum is enabled.
+		virtual bool getFrustumCulling() const = 0;
+
+		//! Returns the visibility cluster the camera was in during the last frame.
+		/** -1 if the camera was outside of the level. */
+		virtual s32 getCameraCluster() const = 0;
+
+		//! Returns how many faces were potentially visible in the last frame.
+		/** These are the faces of all leafs which can be seen from the
+		cluster of the camera, before culling them against the view
+		frustum. */
+		virtual u32 getConsideredFaceCount() const = 0;
+
+		//! Returns how many faces were drawn in the last frame.
+		virtual u32 getDrawnFaceCount() const = 0;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
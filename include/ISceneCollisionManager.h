@@ -10,6 +10,7 @@
 #include "triangle3d.h"
 #include "position2d.h"
 #include "line3d.h"
+#include "irrArray.h"
 
 namespace irr
 {
@@ -20,6 +21,7 @@ namespace scene
 	class ICameraSceneNode;
 	class ITriangleSelector;
 	class IMeshBuffer;
+	class ISceneNodeAnimatorCollisionResponse;
 
 	struct SCollisionHit
 	{
@@ -122,6 +124,25 @@ namespace scene
 			const core::vector3df& gravityDirectionAndSpeed
 			= core::vector3df(0.0f, 0.0f, 0.0f)) = 0;
 
+		//! Moves the nodes of many collision response animators at once.
+		/** Does the same as animating each of the nodes, but the
+		worlds of the animators are updated only once and the collision
+		tests run in parallel when the engine was compiled with OpenMP.
+		Collision callbacks are still called one after another from the
+		calling thread. Animators moved by this call skip their next
+		animation with the same time, so pass the time the scene manager
+		uses for OnAnimate(), usually ITimer::getTime(), and call this
+		before ISceneManager::drawAll().
+		\param animators Animators created by
+		ISceneManager::createCollisionResponseAnimator().
+		\param timeMs Current time in milliseconds.
+		\param parallel Set this to false when the triangle selectors
+		of the worlds can't be queried from several threads at once, for
+		example because they were implemented by the application. */
+		virtual void animateCollisionResponses(
+			const core::array<ISceneNodeAnimatorCollisionResponse*>& animators,
+			u32 timeMs, bool parallel=true) = 0;
+
 		//! Returns a 3d ray which would go through the 2d screen coordinates.
 		/** \param pos: Screen coordinates in pixels.
 		\param camera: Camera from which the ray starts. If null, the
@@ -111,8 +111,11 @@ namespace scene
 	class IMeshSceneNode;
 	class IMeshWriter;
 	class IMetaTriangleSelector;
+	class IOcclusionCuller;
 	class IOctreeSceneNode;
 	class IParticleSystemSceneNode;
+	class IQ3LevelMesh;
+	class IQ3LevelSceneNode;
 	class ISceneCollisionManager;
 	class ISceneLoader;
 	class ISceneNode;
@@ -121,8 +124,11 @@ namespace scene
 	class ISceneNodeAnimatorFactory;
 	class ISceneNodeFactory;
 	class ISceneUserDataSerializer;
+	class IStaticBatchSceneNode;
 	class ITerrainSceneNode;
+	class ITiledTerrainSceneNode;
 	class ITextSceneNode;
+	class ITransformHierarchy;
 	class ITriangleSelector;
 	class IVolumeLightSceneNode;
 
@@ -565,6 +571,38 @@ namespace scene
 		virtual IOctreeSceneNode* addOctreeSceneNode(IMesh* mesh, ISceneNode* parent=0,
 			s32 id=-1, s32 minimalPolysPerNode=256, bool alsoAddIfMeshPointerZero=false) = 0;
 
+		//! Merges the meshes of static scene nodes with equal materials.
+		/** Mesh, octree, cube and sphere scene nodes below root which are
+		visible, have no children and no animators are batched. Their mesh
+		buffers are transformed into world space and merged per material
+		into one buffer for each cell of a grid, so large scenes of small
+		meshes, like those loaded from .irr files, need far fewer draw
+		calls. Nodes with transparent materials or 32 bit indices are left
+		alone. See IStaticBatchSceneNode for details.
+		\param root: Only nodes below this node are batched. If 0, the
+		root scene node is used.
+		\param cellSize: Edge length of the grid cells. Smaller cells can
+		be culled more precisely, larger cells need fewer draw calls.
+		\param id: id of the node. This id can be used to identify the node.
+		\return Pointer to the batch node, which is added below the root
+		scene node. This pointer should not be dropped. See
+		IReferenceCounted::drop() for more information. */
+		virtual IStaticBatchSceneNode* createStaticBatch(ISceneNode* root=0,
+			f32 cellSize=500.f, s32 id=-1) = 0;
+
+		//! Creates flat storage for the transformations of a scene node tree.
+		/** The relative and absolute transformations of root and all
+		nodes below it are kept in arrays in parent before child order,
+		and ITransformHierarchy::update() recalculates the changed ones in
+		a linear pass, which is faster than the recursive update in
+		OnAnimate() for large trees. Call it after moving nodes and before
+		drawAll(). See ITransformHierarchy for details.
+		\param root: Root of the tree. If 0, the root scene node is used.
+		\return The hierarchy. If you no longer need it, you should call
+		ITransformHierarchy::drop(). See IReferenceCounted::drop() for more
+		information. */
+		virtual ITransformHierarchy* createTransformHierarchy(ISceneNode* root=0) = 0;
+
 		//! Adds a camera scene node to the scene graph and sets it as active camera.
 		/** This camera does not react on user input like for example the one created with
 		addCameraSceneNodeFPS(). If you want to move or animate it, use animators or the
@@ -886,6 +924,38 @@ namespace scene
 			s32 maxLOD=5, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17, s32 smoothFactor=0,
 			bool addAlsoIfHeightmapEmpty = false) = 0;
 
+		//! Adds a terrain scene node which loads heightmap tiles around the camera.
+		/** Use this for terrains which are too large to be loaded at once.
+		Each tile is an ITerrainSceneNode, loaded from its own heightmap
+		when the camera comes close and removed again when it is far away.
+		See ITiledTerrainSceneNode for details.
+		\param heightmapPattern: File name of the tile heightmaps, "{x}" and "{z}"
+		are replaced by the tile position, for example "terrain/height_{x}_{z}.png".
+		Tiles without a heightmap file are left empty.
+		\param texturePattern: File name of the tile textures, works like
+		heightmapPattern. Can be empty to use the texture set in the material of
+		the node for all tiles. Textures loaded for the tiles are removed from
+		the texture cache of the video driver together with the last tile using
+		them, unless they are used somewhere else.
+		\param tileCountX: Number of tiles along the x axis.
+		\param tileCountZ: Number of tiles along the z axis.
+		\param tileSize: Size of the tile heightmaps in pixels, must be 2^N+1.
+		\param parent: Parent of the scene node. Can be 0 if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: The absolute position of the tile (0,0).
+		\param scale: The scale factor for all tiles, like for addTerrainSceneNode().
+		\param maxLOD: The maximum LOD (level of detail) of the tiles.
+		\param patchSize: patch size of the tiles.
+		\return Pointer to the created scene node. This pointer should not be dropped.
+		See IReferenceCounted::drop() for more information. */
+		virtual ITiledTerrainSceneNode* addTiledTerrainSceneNode(
+			const io::path& heightmapPattern, const io::path& texturePattern,
+			u32 tileCountX, u32 tileCountZ, s32 tileSize,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f,1.0f,1.0f),
+			s32 maxLOD=5, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17) = 0;
+
 		//! Adds a quake3 scene node to the scene graph.
 		/** A Quake3 Scene renders multiple meshes for a specific HighLanguage Shader (Quake3 Style )
 		\return Pointer to the quake3 scene node if successful, otherwise NULL.
@@ -894,6 +964,19 @@ namespace scene
 												ISceneNode* parent=0, s32 id=-1
 												) = 0;
 
+		//! Adds a scene node which draws a quake3 level using its potentially visible set.
+		/** Only the faces of bsp leafs which can be seen from the
+		cluster of the active camera and which are inside the view
+		frustum are drawn. See IQ3LevelSceneNode for details.
+		\param mesh: The level, loaded with getMesh() from a .bsp file.
+		\param parent: Parent of the scene node. Can be null if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\return Pointer to the created scene node, or 0 if the mesh is 0 or
+		the engine was compiled without the bsp loader.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual IQ3LevelSceneNode* addQ3LevelSceneNode(IQ3LevelMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1) = 0;
+
 
 		//! Adds an empty scene node to the scene graph.
 		/** Can be used for doing advanced transformations
@@ -1283,6 +1366,12 @@ namespace scene
 
 		//! Creates a simple ITriangleSelector, based on an animated mesh scene node.
 		/** Details of the mesh associated with the node will be extracted internally.
+		When the frame of the node changes only the triangles of meshbuffers whose
+		vertices or indices changed are updated, so meshbuffers which are modified
+		by hand need IMeshBuffer::setDirty(). Box and line queries use a bounding
+		volume hierarchy which follows the animation. Skinned meshes are used as
+		the node skinned them in its last OnAnimate() call, so for meshes shared
+		by several nodes the selector gets the vertices of the node animated last.
 		\param node The animated mesh scene node from which to build the selector
 		\param separateMeshbuffers: When true it's possible to get information which meshbuffer
 		got hit in collision tests. But has a slight speed cost.
@@ -1422,6 +1511,13 @@ namespace scene
 		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
 		virtual ISceneCollisionManager* getSceneCollisionManager() = 0;
 
+		//! Get pointer to the occlusion culler.
+		/** The occlusion culler hides nodes with EAC_OCC_SOFTWARE culling
+		behind occluders which are rendered on the CPU.
+		\return Pointer to the occlusion culler.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual IOcclusionCuller* getOcclusionCuller() = 0;
+
 		//! Get pointer to the mesh manipulator.
 		/** \return Pointer to the mesh manipulator
 		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
@@ -1542,6 +1638,9 @@ namespace scene
 		an xml based format. .irr files can Be edited with the Irrlicht
 		Engine Editor, irrEdit (http://www.ambiera.com/irredit/). To
 		load .irr files again, see ISceneManager::loadScene().
+		When the filename ends with .irrb, the scene is written in a
+		binary format instead, which loads much faster but can't be
+		edited. Loading an .irr file and saving it as .irrb converts it.
 		\param filename Name of the file.
 		\param userDataSerializer If you want to save some user data
 		for every scene node into the file, implement the
@@ -1560,6 +1659,7 @@ namespace scene
 		an xml based format. .irr files can Be edited with the Irrlicht
 		Engine Editor, irrEdit (http://www.ambiera.com/irredit/). To
 		load .irr files again, see ISceneManager::loadScene().
+		Files with the extension .irrb get the binary scene format.
 		\param file File where the scene is saved into.
 		\param userDataSerializer If you want to save some user data
 		for every scene node into the file, implement the
@@ -1598,7 +1698,8 @@ namespace scene
 		ISceneManager::addExternalSceneLoader. .irr files can Be edited
 		with the Irrlicht Engine Editor, irrEdit
 		(http://www.ambiera.com/irredit/) or saved directly by the engine
-		using ISceneManager::saveScene().
+		using ISceneManager::saveScene(). Binary .irrb scenes written
+		by ISceneManager::saveScene() are loaded as well.
 		\param filename Name of the file to load from.
 		\param userDataSerializer If you want to load user data
 		possibily saved in that file for some scene nodes in the file,
@@ -1672,6 +1773,28 @@ namespace scene
 		\return True if node is not visible in the current scene, else
 		false. */
 		virtual bool isCulled(const ISceneNode* node) const =0;
+
+		//! Enables culling with a spatial index of the scene nodes.
+		/** The world space boxes of all nodes which register for
+		rendering with automatic culling are kept in a dynamic bounding
+		volume tree. Once per drawAll() the tree is tested against the
+		view frustum of the active camera, which rejects whole groups of
+		nodes at once. Nodes completely inside of the frustum are not
+		tested on their own anymore, only nodes which intersect the
+		frustum are checked with isCulled(). The box of a node is only
+		updated in the tree when its transformation or bounding box
+		changed.
+		Nodes are added when they register for rendering and removed
+		once they did not register in a frame, the scene manager keeps
+		a reference to them until then. Disabled by default.
+		\param enable True to use the spatial index. */
+		virtual void setSpatialIndexCulling(bool enable) =0;
+
+		//! Returns if culling with a spatial index of the scene nodes is enabled.
+		virtual bool getSpatialIndexCulling() const =0;
+
+		//! Returns how many scene nodes are in the spatial index.
+		virtual u32 getSpatialIndexNodeCount() const =0;
 	};
 
 
@@ -11,6 +11,7 @@
 #include "EDebugSceneTypes.h"
 #include "ISceneNodeAnimator.h"
 #include "ITriangleSelector.h"
+#include "ITransformHierarchy.h"
 #include "SMaterial.h"
 #include "irrString.h"
 #include "aabbox3d.h"
@@ -49,7 +50,10 @@ namespace scene
 			: RelativeTranslation(position), RelativeRotation(rotation), RelativeScale(scale),
 				Parent(0), SceneManager(mgr), TriangleSelector(0), ID(id),
 				AutomaticCullingState(EAC_BOX), DebugDataVisible(EDS_OFF),
-				IsVisible(true), IsDebugObject(false)
+				SpatialIndexId(-1), TransformHierarchy(0), TransformHandle(-1),
+				TransformVersion(0), ParentTransformVersion(0),
+				IsVisible(true), IsDebugObject(false),
+				RelativeTransformationChanged(true), AbsoluteTransformationChanged(true)
 		{
 			if (parent)
 				parent->addChild(this);
@@ -200,12 +204,13 @@ namespace scene
 				AbsoluteTransformation.transformVect( edges[i] );
 		}
 
-		//! Get the absolute transformation of the node. Is recalculated every OnAnimate()-call.
+		//! Get the absolute transformation of the node. Is recalculated in OnAnimate() when it changed.
 		/** NOTE: For speed reasons the absolute transformation is not
 		automatically recalculated on each change of the relative
 		transformation or by a transformation change of an parent. Instead the
-		update usually happens once per frame in OnAnimate. You can enforce
-		an update with updateAbsolutePosition().
+		update usually happens once per frame in OnAnimate, but only for nodes
+		whose own or parent's transformation changed since the last update.
+		You can enforce an update with updateAbsolutePosition().
 		\return The absolute transformation matrix. */
 		virtual const core::matrix4& getAbsoluteTransformation() const
 		{
@@ -216,22 +221,67 @@ namespace scene
 		//! Returns the relative transformation of the scene node.
 		/** The relative transformation is stored internally as 3
 		vectors: translation, rotation and scale. To get the relative
-		transformation matrix, it is calculated from these values.
+		transformation matrix, it is calculated from these values. The
+		matrix is cached until one of the values is changed.
 		\return The relative transformation matrix. */
 		virtual core::matrix4 getRelativeTransformation() const
 		{
-			core::matrix4 mat;
-			mat.setRotationDegrees(RelativeRotation);
-			mat.setTranslation(RelativeTranslation);
-
-			if (RelativeScale != core::vector3df(1.f,1.f,1.f))
+			if (RelativeTransformationChanged)
 			{
-				core::matrix4 smat;
-				smat.setScale(RelativeScale);
-				mat *= smat;
+				RelativeTransformation.setRotationDegrees(RelativeRotation);
+				RelativeTransformation.setTranslation(RelativeTranslation);
+
+				if (RelativeScale != core::vector3df(1.f,1.f,1.f))
+				{
+					core::matrix4 smat;
+					smat.setScale(RelativeScale);
+					RelativeTransformation *= smat;
+				}
+				RelativeTransformationChanged = false;
 			}
 
-			return mat;
+			return RelativeTransformation;
+		}
+
+
+		//! Marks the transformation of this node as changed.
+		/** The setters for position, rotation and scale do this already.
+		Nodes which compute their relative transformation from other data
+		have to call it when that data changes, so the absolute
+		transformation of the node and its children is updated in the
+		next OnAnimate() or updateAbsolutePosition() call. */
+		void setTransformationChanged()
+		{
+			RelativeTransformationChanged = true;
+			AbsoluteTransformationChanged = true;
+
+			if (TransformHierarchy)
+				TransformHierarchy->setNodeChanged(TransformHandle);
+		}
+
+
+		//! Sets an absolute transformation which was calculated elsewhere.
+		/** Used by ITransformHierarchy::update(). The transformation is
+		kept until this node or its parent changes.
+		\param transformation Parent's absolute transformation multiplied
+		with the relative transformation of this node. */
+		void setAbsoluteTransformation(const core::matrix4& transformation)
+		{
+			AbsoluteTransformation = transformation;
+			AbsoluteTransformationChanged = false;
+			if (Parent)
+				ParentTransformVersion = Parent->TransformVersion;
+			++TransformVersion;
+		}
+
+
+		//! Returns a counter which is increased each time the absolute transformation is recalculated.
+		/** Caches of data depending on the absolute transformation, like
+		world space bounding boxes, can compare it with the counter they
+		were built with instead of comparing the matrices. */
+		u32 getTransformVersion() const
+		{
+			return TransformVersion;
 		}
 
 
@@ -304,6 +354,10 @@ namespace scene
 				child->remove(); // remove from old parent
 				Children.push_back(child);
 				child->Parent = this;
+				child->AbsoluteTransformationChanged = true;
+
+				if (TransformHierarchy)
+					TransformHierarchy->setStructureChanged();
 			}
 		}
 
@@ -321,6 +375,8 @@ namespace scene
 				if ((*it) == child)
 				{
 					(*it)->Parent = 0;
+					(*it)->AbsoluteTransformationChanged = true;
+					(*it)->removeFromTransformHierarchy();
 					(*it)->drop();
 					Children.erase(it);
 					return true;
@@ -340,6 +396,8 @@ namespace scene
 			for (; it != Children.end(); ++it)
 			{
 				(*it)->Parent = 0;
+				(*it)->AbsoluteTransformationChanged = true;
+				(*it)->removeFromTransformHierarchy();
 				(*it)->drop();
 			}
 
@@ -482,6 +540,7 @@ namespace scene
 		virtual void setScale(const core::vector3df& scale)
 		{
 			RelativeScale = scale;
+			setTransformationChanged();
 		}
 
 
@@ -502,6 +561,7 @@ namespace scene
 		virtual void setRotation(const core::vector3df& rotation)
 		{
 			RelativeRotation = rotation;
+			setTransformationChanged();
 		}
 
 
@@ -521,6 +581,7 @@ namespace scene
 		virtual void setPosition(const core::vector3df& newpos)
 		{
 			RelativeTranslation = newpos;
+			setTransformationChanged();
 		}
 
 
@@ -596,6 +657,65 @@ namespace scene
 		}
 
 
+		//! Sets the entry of this node in the spatial index of the scene manager.
+		/** Only used by the scene manager, see
+		ISceneManager::setSpatialIndexCulling(). */
+		void setSpatialIndexId(s32 id)
+		{
+			SpatialIndexId = id;
+		}
+
+
+		//! Returns the entry of this node in the spatial index of the scene manager.
+		/** \return -1 if the node is not in the spatial index. */
+		s32 getSpatialIndexId() const
+		{
+			return SpatialIndexId;
+		}
+
+
+		//! Sets the transform hierarchy this node is part of, and its handle in there.
+		/** Only used by the transform hierarchy, see
+		ISceneManager::createTransformHierarchy(). */
+		void setTransformHandle(ITransformHierarchy* hierarchy, s32 handle)
+		{
+			TransformHierarchy = hierarchy;
+			TransformHandle = handle;
+		}
+
+
+		//! Returns the transform hierarchy this node is part of, or 0.
+		ITransformHierarchy* getTransformHierarchy() const
+		{
+			return TransformHierarchy;
+		}
+
+
+		//! Returns the handle of this node in its transform hierarchy.
+		/** \return -1 if the node is not part of a transform hierarchy. */
+		s32 getTransformHandle() const
+		{
+			return TransformHandle;
+		}
+
+
+		//! Clears the transform handles of this node and its children in a hierarchy.
+		/** Only used by the transform hierarchy. Children which are part
+		of another hierarchy are left alone. */
+		void clearTransformHandles(ITransformHierarchy* hierarchy)
+		{
+			if (TransformHierarchy != hierarchy)
+				return;
+
+			TransformHierarchy = 0;
+			TransformHandle = -1;
+
+			ISceneNodeList::Iterator it = Children.begin();
+			for (; it != Children.end(); ++it)
+				(*it)->clearTransformHandles(hierarchy);
+		}
+
+
 		//! Returns a const reference to the list of all children.
 		/** \return The list of all children of this node. */
 		const core::list<ISceneNode*>& getChildren() const
@@ -660,17 +780,32 @@ namespace scene
 
 
 		//! Updates the absolute position based on the relative and the parents position
-		/** Note: This does not recursively update the parents absolute positions, so if you have a deeper
+		/** Nothing is recalculated if neither the transformation of this
+		node nor the absolute transformation of the parent changed since the
+		last update.
+		Note: This does not recursively update the parents absolute positions, so if you have a deeper
 			hierarchy you might want to update the parents first.*/
 		virtual void updateAbsolutePosition()
 		{
 			if (Parent)
 			{
+				if (!AbsoluteTransformationChanged && ParentTransformVersion == Parent->TransformVersion)
+					return;
+
 				AbsoluteTransformation =
 					Parent->getAbsoluteTransformation() * getRelativeTransformation();
+				ParentTransformVersion = Parent->TransformVersion;
 			}
 			else
+			{
+				if (!AbsoluteTransformationChanged)
+					return;
+
 				AbsoluteTransformation = getRelativeTransformation();
+			}
+
+			AbsoluteTransformationChanged = false;
+			++TransformVersion;
 		}
 
 
@@ -777,6 +912,7 @@ namespace scene
 			RelativeTranslation = toCopyFrom->RelativeTranslation;
 			RelativeRotation = toCopyFrom->RelativeRotation;
 			RelativeScale = toCopyFrom->RelativeScale;
+			setTransformationChanged();
 			ID = toCopyFrom->ID;
 			setTriangleSelector(toCopyFrom->TriangleSelector);
 			AutomaticCullingState = toCopyFrom->AutomaticCullingState;
@@ -809,6 +945,25 @@ namespace scene
 			}
 		}
 
+		//! Takes this node and its children out of their transform hierarchy.
+		//! Called when the node is removed from its parent. The root of a
+		//! hierarchy stays in it, only its absolute transformation changes.
+		void removeFromTransformHierarchy()
+		{
+			ITransformHierarchy* hierarchy = TransformHierarchy;
+			if (!hierarchy)
+				return;
+
+			if (hierarchy->getRoot() == this)
+			{
+				hierarchy->setNodeChanged(TransformHandle);
+				return;
+			}
+
+			hierarchy->setStructureChanged();
+			clearTransformHandles(hierarchy);
+		}
+
 		//! Sets the new scene manager for this node and all children.
 		//! Called by addChild when moving nodes between scene managers
 		void setSceneManager(ISceneManager* newManager)
@@ -835,6 +990,9 @@ namespace scene
 		//! Relative scale of the scene node.
 		core::vector3df RelativeScale;
 
+		//! Relative transformation built from translation, rotation and scale
+		mutable core::matrix4 RelativeTransformation;
+
 		//! Pointer to the parent
 		ISceneNode* Parent;
 
@@ -859,11 +1017,32 @@ namespace scene
 		//! Flag if debug data should be drawn, such as Bounding Boxes.
 		u32 DebugDataVisible;
 
+		//! Entry in the spatial index of the scene manager
+		s32 SpatialIndexId;
+
+		//! Transform hierarchy the node is part of, not grabbed
+		ITransformHierarchy* TransformHierarchy;
+
+		//! Index of the node in the transform hierarchy
+		s32 TransformHandle;
+
+		//! Increased each time the absolute transformation is recalculated
+		u32 TransformVersion;
+
+		//! TransformVersion of the parent the absolute transformation was calculated with
+		u32 ParentTransformVersion;
+
 		//! Is the node visible?
 		bool IsVisible;
 
 		//! Is debug object?
 		bool IsDebugObject;
+
+		//! Flag if the cached relative transformation has to be rebuilt
+		mutable bool RelativeTransformationChanged;
+
+		//! Flag if the absolute transformation has to be recalculated
+		bool AbsoluteTransformationChanged;
 	};
 
 
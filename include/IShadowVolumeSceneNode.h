@@ -29,6 +29,11 @@ namespace scene
 
 		//! Updates the shadow volumes for current light positions.
 		virtual void updateShadowVolumes() = 0;
+
+		//! Returns how many shadow volumes the last update had to rebuild.
+		/** Volumes are kept as long as neither the light moves relative
+		to the mesh nor the mesh changes. */
+		virtual u32 getRebuiltVolumeCount() const = 0;
 	};
 
 } // end namespace scene
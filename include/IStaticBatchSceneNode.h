@@ -0,0 +1,55 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_STATIC_BATCH_SCENE_NODE_H_INCLUDED__
+#define __I_STATIC_BATCH_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! A scene node which draws the meshes of many static scene nodes at once.
+	/** Created by ISceneManager::createStaticBatch(). The mesh buffers of
+	the source nodes are transformed into world space and merged into one
+	buffer per material and cell of a regular grid, so a scene of many
+	small meshes needs only a few draw calls. Each cell is culled against
+	the view frustum on its own.
+
+	The source nodes are made invisible while they are batched. When a
+	source node moves or is removed from the scene, it is taken out of the
+	batches and the cells it was in are rebuilt, a moved node is made
+	visible again. Changes to the materials or meshes of source nodes are
+	only picked up by rebuild(). */
+	class IStaticBatchSceneNode : public ISceneNode
+	{
+	public:
+
+		//! Constructor
+		IStaticBatchSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id)
+			: ISceneNode(parent, mgr, id) {}
+
+		//! Rebuilds all batches from the current state of the source nodes.
+		virtual void rebuild() = 0;
+
+		//! Takes a node out of the batches and makes it visible again.
+		/** \return True if the node was batched. */
+		virtual bool removeSourceNode(ISceneNode* node) = 0;
+
+		//! Returns the number of batched scene nodes.
+		virtual u32 getSourceNodeCount() const = 0;
+
+		//! Returns the number of merged mesh buffers.
+		virtual u32 getBatchCount() const = 0;
+
+		//! Returns how many merged mesh buffers were drawn in the last frame.
+		virtual u32 getDrawnBatchCount() const = 0;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
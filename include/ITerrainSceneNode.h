@@ -180,6 +180,16 @@ namespace scene
 		given LOD. When < 0 borders are just regular patches (that's default).	*/
 		virtual void setFixedBorderLOD(irr::s32 borderLOD=0) = 0;
 
+		//! Spread index updates over several frames.
+		/** By default all indices are recalculated in the frame in which the
+		camera moved or turned far enough. With incremental updates the new
+		indices are generated for some patches per frame into a second buffer
+		while the old ones are still rendered. The buffers are swapped once
+		all patches are done. This avoids frame spikes on large terrains.
+		\param patchesPerFrame Number of patches updated per frame. 0 updates
+		all patches at once (that's default). */
+		virtual void setIncrementalIndexUpdate(u32 patchesPerFrame=0) = 0;
+
 	};
 
 } // end namespace scene
@@ -0,0 +1,92 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_TILED_TERRAIN_SCENE_NODE_H__
+#define __I_TILED_TERRAIN_SCENE_NODE_H__
+
+#include "ISceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+	class ITerrainSceneNode;
+
+	//! A scene node for terrains which are too large to be loaded at once.
+	/** The terrain is split into a grid of tiles. Each tile is a heightmap
+	file with an optional texture, both named after the tile position. Only
+	the tiles around the active camera are loaded, each one as an
+	ITerrainSceneNode child of this node, and tiles which are too far away
+	are removed again. The memory used by all loaded tiles can be limited.
+
+	All tile heightmaps must have the same size of 2^N+1 pixels, neighbouring
+	tiles share the pixels of their common border. Tiles use full detail at
+	their borders, so there are no cracks between tiles with different LODs.
+
+	The file names of the tiles are created from patterns in which "{x}" and
+	"{z}" are replaced by the tile position, for example
+	"terrain/height_{x}_{z}.png". Tile (0,0) starts at the position of this
+	node, tile (x,z) is placed (heightmap size-1)*scale units further along
+	the x and z axis. Rotations are not supported. */
+	class ITiledTerrainSceneNode : public ISceneNode
+	{
+	public:
+		//! Constructor
+		ITiledTerrainSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0.0f, 0.0f, 0.0f),
+			const core::vector3df& rotation = core::vector3df(0.0f, 0.0f, 0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f) )
+			: ISceneNode (parent, mgr, id, position, rotation, scale) {}
+
+		//! Sets how many tiles around the tile of the camera are loaded.
+		/** Tiles are removed again when they are more than radius+1 tiles
+		away. The default is 1, which keeps 3x3 tiles loaded. */
+		virtual void setLoadRadius(u32 radius) =0;
+
+		//! Returns how many tiles around the tile of the camera are loaded.
+		virtual u32 getLoadRadius() const =0;
+
+		//! Sets how many tiles are loaded at most per frame.
+		/** Loading a tile takes some time, so missing tiles near the camera
+		are loaded over several frames instead of all at once. Tiles closer
+		to the camera are loaded first. The default is 1. */
+		virtual void setTilesPerFrame(u32 count) =0;
+
+		//! Sets the maximal memory used by loaded tiles in bytes.
+		/** Includes vertices, indices and textures of the tiles. No further
+		tiles are loaded once the budget is used up, even if they are inside
+		the load radius. 0 means no limit, which is default. */
+		virtual void setMemoryBudget(u32 bytes) =0;
+
+		//! Returns the memory used by all loaded tiles in bytes.
+		virtual u32 getResidentMemory() const =0;
+
+		//! Returns the number of loaded tiles.
+		virtual u32 getResidentTileCount() const =0;
+
+		//! Returns the terrain node of a tile.
+		/** \param x Tile position along the x axis.
+		\param z Tile position along the z axis.
+		\return The terrain node of the tile, or 0 if the tile is not
+		loaded. Tiles can be removed at any frame, so don't keep the
+		pointer without grabbing it. */
+		virtual ITerrainSceneNode* getTile(s32 x, s32 z) const =0;
+
+		//! Get height of a point of the terrain.
+		/** \return The height at the point, or -FLT_MAX if the tile of the
+		point is not loaded. */
+		virtual f32 getHeight(f32 x, f32 z) const =0;
+
+		//! Loads the tiles around a position right away.
+		/** Useful before the first frame, or when the camera jumps to a far
+		away position. Ignores the tiles per frame limit, but not the memory
+		budget. */
+		virtual void loadTilesAround(const core::vector3df& position) =0;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // __I_TILED_TERRAIN_SCENE_NODE_H__
+
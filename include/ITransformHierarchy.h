@@ -0,0 +1,76 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_TRANSFORM_HIERARCHY_H_INCLUDED__
+#define __I_TRANSFORM_HIERARCHY_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+#include "matrix4.h"
+
+namespace irr
+{
+namespace scene
+{
+	class ISceneNode;
+
+	//! Flat storage of the transformations of a scene node tree.
+	/** Created by ISceneManager::createTransformHierarchy(). The relative
+	and absolute transformations of all nodes below a root are kept in
+	arrays sorted so that each parent comes before its children. update()
+	recalculates the absolute transformations of changed nodes in one
+	linear pass over these arrays instead of a recursive walk through the
+	children lists, the subtrees of the root are processed in parallel if
+	OpenMP is available. The results are written back into the nodes, so
+	the following OnAnimate() calls find nothing left to do.
+
+	Each node of the hierarchy gets a handle, its index in the arrays,
+	see ISceneNode::getTransformHandle(). Nodes report changes of their
+	transformation and added or removed children to the hierarchy, the
+	node order is rebuilt on the next update() after the latter. Handles
+	are only valid until then. A node can only be part of one hierarchy,
+	subtrees which are already part of another one are skipped. */
+	class ITransformHierarchy : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Recalculates the absolute transformations of all changed nodes and their children.
+		/** Call this after moving nodes and before ISceneManager::drawAll(). */
+		virtual void update() = 0;
+
+		//! Rebuilds the node order from the scene graph.
+		/** Done by update() when nodes were added, removed or reparented. */
+		virtual void rebuild() = 0;
+
+		//! Returns the root node of the hierarchy.
+		virtual ISceneNode* getRoot() const = 0;
+
+		//! Returns the number of nodes in the hierarchy, including the root.
+		virtual u32 getNodeCount() const = 0;
+
+		//! Returns the node of a handle.
+		virtual ISceneNode* getNode(s32 handle) const = 0;
+
+		//! Returns the handle of the parent of a node, or -1 for the root.
+		virtual s32 getParentHandle(s32 handle) const = 0;
+
+		//! Returns the relative transformation of a node as of the last update().
+		virtual const core::matrix4& getRelativeTransformation(s32 handle) const = 0;
+
+		//! Returns the absolute transformation of a node as of the last update().
+		virtual const core::matrix4& getAbsoluteTransformation(s32 handle) const = 0;
+
+		//! Returns how many absolute transformations the last update() recalculated.
+		virtual u32 getUpdatedNodeCount() const = 0;
+
+		//! Called by a node of the hierarchy when its relative transformation changed.
+		virtual void setNodeChanged(s32 handle) = 0;
+
+		//! Called by a node of the hierarchy when children were added or removed.
+		virtual void setStructureChanged() = 0;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
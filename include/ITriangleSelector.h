@@ -162,6 +162,20 @@ public:
 		const core::matrix4* transform=0, bool useNodeTransform=true,
 		irr::core::array<SCollisionTriangleRange>* outTriangleInfo=0) const = 0;
 
+	//! Gets a box around all triangles of this selector.
+	/** Selectors of animated nodes update their triangles first. Meta
+	selectors use the boxes of their selectors to skip those which are
+	far away from a queried box.
+	\param outBox Receives the box.
+	\param useNodeTransform When the selector has a node then transform
+	the box by that node's transformation matrix.
+	\return False if the selector doesn't know a box for its triangles,
+	outBox is unchanged then. */
+	virtual bool getBoundingBox(core::aabbox3df& outBox, bool useNodeTransform=true) const
+	{
+		return false;
+	}
+
 	//! Get number of TriangleSelectors that are part of this one
 	/** Only useful for MetaTriangleSelector, others return 1
 	*/
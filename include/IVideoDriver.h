@@ -19,6 +19,7 @@
 #include "EDriverFeatures.h"
 #include "SExposedVideoData.h"
 #include "SOverrideMaterial.h"
+#include "SStreamAllocation.h"
 
 namespace irr
 {
@@ -219,6 +220,12 @@ namespace video
 		Version (int) Version of the driver. Should be Major*100+Minor
 		ShaderLanguageVersion (int) Version of the high level shader language. Should be Major*100+Minor.
 		AntiAlias (int) Number of Samples the driver uses for each pixel. 0 and 1 means anti aliasing is off, typical values are 2,4,8,16,32
+		StreamedBytes (int) Bytes allocated from the streaming buffers in the last frame, see allocateStream().
+		StreamWaits (int) How often allocateStream() had to wait in the last frame until the GPU was done with older data.
+		StreamOrphans (int) How often a streaming buffer was full with data of the last frame and had to be replaced.
+		UploadedBytes (int) Bytes uploaded to the hardware buffers of meshbuffers in the last frame.
+		StateCallsIssued (int) Render state changes and shader constants sent to the API in the last frame. Only counted by the OpenGL driver.
+		StateCallsSkipped (int) Render state changes and shader constants not sent in the last frame, because the driver knew they were already set.
 		*/
 		virtual const io::IAttributes& getDriverAttributes() const=0;
 
@@ -618,6 +625,58 @@ namespace video
 				scene::E_PRIMITIVE_TYPE pType=scene::EPT_TRIANGLES,
 				E_INDEX_TYPE iType=EIT_16BIT) =0;
 
+		//! Allocates memory for vertices or indices which are only drawn in the current frame.
+		/** Dynamic geometry like particles or text, which changes every
+		frame, can be written directly to the returned memory instead of
+		being kept in a meshbuffer and uploaded again. The driver takes
+		the memory from a streaming buffer which is used as a ring. Parts
+		which are still in use by the GPU are protected by fences, if the
+		ring is full with data of the current frame it gets a new buffer
+		(orphaning). Drivers without hardware buffers emulate this in
+		system memory.
+		The memory is only valid until the next allocation from the same
+		buffer, until it was drawn with drawStreamedPrimitiveList() or
+		until endScene(). So write the data right away, and do not read it
+		back, it can be slow uncached memory.
+		\param buffer Stream for vertices or for indices.
+		\param size Size of the allocation in bytes.
+		\return Allocation, its Data is 0 if the size does not fit into
+		the streaming buffer. Draw the data from client memory instead
+		then. */
+		virtual SStreamAllocation allocateStream(E_STREAM_BUFFER buffer, u32 size) =0;
+
+		//! Draws vertices and indices which were written to stream allocations.
+		/** Works like drawVertexPrimitiveList().
+		\param vertices Allocation from the ESB_VERTEX stream.
+		\param vertexCount Amount of vertices in the allocation.
+		\param indices Allocation from the ESB_INDEX stream.
+		\param primCount Amount of Primitives
+		\param vType Vertex type, e.g. video::EVT_STANDARD for S3DVertex.
+		\param pType Primitive type, e.g. scene::EPT_TRIANGLE_FAN for a triangle fan.
+		\param iType Index type, e.g. video::EIT_16BIT for 16bit indices. */
+		virtual void drawStreamedPrimitiveList(const SStreamAllocation& vertices, u32 vertexCount,
+				const SStreamAllocation& indices, u32 primCount,
+				E_VERTEX_TYPE vType=EVT_STANDARD,
+				scene::E_PRIMITIVE_TYPE pType=scene::EPT_TRIANGLES,
+				E_INDEX_TYPE iType=EIT_16BIT) =0;
+
+		//! Draws streamed vertices with indices from client memory.
+		/** Useful when only the vertices change each frame, like for
+		particles. See drawStreamedPrimitiveList() above. */
+		virtual void drawStreamedPrimitiveList(const SStreamAllocation& vertices, u32 vertexCount,
+				const void* indexList, u32 primCount,
+				E_VERTEX_TYPE vType=EVT_STANDARD,
+				scene::E_PRIMITIVE_TYPE pType=scene::EPT_TRIANGLES,
+				E_INDEX_TYPE iType=EIT_16BIT) =0;
+
+		//! Sets the size of a streaming buffer.
+		/** Larger buffers are needed when more dynamic geometry is drawn
+		each frame, see the StreamOrphans value of getDriverAttributes().
+		Changing the size drops the current buffer.
+		\param buffer Stream for vertices or for indices.
+		\param size Size in bytes, 0 disables the stream. */
+		virtual void setStreamBufferSize(E_STREAM_BUFFER buffer, u32 size) =0;
+
 		//! Draws a vertex primitive list in 2d
 		/** Compared to the general (3d) version of this method, this
 		one sets up a 2d render mode, and uses only x and y of vectors.
@@ -322,6 +322,19 @@ to provide the user with the proper DLL. That's why it's disabled by default. */
 tool <http://developer.nvidia.com/object/nvperfhud_home.html>. */
 #undef _IRR_USE_NVIDIA_PERFHUD_
 
+//! Define _IRR_USE_SSE2_ to use SSE2 intrinsics in the batch transformations of matrix4
+/** transformVects, rotateVects, transformBoxesEx and transformPlanes then work on
+several elements at once. The results can differ from the scalar code by rounding.
+Only used when the compiler targets SSE2, it's disabled by default so the engine
+and the application don't have to agree on the instruction set. */
+//#define _IRR_USE_SSE2_
+#ifdef NO_IRR_USE_SSE2_
+#undef _IRR_USE_SSE2_
+#endif
+#if defined(_IRR_USE_SSE2_) && !(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#undef _IRR_USE_SSE2_
+#endif
+
 //! Define one of the three setting for Burning's Video Software Rasterizer
 /** So if we were marketing guys we could say Irrlicht has 4 Software-Rasterizers.
 	In a Nutshell:
@@ -403,6 +416,13 @@ tool <http://developer.nvidia.com/object/nvperfhud_home.html>. */
 #undef _IRR_COMPILE_WITH_IRR_SCENE_LOADER_
 #endif
 
+//! Define _IRR_COMPILE_WITH_IRR_BINARY_SCENE_LOADER_ if you want to be able to load
+/** binary .irrb scenes using ISceneManager::loadScene */
+#define _IRR_COMPILE_WITH_IRR_BINARY_SCENE_LOADER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BINARY_SCENE_LOADER_
+#undef _IRR_COMPILE_WITH_IRR_BINARY_SCENE_LOADER_
+#endif
+
 //! Define _IRR_COMPILE_WITH_SKINNED_MESH_SUPPORT_ if you want to use bone based
 /** animated meshes. If you compile without this, you will be unable to load
 B3D, MS3D or X meshes */
@@ -439,6 +459,11 @@ B3D, MS3D or X meshes */
 #ifdef NO_IRR_COMPILE_WITH_IRR_MESH_LOADER_
 #undef _IRR_COMPILE_WITH_IRR_MESH_LOADER_
 #endif
+//! Define _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_ if you want to load binary .irrbin mesh files
+#define _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#undef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#endif
 //! Define _IRR_COMPILE_WITH_HALFLIFE_LOADER_ if you want to load Halflife animated files
 #define _IRR_COMPILE_WITH_HALFLIFE_LOADER_
 #ifdef NO_IRR_COMPILE_WITH_HALFLIFE_LOADER_
@@ -530,6 +555,16 @@ B3D, MS3D or X meshes */
 #ifdef NO_IRR_COMPILE_WITH_IRR_WRITER_
 #undef _IRR_COMPILE_WITH_IRR_WRITER_
 #endif
+//! Define _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_ if you want to write binary .irrbin mesh files
+#define _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+#undef _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+#endif
+//! Define _IRR_COMPILE_WITH_IRR_BINARY_SCENE_WRITER_ if you want to save binary .irrb scenes
+#define _IRR_COMPILE_WITH_IRR_BINARY_SCENE_WRITER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BINARY_SCENE_WRITER_
+#undef _IRR_COMPILE_WITH_IRR_BINARY_SCENE_WRITER_
+#endif
 //! Define _IRR_COMPILE_WITH_COLLADA_WRITER_ if you want to write Collada files
 #define _IRR_COMPILE_WITH_COLLADA_WRITER_
 #ifdef NO_IRR_COMPILE_WITH_COLLADA_WRITER_
@@ -49,6 +49,38 @@ namespace scene
 	};
 
 
+	//! Particles stored as structure of arrays.
+	/** Each member points to an array with one value per particle, so
+	affectors can work on many particles at once with simple loops over
+	contiguous values. The members correspond to those of SParticle. */
+	struct SParticleArrays
+	{
+		f32* PosX;
+		f32* PosY;
+		f32* PosZ;
+
+		f32* VectorX;
+		f32* VectorY;
+		f32* VectorZ;
+
+		u32* StartTime;
+		u32* EndTime;
+
+		video::SColor* Color;
+		video::SColor* StartColor;
+
+		f32* StartVectorX;
+		f32* StartVectorY;
+		f32* StartVectorZ;
+
+		f32* SizeWidth;
+		f32* SizeHeight;
+
+		f32* StartSizeWidth;
+		f32* StartSizeHeight;
+	};
+
+
 } // end namespace scene
 } // end namespace irr
 
@@ -0,0 +1,48 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_STREAM_ALLOCATION_H_INCLUDED__
+#define __S_STREAM_ALLOCATION_H_INCLUDED__
+
+#include "irrTypes.h"
+
+namespace irr
+{
+namespace video
+{
+
+	//! Streaming buffers of a driver, see IVideoDriver::allocateStream()
+	enum E_STREAM_BUFFER
+	{
+		//! Vertices of any vertex type
+		ESB_VERTEX = 0,
+		//! 16 or 32 bit indices
+		ESB_INDEX,
+
+		//! Not used as a buffer, only to count them
+		ESB_COUNT
+	};
+
+	//! Memory in a streaming buffer of the driver
+	/** Returned by IVideoDriver::allocateStream(). Write the vertices or
+	indices to Data and draw them with
+	IVideoDriver::drawStreamedPrimitiveList(). */
+	struct SStreamAllocation
+	{
+		SStreamAllocation() : Data(0), Size(0), Offset(0), Buffer(ESB_VERTEX) {}
+
+		//! Where the data has to be written to, 0 if the allocation failed
+		void* Data;
+		//! Size of the allocation in bytes
+		u32 Size;
+		//! Position of the allocation in the streaming buffer in bytes
+		u32 Offset;
+		//! Buffer which holds the allocation
+		E_STREAM_BUFFER Buffer;
+	};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
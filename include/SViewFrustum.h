@@ -169,8 +169,7 @@ namespace scene
 
 	inline void SViewFrustum::transform(const core::matrix4& mat)
 	{
-		for (u32 i=0; i<VF_PLANE_COUNT; ++i)
-			mat.transformPlane(planes[i]);
+		mat.transformPlanes(planes, VF_PLANE_COUNT);
 
 		mat.transformVect(cameraPosition);
 		recalculateBoundingBox();
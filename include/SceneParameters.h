@@ -174,6 +174,27 @@ namespace scene
 	**/
 	const c8* const DEBUG_NORMAL_COLOR = "DEBUG_Normal_Color";
 
+	//! Name of the parameter for setting a directory for binary mesh caches.
+	/** When set, ISceneManager::getMesh() writes every loaded mesh in the binary
+	.irrbin format into this directory and loads it from there the next time,
+	which is usually a lot faster than parsing the original file again. Caches
+	are replaced when the size or the content of the original file changes.
+	Meshes with frame based animations like .md2 are not cached. Use it like
+	this:
+	\code
+	SceneManager->getParameters()->setAttribute(scene::MESH_BINARY_CACHE_PATH, "path/to/cache");
+	\endcode
+	**/
+	const c8* const MESH_BINARY_CACHE_PATH = "MESH_BinaryCachePath";
+
+	//! Flag to write binary mesh caches zlib compressed
+	/** Saves disk space, but loading them gets slower. Use it like this:
+	\code
+	SceneManager->getParameters()->setAttribute(scene::MESH_BINARY_CACHE_COMPRESSED, true);
+	\endcode
+	**/
+	const c8* const MESH_BINARY_CACHE_COMPRESSED = "MESH_BinaryCacheCompressed";
+
 
 } // end namespace scene
 } // end namespace irr
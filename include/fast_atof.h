@@ -7,6 +7,7 @@
 
 #include "irrMath.h"
 #include "irrString.h"
+#include "coreutil.h"
 
 namespace irr
 {
@@ -39,13 +40,22 @@ const float fast_atof_table[17] = {
 	0.0000000000000001f
 };
 
+//! Exact powers of ten for fast_atof, the largest ones which fit into the mantissa of a f32 and a f64
+const f32 fast_atof_pow10_f32[11] = {
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+const f64 fast_atof_pow10_f64[23] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
 //! Convert a simple string of base 10 digits into an unsigned 32 bit integer.
 /** \param[in] in: The string of digits to convert. No leading chars are
     allowed, only digits 0 to 9. Parsing stops at the first non-digit.
     \param[out] out: (optional) If provided, it will be set to point at the
     first character not used in the calculation.
     \return The unsigned integer value of the digits. If the string specifies
-    too many digits to encode in an u32 then INT_MAX will be returned.
+    too many digits to encode in an u32 then 0xffffffff will be returned.
 */
 inline u32 strtoul10(const char* in, const char** out=0)
 {
@@ -60,14 +70,15 @@ inline u32 strtoul10(const char* in, const char** out=0)
 	u32 unsignedValue = 0;
 	while ( ( *in >= '0') && ( *in <= '9' ))
 	{
-		const u32 tmp = ( unsignedValue * 10 ) + ( *in - '0' );
-		if (tmp<unsignedValue)
+		const u32 digit = *in - '0';
+		// checking for a wrapped result is not enough, multiplying by 10 can wrap to a larger value
+		if (unsignedValue > (0xffffffff - digit) / 10)
 		{
 			unsignedValue=(u32)0xffffffff;
 			overflow=true;
 		}
 		if (!overflow)
-			unsignedValue = tmp;
+			unsignedValue = ( unsignedValue * 10 ) + digit;
 		++in;
 	}
 
@@ -300,8 +311,11 @@ inline f32 strtof10(const char* in, const char** out = 0)
 }
 
 //! Provides a fast function for converting a string into a float.
-/** This is not guaranteed to be as accurate as atof(), but is
-    approximately 6 to 8 times as fast.
+/** Up to 19 significant digits are collected in an integer and scaled by
+    the decimal exponent at the end. Where both the digits and the power of
+    ten are exact, which covers nearly all numbers found in mesh files, the
+    result is correctly rounded. Otherwise it is computed with doubles and
+    still accurate to a single bit.
     \param[in] in The string to convert.
     \param[out] result The resultant float will be written here.
     \return Pointer to the first character in the string that wasn't used
@@ -319,34 +333,69 @@ inline const char* fast_atof_move(const char* in, f32& result)
 	if (negative || ('+'==*in))
 		++in;
 
-	f32 value = strtof10(in, &in);
+	// Digits which don't fit anymore only change the exponent
+	const u32 MAX_DIGITS = 19;
+	u64 mantissa = 0;
+	u32 numDigits = 0;
+	s32 exponent = 0;
 
-	if ( LOCALE_DECIMAL_POINTS.findFirst(*in) >= 0 )
+	while ( ( *in >= '0') && ( *in <= '9' ) )
 	{
-		const char* afterDecimal = ++in;
-		f32 decimal = strtof10(in, &afterDecimal);
-		size_t numDecimals = afterDecimal - in;
-		if (numDecimals < IRR_ATOF_TABLE_SIZE)
+		if (numDigits < MAX_DIGITS)
 		{
-			value += decimal * fast_atof_table[numDecimals];
+			mantissa = (mantissa * 10) + (*in - '0');
+			if (mantissa) // leading zeros don't count
+				++numDigits;
 		}
 		else
+			++exponent;
+		++in;
+	}
+
+	if ( LOCALE_DECIMAL_POINTS.findFirst(*in) >= 0 )
+	{
+		++in;
+		while ( ( *in >= '0') && ( *in <= '9' ) )
 		{
-			value += decimal * (f32)pow(10.f, -(float)numDecimals);
+			if (numDigits < MAX_DIGITS)
+			{
+				mantissa = (mantissa * 10) + (*in - '0');
+				if (mantissa)
+					++numDigits;
+				--exponent;
+			}
+			++in;
 		}
-		in = afterDecimal;
 	}
 
 	if ('e' == *in || 'E' == *in)
 	{
 		++in;
-		// Assume that the exponent is a whole number.
-		// strtol10() will deal with both + and - signs,
-		// but calculate as f32 to prevent overflow at FLT_MAX
-		// Using pow with float cast instead of powf as otherwise accuracy decreases.
-		value *= (f32)pow(10.f, (f32)strtol10(in, &in));
+		// Clamped, so adding it can't overflow. Anything beyond is 0 or infinity anyway.
+		exponent += core::s32_clamp(strtol10(in, &in), -1000, 1000);
 	}
 
+	f32 value;
+	if (!mantissa)
+		value = 0.f;
+	else if (mantissa < (1<<24) && exponent >= -10 && exponent <= 10)
+	{
+		// both values are exact, so a single rounding step happens
+		if (exponent < 0)
+			value = (f32)mantissa / fast_atof_pow10_f32[-exponent];
+		else
+			value = (f32)mantissa * fast_atof_pow10_f32[exponent];
+	}
+	else if (mantissa <= ((u64)1<<53) && exponent >= -22 && exponent <= 22)
+	{
+		if (exponent < 0)
+			value = (f32)((f64)mantissa / fast_atof_pow10_f64[-exponent]);
+		else
+			value = (f32)((f64)mantissa * fast_atof_pow10_f64[exponent]);
+	}
+	else
+		value = (f32)((f64)mantissa * pow(10.0, (f64)exponent));
+
 	result = negative?-value:value;
 	return in;
 }
@@ -367,6 +416,88 @@ inline float fast_atof(const char* floatAsString, const char** out=0)
 	return ret;
 }
 
+//! Skip whitespace in a text.
+/** \param in Start of the text.
+    \param end End of the text. Can be 0 for 0-terminated text, scanning
+    also stops at a 0 character in any case.
+    \param acrossNewlines If false, stops at line breaks.
+    \return Pointer to the first character which is not whitespace, or end.
+*/
+inline const char* skipWhitespace(const char* in, const char* end, bool acrossNewlines=true)
+{
+	if (acrossNewlines)
+	{
+		while ((in != end) && core::isspace(*in))
+			++in;
+	}
+	else
+	{
+		while ((in != end) && core::isspace(*in) && (*in != '\n') && (*in != '\r'))
+			++in;
+	}
+	return in;
+}
+
+//! Skip a whitespace separated token in a text.
+/** \param in Start of the token.
+    \param end End of the text. Can be 0 for 0-terminated text.
+    \return Pointer to the first character behind the token.
+*/
+inline const char* skipToken(const char* in, const char* end)
+{
+	while ((in != end) && *in && !core::isspace(*in))
+		++in;
+	return in;
+}
+
+//! Find the end of the current line in a text.
+/** \param in Any position in the line.
+    \param end End of the text. Can be 0 for 0-terminated text.
+    \return Pointer to the first line break character, or end.
+*/
+inline const char* findLineEnd(const char* in, const char* end)
+{
+	while ((in != end) && *in && (*in != '\n') && (*in != '\r'))
+		++in;
+	return in;
+}
+
+//! Check if the token at the given position equals a string.
+/** \param in Start of the token.
+    \param end End of the text. Can be 0 for 0-terminated text.
+    \param token 0-terminated string to compare with.
+    \return True if the whitespace separated token equals the string.
+*/
+inline bool equalsToken(const char* in, const char* end, const char* token)
+{
+	while ((in != end) && *token && (*in == *token))
+	{
+		++in;
+		++token;
+	}
+	return !*token && ((in == end) || !*in || core::isspace(*in));
+}
+
+//! Read a float from the next token in a text, without copying it.
+/** Skips whitespace, converts the float with fast_atof_move and moves behind
+    the token. Tokens which are no number result in 0. The text must either be
+    0-terminated or continue with a character which can't be part of a number.
+    \param in Current position in the text.
+    \param end End of the text. Can be 0 for 0-terminated text.
+    \param[out] result The float read.
+    \param acrossNewlines If false, a missing number on the current line
+    results in 0 and the position stays at the line break.
+    \return Pointer to the first character behind the token.
+*/
+inline const char* fast_atof_token(const char* in, const char* end, f32& result, bool acrossNewlines=true)
+{
+	in = skipWhitespace(in, end, acrossNewlines);
+	result = 0.f;
+	if ((in == end) || (*in == '\n') || (*in == '\r'))
+		return in;
+	return skipToken(fast_atof_move(in, result), end);
+}
+
 } // end namespace core
 } // end namespace irr
 
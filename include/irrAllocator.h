@@ -103,6 +103,358 @@ public:
 
 
 
+//! Linear memory arena, for memory which is released all at once.
+/** Allocations just move a pointer forward in a block. Nothing is freed
+before reset(), which makes all memory of the arena available again. Used
+for example for temporary arrays which only live during one frame. The
+arena is not thread safe. */
+class irrMemoryArena
+{
+public:
+
+	//! Constructor
+	/** \param blockSize Size of the memory blocks requested from the heap. */
+	explicit irrMemoryArena(size_t blockSize=65536)
+		: Blocks(0), BlockSize(blockSize), Allocations(0), HeapAllocations(0)
+	{
+	}
+
+	//! Destructor, frees all blocks
+	~irrMemoryArena()
+	{
+		freeBlocks();
+	}
+
+	//! Allocate memory, aligned to 16 bytes
+	void* allocate(size_t size)
+	{
+		size = (size + 15) & ~(size_t)15;
+		++Allocations;
+
+		if (!Blocks || Blocks->Used + size > Blocks->Size)
+			addBlock(size > BlockSize ? size : BlockSize);
+
+		void* ptr = Blocks->data() + Blocks->Used;
+		Blocks->Used += size;
+		return ptr;
+	}
+
+	//! Check if the memory was allocated by this arena
+	bool owns(const void* ptr) const
+	{
+		for (const SBlock* b=Blocks; b; b=b->Next)
+		{
+			if ((const u8*)ptr >= b->data() && (const u8*)ptr < b->data() + b->Size)
+				return true;
+		}
+		return false;
+	}
+
+	//! Makes all memory available again
+	/** Memory allocated from the arena must not be used anymore. When more
+	than one block was needed, they are replaced by a single block large
+	enough for all of them, so the next use needs no heap allocations. */
+	void reset()
+	{
+		if (Blocks && Blocks->Next)
+		{
+			size_t total = 0;
+			for (const SBlock* b=Blocks; b; b=b->Next)
+				total += b->Size;
+			freeBlocks();
+			addBlock(total);
+		}
+		else if (Blocks)
+			Blocks->Used = 0;
+	}
+
+	//! Get the number of allocations done by the arena
+	u32 getAllocationCount() const { return Allocations; }
+
+	//! Get the number of blocks the arena requested from the heap
+	u32 getHeapAllocationCount() const { return HeapAllocations; }
+
+private:
+
+	struct SBlock
+	{
+		SBlock* Next;
+		size_t Size;
+		size_t Used;
+
+		// the header is padded to 16 bytes to keep the alignment
+		u8* data() { return (u8*)this + ((sizeof(SBlock) + 15) & ~(size_t)15); }
+		const u8* data() const { return (const u8*)this + ((sizeof(SBlock) + 15) & ~(size_t)15); }
+	};
+
+	void addBlock(size_t size)
+	{
+		SBlock* b = (SBlock*)operator new(((sizeof(SBlock) + 15) & ~(size_t)15) + size);
+		b->Next = Blocks;
+		b->Size = size;
+		b->Used = 0;
+		Blocks = b;
+		++HeapAllocations;
+	}
+
+	void freeBlocks()
+	{
+		while (Blocks)
+		{
+			SBlock* next = Blocks->Next;
+			operator delete(Blocks);
+			Blocks = next;
+		}
+	}
+
+	// not copyable
+	irrMemoryArena(const irrMemoryArena&);
+	irrMemoryArena& operator=(const irrMemoryArena&);
+
+	SBlock* Blocks;
+	size_t BlockSize;
+	u32 Allocations;
+	u32 HeapAllocations;
+};
+
+
+//! Allocator which takes its memory from an irrMemoryArena.
+/** Set the arena with setArena() before the container allocates anything,
+without arena it works like irrAllocatorFast. Deallocating memory of the
+arena does nothing, the memory is only released by irrMemoryArena::reset().
+So containers using it must be destroyed or cleared before the arena is
+reset. */
+template<typename T>
+class irrAllocatorArena
+{
+public:
+
+	irrAllocatorArena() : Arena(0) {}
+
+	//! Set the arena to allocate from
+	void setArena(irrMemoryArena* arena)
+	{
+		Arena = arena;
+	}
+
+	//! Get the arena the memory is allocated from
+	irrMemoryArena* getArena() const
+	{
+		return Arena;
+	}
+
+	//! Allocate memory for an array of objects
+	T* allocate(size_t cnt)
+	{
+		if (Arena)
+			return (T*)Arena->allocate(cnt* sizeof(T));
+		return (T*)operator new(cnt* sizeof(T));
+	}
+
+	//! Deallocate memory for an array of objects
+	void deallocate(T* ptr)
+	{
+		if (!Arena || !Arena->owns(ptr))
+			operator delete(ptr);
+	}
+
+	//! Construct an element
+	void construct(T* ptr, const T&e)
+	{
+		new ((void*)ptr) T(e);
+	}
+
+	//! Destruct an element
+	void destruct(T* ptr)
+	{
+		ptr->~T();
+	}
+
+private:
+
+	irrMemoryArena* Arena;
+};
+
+
+//! Allocator for single objects of the same size, like the nodes of core::list and core::map.
+/** Objects are taken from chunks of 64 objects, freed objects are reused. The chunks are only released when the allocator is destroyed.
+Each allocator has its own pool, so copies of it start empty. Only
+allocations of single objects are possible. */
+template<typename T>
+class irrAllocatorPool
+{
+public:
+
+	irrAllocatorPool() : Chunks(0), FreeList(0), Allocations(0), HeapAllocations(0) {}
+
+	irrAllocatorPool(const irrAllocatorPool&) : Chunks(0), FreeList(0), Allocations(0), HeapAllocations(0) {}
+
+	~irrAllocatorPool()
+	{
+		while (Chunks)
+		{
+			SChunk* next = Chunks->Next;
+			operator delete(Chunks);
+			Chunks = next;
+		}
+	}
+
+	//! Allocate memory for one object
+	T* allocate(size_t cnt)
+	{
+		_IRR_DEBUG_BREAK_IF(cnt != 1) // only single objects are pooled
+
+		if (!FreeList)
+		{
+			SChunk* chunk = (SChunk*)operator new(sizeof(SChunk));
+			chunk->Next = Chunks;
+			Chunks = chunk;
+			for (u32 i=0; i<NodesPerChunk; ++i)
+			{
+				chunk->Nodes[i].Next = FreeList;
+				FreeList = &chunk->Nodes[i];
+			}
+			++HeapAllocations;
+		}
+
+		SNode* node = FreeList;
+		FreeList = node->Next;
+		++Allocations;
+		return (T*)node->Data;
+	}
+
+	//! Deallocate memory of one object
+	void deallocate(T* ptr)
+	{
+		if (!ptr)
+			return;
+		SNode* node = (SNode*)ptr;
+		node->Next = FreeList;
+		FreeList = node;
+	}
+
+	//! Construct an element
+	void construct(T* ptr, const T&e)
+	{
+		new ((void*)ptr) T(e);
+	}
+
+	//! Destruct an element
+	void destruct(T* ptr)
+	{
+		ptr->~T();
+	}
+
+	//! Swap the pools, used when swapping containers
+	void swap(irrAllocatorPool& other)
+	{
+		SChunk* chunks = Chunks;
+		Chunks = other.Chunks;
+		other.Chunks = chunks;
+		SNode* freeList = FreeList;
+		FreeList = other.FreeList;
+		other.FreeList = freeList;
+	}
+
+	//! Get the number of allocations done by the allocator
+	u32 getAllocationCount() const { return Allocations; }
+
+	//! Get the number of chunks the allocator requested from the heap
+	u32 getHeapAllocationCount() const { return HeapAllocations; }
+
+private:
+
+	union SNode
+	{
+		SNode* Next;
+		// double keeps the alignment of the objects
+		double Align;
+		u8 Data[sizeof(T)];
+	};
+
+	enum { NodesPerChunk = 64 };
+
+	struct SChunk
+	{
+		SChunk* Next;
+		SNode Nodes[NodesPerChunk];
+	};
+
+	// only containers swap their allocators
+	irrAllocatorPool& operator=(const irrAllocatorPool&);
+
+	SChunk* Chunks;
+	SNode* FreeList;
+	u32 Allocations;
+	u32 HeapAllocations;
+};
+
+//! swaps two pool allocators, copying them would lose their pools
+template<typename T>
+inline void swap(irrAllocatorPool<T>& a, irrAllocatorPool<T>& b)
+{
+	a.swap(b);
+}
+
+
+//! Allocator with a buffer for N objects inside of it, for small string optimization.
+/** Allocations of up to N objects return the internal buffer, so strings
+using it, like core::string<c8, irrAllocatorSmall<c8, 32> >, need no heap
+memory as long as they are short. It relies on the way core::string uses
+its allocator: the old memory is copied into the new one with the same
+offsets and the internal buffer is never released. So it is not usable for
+other containers, which could hold two different allocations of the buffer
+at the same time. */
+template<typename T, u32 N=16>
+class irrAllocatorSmall
+{
+public:
+
+	irrAllocatorSmall() : HeapAllocations(0) {}
+
+	irrAllocatorSmall(const irrAllocatorSmall&) : HeapAllocations(0) {}
+
+	//! Allocate memory for an array of objects
+	T* allocate(size_t cnt)
+	{
+		if (cnt <= N)
+			return Buffer;
+		++HeapAllocations;
+		return (T*)operator new(cnt* sizeof(T));
+	}
+
+	//! Deallocate memory for an array of objects
+	void deallocate(T* ptr)
+	{
+		if (ptr != Buffer)
+			operator delete(ptr);
+	}
+
+	//! Construct an element
+	void construct(T* ptr, const T&e)
+	{
+		new ((void*)ptr) T(e);
+	}
+
+	//! Destruct an element
+	void destruct(T* ptr)
+	{
+		ptr->~T();
+	}
+
+	//! Get the number of allocations which needed the heap
+	u32 getHeapAllocationCount() const { return HeapAllocations; }
+
+private:
+
+	// the buffer must not be copied, it belongs to this allocator
+	irrAllocatorSmall& operator=(const irrAllocatorSmall&);
+
+	T Buffer[N];
+	u32 HeapAllocations;
+};
+
+
 #ifdef DEBUG_CLIENTBLOCK
 #undef DEBUG_CLIENTBLOCK
 #define DEBUG_CLIENTBLOCK new( _CLIENT_BLOCK, __FILE__, __LINE__)
@@ -113,7 +465,7 @@ enum eAllocStrategy
 {
 	ALLOC_STRATEGY_SAFE    = 0,	// increase size by 1
 	ALLOC_STRATEGY_DOUBLE  = 1,	// double size when under 500 elements, beyond that increase by 1/4th size. Plus a small constant.
-	ALLOC_STRATEGY_SQRT    = 2	// not implemented
+	ALLOC_STRATEGY_SQRT    = 2	// increase size by the square root of the size. Less memory overhead than ALLOC_STRATEGY_DOUBLE, but more copies.
 };
 
 
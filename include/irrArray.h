@@ -147,6 +147,9 @@ public:
 				case ALLOC_STRATEGY_DOUBLE:
 					newAlloc = used + 5 + (allocated < 500 ? used : used >> 2);
 					break;
+				case ALLOC_STRATEGY_SQRT:
+					newAlloc = used + 1 + (u32)core::squareroot((f32)used);
+					break;
 				default:
 				case ALLOC_STRATEGY_SAFE:
 					newAlloc = used + 1;
@@ -604,6 +607,20 @@ public:
 		other.is_sorted = helper_is_sorted;
 	}
 
+	//! Get the allocator of the array
+	/** Allows to configure allocators like irrAllocatorArena before the
+	array allocates memory. */
+	TAlloc& getAllocator()
+	{
+		return allocator;
+	}
+
+	//! Get the allocator of the array
+	const TAlloc& getAllocator() const
+	{
+		return allocator;
+	}
+
 	typedef TAlloc allocator_type;
 	typedef T value_type;
 	typedef u32 size_type;
@@ -0,0 +1,502 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_HASH_MAP_H_INCLUDED__
+#define __IRR_HASH_MAP_H_INCLUDED__
+
+#include "irrTypes.h"
+#include "irrAllocator.h"
+#include "irrMath.h"
+#include "irrArray.h"
+#include "irrString.h"
+
+namespace irr
+{
+namespace core
+{
+
+//! Hash functor used by hash_map and hash_set
+/** Specializations exist for integers, pointers and strings. For other key
+types a specialization or another functor has to be provided. */
+template <class T>
+struct hash;
+
+template <> struct hash<s32> { u32 operator()(s32 k) const { return (u32)k; } };
+template <> struct hash<u32> { u32 operator()(u32 k) const { return k; } };
+template <> struct hash<s16> { u32 operator()(s16 k) const { return (u32)k; } };
+template <> struct hash<u16> { u32 operator()(u16 k) const { return k; } };
+template <> struct hash<c8> { u32 operator()(c8 k) const { return (u32)k; } };
+template <> struct hash<u8> { u32 operator()(u8 k) const { return k; } };
+
+//! Hash of pointers
+template <class T>
+struct hash<T*>
+{
+	u32 operator()(const T* k) const
+	{
+		const size_t p = (size_t)k;
+		// the lowest bits are always 0 because of the alignment
+		return (u32)(p >> 4) ^ (u32)((u64)p >> 32);
+	}
+};
+
+//! Hash of strings, FNV-1a over the characters
+template <class T, class TAlloc>
+struct hash<string<T, TAlloc> >
+{
+	u32 operator()(const string<T, TAlloc>& k) const
+	{
+		u32 h = 2166136261u;
+		for (u32 i=0; i<k.size(); ++i)
+		{
+			h ^= (u32)k[i];
+			h *= 16777619u;
+		}
+		return h;
+	}
+};
+
+
+//! Unordered map using open addressing with Robin Hood hashing
+/** Insertion, lookup and removal take constant time on average. The
+elements are kept densely in an array, the hash table only holds their
+indices, so growing the table never copies keys or values. The table is
+enlarged when it gets filled to 7/8th. Iterators and pointers to values are
+invalidated by insert and remove. */
+template <class KeyType, class ValueType, class THash = hash<KeyType> >
+class hash_map
+{
+	struct SEntry
+	{
+		SEntry(const KeyType& k, const ValueType& v, u32 h) : Key(k), Value(v), Hash(h) {}
+
+		KeyType Key;
+		ValueType Value;
+		u32 Hash;
+	};
+
+	struct SSlot
+	{
+		// distance from the home slot +1, 0 is an empty slot
+		u32 Distance;
+		u32 Hash;
+		u32 Index;
+	};
+
+public:
+
+	//! Iterator over all elements, in no particular order
+	class Iterator
+	{
+	public:
+		Iterator() : Map(0), Index(0) {}
+
+		bool atEnd() const { return !Map || Index >= Map->Entries.size(); }
+
+		const KeyType& getKey() const { return Map->Entries[Index].Key; }
+		ValueType& getValue() const { return Map->Entries[Index].Value; }
+
+		Iterator& operator++() { ++Index; return *this; }
+		void operator++(int) { ++Index; }
+
+	private:
+		friend class hash_map<KeyType, ValueType, THash>;
+
+		Iterator(hash_map* map) : Map(map), Index(0) {}
+
+		hash_map* Map;
+		u32 Index;
+	};
+
+	//! Const iterator over all elements, in no particular order
+	class ConstIterator
+	{
+	public:
+		ConstIterator() : Map(0), Index(0) {}
+
+		bool atEnd() const { return !Map || Index >= Map->Entries.size(); }
+
+		const KeyType& getKey() const { return Map->Entries[Index].Key; }
+		const ValueType& getValue() const { return Map->Entries[Index].Value; }
+
+		ConstIterator& operator++() { ++Index; return *this; }
+		void operator++(int) { ++Index; }
+
+	private:
+		friend class hash_map<KeyType, ValueType, THash>;
+
+		ConstIterator(const hash_map* map) : Map(map), Index(0) {}
+
+		const hash_map* Map;
+		u32 Index;
+	};
+
+	//! Default constructor
+	hash_map() : Slots(0), Capacity(0), Shift(32) {}
+
+	//! Copy constructor
+	hash_map(const hash_map& other) : Slots(0), Capacity(0), Shift(32)
+	{
+		*this = other;
+	}
+
+	//! Destructor
+	~hash_map()
+	{
+		clear();
+	}
+
+	//! Assignment operator
+	hash_map& operator=(const hash_map& other)
+	{
+		if (this == &other)
+			return *this;
+
+		clear();
+		Entries = other.Entries;
+		if (other.Capacity)
+		{
+			Slots = allocator.allocate(other.Capacity);
+			for (u32 i=0; i<other.Capacity; ++i)
+				Slots[i] = other.Slots[i];
+		}
+		Capacity = other.Capacity;
+		Shift = other.Shift;
+		return *this;
+	}
+
+	//! Inserts a new element
+	/** \return True if successful, false if the key already exists. */
+	bool insert(const KeyType& key, const ValueType& value)
+	{
+		const u32 h = Hash(key);
+		if (findSlot(key, h) >= 0)
+			return false;
+		insertNew(key, value, h);
+		return true;
+	}
+
+	//! Replaces the value if the key already exists, otherwise inserts a new element.
+	void set(const KeyType& key, const ValueType& value)
+	{
+		const u32 h = Hash(key);
+		const s32 slot = findSlot(key, h);
+		if (slot >= 0)
+			Entries[Slots[slot].Index].Value = value;
+		else
+			insertNew(key, value, h);
+	}
+
+	//! Returns the value of a key, inserting a default constructed one if it does not exist
+	ValueType& operator[](const KeyType& key)
+	{
+		const u32 h = Hash(key);
+		const s32 slot = findSlot(key, h);
+		if (slot >= 0)
+			return Entries[Slots[slot].Index].Value;
+		return *insertNew(key, ValueType(), h);
+	}
+
+	//! Finds the value of a key
+	/** \return Pointer to the value, or 0 if the key does not exist. */
+	ValueType* find(const KeyType& key)
+	{
+		const s32 slot = findSlot(key, Hash(key));
+		return (slot >= 0) ? &Entries[Slots[slot].Index].Value : 0;
+	}
+
+	//! Finds the value of a key
+	/** \return Pointer to the value, or 0 if the key does not exist. */
+	const ValueType* find(const KeyType& key) const
+	{
+		const s32 slot = findSlot(key, Hash(key));
+		return (slot >= 0) ? &Entries[Slots[slot].Index].Value : 0;
+	}
+
+	//! Removes an element
+	/** \return True if the key was found and removed. */
+	bool remove(const KeyType& key)
+	{
+		const s32 slot = findSlot(key, Hash(key));
+		if (slot < 0)
+			return false;
+
+		const u32 index = Slots[slot].Index;
+		removeSlot((u32)slot);
+
+		// the last entry fills the gap in the array
+		const u32 last = Entries.size() - 1;
+		if (index != last)
+		{
+			u32 i = homeIndex(Entries[last].Hash);
+			while (Slots[i].Index != last || !Slots[i].Distance)
+				i = (i + 1) & (Capacity - 1);
+			Slots[i].Index = index;
+			Entries[index] = Entries[last];
+		}
+		Entries.erase(last);
+		return true;
+	}
+
+	//! Removes all elements and frees the memory
+	void clear()
+	{
+		Entries.clear();
+		allocator.deallocate(Slots);
+		Slots = 0;
+		Capacity = 0;
+		Shift = 32;
+	}
+
+	//! Makes room for a number of elements, so nothing is reallocated while inserting them
+	void reallocate(u32 count)
+	{
+		if (count > Entries.allocated_size())
+			Entries.reallocate(count);
+
+		u32 capacity = 8;
+		while (capacity - (capacity >> 3) < count)
+			capacity <<= 1;
+		if (capacity > Capacity)
+			rehash(capacity);
+	}
+
+	//! Returns the number of elements
+	u32 size() const
+	{
+		return Entries.size();
+	}
+
+	//! Returns true if there are no elements
+	bool empty() const
+	{
+		return Entries.empty();
+	}
+
+	//! Returns an iterator over all elements
+	Iterator getIterator()
+	{
+		return Iterator(this);
+	}
+
+	//! Returns a const iterator over all elements
+	ConstIterator getConstIterator() const
+	{
+		return ConstIterator(this);
+	}
+
+	//! Swaps the content with another hash_map
+	void swap(hash_map& other)
+	{
+		Entries.swap(other.Entries);
+		core::swap(Slots, other.Slots);
+		core::swap(Capacity, other.Capacity);
+		core::swap(Shift, other.Shift);
+		core::swap(allocator, other.allocator);
+	}
+
+private:
+
+	//! home slot of a hash, Fibonacci hashing spreads weak hashes
+	u32 homeIndex(u32 h) const
+	{
+		return (h * 2654435769u) >> Shift;
+	}
+
+	s32 findSlot(const KeyType& key, u32 h) const
+	{
+		if (!Capacity)
+			return -1;
+
+		u32 i = homeIndex(h);
+		for (u32 dist=1; Slots[i].Distance >= dist; ++dist)
+		{
+			if (Slots[i].Distance == dist && Slots[i].Hash == h && Entries[Slots[i].Index].Key == key)
+				return (s32)i;
+			i = (i + 1) & (Capacity - 1);
+		}
+		return -1;
+	}
+
+	//! inserts a key which is not in the map yet
+	ValueType* insertNew(const KeyType& key, const ValueType& value, u32 h)
+	{
+		if (Entries.size() + 1 > Capacity - (Capacity >> 3))
+			rehash(Capacity ? Capacity << 1 : 8);
+
+		Entries.push_back(SEntry(key, value, h));
+
+		SSlot slot;
+		slot.Distance = 1;
+		slot.Hash = h;
+		slot.Index = Entries.size() - 1;
+		insertSlot(slot);
+
+		return &Entries.getLast().Value;
+	}
+
+	void insertSlot(SSlot slot)
+	{
+		u32 i = homeIndex(slot.Hash);
+		for (;;)
+		{
+			if (!Slots[i].Distance)
+			{
+				Slots[i] = slot;
+				return;
+			}
+
+			// Robin Hood: take the place of elements closer to their home
+			if (Slots[i].Distance < slot.Distance)
+				core::swap(slot, Slots[i]);
+
+			i = (i + 1) & (Capacity - 1);
+			++slot.Distance;
+		}
+	}
+
+	//! shifts the following slots back, so no tombstones are needed
+	void removeSlot(u32 i)
+	{
+		u32 next = (i + 1) & (Capacity - 1);
+		while (Slots[next].Distance > 1)
+		{
+			Slots[i] = Slots[next];
+			--Slots[i].Distance;
+			i = next;
+			next = (i + 1) & (Capacity - 1);
+		}
+		Slots[i].Distance = 0;
+	}
+
+	void rehash(u32 capacity)
+	{
+		SSlot* oldSlots = Slots;
+		const u32 oldCapacity = Capacity;
+
+		Slots = allocator.allocate(capacity);
+		for (u32 i=0; i<capacity; ++i)
+			Slots[i].Distance = 0;
+		Capacity = capacity;
+		Shift = 32;
+		while (capacity > 1)
+		{
+			--Shift;
+			capacity >>= 1;
+		}
+
+		for (u32 i=0; i<oldCapacity; ++i)
+		{
+			if (oldSlots[i].Distance)
+			{
+				SSlot slot = oldSlots[i];
+				slot.Distance = 1;
+				insertSlot(slot);
+			}
+		}
+		allocator.deallocate(oldSlots);
+	}
+
+	array<SEntry> Entries;
+	SSlot* Slots;
+	u32 Capacity;
+	u32 Shift;
+	THash Hash;
+	irrAllocator<SSlot> allocator;
+};
+
+
+//! Unordered set using open addressing, see hash_map
+template <class KeyType, class THash = hash<KeyType> >
+class hash_set
+{
+public:
+
+	//! Iterator over all elements, in no particular order
+	class ConstIterator
+	{
+	public:
+		ConstIterator() {}
+
+		bool atEnd() const { return It.atEnd(); }
+		const KeyType& getKey() const { return It.getKey(); }
+
+		ConstIterator& operator++() { ++It; return *this; }
+		void operator++(int) { ++It; }
+
+	private:
+		friend class hash_set<KeyType, THash>;
+
+		ConstIterator(const typename hash_map<KeyType, bool, THash>::ConstIterator& it) : It(it) {}
+
+		typename hash_map<KeyType, bool, THash>::ConstIterator It;
+	};
+
+	//! Inserts a key
+	/** \return True if successful, false if the key already exists. */
+	bool insert(const KeyType& key)
+	{
+		return Map.insert(key, true);
+	}
+
+	//! Returns true if the key is in the set
+	bool contains(const KeyType& key) const
+	{
+		return Map.find(key) != 0;
+	}
+
+	//! Removes a key
+	/** \return True if the key was found and removed. */
+	bool remove(const KeyType& key)
+	{
+		return Map.remove(key);
+	}
+
+	//! Removes all keys and frees the memory
+	void clear()
+	{
+		Map.clear();
+	}
+
+	//! Makes room for a number of keys
+	void reallocate(u32 count)
+	{
+		Map.reallocate(count);
+	}
+
+	//! Returns the number of keys
+	u32 size() const
+	{
+		return Map.size();
+	}
+
+	//! Returns true if there are no keys
+	bool empty() const
+	{
+		return Map.empty();
+	}
+
+	//! Returns an iterator over all keys
+	ConstIterator getConstIterator() const
+	{
+		return ConstIterator(Map.getConstIterator());
+	}
+
+	//! Swaps the content with another hash_set
+	void swap(hash_set& other)
+	{
+		Map.swap(other.Map);
+	}
+
+private:
+
+	hash_map<KeyType, bool, THash> Map;
+};
+
+
+} // end namespace core
+} // end namespace irr
+
+#endif
+
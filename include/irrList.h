@@ -16,7 +16,9 @@ namespace core
 
 
 //! Doubly linked list template.
-template <class T>
+/** The nodes are allocated with TAlloc<SKListNode>, irrAllocatorPool can
+be used to avoid a heap allocation for each element. */
+template <class T, template<class> class TAlloc = irrAllocator>
 class list
 {
 private:
@@ -75,7 +77,7 @@ public:
 
 		SKListNode* Current;
 
-		friend class list<T>;
+		friend class list<T, TAlloc>;
 		friend class ConstIterator;
 	};
 
@@ -125,7 +127,7 @@ public:
 		SKListNode* Current;
 
 		friend class Iterator;
-		friend class list<T>;
+		friend class list<T, TAlloc>;
 	};
 
 	//! Default constructor for empty list.
@@ -134,7 +136,7 @@ public:
 
 
 	//! Copy constructor.
-	list(const list<T>& other) : First(0), Last(0), Size(0)
+	list(const list<T, TAlloc>& other) : First(0), Last(0), Size(0)
 	{
 		*this = other;
 	}
@@ -148,7 +150,7 @@ public:
 
 
 	//! Assignment operator
-	void operator=(const list<T>& other)
+	void operator=(const list<T, TAlloc>& other)
 	{
 		if(&other == this)
 		{
@@ -386,7 +388,7 @@ public:
 	object will contain the content of this object. Iterators will afterward be valid for
 	the swapped object.
 	\param other Swap content with this object */
-	void swap(list<T>& other)
+	void swap(list<T, TAlloc>& other)
 	{
 		core::swap(First, other.First);
 		core::swap(Last, other.Last);
@@ -394,6 +396,12 @@ public:
 		core::swap(allocator, other.allocator); // memory is still released by the same allocator used for allocation
 	}
 
+	//! Get the allocator of the list nodes
+	const TAlloc<SKListNode>& getAllocator() const
+	{
+		return allocator;
+	}
+
 	typedef T value_type;
 	typedef u32 size_type;
 
@@ -402,7 +410,7 @@ private:
 	SKListNode* First;
 	SKListNode* Last;
 	u32 Size;
-	irrAllocator<SKListNode> allocator;
+	TAlloc<SKListNode> allocator;
 
 };
 
@@ -6,6 +6,7 @@
 #define __IRR_MAP_H_INCLUDED__
 
 #include "irrTypes.h"
+#include "irrAllocator.h"
 #include "irrMath.h"
 
 namespace irr
@@ -14,7 +15,9 @@ namespace core
 {
 
 //! map template for associative arrays using a red-black tree
-template <class KeyType, class ValueType>
+/** The nodes are allocated with TAlloc, irrAllocatorPool can be used to
+avoid a heap allocation for each element. */
+template <class KeyType, class ValueType, template<class> class TAlloc = irrAllocator>
 class map
 {
 	//! red/black tree for map
@@ -622,7 +625,7 @@ class map
 	class AccessClass
 	{
 		// Let map be the only one who can instantiate this class.
-		friend class map<KeyType, ValueType>;
+		friend class map<KeyType, ValueType, TAlloc>;
 
 	public:
 
@@ -680,10 +683,12 @@ class map
 	bool insert(const KeyType& keyNew, const ValueType& v)
 	{
 		// First insert node the "usual" way (no fancy balance logic yet)
-		Node* newNode = new Node(keyNew,v);
+		Node* newNode = allocator.allocate(1);
+		allocator.construct(newNode, Node(keyNew,v));
 		if (!insert(newNode))
 		{
-			delete newNode;
+			allocator.destruct(newNode);
+			allocator.deallocate(newNode);
 			return false;
 		}
 
@@ -768,7 +773,8 @@ class map
 	}
 
 	//! Removes a node from the tree and returns it.
-	/** The returned node must be deleted by the user
+	/** The returned node must be deleted by the user. Only usable with
+	the default allocator, other allocators still own the node memory.
 	\param k the key to remove
 	\return A pointer to the node, or 0 if not found */
 	Node* delink(const KeyType& k)
@@ -851,7 +857,8 @@ class map
 
 		// p is now gone from the tree in the sense that
 		// no one is pointing at it. Let's get rid of it.
-		delete p;
+		allocator.destruct(p);
+		allocator.deallocate(p);
 
 		--Size;
 		return true;
@@ -867,7 +874,8 @@ class map
 			Node* p = i.getNode();
 			i++; // Increment it before it is deleted
 				// else iterator will get quite confused.
-			delete p;
+			allocator.destruct(p);
+			allocator.deallocate(p);
 		}
 		Root = 0;
 		Size= 0;
@@ -927,10 +935,17 @@ class map
 	object will contain the content of this object. Iterators will afterwards be valid for
 	the swapped object.
 	\param other Swap content with this object */
-	void swap(map<KeyType, ValueType>& other)
+	void swap(map<KeyType, ValueType, TAlloc>& other)
 	{
 		core::swap(Root, other.Root);
 		core::swap(Size, other.Size);
+		core::swap(allocator, other.allocator); // memory is still released by the same allocator used for allocation
+	}
+
+	//! Get the allocator of the map nodes
+	const TAlloc<Node>& getAllocator() const
+	{
+		return allocator;
 	}
 
 	//------------------------------
@@ -1105,6 +1120,7 @@ class map
 	//------------------------------
 	Node* Root; // The top node. 0 if empty.
 	u32 Size; // Number of nodes in the tree
+	TAlloc<Node> allocator;
 };
 
 } // end namespace core
@@ -945,17 +945,17 @@ public:
 	/** \param begin Start of substring.
 	\param length Length of substring.
 	\param make_lower copy only lower case */
-	string<T> subString(u32 begin, s32 length, bool make_lower = false ) const
+	string<T,TAlloc> subString(u32 begin, s32 length, bool make_lower = false ) const
 	{
 		// if start after string
 		// or no proper substring length
 		if ((length <= 0) || (begin>=size()))
-			return string<T>("");
+			return string<T,TAlloc>("");
 		// clamp length to maximal value
 		if ((length+begin) > size())
 			length = size()-begin;
 
-		string<T> o;
+		string<T,TAlloc> o;
 		o.reserve(length+1);
 
 		s32 i;
@@ -1423,6 +1423,12 @@ public:
 		return ret.size()-oldSize;
 	}
 
+	//! Get the allocator of the string
+	const TAlloc& getAllocator() const
+	{
+		return allocator;
+	}
+
 	friend size_t multibyteToWString(string<wchar_t>& destination, const char* source, u32 sourceSize);
 
 private:
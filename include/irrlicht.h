@@ -119,13 +119,16 @@
 #include "IOctreeSceneNode.h"
 #include "IColladaMeshWriter.h"
 #include "IMetaTriangleSelector.h"
+#include "IOcclusionCuller.h"
 #include "IOSOperator.h"
 #include "IParticleSystemSceneNode.h" // also includes all emitters and attractors
 #include "IQ3LevelMesh.h"
+#include "IQ3LevelSceneNode.h"
 #include "IQ3Shader.h"
 #include "IReadFile.h"
 #include "IReferenceCounted.h"
 #include "irrArray.h"
+#include "irrHashMap.h"
 #include "IRandomizer.h"
 #include "IRenderTarget.h"
 #include "IrrlichtDevice.h"
@@ -150,10 +153,13 @@
 #include "IShaderConstantSetCallBack.h"
 #include "IShadowVolumeSceneNode.h"
 #include "ISkinnedMesh.h"
+#include "IStaticBatchSceneNode.h"
 #include "ITerrainSceneNode.h"
+#include "ITiledTerrainSceneNode.h"
 #include "ITextSceneNode.h"
 #include "ITexture.h"
 #include "ITimer.h"
+#include "ITransformHierarchy.h"
 #include "ITriangleSelector.h"
 #include "IVertexBuffer.h"
 #include "IVideoDriver.h"
@@ -187,6 +193,7 @@
 #include "SParticle.h"
 #include "SSharedMeshBuffer.h"
 #include "SSkinMeshBuffer.h"
+#include "SStreamAllocation.h"
 #include "SVertexIndex.h"
 #include "SViewFrustum.h"
 #include "triangle3d.h"
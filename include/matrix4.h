@@ -13,6 +13,10 @@
 #include "rect.h"
 #include "irrString.h"
 
+#if defined(_IRR_USE_SSE2_)
+#include <emmintrin.h>
+#endif
+
 // enable this to keep track of changes to the matrix
 // and make simpler identity check for seldom changing matrices
 // otherwise identity check will always compare the elements
@@ -39,6 +43,34 @@ namespace irr
 namespace core
 {
 
+#if defined(_IRR_USE_SSE2_)
+	//! Loads 4 vectors into one register per component
+	inline void loadVects4(const vector3df* in, __m128& x, __m128& y, __m128& z)
+	{
+		// a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+		const __m128 a = _mm_loadu_ps(&in[0].X);
+		const __m128 b = _mm_loadu_ps(&in[1].Y);
+		const __m128 c = _mm_loadu_ps(&in[2].Z);
+		const __m128 ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1,0,2,1));	// y0 z0 y1 z1
+		const __m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,1,3,2));	// x2 y2 x3 y3
+		x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(2,0,3,0));
+		y = _mm_shuffle_ps(ab, bc, _MM_SHUFFLE(3,1,2,0));
+		z = _mm_shuffle_ps(ab, c, _MM_SHUFFLE(3,0,3,1));
+	}
+
+	//! Stores 4 vectors from one register per component
+	inline void storeVects4(vector3df* out, const __m128& x, const __m128& y, const __m128& z)
+	{
+		const __m128 yz = _mm_unpacklo_ps(y, z);	// y0 z0 y1 z1
+		const __m128 xy = _mm_unpackhi_ps(x, y);	// x2 y2 x3 y3
+		const __m128 a = _mm_shuffle_ps(x, yz, _MM_SHUFFLE(1,0,1,0));	// x0 x1 y0 z0
+		const __m128 c = _mm_shuffle_ps(xy, z, _MM_SHUFFLE(3,2,3,2));	// x3 y3 z2 z3
+		_mm_storeu_ps(&out[0].X, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1,3,2,0)));
+		_mm_storeu_ps(&out[1].Y, _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(1,0,3,2)));
+		_mm_storeu_ps(&out[2].Z, _mm_shuffle_ps(c, c, _MM_SHUFFLE(3,1,0,2)));
+	}
+#endif
+
 	//! 4x4 matrix. Mostly used as transformation matrix for 3d calculations.
 	/** The matrix is a D3D style matrix, row major with translations in the 4th row. */
 	template <class T>
@@ -274,6 +306,29 @@ namespace core
 			is slower than transformBox(). */
 			void transformBoxEx(core::aabbox3d<f32>& box) const;
 
+			//! Transforms an array of vectors by this matrix
+			/** Faster than calling transformVect() for each vector. This
+			operation is performed as if the vectors were 4d with the 4th
+			component =1.
+			\param out Array which receives count vectors, can be the same as in.
+			\param in Array of count vectors.
+			\param count Number of vectors. */
+			void transformVects(vector3df* out, const vector3df* in, u32 count) const;
+
+			//! Rotates an array of vectors by the rotation part of this matrix
+			/** \param out Array which receives count vectors, can be the same as in.
+			\param in Array of count vectors.
+			\param count Number of vectors. */
+			void rotateVects(vector3df* out, const vector3df* in, u32 count) const;
+
+			//! Transforms an array of axis aligned bounding boxes like transformBoxEx()
+			void transformBoxesEx(core::aabbox3d<f32>* boxes, u32 count) const;
+
+			//! Transforms an array of planes by this matrix
+			/** Faster than calling transformPlane() for each plane, as the
+			transposed inverse is only calculated once. */
+			void transformPlanes(core::plane3d<f32>* planes, u32 count) const;
+
 			//! Multiplies this matrix by a 1x4 matrix
 			void multiplyWith1x4Matrix(T* matrix) const;
 
@@ -1234,7 +1289,7 @@ namespace core
 		out[0] = in[0]*M[0] + in[1]*M[4] + in[2]*M[8] + in[3]*M[12];
 		out[1] = in[0]*M[1] + in[1]*M[5] + in[2]*M[9] + in[3]*M[13];
 		out[2] = in[0]*M[2] + in[1]*M[6] + in[2]*M[10] + in[3]*M[14];
-		out[3] = in[0]*M[3] + in[1]*M[7] + in[2]*M[11] + in[3]*M[16];
+		out[3] = in[0]*M[3] + in[1]*M[7] + in[2]*M[11] + in[3]*M[15];
 	}
 
 
@@ -1298,6 +1353,7 @@ namespace core
 
 		const CMatrix4<T> &m = *this;
 
+		// min and max instead of branches, so compilers can vectorize it
 		for (u32 i = 0; i < 3; ++i)
 		{
 			for (u32 j = 0; j < 3; ++j)
@@ -1305,16 +1361,8 @@ namespace core
 				const f32 a = m(j,i) * Amin[j];
 				const f32 b = m(j,i) * Amax[j];
 
-				if (a < b)
-				{
-					Bmin[i] += a;
-					Bmax[i] += b;
-				}
-				else
-				{
-					Bmin[i] += b;
-					Bmax[i] += a;
-				}
+				Bmin[i] += core::min_(a, b);
+				Bmax[i] += core::max_(a, b);
 			}
 		}
 
@@ -1328,6 +1376,219 @@ namespace core
 	}
 
 
+	//! Transforms an array of vectors by this matrix
+	template <class T>
+	inline void CMatrix4<T>::transformVects(vector3df* out, const vector3df* in, u32 count) const
+	{
+		// local copies, as out could alias M otherwise
+		const f32 m0 = (f32)M[0], m1 = (f32)M[1], m2 = (f32)M[2];
+		const f32 m4 = (f32)M[4], m5 = (f32)M[5], m6 = (f32)M[6];
+		const f32 m8 = (f32)M[8], m9 = (f32)M[9], m10 = (f32)M[10];
+		const f32 m12 = (f32)M[12], m13 = (f32)M[13], m14 = (f32)M[14];
+
+		u32 i = 0;
+#if defined(_IRR_USE_SSE2_)
+		// 4 vectors at once, all of them are loaded before storing
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x, y, z;
+			loadVects4(in + i, x, y, z);
+			const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m0)),
+				_mm_mul_ps(y, _mm_set1_ps(m4))), _mm_mul_ps(z, _mm_set1_ps(m8))), _mm_set1_ps(m12));
+			const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m1)),
+				_mm_mul_ps(y, _mm_set1_ps(m5))), _mm_mul_ps(z, _mm_set1_ps(m9))), _mm_set1_ps(m13));
+			const __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m2)),
+				_mm_mul_ps(y, _mm_set1_ps(m6))), _mm_mul_ps(z, _mm_set1_ps(m10))), _mm_set1_ps(m14));
+			storeVects4(out + i, rx, ry, rz);
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			const f32 x = in[i].X;
+			const f32 y = in[i].Y;
+			const f32 z = in[i].Z;
+			out[i].X = x*m0 + y*m4 + z*m8 + m12;
+			out[i].Y = x*m1 + y*m5 + z*m9 + m13;
+			out[i].Z = x*m2 + y*m6 + z*m10 + m14;
+		}
+	}
+
+	//! Rotates an array of vectors by the rotation part of this matrix
+	template <class T>
+	inline void CMatrix4<T>::rotateVects(vector3df* out, const vector3df* in, u32 count) const
+	{
+		const f32 m0 = (f32)M[0], m1 = (f32)M[1], m2 = (f32)M[2];
+		const f32 m4 = (f32)M[4], m5 = (f32)M[5], m6 = (f32)M[6];
+		const f32 m8 = (f32)M[8], m9 = (f32)M[9], m10 = (f32)M[10];
+
+		u32 i = 0;
+#if defined(_IRR_USE_SSE2_)
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x, y, z;
+			loadVects4(in + i, x, y, z);
+			const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m0)),
+				_mm_mul_ps(y, _mm_set1_ps(m4))), _mm_mul_ps(z, _mm_set1_ps(m8)));
+			const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m1)),
+				_mm_mul_ps(y, _mm_set1_ps(m5))), _mm_mul_ps(z, _mm_set1_ps(m9)));
+			const __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m2)),
+				_mm_mul_ps(y, _mm_set1_ps(m6))), _mm_mul_ps(z, _mm_set1_ps(m10)));
+			storeVects4(out + i, rx, ry, rz);
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			const f32 x = in[i].X;
+			const f32 y = in[i].Y;
+			const f32 z = in[i].Z;
+			out[i].X = x*m0 + y*m4 + z*m8;
+			out[i].Y = x*m1 + y*m5 + z*m9;
+			out[i].Z = x*m2 + y*m6 + z*m10;
+		}
+	}
+
+	//! Transforms an array of axis aligned bounding boxes
+	template <class T>
+	inline void CMatrix4<T>::transformBoxesEx(core::aabbox3d<f32>* boxes, u32 count) const
+	{
+#if defined ( USE_MATRIX_TEST )
+		if (isIdentity())
+			return;
+#endif
+		f32 m[3][3];
+		for (u32 i = 0; i < 3; ++i)
+			for (u32 j = 0; j < 3; ++j)
+				m[i][j] = (f32)(*this)(j,i);
+		const f32 t[3] = { (f32)M[12], (f32)M[13], (f32)M[14] };
+
+		u32 k = 0;
+#if defined(_IRR_USE_SSE2_)
+		// one box at a time, with the x, y and z results in one register
+		{
+			const __m128 col0 = _mm_set_ps(0.f, m[2][0], m[1][0], m[0][0]);
+			const __m128 col1 = _mm_set_ps(0.f, m[2][1], m[1][1], m[0][1]);
+			const __m128 col2 = _mm_set_ps(0.f, m[2][2], m[1][2], m[0][2]);
+			const __m128 trans = _mm_set_ps(0.f, t[2], t[1], t[0]);
+			for (; k < count; ++k)
+			{
+				const __m128 a0 = _mm_mul_ps(col0, _mm_set1_ps(boxes[k].MinEdge.X));
+				const __m128 b0 = _mm_mul_ps(col0, _mm_set1_ps(boxes[k].MaxEdge.X));
+				const __m128 a1 = _mm_mul_ps(col1, _mm_set1_ps(boxes[k].MinEdge.Y));
+				const __m128 b1 = _mm_mul_ps(col1, _mm_set1_ps(boxes[k].MaxEdge.Y));
+				const __m128 a2 = _mm_mul_ps(col2, _mm_set1_ps(boxes[k].MinEdge.Z));
+				const __m128 b2 = _mm_mul_ps(col2, _mm_set1_ps(boxes[k].MaxEdge.Z));
+
+				f32 Bmin[4];
+				f32 Bmax[4];
+				_mm_storeu_ps(Bmin, _mm_add_ps(_mm_add_ps(_mm_add_ps(trans, _mm_min_ps(a0, b0)),
+					_mm_min_ps(a1, b1)), _mm_min_ps(a2, b2)));
+				_mm_storeu_ps(Bmax, _mm_add_ps(_mm_add_ps(_mm_add_ps(trans, _mm_max_ps(a0, b0)),
+					_mm_max_ps(a1, b1)), _mm_max_ps(a2, b2)));
+
+				boxes[k].MinEdge.set(Bmin[0], Bmin[1], Bmin[2]);
+				boxes[k].MaxEdge.set(Bmax[0], Bmax[1], Bmax[2]);
+			}
+		}
+#endif
+
+		for (; k < count; ++k)
+		{
+			const f32 Amin[3] = {boxes[k].MinEdge.X, boxes[k].MinEdge.Y, boxes[k].MinEdge.Z};
+			const f32 Amax[3] = {boxes[k].MaxEdge.X, boxes[k].MaxEdge.Y, boxes[k].MaxEdge.Z};
+
+			f32 Bmin[3] = { t[0], t[1], t[2] };
+			f32 Bmax[3] = { t[0], t[1], t[2] };
+
+			for (u32 i = 0; i < 3; ++i)
+			{
+				for (u32 j = 0; j < 3; ++j)
+				{
+					const f32 a = m[i][j] * Amin[j];
+					const f32 b = m[i][j] * Amax[j];
+
+					Bmin[i] += core::min_(a, b);
+					Bmax[i] += core::max_(a, b);
+				}
+			}
+
+			boxes[k].MinEdge.set(Bmin[0], Bmin[1], Bmin[2]);
+			boxes[k].MaxEdge.set(Bmax[0], Bmax[1], Bmax[2]);
+		}
+	}
+
+	//! Transforms an array of planes by this matrix
+	template <class T>
+	inline void CMatrix4<T>::transformPlanes(core::plane3d<f32>* planes, u32 count) const
+	{
+		CMatrix4<T> transposedInverse(*this, EM4CONST_INVERSE_TRANSPOSED);
+
+		u32 i = 0;
+#if defined(_IRR_USE_SSE2_)
+		// 4 planes at once, a plane is a normal followed by D
+		const CMatrix4<T>& ti = transposedInverse;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 nx = _mm_loadu_ps(&planes[i].Normal.X);
+			__m128 ny = _mm_loadu_ps(&planes[i+1].Normal.X);
+			__m128 nz = _mm_loadu_ps(&planes[i+2].Normal.X);
+			__m128 d = _mm_loadu_ps(&planes[i+3].Normal.X);
+			_MM_TRANSPOSE4_PS(nx, ny, nz, d);
+
+			// member point is Normal * -D
+			const __m128 minusD = _mm_sub_ps(_mm_setzero_ps(), d);
+			const __m128 px = _mm_mul_ps(nx, minusD);
+			const __m128 py = _mm_mul_ps(ny, minusD);
+			const __m128 pz = _mm_mul_ps(nz, minusD);
+			const __m128 mx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps((f32)M[0])),
+				_mm_mul_ps(py, _mm_set1_ps((f32)M[4]))), _mm_mul_ps(pz, _mm_set1_ps((f32)M[8]))), _mm_set1_ps((f32)M[12]));
+			const __m128 my = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps((f32)M[1])),
+				_mm_mul_ps(py, _mm_set1_ps((f32)M[5]))), _mm_mul_ps(pz, _mm_set1_ps((f32)M[9]))), _mm_set1_ps((f32)M[13]));
+			const __m128 mz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps((f32)M[2])),
+				_mm_mul_ps(py, _mm_set1_ps((f32)M[6]))), _mm_mul_ps(pz, _mm_set1_ps((f32)M[10]))), _mm_set1_ps((f32)M[14]));
+
+			// normal by the transposed inverse
+			const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_set1_ps((f32)ti[0])),
+				_mm_mul_ps(ny, _mm_set1_ps((f32)ti[4]))), _mm_mul_ps(nz, _mm_set1_ps((f32)ti[8])));
+			const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_set1_ps((f32)ti[1])),
+				_mm_mul_ps(ny, _mm_set1_ps((f32)ti[5]))), _mm_mul_ps(nz, _mm_set1_ps((f32)ti[9])));
+			const __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_set1_ps((f32)ti[2])),
+				_mm_mul_ps(ny, _mm_set1_ps((f32)ti[6]))), _mm_mul_ps(nz, _mm_set1_ps((f32)ti[10])));
+
+			// normalize, zero normals are kept like vector3d::normalize() does
+			const __m128 lengthSQ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_mul_ps(rz, rz));
+			const __m128 zero = _mm_cmpeq_ps(lengthSQ, _mm_setzero_ps());
+			const __m128 invLength = _mm_or_ps(_mm_and_ps(zero, _mm_set1_ps(1.f)),
+				_mm_andnot_ps(zero, _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(lengthSQ))));
+			nx = _mm_mul_ps(rx, invLength);
+			ny = _mm_mul_ps(ry, invLength);
+			nz = _mm_mul_ps(rz, invLength);
+
+			// D = -member.dotProduct(Normal)
+			d = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(_mm_add_ps(_mm_mul_ps(mx, nx),
+				_mm_mul_ps(my, ny)), _mm_mul_ps(mz, nz)));
+
+			_MM_TRANSPOSE4_PS(nx, ny, nz, d);
+			_mm_storeu_ps(&planes[i].Normal.X, nx);
+			_mm_storeu_ps(&planes[i+1].Normal.X, ny);
+			_mm_storeu_ps(&planes[i+2].Normal.X, nz);
+			_mm_storeu_ps(&planes[i+3].Normal.X, d);
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			vector3df member;
+			transformVect(member, planes[i].getMemberPoint());
+
+			vector3df normal = planes[i].Normal;
+			transposedInverse.rotateVect(normal);
+			planes[i].setPlane(member, normal.normalize());
+		}
+	}
+
+
 	//! Multiplies this matrix by a 1x4 matrix
 	template <class T>
 	inline void CMatrix4<T>::multiplyWith1x4Matrix(T* matrix) const
@@ -1384,66 +1645,48 @@ namespace core
 #endif
 		const CMatrix4<T> &m = *this;
 
-		f32 d = (m[0] * m[5] - m[1] * m[4]) * (m[10] * m[15] - m[11] * m[14]) -
-			(m[0] * m[6] - m[2] * m[4]) * (m[9] * m[15] - m[11] * m[13]) +
-			(m[0] * m[7] - m[3] * m[4]) * (m[9] * m[14] - m[10] * m[13]) +
-			(m[1] * m[6] - m[2] * m[5]) * (m[8] * m[15] - m[11] * m[12]) -
-			(m[1] * m[7] - m[3] * m[5]) * (m[8] * m[14] - m[10] * m[12]) +
-			(m[2] * m[7] - m[3] * m[6]) * (m[8] * m[13] - m[9] * m[12]);
+		// 2x2 minors of the upper and lower two rows, each one is
+		// used several times by the cofactors
+		const f32 s0 = m[0] * m[5] - m[4] * m[1];
+		const f32 s1 = m[0] * m[6] - m[4] * m[2];
+		const f32 s2 = m[0] * m[7] - m[4] * m[3];
+		const f32 s3 = m[1] * m[6] - m[5] * m[2];
+		const f32 s4 = m[1] * m[7] - m[5] * m[3];
+		const f32 s5 = m[2] * m[7] - m[6] * m[3];
+
+		const f32 c5 = m[10] * m[15] - m[14] * m[11];
+		const f32 c4 = m[9] * m[15] - m[13] * m[11];
+		const f32 c3 = m[9] * m[14] - m[13] * m[10];
+		const f32 c2 = m[8] * m[15] - m[12] * m[11];
+		const f32 c1 = m[8] * m[14] - m[12] * m[10];
+		const f32 c0 = m[8] * m[13] - m[12] * m[9];
+
+		f32 d = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 
 		if( core::iszero ( d, FLT_MIN ) )
 			return false;
 
 		d = core::reciprocal ( d );
 
-		out[0] = d * (m[5] * (m[10] * m[15] - m[11] * m[14]) +
-				m[6] * (m[11] * m[13] - m[9] * m[15]) +
-				m[7] * (m[9] * m[14] - m[10] * m[13]));
-		out[1] = d * (m[9] * (m[2] * m[15] - m[3] * m[14]) +
-				m[10] * (m[3] * m[13] - m[1] * m[15]) +
-				m[11] * (m[1] * m[14] - m[2] * m[13]));
-		out[2] = d * (m[13] * (m[2] * m[7] - m[3] * m[6]) +
-				m[14] * (m[3] * m[5] - m[1] * m[7]) +
-				m[15] * (m[1] * m[6] - m[2] * m[5]));
-		out[3] = d * (m[1] * (m[7] * m[10] - m[6] * m[11]) +
-				m[2] * (m[5] * m[11] - m[7] * m[9]) +
-				m[3] * (m[6] * m[9] - m[5] * m[10]));
-		out[4] = d * (m[6] * (m[8] * m[15] - m[11] * m[12]) +
-				m[7] * (m[10] * m[12] - m[8] * m[14]) +
-				m[4] * (m[11] * m[14] - m[10] * m[15]));
-		out[5] = d * (m[10] * (m[0] * m[15] - m[3] * m[12]) +
-				m[11] * (m[2] * m[12] - m[0] * m[14]) +
-				m[8] * (m[3] * m[14] - m[2] * m[15]));
-		out[6] = d * (m[14] * (m[0] * m[7] - m[3] * m[4]) +
-				m[15] * (m[2] * m[4] - m[0] * m[6]) +
-				m[12] * (m[3] * m[6] - m[2] * m[7]));
-		out[7] = d * (m[2] * (m[7] * m[8] - m[4] * m[11]) +
-				m[3] * (m[4] * m[10] - m[6] * m[8]) +
-				m[0] * (m[6] * m[11] - m[7] * m[10]));
-		out[8] = d * (m[7] * (m[8] * m[13] - m[9] * m[12]) +
-				m[4] * (m[9] * m[15] - m[11] * m[13]) +
-				m[5] * (m[11] * m[12] - m[8] * m[15]));
-		out[9] = d * (m[11] * (m[0] * m[13] - m[1] * m[12]) +
-				m[8] * (m[1] * m[15] - m[3] * m[13]) +
-				m[9] * (m[3] * m[12] - m[0] * m[15]));
-		out[10] = d * (m[15] * (m[0] * m[5] - m[1] * m[4]) +
-				m[12] * (m[1] * m[7] - m[3] * m[5]) +
-				m[13] * (m[3] * m[4] - m[0] * m[7]));
-		out[11] = d * (m[3] * (m[5] * m[8] - m[4] * m[9]) +
-				m[0] * (m[7] * m[9] - m[5] * m[11]) +
-				m[1] * (m[4] * m[11] - m[7] * m[8]));
-		out[12] = d * (m[4] * (m[10] * m[13] - m[9] * m[14]) +
-				m[5] * (m[8] * m[14] - m[10] * m[12]) +
-				m[6] * (m[9] * m[12] - m[8] * m[13]));
-		out[13] = d * (m[8] * (m[2] * m[13] - m[1] * m[14]) +
-				m[9] * (m[0] * m[14] - m[2] * m[12]) +
-				m[10] * (m[1] * m[12] - m[0] * m[13]));
-		out[14] = d * (m[12] * (m[2] * m[5] - m[1] * m[6]) +
-				m[13] * (m[0] * m[6] - m[2] * m[4]) +
-				m[14] * (m[1] * m[4] - m[0] * m[5]));
-		out[15] = d * (m[0] * (m[5] * m[10] - m[6] * m[9]) +
-				m[1] * (m[6] * m[8] - m[4] * m[10]) +
-				m[2] * (m[4] * m[9] - m[5] * m[8]));
+		out[0] = d * ( m[5] * c5 - m[6] * c4 + m[7] * c3);
+		out[1] = d * (-m[1] * c5 + m[2] * c4 - m[3] * c3);
+		out[2] = d * ( m[13] * s5 - m[14] * s4 + m[15] * s3);
+		out[3] = d * (-m[9] * s5 + m[10] * s4 - m[11] * s3);
+
+		out[4] = d * (-m[4] * c5 + m[6] * c2 - m[7] * c1);
+		out[5] = d * ( m[0] * c5 - m[2] * c2 + m[3] * c1);
+		out[6] = d * (-m[12] * s5 + m[14] * s2 - m[15] * s1);
+		out[7] = d * ( m[8] * s5 - m[10] * s2 + m[11] * s1);
+
+		out[8] = d * ( m[4] * c4 - m[5] * c2 + m[7] * c0);
+		out[9] = d * (-m[0] * c4 + m[1] * c2 - m[3] * c0);
+		out[10] = d * ( m[12] * s4 - m[13] * s2 + m[15] * s0);
+		out[11] = d * (-m[8] * s4 + m[9] * s2 - m[11] * s0);
+
+		out[12] = d * (-m[4] * c3 + m[5] * c1 - m[6] * c0);
+		out[13] = d * ( m[0] * c3 - m[1] * c1 + m[2] * c0);
+		out[14] = d * (-m[12] * s3 + m[13] * s1 - m[14] * s0);
+		out[15] = d * ( m[8] * s3 - m[9] * s1 + m[10] * s0);
 
 #if defined ( USE_MATRIX_TEST )
 		out.definitelyIdentityMatrix = definitelyIdentityMatrix;
@@ -735,6 +735,7 @@ IMesh* CAnimatedMeshHalfLife::getMesh(s32 frameInt, s32 detailLevel, s32 startFr
 	//SetBodyPart ( 1, 1 );
 	setUpBones ();
 	buildVertices();
+	MeshIPol->setDirty(EBT_VERTEX);
 
 	MeshIPol->BoundingBox.MinEdge.X = seq->bbmin[0];
 	MeshIPol->BoundingBox.MinEdge.Z = seq->bbmin[1];
@@ -200,6 +200,7 @@ IMesh* CAnimatedMeshMD3::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 					(SMeshBufferLightMap*) MeshIPol->getMeshBuffer(i));
 	}
 	MeshIPol->recalculateBoundingBox();
+	MeshIPol->setDirty(EBT_VERTEX);
 
 	// build current tags
 	buildTagArray(frameA, frameB, iPol);
@@ -59,6 +59,12 @@ public:
 	//! Returns attribute index from name, -1 if not found
 	virtual s32 findAttribute(const c8* attributeName) const _IRR_OVERRIDE_;
 
+	//! Returns a handle for faster repeated access to an attribute
+	virtual SAttributeHandle getAttributeHandle(const c8* attributeName) const _IRR_OVERRIDE_;
+
+	//! Returns attribute index from a handle, -1 if not found
+	virtual s32 findAttribute(const SAttributeHandle& handle) const _IRR_OVERRIDE_;
+
 	//! Removes all attributes
 	virtual void clear() _IRR_OVERRIDE_;
 
@@ -94,6 +100,11 @@ public:
 	//! \param index: Index value, must be between 0 and getAttributeCount()-1.
 	virtual s32 getAttributeAsInt(s32 index) const _IRR_OVERRIDE_;
 
+	//! Gets an attribute as integer value
+	//! \param handle: Handle created with getAttributeHandle().
+	//! \param defaultNotFound Value returned when the attribute was not found
+	virtual s32 getAttributeAsInt(const SAttributeHandle& handle, irr::s32 defaultNotFound=0) const _IRR_OVERRIDE_;
+
 	//! Sets an attribute as integer value
 	virtual void setAttribute(s32 index, s32 value) _IRR_OVERRIDE_;
 
@@ -119,6 +130,11 @@ public:
 	//! \param index: Index value, must be between 0 and getAttributeCount()-1.
 	virtual f32 getAttributeAsFloat(s32 index) const _IRR_OVERRIDE_;
 
+	//! Gets an attribute as float value
+	//! \param handle: Handle created with getAttributeHandle().
+	//! \param defaultNotFound Value returned when the attribute was not found
+	virtual f32 getAttributeAsFloat(const SAttributeHandle& handle, irr::f32 defaultNotFound=0.f) const _IRR_OVERRIDE_;
+
 	//! Sets an attribute as float value
 	virtual void setAttribute(s32 index, f32 value) _IRR_OVERRIDE_;
 
@@ -260,6 +276,11 @@ public:
 	//! \param index: Index value, must be between 0 and getAttributeCount()-1.
 	virtual bool getAttributeAsBool(s32 index) const _IRR_OVERRIDE_;
 
+	//! Gets an attribute as boolean value
+	//! \param handle: Handle created with getAttributeHandle().
+	//! \param defaultNotFound Value returned when the attribute was not found
+	virtual bool getAttributeAsBool(const SAttributeHandle& handle, bool defaultNotFound=false) const _IRR_OVERRIDE_;
+
 	//! Sets an attribute as boolean value
 	virtual void setAttribute(s32 index, bool value) _IRR_OVERRIDE_;
 
@@ -724,8 +745,24 @@ protected:
 
 	void readAttributeFromXML(io::IXMLReader* reader);
 
+	//! Appends an attribute and adds it to the name index
+	void addAttributeP(IAttribute* attribute);
+
+	//! Removes the attribute at index and rebuilds the name index
+	void removeAttributeP(u32 index);
+
+	//! Recreates the name index for all attributes
+	void rebuildNameIndex(u32 minSlots);
+
 	core::array<IAttribute*> Attributes;
 
+	//! Open addressing hash table from attribute name to index in Attributes.
+	//! Size is always a power of two and at least twice the attribute count, empty slots are -1.
+	core::array<s32> NameIndex;
+
+	//! Increased whenever attributes are added or removed, used to validate handles
+	u32 Generation;
+
 	IAttribute* getAttributeP(const c8* attributeName) const;
 
 	video::IVideoDriver* Driver;
@@ -483,7 +483,7 @@ void CColladaFileLoader::readColladaSection(io::IXMLReaderUTF8* reader)
 		return;
 
 	// todo: patch level needs to be handled
-	const f32 version = core::fast_atof(core::stringc(reader->getAttributeValue("version")).c_str());
+	const f32 version = core::fast_atof(reader->getAttributeValue("version"));
 	Version = core::floor32(version)*10000+core::round32(core::fract(version)*1000.0f);
 	// Version 1.4 can be checked for by if (Version >= 10400)
 
@@ -1815,9 +1815,7 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 			if (okToReadArray && !sources.empty())
 			{
 				core::array<f32>& a = sources.getLast().Array.Data;
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
+				const c8* p = reader->getNodeData();
 
 				for (u32 i=0; i<a.size(); ++i)
 				{
@@ -1988,9 +1986,7 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 		{
 			if (parseVcountOK)
 			{
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
+				const c8* p = reader->getNodeData();
 				while(*p)
 				{
 					findNextNoneWhiteSpace(&p);
@@ -2002,9 +1998,7 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 			else
 			if (parsePolygonOK && polygons.size())
 			{
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
+				const c8* p = reader->getNodeData();
 				SPolygon& poly = polygons.getLast();
 				if (polygonType == polygonsSectionName)
 					poly.Indices.reallocate((maxOffset+1)*3);
@@ -2016,7 +2010,8 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 					while(*p)
 					{
 						findNextNoneWhiteSpace(&p);
-						poly.Indices.push_back(readInt(&p));
+						if (*p)
+							poly.Indices.push_back(readInt(&p));
 					}
 				}
 				else
@@ -2028,9 +2023,9 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 
 						for (u32 j = 0; j < polyVCount * inputSemanticCount; j++)
 						{
+							findNextNoneWhiteSpace(&p);
 							if (!*p)
 								break;
-							findNextNoneWhiteSpace(&p);
 							polyCorners.push_back(readInt(&p));
 						}
 
@@ -2635,9 +2630,7 @@ void CColladaFileLoader::readFloatsInsideElement(io::IXMLReaderUTF8* reader, f32
 		if (reader->getNodeType() == io::EXN_TEXT)
 		{
 			// parse float data
-			core::stringc data = reader->getNodeData();
-			data.trim();
-			const c8* p = &data[0];
+			const c8* p = reader->getNodeData();
 
 			for (u32 i=0; i<count; ++i)
 			{
@@ -2669,9 +2662,7 @@ void CColladaFileLoader::readIntsInsideElement(io::IXMLReaderUTF8* reader, s32*
 		if (reader->getNodeType() == io::EXN_TEXT)
 		{
 			// parse float data
-			core::stringc data = reader->getNodeData();
-			data.trim();
-			const c8* p = &data[0];
+			const c8* p = reader->getNodeData();
 
 			for (u32 i=0; i<count; ++i)
 			{
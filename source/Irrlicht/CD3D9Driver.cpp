@@ -1084,8 +1084,7 @@ CD3D9Driver::SHWBufferLink *CD3D9Driver::createHardwareBuffer(const scene::IMesh
 
 	SHWBufferLink_d3d9 *hwBuffer=new SHWBufferLink_d3d9(mb);
 
-	//add to map
-	HWBufferMap.insert(hwBuffer->MeshBuffer, hwBuffer);
+	addHardwareBuffer(hwBuffer);
 
 	hwBuffer->ChangedID_Vertex=hwBuffer->MeshBuffer->getChangedID_Vertex();
 	hwBuffer->ChangedID_Index=hwBuffer->MeshBuffer->getChangedID_Index();
@@ -7,6 +7,7 @@
 #include "ITextSceneNode.h"
 #include "IBillboardTextSceneNode.h"
 #include "ITerrainSceneNode.h"
+#include "ITiledTerrainSceneNode.h"
 #include "IDummyTransformationSceneNode.h"
 #include "ICameraSceneNode.h"
 #include "IBillboardSceneNode.h"
@@ -38,6 +39,7 @@ CDefaultSceneNodeFactory::CDefaultSceneNodeFactory(ISceneManager* mgr)
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_BILLBOARD_TEXT, "billboardText"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_WATER_SURFACE, "waterSurface"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_TERRAIN, "terrain"));
+	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_TILED_TERRAIN, "tiledTerrain"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_SKY_BOX, "skyBox"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_SKY_DOME, "skyDome"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_SHADOW_VOLUME, "shadowVolume"));
@@ -84,6 +86,8 @@ ISceneNode* CDefaultSceneNodeFactory::addSceneNode(ESCENE_NODE_TYPE type, IScene
 							core::vector3df(1.0f,1.0f,1.0f),
 							video::SColor(255,255,255,255),
 							4, ETPS_17, 0, true);
+	case ESNT_TILED_TERRAIN:
+		return Manager->addTiledTerrainSceneNode("", "", 0, 0, 129, parent);
 	case ESNT_SKY_BOX:
 		return Manager->addSkyBoxSceneNode(0,0,0,0,0,0, parent);
 	case ESNT_SKY_DOME:
@@ -35,6 +35,8 @@ const core::aabbox3d<f32>& CDummyTransformationSceneNode::getBoundingBox() const
 //! and rotation.
 core::matrix4& CDummyTransformationSceneNode::getRelativeTransformationMatrix()
 {
+	// the caller may change the matrix through the reference
+	setTransformationChanged();
 	return RelativeTransformationMatrix;
 }
 
@@ -58,6 +60,7 @@ ISceneNode* CDummyTransformationSceneNode::clone(ISceneNode* newParent, ISceneMa
 
 	nb->cloneMembers(this, newManager);
 	nb->RelativeTransformationMatrix = RelativeTransformationMatrix;
+	nb->setTransformationChanged();
 	nb->Box = Box;
 
 	if ( newParent )
@@ -0,0 +1,366 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CDynamicAABBTree.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	core::aabbox3df merge(const core::aabbox3df& a, const core::aabbox3df& b)
+	{
+		core::aabbox3df box(a);
+		box.addInternalBox(b);
+		return box;
+	}
+}
+
+
+//! constructor
+CDynamicAABBTree::CDynamicAABBTree(f32 margin)
+: Root(-1), FreeList(-1), ProxyCount(0), Margin(margin)
+{
+}
+
+
+//! Adds an object to the tree.
+s32 CDynamicAABBTree::createProxy(const core::aabbox3df& box, void* userData)
+{
+	const s32 proxy = allocateNode();
+
+	STreeNode& node = Nodes[proxy];
+	node.Box = fatten(box);
+	node.UserData = userData;
+	node.Height = 0;
+
+	insertLeaf(proxy);
+	++ProxyCount;
+
+	return proxy;
+}
+
+
+//! Removes a proxy from the tree.
+void CDynamicAABBTree::destroyProxy(s32 proxy)
+{
+	_IRR_DEBUG_BREAK_IF(proxy < 0 || proxy >= (s32)Nodes.size() || !Nodes[proxy].isLeaf())
+
+	removeLeaf(proxy);
+	freeNode(proxy);
+	--ProxyCount;
+}
+
+
+//! Updates the box of a proxy.
+bool CDynamicAABBTree::moveProxy(s32 proxy, const core::aabbox3df& box)
+{
+	_IRR_DEBUG_BREAK_IF(proxy < 0 || proxy >= (s32)Nodes.size() || !Nodes[proxy].isLeaf())
+
+	if (box.isFullInside(Nodes[proxy].Box))
+		return false;
+
+	removeLeaf(proxy);
+	Nodes[proxy].Box = fatten(box);
+	insertLeaf(proxy);
+
+	return true;
+}
+
+
+//! Removes all proxies.
+void CDynamicAABBTree::clear()
+{
+	Nodes.clear();
+	Root = -1;
+	FreeList = -1;
+	ProxyCount = 0;
+}
+
+
+s32 CDynamicAABBTree::allocateNode()
+{
+	s32 index;
+	if (FreeList != -1)
+	{
+		index = FreeList;
+		FreeList = Nodes[index].Parent;
+	}
+	else
+	{
+		index = Nodes.size();
+		Nodes.push_back(STreeNode());
+	}
+
+	STreeNode& node = Nodes[index];
+	node.UserData = 0;
+	node.Parent = -1;
+	node.Child1 = -1;
+	node.Child2 = -1;
+	node.Height = 0;
+
+	return index;
+}
+
+
+void CDynamicAABBTree::freeNode(s32 index)
+{
+	Nodes[index].Parent = FreeList;
+	Nodes[index].Height = -1;
+	FreeList = index;
+}
+
+
+void CDynamicAABBTree::insertLeaf(s32 leaf)
+{
+	if (Root == -1)
+	{
+		Root = leaf;
+		Nodes[Root].Parent = -1;
+		return;
+	}
+
+	// find the sibling which enlarges the surface of the tree the least
+	const core::aabbox3df leafBox = Nodes[leaf].Box;
+	s32 index = Root;
+	while (!Nodes[index].isLeaf())
+	{
+		const STreeNode& node = Nodes[index];
+
+		const f32 area = node.Box.getArea();
+		const f32 combinedArea = merge(node.Box, leafBox).getArea();
+
+		// cost of a new parent for this node and the leaf
+		const f32 cost = 2.f * combinedArea;
+
+		// the boxes of all ancestors grow when descending further
+		const f32 inheritanceCost = 2.f * (combinedArea - area);
+
+		f32 childCost[2];
+		const s32 children[2] = { node.Child1, node.Child2 };
+		for (u32 i=0; i<2; ++i)
+		{
+			const STreeNode& child = Nodes[children[i]];
+			const f32 mergedArea = merge(leafBox, child.Box).getArea();
+			if (child.isLeaf())
+				childCost[i] = mergedArea + inheritanceCost;
+			else
+				childCost[i] = mergedArea - child.Box.getArea() + inheritanceCost;
+		}
+
+		if (cost < childCost[0] && cost < childCost[1])
+			break;
+
+		index = childCost[0] < childCost[1] ? children[0] : children[1];
+	}
+
+	const s32 sibling = index;
+
+	// allocating may move the nodes in memory, so no references are kept
+	const s32 newParent = allocateNode();
+	const s32 oldParent = Nodes[sibling].Parent;
+
+	Nodes[newParent].Parent = oldParent;
+	Nodes[newParent].Box = merge(leafBox, Nodes[sibling].Box);
+	Nodes[newParent].Height = Nodes[sibling].Height + 1;
+	Nodes[newParent].Child1 = sibling;
+	Nodes[newParent].Child2 = leaf;
+	Nodes[sibling].Parent = newParent;
+	Nodes[leaf].Parent = newParent;
+
+	if (oldParent != -1)
+	{
+		if (Nodes[oldParent].Child1 == sibling)
+			Nodes[oldParent].Child1 = newParent;
+		else
+			Nodes[oldParent].Child2 = newParent;
+	}
+	else
+		Root = newParent;
+
+	refit(Nodes[leaf].Parent);
+}
+
+
+void CDynamicAABBTree::removeLeaf(s32 leaf)
+{
+	if (leaf == Root)
+	{
+		Root = -1;
+		return;
+	}
+
+	const s32 parent = Nodes[leaf].Parent;
+	const s32 grandParent = Nodes[parent].Parent;
+	const s32 sibling = Nodes[parent].Child1 == leaf ? Nodes[parent].Child2 : Nodes[parent].Child1;
+
+	// the sibling takes the place of the parent
+	if (grandParent != -1)
+	{
+		if (Nodes[grandParent].Child1 == parent)
+			Nodes[grandParent].Child1 = sibling;
+		else
+			Nodes[grandParent].Child2 = sibling;
+		Nodes[sibling].Parent = grandParent;
+		freeNode(parent);
+
+		refit(grandParent);
+	}
+	else
+	{
+		Root = sibling;
+		Nodes[sibling].Parent = -1;
+		freeNode(parent);
+	}
+}
+
+
+//! recalculates boxes and heights from a node up to the root
+void CDynamicAABBTree::refit(s32 index)
+{
+	while (index != -1)
+	{
+		index = balance(index);
+
+		STreeNode& node = Nodes[index];
+		const STreeNode& child1 = Nodes[node.Child1];
+		const STreeNode& child2 = Nodes[node.Child2];
+
+		node.Height = 1 + core::max_(child1.Height, child2.Height);
+		node.Box = merge(child1.Box, child2.Box);
+
+		index = node.Parent;
+	}
+}
+
+
+//! rotates the tree at node a if it is unbalanced
+s32 CDynamicAABBTree::balance(s32 iA)
+{
+	STreeNode* A = &Nodes[iA];
+	if (A->isLeaf() || A->Height < 2)
+		return iA;
+
+	const s32 iB = A->Child1;
+	const s32 iC = A->Child2;
+	STreeNode* B = &Nodes[iB];
+	STreeNode* C = &Nodes[iC];
+
+	const s32 diff = C->Height - B->Height;
+
+	if (diff > 1)
+	{
+		// rotate C up
+		const s32 iF = C->Child1;
+		const s32 iG = C->Child2;
+		STreeNode* F = &Nodes[iF];
+		STreeNode* G = &Nodes[iG];
+
+		// A becomes the child of C
+		C->Child1 = iA;
+		C->Parent = A->Parent;
+		A->Parent = iC;
+
+		if (C->Parent != -1)
+		{
+			if (Nodes[C->Parent].Child1 == iA)
+				Nodes[C->Parent].Child1 = iC;
+			else
+				Nodes[C->Parent].Child2 = iC;
+		}
+		else
+			Root = iC;
+
+		// the higher child of C stays with C
+		if (F->Height > G->Height)
+		{
+			C->Child2 = iF;
+			A->Child2 = iG;
+			G->Parent = iA;
+			A->Box = merge(B->Box, G->Box);
+			C->Box = merge(A->Box, F->Box);
+
+			A->Height = 1 + core::max_(B->Height, G->Height);
+			C->Height = 1 + core::max_(A->Height, F->Height);
+		}
+		else
+		{
+			C->Child2 = iG;
+			A->Child2 = iF;
+			F->Parent = iA;
+			A->Box = merge(B->Box, F->Box);
+			C->Box = merge(A->Box, G->Box);
+
+			A->Height = 1 + core::max_(B->Height, F->Height);
+			C->Height = 1 + core::max_(A->Height, G->Height);
+		}
+
+		return iC;
+	}
+
+	if (diff < -1)
+	{
+		// rotate B up
+		const s32 iD = B->Child1;
+		const s32 iE = B->Child2;
+		STreeNode* D = &Nodes[iD];
+		STreeNode* E = &Nodes[iE];
+
+		// A becomes the child of B
+		B->Child1 = iA;
+		B->Parent = A->Parent;
+		A->Parent = iB;
+
+		if (B->Parent != -1)
+		{
+			if (Nodes[B->Parent].Child1 == iA)
+				Nodes[B->Parent].Child1 = iB;
+			else
+				Nodes[B->Parent].Child2 = iB;
+		}
+		else
+			Root = iB;
+
+		// the higher child of B stays with B
+		if (D->Height > E->Height)
+		{
+			B->Child2 = iD;
+			A->Child1 = iE;
+			E->Parent = iA;
+			A->Box = merge(C->Box, E->Box);
+			B->Box = merge(A->Box, D->Box);
+
+			A->Height = 1 + core::max_(C->Height, E->Height);
+			B->Height = 1 + core::max_(A->Height, D->Height);
+		}
+		else
+		{
+			B->Child2 = iE;
+			A->Child1 = iD;
+			D->Parent = iA;
+			A->Box = merge(C->Box, D->Box);
+			B->Box = merge(A->Box, E->Box);
+
+			A->Height = 1 + core::max_(C->Height, D->Height);
+			B->Height = 1 + core::max_(A->Height, E->Height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+
+core::aabbox3df CDynamicAABBTree::fatten(const core::aabbox3df& box) const
+{
+	const core::vector3df margin = box.getExtent() * Margin;
+	return core::aabbox3df(box.MinEdge - margin, box.MaxEdge + margin);
+}
+
+
+} // end namespace scene
+} // end namespace irr
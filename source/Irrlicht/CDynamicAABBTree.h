@@ -0,0 +1,229 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_DYNAMIC_AABB_TREE_H_INCLUDED__
+#define __C_DYNAMIC_AABB_TREE_H_INCLUDED__
+
+#include "aabbox3d.h"
+#include "irrArray.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Bounding volume hierarchy of axis aligned boxes which can be changed incrementally.
+/** Every object is a leaf (proxy) of a binary tree, inner nodes bound their
+two children. Leaf boxes are enlarged by a margin, so objects which move a
+little don't have to be reinserted. The tree is kept balanced by rotations
+when leafs are inserted or removed. */
+class CDynamicAABBTree
+{
+public:
+
+	//! constructor
+	/** \param margin Leaf boxes are enlarged by this fraction of their size
+	on each side. */
+	CDynamicAABBTree(f32 margin=0.1f);
+
+	//! Adds an object to the tree.
+	/** \return Id of the proxy, which stays the same until the proxy
+	is destroyed. */
+	s32 createProxy(const core::aabbox3df& box, void* userData);
+
+	//! Removes a proxy from the tree.
+	void destroyProxy(s32 proxy);
+
+	//! Updates the box of a proxy.
+	/** \return True if the proxy had to be reinserted, false if the new box
+	still fit into the enlarged box of the proxy. */
+	bool moveProxy(s32 proxy, const core::aabbox3df& box);
+
+	//! Returns the user data of a proxy.
+	void* getUserData(s32 proxy) const
+	{
+		return Nodes[proxy].UserData;
+	}
+
+	//! Returns the enlarged box of a proxy.
+	const core::aabbox3df& getFatBox(s32 proxy) const
+	{
+		return Nodes[proxy].Box;
+	}
+
+	//! Returns the number of proxies in the tree.
+	u32 getProxyCount() const
+	{
+		return ProxyCount;
+	}
+
+	//! Returns the height of the tree, 0 if it is empty.
+	u32 getHeight() const
+	{
+		return Root == -1 ? 0 : Nodes[Root].Height + 1;
+	}
+
+	//! Removes all proxies.
+	void clear();
+
+	//! Finds all proxies which may be inside of a view frustum.
+	/** Calls callback(proxy, userData, inside) for every proxy whose box
+	is not completely outside of one of the frustum planes. inside is true
+	when the box is completely inside of all planes. Subtrees which are
+	outside of a plane are skipped, for subtrees which are inside of a
+	plane the plane is not tested anymore. */
+	template <class T>
+	void query(const SViewFrustum& frustum, T& callback) const
+	{
+		if (Root == -1)
+			return;
+
+		SQueryPlanes planes;
+		for (u32 i=0; i<SViewFrustum::VF_PLANE_COUNT; ++i)
+		{
+			const core::plane3df& p = frustum.planes[i];
+			planes.Normal[i][0] = p.Normal.X;
+			planes.Normal[i][1] = p.Normal.Y;
+			planes.Normal[i][2] = p.Normal.Z;
+			planes.D[i] = p.D;
+
+			// offsets of the corner which is furthest in front of
+			// the plane in the MinEdge,MaxEdge array of a box
+			planes.Far[i][0] = p.Normal.X >= 0.f ? 3 : 0;
+			planes.Far[i][1] = p.Normal.Y >= 0.f ? 4 : 1;
+			planes.Far[i][2] = p.Normal.Z >= 0.f ? 5 : 2;
+		}
+
+		queryNode(planes, Root, (1 << SViewFrustum::VF_PLANE_COUNT) - 1, callback);
+	}
+
+	//! Finds all proxies whose box intersects with a box.
+	/** Calls callback(proxy, userData) for each of them. Doesn't change
+	the tree, so several threads can query at the same time. */
+	template <class T>
+	void query(const core::aabbox3df& box, T& callback) const
+	{
+		if (Root != -1)
+			queryNode(box, Root, callback);
+	}
+
+private:
+
+	struct STreeNode
+	{
+		bool isLeaf() const
+		{
+			return Child1 == -1;
+		}
+
+		core::aabbox3df Box;
+		void* UserData;
+
+		//! parent of a node in the tree, next node in the free list
+		s32 Parent;
+		s32 Child1;
+		s32 Child2;
+
+		//! 0 for leafs, -1 for free nodes
+		s32 Height;
+	};
+
+	//! frustum planes prepared for testing boxes
+	struct SQueryPlanes
+	{
+		f32 Normal[SViewFrustum::VF_PLANE_COUNT][3];
+		f32 D[SViewFrustum::VF_PLANE_COUNT];
+		u32 Far[SViewFrustum::VF_PLANE_COUNT][3];
+	};
+
+	//! Tests a box against the planes in planeMask.
+	/** \return False if the box is outside of a plane, else true and
+	planeMask only keeps the planes which still cut the box. */
+	static bool classifyBox(const SQueryPlanes& planes, const core::aabbox3df& box, u32& planeMask)
+	{
+		const f32* edges = &box.MinEdge.X;
+		u32 mask = planeMask;
+
+		for (u32 i=0; i<SViewFrustum::VF_PLANE_COUNT; ++i)
+		{
+			if (!(mask & (1 << i)))
+				continue;
+
+			const f32* n = planes.Normal[i];
+			const u32* corner = planes.Far[i];
+
+			// the normals point out of the frustum, so the corner
+			// furthest in front is tested for being outside and
+			// the opposite corner for being inside
+			const f32 distFar = n[0]*edges[corner[0]] + n[1]*edges[corner[1]] + n[2]*edges[corner[2]] + planes.D[i];
+			const f32 distNear = n[0]*edges[(corner[0]+3)%6] + n[1]*edges[(corner[1]+3)%6] + n[2]*edges[(corner[2]+3)%6] + planes.D[i];
+
+			if (distNear > 0.f)
+				return false;
+			if (distFar < 0.f)
+				mask &= ~(1 << i);
+		}
+
+		planeMask = mask;
+		return true;
+	}
+
+	template <class T>
+	void queryNode(const SQueryPlanes& planes, s32 index, u32 planeMask, T& callback) const
+	{
+		const STreeNode& node = Nodes[index];
+		if (planeMask && !classifyBox(planes, node.Box, planeMask))
+			return;
+
+		if (node.isLeaf())
+			callback(index, node.UserData, planeMask == 0);
+		else
+		{
+			queryNode(planes, node.Child1, planeMask, callback);
+			queryNode(planes, node.Child2, planeMask, callback);
+		}
+	}
+
+	template <class T>
+	void queryNode(const core::aabbox3df& box, s32 index, T& callback) const
+	{
+		const STreeNode& node = Nodes[index];
+		if (!node.Box.intersectsWithBox(box))
+			return;
+
+		if (node.isLeaf())
+			callback(index, node.UserData);
+		else
+		{
+			queryNode(box, node.Child1, callback);
+			queryNode(box, node.Child2, callback);
+		}
+	}
+
+	s32 allocateNode();
+	void freeNode(s32 index);
+
+	void insertLeaf(s32 leaf);
+	void removeLeaf(s32 leaf);
+
+	//! rotates the tree at node a if it is unbalanced, returns the new root of the subtree
+	s32 balance(s32 a);
+
+	//! recalculates boxes and heights from a node up to the root
+	void refit(s32 index);
+
+	core::aabbox3df fatten(const core::aabbox3df& box) const;
+
+	core::array<STreeNode> Nodes;
+	s32 Root;
+	s32 FreeList;
+	u32 ProxyCount;
+	f32 Margin;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
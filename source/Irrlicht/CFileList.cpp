@@ -17,7 +17,7 @@ namespace io
 static const io::path emptyFileListEntry;
 
 CFileList::CFileList(const io::path& path, bool ignoreCase, bool ignorePaths)
- : IgnorePaths(ignorePaths), IgnoreCase(ignoreCase), Path(path)
+ : IgnorePaths(ignorePaths), IgnoreCase(ignoreCase), Path(path), FileIndexDirty(true)
 {
 	#ifdef _DEBUG
 	setDebugName("CFileList");
@@ -39,6 +39,7 @@ u32 CFileList::getFileCount() const
 void CFileList::sort()
 {
 	Files.sort();
+	FileIndexDirty = true;
 }
 
 const io::path& CFileList::getFileName(u32 index) const
@@ -91,6 +92,7 @@ u32 CFileList::addItem(const io::path& fullPath, u32 offset, u32 size, bool isDi
 	//os::Printer::log(Path.c_str(), entry.FullName);
 
 	Files.push_back(entry);
+	FileIndexDirty = true;
 
 	return Files.size() - 1;
 }
@@ -147,7 +149,29 @@ s32 CFileList::findFile(const io::path& filename, bool isDirectory = false) cons
 	if (IgnorePaths)
 		core::deletePathFromFilename(entry.FullName);
 
-	return Files.binary_search(entry);
+	// derived lists can also change Files directly
+	if (FileIndexDirty || FileIndex.size() > Files.size())
+	{
+		FileIndex.clear();
+		FileIndex.reallocate(Files.size());
+		for (u32 i=0; i<Files.size(); ++i)
+			FileIndex.insert(getIndexKey(Files[i].FullName, Files[i].IsDirectory), (s32)i);
+		FileIndexDirty = false;
+	}
+
+	const s32* index = FileIndex.find(getIndexKey(entry.FullName, entry.IsDirectory));
+	return index ? *index : -1;
+}
+
+
+io::path CFileList::getIndexKey(const io::path& fullName, bool isDirectory)
+{
+	// names are compared without case, directories get their trailing slash back
+	io::path key(fullName);
+	key.make_lower();
+	if (isDirectory)
+		key.append('/');
+	return key;
 }
 
 
@@ -8,6 +8,7 @@
 #include "IFileList.h"
 #include "irrString.h"
 #include "irrArray.h"
+#include "irrHashMap.h"
 
 
 namespace irr
@@ -127,6 +128,15 @@ protected:
 
 	//! List of files
 	core::array<SFileListEntry> Files;
+
+private:
+
+	//! returns the key of a name in FileIndex
+	static io::path getIndexKey(const io::path& fullName, bool isDirectory);
+
+	//! indices of Files by their lower case full name, rebuilt by findFile when Files changed
+	mutable core::hash_map<io::path, s32> FileIndex;
+	mutable bool FileIndexDirty;
 };
 
 
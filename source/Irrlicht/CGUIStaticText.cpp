@@ -314,9 +314,12 @@ void CGUIStaticText::breakText()
 
 	LastBreakFont = font;
 
+	// words and whitespace are short, so they are kept without heap memory
+	typedef core::string<wchar_t, core::irrAllocatorSmall<wchar_t, 32> > stringw_small;
+
 	core::stringw line;
-	core::stringw word;
-	core::stringw whitespace;
+	stringw_small word;
+	stringw_small whitespace;
 	s32 size = Text.size();
 	s32 length = 0;
 	s32 elWidth = RelativeRect.getWidth();
@@ -375,9 +378,9 @@ void CGUIStaticText::breakText()
 						int where = word.findFirst( wchar_t(0x00AD) );
 						if (where != -1)
 						{
-							core::stringw first  = word.subString(0, where);
-							core::stringw second = word.subString(where, word.size() - where);
-							BrokenText.push_back(line + first + L"-");
+							stringw_small first  = word.subString(0, where);
+							stringw_small second = word.subString(where, word.size() - where);
+							BrokenText.push_back(line + first.c_str() + L"-");
 							const s32 secondLength = font->getDimension(second.c_str()).Width;
 
 							length = secondLength;
@@ -403,8 +406,8 @@ void CGUIStaticText::breakText()
 					else
 					{
 						// add word to line
-						line += whitespace;
-						line += word;
+						line += whitespace.c_str();
+						line += word.c_str();
 						length += whitelgth + wordlgth;
 					}
 
@@ -420,8 +423,8 @@ void CGUIStaticText::breakText()
 				// compute line break
 				if (lineBreak)
 				{
-					line += whitespace;
-					line += word;
+					line += whitespace.c_str();
+					line += word.c_str();
 					BrokenText.push_back(line);
 					line = L"";
 					word = L"";
@@ -431,8 +434,8 @@ void CGUIStaticText::breakText()
 			}
 		}
 
-		line += whitespace;
-		line += word;
+		line += whitespace.c_str();
+		line += word.c_str();
 		BrokenText.push_back(line);
 	}
 	else
@@ -0,0 +1,643 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CIrrBinaryAttributes.h"
+#include "os.h"
+
+namespace irr
+{
+namespace io
+{
+
+namespace
+{
+	inline u32 toHostEndian(u32 value)
+	{
+#ifdef __BIG_ENDIAN__
+		return os::Byteswap::byteswap(value);
+#else
+		return value;
+#endif
+	}
+}
+
+//! Removes all data and strings
+void CIrrBinaryWriter::clear()
+{
+	Data.clear();
+	StringOffsets.clear();
+	StringData.clear();
+	StringIndices.clear();
+}
+
+
+//! Writes data consisting of 32 bit values, like vertices or 32 bit indices
+void CIrrBinaryWriter::writeWords(const void* data, u32 count)
+{
+	const u32 pos = Data.size();
+	Data.set_used(pos + count);
+	if (count)
+		memcpy(&Data[pos], data, count*sizeof(u32));
+}
+
+
+//! Writes 16 bit values, padded to full words
+void CIrrBinaryWriter::writeShorts(const u16* data, u32 count)
+{
+	const u32 pos = Data.size();
+	Data.set_used(pos + (count+1)/2);
+	if (count & 1)
+		Data.getLast() = 0;
+#ifdef __BIG_ENDIAN__
+	for (u32 i=0; i<count; i+=2)
+		Data[pos+i/2] = data[i] | (i+1<count ? (u32)data[i+1]<<16 : 0);
+#else
+	if (count)
+		memcpy(&Data[pos], data, count*sizeof(u16));
+#endif
+}
+
+
+//! writes an attribute block
+void CIrrBinaryWriter::writeAttributes(IAttributes* attr)
+{
+	const u32 countPos = Data.size();
+	writeWord(0);
+	u32 count = 0;
+
+	for (u32 i=0; i<attr->getAttributeCount(); ++i)
+	{
+		const E_ATTRIBUTE_TYPE type = attr->getAttributeType(i);
+
+		// pointers make no sense in a file, .irr files are not reading them either
+		if (type == EAT_USER_POINTER)
+			continue;
+
+		writeWord(addString(attr->getAttributeName(i)));
+		writeWord((u32)type);
+		const u32 sizePos = Data.size();
+		writeWord(0);
+
+		switch (type)
+		{
+		case EAT_INT:
+			writeWord((u32)attr->getAttributeAsInt(i));
+			break;
+		case EAT_FLOAT:
+			writeFloat(attr->getAttributeAsFloat(i));
+			break;
+		case EAT_BOOL:
+			writeWord(attr->getAttributeAsBool(i) ? 1 : 0);
+			break;
+		case EAT_COLOR:
+			writeWord(attr->getAttributeAsColor(i).color);
+			break;
+		case EAT_COLORF:
+			{
+				const video::SColorf c = attr->getAttributeAsColorf(i);
+				writeFloat(c.r);
+				writeFloat(c.g);
+				writeFloat(c.b);
+				writeFloat(c.a);
+			}
+			break;
+		case EAT_VECTOR3D:
+			{
+				const core::vector3df v = attr->getAttributeAsVector3d(i);
+				writeFloat(v.X);
+				writeFloat(v.Y);
+				writeFloat(v.Z);
+			}
+			break;
+		case EAT_VECTOR2D:
+			{
+				const core::vector2df v = attr->getAttributeAsVector2d(i);
+				writeFloat(v.X);
+				writeFloat(v.Y);
+			}
+			break;
+		case EAT_POSITION2D:
+			{
+				const core::position2di p = attr->getAttributeAsPosition2d(i);
+				writeWord((u32)p.X);
+				writeWord((u32)p.Y);
+			}
+			break;
+		case EAT_RECT:
+			{
+				const core::rect<s32> r = attr->getAttributeAsRect(i);
+				writeWord((u32)r.UpperLeftCorner.X);
+				writeWord((u32)r.UpperLeftCorner.Y);
+				writeWord((u32)r.LowerRightCorner.X);
+				writeWord((u32)r.LowerRightCorner.Y);
+			}
+			break;
+		case EAT_DIMENSION2D:
+			{
+				const core::dimension2du d = attr->getAttributeAsDimension2d(i);
+				writeWord(d.Width);
+				writeWord(d.Height);
+			}
+			break;
+		case EAT_MATRIX:
+			{
+				const core::matrix4 m = attr->getAttributeAsMatrix(i);
+				for (u32 k=0; k<16; ++k)
+					writeFloat(m[k]);
+			}
+			break;
+		case EAT_QUATERNION:
+			{
+				const core::quaternion q = attr->getAttributeAsQuaternion(i);
+				writeFloat(q.X);
+				writeFloat(q.Y);
+				writeFloat(q.Z);
+				writeFloat(q.W);
+			}
+			break;
+		case EAT_BBOX:
+			{
+				const core::aabbox3df b = attr->getAttributeAsBox3d(i);
+				writeFloat(b.MinEdge.X);
+				writeFloat(b.MinEdge.Y);
+				writeFloat(b.MinEdge.Z);
+				writeFloat(b.MaxEdge.X);
+				writeFloat(b.MaxEdge.Y);
+				writeFloat(b.MaxEdge.Z);
+			}
+			break;
+		case EAT_PLANE:
+			{
+				const core::plane3df p = attr->getAttributeAsPlane3d(i);
+				writeFloat(p.Normal.X);
+				writeFloat(p.Normal.Y);
+				writeFloat(p.Normal.Z);
+				writeFloat(p.D);
+			}
+			break;
+		case EAT_TRIANGLE3D:
+			{
+				const core::triangle3df t = attr->getAttributeAsTriangle3d(i);
+				const core::vector3df* points[3] = { &t.pointA, &t.pointB, &t.pointC };
+				for (u32 k=0; k<3; ++k)
+				{
+					writeFloat(points[k]->X);
+					writeFloat(points[k]->Y);
+					writeFloat(points[k]->Z);
+				}
+			}
+			break;
+		case EAT_LINE2D:
+			{
+				const core::line2df l = attr->getAttributeAsLine2d(i);
+				writeFloat(l.start.X);
+				writeFloat(l.start.Y);
+				writeFloat(l.end.X);
+				writeFloat(l.end.Y);
+			}
+			break;
+		case EAT_LINE3D:
+			{
+				const core::line3df l = attr->getAttributeAsLine3d(i);
+				writeFloat(l.start.X);
+				writeFloat(l.start.Y);
+				writeFloat(l.start.Z);
+				writeFloat(l.end.X);
+				writeFloat(l.end.Y);
+				writeFloat(l.end.Z);
+			}
+			break;
+		case EAT_STRINGWARRAY:
+			{
+				const core::array<core::stringw> arr = attr->getAttributeAsArray(i);
+				writeWord(arr.size());
+				for (u32 k=0; k<arr.size(); ++k)
+					writeWord(addString(arr[k].c_str()));
+			}
+			break;
+		case EAT_STRING:
+			writeWord(addString(attr->getAttributeAsStringW(i).c_str()));
+			break;
+		default:
+			// enums, textures, binary data and all other types use their string form, like in .irr files
+			writeWord(addString(attr->getAttributeAsStringW(i).c_str()));
+			break;
+		}
+
+		Data[sizePos] = Data.size() - sizePos - 1;
+		++count;
+	}
+
+	Data[countPos] = count;
+}
+
+
+//! returns index of a string in the string table, adds it if necessary
+u32 CIrrBinaryWriter::addString(const c8* str)
+{
+	if (!str)
+		return IRR_BINARY_NO_STRING;
+
+	const core::stringc key(str);
+	core::map<core::stringc, u32>::Node* n = StringIndices.find(key);
+	if (n)
+		return n->getValue();
+
+	const u32 index = StringOffsets.size();
+	StringOffsets.push_back(StringData.size());
+	for (u32 i=0; i<=key.size(); ++i)
+		StringData.push_back(key.c_str()[i]);
+
+	StringIndices.insert(key, index);
+	return index;
+}
+
+
+//! adds a wide string as utf-8 to the string table
+u32 CIrrBinaryWriter::addString(const wchar_t* str)
+{
+	if (!str)
+		return IRR_BINARY_NO_STRING;
+
+	// each wchar can need up to 4 bytes in utf-8
+	const u32 len = (u32)wcslen(str);
+	Utf8Buffer.set_used(len*4+1);
+	core::wcharToUtf8(str, Utf8Buffer.pointer(), Utf8Buffer.size());
+
+	return addString(Utf8Buffer.const_pointer());
+}
+
+
+//! Pads the string data to full words and swaps all words on big endian systems
+void CIrrBinaryWriter::finish()
+{
+	while (StringData.size() & 3)
+		StringData.push_back(0);
+
+#ifdef __BIG_ENDIAN__
+	for (u32 i=0; i<StringOffsets.size(); ++i)
+		StringOffsets[i] = os::Byteswap::byteswap(StringOffsets[i]);
+	for (u32 i=0; i<Data.size(); ++i)
+		Data[i] = os::Byteswap::byteswap(Data[i]);
+#endif
+}
+
+
+CIrrBinaryReader::CIrrBinaryReader()
+ : Data(0), DataSize(0), Pos(0), Failed(false),
+	StringOffsets(0), StringData(0), StringCount(0), StringDataSize(0)
+{
+}
+
+
+//! Sets the memory to read from
+void CIrrBinaryReader::setData(const u32* stringOffsets, u32 stringCount, const c8* stringData, u32 stringDataSize,
+	const u32* data, u32 dataSize)
+{
+	StringOffsets = stringOffsets;
+	StringCount = stringCount;
+	StringData = stringData;
+	StringDataSize = stringDataSize;
+	Data = data;
+	DataSize = dataSize;
+	Pos = 0;
+	Failed = false;
+}
+
+
+//! Reads an attribute block into attr, which is cleared first
+bool CIrrBinaryReader::readAttributes(IAttributes* attr)
+{
+	attr->clear();
+
+	const u32 count = readWord();
+	for (u32 i=0; i<count && !Failed; ++i)
+	{
+		const c8* name = getString(readWord());
+		const u32 type = readWord();
+		const u32 size = readWord();
+		if (!name || Failed || size > DataSize - Pos)
+			return false;
+
+		const u32 end = Pos + size;
+
+		switch (type)
+		{
+		case EAT_INT:
+			attr->addInt(name, (s32)readWord());
+			break;
+		case EAT_FLOAT:
+			attr->addFloat(name, readFloat());
+			break;
+		case EAT_BOOL:
+			attr->addBool(name, readWord() != 0);
+			break;
+		case EAT_COLOR:
+			attr->addColor(name, video::SColor(readWord()));
+			break;
+		case EAT_COLORF:
+			{
+				video::SColorf c;
+				c.r = readFloat();
+				c.g = readFloat();
+				c.b = readFloat();
+				c.a = readFloat();
+				attr->addColorf(name, c);
+			}
+			break;
+		case EAT_VECTOR3D:
+			{
+				core::vector3df v;
+				v.X = readFloat();
+				v.Y = readFloat();
+				v.Z = readFloat();
+				attr->addVector3d(name, v);
+			}
+			break;
+		case EAT_VECTOR2D:
+			{
+				core::vector2df v;
+				v.X = readFloat();
+				v.Y = readFloat();
+				attr->addVector2d(name, v);
+			}
+			break;
+		case EAT_POSITION2D:
+			{
+				core::position2di p;
+				p.X = (s32)readWord();
+				p.Y = (s32)readWord();
+				attr->addPosition2d(name, p);
+			}
+			break;
+		case EAT_RECT:
+			{
+				core::rect<s32> r;
+				r.UpperLeftCorner.X = (s32)readWord();
+				r.UpperLeftCorner.Y = (s32)readWord();
+				r.LowerRightCorner.X = (s32)readWord();
+				r.LowerRightCorner.Y = (s32)readWord();
+				attr->addRect(name, r);
+			}
+			break;
+		case EAT_DIMENSION2D:
+			{
+				core::dimension2du d;
+				d.Width = readWord();
+				d.Height = readWord();
+				attr->addDimension2d(name, d);
+			}
+			break;
+		case EAT_MATRIX:
+			{
+				core::matrix4 m(core::matrix4::EM4CONST_NOTHING);
+				for (u32 k=0; k<16; ++k)
+					m[k] = readFloat();
+				attr->addMatrix(name, m);
+			}
+			break;
+		case EAT_QUATERNION:
+			{
+				core::quaternion q;
+				q.X = readFloat();
+				q.Y = readFloat();
+				q.Z = readFloat();
+				q.W = readFloat();
+				attr->addQuaternion(name, q);
+			}
+			break;
+		case EAT_BBOX:
+			{
+				core::aabbox3df b;
+				b.MinEdge.X = readFloat();
+				b.MinEdge.Y = readFloat();
+				b.MinEdge.Z = readFloat();
+				b.MaxEdge.X = readFloat();
+				b.MaxEdge.Y = readFloat();
+				b.MaxEdge.Z = readFloat();
+				attr->addBox3d(name, b);
+			}
+			break;
+		case EAT_PLANE:
+			{
+				core::plane3df p;
+				p.Normal.X = readFloat();
+				p.Normal.Y = readFloat();
+				p.Normal.Z = readFloat();
+				p.D = readFloat();
+				attr->addPlane3d(name, p);
+			}
+			break;
+		case EAT_TRIANGLE3D:
+			{
+				core::triangle3df t;
+				core::vector3df* points[3] = { &t.pointA, &t.pointB, &t.pointC };
+				for (u32 k=0; k<3; ++k)
+				{
+					points[k]->X = readFloat();
+					points[k]->Y = readFloat();
+					points[k]->Z = readFloat();
+				}
+				attr->addTriangle3d(name, t);
+			}
+			break;
+		case EAT_LINE2D:
+			{
+				core::line2df l;
+				l.start.X = readFloat();
+				l.start.Y = readFloat();
+				l.end.X = readFloat();
+				l.end.Y = readFloat();
+				attr->addLine2d(name, l);
+			}
+			break;
+		case EAT_LINE3D:
+			{
+				core::line3df l;
+				l.start.X = readFloat();
+				l.start.Y = readFloat();
+				l.start.Z = readFloat();
+				l.end.X = readFloat();
+				l.end.Y = readFloat();
+				l.end.Z = readFloat();
+				attr->addLine3d(name, l);
+			}
+			break;
+		case EAT_STRINGWARRAY:
+			{
+				const u32 arraySize = readWord();
+				if (arraySize > end - Pos)
+					return false;
+				core::array<core::stringw> arr(arraySize);
+				for (u32 k=0; k<arraySize; ++k)
+				{
+					const wchar_t* str = getStringW(readWord());
+					if (!str)
+						return false;
+					arr.push_back(str);
+				}
+				attr->addArray(name, arr);
+			}
+			break;
+		case EAT_STRING:
+			{
+				const wchar_t* str = getStringW(readWord());
+				if (!str)
+					return false;
+				attr->addString(name, str);
+			}
+			break;
+		case EAT_ENUM:
+		case EAT_BINARY:
+		case EAT_TEXTURE:
+			{
+				// stored in their string form, like .irr files do
+				const wchar_t* str = getStringW(readWord());
+				if (!str)
+					return false;
+				if (type == EAT_ENUM)
+					attr->addEnum(name, 0, 0);
+				else if (type == EAT_BINARY)
+					attr->addBinary(name, 0, 0);
+				else
+					attr->addTexture(name, 0);
+				attr->setAttribute((s32)attr->getAttributeCount()-1, str);
+			}
+			break;
+		default:
+			// types the xml loader can't read either
+			break;
+		}
+
+		if (Failed || Pos > end)
+			return false;
+		Pos = end;
+	}
+
+	return !Failed;
+}
+
+
+//! Reads next word, sets Failed when reading past the end of the data
+u32 CIrrBinaryReader::readWord()
+{
+	if (Pos >= DataSize)
+	{
+		Failed = true;
+		return 0;
+	}
+	return toHostEndian(Data[Pos++]);
+}
+
+
+f32 CIrrBinaryReader::readFloat()
+{
+	const u32 value = readWord();
+	return FR(value);
+}
+
+
+//! Returns string from string table, or 0 for an invalid index
+const c8* CIrrBinaryReader::getString(u32 index)
+{
+	if (index >= StringCount)
+	{
+		Failed = true;
+		return 0;
+	}
+
+	const u32 offset = toHostEndian(StringOffsets[index]);
+	if (offset >= StringDataSize)
+	{
+		Failed = true;
+		return 0;
+	}
+
+	// the writer always terminates strings, but don't trust the file
+	const c8* str = StringData + offset;
+	for (u32 i=offset; i<StringDataSize; ++i)
+	{
+		if (StringData[i] == 0)
+			return str;
+	}
+
+	Failed = true;
+	return 0;
+}
+
+
+//! Returns string from string table converted to a wide string
+const wchar_t* CIrrBinaryReader::getStringW(u32 index)
+{
+	const c8* str = getString(index);
+	if (!str)
+		return 0;
+
+	u32 len = 0;
+	bool ascii = true;
+	for (; str[len]; ++len)
+		ascii &= (u8)str[len] < 0x80;
+
+	WideBuffer.set_used(len+1);
+	if (ascii)
+	{
+		for (u32 i=0; i<=len; ++i)
+			WideBuffer[i] = (wchar_t)str[i];
+	}
+	else
+		core::utf8ToWchar(str, WideBuffer.pointer(), WideBuffer.size()*sizeof(wchar_t));
+
+	return WideBuffer.const_pointer();
+}
+
+
+//! Reads count 32 bit values into dest
+bool CIrrBinaryReader::readWords(void* dest, u32 count)
+{
+	if (count > DataSize - Pos)
+	{
+		Failed = true;
+		return false;
+	}
+
+#ifdef __BIG_ENDIAN__
+	u32* target = static_cast<u32*>(dest);
+	for (u32 i=0; i<count; ++i)
+		target[i] = toHostEndian(Data[Pos+i]);
+#else
+	if (count)
+		memcpy(dest, Data+Pos, count*sizeof(u32));
+#endif
+	Pos += count;
+	return true;
+}
+
+
+//! Reads count 16 bit values written with CIrrBinaryWriter::writeShorts into dest
+bool CIrrBinaryReader::readShorts(u16* dest, u32 count)
+{
+	const u32 words = (count+1)/2;
+	if (words > DataSize - Pos)
+	{
+		Failed = true;
+		return false;
+	}
+
+#ifdef __BIG_ENDIAN__
+	for (u32 i=0; i<count; ++i)
+	{
+		const u32 w = toHostEndian(Data[Pos+i/2]);
+		dest[i] = (i & 1) ? (u16)(w>>16) : (u16)(w & 0xffff);
+	}
+#else
+	if (count)
+		memcpy(dest, Data+Pos, count*sizeof(u16));
+#endif
+	Pos += words;
+	return true;
+}
+
+} // end namespace io
+} // end namespace irr
+
@@ -0,0 +1,161 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IRR_BINARY_ATTRIBUTES_H_INCLUDED__
+#define __C_IRR_BINARY_ATTRIBUTES_H_INCLUDED__
+
+#include "IAttributes.h"
+#include "irrMap.h"
+
+namespace irr
+{
+namespace io
+{
+
+//! String index used when no string is set
+const u32 IRR_BINARY_NO_STRING = 0xffffffff;
+
+//! Collects 32 bit words and a string table for the binary .irrb and .irrbin formats
+/** Attribute blocks are written as attribute count, followed by name (string index),
+E_ATTRIBUTE_TYPE, payload size in words and payload for every attribute.
+Numbers are stored as raw s32/u32/f32 values, strings and references like
+texture names as string indices. Words are in host byte order until
+swapToLittleEndian is called. */
+class CIrrBinaryWriter
+{
+public:
+
+	//! Removes all data and strings
+	void clear();
+
+	void writeWord(u32 value)
+	{
+		Data.push_back(value);
+	}
+
+	void writeFloat(f32 value)
+	{
+		Data.push_back(IR(value));
+	}
+
+	//! Writes data consisting of 32 bit values, like vertices or 32 bit indices
+	void writeWords(const void* data, u32 count);
+
+	//! Writes 16 bit values, padded to full words
+	void writeShorts(const u16* data, u32 count);
+
+	//! Writes an attribute block
+	void writeAttributes(IAttributes* attr);
+
+	//! Returns index of a string in the string table, adds it if necessary
+	u32 addString(const c8* str);
+
+	//! Adds a wide string as utf-8 to the string table
+	u32 addString(const wchar_t* str);
+
+	//! Current position in words, to patch values with setWord once they are known
+	u32 getPosition() const
+	{
+		return Data.size();
+	}
+
+	void setWord(u32 position, u32 value)
+	{
+		Data[position] = value;
+	}
+
+	//! Pads the string data to full words and swaps all words on big endian systems
+	void finish();
+
+	const core::array<u32>& getData() const { return Data; }
+	const core::array<u32>& getStringOffsets() const { return StringOffsets; }
+	const core::array<c8>& getStringData() const { return StringData; }
+
+private:
+
+	core::array<u32> Data;
+
+	core::array<u32> StringOffsets;
+	core::array<c8> StringData;
+	core::map<core::stringc, u32> StringIndices;
+
+	//! buffer for wide string conversion
+	core::array<c8> Utf8Buffer;
+};
+
+
+//! Reads data written by CIrrBinaryWriter directly from memory
+/** All reads are bounds checked. Reading past the end or invalid string indices
+set a failure flag and return 0 values, so callers only need to check failed()
+before using results. */
+class CIrrBinaryReader
+{
+public:
+
+	CIrrBinaryReader();
+
+	//! Sets the memory to read from, which is not copied and must stay valid while reading
+	void setData(const u32* stringOffsets, u32 stringCount, const c8* stringData, u32 stringDataSize,
+		const u32* data, u32 dataSize);
+
+	//! Reads next word
+	u32 readWord();
+
+	f32 readFloat();
+
+	//! Reads count 32 bit values into dest
+	bool readWords(void* dest, u32 count);
+
+	//! Reads count 16 bit values written with CIrrBinaryWriter::writeShorts into dest
+	bool readShorts(u16* dest, u32 count);
+
+	//! Reads an attribute block into attr, which is cleared first
+	bool readAttributes(IAttributes* attr);
+
+	//! Returns string from the string table, or 0 for an invalid index
+	const c8* getString(u32 index);
+
+	//! Returns string from the string table converted to a wide string
+	/** The result is only valid until the next call. */
+	const wchar_t* getStringW(u32 index);
+
+	//! True when any read failed
+	bool failed() const
+	{
+		return Failed;
+	}
+
+	//! Marks the data as invalid, e.g. for counts which can't fit into the remaining words
+	void fail()
+	{
+		Failed = true;
+	}
+
+	//! Words left to read
+	u32 getRemaining() const
+	{
+		return DataSize - Pos;
+	}
+
+private:
+
+	const u32* Data;
+	u32 DataSize;
+	u32 Pos;
+	bool Failed;
+
+	const u32* StringOffsets;
+	const c8* StringData;
+	u32 StringCount;
+	u32 StringDataSize;
+
+	//! buffer for wide string conversion
+	core::array<wchar_t> WideBuffer;
+};
+
+} // end namespace io
+} // end namespace irr
+
+#endif
+
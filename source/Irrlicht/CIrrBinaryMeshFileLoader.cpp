@@ -0,0 +1,459 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+
+#include "CIrrBinaryMeshFileLoader.h"
+#include "SIrrBinaryMeshStructs.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "IFileSystem.h"
+#include "IReadFile.h"
+#include "IMemoryReadFile.h"
+#include "SMesh.h"
+#include "SAnimatedMesh.h"
+#include "CDynamicMeshBuffer.h"
+#include "os.h"
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	#ifndef _IRR_USE_NON_SYSTEM_ZLIB_
+	#include <zlib.h> // use system lib
+	#else
+	#include "zlib/zlib.h"
+	#endif
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	inline u32 toHostEndian(u32 value)
+	{
+#ifdef __BIG_ENDIAN__
+		return os::Byteswap::byteswap(value);
+#else
+		return value;
+#endif
+	}
+
+	bool readHeader(io::IReadFile* file, SIrrBinaryMeshHeader& header)
+	{
+		if (file->read(&header, sizeof(header)) != sizeof(header))
+			return false;
+
+		u32* headerWords = reinterpret_cast<u32*>(&header);
+		for (u32 i=0; i<sizeof(header)/sizeof(u32); ++i)
+			headerWords[i] = toHostEndian(headerWords[i]);
+
+		return header.Magic == IRRBIN_MESH_MAGIC && header.Version == IRRBIN_MESH_VERSION;
+	}
+}
+
+
+//! Constructor
+CIrrBinaryMeshFileLoader::CIrrBinaryMeshFileLoader(scene::ISceneManager* smgr)
+	: SceneManager(smgr), Driver(smgr->getVideoDriver()), Attributes(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CIrrBinaryMeshFileLoader");
+	#endif
+}
+
+
+//! returns true if the file maybe is able to be loaded by this class
+bool CIrrBinaryMeshFileLoader::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension(filename, "irrbin");
+}
+
+
+//! Reads size and content hash of the source file from the header of an .irrbin file
+bool CIrrBinaryMeshFileLoader::readSource(io::IReadFile* file, u32& sourceSize, u32& sourceHash)
+{
+	SIrrBinaryMeshHeader header;
+	if (!file || !readHeader(file, header))
+		return false;
+
+	sourceSize = header.SourceSize;
+	sourceHash = header.SourceHash;
+	return true;
+}
+
+
+//! creates/loads an animated mesh from the file.
+IAnimatedMesh* CIrrBinaryMeshFileLoader::createMesh(io::IReadFile* file)
+{
+	SIrrBinaryMeshHeader header;
+	if (!readHeader(file, header))
+	{
+		os::Printer::log("Not a valid .irrbin file of the current version", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const u64 fullSize = ((u64)header.StringCount + header.DataSize)*sizeof(u32) + header.StringDataSize;
+	const u32 payloadSize = (u32)fullSize;
+	if (fullSize > 0x7fffffff || (header.StringDataSize & 3) ||
+		(!(header.Flags & IRRBIN_FLAG_COMPRESSED) && header.PayloadSize != payloadSize) ||
+		(long)header.PayloadSize > file->getSize() - file->getPos())
+	{
+		os::Printer::log("Invalid .irrbin header", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	// read everything with a single call, memory files are used in place
+	const u32* payload = 0;
+	if (!(header.Flags & IRRBIN_FLAG_COMPRESSED) && file->getType() == io::ERFT_MEMORY_READ_FILE)
+	{
+		const c8* buffer = static_cast<const c8*>(static_cast<io::IMemoryReadFile*>(file)->getBuffer()) + file->getPos();
+		if (((size_t)buffer & 3) == 0)
+			payload = reinterpret_cast<const u32*>(buffer);
+	}
+
+	if (!payload)
+	{
+		FileBuffer.set_used(payloadSize/sizeof(u32));
+
+		if (header.Flags & IRRBIN_FLAG_COMPRESSED)
+		{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+			core::array<u8> compressed;
+			compressed.set_used(header.PayloadSize);
+			uLongf size = payloadSize;
+			if (file->read(compressed.pointer(), header.PayloadSize) != header.PayloadSize ||
+				uncompress((Bytef*)FileBuffer.pointer(), &size, compressed.const_pointer(), header.PayloadSize) != Z_OK ||
+				size != payloadSize)
+			{
+				os::Printer::log("Could not decompress .irrbin file", file->getFileName(), ELL_ERROR);
+				FileBuffer.clear();
+				return 0;
+			}
+#else
+			os::Printer::log("Compressed .irrbin files need zlib", file->getFileName(), ELL_ERROR);
+			FileBuffer.clear();
+			return 0;
+#endif
+		}
+		else if (file->read(FileBuffer.pointer(), payloadSize) != payloadSize)
+		{
+			os::Printer::log("Could not read .irrbin file", file->getFileName(), ELL_ERROR);
+			FileBuffer.clear();
+			return 0;
+		}
+
+		payload = FileBuffer.const_pointer();
+	}
+
+	Reader.setData(payload, header.StringCount,
+		reinterpret_cast<const c8*>(payload + header.StringCount), header.StringDataSize,
+		payload + header.StringCount + header.StringDataSize/sizeof(u32), header.DataSize);
+
+	if (Driver)
+		Attributes = SceneManager->getFileSystem()->createEmptyAttributes(Driver);
+
+	const E_ANIMATED_MESH_TYPE type = (E_ANIMATED_MESH_TYPE)Reader.readWord();
+	const bool skinned = Reader.readWord() != 0;
+	const f32 animationSpeed = Reader.readFloat();
+	readBoundingBox();
+
+	IAnimatedMesh* mesh = skinned ? readSkinnedMesh(animationSpeed) : readStaticMesh(type);
+
+	if (!mesh)
+		os::Printer::log("Could not read .irrbin file, the file is corrupt", file->getFileName(), ELL_ERROR);
+
+	// clean up
+	if (Attributes)
+		Attributes->drop();
+	Attributes = 0;
+	Reader.setData(0, 0, 0, 0, 0, 0);
+	FileBuffer.clear();
+
+	return mesh;
+}
+
+
+IAnimatedMesh* CIrrBinaryMeshFileLoader::readStaticMesh(E_ANIMATED_MESH_TYPE type)
+{
+	SMesh* mesh = new SMesh();
+
+	const u32 bufferCount = Reader.readWord();
+	for (u32 i=0; i<bufferCount && !Reader.failed(); ++i)
+	{
+		video::SMaterial material;
+		SBufferInfo info;
+		if (!readBufferInfo(material, info))
+		{
+			mesh->drop();
+			return 0;
+		}
+
+		CDynamicMeshBuffer* buffer = new CDynamicMeshBuffer(info.VertexType, info.IndexType);
+		buffer->getMaterial() = material;
+		buffer->setPrimitiveType(info.PrimitiveType);
+		buffer->setHardwareMappingHint(info.MappingHintVertex, EBT_VERTEX);
+		buffer->setHardwareMappingHint(info.MappingHintIndex, EBT_INDEX);
+
+		IVertexBuffer& vertices = buffer->getVertexBuffer();
+		vertices.set_used(info.VertexCount);
+		Reader.readWords(vertices.pointer(), info.VertexCount*vertices.stride()/sizeof(u32));
+
+		IIndexBuffer& indices = buffer->getIndexBuffer();
+		indices.set_used(info.IndexCount);
+		if (info.IndexType == video::EIT_32BIT)
+			Reader.readWords(indices.pointer(), info.IndexCount);
+		else
+			Reader.readShorts(static_cast<u16*>(indices.pointer()), info.IndexCount);
+
+		buffer->setBoundingBox(info.BoundingBox);
+		mesh->addMeshBuffer(buffer);
+		buffer->drop();
+	}
+
+	if (Reader.failed())
+	{
+		mesh->drop();
+		return 0;
+	}
+
+	mesh->recalculateBoundingBox();
+
+	SAnimatedMesh* animatedMesh = new SAnimatedMesh(mesh, type);
+	mesh->drop();
+
+	return animatedMesh;
+}
+
+
+IAnimatedMesh* CIrrBinaryMeshFileLoader::readSkinnedMesh(f32 animationSpeed)
+{
+	ISkinnedMesh* mesh = SceneManager->createSkinnedMesh();
+	if (!mesh)
+	{
+		os::Printer::log("Skinned .irrbin meshes need skinned mesh support", ELL_ERROR);
+		return 0;
+	}
+
+	const u32 bufferCount = Reader.readWord();
+	for (u32 i=0; i<bufferCount && !Reader.failed(); ++i)
+	{
+		video::SMaterial material;
+		SBufferInfo info;
+		if (!readBufferInfo(material, info) || info.IndexType != video::EIT_16BIT)
+			break;
+
+		SSkinMeshBuffer* buffer = mesh->addMeshBuffer();
+		buffer->Material = material;
+		buffer->VertexType = info.VertexType;
+		buffer->setPrimitiveType(info.PrimitiveType);
+		buffer->setHardwareMappingHint(info.MappingHintVertex, EBT_VERTEX);
+		buffer->setHardwareMappingHint(info.MappingHintIndex, EBT_INDEX);
+		readMatrix(buffer->Transformation);
+
+		const u32 vertexWords = info.VertexCount*video::getVertexPitchFromType(info.VertexType)/sizeof(u32);
+		switch (info.VertexType)
+		{
+		case video::EVT_2TCOORDS:
+			buffer->Vertices_2TCoords.set_used(info.VertexCount);
+			Reader.readWords(buffer->Vertices_2TCoords.pointer(), vertexWords);
+			break;
+		case video::EVT_TANGENTS:
+			buffer->Vertices_Tangents.set_used(info.VertexCount);
+			Reader.readWords(buffer->Vertices_Tangents.pointer(), vertexWords);
+			break;
+		default:
+			buffer->Vertices_Standard.set_used(info.VertexCount);
+			Reader.readWords(buffer->Vertices_Standard.pointer(), vertexWords);
+			break;
+		}
+
+		buffer->Indices.set_used(info.IndexCount);
+		Reader.readShorts(buffer->Indices.pointer(), info.IndexCount);
+
+		buffer->BoundingBox = info.BoundingBox;
+	}
+
+	// joints are created first, so children can be linked by index
+	const u32 jointCount = Reader.readWord();
+	if (Reader.failed() || jointCount > Reader.getRemaining())
+	{
+		mesh->drop();
+		return 0;
+	}
+
+	for (u32 i=0; i<jointCount; ++i)
+		mesh->addJoint(0);
+	core::array<ISkinnedMesh::SJoint*>& joints = mesh->getAllJoints();
+
+	for (u32 i=0; i<jointCount && !Reader.failed(); ++i)
+	{
+		ISkinnedMesh::SJoint* joint = joints[i];
+
+		const c8* name = Reader.getString(Reader.readWord());
+		if (name)
+			joint->Name = name;
+		readMatrix(joint->LocalMatrix);
+		readMatrix(joint->GlobalInversedMatrix);
+		readMatrix(joint->OffsetMatrix);
+
+		const u32 childCount = Reader.readWord();
+		for (u32 k=0; k<childCount && !Reader.failed(); ++k)
+		{
+			const u32 child = Reader.readWord();
+			if (child < jointCount)
+				joint->Children.push_back(joints[child]);
+		}
+
+		u32 count = Reader.readWord();
+		if (count > Reader.getRemaining())
+		{
+			Reader.fail();
+			break;
+		}
+		joint->AttachedMeshes.set_used(count);
+		Reader.readWords(joint->AttachedMeshes.pointer(), count);
+		for (u32 k=0; k<count; ++k)
+		{
+			if (joint->AttachedMeshes[k] >= bufferCount)
+				joint->AttachedMeshes[k] = 0;
+		}
+
+		count = Reader.readWord();
+		if (count > Reader.getRemaining()/4)
+		{
+			Reader.fail();
+			break;
+		}
+		joint->PositionKeys.set_used(count);
+		Reader.readWords(joint->PositionKeys.pointer(), count*4);
+
+		count = Reader.readWord();
+		if (count > Reader.getRemaining()/4)
+		{
+			Reader.fail();
+			break;
+		}
+		joint->ScaleKeys.set_used(count);
+		Reader.readWords(joint->ScaleKeys.pointer(), count*4);
+
+		count = Reader.readWord();
+		if (count > Reader.getRemaining()/5)
+		{
+			Reader.fail();
+			break;
+		}
+		joint->RotationKeys.set_used(count);
+		Reader.readWords(joint->RotationKeys.pointer(), count*5);
+
+		count = Reader.readWord();
+		if (count > Reader.getRemaining()/3)
+		{
+			Reader.fail();
+			break;
+		}
+		joint->Weights.reallocate(count);
+		for (u32 k=0; k<count; ++k)
+		{
+			const u32 bufferId = Reader.readWord();
+			const u32 vertexId = Reader.readWord();
+			const f32 strength = Reader.readFloat();
+
+			// drop weights pointing outside of the mesh, skinning doesn't check them
+			if (bufferId >= bufferCount || vertexId >= mesh->getMeshBuffers()[bufferId]->getVertexCount())
+				continue;
+
+			ISkinnedMesh::SWeight* weight = mesh->addWeight(joint);
+			weight->buffer_id = (u16)bufferId;
+			weight->vertex_id = vertexId;
+			weight->strength = strength;
+		}
+	}
+
+	if (Reader.failed() || joints.size() != jointCount || mesh->getMeshBuffers().size() != bufferCount)
+	{
+		mesh->drop();
+		return 0;
+	}
+
+	mesh->setAnimationSpeed(animationSpeed);
+	mesh->finalize();
+
+	return mesh;
+}
+
+
+//! reads material and buffer description, checks that the vertices and indices fit into the file
+bool CIrrBinaryMeshFileLoader::readBufferInfo(video::SMaterial& material, SBufferInfo& info)
+{
+	if (Attributes)
+	{
+		if (!Reader.readAttributes(Attributes))
+			return false;
+		Driver->fillMaterialStructureFromAttributes(material, Attributes);
+	}
+	else
+	{
+		// no driver for textures, skip the material
+		io::IAttributes* attributes = SceneManager->getFileSystem()->createEmptyAttributes(0);
+		const bool ok = Reader.readAttributes(attributes);
+		attributes->drop();
+		if (!ok)
+			return false;
+	}
+
+	const u32 vertexType = Reader.readWord();
+	const u32 indexType = Reader.readWord();
+	const u32 primitiveType = Reader.readWord();
+	const u32 mappingHintVertex = Reader.readWord();
+	const u32 mappingHintIndex = Reader.readWord();
+	info.VertexCount = Reader.readWord();
+	info.IndexCount = Reader.readWord();
+	info.BoundingBox = readBoundingBox();
+
+	if (Reader.failed() || vertexType > video::EVT_TANGENTS || indexType > video::EIT_32BIT ||
+		primitiveType > EPT_POINT_SPRITES || mappingHintVertex > EHM_STREAM || mappingHintIndex > EHM_STREAM)
+		return false;
+
+	info.VertexType = (video::E_VERTEX_TYPE)vertexType;
+	info.IndexType = (video::E_INDEX_TYPE)indexType;
+	info.PrimitiveType = (E_PRIMITIVE_TYPE)primitiveType;
+	info.MappingHintVertex = (E_HARDWARE_MAPPING)mappingHintVertex;
+	info.MappingHintIndex = (E_HARDWARE_MAPPING)mappingHintIndex;
+
+	// avoid huge allocations for broken files
+	const u32 vertexWords = video::getVertexPitchFromType(info.VertexType)/sizeof(u32);
+	const u32 indexWords = info.IndexType == video::EIT_32BIT ? info.IndexCount : (info.IndexCount+1)/2;
+	if (info.VertexCount > Reader.getRemaining()/vertexWords || indexWords > Reader.getRemaining())
+		return false;
+
+	return true;
+}
+
+
+core::aabbox3df CIrrBinaryMeshFileLoader::readBoundingBox()
+{
+	core::aabbox3df box;
+	box.MinEdge.X = Reader.readFloat();
+	box.MinEdge.Y = Reader.readFloat();
+	box.MinEdge.Z = Reader.readFloat();
+	box.MaxEdge.X = Reader.readFloat();
+	box.MaxEdge.Y = Reader.readFloat();
+	box.MaxEdge.Z = Reader.readFloat();
+	return box;
+}
+
+
+void CIrrBinaryMeshFileLoader::readMatrix(core::matrix4& matrix)
+{
+	Reader.readWords(matrix.pointer(), 16);
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
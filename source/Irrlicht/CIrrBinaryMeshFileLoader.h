@@ -0,0 +1,85 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IRR_BINARY_MESH_FILE_LOADER_H_INCLUDED__
+#define __C_IRR_BINARY_MESH_FILE_LOADER_H_INCLUDED__
+
+#include "IMeshLoader.h"
+#include "ISkinnedMesh.h"
+#include "CIrrBinaryAttributes.h"
+
+namespace irr
+{
+namespace video
+{
+	class IVideoDriver;
+}
+namespace scene
+{
+
+class ISceneManager;
+class IMeshBuffer;
+
+//! Meshloader capable of loading binary .irrbin meshes written by CIrrBinaryMeshWriter.
+class CIrrBinaryMeshFileLoader : public IMeshLoader
+{
+public:
+
+	//! Constructor
+	CIrrBinaryMeshFileLoader(scene::ISceneManager* smgr);
+
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".cob")
+	virtual bool isALoadableFileExtension(const io::path& filename) const _IRR_OVERRIDE_;
+
+	//! creates/loads an animated mesh from the file.
+	//! \return Pointer to the created mesh. Returns 0 if loading failed.
+	//! If you no longer need the mesh, you should call IAnimatedMesh::drop().
+	//! See IReferenceCounted::drop() for more information.
+	virtual IAnimatedMesh* createMesh(io::IReadFile* file) _IRR_OVERRIDE_;
+
+	//! Reads size and content hash of the source file from the header of an .irrbin file
+	/** \return False if the file is no .irrbin file of the current version. */
+	static bool readSource(io::IReadFile* file, u32& sourceSize, u32& sourceHash);
+
+private:
+
+	//! Description of a mesh buffer record
+	struct SBufferInfo
+	{
+		video::E_VERTEX_TYPE VertexType;
+		video::E_INDEX_TYPE IndexType;
+		E_PRIMITIVE_TYPE PrimitiveType;
+		E_HARDWARE_MAPPING MappingHintVertex;
+		E_HARDWARE_MAPPING MappingHintIndex;
+		u32 VertexCount;
+		u32 IndexCount;
+		core::aabbox3df BoundingBox;
+	};
+
+	IAnimatedMesh* readStaticMesh(E_ANIMATED_MESH_TYPE type);
+	IAnimatedMesh* readSkinnedMesh(f32 animationSpeed);
+
+	//! reads material and buffer description, checks that the vertices and indices fit into the file
+	bool readBufferInfo(video::SMaterial& material, SBufferInfo& info);
+
+	core::aabbox3df readBoundingBox();
+	void readMatrix(core::matrix4& matrix);
+
+	scene::ISceneManager* SceneManager;
+	video::IVideoDriver* Driver;
+
+	io::CIrrBinaryReader Reader;
+
+	//! reused for materials
+	io::IAttributes* Attributes;
+
+	//! buffer for the file content
+	core::array<u32> FileBuffer;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
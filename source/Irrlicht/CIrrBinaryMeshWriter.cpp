@@ -0,0 +1,267 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+
+#include "CIrrBinaryMeshWriter.h"
+#include "SIrrBinaryMeshStructs.h"
+#include "os.h"
+#include "IWriteFile.h"
+#include "IMesh.h"
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	#ifndef _IRR_USE_NON_SYSTEM_ZLIB_
+	#include <zlib.h> // use system lib
+	#else
+	#include "zlib/zlib.h"
+	#endif
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+
+CIrrBinaryMeshWriter::CIrrBinaryMeshWriter(video::IVideoDriver* driver)
+	: VideoDriver(driver), SourceSize(0), SourceHash(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CIrrBinaryMeshWriter");
+	#endif
+
+	if (VideoDriver)
+		VideoDriver->grab();
+}
+
+
+CIrrBinaryMeshWriter::~CIrrBinaryMeshWriter()
+{
+	if (VideoDriver)
+		VideoDriver->drop();
+}
+
+
+//! Returns the type of the mesh writer
+EMESH_WRITER_TYPE CIrrBinaryMeshWriter::getType() const
+{
+	return EMWT_IRR_BINARY_MESH;
+}
+
+
+//! writes a mesh
+bool CIrrBinaryMeshWriter::writeMesh(io::IWriteFile* file, scene::IMesh* mesh, s32 flags)
+{
+	if (!file || !mesh)
+		return false;
+
+	os::Printer::log("Writing mesh", file->getFileName());
+
+	ISkinnedMesh* skinnedMesh = 0;
+	if (mesh->getMeshType() == EAMT_SKINNED)
+		skinnedMesh = static_cast<ISkinnedMesh*>(mesh);
+
+	Writer.clear();
+
+	Writer.writeWord(mesh->getMeshType());
+	Writer.writeWord(skinnedMesh ? 1 : 0);
+	Writer.writeFloat(skinnedMesh ? skinnedMesh->getAnimationSpeed() : 0.f);
+	writeBoundingBox(mesh->getBoundingBox());
+
+	if (skinnedMesh)
+	{
+		// write the local buffers and not the ones which might be used for animation from another mesh
+		const core::array<SSkinMeshBuffer*>& buffers = skinnedMesh->getMeshBuffers();
+		Writer.writeWord(buffers.size());
+		for (u32 i=0; i<buffers.size(); ++i)
+			writeMeshBuffer(buffers[i], &buffers[i]->Transformation);
+
+		const core::array<ISkinnedMesh::SJoint*>& joints = skinnedMesh->getAllJoints();
+		Writer.writeWord(joints.size());
+		for (u32 i=0; i<joints.size(); ++i)
+			writeJoint(skinnedMesh, joints[i]);
+	}
+	else
+	{
+		const u32 bufferCount = mesh->getMeshBufferCount();
+		Writer.writeWord(bufferCount);
+		for (u32 i=0; i<bufferCount; ++i)
+			writeMeshBuffer(mesh->getMeshBuffer(i), 0);
+	}
+
+	Writer.finish();
+
+	const core::array<u32>& stringOffsets = Writer.getStringOffsets();
+	const core::array<c8>& stringData = Writer.getStringData();
+	const core::array<u32>& data = Writer.getData();
+
+	SIrrBinaryMeshHeader header;
+	header.Magic = IRRBIN_MESH_MAGIC;
+	header.Version = IRRBIN_MESH_VERSION;
+	header.Flags = 0;
+	header.SourceSize = SourceSize;
+	header.SourceHash = SourceHash;
+	header.StringCount = stringOffsets.size();
+	header.StringDataSize = stringData.size();
+	header.DataSize = data.size();
+	header.PayloadSize = (stringOffsets.size()+data.size())*sizeof(u32) + stringData.size();
+
+	// put the payload together, strings and data are usually much smaller than the vertices
+	core::array<u8> payload;
+	payload.set_used(header.PayloadSize);
+	u8* p = payload.pointer();
+	if (!stringOffsets.empty())
+	{
+		memcpy(p, stringOffsets.const_pointer(), stringOffsets.size()*sizeof(u32));
+		p += stringOffsets.size()*sizeof(u32);
+	}
+	if (!stringData.empty())
+	{
+		memcpy(p, stringData.const_pointer(), stringData.size());
+		p += stringData.size();
+	}
+	if (!data.empty())
+		memcpy(p, data.const_pointer(), data.size()*sizeof(u32));
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	if (flags & EMWF_WRITE_COMPRESSED)
+	{
+		uLongf compressedSize = compressBound(header.PayloadSize);
+		core::array<u8> compressed;
+		compressed.set_used((u32)compressedSize);
+		if (compress2(compressed.pointer(), &compressedSize, payload.const_pointer(), header.PayloadSize, Z_BEST_SPEED) == Z_OK)
+		{
+			compressed.set_used((u32)compressedSize);
+			payload.swap(compressed);
+			header.Flags |= IRRBIN_FLAG_COMPRESSED;
+			header.PayloadSize = payload.size();
+		}
+		else
+			os::Printer::log("Could not compress mesh, writing it uncompressed", file->getFileName(), ELL_WARNING);
+	}
+#else
+	if (flags & EMWF_WRITE_COMPRESSED)
+		os::Printer::log("Compressed .irrbin files need zlib, writing it uncompressed", file->getFileName(), ELL_WARNING);
+#endif
+
+#ifdef __BIG_ENDIAN__
+	u32* headerWords = reinterpret_cast<u32*>(&header);
+	for (u32 i=0; i<sizeof(header)/sizeof(u32); ++i)
+		headerWords[i] = os::Byteswap::byteswap(headerWords[i]);
+#endif
+
+	const u32 payloadSize = payload.size();
+	size_t written = file->write(&header, sizeof(header));
+	if (payloadSize)
+		written += file->write(payload.const_pointer(), payloadSize);
+
+	Writer.clear();
+
+	if (written != sizeof(header) + payloadSize)
+	{
+		os::Printer::log("Could not write mesh file", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	return true;
+}
+
+
+void CIrrBinaryMeshWriter::writeBoundingBox(const core::aabbox3df& box)
+{
+	Writer.writeFloat(box.MinEdge.X);
+	Writer.writeFloat(box.MinEdge.Y);
+	Writer.writeFloat(box.MinEdge.Z);
+	Writer.writeFloat(box.MaxEdge.X);
+	Writer.writeFloat(box.MaxEdge.Y);
+	Writer.writeFloat(box.MaxEdge.Z);
+}
+
+
+void CIrrBinaryMeshWriter::writeMatrix(const core::matrix4& matrix)
+{
+	Writer.writeWords(matrix.pointer(), 16);
+}
+
+
+void CIrrBinaryMeshWriter::writeMeshBuffer(const IMeshBuffer* buffer, const core::matrix4* transformation)
+{
+	// material
+	if (VideoDriver)
+	{
+		io::IAttributes* attributes = VideoDriver->createAttributesFromMaterial(buffer->getMaterial());
+		Writer.writeAttributes(attributes);
+		attributes->drop();
+	}
+	else
+		Writer.writeWord(0);
+
+	const video::E_VERTEX_TYPE vertexType = buffer->getVertexType();
+	const video::E_INDEX_TYPE indexType = buffer->getIndexType();
+	const u32 vertexCount = buffer->getVertexCount();
+	const u32 indexCount = buffer->getIndexCount();
+
+	Writer.writeWord(vertexType);
+	Writer.writeWord(indexType);
+	Writer.writeWord(buffer->getPrimitiveType());
+	Writer.writeWord(buffer->getHardwareMappingHint_Vertex());
+	Writer.writeWord(buffer->getHardwareMappingHint_Index());
+	Writer.writeWord(vertexCount);
+	Writer.writeWord(indexCount);
+	writeBoundingBox(buffer->getBoundingBox());
+
+	if (transformation)
+		writeMatrix(*transformation);
+
+	// all vertex types consist of 32 bit values only
+	Writer.writeWords(buffer->getVertices(), vertexCount*video::getVertexPitchFromType(vertexType)/sizeof(u32));
+
+	if (indexType == video::EIT_32BIT)
+		Writer.writeWords(buffer->getIndices(), indexCount);
+	else
+		Writer.writeShorts(buffer->getIndices(), indexCount);
+}
+
+
+void CIrrBinaryMeshWriter::writeJoint(const ISkinnedMesh* mesh, const ISkinnedMesh::SJoint* joint)
+{
+	Writer.writeWord(Writer.addString(joint->Name.c_str()));
+	writeMatrix(joint->LocalMatrix);
+	writeMatrix(joint->GlobalInversedMatrix);
+	writeMatrix(joint->OffsetMatrix);
+
+	const core::array<ISkinnedMesh::SJoint*>& joints = mesh->getAllJoints();
+	Writer.writeWord(joint->Children.size());
+	for (u32 i=0; i<joint->Children.size(); ++i)
+		Writer.writeWord((u32)joints.linear_search(joint->Children[i]));
+
+	Writer.writeWord(joint->AttachedMeshes.size());
+	Writer.writeWords(joint->AttachedMeshes.const_pointer(), joint->AttachedMeshes.size());
+
+	// keys are plain floats, see layout in SIrrBinaryMeshStructs.h
+	Writer.writeWord(joint->PositionKeys.size());
+	Writer.writeWords(joint->PositionKeys.const_pointer(), joint->PositionKeys.size()*4);
+	Writer.writeWord(joint->ScaleKeys.size());
+	Writer.writeWords(joint->ScaleKeys.const_pointer(), joint->ScaleKeys.size()*4);
+	Writer.writeWord(joint->RotationKeys.size());
+	Writer.writeWords(joint->RotationKeys.const_pointer(), joint->RotationKeys.size()*5);
+
+	// weights also contain internal members, so they are written one by one
+	Writer.writeWord(joint->Weights.size());
+	for (u32 i=0; i<joint->Weights.size(); ++i)
+	{
+		const ISkinnedMesh::SWeight& weight = joint->Weights[i];
+		Writer.writeWord(weight.buffer_id);
+		Writer.writeWord(weight.vertex_id);
+		Writer.writeFloat(weight.strength);
+	}
+}
+
+
+} // end namespace
+} // end namespace
+
+#endif // _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
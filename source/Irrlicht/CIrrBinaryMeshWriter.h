@@ -0,0 +1,59 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_IRR_BINARY_MESH_WRITER_H_INCLUDED__
+#define __IRR_IRR_BINARY_MESH_WRITER_H_INCLUDED__
+
+#include "IMeshWriter.h"
+#include "ISkinnedMesh.h"
+#include "IVideoDriver.h"
+#include "CIrrBinaryAttributes.h"
+
+namespace irr
+{
+namespace scene
+{
+	class IMeshBuffer;
+
+	//! class to write meshes into the binary .irrbin format, see SIrrBinaryMeshStructs.h
+	/** Stores static and skinned meshes with vertices, indices, joints, weights and
+	keys as they are laid out in memory, so loading them is mostly copying memory.
+	Pass EMWF_WRITE_COMPRESSED to compress the file with zlib. */
+	class CIrrBinaryMeshWriter : public IMeshWriter
+	{
+	public:
+
+		CIrrBinaryMeshWriter(video::IVideoDriver* driver);
+		virtual ~CIrrBinaryMeshWriter();
+
+		//! Returns the type of the mesh writer
+		virtual EMESH_WRITER_TYPE getType() const _IRR_OVERRIDE_;
+
+		//! writes a mesh
+		virtual bool writeMesh(io::IWriteFile* file, scene::IMesh* mesh, s32 flags=EMWF_NONE) _IRR_OVERRIDE_;
+
+		//! Set size and content hash of the file the mesh was loaded from, stored in the header for cache validation
+		void setSource(u32 size, u32 hash)
+		{
+			SourceSize = size;
+			SourceHash = hash;
+		}
+
+	protected:
+
+		void writeBoundingBox(const core::aabbox3df& box);
+		void writeMatrix(const core::matrix4& matrix);
+		void writeMeshBuffer(const IMeshBuffer* buffer, const core::matrix4* transformation);
+		void writeJoint(const ISkinnedMesh* mesh, const ISkinnedMesh::SJoint* joint);
+
+		video::IVideoDriver* VideoDriver;
+		io::CIrrBinaryWriter Writer;
+		u32 SourceSize;
+		u32 SourceHash;
+	};
+
+} // end namespace
+} // end namespace
+
+#endif
@@ -29,6 +29,28 @@ void CMeshCache::addMesh(const io::path& filename, IAnimatedMesh* mesh)
 	e.Mesh = mesh;
 
 	Meshes.push_back(e);
+	MeshIndex.insert(e.NamedPath.getInternalName(), mesh);
+}
+
+
+void CMeshCache::removeFromIndex(u32 index)
+{
+	const io::path& name = Meshes[index].NamedPath.getInternalName();
+	IAnimatedMesh** indexed = MeshIndex.find(name);
+	if (!indexed || *indexed != Meshes[index].Mesh)
+		return;
+
+	MeshIndex.remove(name);
+
+	// another mesh with the same name takes its place
+	for (u32 i=0; i<Meshes.size(); ++i)
+	{
+		if (i != index && Meshes[i].NamedPath.getInternalName() == name)
+		{
+			MeshIndex.insert(name, Meshes[i].Mesh);
+			break;
+		}
+	}
 }
 
 
@@ -41,6 +63,7 @@ void CMeshCache::removeMesh(const IMesh* const mesh)
 	{
 		if (Meshes[i].Mesh == mesh || (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh))
 		{
+			removeFromIndex(i);
 			Meshes[i].Mesh->drop();
 			Meshes.erase(i);
 			return;
@@ -82,9 +105,8 @@ IAnimatedMesh* CMeshCache::getMeshByIndex(u32 number)
 //! Returns a mesh based on its name.
 IAnimatedMesh* CMeshCache::getMeshByName(const io::path& name)
 {
-	MeshEntry e ( name );
-	s32 id = Meshes.binary_search(e);
-	return (id != -1) ? Meshes[id].Mesh : 0;
+	IAnimatedMesh** mesh = MeshIndex.find(io::SNamedPath(name).getInternalName());
+	return mesh ? *mesh : 0;
 }
 
 
@@ -119,8 +141,9 @@ bool CMeshCache::renameMesh(u32 index, const io::path& name)
 	if (index >= Meshes.size())
 		return false;
 
+	removeFromIndex(index);
 	Meshes[index].NamedPath.setPath(name);
-	Meshes.sort();
+	MeshIndex.insert(Meshes[index].NamedPath.getInternalName(), Meshes[index].Mesh);
 	return true;
 }
 
@@ -132,9 +155,7 @@ bool CMeshCache::renameMesh(const IMesh* const mesh, const io::path& name)
 	{
 		if (Meshes[i].Mesh == mesh || (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh))
 		{
-			Meshes[i].NamedPath.setPath(name);
-			Meshes.sort();
-			return true;
+			return renameMesh(i, name);
 		}
 	}
 
@@ -156,6 +177,7 @@ void CMeshCache::clear()
 		Meshes[i].Mesh->drop();
 
 	Meshes.clear();
+	MeshIndex.clear();
 }
 
 //! Clears all meshes that are held in the mesh cache but not used anywhere else.
@@ -165,6 +187,7 @@ void CMeshCache::clearUnusedMeshes()
 	{
 		if (Meshes[i].Mesh->getReferenceCount() == 1)
 		{
+			removeFromIndex(i);
 			Meshes[i].Mesh->drop();
 			Meshes.erase(i);
 			--i;
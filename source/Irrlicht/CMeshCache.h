@@ -7,6 +7,7 @@
 
 #include "IMeshCache.h"
 #include "irrArray.h"
+#include "irrHashMap.h"
 
 namespace irr
 {
@@ -111,8 +112,14 @@ namespace scene
 			}
 		};
 
+		//! removes a mesh from MeshIndex, before it is erased from Meshes
+		void removeFromIndex(u32 index);
+
 		//! loaded meshes
 		core::array<MeshEntry> Meshes;
+
+		//! meshes by their internal name
+		core::hash_map<io::path, IAnimatedMesh*> MeshIndex;
 	};
 
 
@@ -761,186 +761,215 @@ IMesh* CMeshManipulator::createMeshUniquePrimitives(IMesh* mesh) const
 }
 
 
-//! Creates a copy of a mesh, which will have identical vertices welded together
-// not yet 32bit
-IMesh* CMeshManipulator::createMeshWelded(IMesh *mesh, f32 tolerance) const
+namespace
 {
-	SMesh* clone = new SMesh();
-	clone->BoundingBox = mesh->getBoundingBox();
 
-	core::array<u16> redirects;
+// vertices are welded when all their attributes are equal within the tolerance
+inline bool isWeldable(const video::S3DVertex& a, const video::S3DVertex& b, f32 tolerance)
+{
+	return a.Pos.equals(b.Pos, tolerance) &&
+		a.Normal.equals(b.Normal, tolerance) &&
+		a.TCoords.equals(b.TCoords) &&
+		(a.Color == b.Color);
+}
 
-	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
-	{
-		const IMeshBuffer* const mb = mesh->getMeshBuffer(b);
-		// reset redirect list
-		redirects.set_used(mb->getVertexCount());
+inline bool isWeldable(const video::S3DVertex2TCoords& a, const video::S3DVertex2TCoords& b, f32 tolerance)
+{
+	return isWeldable((const video::S3DVertex&)a, (const video::S3DVertex&)b, tolerance) &&
+		a.TCoords2.equals(b.TCoords2);
+}
 
-		const u16* indices = 0;
-		u32 indexCount = 0;
-		core::array<u16>* outIdx = 0;
+inline bool isWeldable(const video::S3DVertexTangents& a, const video::S3DVertexTangents& b, f32 tolerance)
+{
+	return isWeldable((const video::S3DVertex&)a, (const video::S3DVertex&)b, tolerance) &&
+		a.Tangent.equals(b.Tangent, tolerance) &&
+		a.Binormal.equals(b.Binormal, tolerance);
+}
 
-		switch(mb->getVertexType())
-		{
-		case video::EVT_STANDARD:
-		{
-			SMeshBuffer* buffer = new SMeshBuffer();
-			buffer->BoundingBox = mb->getBoundingBox();
-			buffer->Material = mb->getMaterial();
-			clone->addMeshBuffer(buffer);
-			buffer->drop();
+// cell of a coordinate in the spatial hash
+inline s64 getWeldCell(f64 value, f64 invCellSize)
+{
+	return (s64)core::clamp(floor(value*invCellSize), -1e18, 1e18);
+}
 
-			video::S3DVertex* v =
-					(video::S3DVertex*)mb->getVertices();
+// multiplied unsigned, as signed overflow is undefined for large cells
+inline u32 getWeldHash(s64 x, s64 y, s64 z)
+{
+	return (u32)((u64)x*73856093u) ^ (u32)((u64)y*19349663u) ^ (u32)((u64)z*83492791u);
+}
+
+//! Welds vertices with a spatial hash of the positions
+/** A vertex is redirected to the first kept vertex it can be welded with,
+otherwise it is kept. Welded positions are at most the tolerance apart,
+so with cells of four times the tolerance only up to two cells per axis
+have to be searched, leaving room for rounding errors. */
+template <class T>
+void weldVertices(const T* v, u32 vertexCount, f32 tolerance,
+		core::array<T>& out, core::array<u16>& redirects)
+{
+	redirects.set_used(vertexCount);
+	out.reallocate(vertexCount);
 
-			u32 vertexCount = mb->getVertexCount();
+	const f64 range = 2.0*tolerance;
+	const f64 invCellSize = 1.0 / core::max_(2.0*range, (f64)core::ROUNDING_ERROR_f32);
 
-			indices = mb->getIndices();
-			indexCount = mb->getIndexCount();
-			outIdx = &buffer->Indices;
+	u32 bucketCount = 1;
+	while (bucketCount < vertexCount*2)
+		bucketCount <<= 1;
+	const u32 mask = bucketCount-1;
 
-			buffer->Vertices.reallocate(vertexCount);
+	core::array<s32> buckets;
+	buckets.set_used(bucketCount);
+	for (u32 i=0; i<bucketCount; ++i)
+		buckets[i] = -1;
 
-			for (u32 i=0; i < vertexCount; ++i)
+	// chains of kept vertices in the same bucket
+	core::array<s32> next;
+	next.set_used(vertexCount);
+
+	for (u32 i=0; i < vertexCount; ++i)
+	{
+		const core::vector3df& pos = v[i].Pos;
+		const s64 x0 = getWeldCell(pos.X-range, invCellSize);
+		const s64 x1 = getWeldCell(pos.X+range, invCellSize);
+		const s64 y0 = getWeldCell(pos.Y-range, invCellSize);
+		const s64 y1 = getWeldCell(pos.Y+range, invCellSize);
+		const s64 z0 = getWeldCell(pos.Z-range, invCellSize);
+		const s64 z1 = getWeldCell(pos.Z+range, invCellSize);
+
+		s32 found = -1;
+		for (s64 x=x0; x<=x1; ++x)
+		{
+			for (s64 y=y0; y<=y1; ++y)
 			{
-				bool found = false;
-				for (u32 j=0; j < i; ++j)
+				for (s64 z=z0; z<=z1; ++z)
 				{
-					if ( v[i].Pos.equals( v[j].Pos, tolerance) &&
-						 v[i].Normal.equals( v[j].Normal, tolerance) &&
-						 v[i].TCoords.equals( v[j].TCoords ) &&
-						(v[i].Color == v[j].Color) )
+					for (s32 k=buckets[getWeldHash(x,y,z) & mask]; k!=-1; k=next[k])
 					{
-						redirects[i] = redirects[j];
-						found = true;
-						break;
+						if ((found == -1 || redirects[k] < redirects[found]) &&
+							isWeldable(v[i], v[k], tolerance))
+							found = k;
 					}
 				}
-				if (!found)
-				{
-					redirects[i] = buffer->Vertices.size();
-					buffer->Vertices.push_back(v[i]);
-				}
 			}
-
-			break;
 		}
-		case video::EVT_2TCOORDS:
+
+		if (found != -1)
+			redirects[i] = redirects[found];
+		else
 		{
-			SMeshBufferLightMap* buffer = new SMeshBufferLightMap();
-			buffer->BoundingBox = mb->getBoundingBox();
-			buffer->Material = mb->getMaterial();
-			clone->addMeshBuffer(buffer);
-			buffer->drop();
+			redirects[i] = out.size();
+			out.push_back(v[i]);
 
-			video::S3DVertex2TCoords* v =
-					(video::S3DVertex2TCoords*)mb->getVertices();
+			const u32 bucket = getWeldHash(getWeldCell(pos.X, invCellSize),
+				getWeldCell(pos.Y, invCellSize), getWeldCell(pos.Z, invCellSize)) & mask;
+			next[i] = buckets[bucket];
+			buckets[bucket] = i;
+		}
+	}
+}
 
-			u32 vertexCount = mb->getVertexCount();
+template <class T>
+void weldMeshBuffer(const IMeshBuffer* mb, CMeshBuffer<T>* buffer, f32 tolerance)
+{
+	core::array<u16> redirects;
+	weldVertices((const T*)mb->getVertices(), mb->getVertexCount(), tolerance,
+		buffer->Vertices, redirects);
+
+	// Clean up any degenerate tris
+	const u16* indices = mb->getIndices();
+	const u32 indexCount = mb->getIndexCount();
+	core::array<u16>& Indices = buffer->Indices;
+	Indices.reallocate(indexCount);
+	for (u32 i = 0; i < indexCount; i+=3)
+	{
+		u16 a, b, c;
+		a = redirects[indices[i]];
+		b = redirects[indices[i+1]];
+		c = redirects[indices[i+2]];
 
-			indices = mb->getIndices();
-			indexCount = mb->getIndexCount();
-			outIdx = &buffer->Indices;
+		bool drop = false;
 
-			buffer->Vertices.reallocate(vertexCount);
+		if (a == b || b == c || a == c)
+			drop = true;
 
-			for (u32 i=0; i < vertexCount; ++i)
-			{
-				bool found = false;
-				for (u32 j=0; j < i; ++j)
-				{
-					if ( v[i].Pos.equals( v[j].Pos, tolerance) &&
-						 v[i].Normal.equals( v[j].Normal, tolerance) &&
-						 v[i].TCoords.equals( v[j].TCoords ) &&
-						 v[i].TCoords2.equals( v[j].TCoords2 ) &&
-						(v[i].Color == v[j].Color) )
-					{
-						redirects[i] = redirects[j];
-						found = true;
-						break;
-					}
-				}
-				if (!found)
-				{
-					redirects[i] = buffer->Vertices.size();
-					buffer->Vertices.push_back(v[i]);
-				}
-			}
-			break;
-		}
-		case video::EVT_TANGENTS:
+		// Open for other checks
+
+		if (!drop)
 		{
-			SMeshBufferTangents* buffer = new SMeshBufferTangents();
-			buffer->BoundingBox = mb->getBoundingBox();
-			buffer->Material = mb->getMaterial();
-			clone->addMeshBuffer(buffer);
-			buffer->drop();
+			Indices.push_back(a);
+			Indices.push_back(b);
+			Indices.push_back(c);
+		}
+	}
+}
 
-			video::S3DVertexTangents* v =
-					(video::S3DVertexTangents*)mb->getVertices();
+} // end anonymous namespace
 
-			u32 vertexCount = mb->getVertexCount();
+//! Creates a copy of a mesh, which will have identical vertices welded together
+// not yet 32bit
+IMesh* CMeshManipulator::createMeshWelded(IMesh *mesh, f32 tolerance) const
+{
+	SMesh* clone = new SMesh();
+	clone->BoundingBox = mesh->getBoundingBox();
 
-			indices = mb->getIndices();
-			indexCount = mb->getIndexCount();
-			outIdx = &buffer->Indices;
+	const u32 bufcnt = mesh->getMeshBufferCount();
 
-			buffer->Vertices.reallocate(vertexCount);
+	// create the buffers first, so they keep their order when they
+	// are welded in parallel
+	core::array<IMeshBuffer*> buffers(bufcnt);
+	for (u32 b=0; b<bufcnt; ++b)
+	{
+		const IMeshBuffer* const mb = mesh->getMeshBuffer(b);
 
-			for (u32 i=0; i < vertexCount; ++i)
-			{
-				bool found = false;
-				for (u32 j=0; j < i; ++j)
-				{
-					if ( v[i].Pos.equals( v[j].Pos, tolerance) &&
-						 v[i].Normal.equals( v[j].Normal, tolerance) &&
-						 v[i].TCoords.equals( v[j].TCoords ) &&
-						 v[i].Tangent.equals( v[j].Tangent, tolerance ) &&
-						 v[i].Binormal.equals( v[j].Binormal, tolerance ) &&
-						(v[i].Color == v[j].Color) )
-					{
-						redirects[i] = redirects[j];
-						found = true;
-						break;
-					}
-				}
-				if (!found)
-				{
-					redirects[i] = buffer->Vertices.size();
-					buffer->Vertices.push_back(v[i]);
-				}
-			}
+		IMeshBuffer* buffer = 0;
+		switch(mb->getVertexType())
+		{
+		case video::EVT_STANDARD:
+			buffer = new SMeshBuffer();
+			break;
+		case video::EVT_2TCOORDS:
+			buffer = new SMeshBufferLightMap();
+			break;
+		case video::EVT_TANGENTS:
+			buffer = new SMeshBufferTangents();
 			break;
-		}
 		default:
 			os::Printer::log("Cannot create welded mesh, vertex type unsupported", ELL_ERROR);
 			break;
 		}
 
-		// Clean up any degenerate tris
- 		core::array<u16> &Indices = *outIdx;
-		Indices.clear();
-		Indices.reallocate(indexCount);
-		for (u32 i = 0; i < indexCount; i+=3)
- 		{
-			u16 a, b, c;
-			a = redirects[indices[i]];
-			b = redirects[indices[i+1]];
-			c = redirects[indices[i+2]];
-
-			bool drop = false;
-
-			if (a == b || b == c || a == c)
-				drop = true;
+		if (buffer)
+		{
+			buffer->setBoundingBox(mb->getBoundingBox());
+			buffer->getMaterial() = mb->getMaterial();
+			clone->addMeshBuffer(buffer);
+			buffer->drop();
+		}
+		buffers.push_back(buffer);
+	}
 
-			// Open for other checks
+	const s32 count = (s32)bufcnt;
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) if (count > 1)
+#endif
+	for (s32 b=0; b<count; ++b)
+	{
+		const IMeshBuffer* const mb = mesh->getMeshBuffer(b);
 
-			if (!drop)
-			{
-				Indices.push_back(a);
-				Indices.push_back(b);
-				Indices.push_back(c);
-			}
+		switch(mb->getVertexType())
+		{
+		case video::EVT_STANDARD:
+			weldMeshBuffer(mb, static_cast<SMeshBuffer*>(buffers[b]), tolerance);
+			break;
+		case video::EVT_2TCOORDS:
+			weldMeshBuffer(mb, static_cast<SMeshBufferLightMap*>(buffers[b]), tolerance);
+			break;
+		case video::EVT_TANGENTS:
+			weldMeshBuffer(mb, static_cast<SMeshBufferTangents*>(buffers[b]), tolerance);
+			break;
+		default:
+			break;
 		}
 	}
 	return clone;
@@ -1680,439 +1709,445 @@ private:
 	tcache *tc;
 };
 
-} // end anonymous namespace
-
-/**
-Vertex cache optimization according to the Forsyth paper:
-http://home.comcast.net/~tom_forsyth/papers/fast_vert_cache_opt.html
-
-The function is thread-safe (read: you can optimize several meshes in different threads)
-
-\param mesh Source mesh for the operation.  */
-IMesh* CMeshManipulator::createForsythOptimizedMesh(const IMesh *mesh) const
+//! Optimizes a single meshbuffer for the vertex cache
+template <class T>
+IMeshBuffer* createForsythOptimizedBuffer(const IMeshBuffer* mb)
 {
-	if (!mesh)
-		return 0;
+	const u32 icount = mb->getIndexCount();
+	const u32 tcount = icount / 3;
+	const u32 vcount = mb->getVertexCount();
+	const u16 *ind = mb->getIndices();
 
-	SMesh *newmesh = new SMesh();
-	newmesh->BoundingBox = mesh->getBoundingBox();
+	vcache *vc = new vcache[vcount];
+	tcache *tc = new tcache[tcount];
 
-	const u32 mbcount = mesh->getMeshBufferCount();
+	f_lru lru(vc, tc);
 
-	for (u32 b = 0; b < mbcount; ++b)
+	// init
+	for (u32 i = 0; i < vcount; i++)
 	{
-		const IMeshBuffer *mb = mesh->getMeshBuffer(b);
+		vc[i].score = 0;
+		vc[i].cachepos = -1;
+		vc[i].NumActiveTris = 0;
+	}
 
-		if (mb->getIndexType() != video::EIT_16BIT)
-		{
-			os::Printer::log("Cannot optimize a mesh with 32bit indices", ELL_ERROR);
-			newmesh->drop();
-			return 0;
-		}
+	// First pass: count how many times a vert is used
+	for (u32 i = 0; i < icount; i += 3)
+	{
+		vc[ind[i]].NumActiveTris++;
+		vc[ind[i + 1]].NumActiveTris++;
+		vc[ind[i + 2]].NumActiveTris++;
+
+		const u32 tri_ind = i/3;
+		tc[tri_ind].ind[0] = ind[i];
+		tc[tri_ind].ind[1] = ind[i + 1];
+		tc[tri_ind].ind[2] = ind[i + 2];
+	}
 
-		const u32 icount = mb->getIndexCount();
-		const u32 tcount = icount / 3;
-		const u32 vcount = mb->getVertexCount();
-		const u16 *ind = mb->getIndices();
+	// Second pass: list of each triangle
+	for (u32 i = 0; i < tcount; i++)
+	{
+		vc[tc[i].ind[0]].tris.push_back(i);
+		vc[tc[i].ind[1]].tris.push_back(i);
+		vc[tc[i].ind[2]].tris.push_back(i);
 
-		vcache *vc = new vcache[vcount];
-		tcache *tc = new tcache[tcount];
+		tc[i].drawn = false;
+	}
 
-		f_lru lru(vc, tc);
+	// Give initial scores
+	for (u32 i = 0; i < vcount; i++)
+	{
+		vc[i].score = FindVertexScore(&vc[i]);
+	}
+	for (u32 i = 0; i < tcount; i++)
+	{
+		tc[i].score =
+				vc[tc[i].ind[0]].score +
+				vc[tc[i].ind[1]].score +
+				vc[tc[i].ind[2]].score;
+	}
 
-		// init
-		for (u16 i = 0; i < vcount; i++)
-		{
-			vc[i].score = 0;
-			vc[i].cachepos = -1;
-			vc[i].NumActiveTris = 0;
-		}
+	const T *v = (const T *) mb->getVertices();
 
-		// First pass: count how many times a vert is used
-		for (u32 i = 0; i < icount; i += 3)
-		{
-			vc[ind[i]].NumActiveTris++;
-			vc[ind[i + 1]].NumActiveTris++;
-			vc[ind[i + 2]].NumActiveTris++;
-
-			const u32 tri_ind = i/3;
-			tc[tri_ind].ind[0] = ind[i];
-			tc[tri_ind].ind[1] = ind[i + 1];
-			tc[tri_ind].ind[2] = ind[i + 2];
-		}
+	CMeshBuffer<T> *buf = new CMeshBuffer<T>();
+	buf->Material = mb->getMaterial();
 
-		// Second pass: list of each triangle
-		for (u32 i = 0; i < tcount; i++)
-		{
-			vc[tc[i].ind[0]].tris.push_back(i);
-			vc[tc[i].ind[1]].tris.push_back(i);
-			vc[tc[i].ind[2]].tris.push_back(i);
+	buf->Vertices.reallocate(vcount);
+	buf->Indices.reallocate(icount);
 
-			tc[i].drawn = false;
-		}
+	// new index of each source vertex, so equal vertices are only
+	// searched once
+	core::array<u32> remap;
+	remap.set_used(vcount);
+	for (u32 i = 0; i < vcount; i++)
+		remap[i] = 0xffffffff;
 
-		// Give initial scores
-		for (u16 i = 0; i < vcount; i++)
-		{
-			vc[i].score = FindVertexScore(&vc[i]);
-		}
-		for (u32 i = 0; i < tcount; i++)
-		{
-			tc[i].score =
-					vc[tc[i].ind[0]].score +
-					vc[tc[i].ind[1]].score +
-					vc[tc[i].ind[2]].score;
-		}
+	// search index for fast operation, the pool avoids a heap allocation per vertex
+	typedef core::map<const T, const u16, core::irrAllocatorPool> smap;
+	smap sind;
+	typedef typename smap::Node snode;
 
-		switch(mb->getVertexType())
+	// Main algorithm
+	u32 highest = 0;
+	u32 drawcalls = 0;
+	for (;;)
+	{
+		if (tc[highest].drawn)
 		{
-			case video::EVT_STANDARD:
+			bool found = false;
+			float hiscore = 0;
+			for (u32 t = 0; t < tcount; t++)
 			{
-				video::S3DVertex *v = (video::S3DVertex *) mb->getVertices();
-
-				SMeshBuffer *buf = new SMeshBuffer();
-				buf->Material = mb->getMaterial();
-
-				buf->Vertices.reallocate(vcount);
-				buf->Indices.reallocate(icount);
-
-				core::map<const video::S3DVertex, const u16> sind; // search index for fast operation
-				typedef core::map<const video::S3DVertex, const u16>::Node snode;
-
-				// Main algorithm
-				u32 highest = 0;
-				u32 drawcalls = 0;
-				for (;;)
+				if (!tc[t].drawn)
 				{
-					if (tc[highest].drawn)
+					if (tc[t].score > hiscore)
 					{
-						bool found = false;
-						float hiscore = 0;
-						for (u32 t = 0; t < tcount; t++)
-						{
-							if (!tc[t].drawn)
-							{
-								if (tc[t].score > hiscore)
-								{
-									highest = t;
-									hiscore = tc[t].score;
-									found = true;
-								}
-							}
-						}
-						if (!found)
-							break;
+						highest = t;
+						hiscore = tc[t].score;
+						found = true;
 					}
+				}
+			}
+			if (!found)
+				break;
+		}
 
-					// Output the best triangle
-					u16 newind = buf->Vertices.size();
+		// Output the best triangle
+		for (u32 j = 0; j < 3; j++)
+		{
+			const u16 old = tc[highest].ind[j];
+			if (remap[old] == 0xffffffff)
+			{
+				snode *s = sind.find(v[old]);
 
-					snode *s = sind.find(v[tc[highest].ind[0]]);
+				if (!s)
+				{
+					const u16 newind = buf->Vertices.size();
+					buf->Vertices.push_back(v[old]);
+					sind.insert(v[old], newind);
+					remap[old] = newind;
+				}
+				else
+				{
+					remap[old] = s->getValue();
+				}
+			}
+			buf->Indices.push_back((u16)remap[old]);
+		}
 
-					if (!s)
-					{
-						buf->Vertices.push_back(v[tc[highest].ind[0]]);
-						buf->Indices.push_back(newind);
-						sind.insert(v[tc[highest].ind[0]], newind);
-						newind++;
-					}
-					else
-					{
-						buf->Indices.push_back(s->getValue());
-					}
+		vc[tc[highest].ind[0]].NumActiveTris--;
+		vc[tc[highest].ind[1]].NumActiveTris--;
+		vc[tc[highest].ind[2]].NumActiveTris--;
 
-					s = sind.find(v[tc[highest].ind[1]]);
+		tc[highest].drawn = true;
 
-					if (!s)
-					{
-						buf->Vertices.push_back(v[tc[highest].ind[1]]);
-						buf->Indices.push_back(newind);
-						sind.insert(v[tc[highest].ind[1]], newind);
-						newind++;
-					}
-					else
-					{
-						buf->Indices.push_back(s->getValue());
-					}
+		for (u16 j = 0; j < 3; j++)
+		{
+			vcache *vert = &vc[tc[highest].ind[j]];
+			for (u32 t = 0; t < vert->tris.size(); t++)
+			{
+				if (highest == vert->tris[t])
+				{
+					vert->tris.erase(t);
+					break;
+				}
+			}
+		}
 
-					s = sind.find(v[tc[highest].ind[2]]);
+		lru.add(tc[highest].ind[0]);
+		lru.add(tc[highest].ind[1]);
+		highest = lru.add(tc[highest].ind[2], true);
+		drawcalls++;
+	}
 
-					if (!s)
-					{
-						buf->Vertices.push_back(v[tc[highest].ind[2]]);
-						buf->Indices.push_back(newind);
-						sind.insert(v[tc[highest].ind[2]], newind);
-					}
-					else
-					{
-						buf->Indices.push_back(s->getValue());
-					}
+	buf->setBoundingBox(mb->getBoundingBox());
 
-					vc[tc[highest].ind[0]].NumActiveTris--;
-					vc[tc[highest].ind[1]].NumActiveTris--;
-					vc[tc[highest].ind[2]].NumActiveTris--;
+	delete [] vc;
+	delete [] tc;
 
-					tc[highest].drawn = true;
+	return buf;
+}
 
-					for (u16 j = 0; j < 3; j++)
-					{
-						vcache *vert = &vc[tc[highest].ind[j]];
-						for (u16 t = 0; t < vert->tris.size(); t++)
-						{
-							if (highest == vert->tris[t])
-							{
-								vert->tris.erase(t);
-								break;
-							}
-						}
-					}
+} // end anonymous namespace
 
-					lru.add(tc[highest].ind[0]);
-					lru.add(tc[highest].ind[1]);
-					highest = lru.add(tc[highest].ind[2], true);
-					drawcalls++;
-				}
+/**
+Vertex cache optimization according to the Forsyth paper:
+http://home.comcast.net/~tom_forsyth/papers/fast_vert_cache_opt.html
 
-				buf->setBoundingBox(mb->getBoundingBox());
-				newmesh->addMeshBuffer(buf);
-				buf->drop();
-			}
-			break;
-			case video::EVT_2TCOORDS:
-			{
-				video::S3DVertex2TCoords *v = (video::S3DVertex2TCoords *) mb->getVertices();
+The function is thread-safe (read: you can optimize several meshes in different threads)
 
-				SMeshBufferLightMap *buf = new SMeshBufferLightMap();
-				buf->Material = mb->getMaterial();
+\param mesh Source mesh for the operation.  */
+IMesh* CMeshManipulator::createForsythOptimizedMesh(const IMesh *mesh) const
+{
+	if (!mesh)
+		return 0;
 
-				buf->Vertices.reallocate(vcount);
-				buf->Indices.reallocate(icount);
+	const u32 mbcount = mesh->getMeshBufferCount();
 
-				core::map<const video::S3DVertex2TCoords, const u16> sind; // search index for fast operation
-				typedef core::map<const video::S3DVertex2TCoords, const u16>::Node snode;
+	for (u32 b = 0; b < mbcount; ++b)
+	{
+		if (mesh->getMeshBuffer(b)->getIndexType() != video::EIT_16BIT)
+		{
+			os::Printer::log("Cannot optimize a mesh with 32bit indices", ELL_ERROR);
+			return 0;
+		}
+	}
 
-				// Main algorithm
-				u32 highest = 0;
-				u32 drawcalls = 0;
-				for (;;)
-				{
-					if (tc[highest].drawn)
-					{
-						bool found = false;
-						float hiscore = 0;
-						for (u32 t = 0; t < tcount; t++)
-						{
-							if (!tc[t].drawn)
-							{
-								if (tc[t].score > hiscore)
-								{
-									highest = t;
-									hiscore = tc[t].score;
-									found = true;
-								}
-							}
-						}
-						if (!found)
-							break;
-					}
+	// meshbuffers are independent, so they are optimized in parallel
+	core::array<IMeshBuffer*> buffers;
+	buffers.set_used(mbcount);
 
-					// Output the best triangle
-					u16 newind = buf->Vertices.size();
+	const s32 count = (s32)mbcount;
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) if (count > 1)
+#endif
+	for (s32 b = 0; b < count; ++b)
+	{
+		const IMeshBuffer *mb = mesh->getMeshBuffer(b);
 
-					snode *s = sind.find(v[tc[highest].ind[0]]);
+		switch(mb->getVertexType())
+		{
+			case video::EVT_STANDARD:
+				buffers[b] = createForsythOptimizedBuffer<video::S3DVertex>(mb);
+				break;
+			case video::EVT_2TCOORDS:
+				buffers[b] = createForsythOptimizedBuffer<video::S3DVertex2TCoords>(mb);
+				break;
+			case video::EVT_TANGENTS:
+				buffers[b] = createForsythOptimizedBuffer<video::S3DVertexTangents>(mb);
+				break;
+			default:
+				buffers[b] = 0;
+				break;
+		}
+	}
 
-					if (!s)
-					{
-						buf->Vertices.push_back(v[tc[highest].ind[0]]);
-						buf->Indices.push_back(newind);
-						sind.insert(v[tc[highest].ind[0]], newind);
-						newind++;
-					}
-					else
-					{
-						buf->Indices.push_back(s->getValue());
-					}
+	SMesh *newmesh = new SMesh();
+	newmesh->BoundingBox = mesh->getBoundingBox();
 
-					s = sind.find(v[tc[highest].ind[1]]);
+	for (u32 b = 0; b < mbcount; ++b)
+	{
+		if (buffers[b])
+		{
+			newmesh->addMeshBuffer(buffers[b]);
+			buffers[b]->drop();
+		}
+	}
 
-					if (!s)
-					{
-						buf->Vertices.push_back(v[tc[highest].ind[1]]);
-						buf->Indices.push_back(newind);
-						sind.insert(v[tc[highest].ind[1]], newind);
-						newind++;
-					}
-					else
-					{
-						buf->Indices.push_back(s->getValue());
-					}
+	return newmesh;
+}
 
-					s = sind.find(v[tc[highest].ind[2]]);
 
-					if (!s)
-					{
-						buf->Vertices.push_back(v[tc[highest].ind[2]]);
-						buf->Indices.push_back(newind);
-						sind.insert(v[tc[highest].ind[2]], newind);
-					}
-					else
-					{
-						buf->Indices.push_back(s->getValue());
-					}
+namespace
+{
 
-					vc[tc[highest].ind[0]].NumActiveTris--;
-					vc[tc[highest].ind[1]].NumActiveTris--;
-					vc[tc[highest].ind[2]].NumActiveTris--;
+//! run of triangles which is kept together when sorting for overdraw
+struct SFetchCluster
+{
+	u32 Start;
+	u32 Count;
+	f32 Key;
 
-					tc[highest].drawn = true;
+	// outward facing clusters first
+	bool operator<(const SFetchCluster& other) const
+	{
+		return Key > other.Key || (Key == other.Key && Start < other.Start);
+	}
+};
 
-					for (u16 j = 0; j < 3; j++)
-					{
-						vcache *vert = &vc[tc[highest].ind[j]];
-						for (u16 t = 0; t < vert->tris.size(); t++)
-						{
-							if (highest == vert->tris[t])
-							{
-								vert->tris.erase(t);
-								break;
-							}
-						}
-					}
+//! Reorders triangles and vertices of a single meshbuffer
+template <class T>
+IMeshBuffer* createVertexFetchOptimizedBuffer(const IMeshBuffer* mb, bool reduceOverdraw)
+{
+	const u32 icount = mb->getIndexCount() - mb->getIndexCount()%3;
+	const u32 vcount = mb->getVertexCount();
+	const u16* ind = mb->getIndices();
+	const T* v = (const T*)mb->getVertices();
 
-					lru.add(tc[highest].ind[0]);
-					lru.add(tc[highest].ind[1]);
-					highest = lru.add(tc[highest].ind[2]);
-					drawcalls++;
-				}
+	core::array<u16> order;
+	order.reallocate(icount);
 
-				buf->setBoundingBox(mb->getBoundingBox());
-				newmesh->addMeshBuffer(buf);
-				buf->drop();
+	if (reduceOverdraw && icount)
+	{
+		// Split the triangles into clusters where the simulated vertex
+		// cache misses all vertices of a triangle, i.e. where the cache
+		// optimized order jumps to another part of the mesh.
+		const u32 minClusterSize = 16;
+		core::array<u32> cacheTime;
+		cacheTime.set_used(vcount);
+		for (u32 i = 0; i < vcount; ++i)
+			cacheTime[i] = 0;
+		u32 time = cachesize+1;
+
+		core::array<SFetchCluster> clusters;
+		SFetchCluster cluster;
+		cluster.Start = 0;
+		cluster.Count = 0;
+		cluster.Key = 0.f;
 
+		for (u32 i = 0; i < icount; i += 3)
+		{
+			u32 misses = 0;
+			for (u32 j = 0; j < 3; ++j)
+			{
+				if (time - cacheTime[ind[i+j]] > cachesize)
+				{
+					cacheTime[ind[i+j]] = time++;
+					++misses;
+				}
 			}
-			break;
-			case video::EVT_TANGENTS:
+
+			if (misses == 3 && cluster.Count >= minClusterSize)
 			{
-				video::S3DVertexTangents *v = (video::S3DVertexTangents *) mb->getVertices();
+				clusters.push_back(cluster);
+				cluster.Start = i/3;
+				cluster.Count = 0;
+			}
+			++cluster.Count;
+		}
+		clusters.push_back(cluster);
 
-				SMeshBufferTangents *buf = new SMeshBufferTangents();
-				buf->Material = mb->getMaterial();
+		// centroid of the mesh, weighted by triangle area
+		core::vector3df meshCenter;
+		f32 meshArea = 0.f;
+		for (u32 i = 0; i < icount; i += 3)
+		{
+			const core::vector3df& p0 = v[ind[i]].Pos;
+			const core::vector3df& p1 = v[ind[i+1]].Pos;
+			const core::vector3df& p2 = v[ind[i+2]].Pos;
+			const f32 area = (p1-p0).crossProduct(p2-p0).getLength();
+			meshCenter += (p0+p1+p2) * area;
+			meshArea += area;
+		}
+		if (meshArea > 0.f)
+			meshCenter /= meshArea*3.f;
 
-				buf->Vertices.reallocate(vcount);
-				buf->Indices.reallocate(icount);
+		// clusters which face away from the center are likely in front
+		for (u32 c = 0; c < clusters.size(); ++c)
+		{
+			core::vector3df center;
+			core::vector3df normal;
+			f32 area = 0.f;
+			const u32 end = (clusters[c].Start + clusters[c].Count)*3;
+			for (u32 i = clusters[c].Start*3; i < end; i += 3)
+			{
+				const core::vector3df& p0 = v[ind[i]].Pos;
+				const core::vector3df& p1 = v[ind[i+1]].Pos;
+				const core::vector3df& p2 = v[ind[i+2]].Pos;
+				const core::vector3df n = (p1-p0).crossProduct(p2-p0);
+				const f32 a = n.getLength();
+				center += (p0+p1+p2) * a;
+				normal += n;
+				area += a;
+			}
+			if (area > 0.f)
+				center /= area*3.f;
+			normal.normalize();
+			clusters[c].Key = (center-meshCenter).dotProduct(normal);
+		}
 
-				core::map<const video::S3DVertexTangents, const u16> sind; // search index for fast operation
-				typedef core::map<const video::S3DVertexTangents, const u16>::Node snode;
+		clusters.sort();
 
-				// Main algorithm
-				u32 highest = 0;
-				u32 drawcalls = 0;
-				for (;;)
-				{
-					if (tc[highest].drawn)
-					{
-						bool found = false;
-						float hiscore = 0;
-						for (u32 t = 0; t < tcount; t++)
-						{
-							if (!tc[t].drawn)
-							{
-								if (tc[t].score > hiscore)
-								{
-									highest = t;
-									hiscore = tc[t].score;
-									found = true;
-								}
-							}
-						}
-						if (!found)
-							break;
-					}
-
-					// Output the best triangle
-					u16 newind = buf->Vertices.size();
+		for (u32 c = 0; c < clusters.size(); ++c)
+		{
+			const u32 end = (clusters[c].Start + clusters[c].Count)*3;
+			for (u32 i = clusters[c].Start*3; i < end; ++i)
+				order.push_back(ind[i]);
+		}
+	}
+	else
+	{
+		for (u32 i = 0; i < icount; ++i)
+			order.push_back(ind[i]);
+	}
 
-					snode *s = sind.find(v[tc[highest].ind[0]]);
+	CMeshBuffer<T>* buf = new CMeshBuffer<T>();
+	buf->Material = mb->getMaterial();
+	buf->Vertices.reallocate(vcount);
+	buf->Indices.reallocate(icount);
 
-					if (!s)
-					{
-						buf->Vertices.push_back(v[tc[highest].ind[0]]);
-						buf->Indices.push_back(newind);
-						sind.insert(v[tc[highest].ind[0]], newind);
-						newind++;
-					}
-					else
-					{
-						buf->Indices.push_back(s->getValue());
-					}
+	// store vertices in order of first use, drop unused ones
+	core::array<u32> remap;
+	remap.set_used(vcount);
+	for (u32 i = 0; i < vcount; ++i)
+		remap[i] = 0xffffffff;
 
-					s = sind.find(v[tc[highest].ind[1]]);
+	for (u32 i = 0; i < icount; ++i)
+	{
+		const u16 old = order[i];
+		if (remap[old] == 0xffffffff)
+		{
+			remap[old] = buf->Vertices.size();
+			buf->Vertices.push_back(v[old]);
+		}
+		buf->Indices.push_back((u16)remap[old]);
+	}
 
-					if (!s)
-					{
-						buf->Vertices.push_back(v[tc[highest].ind[1]]);
-						buf->Indices.push_back(newind);
-						sind.insert(v[tc[highest].ind[1]], newind);
-						newind++;
-					}
-					else
-					{
-						buf->Indices.push_back(s->getValue());
-					}
+	buf->recalculateBoundingBox();
+	return buf;
+}
 
-					s = sind.find(v[tc[highest].ind[2]]);
+} // end anonymous namespace
 
-					if (!s)
-					{
-						buf->Vertices.push_back(v[tc[highest].ind[2]]);
-						buf->Indices.push_back(newind);
-						sind.insert(v[tc[highest].ind[2]], newind);
-					}
-					else
-					{
-						buf->Indices.push_back(s->getValue());
-					}
+//! Reorders triangles and vertices for faster vertex fetching and less overdraw
+IMesh* CMeshManipulator::createVertexFetchOptimizedMesh(const IMesh* mesh, bool reduceOverdraw) const
+{
+	if (!mesh)
+		return 0;
 
-					vc[tc[highest].ind[0]].NumActiveTris--;
-					vc[tc[highest].ind[1]].NumActiveTris--;
-					vc[tc[highest].ind[2]].NumActiveTris--;
+	const u32 mbcount = mesh->getMeshBufferCount();
 
-					tc[highest].drawn = true;
+	for (u32 b = 0; b < mbcount; ++b)
+	{
+		if (mesh->getMeshBuffer(b)->getIndexType() != video::EIT_16BIT)
+		{
+			os::Printer::log("Cannot optimize a mesh with 32bit indices", ELL_ERROR);
+			return 0;
+		}
+	}
 
-					for (u16 j = 0; j < 3; j++)
-					{
-						vcache *vert = &vc[tc[highest].ind[j]];
-						for (u16 t = 0; t < vert->tris.size(); t++)
-						{
-							if (highest == vert->tris[t])
-							{
-								vert->tris.erase(t);
-								break;
-							}
-						}
-					}
+	core::array<IMeshBuffer*> buffers;
+	buffers.set_used(mbcount);
 
-					lru.add(tc[highest].ind[0]);
-					lru.add(tc[highest].ind[1]);
-					highest = lru.add(tc[highest].ind[2]);
-					drawcalls++;
-				}
+	const s32 count = (s32)mbcount;
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) if (count > 1)
+#endif
+	for (s32 b = 0; b < count; ++b)
+	{
+		const IMeshBuffer *mb = mesh->getMeshBuffer(b);
 
-				buf->setBoundingBox(mb->getBoundingBox());
-				newmesh->addMeshBuffer(buf);
-				buf->drop();
-			}
-			break;
+		switch(mb->getVertexType())
+		{
+			case video::EVT_STANDARD:
+				buffers[b] = createVertexFetchOptimizedBuffer<video::S3DVertex>(mb, reduceOverdraw);
+				break;
+			case video::EVT_2TCOORDS:
+				buffers[b] = createVertexFetchOptimizedBuffer<video::S3DVertex2TCoords>(mb, reduceOverdraw);
+				break;
+			case video::EVT_TANGENTS:
+				buffers[b] = createVertexFetchOptimizedBuffer<video::S3DVertexTangents>(mb, reduceOverdraw);
+				break;
+			default:
+				buffers[b] = 0;
+				break;
 		}
+	}
 
-		delete [] vc;
-		delete [] tc;
+	SMesh *newmesh = new SMesh();
 
-	} // for each meshbuffer
+	for (u32 b = 0; b < mbcount; ++b)
+	{
+		if (buffers[b])
+		{
+			newmesh->addMeshBuffer(buffers[b]);
+			buffers[b]->drop();
+		}
+	}
+	newmesh->recalculateBoundingBox();
 
 	return newmesh;
 }
 
 } // end namespace scene
 } // end namespace irr
-
@@ -87,6 +87,9 @@ public:
 	//! create a mesh optimized for the vertex cache
 	virtual IMesh* createForsythOptimizedMesh(const scene::IMesh *mesh) const _IRR_OVERRIDE_;
 
+	//! create a mesh optimized for vertex fetching and less overdraw
+	virtual IMesh* createVertexFetchOptimizedMesh(const scene::IMesh *mesh, bool reduceOverdraw=true) const _IRR_OVERRIDE_;
+
 	//! Optimizes the mesh using an algorithm tuned for heightmaps
 	virtual void heightmapOptimizeMesh(IMesh * const m, const f32 tolerance = core::ROUNDING_ERROR_f32) const _IRR_OVERRIDE_;
 
@@ -3,12 +3,56 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CMetaTriangleSelector.h"
+#include "ISceneNode.h"
 
 namespace irr
 {
 namespace scene
 {
 
+namespace
+{
+	// Adds the triangles of selectors found in the box tree to the result
+	struct SSelectorQuery
+	{
+		void operator()(s32 proxy, void* userData)
+		{
+			add(static_cast<const ITriangleSelector*>(userData));
+		}
+
+		void add(const ITriangleSelector* selector)
+		{
+			if (Written == ArraySize)
+				return;
+
+			const u32 infoSize = TriangleInfo ? TriangleInfo->size() : 0;
+			s32 t = 0;
+			if (Line)
+				selector->getTriangles(Triangles + Written, ArraySize - Written, t,
+						*Line, Transform, true, TriangleInfo);
+			else
+				selector->getTriangles(Triangles + Written, ArraySize - Written, t,
+						*Box, Transform, true, TriangleInfo);
+
+			if ( TriangleInfo )
+			{
+				for ( u32 ti=infoSize; ti<TriangleInfo->size(); ++ti )
+					(*TriangleInfo)[ti].RangeStart += Written;
+			}
+
+			Written += t;
+		}
+
+		core::triangle3df* Triangles;
+		s32 ArraySize;
+		s32 Written;
+		const core::aabbox3df* Box;
+		const core::line3df* Line;
+		const core::matrix4* Transform;
+		core::array<SCollisionTriangleRange>* TriangleInfo;
+	};
+}
+
 //! constructor
 CMetaTriangleSelector::CMetaTriangleSelector()
 {
@@ -74,6 +118,31 @@ void CMetaTriangleSelector::getTriangles(core::triangle3df* triangles, s32 array
 		const core::matrix4* transform, bool useNodeTransform, 
 		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const
 {
+	if (useNodeTransform)
+	{
+		// only ask the selectors which are close to the box
+		updateBoxes();
+
+		SSelectorQuery query;
+		query.Triangles = triangles;
+		query.ArraySize = arraySize;
+		query.Written = 0;
+		query.Box = &box;
+		query.Line = 0;
+		query.Transform = transform;
+		query.TriangleInfo = outTriangleInfo;
+
+		BoxTree.query(box, query);
+		for (u32 i=0; i<Entries.size(); ++i)
+		{
+			if (Entries[i].Proxy == -1)
+				query.add(TriangleSelectors[i]);
+		}
+
+		outTriangleCount = query.Written;
+		return;
+	}
+
 	s32 outWritten = 0;
 	irr::u32 outTriangleInfoSize = outTriangleInfo ? outTriangleInfo->size() : 0;
 	for (u32 i=0; i<TriangleSelectors.size(); ++i)
@@ -107,6 +176,34 @@ void CMetaTriangleSelector::getTriangles(core::triangle3df* triangles, s32 array
 		const core::matrix4* transform, bool useNodeTransform, 
 		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const
 {
+	if (useNodeTransform)
+	{
+		// only ask the selectors which are close to the line
+		updateBoxes();
+
+		core::aabbox3df box(line.start);
+		box.addInternalPoint(line.end);
+
+		SSelectorQuery query;
+		query.Triangles = triangles;
+		query.ArraySize = arraySize;
+		query.Written = 0;
+		query.Box = &box;
+		query.Line = &line;
+		query.Transform = transform;
+		query.TriangleInfo = outTriangleInfo;
+
+		BoxTree.query(box, query);
+		for (u32 i=0; i<Entries.size(); ++i)
+		{
+			if (Entries[i].Proxy == -1)
+				query.add(TriangleSelectors[i]);
+		}
+
+		outTriangleCount = query.Written;
+		return;
+	}
+
 	s32 outWritten = 0;
 	irr::u32 outTriangleInfoSize = outTriangleInfo ? outTriangleInfo->size() : 0;
 	for (u32 i=0; i<TriangleSelectors.size(); ++i)
@@ -143,6 +240,32 @@ void CMetaTriangleSelector::addTriangleSelector(ITriangleSelector* toAdd)
 
 	TriangleSelectors.push_back(toAdd);
 	toAdd->grab();
+
+	SSelectorEntry entry;
+	entry.Node = toAdd->getSceneNodeForTriangle(0);
+	entry.TransformVersion = 0;
+	entry.Proxy = -1;
+
+	// meta selectors have several nodes and animated triangles change with
+	// the frame, triangles of static meshes and terrains only move with the node
+	entry.AlwaysUpdate = toAdd->getSelectorCount() != 1 || toAdd->getSelector(0) != toAdd;
+	if (entry.Node && !entry.AlwaysUpdate)
+	{
+		switch (entry.Node->getType())
+		{
+		case ESNT_MESH:
+		case ESNT_OCTREE:
+		case ESNT_CUBE:
+		case ESNT_SPHERE:
+		case ESNT_TERRAIN:
+			break;
+		default:
+			entry.AlwaysUpdate = true;
+		}
+	}
+
+	Entries.push_back(entry);
+	updateBox(Entries.size()-1);
 }
 
 
@@ -153,6 +276,10 @@ bool CMetaTriangleSelector::removeTriangleSelector(ITriangleSelector* toRemove)
 	{
 		if (toRemove == TriangleSelectors[i])
 		{
+			if (Entries[i].Proxy != -1)
+				BoxTree.destroyProxy(Entries[i].Proxy);
+			Entries.erase(i);
+
 			TriangleSelectors[i]->drop();
 			TriangleSelectors.erase(i);
 			return true;
@@ -170,6 +297,88 @@ void CMetaTriangleSelector::removeAllTriangleSelectors()
 		TriangleSelectors[i]->drop();
 
 	TriangleSelectors.clear();
+	Entries.clear();
+	BoxTree.clear();
+}
+
+
+//! Gets a box around all triangles of this selector.
+bool CMetaTriangleSelector::getBoundingBox(core::aabbox3df& outBox, bool useNodeTransform) const
+{
+	if (TriangleSelectors.empty())
+		return false;
+
+	if (!useNodeTransform)
+	{
+		core::aabbox3df box;
+		for (u32 i=0; i<TriangleSelectors.size(); ++i)
+		{
+			if (!TriangleSelectors[i]->getBoundingBox(box, false))
+				return false;
+			if (i == 0)
+				outBox = box;
+			else
+				outBox.addInternalBox(box);
+		}
+		return true;
+	}
+
+	// also brings animated selectors up to date, so the following
+	// queries don't have to change anything
+	updateBoxes();
+
+	for (u32 i=0; i<Entries.size(); ++i)
+	{
+		if (Entries[i].Proxy == -1)
+			return false;
+	}
+
+	outBox = Entries[0].Box;
+	for (u32 i=1; i<Entries.size(); ++i)
+		outBox.addInternalBox(Entries[i].Box);
+	return true;
+}
+
+
+//! Updates the boxes of selectors which moved
+void CMetaTriangleSelector::updateBoxes() const
+{
+	for (u32 i=0; i<Entries.size(); ++i)
+	{
+		const SSelectorEntry& entry = Entries[i];
+		if (entry.AlwaysUpdate || (entry.Node && entry.Node->getTransformVersion() != entry.TransformVersion))
+			updateBox(i);
+	}
+}
+
+
+//! Updates the box of one selector
+void CMetaTriangleSelector::updateBox(u32 index) const
+{
+	SSelectorEntry& entry = Entries[index];
+
+	if (entry.Node && entry.Node->getTransformVersion() != entry.TransformVersion)
+		entry.TransformVersion = entry.Node->getTransformVersion();
+
+	core::aabbox3df box;
+	if (!TriangleSelectors[index]->getBoundingBox(box))
+	{
+		if (entry.Proxy != -1)
+		{
+			BoxTree.destroyProxy(entry.Proxy);
+			entry.Proxy = -1;
+		}
+		return;
+	}
+
+	if (entry.Proxy == -1)
+		entry.Proxy = BoxTree.createProxy(box, TriangleSelectors[index]);
+	else if (box == entry.Box)
+		return;
+	else
+		BoxTree.moveProxy(entry.Proxy, box);
+
+	entry.Box = box;
 }
 
 
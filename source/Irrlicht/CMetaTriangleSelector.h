@@ -7,6 +7,7 @@
 
 #include "IMetaTriangleSelector.h"
 #include "irrArray.h"
+#include "CDynamicAABBTree.h"
 
 namespace irr
 {
@@ -44,6 +45,9 @@ public:
 		const core::matrix4* transform,	bool useNodeTransform, 
 		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const _IRR_OVERRIDE_;
 
+	//! Gets a box around all triangles of this selector.
+	virtual bool getBoundingBox(core::aabbox3df& outBox, bool useNodeTransform) const _IRR_OVERRIDE_;
+
 	//! Adds a triangle selector to the collection of triangle selectors
 	//! in this metaTriangleSelector.
 	virtual void addTriangleSelector(ITriangleSelector* toAdd) _IRR_OVERRIDE_;
@@ -68,7 +72,32 @@ public:
 
 private:
 
+	//! Broadphase data of a selector
+	struct SSelectorEntry
+	{
+		//! node of the selector, its transformation version tells when the box moved
+		const ISceneNode* Node;
+		u32 TransformVersion;
+		//! box in world space and its proxy in BoxTree, -1 if the selector has no box
+		core::aabbox3df Box;
+		s32 Proxy;
+		//! the triangles can change without the node moving
+		bool AlwaysUpdate;
+	};
+
+	//! Updates the boxes of selectors which moved
+	/** Only writes when something changed, so it can be called from
+	several threads once the selectors are up to date. */
+	void updateBoxes() const;
+
+	//! Updates the box of one selector
+	void updateBox(u32 index) const;
+
 	core::array<ITriangleSelector*> TriangleSelectors;
+
+	//! same order as TriangleSelectors
+	mutable core::array<SSelectorEntry> Entries;
+	mutable CDynamicAABBTree BoxTree;
 };
 
 } // end namespace scene
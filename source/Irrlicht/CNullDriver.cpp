@@ -87,7 +87,8 @@ IImageWriter* createImageWriterPPM();
 //! constructor
 CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& screenSize)
 	: SharedRenderTarget(0), CurrentRenderTarget(0), CurrentRenderTargetSize(0, 0), FileSystem(io), MeshManipulator(0),
-	ViewPort(0, 0, 0, 0), ScreenSize(screenSize), PrimitivesDrawn(0), MinVertexCountForVBO(500),
+	ViewPort(0, 0, 0, 0), ScreenSize(screenSize), PrimitivesDrawn(0), BufferLinkLookups(0), BufferLinkSearches(0), UnstoredBufferLinks(0),
+	StreamFrame(0), StreamedBytes(0), StreamWaits(0), StreamOrphans(0), UploadedBytes(0), MinVertexCountForVBO(500),
 	TextureCreationFlags(0), OverrideMaterial2DEnabled(false), AllowZWriteOnTransparent(false)
 {
 	#ifdef _DEBUG
@@ -107,6 +108,14 @@ CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& scre
 //	DriverAttributes->addInt("MaxGeometryVerticesOut", 0);
 //	DriverAttributes->addFloat("MaxTextureLODBias", 0.f);
 	DriverAttributes->addInt("Version", 1);
+	DriverAttributes->addInt("BufferLinkLookups", 0);
+	DriverAttributes->addInt("BufferLinkSearches", 0);
+	DriverAttributes->addInt("StreamedBytes", 0);
+	DriverAttributes->addInt("StreamWaits", 0);
+	DriverAttributes->addInt("StreamOrphans", 0);
+	DriverAttributes->addInt("UploadedBytes", 0);
+	DriverAttributes->addInt("StateCallsIssued", 0);
+	DriverAttributes->addInt("StateCallsSkipped", 0);
 //	DriverAttributes->addInt("ShaderLanguageVersion", 0);
 //	DriverAttributes->addInt("AntiAlias", 0);
 
@@ -206,6 +215,10 @@ CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& scre
 		InitMaterial2D.TextureLayer[i].TextureWrapW = video::ETC_REPEAT;
 	}
 	OverrideMaterial2D=InitMaterial2D;
+
+	// enough for some thousand particles and several lines of text each frame
+	StreamBuffers[ESB_VERTEX].Size = 4*1024*1024;
+	StreamBuffers[ESB_INDEX].Size = 1024*1024;
 }
 
 
@@ -312,6 +325,7 @@ void CNullDriver::deleteAllTextures()
 		Textures[i].Surface->drop();
 
 	Textures.clear();
+	TextureIndex.clear();
 
 	SharedDepthTextures.clear();
 }
@@ -326,6 +340,19 @@ bool CNullDriver::beginScene(u16 clearFlag, SColor clearColor, f32 clearDepth, u
 bool CNullDriver::endScene()
 {
 	FPSCounter.registerFrame(os::Timer::getRealTime(), PrimitivesDrawn);
+	DriverAttributes->setAttribute("BufferLinkLookups", (s32)BufferLinkLookups);
+	DriverAttributes->setAttribute("BufferLinkSearches", (s32)BufferLinkSearches);
+	BufferLinkLookups = 0;
+	BufferLinkSearches = 0;
+	fenceStreamBuffers();
+	DriverAttributes->setAttribute("StreamedBytes", (s32)StreamedBytes);
+	DriverAttributes->setAttribute("StreamWaits", (s32)StreamWaits);
+	DriverAttributes->setAttribute("StreamOrphans", (s32)StreamOrphans);
+	DriverAttributes->setAttribute("UploadedBytes", (s32)UploadedBytes);
+	StreamedBytes = 0;
+	StreamWaits = 0;
+	StreamOrphans = 0;
+	UploadedBytes = 0;
 	updateAllHardwareBuffers();
 	updateAllOcclusionQueries();
 	return true;
@@ -383,6 +410,7 @@ void CNullDriver::removeTexture(ITexture* texture)
 	{
 		if (Textures[i].Surface == texture)
 		{
+			removeFromTextureIndex(i);
 			texture->drop();
 			Textures.erase(i);
 			return;
@@ -422,12 +450,44 @@ void CNullDriver::renameTexture(ITexture* texture, const io::path& newName)
 {
 	// we can do a const_cast here safely, the name of the ITexture interface
 	// is just readonly to prevent the user changing the texture name without invoking
-	// this method, because the textures will need resorting afterwards
+	// this method, because the texture index needs to be updated afterwards
 
 	io::SNamedPath& name = const_cast<io::SNamedPath&>(texture->getName());
+
+	for (u32 i=0; i<Textures.size(); ++i)
+	{
+		if (Textures[i].Surface == texture)
+		{
+			removeFromTextureIndex(i);
+			name.setPath(newName);
+			TextureIndex.insert(name.getInternalName(), texture);
+			return;
+		}
+	}
+
+	// not a texture of this driver, so it is not in the index either
 	name.setPath(newName);
+}
+
 
-	Textures.sort();
+void CNullDriver::removeFromTextureIndex(u32 index)
+{
+	const io::path& name = Textures[index].Surface->getName().getInternalName();
+	ITexture** indexed = TextureIndex.find(name);
+	if (!indexed || *indexed != Textures[index].Surface)
+		return;
+
+	TextureIndex.remove(name);
+
+	// another texture with the same name takes its place
+	for (u32 i=0; i<Textures.size(); ++i)
+	{
+		if (i != index && Textures[i].Surface->getName().getInternalName() == name)
+		{
+			TextureIndex.insert(name, Textures[i].Surface);
+			break;
+		}
+	}
 }
 
 ITexture* CNullDriver::addTexture(const core::dimension2d<u32>& size, const io::path& name, ECOLOR_FORMAT format)
@@ -710,13 +770,7 @@ void CNullDriver::addTexture(video::ITexture* texture)
 		texture->grab();
 
 		Textures.push_back(s);
-
-		// the new texture is now at the end of the texture list. when searching for
-		// the next new texture, the texture array will be sorted and the index of this texture
-		// will be changed. to let the order be more consistent to the user, sort
-		// the textures now already although this isn't necessary:
-
-		Textures.sort();
+		TextureIndex.insert(texture->getName().getInternalName(), texture);
 	}
 }
 
@@ -724,15 +778,8 @@ void CNullDriver::addTexture(video::ITexture* texture)
 //! looks if the image is already loaded
 video::ITexture* CNullDriver::findTexture(const io::path& filename)
 {
-	SSurface s;
-	SDummyTexture dummy(filename, ETT_2D);
-	s.Surface = &dummy;
-
-	s32 index = Textures.binary_search(s);
-	if (index != -1)
-		return Textures[index].Surface;
-
-	return 0;
+	ITexture** texture = TextureIndex.find(io::SNamedPath(filename).getInternalName());
+	return texture ? *texture : 0;
 }
 
 ITexture* CNullDriver::createDeviceDependentTexture(const io::path& name, IImage* image)
@@ -810,6 +857,198 @@ void CNullDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
 }
 
 
+//! Allocates memory for vertices or indices which are only drawn in the current frame.
+SStreamAllocation CNullDriver::allocateStream(E_STREAM_BUFFER buffer, u32 size)
+{
+	SStreamAllocation result;
+	result.Buffer = buffer;
+	if ((u32)buffer >= ESB_COUNT)
+		return result;
+
+	SStreamBuffer& ring = StreamBuffers[buffer];
+	// keep vertex attributes and indices aligned
+	const u32 alignedSize = (size + 3) & ~3u;
+	if (!size || alignedSize > ring.Size)
+		return result;
+
+	unmapStreamBuffer(buffer);
+
+	while (true)
+	{
+		if (!ring.Pending)
+			ring.Head = ring.Tail = 0;
+
+		// free are [Head, Size) and [0, Tail) or only [Head, Tail)
+		if (!ring.Pending || ring.Head > ring.Tail)
+		{
+			if (ring.Size - ring.Head >= alignedSize)
+				break;
+			if (ring.Tail >= alignedSize)
+			{
+				// skip the end of the ring, it is freed with this frame
+				const u32 skipped = ring.Size - ring.Head;
+				ring.Pending += skipped;
+				ring.FrameBytes += skipped;
+				ring.Head = 0;
+				break;
+			}
+		}
+		else if (ring.Tail - ring.Head >= alignedSize)
+			break;
+
+		if (!ring.Fences.empty())
+		{
+			// oldest range is still in use, the GPU has to catch up
+			if (!waitStreamFence(ring.Fences[0], false))
+			{
+				++StreamWaits;
+				waitStreamFence(ring.Fences[0], true);
+			}
+			retireStreamFence(ring);
+		}
+		else
+		{
+			// everything was written in this frame, or fences are not
+			// supported, so continue in fresh memory
+			orphanStreamBuffer(buffer);
+			resetStreamBuffer(buffer);
+			++StreamOrphans;
+		}
+	}
+
+	result.Data = mapStreamBuffer(buffer, ring.Head, alignedSize);
+	if (!result.Data)
+		return result;
+
+	result.Size = size;
+	result.Offset = ring.Head;
+	ring.Head += alignedSize;
+	ring.Pending += alignedSize;
+	ring.FrameBytes += alignedSize;
+	StreamedBytes += alignedSize;
+
+	return result;
+}
+
+
+//! Draws vertices and indices which were written to stream allocations.
+void CNullDriver::drawStreamedPrimitiveList(const SStreamAllocation& vertices, u32 vertexCount,
+		const SStreamAllocation& indices, u32 primitiveCount,
+		E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
+{
+	// the emulation allocates system memory, which is drawn like client memory
+	if (vertices.Data && indices.Data)
+		drawVertexPrimitiveList(vertices.Data, vertexCount, indices.Data, primitiveCount, vType, pType, iType);
+}
+
+
+//! Draws streamed vertices with indices from client memory.
+void CNullDriver::drawStreamedPrimitiveList(const SStreamAllocation& vertices, u32 vertexCount,
+		const void* indexList, u32 primitiveCount,
+		E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
+{
+	if (vertices.Data)
+		drawVertexPrimitiveList(vertices.Data, vertexCount, indexList, primitiveCount, vType, pType, iType);
+}
+
+
+//! Sets the size of a streaming buffer.
+void CNullDriver::setStreamBufferSize(E_STREAM_BUFFER buffer, u32 size)
+{
+	if ((u32)buffer >= ESB_COUNT)
+		return;
+
+	unmapStreamBuffer(buffer);
+	resetStreamBuffer(buffer);
+	deleteStreamBuffer(buffer);
+	StreamBuffers[buffer].Size = size;
+}
+
+
+//! Returns memory to write a range of a streaming buffer to
+void* CNullDriver::mapStreamBuffer(E_STREAM_BUFFER buffer, u32 offset, u32 size)
+{
+	SStreamBuffer& ring = StreamBuffers[buffer];
+	if (ring.Memory.size() != ring.Size)
+		ring.Memory.set_used(ring.Size);
+
+	return ring.Memory.pointer() + offset;
+}
+
+
+//! Frees the memory of a streaming buffer
+void CNullDriver::deleteStreamBuffer(E_STREAM_BUFFER buffer)
+{
+	StreamBuffers[buffer].Memory.clear();
+}
+
+
+//! Checks if the GPU passed a fence, or waits for it when block is true
+bool CNullDriver::waitStreamFence(SStreamFence& fence, bool block)
+{
+	// a GPU usually renders up to two frames behind
+	return block || (StreamFrame - fence.Frame >= 2);
+}
+
+
+//! Frees the oldest fenced range of a streaming buffer
+void CNullDriver::retireStreamFence(SStreamBuffer& ring)
+{
+	SStreamFence& fence = ring.Fences[0];
+	ring.Tail = fence.End;
+	ring.Pending -= fence.Bytes;
+	deleteStreamFence(fence);
+	ring.Fences.erase(0);
+}
+
+
+//! Fences the data written to the streaming buffers in this frame
+void CNullDriver::fenceStreamBuffers()
+{
+	for (u32 i=0; i<ESB_COUNT; ++i)
+	{
+		const E_STREAM_BUFFER buffer = (E_STREAM_BUFFER)i;
+		SStreamBuffer& ring = StreamBuffers[i];
+		unmapStreamBuffer(buffer);
+
+		// free what the GPU is done with, without waiting
+		while (!ring.Fences.empty() && waitStreamFence(ring.Fences[0], false))
+			retireStreamFence(ring);
+
+		if (!ring.FrameBytes)
+			continue;
+
+		SStreamFence fence;
+		fence.Sync = 0;
+		fence.Frame = StreamFrame;
+		fence.End = ring.Head;
+		fence.Bytes = ring.FrameBytes;
+		// without fences the data stays in use until the ring is orphaned
+		if (insertStreamFence(fence))
+		{
+			ring.Fences.push_back(fence);
+			ring.FrameBytes = 0;
+		}
+	}
+
+	++StreamFrame;
+}
+
+
+//! Drops all fences and starts at the beginning of the ring
+void CNullDriver::resetStreamBuffer(E_STREAM_BUFFER buffer)
+{
+	SStreamBuffer& ring = StreamBuffers[buffer];
+	for (u32 i=0; i<ring.Fences.size(); ++i)
+		deleteStreamFence(ring.Fences[i]);
+	ring.Fences.clear();
+	ring.Head = 0;
+	ring.Tail = 0;
+	ring.Pending = 0;
+	ring.FrameBytes = 0;
+}
+
+
 //! draws a vertex primitive list in 2d
 void CNullDriver::draw2DVertexPrimitiveList(const void* vertices, u32 vertexCount, const void* indexList, u32 primitiveCount, E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
 {
@@ -1811,32 +2050,68 @@ CNullDriver::SHWBufferLink *CNullDriver::getBufferLink(const scene::IMeshBuffer*
 	if (!mb || !isHardwareBufferRecommend(mb))
 		return 0;
 
-	//search for hardware links
-	core::map< const scene::IMeshBuffer*,SHWBufferLink* >::Node* node = HWBufferMap.find(mb);
-	if (node)
-		return node->getValue();
+	++BufferLinkLookups;
+
+	// the meshbuffer knows its link, unless another driver stored its own
+	SHWBufferLink* link = (SHWBufferLink*)mb->getHWBufferLink();
+	if (link && link->Driver == this)
+		return link;
+
+	if (UnstoredBufferLinks)
+	{
+		SHWBufferLink* found = findBufferLink(mb);
+		if (found)
+		{
+			// the other driver removed its link meanwhile
+			if (!link)
+			{
+				mb->setHWBufferLink(found);
+				--UnstoredBufferLinks;
+			}
+			return found;
+		}
+	}
 
 	return createHardwareBuffer(mb); //no hardware links, and mesh wants one, create it
 }
 
 
+CNullDriver::SHWBufferLink* CNullDriver::findBufferLink(const scene::IMeshBuffer* mb) const
+{
+	++const_cast<CNullDriver*>(this)->BufferLinkSearches;
+	for (u32 i=0; i<HWBufferLinks.size(); ++i)
+	{
+		if (HWBufferLinks[i]->MeshBuffer == mb)
+			return HWBufferLinks[i];
+	}
+	return 0;
+}
+
+
+void CNullDriver::addHardwareBuffer(SHWBufferLink *HWBuffer)
+{
+	HWBuffer->Driver = this;
+	HWBuffer->LinkIndex = HWBufferLinks.size();
+	HWBufferLinks.push_back(HWBuffer);
+
+	if (!HWBuffer->MeshBuffer->getHWBufferLink())
+		HWBuffer->MeshBuffer->setHWBufferLink(HWBuffer);
+	else
+		++UnstoredBufferLinks;
+}
+
+
 //! Update all hardware buffers, remove unused ones
 void CNullDriver::updateAllHardwareBuffers()
 {
-	core::map<const scene::IMeshBuffer*,SHWBufferLink*>::ParentFirstIterator Iterator=HWBufferMap.getParentFirstIterator();
-
-	for (;!Iterator.atEnd();Iterator++)
+	// backwards, as deleting moves the last link into the free place
+	for (s32 i=(s32)HWBufferLinks.size()-1; i>=0; --i)
 	{
-		SHWBufferLink *Link=Iterator.getNode()->getValue();
+		SHWBufferLink *Link=HWBufferLinks[i];
 
 		Link->LastUsed++;
 		if (Link->LastUsed>20000)
-		{
 			deleteHardwareBuffer(Link);
-
-			// todo: needs better fix
-			Iterator = HWBufferMap.getParentFirstIterator();
-		}
 	}
 }
 
@@ -1845,7 +2120,20 @@ void CNullDriver::deleteHardwareBuffer(SHWBufferLink *HWBuffer)
 {
 	if (!HWBuffer)
 		return;
-	HWBufferMap.remove(HWBuffer->MeshBuffer);
+
+	const u32 last = HWBufferLinks.size()-1;
+	if (HWBuffer->LinkIndex != last)
+	{
+		HWBufferLinks[HWBuffer->LinkIndex] = HWBufferLinks[last];
+		HWBufferLinks[HWBuffer->LinkIndex]->LinkIndex = HWBuffer->LinkIndex;
+	}
+	HWBufferLinks.erase(last);
+
+	if (HWBuffer->MeshBuffer->getHWBufferLink() == HWBuffer)
+		HWBuffer->MeshBuffer->setHWBufferLink(0);
+	else
+		--UnstoredBufferLinks;
+
 	delete HWBuffer;
 }
 
@@ -1853,17 +2141,22 @@ void CNullDriver::deleteHardwareBuffer(SHWBufferLink *HWBuffer)
 //! Remove hardware buffer
 void CNullDriver::removeHardwareBuffer(const scene::IMeshBuffer* mb)
 {
-	core::map<const scene::IMeshBuffer*,SHWBufferLink*>::Node* node = HWBufferMap.find(mb);
-	if (node)
-		deleteHardwareBuffer(node->getValue());
+	if (!mb)
+		return;
+
+	SHWBufferLink* link = (SHWBufferLink*)mb->getHWBufferLink();
+	if ((!link || link->Driver != this) && UnstoredBufferLinks)
+		link = findBufferLink(mb);
+	if (link && link->Driver == this)
+		deleteHardwareBuffer(link);
 }
 
 
 //! Remove all hardware buffers
 void CNullDriver::removeAllHardwareBuffers()
 {
-	while (HWBufferMap.size())
-		deleteHardwareBuffer(HWBufferMap.getRoot()->getValue());
+	while (HWBufferLinks.size())
+		deleteHardwareBuffer(HWBufferLinks.getLast());
 }
 
 
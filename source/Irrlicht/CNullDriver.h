@@ -12,6 +12,7 @@
 #include "irrArray.h"
 #include "irrString.h"
 #include "irrMap.h"
+#include "irrHashMap.h"
 #include "IAttributes.h"
 #include "IMesh.h"
 #include "IMeshBuffer.h"
@@ -122,6 +123,24 @@ namespace video
 				E_VERTEX_TYPE vType=EVT_STANDARD, scene::E_PRIMITIVE_TYPE pType=scene::EPT_TRIANGLES,
 				E_INDEX_TYPE iType=EIT_16BIT) _IRR_OVERRIDE_;
 
+		//! Allocates memory for vertices or indices which are only drawn in the current frame.
+		virtual SStreamAllocation allocateStream(E_STREAM_BUFFER buffer, u32 size) _IRR_OVERRIDE_;
+
+		//! Draws vertices and indices which were written to stream allocations.
+		virtual void drawStreamedPrimitiveList(const SStreamAllocation& vertices, u32 vertexCount,
+				const SStreamAllocation& indices, u32 primitiveCount,
+				E_VERTEX_TYPE vType=EVT_STANDARD, scene::E_PRIMITIVE_TYPE pType=scene::EPT_TRIANGLES,
+				E_INDEX_TYPE iType=EIT_16BIT) _IRR_OVERRIDE_;
+
+		//! Draws streamed vertices with indices from client memory.
+		virtual void drawStreamedPrimitiveList(const SStreamAllocation& vertices, u32 vertexCount,
+				const void* indexList, u32 primitiveCount,
+				E_VERTEX_TYPE vType=EVT_STANDARD, scene::E_PRIMITIVE_TYPE pType=scene::EPT_TRIANGLES,
+				E_INDEX_TYPE iType=EIT_16BIT) _IRR_OVERRIDE_;
+
+		//! Sets the size of a streaming buffer.
+		virtual void setStreamBufferSize(E_STREAM_BUFFER buffer, u32 size) _IRR_OVERRIDE_;
+
 		//! draws a vertex primitive list in 2d
 		virtual void draw2DVertexPrimitiveList(const void* vertices, u32 vertexCount,
 				const void* indexList, u32 primitiveCount,
@@ -392,7 +411,7 @@ namespace video
 		struct SHWBufferLink
 		{
 			SHWBufferLink(const scene::IMeshBuffer *_MeshBuffer)
-				:MeshBuffer(_MeshBuffer),
+				:MeshBuffer(_MeshBuffer), Driver(0), LinkIndex(0),
 				ChangedID_Vertex(0),ChangedID_Index(0),LastUsed(0),
 				Mapped_Vertex(scene::EHM_NEVER),Mapped_Index(scene::EHM_NEVER)
 			{
@@ -407,6 +426,10 @@ namespace video
 			}
 
 			const scene::IMeshBuffer *MeshBuffer;
+			//! driver which created the link, set by addHardwareBuffer
+			const CNullDriver* Driver;
+			//! position in HWBufferLinks
+			u32 LinkIndex;
 			u32 ChangedID_Vertex;
 			u32 ChangedID_Index;
 			u32 LastUsed;
@@ -426,6 +449,12 @@ namespace video
 		//! Delete hardware buffer
 		virtual void deleteHardwareBuffer(SHWBufferLink *HWBuffer);
 
+		//! Adds a new hardware buffer link, so it can be found by getBufferLink
+		void addHardwareBuffer(SHWBufferLink *HWBuffer);
+
+		//! Searches the link of a meshbuffer which did not store it
+		SHWBufferLink* findBufferLink(const scene::IMeshBuffer* mb) const;
+
 		//! Create hardware buffer from mesh (only some drivers can)
 		virtual SHWBufferLink *createHardwareBuffer(const scene::IMeshBuffer* mb) {return 0;}
 
@@ -687,9 +716,79 @@ namespace video
 		virtual bool checkDriverReset() _IRR_OVERRIDE_ {return false;}
 	protected:
 
+		//! fence after the commands which use a range of a streaming buffer
+		struct SStreamFence
+		{
+			//! driver specific fence object
+			void* Sync;
+			//! frame in which the fence was inserted
+			u32 Frame;
+			//! head of the ring when the fence was inserted
+			u32 End;
+			//! bytes of the ring covered by the fence, including skipped ones at the end
+			u32 Bytes;
+		};
+
+		//! ring allocator of a streaming buffer
+		struct SStreamBuffer
+		{
+			SStreamBuffer() : Size(0), Head(0), Tail(0), Pending(0), FrameBytes(0) {}
+
+			//! capacity in bytes
+			u32 Size;
+			//! next byte to allocate
+			u32 Head;
+			//! first byte which may still be in use by the GPU
+			u32 Tail;
+			//! bytes from Tail to Head, fenced or written in the current frame
+			u32 Pending;
+			//! bytes allocated since the last fence
+			u32 FrameBytes;
+			//! fences of former frames, oldest first
+			core::array<SStreamFence> Fences;
+			//! system memory used by the emulation
+			core::array<u8> Memory;
+		};
+
+		//! Returns memory to write a range of a streaming buffer to
+		/** The emulation returns system memory, drivers with hardware
+		buffers map the range. Returns 0 on failure. */
+		virtual void* mapStreamBuffer(E_STREAM_BUFFER buffer, u32 offset, u32 size);
+
+		//! Finishes writing to the memory returned by mapStreamBuffer
+		virtual void unmapStreamBuffer(E_STREAM_BUFFER buffer) {}
+
+		//! Continues in new memory, the GPU may still use the old one
+		virtual void orphanStreamBuffer(E_STREAM_BUFFER buffer) {}
+
+		//! Frees the memory of a streaming buffer
+		virtual void deleteStreamBuffer(E_STREAM_BUFFER buffer);
+
+		//! Inserts a fence after all commands sent so far, false if fences are not supported
+		virtual bool insertStreamFence(SStreamFence& fence) { return true; }
+
+		//! Checks if the GPU passed a fence, or waits for it when block is true
+		/** The emulation acts like a GPU which is some frames behind. */
+		virtual bool waitStreamFence(SStreamFence& fence, bool block);
+
+		//! Deletes a fence object
+		virtual void deleteStreamFence(SStreamFence& fence) {}
+
+		//! Frees the oldest fenced range of a streaming buffer
+		void retireStreamFence(SStreamBuffer& ring);
+
+		//! Fences the data written to the streaming buffers in this frame
+		void fenceStreamBuffers();
+
+		//! Drops all fences and starts at the beginning of the ring
+		void resetStreamBuffer(E_STREAM_BUFFER buffer);
+
 		//! deletes all textures
 		void deleteAllTextures();
 
+		//! removes a texture from TextureIndex, before it is erased from Textures
+		void removeFromTextureIndex(u32 index);
+
 		//! opens the file and loads it into the surface
 		video::ITexture* loadTextureFromFile(io::IReadFile* file, const io::path& hashName = "");
 
@@ -788,6 +887,8 @@ namespace video
 			virtual void regenerateMipMapLevels(void* data = 0, u32 layer = 0) _IRR_OVERRIDE_ {}
 		};
 		core::array<SSurface> Textures;
+		//! textures by their internal name, for findTexture
+		core::hash_map<io::path, ITexture*> TextureIndex;
 
 		struct SOccQuery
 		{
@@ -860,8 +961,8 @@ namespace video
 		core::array<SLight> Lights;
 		core::array<SMaterialRenderer> MaterialRenderers;
 
-		//core::array<SHWBufferLink*> HWBufferLinks;
-		core::map< const scene::IMeshBuffer* , SHWBufferLink* > HWBufferMap;
+		//! all hardware buffer links, the meshbuffers also store their own link
+		core::array<SHWBufferLink*> HWBufferLinks;
 
 		io::IFileSystem* FileSystem;
 
@@ -875,6 +976,24 @@ namespace video
 		CFPSCounter FPSCounter;
 
 		u32 PrimitivesDrawn;
+		//! getBufferLink calls in the current frame
+		u32 BufferLinkLookups;
+		//! lookups which had to search HWBufferLinks in the current frame
+		u32 BufferLinkSearches;
+		//! links which are not stored in their meshbuffer, as another driver did so
+		u32 UnstoredBufferLinks;
+
+		SStreamBuffer StreamBuffers[ESB_COUNT];
+		//! frames since the driver was created, for fences of the emulation
+		u32 StreamFrame;
+		//! bytes allocated from the streaming buffers in the current frame
+		u32 StreamedBytes;
+		//! blocking fence waits in the current frame
+		u32 StreamWaits;
+		//! replaced streaming buffers in the current frame
+		u32 StreamOrphans;
+		//! bytes uploaded to hardware buffers of meshbuffers in the current frame
+		u32 UploadedBytes;
 		u32 MinVertexCountForVBO;
 
 		u32 TextureCreationFlags;
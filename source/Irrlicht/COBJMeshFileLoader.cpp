@@ -89,8 +89,9 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 	const io::path fullName = file->getFileName();
 	const io::path relPath = FileSystem->getFileDir(fullName)+"/";
 
-	c8* buf = new c8[filesize];
-	memset(buf, 0, filesize);
+	// 0-terminated, so numbers can be parsed in place
+	c8* buf = new c8[filesize+1];
+	memset(buf, 0, filesize+1);
 	file->read((void*)buf, filesize);
 	const c8* const bufEnd = buf+filesize;
 
@@ -199,7 +200,6 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 
 		case 'f':               // face
 		{
-			c8 vertexWord[WORD_BUFFER_LENGTH]; // for retrieving vertex data
 			video::S3DVertex v;
 			// Assign vertex color from currently active material's diffuse color
 			if (mtlChanged)
@@ -215,15 +215,13 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 				v.Color = currMtl->Meshbuffer->Material.DiffuseColor;
 
 			// get all vertices data in this face (current line of obj file)
-			const core::stringc wordBuffer = copyLine(bufPtr, bufEnd);
-			const c8* linePtr = wordBuffer.c_str();
-			const c8* const endPtr = linePtr+wordBuffer.size();
+			const c8* const lineEnd = core::findLineEnd(bufPtr, bufEnd);
+			const c8* linePtr = goNextWord(bufPtr, lineEnd);
 
 			faceCorners.set_used(0); // fast clear
 
 			// read in all vertices
-			linePtr = goNextWord(linePtr, endPtr);
-			while (0 != linePtr[0])
+			while (linePtr != lineEnd)
 			{
 				// Array to communicate with retrieveVertexIndices()
 				// sends the buffer sizes and gets the actual indices
@@ -232,14 +230,13 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 				Idx[0] = Idx[1] = Idx[2] = -1;
 
 				// read in next vertex's data
-				u32 wlength = copyWord(vertexWord, linePtr, WORD_BUFFER_LENGTH, endPtr);
 				// this function will also convert obj's 1-based index to c++'s 0-based index
-				retrieveVertexIndices(vertexWord, Idx, vertexWord+wlength+1, vertexBuffer.size(), textureCoordBuffer.size(), normalsBuffer.size());
+				retrieveVertexIndices(linePtr, Idx, lineEnd, vertexBuffer.size(), textureCoordBuffer.size(), normalsBuffer.size());
 				if ( -1 != Idx[0] && Idx[0] < (irr::s32)vertexBuffer.size() )
 					v.Pos = vertexBuffer[Idx[0]];
 				else
 				{
-					os::Printer::log("Invalid vertex index in this line:", wordBuffer.c_str(), ELL_ERROR);
+					os::Printer::log("Invalid vertex index in this line:", core::stringc(bufPtr, (u32)(lineEnd-bufPtr)).c_str(), ELL_ERROR);
 					delete [] buf;
 					return 0;
 				}
@@ -271,7 +268,7 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 				faceCorners.push_back(vertLocation);
 
 				// go to next vertex
-				linePtr = goNextWord(linePtr, endPtr);
+				linePtr = goNextWord(linePtr, lineEnd);
 			}
 
 			// triangulate the face
@@ -529,7 +526,8 @@ void COBJMeshFileLoader::readMTL(const c8* fileName, const io::path& relPath)
 		return;
 	}
 
-	c8* buf = new c8[filesize];
+	c8* buf = new c8[filesize+1];
+	memset(buf, 0, filesize+1);
 	mtlReader->read((void*)buf, filesize);
 	const c8* bufEnd = buf+filesize;
 
@@ -685,16 +683,16 @@ void COBJMeshFileLoader::readMTL(const c8* fileName, const io::path& relPath)
 //! Read RGB color
 const c8* COBJMeshFileLoader::readColor(const c8* bufPtr, video::SColor& color, const c8* const bufEnd)
 {
-	const u32 COLOR_BUFFER_LENGTH = 16;
-	c8 colStr[COLOR_BUFFER_LENGTH];
+	f32 value;
 
 	color.setAlpha(255);
-	bufPtr = goAndCopyNextWord(colStr, bufPtr, COLOR_BUFFER_LENGTH, bufEnd);
-	color.setRed((s32)(core::fast_atof(colStr) * 255.0f));
-	bufPtr = goAndCopyNextWord(colStr,   bufPtr, COLOR_BUFFER_LENGTH, bufEnd);
-	color.setGreen((s32)(core::fast_atof(colStr) * 255.0f));
-	bufPtr = goAndCopyNextWord(colStr,   bufPtr, COLOR_BUFFER_LENGTH, bufEnd);
-	color.setBlue((s32)(core::fast_atof(colStr) * 255.0f));
+	bufPtr = core::skipToken(bufPtr, bufEnd);
+	bufPtr = core::fast_atof_token(bufPtr, bufEnd, value, false);
+	color.setRed((s32)(value * 255.0f));
+	bufPtr = core::fast_atof_token(bufPtr, bufEnd, value, false);
+	color.setGreen((s32)(value * 255.0f));
+	bufPtr = core::fast_atof_token(bufPtr, bufEnd, value, false);
+	color.setBlue((s32)(value * 255.0f));
 	return bufPtr;
 }
 
@@ -702,15 +700,11 @@ const c8* COBJMeshFileLoader::readColor(const c8* bufPtr, video::SColor& color,
 //! Read 3d vector of floats
 const c8* COBJMeshFileLoader::readVec3(const c8* bufPtr, core::vector3df& vec, const c8* const bufEnd)
 {
-	const u32 WORD_BUFFER_LENGTH = 256;
-	c8 wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.X=-core::fast_atof(wordBuffer); // change handedness
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Y=core::fast_atof(wordBuffer);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Z=core::fast_atof(wordBuffer);
+	bufPtr = core::skipToken(bufPtr, bufEnd);
+	bufPtr = core::fast_atof_token(bufPtr, bufEnd, vec.X, false);
+	vec.X = -vec.X; // change handedness
+	bufPtr = core::fast_atof_token(bufPtr, bufEnd, vec.Y, false);
+	bufPtr = core::fast_atof_token(bufPtr, bufEnd, vec.Z, false);
 	return bufPtr;
 }
 
@@ -718,13 +712,10 @@ const c8* COBJMeshFileLoader::readVec3(const c8* bufPtr, core::vector3df& vec, c
 //! Read 2d vector of floats
 const c8* COBJMeshFileLoader::readUV(const c8* bufPtr, core::vector2df& vec, const c8* const bufEnd)
 {
-	const u32 WORD_BUFFER_LENGTH = 256;
-	c8 wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.X=core::fast_atof(wordBuffer);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Y=1-core::fast_atof(wordBuffer); // change handedness
+	bufPtr = core::skipToken(bufPtr, bufEnd);
+	bufPtr = core::fast_atof_token(bufPtr, bufEnd, vec.X, false);
+	bufPtr = core::fast_atof_token(bufPtr, bufEnd, vec.Y, false);
+	vec.Y = 1-vec.Y; // change handedness
 	return bufPtr;
 }
 
@@ -777,41 +768,21 @@ COBJMeshFileLoader::SObjMtl* COBJMeshFileLoader::findMtl(const core::stringc& mt
 //! skip space characters and stop on first non-space
 const c8* COBJMeshFileLoader::goFirstWord(const c8* buf, const c8* const bufEnd, bool acrossNewlines)
 {
-	// skip space characters
-	if (acrossNewlines)
-		while((buf != bufEnd) && core::isspace(*buf))
-			++buf;
-	else
-		while((buf != bufEnd) && core::isspace(*buf) && (*buf != '\n'))
-			++buf;
-
-	return buf;
+	return core::skipWhitespace(buf, bufEnd, acrossNewlines);
 }
 
 
 //! skip current word and stop at beginning of next one
 const c8* COBJMeshFileLoader::goNextWord(const c8* buf, const c8* const bufEnd, bool acrossNewlines)
 {
-	// skip current word
-	while(( buf != bufEnd ) && !core::isspace(*buf))
-		++buf;
-
-	return goFirstWord(buf, bufEnd, acrossNewlines);
+	return core::skipWhitespace(core::skipToken(buf, bufEnd), bufEnd, acrossNewlines);
 }
 
 
 //! Read until line break is reached and stop at the next non-space character
 const c8* COBJMeshFileLoader::goNextLine(const c8* buf, const c8* const bufEnd)
 {
-	// look for newline characters
-	while(buf != bufEnd)
-	{
-		// found it, so leave
-		if (*buf=='\n' || *buf=='\r')
-			break;
-		++buf;
-	}
-	return goFirstWord(buf, bufEnd);
+	return core::skipWhitespace(core::findLineEnd(buf, bufEnd), bufEnd);
 }
 
 
@@ -842,23 +813,6 @@ u32 COBJMeshFileLoader::copyWord(c8* outBuf, const c8* const inBuf, u32 outBufLe
 }
 
 
-core::stringc COBJMeshFileLoader::copyLine(const c8* inBuf, const c8* bufEnd)
-{
-	if (!inBuf)
-		return core::stringc();
-
-	const c8* ptr = inBuf;
-	while (ptr<bufEnd)
-	{
-		if (*ptr=='\n' || *ptr=='\r')
-			break;
-		++ptr;
-	}
-	// we must avoid the +1 in case the array is used up
-	return core::stringc(inBuf, (u32)(ptr-inBuf+((ptr < bufEnd) ? 1 : 0)));
-}
-
-
 const c8* COBJMeshFileLoader::goAndCopyNextWord(c8* outBuf, const c8* inBuf, u32 outBufLength, const c8* bufEnd)
 {
 	inBuf = goNextWord(inBuf, bufEnd, false);
@@ -867,72 +821,30 @@ const c8* COBJMeshFileLoader::goAndCopyNextWord(c8* outBuf, const c8* inBuf, u32
 }
 
 
-bool COBJMeshFileLoader::retrieveVertexIndices(c8* vertexData, s32* idx, const c8* bufEnd, u32 vbsize, u32 vtsize, u32 vnsize)
+const c8* COBJMeshFileLoader::retrieveVertexIndices(const c8* vertexData, s32* idx, const c8* bufEnd, u32 vbsize, u32 vtsize, u32 vnsize)
 {
-	c8 word[16] = "";
-	const c8* p = goFirstWord(vertexData, bufEnd);
-	u32 idxType = 0;	// 0 = posIdx, 1 = texcoordIdx, 2 = normalIdx
+	const u32 sizes[3] = { vbsize, vtsize, vnsize };
+	const c8* p = vertexData;
 
-	u32 i = 0;
-	while ( p != bufEnd )
+	// 0 = posIdx, 1 = texcoordIdx, 2 = normalIdx
+	for (u32 idxType = 0; idxType < 3; ++idxType)
 	{
-		if ( ( core::isdigit(*p)) || (*p == '-') )
-		{
-			// build up the number
-			word[i++] = *p;
-		}
-		else if ( *p == '/' || *p == ' ' || *p == '\0' )
-		{
-			// number is completed. Convert and store it
-			word[i] = '\0';
-			// if no number was found index will become 0 and later on -1 by decrement
-			idx[idxType] = core::strtol10(word);
-			if (idx[idxType]<0)
-			{
-				switch (idxType)
-				{
-					case 0:
-						idx[idxType] += vbsize;
-						break;
-					case 1:
-						idx[idxType] += vtsize;
-						break;
-					case 2:
-						idx[idxType] += vnsize;
-						break;
-				}
-			}
-			else
-				idx[idxType]-=1;
-
-			// reset the word
-			word[0] = '\0';
-			i = 0;
-
-			// go to the next kind of index type
-			if (*p == '/')
-			{
-				if ( ++idxType > 2 )
-				{
-					// error checking, shouldn't reach here unless file is wrong
-					idxType = 0;
-				}
-			}
-			else
-			{
-				// set all missing values to disable (=-1)
-				while (++idxType < 3)
-					idx[idxType]=-1;
-				++p;
-				break; // while
-			}
-		}
+		// if no number was found index will become 0 and later on -1 by decrement
+		s32 value = 0;
+		if ( p != bufEnd && ( core::isdigit(*p) || *p == '-' ) )
+			value = core::strtol10(p, &p);
+		if (value<0)
+			idx[idxType] = value + (s32)sizes[idxType];
+		else
+			idx[idxType] = value - 1;
 
-		// go to the next char
+		// go to the next kind of index type, all missing values stay disabled (=-1)
+		if ( p == bufEnd || *p != '/' )
+			break;
 		++p;
 	}
 
-	return true;
+	return p;
 }
 
 
@@ -81,8 +81,6 @@ private:
 	const c8* goNextLine(const c8* buf, const c8* const bufEnd);
 	// copies the current word from the inBuf to the outBuf
 	u32 copyWord(c8* outBuf, const c8* inBuf, u32 outBufLength, const c8* const pBufEnd);
-	// copies the current line from the inBuf to the outBuf
-	core::stringc copyLine(const c8* inBuf, const c8* const bufEnd);
 
 	// combination of goNextWord followed by copyWord
 	const c8* goAndCopyNextWord(c8* outBuf, const c8* inBuf, u32 outBufLength, const c8* const pBufEnd);
@@ -102,10 +100,11 @@ private:
 	//! Read boolean value represented as 'on' or 'off'
 	const c8* readBool(const c8* bufPtr, bool& tf, const c8* const bufEnd);
 
-	// reads and convert to integer the vertex indices in a line of obj file's face statement
+	// reads and convert to integer the vertex indices of a vertex in an obj file's face statement
 	// -1 for the index if it doesn't exist
 	// indices are changed to 0-based index instead of 1-based from the obj file
-	bool retrieveVertexIndices(c8* vertexData, s32* idx, const c8* bufEnd, u32 vbsize, u32 vtsize, u32 vnsize);
+	// returns a pointer behind the last index read
+	const c8* retrieveVertexIndices(const c8* vertexData, s32* idx, const c8* bufEnd, u32 vbsize, u32 vtsize, u32 vnsize);
 
 	void cleanUp();
 
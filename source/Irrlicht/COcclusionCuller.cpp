@@ -0,0 +1,489 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "COcclusionCuller.h"
+#include "ICameraSceneNode.h"
+#include "IMeshSceneNode.h"
+#include "IAnimatedMeshSceneNode.h"
+#include "IAnimatedMesh.h"
+#include "IMeshBuffer.h"
+#include "SViewFrustum.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+COcclusionCuller::COcclusionCuller()
+: NearValue(1.f), Orthogonal(false),
+	RasterizedTriangles(0), TestedCount(0), OccludedCount(0)
+{
+	#ifdef _DEBUG
+	setDebugName("COcclusionCuller");
+	#endif
+
+	setResolution(core::dimension2du(256, 128));
+}
+
+
+//! destructor
+COcclusionCuller::~COcclusionCuller()
+{
+	removeAllOccluders();
+}
+
+
+//! Adds a scene node whose geometry hides nodes behind it.
+bool COcclusionCuller::addOccluder(ISceneNode* node, IMesh* mesh)
+{
+	if (!node)
+		return false;
+
+	if (!mesh)
+	{
+		const ESCENE_NODE_TYPE type = node->getType();
+		if (type == ESNT_MESH || type == ESNT_OCTREE || type == ESNT_CUBE || type == ESNT_SPHERE)
+			mesh = static_cast<IMeshSceneNode*>(node)->getMesh();
+		else if (type == ESNT_ANIMATED_MESH)
+		{
+			IAnimatedMesh* animatedMesh = static_cast<IAnimatedMeshSceneNode*>(node)->getMesh();
+			if (animatedMesh)
+				mesh = animatedMesh->getMesh(0);
+		}
+	}
+
+	if (!mesh)
+	{
+		os::Printer::log("Occluder needs a mesh", ELL_WARNING);
+		return false;
+	}
+
+	Occluders.push_back(SOccluder());
+	SOccluder& occluder = Occluders.getLast();
+	occluder.Node = node;
+
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		if (mb->getPrimitiveType() != EPT_TRIANGLES)
+			continue;
+
+		const u32 first = occluder.Positions.size();
+		for (u32 i=0; i<mb->getVertexCount(); ++i)
+			occluder.Positions.push_back(mb->getPosition(i));
+
+		const u32 indexCount = mb->getIndexCount();
+		occluder.Indices.reallocate(occluder.Indices.size() + indexCount);
+		if (mb->getIndexType() == video::EIT_16BIT)
+		{
+			const u16* indices = mb->getIndices();
+			for (u32 i=0; i<indexCount; ++i)
+				occluder.Indices.push_back(first + indices[i]);
+		}
+		else
+		{
+			const u32* indices = (const u32*)mb->getIndices();
+			for (u32 i=0; i<indexCount; ++i)
+				occluder.Indices.push_back(first + indices[i]);
+		}
+	}
+
+	if (occluder.Indices.size() < 3)
+	{
+		Occluders.erase(Occluders.size()-1);
+		return false;
+	}
+
+	node->grab();
+	return true;
+}
+
+
+//! Removes all occluders of a scene node.
+void COcclusionCuller::removeOccluder(ISceneNode* node)
+{
+	for (u32 i=0; i<Occluders.size(); )
+	{
+		if (Occluders[i].Node == node)
+		{
+			node->drop();
+			Occluders.erase(i);
+		}
+		else
+			++i;
+	}
+}
+
+
+//! Removes all occluders.
+void COcclusionCuller::removeAllOccluders()
+{
+	for (u32 i=0; i<Occluders.size(); ++i)
+		Occluders[i].Node->drop();
+	Occluders.clear();
+	RasterizedTriangles = 0;
+}
+
+
+//! Sets the size of the depth buffer.
+void COcclusionCuller::setResolution(const core::dimension2du& size)
+{
+	Size.Width = core::max_(size.Width, 1u);
+	Size.Height = core::max_(size.Height, 1u);
+
+	// each level has half the size of the one before, until 1x1
+	Levels.clear();
+	SLevel level;
+	level.Width = Size.Width;
+	level.Height = Size.Height;
+	level.Offset = 0;
+	while (true)
+	{
+		Levels.push_back(level);
+		if (level.Width == 1 && level.Height == 1)
+			break;
+
+		level.Offset += level.Width * level.Height;
+		level.Width = (level.Width + 1) / 2;
+		level.Height = (level.Height + 1) / 2;
+	}
+
+	const u32 texels = level.Offset + 1;
+	MinDepth.set_used(texels);
+	MaxDepth.set_used(texels);
+	RasterizedTriangles = 0;
+}
+
+
+//! Renders the occluders as seen by a camera.
+void COcclusionCuller::update(const ICameraSceneNode* camera)
+{
+	TestedCount = 0;
+	OccludedCount = 0;
+	RasterizedTriangles = 0;
+
+	// nodes removed from the scene have no parent anymore, release them
+	for (u32 o=0; o<Occluders.size(); )
+	{
+		if (!Occluders[o].Node->getParent())
+		{
+			Occluders[o].Node->drop();
+			Occluders.erase(o);
+		}
+		else
+			++o;
+	}
+
+	if (!camera || Occluders.empty())
+		return;
+
+	const SViewFrustum* frustum = camera->getViewFrustum();
+	ViewProjection = frustum->getTransform(video::ETS_PROJECTION);
+	ViewProjection *= frustum->getTransform(video::ETS_VIEW);
+	NearValue = camera->getNearValue();
+	Orthogonal = camera->isOrthogonal();
+
+	const u32 texels = Size.Width * Size.Height;
+	for (u32 i=0; i<texels; ++i)
+		MaxDepth[i] = FLT_MAX;
+
+	for (u32 o=0; o<Occluders.size(); ++o)
+	{
+		const SOccluder& occluder = Occluders[o];
+		if (!occluder.Node->isTrulyVisible())
+			continue;
+
+		core::matrix4 transform(ViewProjection);
+		transform *= occluder.Node->getAbsoluteTransformation();
+
+		const u32 vertexCount = occluder.Positions.size();
+		ClipVertices.set_used(vertexCount);
+		for (u32 i=0; i<vertexCount; ++i)
+			transform.transformVect(&ClipVertices[i].X, occluder.Positions[i]);
+
+		const u32* indices = occluder.Indices.const_pointer();
+		for (u32 i=0; i+2<occluder.Indices.size(); i+=3)
+		{
+			if (indices[i] >= vertexCount || indices[i+1] >= vertexCount || indices[i+2] >= vertexCount)
+				continue;
+
+			const SClipVertex& a = ClipVertices[indices[i]];
+			const SClipVertex& b = ClipVertices[indices[i+1]];
+			const SClipVertex& c = ClipVertices[indices[i+2]];
+
+			// completely outside of one side of the view
+			if ((a.X > a.W && b.X > b.W && c.X > c.W) ||
+				(a.X < -a.W && b.X < -b.W && c.X < -c.W) ||
+				(a.Y > a.W && b.Y > b.W && c.Y > c.W) ||
+				(a.Y < -a.W && b.Y < -b.W && c.Y < -c.W))
+				continue;
+
+			drawTriangle(a, b, c);
+		}
+	}
+
+	if (RasterizedTriangles)
+		buildPyramid();
+}
+
+
+//! clips a triangle at the near plane and rasterizes it
+void COcclusionCuller::drawTriangle(const SClipVertex& a, const SClipVertex& b, const SClipVertex& c)
+{
+	if (Orthogonal || (a.W >= NearValue && b.W >= NearValue && c.W >= NearValue))
+	{
+		rasterize(toScreen(a), toScreen(b), toScreen(c));
+		return;
+	}
+
+	// clip the polygon at w == near
+	const SClipVertex* in[3] = { &a, &b, &c };
+	SClipVertex out[4];
+	u32 count = 0;
+
+	for (u32 i=0; i<3; ++i)
+	{
+		const SClipVertex& p = *in[i];
+		const SClipVertex& q = *in[(i+1)%3];
+		const bool pInside = p.W >= NearValue;
+		const bool qInside = q.W >= NearValue;
+
+		if (pInside)
+			out[count++] = p;
+
+		if (pInside != qInside)
+		{
+			const f32 t = (NearValue - p.W) / (q.W - p.W);
+			SClipVertex& v = out[count++];
+			v.X = p.X + (q.X - p.X) * t;
+			v.Y = p.Y + (q.Y - p.Y) * t;
+			v.Z = p.Z + (q.Z - p.Z) * t;
+			v.W = NearValue;
+		}
+	}
+
+	if (count < 3)
+		return;
+
+	const core::vector3df v0 = toScreen(out[0]);
+	rasterize(v0, toScreen(out[1]), toScreen(out[2]));
+	if (count == 4)
+		rasterize(v0, toScreen(out[2]), toScreen(out[3]));
+}
+
+
+//! projects a vertex from clip space to the depth buffer
+core::vector3df COcclusionCuller::toScreen(const SClipVertex& v) const
+{
+	const f32 invW = core::reciprocal(v.W);
+	return core::vector3df(
+		(v.X * invW * 0.5f + 0.5f) * Size.Width,
+		(0.5f - v.Y * invW * 0.5f) * Size.Height,
+		v.Z * invW);
+}
+
+
+//! rasterizes a triangle in screen space, keeping the nearest depth
+void COcclusionCuller::rasterize(const core::vector3df& v0, const core::vector3df& v1, const core::vector3df& v2)
+{
+	f32 area = (v1.X - v0.X) * (v2.Y - v0.Y) - (v2.X - v0.X) * (v1.Y - v0.Y);
+	if (core::iszero(area))
+		return;
+
+	// occluders are drawn from both sides, flip to positive area
+	const core::vector3df* p[3] = { &v0, &v1, &v2 };
+	if (area < 0.f)
+	{
+		p[1] = &v2;
+		p[2] = &v1;
+		area = -area;
+	}
+
+	// pixels whose centers are inside of the bounding rectangle
+	const s32 x0 = core::max_((s32)floorf(core::min_(v0.X, v1.X, v2.X) - 0.5f) + 1, 0);
+	const s32 y0 = core::max_((s32)floorf(core::min_(v0.Y, v1.Y, v2.Y) - 0.5f) + 1, 0);
+	const s32 x1 = core::min_((s32)floorf(core::max_(v0.X, v1.X, v2.X) - 0.5f), (s32)Size.Width - 1);
+	const s32 y1 = core::min_((s32)floorf(core::max_(v0.Y, v1.Y, v2.Y) - 0.5f), (s32)Size.Height - 1);
+	if (x0 > x1 || y0 > y1)
+		return;
+
+	++RasterizedTriangles;
+
+	// edge functions, positive on the inner side of each edge
+	f32 stepX[3], stepY[3], start[3];
+	const f32 px = x0 + 0.5f;
+	const f32 py = y0 + 0.5f;
+	for (u32 i=0; i<3; ++i)
+	{
+		const core::vector3df& a = *p[(i+1)%3];
+		const core::vector3df& b = *p[(i+2)%3];
+		stepX[i] = a.Y - b.Y;
+		stepY[i] = b.X - a.X;
+		start[i] = (b.X - a.X) * (py - a.Y) - (b.Y - a.Y) * (px - a.X);
+	}
+
+	// depth is linear in screen space, the edge functions are the barycentric weights
+	const f32 invArea = core::reciprocal(area);
+	const f32 zStepX = (stepX[0] * p[0]->Z + stepX[1] * p[1]->Z + stepX[2] * p[2]->Z) * invArea;
+	const f32 zStepY = (stepY[0] * p[0]->Z + stepY[1] * p[1]->Z + stepY[2] * p[2]->Z) * invArea;
+	const f32 zStart = (start[0] * p[0]->Z + start[1] * p[1]->Z + start[2] * p[2]->Z) * invArea;
+
+	const s32 count = x1 - x0 + 1;
+	for (s32 y=y0; y<=y1; ++y)
+	{
+		const f32 dy = (f32)(y - y0);
+		const f32 e0 = start[0] + stepY[0] * dy;
+		const f32 e1 = start[1] + stepY[1] * dy;
+		const f32 e2 = start[2] + stepY[2] * dy;
+		const f32 z = zStart + zStepY * dy;
+
+		f32* row = MaxDepth.pointer() + y * Size.Width + x0;
+
+		// no branches, so the compiler can vectorize the span
+		for (s32 x=0; x<count; ++x)
+		{
+			const f32 dx = (f32)x;
+			const bool inside = (e0 + stepX[0] * dx >= 0.f) &
+				(e1 + stepX[1] * dx >= 0.f) & (e2 + stepX[2] * dx >= 0.f);
+			const f32 depth = z + zStepX * dx;
+			row[x] = (inside & (depth < row[x])) ? depth : row[x];
+		}
+	}
+}
+
+
+//! builds the levels of the depth pyramid from the depth buffer
+void COcclusionCuller::buildPyramid()
+{
+	const u32 texels = Size.Width * Size.Height;
+	memcpy(MinDepth.pointer(), MaxDepth.const_pointer(), texels * sizeof(f32));
+
+	for (u32 l=1; l<Levels.size(); ++l)
+	{
+		const SLevel& src = Levels[l-1];
+		const SLevel& dst = Levels[l];
+
+		for (u32 y=0; y<dst.Height; ++y)
+		{
+			// odd sizes repeat the last row and column
+			const u32 sy0 = src.Offset + (y*2) * src.Width;
+			const u32 sy1 = src.Offset + core::min_(y*2+1, src.Height-1) * src.Width;
+
+			for (u32 x=0; x<dst.Width; ++x)
+			{
+				const u32 sx0 = x*2;
+				const u32 sx1 = core::min_(x*2+1, src.Width-1);
+				const u32 d = dst.Offset + y * dst.Width + x;
+
+				MaxDepth[d] = core::max_(
+					core::max_(MaxDepth[sy0+sx0], MaxDepth[sy0+sx1]),
+					core::max_(MaxDepth[sy1+sx0], MaxDepth[sy1+sx1]));
+				MinDepth[d] = core::min_(
+					core::min_(MinDepth[sy0+sx0], MinDepth[sy0+sx1]),
+					core::min_(MinDepth[sy1+sx0], MinDepth[sy1+sx1]));
+			}
+		}
+	}
+}
+
+
+//! Checks if a box is hidden by the occluders.
+bool COcclusionCuller::isOccluded(const core::aabbox3df& box) const
+{
+	++TestedCount;
+
+	if (!RasterizedTriangles)
+		return false;
+
+	core::vector3df edges[8];
+	box.getEdges(edges);
+
+	f32 minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+	f32 maxX = -FLT_MAX, maxY = -FLT_MAX, maxZ = -FLT_MAX;
+	for (u32 i=0; i<8; ++i)
+	{
+		SClipVertex v;
+		ViewProjection.transformVect(&v.X, edges[i]);
+
+		// boxes cut by the near plane are always visible
+		if (!Orthogonal && v.W < NearValue)
+			return false;
+
+		const core::vector3df s = toScreen(v);
+		minX = core::min_(minX, s.X);
+		minY = core::min_(minY, s.Y);
+		minZ = core::min_(minZ, s.Z);
+		maxX = core::max_(maxX, s.X);
+		maxY = core::max_(maxY, s.Y);
+		maxZ = core::max_(maxZ, s.Z);
+	}
+
+	// culling boxes outside of the view is left to the frustum tests
+	const s32 x0 = core::max_((s32)floorf(minX), 0);
+	const s32 y0 = core::max_((s32)floorf(minY), 0);
+	const s32 x1 = core::min_((s32)floorf(maxX), (s32)Size.Width - 1);
+	const s32 y1 = core::min_((s32)floorf(maxY), (s32)Size.Height - 1);
+	if (x0 > x1 || y0 > y1)
+		return false;
+
+	// coarsest level on which the rectangle covers at most 2x2 texels
+	u32 level = 0;
+	while (level+1 < Levels.size() &&
+		(((x1 >> level) - (x0 >> level)) > 1 || ((y1 >> level) - (y0 >> level)) > 1))
+		++level;
+
+	if (isOccludedAtLevel(level, x0, y0, x1, y1, minZ))
+	{
+		++OccludedCount;
+		return true;
+	}
+
+	// in front of everything in the rectangle, finer levels can't hide it
+	const SLevel& coarse = Levels[level];
+	bool inFront = true;
+	for (s32 y=(y0 >> level); y<=(y1 >> level) && inFront; ++y)
+		for (s32 x=(x0 >> level); x<=(x1 >> level); ++x)
+			if (maxZ >= MinDepth[coarse.Offset + y * coarse.Width + x])
+			{
+				inFront = false;
+				break;
+			}
+	if (inFront)
+		return false;
+
+	// finer levels are closer to the occluder outlines
+	for (u32 l=1; l<=2 && l<=level; ++l)
+	{
+		if (isOccludedAtLevel(level-l, x0, y0, x1, y1, minZ))
+		{
+			++OccludedCount;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+//! tests the screen rectangle of a box against a level of the pyramid
+bool COcclusionCuller::isOccludedAtLevel(u32 level, s32 x0, s32 y0, s32 x1, s32 y1, f32 minZ) const
+{
+	const SLevel& l = Levels[level];
+	for (s32 y=(y0 >> level); y<=(y1 >> level); ++y)
+	{
+		const f32* row = MaxDepth.const_pointer() + l.Offset + y * l.Width;
+		for (s32 x=(x0 >> level); x<=(x1 >> level); ++x)
+		{
+			if (minZ <= row[x])
+				return false;
+		}
+	}
+	return true;
+}
+
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,121 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_OCCLUSION_CULLER_H_INCLUDED__
+#define __C_OCCLUSION_CULLER_H_INCLUDED__
+
+#include "IOcclusionCuller.h"
+#include "irrArray.h"
+#include "matrix4.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Occlusion culling with a hierarchical depth buffer rendered on the CPU.
+	class COcclusionCuller : public IOcclusionCuller
+	{
+	public:
+
+		//! constructor
+		COcclusionCuller();
+
+		//! destructor
+		virtual ~COcclusionCuller();
+
+		//! Adds a scene node whose geometry hides nodes behind it.
+		virtual bool addOccluder(ISceneNode* node, IMesh* mesh=0) _IRR_OVERRIDE_;
+
+		//! Removes all occluders of a scene node.
+		virtual void removeOccluder(ISceneNode* node) _IRR_OVERRIDE_;
+
+		//! Removes all occluders.
+		virtual void removeAllOccluders() _IRR_OVERRIDE_;
+
+		//! Returns the number of occluders.
+		virtual u32 getOccluderCount() const _IRR_OVERRIDE_ { return Occluders.size(); }
+
+		//! Sets the size of the depth buffer.
+		virtual void setResolution(const core::dimension2du& size) _IRR_OVERRIDE_;
+
+		//! Returns the size of the depth buffer.
+		virtual const core::dimension2du& getResolution() const _IRR_OVERRIDE_ { return Size; }
+
+		//! Renders the occluders as seen by a camera.
+		virtual void update(const ICameraSceneNode* camera) _IRR_OVERRIDE_;
+
+		//! Checks if a box is hidden by the occluders.
+		virtual bool isOccluded(const core::aabbox3df& box) const _IRR_OVERRIDE_;
+
+		//! Returns how many boxes were tested since the last update.
+		virtual u32 getTestedCount() const _IRR_OVERRIDE_ { return TestedCount; }
+
+		//! Returns how many boxes were occluded since the last update.
+		virtual u32 getOccludedCount() const _IRR_OVERRIDE_ { return OccludedCount; }
+
+		//! Returns how many occluder triangles were rasterized by the last update.
+		virtual u32 getRasterizedTriangleCount() const _IRR_OVERRIDE_ { return RasterizedTriangles; }
+
+	private:
+
+		struct SOccluder
+		{
+			ISceneNode* Node;
+			core::array<core::vector3df> Positions;
+			core::array<u32> Indices;
+		};
+
+		//! vertex in clip space
+		struct SClipVertex
+		{
+			f32 X, Y, Z, W;
+		};
+
+		//! a level of the depth pyramid
+		struct SLevel
+		{
+			u32 Width;
+			u32 Height;
+			u32 Offset;
+		};
+
+		//! clips a triangle at the near plane and rasterizes it
+		void drawTriangle(const SClipVertex& a, const SClipVertex& b, const SClipVertex& c);
+
+		//! rasterizes a triangle in screen space, keeping the nearest depth
+		void rasterize(const core::vector3df& v0, const core::vector3df& v1, const core::vector3df& v2);
+
+		//! projects a vertex from clip space to the depth buffer
+		core::vector3df toScreen(const SClipVertex& v) const;
+
+		//! builds the levels of the depth pyramid from the depth buffer
+		void buildPyramid();
+
+		//! tests the screen rectangle of a box against a level of the pyramid
+		bool isOccludedAtLevel(u32 level, s32 x0, s32 y0, s32 x1, s32 y1, f32 minZ) const;
+
+		core::array<SOccluder> Occluders;
+
+		//! nearest and farthest depth of each texel, all levels after each other
+		core::array<f32> MinDepth;
+		core::array<f32> MaxDepth;
+		core::array<SLevel> Levels;
+
+		core::array<SClipVertex> ClipVertices;
+
+		core::matrix4 ViewProjection;
+		core::dimension2du Size;
+		f32 NearValue;
+		bool Orthogonal;
+
+		u32 RasterizedTriangles;
+		mutable u32 TestedCount;
+		mutable u32 OccludedCount;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
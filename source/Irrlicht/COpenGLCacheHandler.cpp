@@ -18,7 +18,9 @@ namespace video
 COpenGLCacheHandler::COpenGLCacheHandler(COpenGLDriver* driver) :
 	COpenGLCoreCacheHandler<COpenGLDriver, COpenGLTexture>(driver), AlphaMode(GL_ALWAYS), AlphaRef(0.f), AlphaTest(false),
 	MatrixMode(GL_MODELVIEW), ClientActiveTexture(GL_TEXTURE0), ClientStateVertex(false),
-	ClientStateNormal(false), ClientStateColor(false), ClientStateTexCoord0(false)
+	ClientStateNormal(false), ClientStateColor(false), ClientStateTexCoord0(false), ColorMaterialMode(GL_AMBIENT_AND_DIFFUSE),
+	MaterialShininess(0.f), LightModelColorControl(0), ShadeModel(GL_SMOOTH), PolygonMode(GL_FILL), PolygonOffsetFactor(0.f),
+	PolygonOffsetUnits(0.f), PointSize(1.f), LineWidth(1.f)
 {
 	// Initial OpenGL values from specification.
 
@@ -33,6 +35,46 @@ COpenGLCacheHandler::COpenGLCacheHandler(COpenGLDriver* driver) :
 	glDisableClientState(GL_NORMAL_ARRAY);
 	glDisableClientState(GL_COLOR_ARRAY);
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	const GLenum capabilities[CAPABILITY_COUNT] = { GL_LIGHTING, GL_FOG, GL_NORMALIZE, GL_COLOR_MATERIAL,
+		GL_POLYGON_OFFSET_FILL, GL_POLYGON_OFFSET_LINE, GL_POLYGON_OFFSET_POINT, GL_LINE_SMOOTH, GL_POINT_SMOOTH,
+		GL_MULTISAMPLE_ARB, GL_SAMPLE_ALPHA_TO_COVERAGE_ARB };
+
+	for (u32 i = 0; i < CAPABILITY_COUNT; ++i)
+	{
+		CapabilityName[i] = capabilities[i];
+		CapabilityEnabled[i] = false;
+
+		// multisample capabilities depend on an extension and the context, they are set on first use
+		CapabilityValid[i] = (capabilities[i] != GL_MULTISAMPLE_ARB && capabilities[i] != GL_SAMPLE_ALPHA_TO_COVERAGE_ARB);
+
+		if (CapabilityValid[i])
+			glDisable(capabilities[i]);
+	}
+
+	glColorMaterial(GL_FRONT_AND_BACK, ColorMaterialMode);
+
+	const GLfloat colors[MATERIAL_COLOR_COUNT][4] = { {0.2f, 0.2f, 0.2f, 1.f}, {0.8f, 0.8f, 0.8f, 1.f},
+		{0.f, 0.f, 0.f, 1.f}, {0.f, 0.f, 0.f, 1.f} };
+	const GLenum colorNames[MATERIAL_COLOR_COUNT] = { GL_AMBIENT, GL_DIFFUSE, GL_SPECULAR, GL_EMISSION };
+
+	for (u32 i = 0; i < MATERIAL_COLOR_COUNT; ++i)
+	{
+		for (u32 j = 0; j < 4; ++j)
+			MaterialColor[i][j] = colors[i][j];
+		MaterialColorValid[i] = true;
+
+		glMaterialfv(GL_FRONT_AND_BACK, colorNames[i], MaterialColor[i]);
+	}
+
+	glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, MaterialShininess);
+	glShadeModel(ShadeModel);
+
+	glPolygonMode(GL_FRONT_AND_BACK, PolygonMode);
+	glPolygonOffset(PolygonOffsetFactor, PolygonOffsetUnits);
+
+	glPointSize(PointSize);
+	glLineWidth(LineWidth);
 }
 
 COpenGLCacheHandler::~COpenGLCacheHandler()
@@ -43,29 +85,37 @@ void COpenGLCacheHandler::setAlphaFunc(GLenum mode, GLclampf ref)
 {
 	if (AlphaMode != mode || AlphaRef != ref)
 	{
+		++StateCallsIssued;
 		glAlphaFunc(mode, ref);
 
 		AlphaMode = mode;
 		AlphaRef = ref;
 	}
+	else
+		++StateCallsSkipped;
 }
 
 void COpenGLCacheHandler::setAlphaTest(bool enable)
 {
 	if (AlphaTest != enable)
 	{
+		++StateCallsIssued;
 		if (enable)
 			glEnable(GL_ALPHA_TEST);
 		else
 			glDisable(GL_ALPHA_TEST);
 		AlphaTest = enable;
 	}
+	else
+		++StateCallsSkipped;
 }
 
 void COpenGLCacheHandler::setClientState(bool vertex, bool normal, bool color, bool texCoord0)
 {
 	if (ClientStateVertex != vertex)
 	{
+		++StateCallsIssued;
+
 		if (vertex)
 			glEnableClientState(GL_VERTEX_ARRAY);
 		else
@@ -73,9 +123,13 @@ void COpenGLCacheHandler::setClientState(bool vertex, bool normal, bool color, b
 
 		ClientStateVertex = vertex;
 	}
+	else
+		++StateCallsSkipped;
 
 	if (ClientStateNormal != normal)
 	{
+		++StateCallsIssued;
+
 		if (normal)
 			glEnableClientState(GL_NORMAL_ARRAY);
 		else
@@ -83,9 +137,13 @@ void COpenGLCacheHandler::setClientState(bool vertex, bool normal, bool color, b
 
 		ClientStateNormal = normal;
 	}
+	else
+		++StateCallsSkipped;
 
 	if (ClientStateColor != color)
 	{
+		++StateCallsIssued;
+
 		if (color)
 			glEnableClientState(GL_COLOR_ARRAY);
 		else
@@ -93,9 +151,13 @@ void COpenGLCacheHandler::setClientState(bool vertex, bool normal, bool color, b
 
 		ClientStateColor = color;
 	}
+	else
+		++StateCallsSkipped;
 
 	if (ClientStateTexCoord0 != texCoord0)
 	{
+		++StateCallsIssued;
+
 		setClientActiveTexture(GL_TEXTURE0_ARB);
 
 		if (texCoord0)
@@ -105,24 +167,246 @@ void COpenGLCacheHandler::setClientState(bool vertex, bool normal, bool color, b
 
 		ClientStateTexCoord0 = texCoord0;
 	}
+	else
+		++StateCallsSkipped;
 }
 
 void COpenGLCacheHandler::setMatrixMode(GLenum mode)
 {
 	if (MatrixMode != mode)
 	{
+		++StateCallsIssued;
 		glMatrixMode(mode);
 		MatrixMode = mode;
 	}
+	else
+		++StateCallsSkipped;
 }
 
 void COpenGLCacheHandler::setClientActiveTexture(GLenum texture)
 {
 	if (ClientActiveTexture != texture)
 	{
+		++StateCallsIssued;
 		Driver->irrGlClientActiveTexture(texture);
 		ClientActiveTexture = texture;
 	}
+	else
+		++StateCallsSkipped;
+}
+
+void COpenGLCacheHandler::setEnabled(GLenum cap, bool enable)
+{
+	const s32 index = getCapabilityIndex(cap);
+
+	if (index < 0 || !CapabilityValid[index] || CapabilityEnabled[index] != enable)
+	{
+		++StateCallsIssued;
+
+		if (enable)
+			glEnable(cap);
+		else
+			glDisable(cap);
+
+		if (index >= 0)
+		{
+			CapabilityEnabled[index] = enable;
+			CapabilityValid[index] = true;
+		}
+
+		if (cap == GL_COLOR_MATERIAL && enable)
+			invalidateColorMaterial();
+	}
+	else
+		++StateCallsSkipped;
+}
+
+void COpenGLCacheHandler::setColorMaterial(GLenum mode)
+{
+	if (ColorMaterialMode != mode)
+	{
+		++StateCallsIssued;
+		glColorMaterial(GL_FRONT_AND_BACK, mode);
+		ColorMaterialMode = mode;
+
+		invalidateColorMaterial();
+	}
+	else
+		++StateCallsSkipped;
+}
+
+void COpenGLCacheHandler::setMaterialColor(GLenum pname, const GLfloat* color)
+{
+	s32 index = -1;
+
+	switch (pname)
+	{
+	case GL_AMBIENT:
+		index = 0;
+		break;
+	case GL_DIFFUSE:
+		index = 1;
+		break;
+	case GL_SPECULAR:
+		index = 2;
+		break;
+	case GL_EMISSION:
+		index = 3;
+		break;
+	}
+
+	bool changed = (index < 0 || !MaterialColorValid[index]);
+
+	for (u32 i = 0; !changed && i < 4; ++i)
+		changed = (MaterialColor[index][i] != color[i]);
+
+	if (changed)
+	{
+		++StateCallsIssued;
+		glMaterialfv(GL_FRONT_AND_BACK, pname, color);
+
+		if (index >= 0)
+		{
+			for (u32 i = 0; i < 4; ++i)
+				MaterialColor[index][i] = color[i];
+
+			// overwritten by the next vertex color
+			MaterialColorValid[index] = !isColorMaterialTracked(index);
+		}
+	}
+	else
+		++StateCallsSkipped;
+}
+
+void COpenGLCacheHandler::setMaterialShininess(GLfloat shininess)
+{
+	if (MaterialShininess != shininess)
+	{
+		++StateCallsIssued;
+		glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, shininess);
+		MaterialShininess = shininess;
+	}
+	else
+		++StateCallsSkipped;
+}
+
+void COpenGLCacheHandler::setLightModelColorControl(GLint mode)
+{
+#ifdef GL_EXT_separate_specular_color
+	if (LightModelColorControl != mode)
+	{
+		++StateCallsIssued;
+		glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL, mode);
+		LightModelColorControl = mode;
+	}
+	else
+		++StateCallsSkipped;
+#endif
+}
+
+void COpenGLCacheHandler::setShadeModel(GLenum mode)
+{
+	if (ShadeModel != mode)
+	{
+		++StateCallsIssued;
+		glShadeModel(mode);
+		ShadeModel = mode;
+	}
+	else
+		++StateCallsSkipped;
+}
+
+void COpenGLCacheHandler::setPolygonMode(GLenum mode)
+{
+	if (PolygonMode != mode)
+	{
+		++StateCallsIssued;
+		glPolygonMode(GL_FRONT_AND_BACK, mode);
+		PolygonMode = mode;
+	}
+	else
+		++StateCallsSkipped;
+}
+
+void COpenGLCacheHandler::setPolygonOffset(GLfloat factor, GLfloat units)
+{
+	if (PolygonOffsetFactor != factor || PolygonOffsetUnits != units)
+	{
+		++StateCallsIssued;
+		glPolygonOffset(factor, units);
+		PolygonOffsetFactor = factor;
+		PolygonOffsetUnits = units;
+	}
+	else
+		++StateCallsSkipped;
+}
+
+void COpenGLCacheHandler::setPointSize(GLfloat size)
+{
+	if (PointSize != size)
+	{
+		++StateCallsIssued;
+		glPointSize(size);
+		PointSize = size;
+	}
+	else
+		++StateCallsSkipped;
+}
+
+void COpenGLCacheHandler::setLineWidth(GLfloat width)
+{
+	if (LineWidth != width)
+	{
+		++StateCallsIssued;
+		glLineWidth(width);
+		LineWidth = width;
+	}
+	else
+		++StateCallsSkipped;
+}
+
+s32 COpenGLCacheHandler::getCapabilityIndex(GLenum cap) const
+{
+	for (u32 i = 0; i < CAPABILITY_COUNT; ++i)
+	{
+		if (CapabilityName[i] == cap)
+			return i;
+	}
+
+	return -1;
+}
+
+bool COpenGLCacheHandler::isColorMaterialTracked(u32 index) const
+{
+	const s32 capability = getCapabilityIndex(GL_COLOR_MATERIAL);
+
+	if (CapabilityValid[capability] && !CapabilityEnabled[capability])
+		return false;
+
+	switch (ColorMaterialMode)
+	{
+	case GL_AMBIENT:
+		return index == 0;
+	case GL_DIFFUSE:
+		return index == 1;
+	case GL_SPECULAR:
+		return index == 2;
+	case GL_EMISSION:
+		return index == 3;
+	case GL_AMBIENT_AND_DIFFUSE:
+		return index == 0 || index == 1;
+	}
+
+	return true;
+}
+
+void COpenGLCacheHandler::invalidateColorMaterial()
+{
+	for (u32 i = 0; i < MATERIAL_COLOR_COUNT; ++i)
+	{
+		if (isColorMaterialTracked(i))
+			MaterialColorValid[i] = false;
+	}
 }
 
 } // end namespace
@@ -44,7 +44,47 @@ namespace video
 
 		void setClientActiveTexture(GLenum texture);
 
+		// Capability calls.
+
+		//! Enable or disable a fixed pipeline or rasterization capability.
+		/** Shadowed are lighting, fog, normalize, color material, polygon
+		offset, smoothing and multisample capabilities. Others are passed
+		to OpenGL on each call. */
+		void setEnabled(GLenum cap, bool enable);
+
+		// Material calls.
+
+		void setColorMaterial(GLenum mode);
+
+		void setMaterialColor(GLenum pname, const GLfloat* color);
+
+		void setMaterialShininess(GLfloat shininess);
+
+		void setLightModelColorControl(GLint mode);
+
+		void setShadeModel(GLenum mode);
+
+		// Rasterization calls.
+
+		void setPolygonMode(GLenum mode);
+
+		void setPolygonOffset(GLfloat factor, GLfloat units);
+
+		void setPointSize(GLfloat size);
+
+		void setLineWidth(GLfloat width);
+
 	protected:
+		//! Returns the index of a shadowed capability, or -1.
+		s32 getCapabilityIndex(GLenum cap) const;
+
+		//! Returns true when the material color follows the vertex colors.
+		bool isColorMaterialTracked(u32 index) const;
+
+		//! Marks the material colors set by the vertex colors as unknown.
+		void invalidateColorMaterial();
+
+
 		GLenum AlphaMode;
 		GLclampf AlphaRef;
 		bool AlphaTest;
@@ -57,6 +97,34 @@ namespace video
 		bool ClientStateNormal;
 		bool ClientStateColor;
 		bool ClientStateTexCoord0;
+
+		enum
+		{
+			CAPABILITY_COUNT = 11,
+			MATERIAL_COLOR_COUNT = 4
+		};
+
+		GLenum CapabilityName[CAPABILITY_COUNT];
+		bool CapabilityEnabled[CAPABILITY_COUNT];
+		// false until the state is known, e.g. for capabilities not set at initialization
+		bool CapabilityValid[CAPABILITY_COUNT];
+
+		GLenum ColorMaterialMode;
+
+		// ambient, diffuse, specular and emission
+		GLfloat MaterialColor[MATERIAL_COLOR_COUNT][4];
+		bool MaterialColorValid[MATERIAL_COLOR_COUNT];
+		GLfloat MaterialShininess;
+
+		GLint LightModelColorControl;
+		GLenum ShadeModel;
+
+		GLenum PolygonMode;
+		GLfloat PolygonOffsetFactor;
+		GLfloat PolygonOffsetUnits;
+
+		GLfloat PointSize;
+		GLfloat LineWidth;
 	};
 
 } // end namespace video
@@ -75,6 +75,8 @@ class COpenGLCoreCacheHandler
 
 				if (texture != prevTexture)
 				{
+					++CacheHandler.StateCallsIssued;
+
 					if ( esa == EST_ACTIVE_ON_CHANGE )
 						CacheHandler.setActiveTexture(GL_TEXTURE0 + index);
 
@@ -130,6 +132,8 @@ class COpenGLCoreCacheHandler
 					if (prevTexture)
 						prevTexture->drop();
 				}
+				else
+					++CacheHandler.StateCallsSkipped;
 
 				status = true;
 			}
@@ -191,7 +195,7 @@ public:
 		FrameBufferCount(0), BlendEquation(0), BlendSourceRGB(0),
 		BlendDestinationRGB(0), BlendSourceAlpha(0), BlendDestinationAlpha(0), Blend(0), BlendEquationInvalid(false), BlendFuncInvalid(false), BlendInvalid(false),
 		ColorMask(0), ColorMaskInvalid(false), CullFaceMode(GL_BACK), CullFace(false), DepthFunc(GL_LESS), DepthMask(true), DepthTest(false), FrameBufferID(0),
-		ProgramID(0), ActiveTexture(GL_TEXTURE0), ViewportX(0), ViewportY(0)
+		ProgramID(0), ActiveTexture(GL_TEXTURE0), ViewportX(0), ViewportY(0), StateCallsIssued(0), StateCallsSkipped(0)
 	{
 		const COpenGLCoreFeature& feature = Driver->getFeature();
 
@@ -277,6 +281,7 @@ public:
 	{
 		if (BlendEquation[0] != mode || BlendEquationInvalid)
 		{
+			++StateCallsIssued;
 			Driver->irrGlBlendEquation(mode);
 
 			for (GLuint i = 0; i < FrameBufferCount; ++i)
@@ -284,17 +289,22 @@ public:
 
 			BlendEquationInvalid = false;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	void setBlendEquationIndexed(GLuint index, GLenum mode)
 	{
 		if (index < FrameBufferCount && BlendEquation[index] != mode)
 		{
+			++StateCallsIssued;
 			Driver->irrGlBlendEquationIndexed(index, mode);
 
 			BlendEquation[index] = mode;
 			BlendEquationInvalid = true;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	void setBlendFunc(GLenum source, GLenum destination)
@@ -303,6 +313,7 @@ public:
 			BlendSourceAlpha[0] != source || BlendDestinationAlpha[0] != destination ||
 			BlendFuncInvalid)
 		{
+			++StateCallsIssued;
 			glBlendFunc(source, destination);
 
 			for (GLuint i = 0; i < FrameBufferCount; ++i)
@@ -315,6 +326,8 @@ public:
 
 			BlendFuncInvalid = false;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	void setBlendFuncSeparate(GLenum sourceRGB, GLenum destinationRGB, GLenum sourceAlpha, GLenum destinationAlpha)
@@ -325,6 +338,7 @@ public:
 				BlendSourceAlpha[0] != sourceAlpha || BlendDestinationAlpha[0] != destinationAlpha ||
 				BlendFuncInvalid)
 			{
+				++StateCallsIssued;
 				Driver->irrGlBlendFuncSeparate(sourceRGB, destinationRGB, sourceAlpha, destinationAlpha);
 
 				for (GLuint i = 0; i < FrameBufferCount; ++i)
@@ -337,6 +351,8 @@ public:
 
 				BlendFuncInvalid = false;
 			}
+			else
+				++StateCallsSkipped;
 		}
 		else
 		{
@@ -349,6 +365,7 @@ public:
 		if (index < FrameBufferCount && (BlendSourceRGB[index] != source || BlendDestinationRGB[index] != destination ||
 			BlendSourceAlpha[index] != source || BlendDestinationAlpha[index] != destination))
 		{
+			++StateCallsIssued;
 			Driver->irrGlBlendFuncIndexed(index, source, destination);
 
 			BlendSourceRGB[index] = source;
@@ -357,6 +374,8 @@ public:
 			BlendDestinationAlpha[index] = destination;
 			BlendFuncInvalid = true;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	void setBlendFuncSeparateIndexed(GLuint index, GLenum sourceRGB, GLenum destinationRGB, GLenum sourceAlpha, GLenum destinationAlpha)
@@ -366,6 +385,7 @@ public:
 			if (index < FrameBufferCount && (BlendSourceRGB[index] != sourceRGB || BlendDestinationRGB[index] != destinationRGB ||
 				BlendSourceAlpha[index] != sourceAlpha || BlendDestinationAlpha[index] != destinationAlpha))
 			{
+				++StateCallsIssued;
 				Driver->irrGlBlendFuncSeparateIndexed(index, sourceRGB, destinationRGB, sourceAlpha, destinationAlpha);
 
 				BlendSourceRGB[index] = sourceRGB;
@@ -374,6 +394,8 @@ public:
 				BlendDestinationAlpha[index] = destinationAlpha;
 				BlendFuncInvalid = true;
 			}
+			else
+				++StateCallsSkipped;
 		}
 		else
 		{
@@ -385,6 +407,7 @@ public:
 	{
 		if (Blend[0] != enable || BlendInvalid)
 		{
+			++StateCallsIssued;
 			if (enable)
 				glEnable(GL_BLEND);
 			else
@@ -395,12 +418,15 @@ public:
 
 			BlendInvalid = false;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	void setBlendIndexed(GLuint index, bool enable)
 	{
 		if (index < FrameBufferCount && Blend[index] != enable)
 		{
+			++StateCallsIssued;
 			if (enable)
 				Driver->irrGlEnableIndexed(GL_BLEND, index);
 			else
@@ -409,6 +435,8 @@ public:
 			Blend[index] = enable;
 			BlendInvalid = true;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	// Color Mask.
@@ -422,6 +450,7 @@ public:
 	{
 		if (ColorMask[0] != mask || ColorMaskInvalid)
 		{
+			++StateCallsIssued;
 			glColorMask((mask & ECP_RED) ? GL_TRUE : GL_FALSE, (mask & ECP_GREEN) ? GL_TRUE : GL_FALSE, (mask & ECP_BLUE) ? GL_TRUE : GL_FALSE, (mask & ECP_ALPHA) ? GL_TRUE : GL_FALSE);
 
 			for (GLuint i = 0; i < FrameBufferCount; ++i)
@@ -429,17 +458,22 @@ public:
 
 			ColorMaskInvalid = false;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	void setColorMaskIndexed(GLuint index, u8 mask)
 	{
 		if (index < FrameBufferCount && ColorMask[index] != mask)
 		{
+			++StateCallsIssued;
 			Driver->irrGlColorMaskIndexed(index, (mask & ECP_RED) ? GL_TRUE : GL_FALSE, (mask & ECP_GREEN) ? GL_TRUE : GL_FALSE, (mask & ECP_BLUE) ? GL_TRUE : GL_FALSE, (mask & ECP_ALPHA) ? GL_TRUE : GL_FALSE);
 
 			ColorMask[index] = mask;
 			ColorMaskInvalid = true;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	// Cull face calls.
@@ -448,15 +482,19 @@ public:
 	{
 		if (CullFaceMode != mode)
 		{
+			++StateCallsIssued;
 			glCullFace(mode);
 			CullFaceMode = mode;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	void setCullFace(bool enable)
 	{
 		if (CullFace != enable)
 		{
+			++StateCallsIssued;
 			if (enable)
 				glEnable(GL_CULL_FACE);
 			else
@@ -464,6 +502,8 @@ public:
 
 			CullFace = enable;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	// Depth calls.
@@ -472,9 +512,12 @@ public:
 	{
 		if (DepthFunc != mode)
 		{
+			++StateCallsIssued;
 			glDepthFunc(mode);
 			DepthFunc = mode;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	void getDepthMask(bool& depth)
@@ -486,6 +529,7 @@ public:
 	{
 		if (DepthMask != enable)
 		{
+			++StateCallsIssued;
 			if (enable)
 				glDepthMask(GL_TRUE);
 			else
@@ -493,6 +537,8 @@ public:
 
 			DepthMask = enable;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
     void getDepthTest(bool& enable)
@@ -504,6 +550,7 @@ public:
 	{
 		if (DepthTest != enable)
 		{
+			++StateCallsIssued;
 			if (enable)
 				glEnable(GL_DEPTH_TEST);
 			else
@@ -511,6 +558,8 @@ public:
 
 			DepthTest = enable;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	// FBO calls.
@@ -524,9 +573,12 @@ public:
 	{
 		if (FrameBufferID != frameBufferID)
 		{
+			++StateCallsIssued;
 			Driver->irrGlBindFramebuffer(GL_FRAMEBUFFER, frameBufferID);
 			FrameBufferID = frameBufferID;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	// Shaders calls.
@@ -540,9 +592,12 @@ public:
 	{
 		if (ProgramID != programID)
 		{
+			++StateCallsIssued;
 			Driver->irrGlUseProgram(programID);
 			ProgramID = programID;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	// Texture calls.
@@ -556,9 +611,12 @@ public:
 	{
 		if (ActiveTexture != texture)
 		{
+			++StateCallsIssued;
 			Driver->irrGlActiveTexture(texture);
 			ActiveTexture = texture;
 		}
+		else
+			++StateCallsSkipped;
 	}
 
 	// Viewport calls.
@@ -575,12 +633,39 @@ public:
 	{
 		if (ViewportX != viewportX || ViewportY != viewportY || ViewportWidth != viewportWidth || ViewportHeight != viewportHeight)
 		{
+			++StateCallsIssued;
 			glViewport(viewportX, viewportY, viewportWidth, viewportHeight);
 			ViewportX = viewportX;
 			ViewportY = viewportY;
 			ViewportWidth = viewportWidth;
 			ViewportHeight = viewportHeight;
 		}
+		else
+			++StateCallsSkipped;
+	}
+
+	// Statistics.
+
+	//! Get the number of state changes sent to OpenGL and the number of calls skipped because the cache already had the value.
+	void getStateCalls(u32& issued, u32& skipped) const
+	{
+		issued = StateCallsIssued;
+		skipped = StateCallsSkipped;
+	}
+
+	//! Count a state change which is shadowed outside of the cache handler, e.g. shader uniforms.
+	void addStateCall(bool issued)
+	{
+		if (issued)
+			++StateCallsIssued;
+		else
+			++StateCallsSkipped;
+	}
+
+	void resetStateCalls()
+	{
+		StateCallsIssued = 0;
+		StateCallsSkipped = 0;
 	}
 
 	//! Compare material to current cache and update it when there are differences
@@ -636,6 +721,9 @@ protected:
 	GLint ViewportY;
 	GLsizei ViewportWidth;
 	GLsizei ViewportHeight;
+
+	u32 StateCallsIssued;
+	u32 StateCallsSkipped;
 };
 
 }
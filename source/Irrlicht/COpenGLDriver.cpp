@@ -97,6 +97,12 @@ COpenGLDriver::~COpenGLDriver()
 	deleteAllTextures();
 	removeAllOcclusionQueries();
 	removeAllHardwareBuffers();
+	for (u32 i=0; i<ESB_COUNT; ++i)
+	{
+		unmapStreamBuffer((E_STREAM_BUFFER)i);
+		resetStreamBuffer((E_STREAM_BUFFER)i);
+		deleteStreamBuffer((E_STREAM_BUFFER)i);
+	}
 
 	delete CacheHandler;
 
@@ -179,9 +185,10 @@ bool COpenGLDriver::genericDriverInit()
 	setAmbientLight(SColorf(0.0f,0.0f,0.0f,0.0f));
 #ifdef GL_EXT_separate_specular_color
 	if (FeatureAvailable[IRR_EXT_separate_specular_color])
-		glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL, GL_SEPARATE_SPECULAR_COLOR);
+		CacheHandler->setLightModelColorControl(GL_SEPARATE_SPECULAR_COLOR);
 #endif
 	glLightModeli(GL_LIGHT_MODEL_LOCAL_VIEWER, 1);
+	CacheHandler->addStateCall(true);
 
 	Params.HandleSRGB &= ((FeatureAvailable[IRR_ARB_framebuffer_sRGB] || FeatureAvailable[IRR_EXT_framebuffer_sRGB]) &&
 		FeatureAvailable[IRR_EXT_texture_sRGB]);
@@ -304,6 +311,13 @@ bool COpenGLDriver::endScene()
 {
 	CNullDriver::endScene();
 
+	u32 stateCallsIssued = 0;
+	u32 stateCallsSkipped = 0;
+	CacheHandler->getStateCalls(stateCallsIssued, stateCallsSkipped);
+	DriverAttributes->setAttribute("StateCallsIssued", (s32)stateCallsIssued);
+	DriverAttributes->setAttribute("StateCallsSkipped", (s32)stateCallsSkipped);
+	CacheHandler->resetStateCalls();
+
 	glFlush();
 
 	bool status = false;
@@ -356,12 +370,14 @@ void COpenGLDriver::setTransform(E_TRANSFORMATION_STATE state, const core::matri
 
 			// now the real model-view matrix
 			glMultMatrixf(Matrices[ETS_WORLD].pointer());
+			CacheHandler->addStateCall(true);
 		}
 		break;
 	case ETS_PROJECTION:
 		{
 			CacheHandler->setMatrixMode(GL_PROJECTION);
 			glLoadMatrixf(mat.pointer());
+			CacheHandler->addStateCall(true);
 		}
 		break;
 	default:
@@ -451,6 +467,7 @@ bool COpenGLDriver::updateVertexHardwareBuffer(SHWBufferLink_opengl *HWBuffer)
 	extGlBindBuffer(GL_ARRAY_BUFFER, HWBuffer->vbo_verticesID);
 
 	// copy data to graphics card
+	UploadedBytes += vertexCount * vertexSize;
 	if (!newBuffer)
 		extGlBufferSubData(GL_ARRAY_BUFFER, 0, vertexCount * vertexSize, vbuf);
 	else
@@ -525,6 +542,7 @@ bool COpenGLDriver::updateIndexHardwareBuffer(SHWBufferLink_opengl *HWBuffer)
 	extGlBindBuffer(GL_ELEMENT_ARRAY_BUFFER, HWBuffer->vbo_indicesID);
 
 	// copy data to graphics card
+	UploadedBytes += indexCount * indexSize;
 	if (!newBuffer)
 		extGlBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexCount * indexSize, indices);
 	else
@@ -593,8 +611,7 @@ COpenGLDriver::SHWBufferLink *COpenGLDriver::createHardwareBuffer(const scene::I
 
 	SHWBufferLink_opengl *HWBuffer=new SHWBufferLink_opengl(mb);
 
-	//add to map
-	HWBufferMap.insert(HWBuffer->MeshBuffer, HWBuffer);
+	addHardwareBuffer(HWBuffer);
 
 	HWBuffer->ChangedID_Vertex=HWBuffer->MeshBuffer->getChangedID_Vertex();
 	HWBuffer->ChangedID_Index=HWBuffer->MeshBuffer->getChangedID_Index();
@@ -975,6 +992,265 @@ void COpenGLDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCoun
 }
 
 
+//! Draws vertices and indices which were written to stream allocations.
+void COpenGLDriver::drawStreamedPrimitiveList(const SStreamAllocation& vertices, u32 vertexCount,
+		const SStreamAllocation& indices, u32 primitiveCount,
+		E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
+{
+	if (!hasHardwareStreams())
+	{
+		CNullDriver::drawStreamedPrimitiveList(vertices, vertexCount, indices, primitiveCount, vType, pType, iType);
+		return;
+	}
+
+	if (!vertices.Data || !indices.Data)
+		return;
+
+	unmapStreamBuffer(ESB_VERTEX);
+	unmapStreamBuffer(ESB_INDEX);
+
+	// with bound buffers the pointers are offsets into them
+	extGlBindBuffer(GL_ARRAY_BUFFER, StreamBuffersGL[ESB_VERTEX].Id);
+	extGlBindBuffer(GL_ELEMENT_ARRAY_BUFFER, StreamBuffersGL[ESB_INDEX].Id);
+
+	drawVertexPrimitiveList(buffer_offset(vertices.Offset), vertexCount, buffer_offset(indices.Offset), primitiveCount, vType, pType, iType);
+
+	extGlBindBuffer(GL_ARRAY_BUFFER, 0);
+	extGlBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+
+//! Draws streamed vertices with indices from client memory.
+void COpenGLDriver::drawStreamedPrimitiveList(const SStreamAllocation& vertices, u32 vertexCount,
+		const void* indexList, u32 primitiveCount,
+		E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
+{
+	if (!hasHardwareStreams())
+	{
+		CNullDriver::drawStreamedPrimitiveList(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType);
+		return;
+	}
+
+	if (!vertices.Data)
+		return;
+
+	unmapStreamBuffer(ESB_VERTEX);
+
+	extGlBindBuffer(GL_ARRAY_BUFFER, StreamBuffersGL[ESB_VERTEX].Id);
+	drawVertexPrimitiveList(buffer_offset(vertices.Offset), vertexCount, indexList, primitiveCount, vType, pType, iType);
+	extGlBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+
+//! true if streaming buffers are OpenGL buffers, otherwise they are emulated
+bool COpenGLDriver::hasHardwareStreams() const
+{
+	// colors are read from the buffer, so they can't be converted
+	return FeatureAvailable[IRR_ARB_vertex_buffer_object] &&
+		(FeatureAvailable[IRR_ARB_vertex_array_bgra] || FeatureAvailable[IRR_EXT_vertex_array_bgra]);
+}
+
+
+//! creates the OpenGL buffer of a streaming buffer
+bool COpenGLDriver::createStreamBuffer(E_STREAM_BUFFER buffer)
+{
+#if defined(GL_ARB_vertex_buffer_object)
+	SStreamBufferGL& stream = StreamBuffersGL[buffer];
+	const GLenum target = (buffer == ESB_VERTEX) ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
+	const u32 size = StreamBuffers[buffer].Size;
+
+	extGlGenBuffers(1, &stream.Id);
+	if (!stream.Id)
+		return false;
+
+	extGlBindBuffer(target, stream.Id);
+
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_map_buffer_range)
+	// map once and keep writing to it, fences are needed for that
+	if (FeatureAvailable[IRR_ARB_buffer_storage] && FeatureAvailable[IRR_ARB_map_buffer_range] && FeatureAvailable[IRR_ARB_sync])
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		extGlBufferStorage(target, size, 0, flags);
+		stream.Persistent = static_cast<u8*>(extGlMapBufferRange(target, 0, size, flags));
+
+		if (!stream.Persistent)
+		{
+			// storage is immutable, start again with a mutable one
+			extGlBindBuffer(target, 0);
+			extGlDeleteBuffers(1, &stream.Id);
+			extGlGenBuffers(1, &stream.Id);
+			if (!stream.Id)
+				return false;
+			extGlBindBuffer(target, stream.Id);
+		}
+	}
+#endif
+
+	if (!stream.Persistent)
+		extGlBufferData(target, size, 0, GL_STREAM_DRAW);
+
+	extGlBindBuffer(target, 0);
+
+	return (!testGLError(__LINE__));
+#else
+	return false;
+#endif
+}
+
+
+//! Returns memory to write a range of a streaming buffer to
+void* COpenGLDriver::mapStreamBuffer(E_STREAM_BUFFER buffer, u32 offset, u32 size)
+{
+	if (!hasHardwareStreams())
+		return CNullDriver::mapStreamBuffer(buffer, offset, size);
+
+	SStreamBufferGL& stream = StreamBuffersGL[buffer];
+	if (!stream.Id && !createStreamBuffer(buffer))
+		return 0;
+
+	if (stream.Persistent)
+		return stream.Persistent + offset;
+
+	void* data = 0;
+#if defined(GL_ARB_map_buffer_range)
+	if (FeatureAvailable[IRR_ARB_map_buffer_range])
+	{
+		const GLenum target = (buffer == ESB_VERTEX) ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
+		extGlBindBuffer(target, stream.Id);
+		// the ring makes sure that the GPU is done with this range
+		data = extGlMapBufferRange(target, offset, size,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		extGlBindBuffer(target, 0);
+		stream.Mapped = (data != 0);
+	}
+#endif
+
+	if (!data)
+	{
+		// upload with glBufferSubData when unmapped
+		stream.Staging.set_used(size);
+		stream.StagedOffset = offset;
+		stream.Staged = true;
+		data = stream.Staging.pointer();
+	}
+
+	return data;
+}
+
+
+//! Finishes writing to the memory returned by mapStreamBuffer
+void COpenGLDriver::unmapStreamBuffer(E_STREAM_BUFFER buffer)
+{
+	SStreamBufferGL& stream = StreamBuffersGL[buffer];
+	if (!stream.Mapped && !stream.Staged)
+		return;
+
+	const GLenum target = (buffer == ESB_VERTEX) ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
+	extGlBindBuffer(target, stream.Id);
+	if (stream.Mapped)
+		extGlUnmapBuffer(target);
+	else
+		extGlBufferSubData(target, stream.StagedOffset, stream.Staging.size(), stream.Staging.pointer());
+	extGlBindBuffer(target, 0);
+
+	stream.Mapped = false;
+	stream.Staged = false;
+}
+
+
+//! Continues in new memory, the GPU may still use the old one
+void COpenGLDriver::orphanStreamBuffer(E_STREAM_BUFFER buffer)
+{
+	SStreamBufferGL& stream = StreamBuffersGL[buffer];
+	if (!stream.Id)
+		return;
+
+	if (stream.Persistent)
+	{
+		// OpenGL keeps the storage of deleted buffers until they are not used anymore
+		deleteStreamBuffer(buffer);
+		createStreamBuffer(buffer);
+	}
+	else
+	{
+		const GLenum target = (buffer == ESB_VERTEX) ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
+		extGlBindBuffer(target, stream.Id);
+		extGlBufferData(target, StreamBuffers[buffer].Size, 0, GL_STREAM_DRAW);
+		extGlBindBuffer(target, 0);
+	}
+}
+
+
+//! Frees the memory of a streaming buffer
+void COpenGLDriver::deleteStreamBuffer(E_STREAM_BUFFER buffer)
+{
+	CNullDriver::deleteStreamBuffer(buffer);
+
+	SStreamBufferGL& stream = StreamBuffersGL[buffer];
+	if (!stream.Id)
+		return;
+
+	if (stream.Persistent)
+	{
+		const GLenum target = (buffer == ESB_VERTEX) ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
+		extGlBindBuffer(target, stream.Id);
+		extGlUnmapBuffer(target);
+		extGlBindBuffer(target, 0);
+		stream.Persistent = 0;
+	}
+
+	extGlDeleteBuffers(1, &stream.Id);
+	stream.Id = 0;
+	stream.Staging.clear();
+}
+
+
+//! Inserts a fence after all commands sent so far, false if fences are not supported
+bool COpenGLDriver::insertStreamFence(SStreamFence& fence)
+{
+	if (!hasHardwareStreams())
+		return CNullDriver::insertStreamFence(fence);
+
+#if defined(GL_ARB_sync)
+	if (FeatureAvailable[IRR_ARB_sync])
+	{
+		fence.Sync = extGlFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		return fence.Sync != 0;
+	}
+#endif
+	return false;
+}
+
+
+//! Checks if the GPU passed a fence, or waits for it when block is true
+bool COpenGLDriver::waitStreamFence(SStreamFence& fence, bool block)
+{
+	if (!hasHardwareStreams())
+		return CNullDriver::waitStreamFence(fence, block);
+
+#if defined(GL_ARB_sync)
+	if (!block)
+		return extGlClientWaitSync((GLsync)fence.Sync, 0, 0) != GL_TIMEOUT_EXPIRED;
+
+	// the flush makes sure that the fence is reached at all
+	while (extGlClientWaitSync((GLsync)fence.Sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+		;
+#endif
+	return true;
+}
+
+
+//! Deletes a fence object
+void COpenGLDriver::deleteStreamFence(SStreamFence& fence)
+{
+#if defined(GL_ARB_sync)
+	if (fence.Sync)
+		extGlDeleteSync((GLsync)fence.Sync);
+#endif
+	fence.Sync = 0;
+}
+
+
 void COpenGLDriver::getColorBuffer(const void* vertices, u32 vertexCount, E_VERTEX_TYPE vType)
 {
 	// convert colors to gl color format.
@@ -1077,7 +1353,7 @@ void COpenGLDriver::renderArray(const void* indexList, u32 primitiveCount,
 			extGlPointParameterf(GL_POINT_FADE_THRESHOLD_SIZE_SGIS, 1.0f);
 #endif
 #endif
-			glPointSize(particleSize);
+			CacheHandler->setPointSize(particleSize);
 
 #ifdef GL_ARB_point_sprite
 			if (pType == scene::EPT_POINT_SPRITES && FeatureAvailable[IRR_ARB_point_sprite])
@@ -1455,8 +1731,10 @@ void COpenGLDriver::draw2DImage(const video::ITexture* texture, u32 layer, bool
 
 	CacheHandler->setMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
+	CacheHandler->addStateCall(true);
 	CacheHandler->setMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
+	CacheHandler->addStateCall(true);
 
 	Transformation3DChanged = true;
 
@@ -2104,9 +2382,11 @@ void COpenGLDriver::setRenderStates3DMode()
 		// switch back the matrices
 		CacheHandler->setMatrixMode(GL_MODELVIEW);
 		glLoadMatrixf((Matrices[ETS_VIEW] * Matrices[ETS_WORLD]).pointer());
+		CacheHandler->addStateCall(true);
 
 		CacheHandler->setMatrixMode(GL_PROJECTION);
 		glLoadMatrixf(Matrices[ETS_PROJECTION].pointer());
+		CacheHandler->addStateCall(true);
 
 		ResetRenderStates = true;
 #ifdef GL_EXT_clip_volume_hint
@@ -2259,26 +2539,26 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 			switch (material.ColorMaterial)
 			{
 			case ECM_NONE:
-				glDisable(GL_COLOR_MATERIAL);
+				CacheHandler->setEnabled(GL_COLOR_MATERIAL, false);
 				break;
 			case ECM_DIFFUSE:
-				glColorMaterial(GL_FRONT_AND_BACK, GL_DIFFUSE);
+				CacheHandler->setColorMaterial(GL_DIFFUSE);
 				break;
 			case ECM_AMBIENT:
-				glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT);
+				CacheHandler->setColorMaterial(GL_AMBIENT);
 				break;
 			case ECM_EMISSIVE:
-				glColorMaterial(GL_FRONT_AND_BACK, GL_EMISSION);
+				CacheHandler->setColorMaterial(GL_EMISSION);
 				break;
 			case ECM_SPECULAR:
-				glColorMaterial(GL_FRONT_AND_BACK, GL_SPECULAR);
+				CacheHandler->setColorMaterial(GL_SPECULAR);
 				break;
 			case ECM_DIFFUSE_AND_AMBIENT:
-				glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+				CacheHandler->setColorMaterial(GL_AMBIENT_AND_DIFFUSE);
 				break;
 			}
 			if (material.ColorMaterial != ECM_NONE)
-				glEnable(GL_COLOR_MATERIAL);
+				CacheHandler->setEnabled(GL_COLOR_MATERIAL, true);
 		}
 
 		if (resetAllRenderStates || tempState == EOFPS_DISABLE_TO_ENABLE ||
@@ -2298,7 +2578,7 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 				color[1] = material.AmbientColor.getGreen() * inv;
 				color[2] = material.AmbientColor.getBlue() * inv;
 				color[3] = material.AmbientColor.getAlpha() * inv;
-				glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, color);
+				CacheHandler->setMaterialColor(GL_AMBIENT, color);
 			}
 
 			if ((material.ColorMaterial != video::ECM_DIFFUSE) &&
@@ -2308,7 +2588,7 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 				color[1] = material.DiffuseColor.getGreen() * inv;
 				color[2] = material.DiffuseColor.getBlue() * inv;
 				color[3] = material.DiffuseColor.getAlpha() * inv;
-				glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, color);
+				CacheHandler->setMaterialColor(GL_DIFFUSE, color);
 			}
 
 			if (material.ColorMaterial != video::ECM_EMISSIVE)
@@ -2317,7 +2597,7 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 				color[1] = material.EmissiveColor.getGreen() * inv;
 				color[2] = material.EmissiveColor.getBlue() * inv;
 				color[3] = material.EmissiveColor.getAlpha() * inv;
-				glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, color);
+				CacheHandler->setMaterialColor(GL_EMISSION, color);
 			}
 		}
 
@@ -2329,14 +2609,14 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 			GLfloat color[4]={0.f,0.f,0.f,1.f};
 			const f32 inv = 1.0f / 255.0f;
 
-			glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, material.Shininess);
+			CacheHandler->setMaterialShininess(material.Shininess);
 			// disable Specular colors if no shininess is set
 			if ((material.Shininess != 0.0f) &&
 				(material.ColorMaterial != video::ECM_SPECULAR))
 			{
 #ifdef GL_EXT_separate_specular_color
 				if (FeatureAvailable[IRR_EXT_separate_specular_color])
-					glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL, GL_SEPARATE_SPECULAR_COLOR);
+					CacheHandler->setLightModelColorControl(GL_SEPARATE_SPECULAR_COLOR);
 #endif
 				color[0] = material.SpecularColor.getRed() * inv;
 				color[1] = material.SpecularColor.getGreen() * inv;
@@ -2345,49 +2625,37 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 			}
 #ifdef GL_EXT_separate_specular_color
 			else if (FeatureAvailable[IRR_EXT_separate_specular_color])
-				glLightModeli(GL_LIGHT_MODEL_COLOR_CONTROL, GL_SINGLE_COLOR);
+				CacheHandler->setLightModelColorControl(GL_SINGLE_COLOR);
 #endif
-			glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, color);
+			CacheHandler->setMaterialColor(GL_SPECULAR, color);
 		}
 
 		// shademode
 		if (resetAllRenderStates || tempState == EOFPS_DISABLE_TO_ENABLE ||
 			lastmaterial.GouraudShading != material.GouraudShading)
 		{
-			if (material.GouraudShading)
-				glShadeModel(GL_SMOOTH);
-			else
-				glShadeModel(GL_FLAT);
+			CacheHandler->setShadeModel(material.GouraudShading ? GL_SMOOTH : GL_FLAT);
 		}
 
 		// lighting
 		if (resetAllRenderStates || tempState == EOFPS_DISABLE_TO_ENABLE ||
 			lastmaterial.Lighting != material.Lighting)
 		{
-			if (material.Lighting)
-				glEnable(GL_LIGHTING);
-			else
-				glDisable(GL_LIGHTING);
+			CacheHandler->setEnabled(GL_LIGHTING, material.Lighting);
 		}
 
 		// fog
 		if (resetAllRenderStates || tempState == EOFPS_DISABLE_TO_ENABLE ||
 			lastmaterial.FogEnable != material.FogEnable)
 		{
-			if (material.FogEnable)
-				glEnable(GL_FOG);
-			else
-				glDisable(GL_FOG);
+			CacheHandler->setEnabled(GL_FOG, material.FogEnable);
 		}
 
 		// normalization
 		if (resetAllRenderStates || tempState == EOFPS_DISABLE_TO_ENABLE ||
 			lastmaterial.NormalizeNormals != material.NormalizeNormals)
 		{
-			if (material.NormalizeNormals)
-				glEnable(GL_NORMALIZE);
-			else
-				glDisable(GL_NORMALIZE);
+			CacheHandler->setEnabled(GL_NORMALIZE, material.NormalizeNormals);
 		}
 
 		// Set fixed pipeline as active.
@@ -2395,10 +2663,10 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 	}
 	else if (tempState == EOFPS_ENABLE_TO_DISABLE)
 	{
-		glDisable(GL_COLOR_MATERIAL);
-		glDisable(GL_LIGHTING);
-		glDisable(GL_FOG);
-		glDisable(GL_NORMALIZE);
+		CacheHandler->setEnabled(GL_COLOR_MATERIAL, false);
+		CacheHandler->setEnabled(GL_LIGHTING, false);
+		CacheHandler->setEnabled(GL_FOG, false);
+		CacheHandler->setEnabled(GL_NORMALIZE, false);
 
 		// Set programmable pipeline as active.
 		tempState = EOFPS_DISABLE;
@@ -2408,7 +2676,7 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 
 	// fillmode - fixed pipeline call, but it emulate GL_LINES behaviour in rendering, so it stay here.
 	if (resetAllRenderStates || (lastmaterial.Wireframe != material.Wireframe) || (lastmaterial.PointCloud != material.PointCloud))
-		glPolygonMode(GL_FRONT_AND_BACK, material.Wireframe ? GL_LINE : material.PointCloud? GL_POINT : GL_FILL);
+		CacheHandler->setPolygonMode(material.Wireframe ? GL_LINE : material.PointCloud? GL_POINT : GL_FILL);
 
 	// ZBuffer
 	switch (material.ZBuffer)
@@ -2609,30 +2877,34 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 
 	// Polygon Offset
 	if (queryFeature(EVDF_POLYGON_OFFSET) && (resetAllRenderStates ||
+		lastmaterial.Wireframe != material.Wireframe ||
+		lastmaterial.PointCloud != material.PointCloud ||
 		lastmaterial.PolygonOffsetDirection != material.PolygonOffsetDirection ||
 		lastmaterial.PolygonOffsetFactor != material.PolygonOffsetFactor ||
 		lastmaterial.PolygonOffsetSlopeScale != material.PolygonOffsetSlopeScale ||
 		lastmaterial.PolygonOffsetDepthBias != material.PolygonOffsetDepthBias ))
 	{
-		glDisable(lastmaterial.Wireframe?GL_POLYGON_OFFSET_LINE:lastmaterial.PointCloud?GL_POLYGON_OFFSET_POINT:GL_POLYGON_OFFSET_FILL);
+		const GLenum offsetMode = material.Wireframe?GL_POLYGON_OFFSET_LINE:material.PointCloud?GL_POLYGON_OFFSET_POINT:GL_POLYGON_OFFSET_FILL;
+		const bool offset = material.PolygonOffsetSlopeScale || material.PolygonOffsetDepthBias || material.PolygonOffsetFactor;
+
+		CacheHandler->setEnabled(GL_POLYGON_OFFSET_FILL, offset && offsetMode == GL_POLYGON_OFFSET_FILL);
+		CacheHandler->setEnabled(GL_POLYGON_OFFSET_LINE, offset && offsetMode == GL_POLYGON_OFFSET_LINE);
+		CacheHandler->setEnabled(GL_POLYGON_OFFSET_POINT, offset && offsetMode == GL_POLYGON_OFFSET_POINT);
+
 		if ( material.PolygonOffsetSlopeScale || material.PolygonOffsetDepthBias )
 		{
-			glEnable(material.Wireframe?GL_POLYGON_OFFSET_LINE:material.PointCloud?GL_POLYGON_OFFSET_POINT:GL_POLYGON_OFFSET_FILL);
-
-			glPolygonOffset(material.PolygonOffsetSlopeScale, material.PolygonOffsetDepthBias);
+			CacheHandler->setPolygonOffset(material.PolygonOffsetSlopeScale, material.PolygonOffsetDepthBias);
 		}
 		else if (material.PolygonOffsetFactor)
 		{
-			glEnable(material.Wireframe?GL_POLYGON_OFFSET_LINE:material.PointCloud?GL_POLYGON_OFFSET_POINT:GL_POLYGON_OFFSET_FILL);
-
 			if (material.PolygonOffsetDirection==EPO_BACK)
-				glPolygonOffset(1.0f, (GLfloat)material.PolygonOffsetFactor);
+				CacheHandler->setPolygonOffset(1.0f, (GLfloat)material.PolygonOffsetFactor);
 			else
-				glPolygonOffset(-1.0f, (GLfloat)-material.PolygonOffsetFactor);
+				CacheHandler->setPolygonOffset(-1.0f, (GLfloat)-material.PolygonOffsetFactor);
 		}
 		else
 		{
-			glPolygonOffset(0.0f, 0.f);
+			CacheHandler->setPolygonOffset(0.0f, 0.f);
 		}
 	}
 
@@ -2643,13 +2915,13 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 		{
 //			glPointSize(core::clamp(static_cast<GLfloat>(material.Thickness), DimSmoothedPoint[0], DimSmoothedPoint[1]));
 			// we don't use point smoothing
-			glPointSize(core::clamp(static_cast<GLfloat>(material.Thickness), DimAliasedPoint[0], DimAliasedPoint[1]));
-			glLineWidth(core::clamp(static_cast<GLfloat>(material.Thickness), DimSmoothedLine[0], DimSmoothedLine[1]));
+			CacheHandler->setPointSize(core::clamp(static_cast<GLfloat>(material.Thickness), DimAliasedPoint[0], DimAliasedPoint[1]));
+			CacheHandler->setLineWidth(core::clamp(static_cast<GLfloat>(material.Thickness), DimSmoothedLine[0], DimSmoothedLine[1]));
 		}
 		else
 		{
-			glPointSize(core::clamp(static_cast<GLfloat>(material.Thickness), DimAliasedPoint[0], DimAliasedPoint[1]));
-			glLineWidth(core::clamp(static_cast<GLfloat>(material.Thickness), DimAliasedLine[0], DimAliasedLine[1]));
+			CacheHandler->setPointSize(core::clamp(static_cast<GLfloat>(material.Thickness), DimAliasedPoint[0], DimAliasedPoint[1]));
+			CacheHandler->setLineWidth(core::clamp(static_cast<GLfloat>(material.Thickness), DimAliasedLine[0], DimAliasedLine[1]));
 		}
 	}
 
@@ -2658,14 +2930,11 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 	{
 		if (FeatureAvailable[IRR_ARB_multisample])
 		{
-			if (material.AntiAliasing & EAAM_ALPHA_TO_COVERAGE)
-				glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE_ARB);
-			else if (lastmaterial.AntiAliasing & EAAM_ALPHA_TO_COVERAGE)
-				glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE_ARB);
+			CacheHandler->setEnabled(GL_SAMPLE_ALPHA_TO_COVERAGE_ARB, (material.AntiAliasing & EAAM_ALPHA_TO_COVERAGE) != 0);
 
 			if ((AntiAlias >= 2) && (material.AntiAliasing & (EAAM_SIMPLE|EAAM_QUALITY)))
 			{
-				glEnable(GL_MULTISAMPLE_ARB);
+				CacheHandler->setEnabled(GL_MULTISAMPLE_ARB, true);
 #ifdef GL_NV_multisample_filter_hint
 				if (FeatureAvailable[IRR_NV_multisample_filter_hint])
 				{
@@ -2677,23 +2946,11 @@ void COpenGLDriver::setBasicRenderStates(const SMaterial& material, const SMater
 #endif
 			}
 			else
-				glDisable(GL_MULTISAMPLE_ARB);
-		}
-		if ((material.AntiAliasing & EAAM_LINE_SMOOTH) != (lastmaterial.AntiAliasing & EAAM_LINE_SMOOTH))
-		{
-			if (material.AntiAliasing & EAAM_LINE_SMOOTH)
-				glEnable(GL_LINE_SMOOTH);
-			else if (lastmaterial.AntiAliasing & EAAM_LINE_SMOOTH)
-				glDisable(GL_LINE_SMOOTH);
-		}
-		if ((material.AntiAliasing & EAAM_POINT_SMOOTH) != (lastmaterial.AntiAliasing & EAAM_POINT_SMOOTH))
-		{
-			if (material.AntiAliasing & EAAM_POINT_SMOOTH)
-				// often in software, and thus very slow
-				glEnable(GL_POINT_SMOOTH);
-			else if (lastmaterial.AntiAliasing & EAAM_POINT_SMOOTH)
-				glDisable(GL_POINT_SMOOTH);
+				CacheHandler->setEnabled(GL_MULTISAMPLE_ARB, false);
 		}
+		CacheHandler->setEnabled(GL_LINE_SMOOTH, (material.AntiAliasing & EAAM_LINE_SMOOTH) != 0);
+		// often in software, and thus very slow
+		CacheHandler->setEnabled(GL_POINT_SMOOTH, (material.AntiAliasing & EAAM_POINT_SMOOTH) != 0);
 	}
 
 	// Texture parameters
@@ -2738,15 +2995,14 @@ void COpenGLDriver::setTextureRenderStates(const SMaterial& material, bool reset
 						getGLTextureMatrix(glmat, Matrices[ETS_TEXTURE_0 + i]);
 					glLoadMatrixf(glmat);
 				}
+				CacheHandler->addStateCall(true);
 			}
 
 			const GLenum tmpType = tmpTexture->getOpenGLTextureType();
 
+			// texture parameters are stored per texture and only changed here, so they stay valid when states are reset
 			COpenGLTexture::SStatesCache& statesCache = tmpTexture->getStatesCache();
 
-			if (resetAllRenderstates)
-				statesCache.IsCached = false;
-
 #ifdef GL_VERSION_2_1
 			if (Version >= 210)
 			{
@@ -2761,7 +3017,10 @@ void COpenGLDriver::setTextureRenderStates(const SMaterial& material, bool reset
 						glTexParameterf(tmpType, GL_TEXTURE_LOD_BIAS, 0.f);
 
 					statesCache.LODBias = material.TextureLayer[i].LODBias;
+					CacheHandler->addStateCall(true);
 				}
+				else
+					CacheHandler->addStateCall(false);
 			}
 			else if (FeatureAvailable[IRR_EXT_texture_lod_bias])
 			{
@@ -2772,6 +3031,7 @@ void COpenGLDriver::setTextureRenderStates(const SMaterial& material, bool reset
 				}
 				else
 					glTexEnvf(GL_TEXTURE_FILTER_CONTROL_EXT, GL_TEXTURE_LOD_BIAS_EXT, 0.f);
+				CacheHandler->addStateCall(true);
 			}
 #elif defined(GL_EXT_texture_lod_bias)
 			if (FeatureAvailable[IRR_EXT_texture_lod_bias])
@@ -2783,56 +3043,68 @@ void COpenGLDriver::setTextureRenderStates(const SMaterial& material, bool reset
 				}
 				else
 					glTexEnvf(GL_TEXTURE_FILTER_CONTROL_EXT, GL_TEXTURE_LOD_BIAS_EXT, 0.f);
+				CacheHandler->addStateCall(true);
 			}
 #endif
 
-			if (!statesCache.IsCached || material.TextureLayer[i].BilinearFilter != statesCache.BilinearFilter ||
-				material.TextureLayer[i].TrilinearFilter != statesCache.TrilinearFilter)
+			// both filters are compared against the previous state, the cache is updated afterwards
+			const bool filterChanged = !statesCache.IsCached || material.TextureLayer[i].BilinearFilter != statesCache.BilinearFilter ||
+				material.TextureLayer[i].TrilinearFilter != statesCache.TrilinearFilter;
+
+			if (filterChanged)
 			{
 				glTexParameteri(tmpType, GL_TEXTURE_MAG_FILTER,
 					(material.TextureLayer[i].BilinearFilter || material.TextureLayer[i].TrilinearFilter) ? GL_LINEAR : GL_NEAREST);
-
-				statesCache.BilinearFilter = material.TextureLayer[i].BilinearFilter;
-				statesCache.TrilinearFilter = material.TextureLayer[i].TrilinearFilter;
+				CacheHandler->addStateCall(true);
 			}
+			else
+				CacheHandler->addStateCall(false);
 
 			if (material.UseMipMaps && tmpTexture->hasMipMaps())
 			{
-				if (!statesCache.IsCached || material.TextureLayer[i].BilinearFilter != statesCache.BilinearFilter ||
-					material.TextureLayer[i].TrilinearFilter != statesCache.TrilinearFilter || !statesCache.MipMapStatus)
+				if (filterChanged || !statesCache.MipMapStatus)
 				{
 					glTexParameteri(tmpType, GL_TEXTURE_MIN_FILTER,
 						material.TextureLayer[i].TrilinearFilter ? GL_LINEAR_MIPMAP_LINEAR :
 						material.TextureLayer[i].BilinearFilter ? GL_LINEAR_MIPMAP_NEAREST :
 						GL_NEAREST_MIPMAP_NEAREST);
 
-					statesCache.BilinearFilter = material.TextureLayer[i].BilinearFilter;
-					statesCache.TrilinearFilter = material.TextureLayer[i].TrilinearFilter;
 					statesCache.MipMapStatus = true;
+					CacheHandler->addStateCall(true);
 				}
+				else
+					CacheHandler->addStateCall(false);
 			}
 			else
 			{
-				if (!statesCache.IsCached || material.TextureLayer[i].BilinearFilter != statesCache.BilinearFilter ||
-					material.TextureLayer[i].TrilinearFilter != statesCache.TrilinearFilter || statesCache.MipMapStatus)
+				if (filterChanged || statesCache.MipMapStatus)
 				{
 					glTexParameteri(tmpType, GL_TEXTURE_MIN_FILTER,
 						(material.TextureLayer[i].BilinearFilter || material.TextureLayer[i].TrilinearFilter) ? GL_LINEAR : GL_NEAREST);
 
-					statesCache.BilinearFilter = material.TextureLayer[i].BilinearFilter;
-					statesCache.TrilinearFilter = material.TextureLayer[i].TrilinearFilter;
 					statesCache.MipMapStatus = false;
+					CacheHandler->addStateCall(true);
 				}
+				else
+					CacheHandler->addStateCall(false);
 			}
 
+			statesCache.BilinearFilter = material.TextureLayer[i].BilinearFilter;
+			statesCache.TrilinearFilter = material.TextureLayer[i].TrilinearFilter;
+
 #ifdef GL_EXT_texture_filter_anisotropic
-			if (FeatureAvailable[IRR_EXT_texture_filter_anisotropic] &&
-				(!statesCache.IsCached || material.TextureLayer[i].AnisotropicFilter != statesCache.AnisotropicFilter))
+			if (FeatureAvailable[IRR_EXT_texture_filter_anisotropic])
 			{
-				glTexParameteri(tmpType, GL_TEXTURE_MAX_ANISOTROPY_EXT,
-					material.TextureLayer[i].AnisotropicFilter > 1 ? core::min_(MaxAnisotropy, material.TextureLayer[i].AnisotropicFilter) : 1);
+				if (!statesCache.IsCached || material.TextureLayer[i].AnisotropicFilter != statesCache.AnisotropicFilter)
+				{
+					glTexParameteri(tmpType, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+						material.TextureLayer[i].AnisotropicFilter > 1 ? core::min_(MaxAnisotropy, material.TextureLayer[i].AnisotropicFilter) : 1);
 
-				statesCache.AnisotropicFilter = material.TextureLayer[i].AnisotropicFilter;
+					statesCache.AnisotropicFilter = material.TextureLayer[i].AnisotropicFilter;
+					CacheHandler->addStateCall(true);
+				}
+				else
+					CacheHandler->addStateCall(false);
 			}
 #endif
 
@@ -2840,19 +3112,28 @@ void COpenGLDriver::setTextureRenderStates(const SMaterial& material, bool reset
 			{
 				glTexParameteri(tmpType, GL_TEXTURE_WRAP_S, getTextureWrapMode(material.TextureLayer[i].TextureWrapU));
 				statesCache.WrapU = material.TextureLayer[i].TextureWrapU;
+				CacheHandler->addStateCall(true);
 			}
+			else
+				CacheHandler->addStateCall(false);
 
 			if (!statesCache.IsCached || material.TextureLayer[i].TextureWrapV != statesCache.WrapV)
 			{
 				glTexParameteri(tmpType, GL_TEXTURE_WRAP_T, getTextureWrapMode(material.TextureLayer[i].TextureWrapV));
 				statesCache.WrapV = material.TextureLayer[i].TextureWrapV;
+				CacheHandler->addStateCall(true);
 			}
+			else
+				CacheHandler->addStateCall(false);
 
 			if (!statesCache.IsCached || material.TextureLayer[i].TextureWrapW != statesCache.WrapW)
 			{
 				glTexParameteri(tmpType, GL_TEXTURE_WRAP_R, getTextureWrapMode(material.TextureLayer[i].TextureWrapW));
 				statesCache.WrapW = material.TextureLayer[i].TextureWrapW;
+				CacheHandler->addStateCall(true);
 			}
+			else
+				CacheHandler->addStateCall(false);
 
 			statesCache.IsCached = true;
 		}
@@ -2898,10 +3179,12 @@ void COpenGLDriver::setRenderStates2DMode(bool alpha, bool texture, bool alphaCh
 			m.buildProjectionMatrixOrthoLH(f32(renderTargetSize.Width), f32(-(s32)(renderTargetSize.Height)), -1.0f, 1.0f);
 			m.setTranslation(core::vector3df(-1,1,0));
 			glLoadMatrixf(m.pointer());
+			CacheHandler->addStateCall(true);
 
 			CacheHandler->setMatrixMode(GL_MODELVIEW);
 			glLoadIdentity();
 			glTranslatef(0.375f, 0.375f, 0.0f);
+			CacheHandler->addStateCall(true);
 
 			Transformation3DChanged = false;
 		}
@@ -3216,6 +3499,7 @@ void COpenGLDriver::setAmbientLight(const SColorf& color)
 {
 	GLfloat data[4] = {color.r, color.g, color.b, color.a};
 	glLightModelfv(GL_LIGHT_MODEL_AMBIENT, data);
+	CacheHandler->addStateCall(true);
 }
 
 
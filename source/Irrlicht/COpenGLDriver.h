@@ -120,6 +120,16 @@ namespace video
 				const void* indexList, u32 primitiveCount,
 				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType) _IRR_OVERRIDE_;
 
+		//! Draws vertices and indices which were written to stream allocations.
+		virtual void drawStreamedPrimitiveList(const SStreamAllocation& vertices, u32 vertexCount,
+				const SStreamAllocation& indices, u32 primitiveCount,
+				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType) _IRR_OVERRIDE_;
+
+		//! Draws streamed vertices with indices from client memory.
+		virtual void drawStreamedPrimitiveList(const SStreamAllocation& vertices, u32 vertexCount,
+				const void* indexList, u32 primitiveCount,
+				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType) _IRR_OVERRIDE_;
+
 		//! draws a vertex primitive list in 2d
 		virtual void draw2DVertexPrimitiveList(const void* vertices, u32 vertexCount,
 				const void* indexList, u32 primitiveCount,
@@ -411,6 +421,36 @@ namespace video
 		bool updateVertexHardwareBuffer(SHWBufferLink_opengl *HWBuffer);
 		bool updateIndexHardwareBuffer(SHWBufferLink_opengl *HWBuffer);
 
+		//! OpenGL buffer of a streaming buffer, the ring is managed by CNullDriver
+		struct SStreamBufferGL
+		{
+			SStreamBufferGL() : Id(0), Persistent(0), Mapped(false), Staged(false), StagedOffset(0) {}
+
+			GLuint Id;
+			//! memory of the whole buffer when it is mapped persistently
+			u8* Persistent;
+			//! a range is mapped with glMapBufferRange
+			bool Mapped;
+			//! a range was written to Staging, it is uploaded when unmapped
+			bool Staged;
+			u32 StagedOffset;
+			core::array<u8> Staging;
+		};
+
+		//! true if streaming buffers are OpenGL buffers, otherwise they are emulated
+		bool hasHardwareStreams() const;
+
+		//! creates the OpenGL buffer of a streaming buffer
+		bool createStreamBuffer(E_STREAM_BUFFER buffer);
+
+		virtual void* mapStreamBuffer(E_STREAM_BUFFER buffer, u32 offset, u32 size) _IRR_OVERRIDE_;
+		virtual void unmapStreamBuffer(E_STREAM_BUFFER buffer) _IRR_OVERRIDE_;
+		virtual void orphanStreamBuffer(E_STREAM_BUFFER buffer) _IRR_OVERRIDE_;
+		virtual void deleteStreamBuffer(E_STREAM_BUFFER buffer) _IRR_OVERRIDE_;
+		virtual bool insertStreamFence(SStreamFence& fence) _IRR_OVERRIDE_;
+		virtual bool waitStreamFence(SStreamFence& fence, bool block) _IRR_OVERRIDE_;
+		virtual void deleteStreamFence(SStreamFence& fence) _IRR_OVERRIDE_;
+
 		void uploadClipPlane(u32 index);
 
 		//! inits the parts of the open gl driver used on all platforms
@@ -453,6 +493,8 @@ namespace video
 		core::matrix4 Matrices[ETS_COUNT];
 		core::array<u8> ColorBuffer;
 
+		SStreamBufferGL StreamBuffersGL[ESB_COUNT];
+
 		//! enumeration for rendering modes such as 2d and 3d for minizing the switching of renderStates.
 		enum E_RENDER_MODE
 		{
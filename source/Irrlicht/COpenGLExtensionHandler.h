@@ -1159,6 +1159,13 @@ class COpenGLExtensionHandler
 	GLboolean extGlIsBuffer (GLuint buffer);
 	void extGlGetBufferParameteriv (GLenum target, GLenum pname, GLint *params);
 	void extGlGetBufferPointerv (GLenum target, GLenum pname, GLvoid **params);
+	void *extGlMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+	void extGlBufferStorage(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+	// sync objects
+	GLsync extGlFenceSync(GLenum condition, GLbitfield flags);
+	GLenum extGlClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+	void extGlDeleteSync(GLsync sync);
 	void extGlProvokingVertex(GLenum mode);
 	void extGlProgramParameteri(GLuint program, GLenum pname, GLint value);
 
@@ -1304,6 +1311,11 @@ class COpenGLExtensionHandler
 		PFNGLISBUFFERARBPROC pGlIsBufferARB;
 		PFNGLGETBUFFERPARAMETERIVARBPROC pGlGetBufferParameterivARB;
 		PFNGLGETBUFFERPOINTERVARBPROC pGlGetBufferPointervARB;
+		PFNGLMAPBUFFERRANGEPROC pGlMapBufferRange;
+		PFNGLBUFFERSTORAGEPROC pGlBufferStorage;
+		PFNGLFENCESYNCPROC pGlFenceSync;
+		PFNGLCLIENTWAITSYNCPROC pGlClientWaitSync;
+		PFNGLDELETESYNCPROC pGlDeleteSync;
 		PFNGLPROVOKINGVERTEXPROC pGlProvokingVertexARB;
 		PFNGLPROVOKINGVERTEXEXTPROC pGlProvokingVertexEXT;
 		PFNGLPROGRAMPARAMETERIARBPROC pGlProgramParameteriARB;
@@ -2434,6 +2446,72 @@ inline void COpenGLExtensionHandler::extGlGetBufferPointerv(GLenum target, GLenu
 }
 
 
+inline void *COpenGLExtensionHandler::extGlMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+#ifdef _IRR_OPENGL_USE_EXTPOINTER_
+	if (pGlMapBufferRange)
+		return pGlMapBufferRange(target, offset, length, access);
+	return 0;
+#elif defined(GL_ARB_map_buffer_range)
+	return glMapBufferRange(target, offset, length, access);
+#else
+	os::Printer::log("glMapBufferRange not supported", ELL_ERROR);
+	return 0;
+#endif
+}
+
+inline void COpenGLExtensionHandler::extGlBufferStorage(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags)
+{
+#ifdef _IRR_OPENGL_USE_EXTPOINTER_
+	if (pGlBufferStorage)
+		pGlBufferStorage(target, size, data, flags);
+#elif defined(GL_ARB_buffer_storage)
+	glBufferStorage(target, size, data, flags);
+#else
+	os::Printer::log("glBufferStorage not supported", ELL_ERROR);
+#endif
+}
+
+inline GLsync COpenGLExtensionHandler::extGlFenceSync(GLenum condition, GLbitfield flags)
+{
+#ifdef _IRR_OPENGL_USE_EXTPOINTER_
+	if (pGlFenceSync)
+		return pGlFenceSync(condition, flags);
+	return 0;
+#elif defined(GL_ARB_sync)
+	return glFenceSync(condition, flags);
+#else
+	os::Printer::log("glFenceSync not supported", ELL_ERROR);
+	return 0;
+#endif
+}
+
+inline GLenum COpenGLExtensionHandler::extGlClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+#ifdef _IRR_OPENGL_USE_EXTPOINTER_
+	if (pGlClientWaitSync)
+		return pGlClientWaitSync(sync, flags, timeout);
+	return GL_WAIT_FAILED;
+#elif defined(GL_ARB_sync)
+	return glClientWaitSync(sync, flags, timeout);
+#else
+	os::Printer::log("glClientWaitSync not supported", ELL_ERROR);
+	return GL_WAIT_FAILED;
+#endif
+}
+
+inline void COpenGLExtensionHandler::extGlDeleteSync(GLsync sync)
+{
+#ifdef _IRR_OPENGL_USE_EXTPOINTER_
+	if (pGlDeleteSync)
+		pGlDeleteSync(sync);
+#elif defined(GL_ARB_sync)
+	glDeleteSync(sync);
+#else
+	os::Printer::log("glDeleteSync not supported", ELL_ERROR);
+#endif
+}
+
 inline void COpenGLExtensionHandler::extGlProvokingVertex(GLenum mode)
 {
 #ifdef _IRR_OPENGL_USE_EXTPOINTER_
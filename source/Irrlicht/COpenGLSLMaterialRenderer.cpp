@@ -614,6 +614,13 @@ bool COpenGLSLMaterialRenderer::setPixelShaderConstant(s32 index, const f32* flo
 	if(index < 0 || UniformInfo[index].location < 0)
 		return false;
 
+	// unchanged values don't have to be sent again
+	if (isUniformCached(UniformInfo[index], floats, count))
+	{
+		Driver->getCacheHandler()->addStateCall(false);
+		return true;
+	}
+
 	bool status = true;
 
 	switch (UniformInfo[index].type)
@@ -659,6 +666,13 @@ bool COpenGLSLMaterialRenderer::setPixelShaderConstant(s32 index, const f32* flo
 			status = false;
 			break;
 	}
+
+	if (status)
+	{
+		Driver->getCacheHandler()->addStateCall(true);
+		setUniformCache(UniformInfo[index], floats, count);
+	}
+
 	return status;
 #else
 	return false;
@@ -671,6 +685,13 @@ bool COpenGLSLMaterialRenderer::setPixelShaderConstant(s32 index, const s32* int
 	if(index < 0 || UniformInfo[index].location < 0)
 		return false;
 
+	// unchanged values don't have to be sent again
+	if (isUniformCached(UniformInfo[index], ints, count))
+	{
+		Driver->getCacheHandler()->addStateCall(false);
+		return true;
+	}
+
 	bool status = true;
 
 	switch (UniformInfo[index].type)
@@ -703,12 +724,39 @@ bool COpenGLSLMaterialRenderer::setPixelShaderConstant(s32 index, const s32* int
 			status = false;
 			break;
 	}
+
+	if (status)
+	{
+		Driver->getCacheHandler()->addStateCall(true);
+		setUniformCache(UniformInfo[index], ints, count);
+	}
+
 	return status;
 #else
 	return false;
 #endif
 }
 
+bool COpenGLSLMaterialRenderer::isUniformCached(const SUniformInfo& info, const void* data, int count) const
+{
+	if (!data || count <= 0 || info.values.size() != static_cast<u32>(count))
+		return false;
+
+	return memcmp(info.values.const_pointer(), data, count * sizeof(u32)) == 0;
+}
+
+void COpenGLSLMaterialRenderer::setUniformCache(SUniformInfo& info, const void* data, int count)
+{
+	if (!data || count <= 0)
+	{
+		info.values.clear();
+		return;
+	}
+
+	info.values.set_used(count);
+	memcpy(info.values.pointer(), data, count * sizeof(u32));
+}
+
 IVideoDriver* COpenGLSLMaterialRenderer::getVideoDriver()
 {
 	return Driver;
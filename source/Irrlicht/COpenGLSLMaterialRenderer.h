@@ -104,6 +104,14 @@ protected:
 	bool createShader(GLenum shaderType, const char* shader);
 	bool linkProgram();
 
+	struct SUniformInfo;
+
+	//! Returns true if the uniform already has these values.
+	bool isUniformCached(const SUniformInfo& info, const void* data, int count) const;
+
+	//! Stores the values of a uniform after they were set.
+	void setUniformCache(SUniformInfo& info, const void* data, int count);
+
 	COpenGLDriver* Driver;
 	IShaderConstantSetCallBack* CallBack;
 
@@ -117,6 +125,8 @@ protected:
 		core::stringc name;
 		GLenum type;
 		GLint location;
+		// last values set, uniforms keep them as long as the program is linked
+		core::array<u32> values;
 	};
 
 	GLhandleARB Program;
@@ -192,7 +192,7 @@ IAnimatedMesh* CPLYMeshFileLoader::createMesh(io::IReadFile* file)
 			{
 				SPLYElement* el = new SPLYElement;
 				el->Name = getNextWord();
-				el->Count = atoi(getNextWord());
+				el->Count = core::strtoul10(getNextWord());
 				el->IsFixedWidth = true;
 				el->KnownSize = 0;
 				ElementList.push_back(el);
@@ -716,11 +716,11 @@ f32 CPLYMeshFileLoader::getFloat(E_PLY_PROPERTY_TYPE t)
 		case EPLYPT_INT8:
 		case EPLYPT_INT16:
 		case EPLYPT_INT32:
-			retVal = f32(atoi(word));
+			retVal = f32(core::strtol10(word));
 			break;
 		case EPLYPT_FLOAT32:
 		case EPLYPT_FLOAT64:
-			retVal = f32(atof(word));
+			retVal = core::fast_atof(word);
 			break;
 		case EPLYPT_LIST:
 		case EPLYPT_UNKNOWN:
@@ -794,11 +794,11 @@ u32 CPLYMeshFileLoader::getInt(E_PLY_PROPERTY_TYPE t)
 		case EPLYPT_INT8:
 		case EPLYPT_INT16:
 		case EPLYPT_INT32:
-			retVal = atoi(word);
+			retVal = (u32)core::strtol10(word);
 			break;
 		case EPLYPT_FLOAT32:
 		case EPLYPT_FLOAT64:
-			retVal = u32(atof(word));
+			retVal = u32(core::fast_atof(word));
 			break;
 		case EPLYPT_LIST:
 		case EPLYPT_UNKNOWN:
@@ -0,0 +1,223 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_PARTICLE_ARRAYS_H_INCLUDED__
+#define __C_PARTICLE_ARRAYS_H_INCLUDED__
+
+#include "SParticle.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Storage for particles as structure of arrays.
+/** Keeps one array per particle member, so updates of a single member
+touch only the memory they need and run in simple loops. */
+class CParticleArrays
+{
+public:
+
+	//! Returns the number of particles
+	u32 size() const
+	{
+		return StartTime.size();
+	}
+
+	//! Removes all particles, keeps the memory
+	void clear()
+	{
+		set_used(0);
+	}
+
+	//! Adds a particle at the end
+	void push_back(const SParticle& p)
+	{
+		const u32 i = size();
+		set_used(i+1);
+		set(i, p);
+	}
+
+	//! Returns a particle
+	SParticle get(u32 i) const
+	{
+		SParticle p;
+		p.pos.set(PosX[i], PosY[i], PosZ[i]);
+		p.vector.set(VectorX[i], VectorY[i], VectorZ[i]);
+		p.startTime = StartTime[i];
+		p.endTime = EndTime[i];
+		p.color = Color[i];
+		p.startColor = StartColor[i];
+		p.startVector.set(StartVectorX[i], StartVectorY[i], StartVectorZ[i]);
+		p.size.set(SizeWidth[i], SizeHeight[i]);
+		p.startSize.set(StartSizeWidth[i], StartSizeHeight[i]);
+		return p;
+	}
+
+	//! Overwrites a particle
+	void set(u32 i, const SParticle& p)
+	{
+		PosX[i] = p.pos.X;
+		PosY[i] = p.pos.Y;
+		PosZ[i] = p.pos.Z;
+		VectorX[i] = p.vector.X;
+		VectorY[i] = p.vector.Y;
+		VectorZ[i] = p.vector.Z;
+		StartTime[i] = p.startTime;
+		EndTime[i] = p.endTime;
+		Color[i] = p.color;
+		StartColor[i] = p.startColor;
+		StartVectorX[i] = p.startVector.X;
+		StartVectorY[i] = p.startVector.Y;
+		StartVectorZ[i] = p.startVector.Z;
+		SizeWidth[i] = p.size.Width;
+		SizeHeight[i] = p.size.Height;
+		StartSizeWidth[i] = p.startSize.Width;
+		StartSizeHeight[i] = p.startSize.Height;
+	}
+
+	//! Removes a particle by moving the last one into its place.
+	/** Particle order does not matter, so this is a lot faster than
+	erasing from the middle of the arrays. */
+	void swapRemove(u32 i)
+	{
+		const u32 last = size()-1;
+		if (i != last)
+		{
+			PosX[i] = PosX[last];
+			PosY[i] = PosY[last];
+			PosZ[i] = PosZ[last];
+			VectorX[i] = VectorX[last];
+			VectorY[i] = VectorY[last];
+			VectorZ[i] = VectorZ[last];
+			StartTime[i] = StartTime[last];
+			EndTime[i] = EndTime[last];
+			Color[i] = Color[last];
+			StartColor[i] = StartColor[last];
+			StartVectorX[i] = StartVectorX[last];
+			StartVectorY[i] = StartVectorY[last];
+			StartVectorZ[i] = StartVectorZ[last];
+			SizeWidth[i] = SizeWidth[last];
+			SizeHeight[i] = SizeHeight[last];
+			StartSizeWidth[i] = StartSizeWidth[last];
+			StartSizeHeight[i] = StartSizeHeight[last];
+		}
+		set_used(last);
+	}
+
+	//! Copies all particles into an array of structures
+	void copyTo(core::array<SParticle>& particles) const
+	{
+		particles.set_used(size());
+		for (u32 i=0; i<size(); ++i)
+			particles[i] = get(i);
+	}
+
+	//! Replaces all particles by those of an array of structures
+	void copyFrom(const core::array<SParticle>& particles)
+	{
+		set_used(particles.size());
+		for (u32 i=0; i<particles.size(); ++i)
+			set(i, particles[i]);
+	}
+
+	//! Returns pointers to all arrays.
+	/** Only valid until the number of particles changes. */
+	SParticleArrays getArrays()
+	{
+		SParticleArrays arrays;
+		arrays.PosX = PosX.pointer();
+		arrays.PosY = PosY.pointer();
+		arrays.PosZ = PosZ.pointer();
+		arrays.VectorX = VectorX.pointer();
+		arrays.VectorY = VectorY.pointer();
+		arrays.VectorZ = VectorZ.pointer();
+		arrays.StartTime = StartTime.pointer();
+		arrays.EndTime = EndTime.pointer();
+		arrays.Color = Color.pointer();
+		arrays.StartColor = StartColor.pointer();
+		arrays.StartVectorX = StartVectorX.pointer();
+		arrays.StartVectorY = StartVectorY.pointer();
+		arrays.StartVectorZ = StartVectorZ.pointer();
+		arrays.SizeWidth = SizeWidth.pointer();
+		arrays.SizeHeight = SizeHeight.pointer();
+		arrays.StartSizeWidth = StartSizeWidth.pointer();
+		arrays.StartSizeHeight = StartSizeHeight.pointer();
+		return arrays;
+	}
+
+private:
+
+	void set_used(u32 count)
+	{
+		// core::array::set_used grows to the exact size, but particles
+		// are added one by one
+		if (count > PosX.allocated_size())
+			reallocate(count + count/2 + 16);
+
+		PosX.set_used(count);
+		PosY.set_used(count);
+		PosZ.set_used(count);
+		VectorX.set_used(count);
+		VectorY.set_used(count);
+		VectorZ.set_used(count);
+		StartTime.set_used(count);
+		EndTime.set_used(count);
+		Color.set_used(count);
+		StartColor.set_used(count);
+		StartVectorX.set_used(count);
+		StartVectorY.set_used(count);
+		StartVectorZ.set_used(count);
+		SizeWidth.set_used(count);
+		SizeHeight.set_used(count);
+		StartSizeWidth.set_used(count);
+		StartSizeHeight.set_used(count);
+	}
+
+	void reallocate(u32 count)
+	{
+		PosX.reallocate(count);
+		PosY.reallocate(count);
+		PosZ.reallocate(count);
+		VectorX.reallocate(count);
+		VectorY.reallocate(count);
+		VectorZ.reallocate(count);
+		StartTime.reallocate(count);
+		EndTime.reallocate(count);
+		Color.reallocate(count);
+		StartColor.reallocate(count);
+		StartVectorX.reallocate(count);
+		StartVectorY.reallocate(count);
+		StartVectorZ.reallocate(count);
+		SizeWidth.reallocate(count);
+		SizeHeight.reallocate(count);
+		StartSizeWidth.reallocate(count);
+		StartSizeHeight.reallocate(count);
+	}
+
+	core::array<f32> PosX;
+	core::array<f32> PosY;
+	core::array<f32> PosZ;
+	core::array<f32> VectorX;
+	core::array<f32> VectorY;
+	core::array<f32> VectorZ;
+	core::array<u32> StartTime;
+	core::array<u32> EndTime;
+	core::array<video::SColor> Color;
+	core::array<video::SColor> StartColor;
+	core::array<f32> StartVectorX;
+	core::array<f32> StartVectorY;
+	core::array<f32> StartVectorZ;
+	core::array<f32> SizeWidth;
+	core::array<f32> SizeHeight;
+	core::array<f32> StartSizeWidth;
+	core::array<f32> StartSizeHeight;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
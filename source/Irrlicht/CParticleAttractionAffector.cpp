@@ -18,7 +18,7 @@ CParticleAttractionAffector::CParticleAttractionAffector(
 		const core::vector3df& point, f32 speed, bool attract,
 		bool affectX, bool affectY, bool affectZ )
 	: Point(point), Speed(speed), AffectX(affectX), AffectY(affectY),
-		AffectZ(affectZ), Attract(attract), LastTime(0)
+		AffectZ(affectZ), Attract(attract), LastTime(0), Step(0.f)
 {
 	#ifdef _DEBUG
 	setDebugName("CParticleAttractionAffector");
@@ -60,6 +60,47 @@ void CParticleAttractionAffector::affect(u32 now, SParticle* particlearray, u32
 	}
 }
 
+//! Prepares affecting particles stored as structure of arrays.
+bool CParticleAttractionAffector::beginAffect(u32 now)
+{
+	if( LastTime == 0 )
+		LastTime = now;
+
+	const f32 timeDelta = ( now - LastTime ) / 1000.0f;
+	LastTime = now;
+
+	Step = Attract ? Speed * timeDelta : -Speed * timeDelta;
+	return true;
+}
+
+
+//! Affects a block of particles stored as structure of arrays.
+void CParticleAttractionAffector::affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end)
+{
+	if( !Enabled )
+		return;
+
+	const f32 stepX = AffectX ? Step : 0.f;
+	const f32 stepY = AffectY ? Step : 0.f;
+	const f32 stepZ = AffectZ ? Step : 0.f;
+
+	for(u32 i=begin; i<end; ++i)
+	{
+		const f32 x = Point.X - particles.PosX[i];
+		const f32 y = Point.Y - particles.PosY[i];
+		const f32 z = Point.Z - particles.PosZ[i];
+
+		// particles at the point don't move, like with vector3d::normalize
+		const f32 lengthSq = x*x + y*y + z*z;
+		const f32 scale = lengthSq > 0.f ? core::reciprocal_squareroot(lengthSq) : 0.f;
+
+		particles.PosX[i] += x * scale * stepX;
+		particles.PosY[i] += y * scale * stepY;
+		particles.PosZ[i] += z * scale * stepZ;
+	}
+}
+
+
 //! Writes attributes of the object.
 void CParticleAttractionAffector::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
 {
@@ -28,6 +28,12 @@ public:
 	//! Affects a particle.
 	virtual void affect(u32 now, SParticle* particlearray, u32 count) _IRR_OVERRIDE_;
 
+	//! Prepares affecting particles stored as structure of arrays.
+	virtual bool beginAffect(u32 now) _IRR_OVERRIDE_;
+
+	//! Affects a block of particles stored as structure of arrays.
+	virtual void affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end) _IRR_OVERRIDE_;
+
 	//! Set the point that particles will attract to
 	virtual void setPoint( const core::vector3df& point ) _IRR_OVERRIDE_ { Point = point; }
 
@@ -79,6 +85,8 @@ private:
 	bool AffectZ;
 	bool Attract;
 	u32 LastTime;
+	// movement towards the point in the current update, set by beginAffect
+	f32 Step;
 };
 
 } // end namespace scene
@@ -47,6 +47,28 @@ void CParticleFadeOutAffector::affect(u32 now, SParticle* particlearray, u32 cou
 }
 
 
+//! Prepares affecting particles stored as structure of arrays.
+bool CParticleFadeOutAffector::beginAffect(u32 now)
+{
+	return true;
+}
+
+
+//! Affects a block of particles stored as structure of arrays.
+void CParticleFadeOutAffector::affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end)
+{
+	if (!Enabled)
+		return;
+
+	for (u32 i=begin; i<end; ++i)
+	{
+		const u32 timeLeft = particles.EndTime[i] - now;
+		if (timeLeft < FadeOutTime)
+			particles.Color[i] = particles.StartColor[i].getInterpolated(TargetColor, timeLeft / FadeOutTime);
+	}
+}
+
+
 //! Writes attributes of the object.
 //! Implement this to expose the attributes of your scene node animator for
 //! scripting languages, editors, debuggers or xml serialization purposes.
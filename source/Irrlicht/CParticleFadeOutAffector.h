@@ -26,6 +26,12 @@ public:
 	//! Affects a particle.
 	virtual void affect(u32 now, SParticle* particlearray, u32 count) _IRR_OVERRIDE_;
 
+	//! Prepares affecting particles stored as structure of arrays.
+	virtual bool beginAffect(u32 now) _IRR_OVERRIDE_;
+
+	//! Affects a block of particles stored as structure of arrays.
+	virtual void affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end) _IRR_OVERRIDE_;
+
 	//! Sets the targetColor, i.e. the color the particles will interpolate
 	//! to over time.
 	virtual void setTargetColor( const video::SColor& targetColor ) _IRR_OVERRIDE_ { TargetColor = targetColor; }
@@ -45,6 +45,32 @@ void CParticleGravityAffector::affect(u32 now, SParticle* particlearray, u32 cou
 	}
 }
 
+//! Prepares affecting particles stored as structure of arrays.
+bool CParticleGravityAffector::beginAffect(u32 now)
+{
+	return true;
+}
+
+
+//! Affects a block of particles stored as structure of arrays.
+void CParticleGravityAffector::affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end)
+{
+	if (!Enabled)
+		return;
+
+	for (u32 i=begin; i<end; ++i)
+	{
+		f32 d = (now - particles.StartTime[i]) / TimeForceLost;
+		d = core::clamp(d, 0.f, 1.f);
+
+		// interpolated from the start vector to gravity
+		particles.VectorX[i] = Gravity.X + (particles.StartVectorX[i] - Gravity.X) * (1.f - d);
+		particles.VectorY[i] = Gravity.Y + (particles.StartVectorY[i] - Gravity.Y) * (1.f - d);
+		particles.VectorZ[i] = Gravity.Z + (particles.StartVectorZ[i] - Gravity.Z) * (1.f - d);
+	}
+}
+
+
 //! Writes attributes of the object.
 void CParticleGravityAffector::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
 {
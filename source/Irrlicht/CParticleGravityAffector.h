@@ -28,6 +28,12 @@ public:
 	//! Affects a particle.
 	virtual void affect(u32 now, SParticle* particlearray, u32 count) _IRR_OVERRIDE_;
 
+	//! Prepares affecting particles stored as structure of arrays.
+	virtual bool beginAffect(u32 now) _IRR_OVERRIDE_;
+
+	//! Affects a block of particles stored as structure of arrays.
+	virtual void affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end) _IRR_OVERRIDE_;
+
 	//! Set the time in milliseconds when the gravity force is totally
 	//! lost and the particle does not move any more.
 	virtual void setTimeForceLost( f32 timeForceLost ) _IRR_OVERRIDE_ { TimeForceLost = timeForceLost; }
@@ -16,7 +16,7 @@ namespace scene
 
 //! constructor
 CParticleRotationAffector::CParticleRotationAffector( const core::vector3df& speed, const core::vector3df& pivotPoint )
-		: PivotPoint(pivotPoint), Speed(speed), LastTime(0)
+		: PivotPoint(pivotPoint), Speed(speed), LastTime(0), Cos(1.f, 1.f, 1.f)
 {
 	#ifdef _DEBUG
 	setDebugName("CParticleRotationAffector");
@@ -52,6 +52,56 @@ void CParticleRotationAffector::affect(u32 now, SParticle* particlearray, u32 co
 	}
 }
 
+//! Prepares affecting particles stored as structure of arrays.
+bool CParticleRotationAffector::beginAffect(u32 now)
+{
+	if( LastTime == 0 )
+		LastTime = now;
+
+	const f64 timeDelta = ( now - LastTime ) / 1000.0;
+	LastTime = now;
+
+	// all particles rotate by the same angles
+	const core::vector3d<f64> angle(core::vector3d<f64>(Speed.X, Speed.Y, Speed.Z) * timeDelta * core::DEGTORAD64);
+	Sin.set((f32)sin(angle.X), (f32)sin(angle.Y), (f32)sin(angle.Z));
+	Cos.set((f32)cos(angle.X), (f32)cos(angle.Y), (f32)cos(angle.Z));
+	return true;
+}
+
+
+//! Affects a block of particles stored as structure of arrays.
+void CParticleRotationAffector::affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end)
+{
+	if( !Enabled )
+		return;
+
+	for(u32 i=begin; i<end; ++i)
+	{
+		f32 x = particles.PosX[i] - PivotPoint.X;
+		f32 y = particles.PosY[i] - PivotPoint.Y;
+		f32 z = particles.PosZ[i] - PivotPoint.Z;
+		f32 tmp;
+
+		// same order as in affect
+		tmp = y*Cos.X - z*Sin.X;
+		z = y*Sin.X + z*Cos.X;
+		y = tmp;
+
+		tmp = x*Cos.Y - z*Sin.Y;
+		z = x*Sin.Y + z*Cos.Y;
+		x = tmp;
+
+		tmp = x*Cos.Z - y*Sin.Z;
+		y = x*Sin.Z + y*Cos.Z;
+		x = tmp;
+
+		particles.PosX[i] = x + PivotPoint.X;
+		particles.PosY[i] = y + PivotPoint.Y;
+		particles.PosZ[i] = z + PivotPoint.Z;
+	}
+}
+
+
 //! Writes attributes of the object.
 void CParticleRotationAffector::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
 {
@@ -26,6 +26,12 @@ public:
 	//! Affects a particle.
 	virtual void affect(u32 now, SParticle* particlearray, u32 count) _IRR_OVERRIDE_;
 
+	//! Prepares affecting particles stored as structure of arrays.
+	virtual bool beginAffect(u32 now) _IRR_OVERRIDE_;
+
+	//! Affects a block of particles stored as structure of arrays.
+	virtual void affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end) _IRR_OVERRIDE_;
+
 	//! Set the point that particles will attract to
 	virtual void setPivotPoint( const core::vector3df& point ) _IRR_OVERRIDE_ { PivotPoint = point; }
 
@@ -49,6 +55,9 @@ private:
 	core::vector3df PivotPoint;
 	core::vector3df Speed;
 	u32 LastTime;
+	// rotation around each axis in the current update, set by beginAffect
+	core::vector3df Sin;
+	core::vector3df Cos;
 };
 
 } // end namespace scene
@@ -33,6 +33,25 @@ namespace irr
 		}
 
 
+		bool CParticleScaleAffector::beginAffect(u32 now)
+		{
+			return true;
+		}
+
+
+		void CParticleScaleAffector::affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end)
+		{
+			for(u32 i=begin;i<end;i++)
+			{
+				const u32 maxdiff = particles.EndTime[i] - particles.StartTime[i];
+				const u32 curdiff = now - particles.StartTime[i];
+				const f32 newscale = (f32)curdiff/maxdiff;
+				particles.SizeWidth[i] = particles.StartSizeWidth[i] + ScaleTo.Width*newscale;
+				particles.SizeHeight[i] = particles.StartSizeHeight[i] + ScaleTo.Height*newscale;
+			}
+		}
+
+
 		void CParticleScaleAffector::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
 		{
 			out->addFloat("ScaleToWidth", ScaleTo.Width);
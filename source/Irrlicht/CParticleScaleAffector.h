@@ -21,6 +21,12 @@ namespace irr
 
 			virtual void affect(u32 now, SParticle *particlearray, u32 count) _IRR_OVERRIDE_;
 
+			//! Prepares affecting particles stored as structure of arrays.
+			virtual bool beginAffect(u32 now) _IRR_OVERRIDE_;
+
+			//! Affects a block of particles stored as structure of arrays.
+			virtual void affectBlock(u32 now, const SParticleArrays& particles, u32 begin, u32 end) _IRR_OVERRIDE_;
+
 			//! Writes attributes of the object.
 			//! Implement this to expose the attributes of your scene node animator for
 			//! scripting languages, editors, debuggers or xml serialization purposes.
@@ -30,6 +30,29 @@ namespace irr
 namespace scene
 {
 
+namespace
+{
+	//! Particles updated and rendered together
+	const u32 PARTICLE_BLOCK_SIZE = 1024;
+	//! Minimal amount of particles to split the work between threads
+	const u32 PARTICLE_PARALLEL_COUNT = 8192;
+
+	template <class T>
+	void fillQuadIndices(T* indices, u32 begin, u32 end, u32 vertex)
+	{
+		for (u32 i=begin; i<end; i+=6)
+		{
+			indices[0+i] = (T)(0+vertex);
+			indices[1+i] = (T)(2+vertex);
+			indices[2+i] = (T)(1+vertex);
+			indices[3+i] = (T)(0+vertex);
+			indices[4+i] = (T)(3+vertex);
+			indices[5+i] = (T)(2+vertex);
+			vertex += 4;
+		}
+	}
+}
+
 //! constructor
 CParticleSystemSceneNode::CParticleSystemSceneNode(bool createDefaultEmitter,
 	ISceneNode* parent, ISceneManager* mgr, s32 id,
@@ -43,7 +66,7 @@ CParticleSystemSceneNode::CParticleSystemSceneNode(bool createDefaultEmitter,
 	setDebugName("CParticleSystemSceneNode");
 	#endif
 
-	Buffer = new SMeshBuffer();
+	Buffer = new CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_16BIT);
 	if (createDefaultEmitter)
 	{
 		IParticleEmitter* e = createBoxEmitter();
@@ -334,48 +357,52 @@ void CParticleSystemSceneNode::render()
 	// reallocate arrays, if they are too small
 	reallocateBuffers();
 
-	// create particle vertex data
-	s32 idx = 0;
-	for (u32 i=0; i<Particles.size(); ++i)
-	{
-		const SParticle& particle = Particles[i];
+	const SParticleArrays particles = Particles.getArrays();
+	const s32 count = (s32)Particles.size();
 
-		#if 0
-			core::vector3df horizontal = camera->getUpVector().crossProduct(view);
-			horizontal.normalize();
-			horizontal *= 0.5f * particle.size.Width;
+	// create particle vertex data, directly in the driver's streaming
+	// buffer as they change every frame. The streaming buffer holds old
+	// data of other draw calls, so all vertex members have to be written.
+	const video::SStreamAllocation stream = driver->allocateStream(video::ESB_VERTEX, count*4*sizeof(video::S3DVertex));
+	video::S3DVertex* vertices = stream.Data ? static_cast<video::S3DVertex*>(stream.Data) : Buffer->getVertexBuffer().pointer();
 
-			core::vector3df vertical = horizontal.crossProduct(view);
-			vertical.normalize();
-			vertical *= 0.5f * particle.size.Height;
+#ifdef _OPENMP
+	#pragma omp parallel for if(count >= (s32)PARTICLE_PARALLEL_COUNT)
+#endif
+	for (s32 i=0; i<count; ++i)
+	{
+		const core::vector3df pos(particles.PosX[i], particles.PosY[i], particles.PosZ[i]);
+		const video::SColor color = particles.Color[i];
 
-		#else
-			f32 f;
+		f32 f;
 
-			f = 0.5f * particle.size.Width;
-			const core::vector3df horizontal ( m[0] * f, m[4] * f, m[8] * f );
+		f = 0.5f * particles.SizeWidth[i];
+		const core::vector3df horizontal ( m[0] * f, m[4] * f, m[8] * f );
 
-			f = -0.5f * particle.size.Height;
-			const core::vector3df vertical ( m[1] * f, m[5] * f, m[9] * f );
-		#endif
+		f = -0.5f * particles.SizeHeight[i];
+		const core::vector3df vertical ( m[1] * f, m[5] * f, m[9] * f );
 
-		Buffer->Vertices[0+idx].Pos = particle.pos + horizontal + vertical;
-		Buffer->Vertices[0+idx].Color = particle.color;
-		Buffer->Vertices[0+idx].Normal = view;
+		video::S3DVertex* v = vertices + i*4;
 
-		Buffer->Vertices[1+idx].Pos = particle.pos + horizontal - vertical;
-		Buffer->Vertices[1+idx].Color = particle.color;
-		Buffer->Vertices[1+idx].Normal = view;
+		v[0].Pos = pos + horizontal + vertical;
+		v[0].Color = color;
+		v[0].Normal = view;
+		v[0].TCoords.set(0.0f, 0.0f);
 
-		Buffer->Vertices[2+idx].Pos = particle.pos - horizontal - vertical;
-		Buffer->Vertices[2+idx].Color = particle.color;
-		Buffer->Vertices[2+idx].Normal = view;
+		v[1].Pos = pos + horizontal - vertical;
+		v[1].Color = color;
+		v[1].Normal = view;
+		v[1].TCoords.set(0.0f, 1.0f);
 
-		Buffer->Vertices[3+idx].Pos = particle.pos - horizontal + vertical;
-		Buffer->Vertices[3+idx].Color = particle.color;
-		Buffer->Vertices[3+idx].Normal = view;
+		v[2].Pos = pos - horizontal - vertical;
+		v[2].Color = color;
+		v[2].Normal = view;
+		v[2].TCoords.set(1.0f, 1.0f);
 
-		idx +=4;
+		v[3].Pos = pos - horizontal + vertical;
+		v[3].Color = color;
+		v[3].Normal = view;
+		v[3].TCoords.set(1.0f, 0.0f);
 	}
 
 	// render all
@@ -386,8 +413,18 @@ void CParticleSystemSceneNode::render()
 
 	driver->setMaterial(Buffer->Material);
 
-	driver->drawVertexPrimitiveList(Buffer->getVertices(), Particles.size()*4,
-		Buffer->getIndices(), Particles.size()*2, video::EVT_STANDARD, EPT_TRIANGLES,Buffer->getIndexType());
+	// don't let the driver reject the whole system, better skip some particles
+	u32 primitiveCount = Particles.size()*2;
+	if (primitiveCount > driver->getMaximalPrimitiveCount())
+		primitiveCount = driver->getMaximalPrimitiveCount() & ~1;
+
+	IIndexBuffer& indices = Buffer->getIndexBuffer();
+	if (stream.Data)
+		driver->drawStreamedPrimitiveList(stream, primitiveCount*2,
+			indices.pointer(), primitiveCount, video::EVT_STANDARD, EPT_TRIANGLES, indices.getType());
+	else
+		driver->drawVertexPrimitiveList(vertices, primitiveCount*2,
+			indices.pointer(), primitiveCount, video::EVT_STANDARD, EPT_TRIANGLES, indices.getType());
 
 	// for debug purposes only:
 	if ( DebugDataVisible & scene::EDS_BBOX )
@@ -433,114 +470,207 @@ void CParticleSystemSceneNode::doParticleSystem(u32 time)
 
 		if (newParticles && array)
 		{
-			s32 j=Particles.size();
-			if (newParticles > 16250-j)	// avoid having more than 64k vertices in the scenenode
-				newParticles=16250-j;
-			Particles.set_used(j+newParticles);
-			for (s32 i=j; i<j+newParticles; ++i)
+			for (s32 i=0; i<newParticles; ++i)
 			{
-				Particles[i]=array[i-j];
+				SParticle particle = array[i];
 
 				if ( ParticlesAreGlobal && behavior & EPB_EMITTER_FRAME_INTERPOLATION )
 				{
 					// Interpolate between current node transformations and last ones.
 					// (Lazy solution - calculating twice and interpolating results)
 					f32 randInterpolate = (f32)(os::Randomizer::rand() % 101) / 100.f;	// 0 to 1
-					core::vector3df posNow(Particles[i].pos);
-					core::vector3df posLast(Particles[i].pos);
+					core::vector3df posNow(particle.pos);
+					core::vector3df posLast(particle.pos);
 
 					AbsoluteTransformation.transformVect(posNow);
 					LastAbsoluteTransformation.transformVect(posLast);
-					Particles[i].pos = posNow.getInterpolated(posLast, randInterpolate);
+					particle.pos = posNow.getInterpolated(posLast, randInterpolate);
 
 					if ( !(behavior & EPB_EMITTER_VECTOR_IGNORE_ROTATION) )
 					{
-						core::vector3df vecNow(Particles[i].startVector);
-						core::vector3df vecOld(Particles[i].startVector);
+						core::vector3df vecNow(particle.startVector);
+						core::vector3df vecOld(particle.startVector);
 						AbsoluteTransformation.rotateVect(vecNow);
 						LastAbsoluteTransformation.rotateVect(vecOld);
-						Particles[i].startVector = vecNow.getInterpolated(vecOld, randInterpolate);
+						particle.startVector = vecNow.getInterpolated(vecOld, randInterpolate);
 
-						vecNow = Particles[i].vector;
-						vecOld = Particles[i].vector;
+						vecNow = particle.vector;
+						vecOld = particle.vector;
 						AbsoluteTransformation.rotateVect(vecNow);
 						LastAbsoluteTransformation.rotateVect(vecOld);
-						Particles[i].vector = vecNow.getInterpolated(vecOld, randInterpolate);
+						particle.vector = vecNow.getInterpolated(vecOld, randInterpolate);
 					}
 				}
 				else
 				{
 					if (ParticlesAreGlobal)
-						AbsoluteTransformation.transformVect(Particles[i].pos);
+						AbsoluteTransformation.transformVect(particle.pos);
 
 					if ( !(behavior & EPB_EMITTER_VECTOR_IGNORE_ROTATION) )
 					{
 						if (!ParticlesAreGlobal)
-							AbsoluteTransformation.rotateVect(Particles[i].pos);
+							AbsoluteTransformation.rotateVect(particle.pos);
 
-						AbsoluteTransformation.rotateVect(Particles[i].startVector);
-						AbsoluteTransformation.rotateVect(Particles[i].vector);
+						AbsoluteTransformation.rotateVect(particle.startVector);
+						AbsoluteTransformation.rotateVect(particle.vector);
 					}
 				}
+
+				Particles.push_back(particle);
 			}
 		}
 	}
 
-	// run affectors
-	if ( visible || behavior & EPB_INVISIBLE_AFFECTING )
+	// run affectors and animate all particles
+	affectAndAnimate(now, timediff,
+		visible || behavior & EPB_INVISIBLE_AFFECTING,
+		visible || behavior & EPB_INVISIBLE_ANIMATING);
+
+	const f32 m = (ParticleSize.Width > ParticleSize.Height ? ParticleSize.Width : ParticleSize.Height) * 0.5f;
+	Buffer->BoundingBox.MaxEdge.X += m;
+	Buffer->BoundingBox.MaxEdge.Y += m;
+	Buffer->BoundingBox.MaxEdge.Z += m;
+
+	Buffer->BoundingBox.MinEdge.X -= m;
+	Buffer->BoundingBox.MinEdge.Y -= m;
+	Buffer->BoundingBox.MinEdge.Z -= m;
+
+	if (ParticlesAreGlobal)
+	{
+		core::matrix4 absinv( AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE );
+		absinv.transformBoxEx(Buffer->BoundingBox);
+	}
+
+	LastAbsoluteTransformation = AbsoluteTransformation;
+}
+
+
+//! Runs the affectors and moves the particles in blocks
+void CParticleSystemSceneNode::affectAndAnimate(u32 now, u32 timediff, bool affect, bool animate)
+{
+	// affectors which can't work on the particle arrays need a copy of
+	// the particles, then all affectors run over all particles in order
+	BlockAffectors.set_used(0);
+	bool allBlockAffectors = true;
+	if (affect)
 	{
 		core::list<IParticleAffector*>::Iterator ait = AffectorList.begin();
 		for (; ait != AffectorList.end(); ++ait)
-			(*ait)->affect(now, Particles.pointer(), Particles.size());
+		{
+			if ((*ait)->beginAffect(now))
+				BlockAffectors.push_back(*ait);
+			else
+				allBlockAffectors = false;
+		}
 	}
 
-	if (ParticlesAreGlobal)
-		Buffer->BoundingBox.reset(AbsoluteTransformation.getTranslation());
-	else
-		Buffer->BoundingBox.reset(core::vector3df(0,0,0));
-
-	// animate all particles
-	if ( visible || behavior & EPB_INVISIBLE_ANIMATING )
+	if (!allBlockAffectors)
 	{
-		f32 scale = (f32)timediff;
+		const SParticleArrays particles = Particles.getArrays();
+		bool copied = false;
+		u32 b = 0;
 
-		for (u32 i=0; i<Particles.size();)
+		core::list<IParticleAffector*>::Iterator ait = AffectorList.begin();
+		for (; ait != AffectorList.end(); ++ait)
 		{
-			// erase is pretty expensive!
-			if (now > Particles[i].endTime)
+			if (b < BlockAffectors.size() && BlockAffectors[b] == *ait)
 			{
-				// Particle order does not seem to matter.
-				// So we can delete by switching with last particle and deleting that one.
-				// This is a lot faster and speed is very important here as the erase otherwise
-				// can cause noticable freezes.
-				Particles[i] = Particles[Particles.size()-1];
-				Particles.erase( Particles.size()-1 );
+				if (copied)
+				{
+					Particles.copyFrom(ParticleCopy);
+					copied = false;
+				}
+				(*ait)->affectBlock(now, particles, 0, Particles.size());
+				++b;
 			}
 			else
 			{
-				Particles[i].pos += (Particles[i].vector * scale);
-				Buffer->BoundingBox.addInternalPoint(Particles[i].pos);
-				++i;
+				if (!copied)
+				{
+					Particles.copyTo(ParticleCopy);
+					copied = true;
+				}
+				(*ait)->affect(now, ParticleCopy.pointer(), ParticleCopy.size());
 			}
 		}
+
+		if (copied)
+			Particles.copyFrom(ParticleCopy);
+		BlockAffectors.set_used(0);
 	}
 
-	const f32 m = (ParticleSize.Width > ParticleSize.Height ? ParticleSize.Width : ParticleSize.Height) * 0.5f;
-	Buffer->BoundingBox.MaxEdge.X += m;
-	Buffer->BoundingBox.MaxEdge.Y += m;
-	Buffer->BoundingBox.MaxEdge.Z += m;
+	if (ParticlesAreGlobal)
+		Buffer->BoundingBox.reset(AbsoluteTransformation.getTranslation());
+	else
+		Buffer->BoundingBox.reset(core::vector3df(0,0,0));
 
-	Buffer->BoundingBox.MinEdge.X -= m;
-	Buffer->BoundingBox.MinEdge.Y -= m;
-	Buffer->BoundingBox.MinEdge.Z -= m;
+	if (BlockAffectors.empty() && !animate)
+		return;
 
-	if (ParticlesAreGlobal)
+	// Blocks are independent of each other. Each one runs all affectors and
+	// the animation while its particles are still in the cache.
+	const SParticleArrays particles = Particles.getArrays();
+	const u32 count = Particles.size();
+	const s32 blockCount = (s32)((count + PARTICLE_BLOCK_SIZE - 1) / PARTICLE_BLOCK_SIZE);
+	const f32 scale = (f32)timediff;
+	BlockBoxes.set_used(blockCount);
+
+#ifdef _OPENMP
+	#pragma omp parallel for if(count >= PARTICLE_PARALLEL_COUNT)
+#endif
+	for (s32 b=0; b<blockCount; ++b)
 	{
-		core::matrix4 absinv( AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE );
-		absinv.transformBoxEx(Buffer->BoundingBox);
+		const u32 begin = b * PARTICLE_BLOCK_SIZE;
+		const u32 end = core::min_(begin + PARTICLE_BLOCK_SIZE, count);
+
+		for (u32 a=0; a<BlockAffectors.size(); ++a)
+			BlockAffectors[a]->affectBlock(now, particles, begin, end);
+
+		if (!animate)
+			continue;
+
+		u32 i;
+		for (i=begin; i<end; ++i)
+			particles.PosX[i] += particles.VectorX[i] * scale;
+		for (i=begin; i<end; ++i)
+			particles.PosY[i] += particles.VectorY[i] * scale;
+		for (i=begin; i<end; ++i)
+			particles.PosZ[i] += particles.VectorZ[i] * scale;
+
+		// only particles which survive this update count, an empty block
+		// keeps its inverted box
+		core::aabbox3df& box = BlockBoxes[b];
+		box.MinEdge.set(FLT_MAX, FLT_MAX, FLT_MAX);
+		box.MaxEdge.set(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (i=begin; i<end; ++i)
+		{
+			if (now <= particles.EndTime[i])
+				box.addInternalPoint(particles.PosX[i], particles.PosY[i], particles.PosZ[i]);
+		}
 	}
 
-	LastAbsoluteTransformation = AbsoluteTransformation;
+	BlockAffectors.set_used(0);
+
+	if (!animate)
+		return;
+
+	for (s32 b=0; b<blockCount; ++b)
+	{
+		if (BlockBoxes[b].MinEdge.X <= BlockBoxes[b].MaxEdge.X)
+			Buffer->BoundingBox.addInternalBox(BlockBoxes[b]);
+	}
+
+	for (u32 i=0; i<Particles.size();)
+	{
+		// Particle order does not seem to matter.
+		// So we can delete by switching with last particle and deleting that one.
+		// This is a lot faster and speed is very important here as the erase otherwise
+		// can cause noticable freezes.
+		if (now > particles.EndTime[i])
+			Particles.swapRemove(i);
+		else
+			++i;
+	}
 }
 
 
@@ -555,7 +685,7 @@ void CParticleSystemSceneNode::setParticlesAreGlobal(bool global)
 //! Remove all currently visible particles
 void CParticleSystemSceneNode::clearParticles()
 {
-	Particles.set_used(0);
+	Particles.clear();
 }
 
 //! Sets if the node should be visible or not.
@@ -585,38 +715,37 @@ void CParticleSystemSceneNode::setParticleSize(const core::dimension2d<f32> &siz
 
 void CParticleSystemSceneNode::reallocateBuffers()
 {
-	if (Particles.size() * 4 > Buffer->getVertexCount() ||
-			Particles.size() * 6 > Buffer->getIndexCount())
-	{
-		u32 oldSize = Buffer->getVertexCount();
-		Buffer->Vertices.set_used(Particles.size() * 4);
+	IVertexBuffer& vertexBuffer = Buffer->getVertexBuffer();
+	IIndexBuffer& indexBuffer = Buffer->getIndexBuffer();
 
-		u32 i;
+	if (Particles.size() * 4 > vertexBuffer.size() ||
+			Particles.size() * 6 > indexBuffer.size())
+	{
+		u32 oldSize = vertexBuffer.size();
+		vertexBuffer.set_used(Particles.size() * 4);
 
 		// fill remaining vertices
-		for (i=oldSize; i<Buffer->Vertices.size(); i+=4)
+		video::S3DVertex* vertices = vertexBuffer.pointer();
+		for (u32 i=oldSize; i<vertexBuffer.size(); i+=4)
 		{
-			Buffer->Vertices[0+i].TCoords.set(0.0f, 0.0f);
-			Buffer->Vertices[1+i].TCoords.set(0.0f, 1.0f);
-			Buffer->Vertices[2+i].TCoords.set(1.0f, 1.0f);
-			Buffer->Vertices[3+i].TCoords.set(1.0f, 0.0f);
+			vertices[0+i].TCoords.set(0.0f, 0.0f);
+			vertices[1+i].TCoords.set(0.0f, 1.0f);
+			vertices[2+i].TCoords.set(1.0f, 1.0f);
+			vertices[3+i].TCoords.set(1.0f, 0.0f);
 		}
 
+		// 16 bit indices can't address more than 65536 vertices
+		if (vertexBuffer.size() > 65536 && indexBuffer.getType() == video::EIT_16BIT)
+			indexBuffer.setType(video::EIT_32BIT);
+
 		// fill remaining indices
-		u32 oldIdxSize = Buffer->getIndexCount();
-		u32 oldvertices = oldSize;
-		Buffer->Indices.set_used(Particles.size() * 6);
+		u32 oldIdxSize = indexBuffer.size();
+		indexBuffer.set_used(Particles.size() * 6);
 
-		for (i=oldIdxSize; i<Buffer->Indices.size(); i+=6)
-		{
-			Buffer->Indices[0+i] = (u16)0+oldvertices;
-			Buffer->Indices[1+i] = (u16)2+oldvertices;
-			Buffer->Indices[2+i] = (u16)1+oldvertices;
-			Buffer->Indices[3+i] = (u16)0+oldvertices;
-			Buffer->Indices[4+i] = (u16)3+oldvertices;
-			Buffer->Indices[5+i] = (u16)2+oldvertices;
-			oldvertices += 4;
-		}
+		if (indexBuffer.getType() == video::EIT_32BIT)
+			fillQuadIndices(static_cast<u32*>(indexBuffer.pointer()), oldIdxSize, indexBuffer.size(), oldSize);
+		else
+			fillQuadIndices(static_cast<u16*>(indexBuffer.pointer()), oldIdxSize, indexBuffer.size(), oldSize);
 	}
 }
 
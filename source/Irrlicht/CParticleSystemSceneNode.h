@@ -11,7 +11,8 @@
 #include "IParticleSystemSceneNode.h"
 #include "irrArray.h"
 #include "irrList.h"
-#include "SMeshBuffer.h"
+#include "CDynamicMeshBuffer.h"
+#include "CParticleArrays.h"
 
 namespace irr
 {
@@ -218,14 +219,24 @@ private:
 
 	void reallocateBuffers();
 
+	//! Runs the affectors and moves the particles in blocks
+	void affectAndAnimate(u32 now, u32 timediff, bool affect, bool animate);
+
 	core::list<IParticleAffector*> AffectorList;
 	IParticleEmitter* Emitter;
-	core::array<SParticle> Particles;
+	CParticleArrays Particles;
 	core::dimension2d<f32> ParticleSize;
 	u32 LastEmitTime;
 	core::matrix4 LastAbsoluteTransformation;
 
-	SMeshBuffer* Buffer;
+	CDynamicMeshBuffer* Buffer;
+
+	//! Affectors which work on the particle arrays in this update
+	core::array<IParticleAffector*> BlockAffectors;
+	//! Bounding boxes of the particle blocks in this update
+	core::array<core::aabbox3df> BlockBoxes;
+	//! Particles as array of structures for affectors without affectBlock
+	core::array<SParticle> ParticleCopy;
 
 // TODO: That was obviously planned by someone at some point and sounds like a good idea.
 // But seems it was never implemented.
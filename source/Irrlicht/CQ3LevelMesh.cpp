@@ -13,6 +13,7 @@
 #include "ILightSceneNode.h"
 #include "IQ3Shader.h"
 #include "IFileList.h"
+#include "irrMap.h"
 
 //#define TJUNCTION_SOLVER_ROUND
 //#define TJUNCTION_SOLVER_0125
@@ -30,8 +31,9 @@ CQ3LevelMesh::CQ3LevelMesh(io::IFileSystem* fs, scene::ISceneManager* smgr,
 	: LoadParam(loadParam), Textures(0), NumTextures(0), LightMaps(0), NumLightMaps(0),
 	Vertices(0), NumVertices(0), Faces(0), NumFaces(0), Models(0), NumModels(0),
 	Planes(0), NumPlanes(0), Nodes(0), NumNodes(0), Leafs(0), NumLeafs(0),
-	LeafFaces(0), NumLeafFaces(0), MeshVerts(0), NumMeshVerts(0),
-	Brushes(0), NumBrushes(0), BrushEntities(0), FileSystem(fs),
+	LeafFaces(0), NumLeafFaces(0), NumClusters(0), BytesPerCluster(0),
+	MeshVerts(0), NumMeshVerts(0), Brushes(0), NumBrushes(0),
+	BrushEntities(0), FileSystem(fs),
 	SceneManager(smgr), FramesPerSecond(25.f)
 {
 	#ifdef _DEBUG
@@ -162,6 +164,7 @@ bool CQ3LevelMesh::loadFile(io::IReadFile* file)
 
 	cleanMeshes();
 	calcBoundingBoxes();
+	constructVisibility();
 	cleanLoader();
 
 	return true;
@@ -182,6 +185,7 @@ void CQ3LevelMesh::cleanLoader ()
 	delete [] LeafFaces; LeafFaces = 0;
 	delete [] MeshVerts; MeshVerts = 0;
 	delete [] Brushes; Brushes = 0;
+	FaceBuffers.clear();
 
 	Lightmap.clear();
 	Tex.clear();
@@ -314,7 +318,24 @@ void CQ3LevelMesh::loadFaces(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumPlanes = l->length / sizeof(tBSPPlane);
+	if ( !NumPlanes )
+		return;
+	Planes = new tBSPPlane[NumPlanes];
+
+	file->seek(l->offset);
+	file->read(Planes, l->length);
+
+	if ( LoadParam.swapHeader )
+	{
+		for (s32 i=0;i<NumPlanes;++i)
+		{
+			Planes[i].vNormal[0] = os::Byteswap::byteswap(Planes[i].vNormal[0]);
+			Planes[i].vNormal[1] = os::Byteswap::byteswap(Planes[i].vNormal[1]);
+			Planes[i].vNormal[2] = os::Byteswap::byteswap(Planes[i].vNormal[2]);
+			Planes[i].d = os::Byteswap::byteswap(Planes[i].d);
+		}
+	}
 }
 
 
@@ -322,7 +343,23 @@ void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumNodes = l->length / sizeof(tBSPNode);
+	if ( !NumNodes )
+		return;
+	Nodes = new tBSPNode[NumNodes];
+
+	file->seek(l->offset);
+	file->read(Nodes, l->length);
+
+	if ( LoadParam.swapHeader )
+	{
+		for (s32 i=0;i<NumNodes;++i)
+		{
+			Nodes[i].plane = os::Byteswap::byteswap(Nodes[i].plane);
+			Nodes[i].front = os::Byteswap::byteswap(Nodes[i].front);
+			Nodes[i].back = os::Byteswap::byteswap(Nodes[i].back);
+		}
+	}
 }
 
 
@@ -330,7 +367,29 @@ void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafs = l->length / sizeof(tBSPLeaf);
+	if ( !NumLeafs )
+		return;
+	Leafs = new tBSPLeaf[NumLeafs];
+
+	file->seek(l->offset);
+	file->read(Leafs, l->length);
+
+	if ( LoadParam.swapHeader )
+	{
+		for (s32 i=0;i<NumLeafs;++i)
+		{
+			Leafs[i].cluster = os::Byteswap::byteswap(Leafs[i].cluster);
+			Leafs[i].mins[0] = os::Byteswap::byteswap(Leafs[i].mins[0]);
+			Leafs[i].mins[1] = os::Byteswap::byteswap(Leafs[i].mins[1]);
+			Leafs[i].mins[2] = os::Byteswap::byteswap(Leafs[i].mins[2]);
+			Leafs[i].maxs[0] = os::Byteswap::byteswap(Leafs[i].maxs[0]);
+			Leafs[i].maxs[1] = os::Byteswap::byteswap(Leafs[i].maxs[1]);
+			Leafs[i].maxs[2] = os::Byteswap::byteswap(Leafs[i].maxs[2]);
+			Leafs[i].leafface = os::Byteswap::byteswap(Leafs[i].leafface);
+			Leafs[i].numOfLeafFaces = os::Byteswap::byteswap(Leafs[i].numOfLeafFaces);
+		}
+	}
 }
 
 
@@ -338,7 +397,19 @@ void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafFaces(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafFaces = l->length / sizeof(s32);
+	if ( !NumLeafFaces )
+		return;
+	LeafFaces = new s32[NumLeafFaces];
+
+	file->seek(l->offset);
+	file->read(LeafFaces, l->length);
+
+	if ( LoadParam.swapHeader )
+	{
+		for (s32 i=0;i<NumLeafFaces;++i)
+			LeafFaces[i] = os::Byteswap::byteswap(LeafFaces[i]);
+	}
 }
 
 
@@ -346,7 +417,35 @@ void CQ3LevelMesh::loadLeafFaces(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadVisData(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumClusters = 0;
+	BytesPerCluster = 0;
+	ClusterVisibility.clear();
+
+	if ( l->length < 2 * (s32) sizeof(s32) )
+		return;
+
+	s32 header[2];
+	file->seek(l->offset);
+	file->read(header, sizeof(header));
+
+	if ( LoadParam.swapHeader )
+	{
+		header[0] = os::Byteswap::byteswap(header[0]);
+		header[1] = os::Byteswap::byteswap(header[1]);
+	}
+
+	// the bitset of each cluster needs a bit for every cluster
+	if ( header[0] <= 0 || header[1] < (header[0] + 7) / 8 ||
+		l->length - (s32) sizeof(header) < header[0] * header[1] )
+	{
+		os::Printer::log("Ignoring invalid visibility data of .bsp file", file->getFileName(), ELL_WARNING);
+		return;
+	}
+
+	NumClusters = header[0];
+	BytesPerCluster = header[1];
+	ClusterVisibility.set_used(NumClusters * BytesPerCluster);
+	file->read(ClusterVisibility.pointer(), ClusterVisibility.size());
 }
 
 
@@ -965,6 +1064,8 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 			}
 
 
+			const u32 firstIndex = buffer->getIndexCount();
+
 			switch(Faces[i].type)
 			{
 				case 4: // billboards
@@ -1018,6 +1119,14 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 					break;
 
 			} // end switch
+
+			// remember the triangles of the level geometry for visibility culling
+			if ( 0 == num && item[g].index == E_Q3_MESH_GEOMETRY )
+			{
+				FaceBuffers[i] = buffer;
+				FaceIndices[i].FirstIndex = firstIndex;
+				FaceIndices[i].IndexCount = buffer->getIndexCount() - firstIndex;
+			}
 		}
 	}
 
@@ -1054,6 +1163,17 @@ void CQ3LevelMesh::constructMesh()
 
 	s32 i, j;
 
+	// faces are mapped to the final mesh buffers in constructVisibility
+	FaceIndices.set_used(NumFaces);
+	FaceBuffers.set_used(NumFaces);
+	for (i = 0; i < NumFaces; i++)
+	{
+		FaceIndices[i].MeshBuffer = -1;
+		FaceIndices[i].FirstIndex = 0;
+		FaceIndices[i].IndexCount = 0;
+		FaceBuffers[i] = 0;
+	}
+
 	// First the main level
 	SMesh **tmp = buildMesh(0);
 
@@ -1095,6 +1215,141 @@ void CQ3LevelMesh::constructMesh()
 }
 
 
+/*!
+	keeps the bsp tree, the leafs and the visibility data of the level in
+	irrlicht coordinates after loading.
+*/
+void CQ3LevelMesh::constructVisibility()
+{
+	s32 i;
+
+	// cleanMeshes might have removed or moved mesh buffers
+	core::map<IMeshBuffer*, s32> bufferIndex;
+	const SMesh* geometry = Mesh[E_Q3_MESH_GEOMETRY];
+	for (i = 0; i < (s32)geometry->MeshBuffers.size(); ++i)
+		bufferIndex.insert(geometry->MeshBuffers[i], i);
+
+	for (i = 0; i < (s32)FaceIndices.size(); ++i)
+	{
+		core::map<IMeshBuffer*, s32>::Node* n = FaceBuffers[i] ? bufferIndex.find(FaceBuffers[i]) : 0;
+		FaceIndices[i].MeshBuffer = n ? n->getValue() : -1;
+	}
+
+	BspPlanes.clear();
+	BspNodes.clear();
+	BspLeafs.clear();
+	BspLeafFaces.clear();
+
+	if ( 0 == NumNodes || 0 == NumLeafs )
+		return;
+
+	// swap y and z like for the vertices
+	BspPlanes.set_used(NumPlanes);
+	for (i = 0; i < NumPlanes; ++i)
+	{
+		const tBSPPlane& p = Planes[i];
+		BspPlanes[i] = core::plane3df(core::vector3df(p.vNormal[0], p.vNormal[2], p.vNormal[1]), -p.d);
+	}
+
+	// children always come after their parent, which also keeps findLeaf from looping
+	bool valid = true;
+	BspNodes.set_used(NumNodes);
+	for (i = 0; i < NumNodes && valid; ++i)
+	{
+		const tBSPNode& n = Nodes[i];
+		valid = n.plane >= 0 && n.plane < NumPlanes &&
+			( n.front < 0 ? -n.front <= NumLeafs : ( n.front > i && n.front < NumNodes ) ) &&
+			( n.back < 0 ? -n.back <= NumLeafs : ( n.back > i && n.back < NumNodes ) );
+
+		BspNodes[i].Plane = n.plane;
+		BspNodes[i].Front = n.front;
+		BspNodes[i].Back = n.back;
+	}
+
+	if ( !valid )
+	{
+		os::Printer::log("quake3::constructVisibility ignoring invalid bsp tree", LevelName.c_str(), ELL_WARNING);
+		BspPlanes.clear();
+		BspNodes.clear();
+		return;
+	}
+
+	BspLeafFaces.set_used(NumLeafFaces);
+	for (i = 0; i < NumLeafFaces; ++i)
+		BspLeafFaces[i] = (u32) LeafFaces[i];
+
+	BspLeafs.set_used(NumLeafs);
+	for (i = 0; i < NumLeafs; ++i)
+	{
+		const tBSPLeaf& l = Leafs[i];
+		quake3::SBSPLeaf& leaf = BspLeafs[i];
+
+		leaf.Cluster = l.cluster;
+		leaf.Box.reset(core::vector3df((f32)l.mins[0], (f32)l.mins[2], (f32)l.mins[1]));
+		leaf.Box.addInternalPoint(core::vector3df((f32)l.maxs[0], (f32)l.maxs[2], (f32)l.maxs[1]));
+		leaf.FirstFace = 0;
+		leaf.FaceCount = 0;
+
+		if ( l.leafface < 0 || l.numOfLeafFaces <= 0 || l.leafface + l.numOfLeafFaces > NumLeafFaces )
+			continue;
+
+		s32 f;
+		for (f = l.leafface; f < l.leafface + l.numOfLeafFaces; ++f)
+		{
+			if ( LeafFaces[f] < 0 || LeafFaces[f] >= NumFaces )
+				break;
+		}
+
+		if ( f == l.leafface + l.numOfLeafFaces )
+		{
+			leaf.FirstFace = l.leafface;
+			leaf.FaceCount = l.numOfLeafFaces;
+		}
+	}
+
+	if ( LoadParam.verbose > 0 )
+	{
+		snprintf_irr( buf, sizeof ( buf ),
+			"quake3::constructVisibility %d nodes, %d leafs, %d clusters",
+			NumNodes,
+			NumLeafs,
+			NumClusters
+			);
+		os::Printer::log(buf, ELL_INFORMATION);
+	}
+}
+
+
+//! returns the leaf which contains a position
+s32 CQ3LevelMesh::findLeaf(const core::vector3df& pos) const
+{
+	if ( BspNodes.empty() )
+		return -1;
+
+	s32 index = 0;
+	while ( index >= 0 )
+	{
+		const SBSPNode& node = BspNodes[index];
+		index = BspPlanes[node.Plane].getDistanceTo(pos) >= 0.f ? node.Front : node.Back;
+	}
+
+	return -index - 1;
+}
+
+
+//! returns if a cluster is potentially visible from another cluster
+bool CQ3LevelMesh::isClusterVisible(s32 from, s32 to) const
+{
+	if ( to < 0 )
+		return false;
+
+	if ( from < 0 || from >= NumClusters || to >= NumClusters )
+		return true;
+
+	return ( ClusterVisibility[from * BytesPerCluster + (to >> 3)] & (1 << (to & 7)) ) != 0;
+}
+
+
 void CQ3LevelMesh::S3DVertex2TCoords_64::copy( video::S3DVertex2TCoords &dest ) const
 {
 #if defined (TJUNCTION_SOLVER_ROUND)
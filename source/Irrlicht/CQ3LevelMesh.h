@@ -12,6 +12,7 @@
 #include "SMeshBufferLightMap.h"
 #include "IVideoDriver.h"
 #include "irrString.h"
+#include "plane3d.h"
 #include "ISceneManager.h"
 #include "os.h"
 
@@ -89,6 +90,30 @@ namespace scene
 		//! returns the requested brush entity
 		virtual IMesh* getBrushEntityMesh(quake3::IEntity &ent) const _IRR_OVERRIDE_;
 
+		//! returns the leafs of the bsp tree
+		virtual const core::array<quake3::SBSPLeaf>& getLeafs() const _IRR_OVERRIDE_
+		{
+			return BspLeafs;
+		}
+
+		//! returns the faces of all leafs
+		virtual const core::array<u32>& getLeafFaces() const _IRR_OVERRIDE_
+		{
+			return BspLeafFaces;
+		}
+
+		//! returns where the triangles of each face are stored
+		virtual const core::array<quake3::SBSPFaceIndices>& getFaceIndices() const _IRR_OVERRIDE_
+		{
+			return FaceIndices;
+		}
+
+		//! returns the leaf which contains a position
+		virtual s32 findLeaf(const core::vector3df& pos) const _IRR_OVERRIDE_;
+
+		//! returns if a cluster is potentially visible from another cluster
+		virtual bool isClusterVisible(s32 from, s32 to) const _IRR_OVERRIDE_;
+
 		//Link to held meshes? ...
 
 
@@ -133,6 +158,7 @@ namespace scene
 
 
 		void constructMesh();
+		void constructVisibility();
 		void solveTJunction();
 		void loadTextures();
 		scene::SMesh** buildMesh(s32 num);
@@ -404,6 +430,25 @@ namespace scene
 		s32 *LeafFaces;
 		s32 NumLeafFaces;
 
+		// bsp tree and visibility data, kept after loading
+		struct SBSPNode
+		{
+			s32 Plane;
+			s32 Front;	// child node, or -(leaf+1)
+			s32 Back;
+		};
+
+		core::array<core::plane3df> BspPlanes;
+		core::array<SBSPNode> BspNodes;
+		core::array<quake3::SBSPLeaf> BspLeafs;
+		core::array<u32> BspLeafFaces;
+		core::array<quake3::SBSPFaceIndices> FaceIndices;
+		core::array<IMeshBuffer*> FaceBuffers; // only valid while loading
+
+		s32 NumClusters;
+		s32 BytesPerCluster;
+		core::array<u8> ClusterVisibility;
+
 		s32 *MeshVerts;           // The vertex offsets for a mesh
 		s32 NumMeshVerts;
 
@@ -0,0 +1,394 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+
+#include "CQ3LevelSceneNode.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "ICameraSceneNode.h"
+#include "IMaterialRenderer.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	//! true if the box is completely outside of one of the frustum planes
+	inline bool isBoxOutsideFrustum(const SViewFrustum& frustum, const core::aabbox3d<f32>& box)
+	{
+		for (u32 i=0; i<SViewFrustum::VF_PLANE_COUNT; ++i)
+		{
+			const core::plane3df& plane = frustum.planes[i];
+
+			// the planes point out of the frustum, so test the corner
+			// which is furthest behind the plane
+			const core::vector3df corner(
+				plane.Normal.X >= 0.f ? box.MinEdge.X : box.MaxEdge.X,
+				plane.Normal.Y >= 0.f ? box.MinEdge.Y : box.MaxEdge.Y,
+				plane.Normal.Z >= 0.f ? box.MinEdge.Z : box.MaxEdge.Z);
+
+			if (plane.getDistanceTo(corner) > 0.f)
+				return true;
+		}
+		return false;
+	}
+}
+
+
+//! constructor
+CQ3LevelSceneNode::CQ3LevelSceneNode(IQ3LevelMesh* mesh, ISceneNode* parent,
+		ISceneManager* mgr, s32 id)
+	: IQ3LevelSceneNode(parent, mgr, id), Mesh(mesh), Stamp(0),
+	CameraCluster(-1), ConsideredFaces(0), DrawnFaces(0), GeometryFaces(0),
+	PassCount(0), PVSCulling(true), FrustumCulling(true), VisibleLeafsValid(false)
+{
+#ifdef _DEBUG
+	setDebugName("CQ3LevelSceneNode");
+#endif
+
+	if (!Mesh)
+		return;
+
+	Mesh->grab();
+
+	const IMesh* geometry = Mesh->getMesh(quake3::E_Q3_MESH_GEOMETRY);
+	if (!geometry)
+		return;
+
+	Box = geometry->getBoundingBox();
+
+	const u32 bufferCount = geometry->getMeshBufferCount();
+	Buffers.set_used(bufferCount);
+	Materials.set_used(bufferCount);
+
+	u32 i;
+	for (i=0; i<bufferCount; ++i)
+	{
+		IMeshBuffer* mb = geometry->getMeshBuffer(i);
+		Materials[i] = mb->getMaterial();
+
+		// the level loader only creates lightmap buffers
+		if (mb->getVertexType() != video::EVT_2TCOORDS || mb->getIndexType() != video::EIT_16BIT)
+			continue;
+
+		SVisibleBuffer& vb = Buffers[i];
+		vb.Source = static_cast<const SMeshBufferLightMap*>(mb);
+
+		// share the vertices, they are never changed by this node
+		vb.Buffer = new SMeshBufferLightMap();
+		vb.Buffer->Vertices.set_pointer(
+			const_cast<video::S3DVertex2TCoords*>(vb.Source->Vertices.const_pointer()),
+			vb.Source->Vertices.size(), false, false);
+		vb.Buffer->BoundingBox = vb.Source->BoundingBox;
+		vb.Buffer->setHardwareMappingHint(EHM_STATIC, EBT_VERTEX);
+		vb.Buffer->setHardwareMappingHint(EHM_DYNAMIC, EBT_INDEX);
+	}
+
+	const core::array<quake3::SBSPFaceIndices>& faces = Mesh->getFaceIndices();
+	for (i=0; i<faces.size(); ++i)
+	{
+		const quake3::SBSPFaceIndices& face = faces[i];
+		if (face.MeshBuffer < 0 || face.MeshBuffer >= (s32)bufferCount || 0 == face.IndexCount)
+			continue;
+
+		SVisibleBuffer& vb = Buffers[face.MeshBuffer];
+		if (vb.Buffer && face.FirstIndex + face.IndexCount <= vb.Source->Indices.size())
+		{
+			vb.Faces.push_back(i);
+			++GeometryFaces;
+		}
+	}
+
+	FaceStamps.set_used(faces.size());
+	for (i=0; i<FaceStamps.size(); ++i)
+		FaceStamps[i] = 0;
+}
+
+
+//! destructor
+CQ3LevelSceneNode::~CQ3LevelSceneNode()
+{
+	for (u32 i=0; i<Buffers.size(); ++i)
+	{
+		if (Buffers[i].Buffer)
+			Buffers[i].Buffer->drop();
+	}
+
+	if (Mesh)
+		Mesh->drop();
+}
+
+
+void CQ3LevelSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Mesh)
+	{
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+		PassCount = 0;
+		u32 transparentCount = 0;
+		u32 solidCount = 0;
+
+		for (u32 i=0; i<Materials.size(); ++i)
+		{
+			const video::IMaterialRenderer* const rnd =
+				driver->getMaterialRenderer(Materials[i].MaterialType);
+
+			if ((rnd && rnd->isTransparent()) || Materials[i].isTransparent())
+				++transparentCount;
+			else
+				++solidCount;
+
+			if (solidCount && transparentCount)
+				break;
+		}
+
+		if (solidCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_SOLID);
+
+		if (transparentCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
+	}
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! renders the node.
+void CQ3LevelSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	if (!Mesh || !driver || !SceneManager->getActiveCamera())
+		return;
+
+	// visibility only changes once per frame, not per render pass
+	if (0 == PassCount++)
+		calculateVisibleFaces();
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	for (u32 i=0; i<Buffers.size(); ++i)
+	{
+		const SVisibleBuffer& vb = Buffers[i];
+		if (!vb.Buffer || 0 == vb.Buffer->getIndexCount())
+			continue;
+
+		const video::IMaterialRenderer* const rnd =
+			driver->getMaterialRenderer(Materials[i].MaterialType);
+		const bool transparent = (rnd && rnd->isTransparent()) || Materials[i].isTransparent();
+
+		if (transparent == isTransparentPass)
+		{
+			driver->setMaterial(Materials[i]);
+			driver->drawMeshBuffer(vb.Buffer);
+		}
+	}
+
+	if (DebugDataVisible & scene::EDS_BBOX)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+		driver->draw3DBox(Box, video::SColor(255,255,255,255));
+	}
+}
+
+
+void CQ3LevelSceneNode::calculateVisibleFaces()
+{
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	const core::array<quake3::SBSPLeaf>& leafs = Mesh->getLeafs();
+	const core::array<u32>& leafFaces = Mesh->getLeafFaces();
+
+	// camera and frustum in mesh coordinates
+	core::vector3df cameraPos = camera->getAbsolutePosition();
+	SViewFrustum frustum = *camera->getViewFrustum();
+	if (!AbsoluteTransformation.isIdentity())
+	{
+		core::matrix4 invTrans(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE);
+		invTrans.transformVect(cameraPos);
+		frustum.transform(invTrans);
+	}
+
+	const s32 leaf = Mesh->findLeaf(cameraPos);
+	const s32 cluster = leaf >= 0 ? leafs[leaf].Cluster : -1;
+	if (!VisibleLeafsValid || cluster != CameraCluster)
+		updateVisibleLeafs(cluster);
+
+	nextStamp();
+	u32 i;
+
+	if (leafs.empty())
+	{
+		// no bsp tree, so there is nothing to cull with
+		for (i=0; i<FaceStamps.size(); ++i)
+			FaceStamps[i] = Stamp;
+	}
+	else
+	{
+		for (i=0; i<VisibleLeafs.size(); ++i)
+		{
+			const quake3::SBSPLeaf& l = leafs[VisibleLeafs[i]];
+			if (FrustumCulling && isBoxOutsideFrustum(frustum, l.Box))
+				continue;
+
+			const u32 end = l.FirstFace + l.FaceCount;
+			for (u32 f=l.FirstFace; f<end; ++f)
+				FaceStamps[leafFaces[f]] = Stamp;
+		}
+	}
+
+	// only index buffers whose visible faces changed are rebuilt and uploaded again
+	DrawnFaces = 0;
+	const core::array<quake3::SBSPFaceIndices>& faces = Mesh->getFaceIndices();
+	for (i=0; i<Buffers.size(); ++i)
+	{
+		SVisibleBuffer& vb = Buffers[i];
+		if (!vb.Buffer)
+			continue;
+
+		NewVisibleFaces.set_used(0);
+		for (u32 f=0; f<vb.Faces.size(); ++f)
+		{
+			if (FaceStamps[vb.Faces[f]] == Stamp)
+				NewVisibleFaces.push_back(vb.Faces[f]);
+		}
+
+		DrawnFaces += NewVisibleFaces.size();
+
+		if (NewVisibleFaces == vb.VisibleFaces)
+			continue;
+
+		vb.VisibleFaces.swap(NewVisibleFaces);
+
+		core::array<u16>& indices = vb.Buffer->Indices;
+		indices.set_used(0);
+		for (u32 f=0; f<vb.VisibleFaces.size(); ++f)
+		{
+			const quake3::SBSPFaceIndices& face = faces[vb.VisibleFaces[f]];
+			const u16* src = vb.Source->Indices.const_pointer() + face.FirstIndex;
+
+			const u32 start = indices.size();
+			indices.set_used(start + face.IndexCount);
+			memcpy(indices.pointer() + start, src, face.IndexCount * sizeof(u16));
+		}
+
+		vb.Buffer->setDirty(EBT_INDEX);
+	}
+}
+
+
+void CQ3LevelSceneNode::updateVisibleLeafs(s32 cluster)
+{
+	CameraCluster = cluster;
+	VisibleLeafsValid = true;
+	VisibleLeafs.set_used(0);
+
+	const core::array<quake3::SBSPLeaf>& leafs = Mesh->getLeafs();
+	if (leafs.empty())
+	{
+		ConsideredFaces = GeometryFaces;
+		return;
+	}
+
+	const core::array<u32>& leafFaces = Mesh->getLeafFaces();
+
+	nextStamp();
+	u32 i;
+
+	for (i=0; i<leafs.size(); ++i)
+	{
+		const quake3::SBSPLeaf& l = leafs[i];
+		if (0 == l.FaceCount)
+			continue;
+
+		// leafs without cluster are outside of the level
+		if (PVSCulling ? !Mesh->isClusterVisible(cluster, l.Cluster) : l.Cluster < 0)
+			continue;
+
+		VisibleLeafs.push_back(i);
+
+		const u32 end = l.FirstFace + l.FaceCount;
+		for (u32 f=l.FirstFace; f<end; ++f)
+			FaceStamps[leafFaces[f]] = Stamp;
+	}
+
+	// count each face once, even if it is in several leafs
+	ConsideredFaces = 0;
+	for (i=0; i<Buffers.size(); ++i)
+	{
+		const core::array<u32>& bufferFaces = Buffers[i].Faces;
+		for (u32 f=0; f<bufferFaces.size(); ++f)
+		{
+			if (FaceStamps[bufferFaces[f]] == Stamp)
+				++ConsideredFaces;
+		}
+	}
+}
+
+
+void CQ3LevelSceneNode::nextStamp()
+{
+	++Stamp;
+
+	// start again when the counter wraps around
+	if (0 == Stamp)
+	{
+		for (u32 i=0; i<FaceStamps.size(); ++i)
+			FaceStamps[i] = 0;
+		Stamp = 1;
+	}
+}
+
+
+void CQ3LevelSceneNode::setPVSCulling(bool enable)
+{
+	PVSCulling = enable;
+	VisibleLeafsValid = false;
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CQ3LevelSceneNode::getMaterial(u32 i)
+{
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! Writes attributes of the scene node.
+void CQ3LevelSceneNode::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
+{
+	IQ3LevelSceneNode::serializeAttributes(out, options);
+
+	out->addBool("PVSCulling", PVSCulling);
+	out->addBool("FrustumCulling", FrustumCulling);
+}
+
+
+//! Reads attributes of the scene node.
+void CQ3LevelSceneNode::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options)
+{
+	setPVSCulling(in->getAttributeAsBool("PVSCulling", PVSCulling));
+	FrustumCulling = in->getAttributeAsBool("FrustumCulling", FrustumCulling);
+
+	IQ3LevelSceneNode::deserializeAttributes(in, options);
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BSP_LOADER_
+
@@ -0,0 +1,138 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+#define __C_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+
+#include "IQ3LevelSceneNode.h"
+#include "IQ3LevelMesh.h"
+#include "SMeshBufferLightMap.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+	//! Draws the geometry of a Quake3 level using the potentially visible set of the camera cluster.
+	class CQ3LevelSceneNode : public IQ3LevelSceneNode
+	{
+	public:
+
+		//! constructor
+		CQ3LevelSceneNode(IQ3LevelMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id);
+
+		//! destructor
+		virtual ~CQ3LevelSceneNode();
+
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
+		//! renders the node.
+		virtual void render() _IRR_OVERRIDE_;
+
+		//! returns the axis aligned bounding box of this node
+		virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_ { return Box; }
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i) _IRR_OVERRIDE_;
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const _IRR_OVERRIDE_ { return Materials.size(); }
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_Q3_LEVEL; }
+
+		//! Writes attributes of the scene node.
+		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const _IRR_OVERRIDE_;
+
+		//! Reads attributes of the scene node.
+		virtual void deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options=0) _IRR_OVERRIDE_;
+
+		//! Returns the level which is drawn by this node.
+		virtual IQ3LevelMesh* getLevelMesh() const _IRR_OVERRIDE_ { return Mesh; }
+
+		//! Enables or disables culling with the potentially visible set.
+		virtual void setPVSCulling(bool enable) _IRR_OVERRIDE_;
+
+		//! Returns if culling with the potentially visible set is enabled.
+		virtual bool getPVSCulling() const _IRR_OVERRIDE_ { return PVSCulling; }
+
+		//! Enables or disables culling of bsp leafs against the view frustum.
+		virtual void setFrustumCulling(bool enable) _IRR_OVERRIDE_ { FrustumCulling = enable; }
+
+		//! Returns if culling of bsp leafs against the view frustum is enabled.
+		virtual bool getFrustumCulling() const _IRR_OVERRIDE_ { return FrustumCulling; }
+
+		//! Returns the visibility cluster the camera was in during the last frame.
+		virtual s32 getCameraCluster() const _IRR_OVERRIDE_ { return CameraCluster; }
+
+		//! Returns how many faces were potentially visible in the last frame.
+		virtual u32 getConsideredFaceCount() const _IRR_OVERRIDE_ { return ConsideredFaces; }
+
+		//! Returns how many faces were drawn in the last frame.
+		virtual u32 getDrawnFaceCount() const _IRR_OVERRIDE_ { return DrawnFaces; }
+
+	private:
+
+		//! finds the visible faces and updates the index buffers
+		void calculateVisibleFaces();
+
+		//! collects the leafs which are potentially visible from a cluster
+		void updateVisibleLeafs(s32 cluster);
+
+		//! starts a new round of marking faces
+		void nextStamp();
+
+		//! level geometry which shares the vertices of the level mesh,
+		//! the indices are only those of the visible faces
+		struct SVisibleBuffer
+		{
+			SVisibleBuffer() : Source(0), Buffer(0) {}
+
+			const SMeshBufferLightMap* Source;
+			SMeshBufferLightMap* Buffer;
+
+			//! faces of the source buffer, in the order of their indices
+			core::array<u32> Faces;
+
+			//! faces drawn in the last frame
+			core::array<u32> VisibleFaces;
+		};
+
+		IQ3LevelMesh* Mesh;
+
+		core::array<SVisibleBuffer> Buffers;
+		core::array<video::SMaterial> Materials;
+
+		//! leafs which are potentially visible from CameraCluster
+		core::array<u32> VisibleLeafs;
+
+		//! frame in which a face was last marked visible
+		core::array<u32> FaceStamps;
+		u32 Stamp;
+
+		core::array<u32> NewVisibleFaces;
+
+		core::aabbox3d<f32> Box;
+
+		s32 CameraCluster;
+		u32 ConsideredFaces;
+		u32 DrawnFaces;
+		u32 GeometryFaces;
+		u32 PassCount;
+
+		bool PVSCulling;
+		bool FrustumCulling;
+		bool VisibleLeafsValid;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BSP_LOADER_
+
+#endif
+
@@ -45,108 +45,20 @@ IAnimatedMesh* CSTLMeshFileLoader::createMesh(io::IReadFile* file)
 	mesh->addMeshBuffer(meshBuffer);
 	meshBuffer->drop();
 
-	core::vector3df vertex[3];
-	core::vector3df normal;
-
-	bool binary = false;
-	core::stringc token;
-	if (getNextToken(file, token) != "solid")
-		binary = true;
-	// read/skip header
-	u32 binFaceCount = 0;
-	if (binary)
+	// text files start with "solid", binary files with an 80 byte header
+	c8 header[80];
+	const size_t headerSize = file->read(header, core::min_((size_t)filesize, sizeof(header)));
+	const c8* const headerEnd = header+headerSize;
+	const bool binary = !core::equalsToken(core::skipWhitespace(header, headerEnd), headerEnd, "solid");
+	file->seek(0);
+
+	const bool success = binary ? readBinary(file, meshBuffer) : readText(file, meshBuffer);
+	if (!success)
 	{
-		file->seek(80);
-		file->read(&binFaceCount, 4);
-#ifdef __BIG_ENDIAN__
-		binFaceCount = os::Byteswap::byteswap(binFaceCount);
-#endif
+		mesh->drop();
+		return 0;
 	}
-	else
-		goNextLine(file);
-
-	u16 attrib=0;
-	token.reserve(32);
-
-	while (file->getPos() < filesize)
-	{
-		if (!binary)
-		{
-			if (getNextToken(file, token) != "facet")
-			{
-				if (token=="endsolid")
-					break;
-				mesh->drop();
-				return 0;
-			}
-			if (getNextToken(file, token) != "normal")
-			{
-				mesh->drop();
-				return 0;
-			}
-		}
-		getNextVector(file, normal, binary);
-		if (!binary)
-		{
-			if (getNextToken(file, token) != "outer")
-			{
-				mesh->drop();
-				return 0;
-			}
-			if (getNextToken(file, token) != "loop")
-			{
-				mesh->drop();
-				return 0;
-			}
-		}
-		for (u32 i=0; i<3; ++i)
-		{
-			if (!binary)
-			{
-				if (getNextToken(file, token) != "vertex")
-				{
-					mesh->drop();
-					return 0;
-				}
-			}
-			getNextVector(file, vertex[i], binary);
-		}
-		if (!binary)
-		{
-			if (getNextToken(file, token) != "endloop")
-			{
-				mesh->drop();
-				return 0;
-			}
-			if (getNextToken(file, token) != "endfacet")
-			{
-				mesh->drop();
-				return 0;
-			}
-		}
-		else
-		{
-			file->read(&attrib, 2);
-#ifdef __BIG_ENDIAN__
-			attrib = os::Byteswap::byteswap(attrib);
-#endif
-		}
-
-		SMeshBuffer* mb = reinterpret_cast<SMeshBuffer*>(mesh->getMeshBuffer(mesh->getMeshBufferCount()-1));
-		u32 vCount = mb->getVertexCount();
-		video::SColor color(0xffffffff);
-		if (attrib & 0x8000)
-			color = video::A1R5G5B5toA8R8G8B8(attrib);
-		if (normal==core::vector3df())
-			normal=core::plane3df(vertex[2],vertex[1],vertex[0]).Normal;
-		mb->Vertices.push_back(video::S3DVertex(vertex[2],normal,color, core::vector2df()));
-		mb->Vertices.push_back(video::S3DVertex(vertex[1],normal,color, core::vector2df()));
-		mb->Vertices.push_back(video::S3DVertex(vertex[0],normal,color, core::vector2df()));
-		mb->Indices.push_back(vCount);
-		mb->Indices.push_back(vCount+1);
-		mb->Indices.push_back(vCount+2);
-	}	// end while (file->getPos() < filesize)
-	mesh->getMeshBuffer(0)->recalculateBoundingBox();
+	meshBuffer->recalculateBoundingBox();
 
 	// Create the Animated mesh if there's anything in the mesh
 	SAnimatedMesh* pAM = 0;
@@ -165,83 +77,138 @@ IAnimatedMesh* CSTLMeshFileLoader::createMesh(io::IReadFile* file)
 }
 
 
-//! Read 3d vector of floats
-void CSTLMeshFileLoader::getNextVector(io::IReadFile* file, core::vector3df& vec, bool binary) const
+//! Read the triangles of a binary file
+bool CSTLMeshFileLoader::readBinary(io::IReadFile* file, SMeshBuffer* mb) const
 {
-	if (binary)
-	{
-		file->read(&vec.X, 4);
-		file->read(&vec.Y, 4);
-		file->read(&vec.Z, 4);
+	const long filesize = file->getSize();
+
+	// skip header
+	u32 binFaceCount = 0;
+	file->seek(80);
+	file->read(&binFaceCount, 4);
 #ifdef __BIG_ENDIAN__
-		vec.X = os::Byteswap::byteswap(vec.X);
-		vec.Y = os::Byteswap::byteswap(vec.Y);
-		vec.Z = os::Byteswap::byteswap(vec.Z);
+	binFaceCount = os::Byteswap::byteswap(binFaceCount);
 #endif
-	}
-	else
+
+	core::vector3df vertex[3];
+	core::vector3df normal;
+	u16 attrib=0;
+
+	while (file->getPos() < filesize)
 	{
-		goNextWord(file);
-		core::stringc tmp;
-
-		getNextToken(file, tmp);
-		core::fast_atof_move(tmp.c_str(), vec.X);
-		getNextToken(file, tmp);
-		core::fast_atof_move(tmp.c_str(), vec.Y);
-		getNextToken(file, tmp);
-		core::fast_atof_move(tmp.c_str(), vec.Z);
+		getNextVector(file, normal);
+		for (u32 i=0; i<3; ++i)
+			getNextVector(file, vertex[i]);
+		file->read(&attrib, 2);
+#ifdef __BIG_ENDIAN__
+		attrib = os::Byteswap::byteswap(attrib);
+#endif
+
+		video::SColor color(0xffffffff);
+		if (attrib & 0x8000)
+			color = video::A1R5G5B5toA8R8G8B8(attrib);
+		addTriangle(mb, vertex, normal, color);
 	}
-	vec.X=-vec.X;
+
+	return true;
 }
 
 
-//! Read next word
-const core::stringc& CSTLMeshFileLoader::getNextToken(io::IReadFile* file, core::stringc& token) const
+//! Read the triangles of a text file
+bool CSTLMeshFileLoader::readText(io::IReadFile* file, SMeshBuffer* mb) const
 {
-	goNextWord(file);
-	u8 c;
-	token = "";
-	while(file->getPos() != file->getSize())
+	// the whole file is parsed in place, 0-terminated for the number parser
+	const long filesize = file->getSize();
+	core::array<c8> buffer;
+	buffer.set_used(filesize+1);
+	if (file->read(buffer.pointer(), filesize) != (size_t)filesize)
+		return false;
+	buffer[filesize] = 0;
+
+	const c8* p = buffer.const_pointer();
+	const c8* const end = p + filesize;
+
+	// skip the line with the name
+	p = core::findLineEnd(p, end);
+
+	core::vector3df vertex[3];
+	core::vector3df normal;
+
+	while (true)
 	{
-		file->read(&c, 1);
-		// found it, so leave
-		if (core::isspace(c))
+		p = core::skipWhitespace(p, end);
+		if (p == end || core::equalsToken(p, end, "endsolid"))
 			break;
-		token.append(c);
+
+		if (!readToken(p, end, "facet") || !readToken(p, end, "normal"))
+			return false;
+		getNextVector(p, end, normal);
+		if (!readToken(p, end, "outer") || !readToken(p, end, "loop"))
+			return false;
+		for (u32 i=0; i<3; ++i)
+		{
+			if (!readToken(p, end, "vertex"))
+				return false;
+			getNextVector(p, end, vertex[i]);
+		}
+		if (!readToken(p, end, "endloop") || !readToken(p, end, "endfacet"))
+			return false;
+
+		addTriangle(mb, vertex, normal, video::SColor(0xffffffff));
 	}
-	return token;
+
+	return true;
 }
 
 
-//! skip to next word
-void CSTLMeshFileLoader::goNextWord(io::IReadFile* file) const
+//! Add a triangle with flipped winding
+void CSTLMeshFileLoader::addTriangle(SMeshBuffer* mb, const core::vector3df* vertex,
+	core::vector3df normal, video::SColor color) const
 {
-	u8 c;
-	while(file->getPos() != file->getSize())
-	{
-		file->read(&c, 1);
-		// found it, so leave
-		if (!core::isspace(c))
-		{
-			file->seek(-1, true);
-			break;
-		}
-	}
+	const u32 vCount = mb->getVertexCount();
+	if (normal==core::vector3df())
+		normal=core::plane3df(vertex[2],vertex[1],vertex[0]).Normal;
+	mb->Vertices.push_back(video::S3DVertex(vertex[2],normal,color, core::vector2df()));
+	mb->Vertices.push_back(video::S3DVertex(vertex[1],normal,color, core::vector2df()));
+	mb->Vertices.push_back(video::S3DVertex(vertex[0],normal,color, core::vector2df()));
+	mb->Indices.push_back(vCount);
+	mb->Indices.push_back(vCount+1);
+	mb->Indices.push_back(vCount+2);
 }
 
 
-//! Read until line break is reached and stop at the next non-space character
-void CSTLMeshFileLoader::goNextLine(io::IReadFile* file) const
+//! Read 3d vector of floats from a binary file
+void CSTLMeshFileLoader::getNextVector(io::IReadFile* file, core::vector3df& vec) const
 {
-	u8 c;
-	// look for newline characters
-	while(file->getPos() != file->getSize())
-	{
-		file->read(&c, 1);
-		// found it, so leave
-		if (c=='\n' || c=='\r')
-			break;
-	}
+	file->read(&vec.X, 4);
+	file->read(&vec.Y, 4);
+	file->read(&vec.Z, 4);
+#ifdef __BIG_ENDIAN__
+	vec.X = os::Byteswap::byteswap(vec.X);
+	vec.Y = os::Byteswap::byteswap(vec.Y);
+	vec.Z = os::Byteswap::byteswap(vec.Z);
+#endif
+	vec.X=-vec.X;
+}
+
+
+//! Read 3d vector of floats from text
+void CSTLMeshFileLoader::getNextVector(const c8*& p, const c8* const end, core::vector3df& vec) const
+{
+	p = core::fast_atof_token(p, end, vec.X);
+	p = core::fast_atof_token(p, end, vec.Y);
+	p = core::fast_atof_token(p, end, vec.Z);
+	vec.X=-vec.X;
+}
+
+
+//! Check that the next word is token and move behind it
+bool CSTLMeshFileLoader::readToken(const c8*& p, const c8* const end, const c8* token) const
+{
+	p = core::skipWhitespace(p, end);
+	const bool found = core::equalsToken(p, end, token);
+	p = core::skipToken(p, end);
+	return found;
 }
 
 
@@ -8,6 +8,7 @@
 #include "IMeshLoader.h"
 #include "irrString.h"
 #include "vector3d.h"
+#include "SMeshBuffer.h"
 
 namespace irr
 {
@@ -31,15 +32,20 @@ public:
 
 private:
 
-	// skips to the first non-space character available
-	void goNextWord(io::IReadFile* file) const;
-	// returns the next word
-	const core::stringc& getNextToken(io::IReadFile* file, core::stringc& token) const;
-	// skip to next printable character after the first line break
-	void goNextLine(io::IReadFile* file) const;
-
-	//! Read 3d vector of floats
-	void getNextVector(io::IReadFile* file, core::vector3df& vec, bool binary) const;
+	//! Read the triangles of a binary file
+	bool readBinary(io::IReadFile* file, SMeshBuffer* mb) const;
+	//! Read the triangles of a text file
+	bool readText(io::IReadFile* file, SMeshBuffer* mb) const;
+	//! Add a triangle with flipped winding, the normal is calculated if it is 0
+	void addTriangle(SMeshBuffer* mb, const core::vector3df* vertex,
+		core::vector3df normal, video::SColor color) const;
+
+	//! Read 3d vector of floats from a binary file
+	void getNextVector(io::IReadFile* file, core::vector3df& vec) const;
+	//! Read 3d vector of floats from text
+	void getNextVector(const c8*& p, const c8* const end, core::vector3df& vec) const;
+	//! Check that the next word is token and move behind it
+	bool readToken(const c8*& p, const c8* const end, const c8* token) const;
 };
 
 } // end namespace scene
@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CSceneCollisionManager.h"
+#include "CSceneNodeAnimatorCollisionResponse.h"
 #include "ISceneNode.h"
 #include "ICameraSceneNode.h"
 #include "ITriangleSelector.h"
@@ -10,6 +11,7 @@
 
 #include "os.h"
 #include "irrMath.h"
+#include "irrHashMap.h"
 
 namespace irr
 {
@@ -348,11 +350,13 @@ bool CSceneCollisionManager::getCollisionPoint(SCollisionHit& hitResult, const c
 	if ( totalcnt <= 0 )
 		return false;
 
+	core::array<core::triangle3df>& Triangles = Buffers.Triangles;
+	core::array<SCollisionTriangleRange>& TriangleInfo = Buffers.TriangleInfo;
 	Triangles.set_used(totalcnt);
 
 	s32 cnt = 0;
-	irr::core::array<SCollisionTriangleRange> outTriangleInfo;
-	selector->getTriangles(Triangles.pointer(), totalcnt, cnt, ray, 0, true, &outTriangleInfo);
+	TriangleInfo.set_used(0);
+	selector->getTriangles(Triangles.pointer(), totalcnt, cnt, ray, 0, true, &TriangleInfo);
 
 	const core::vector3df linevect = ray.getVector().normalize();
 	core::vector3df intersection;
@@ -402,14 +406,14 @@ bool CSceneCollisionManager::getCollisionPoint(SCollisionHit& hitResult, const c
 
 	if ( foundIndex >= 0 )
 	{
-		for ( irr::u32 t=0; t<outTriangleInfo.size(); ++t )
+		for ( irr::u32 t=0; t<TriangleInfo.size(); ++t )
 		{
-			if ( outTriangleInfo[t].isIndexInRange(foundIndex) )
+			if ( TriangleInfo[t].isIndexInRange(foundIndex) )
 			{
-				hitResult.Node = outTriangleInfo[t].SceneNode;
-				hitResult.MeshBuffer = outTriangleInfo[t].MeshBuffer;
-				hitResult.MaterialIndex = outTriangleInfo[t].MaterialIndex;
-				hitResult.TriangleSelector = outTriangleInfo[t].Selector;
+				hitResult.Node = TriangleInfo[t].SceneNode;
+				hitResult.MeshBuffer = TriangleInfo[t].MeshBuffer;
+				hitResult.MaterialIndex = TriangleInfo[t].MaterialIndex;
+				hitResult.TriangleSelector = TriangleInfo[t].Selector;
 
 				break;
 			}
@@ -434,11 +438,76 @@ core::vector3df CSceneCollisionManager::getCollisionResultPosition(
 		f32 slidingSpeed,
 		const core::vector3df& gravity)
 {
-	return collideEllipsoidWithWorld(selector, position,
+	return collideEllipsoidWithWorld(Buffers, selector, position,
 		radius, direction, slidingSpeed, gravity, triout, hitPosition, outFalling, outNode);
 }
 
 
+//! Like getCollisionResultPosition, but uses the given buffers.
+core::vector3df CSceneCollisionManager::getCollisionResultPosition(
+		SCollisionBuffers& buffers,
+		ITriangleSelector* selector,
+		const core::vector3df &position, const core::vector3df& radius,
+		const core::vector3df& direction,
+		core::triangle3df& triout,
+		core::vector3df& hitPosition,
+		bool& outFalling,
+		ISceneNode*& outNode,
+		f32 slidingSpeed,
+		const core::vector3df& gravity)
+{
+	return collideEllipsoidWithWorld(buffers, selector, position,
+		radius, direction, slidingSpeed, gravity, triout, hitPosition, outFalling, outNode);
+}
+
+
+//! Moves the nodes of many collision response animators at once.
+void CSceneCollisionManager::animateCollisionResponses(
+		const core::array<ISceneNodeAnimatorCollisionResponse*>& animators,
+		u32 timeMs, bool parallel)
+{
+	core::array<CSceneNodeAnimatorCollisionResponse*> active(animators.size());
+	core::hash_set<ITriangleSelector*> worlds;
+
+	for (u32 i=0; i<animators.size(); ++i)
+	{
+		// only animators created by the scene manager
+		CSceneNodeAnimatorCollisionResponse* animator = static_cast<CSceneNodeAnimatorCollisionResponse*>(animators[i]);
+		if (!animator || !animator->beginStep(timeMs, true))
+			continue;
+
+		active.push_back(animator);
+
+		// bring animated selectors and the boxes of meta selectors up to date,
+		// after that the collision tests only read from the worlds
+		ITriangleSelector* world = animator->getWorld();
+		if (worlds.insert(world))
+		{
+			core::aabbox3df box;
+			world->getBoundingBox(box);
+		}
+	}
+
+	const s32 count = (s32)active.size();
+#ifdef _OPENMP
+	#pragma omp parallel if (parallel && count >= 8)
+#endif
+	{
+		SCollisionBuffers buffers;
+
+#ifdef _OPENMP
+		#pragma omp for schedule(dynamic)
+#endif
+		for (s32 i=0; i<count; ++i)
+			active[i]->collide(this, buffers);
+	}
+
+	// callbacks and moving the nodes are done in order
+	for (s32 i=0; i<count; ++i)
+		active[i]->endStep();
+}
+
+
 bool CSceneCollisionManager::testTriangleIntersection(SCollisionData* colData,
 			const core::triangle3df& triangle)
 {
@@ -692,6 +761,7 @@ bool CSceneCollisionManager::testTriangleIntersection(SCollisionData* colData,
 //! Collides a moving ellipsoid with a 3d world with gravity and returns
 //! the resulting new position of the ellipsoid.
 core::vector3df CSceneCollisionManager::collideEllipsoidWithWorld(
+		SCollisionBuffers& buffers,
 		ITriangleSelector* selector, const core::vector3df &position,
 		const core::vector3df& radius,  const core::vector3df& velocity,
 		f32 slidingSpeed,
@@ -716,6 +786,8 @@ core::vector3df CSceneCollisionManager::collideEllipsoidWithWorld(
 	colData.slidingSpeed = slidingSpeed;
 	colData.triangleHits = 0;
 	colData.node = 0;
+	colData.buffers = &buffers;
+	colData.triangleCount = 0;
 
 	core::vector3df eSpacePosition = colData.R3Position / colData.eRadius;
 	core::vector3df eSpaceVelocity = colData.R3Velocity / colData.eRadius;
@@ -775,41 +847,49 @@ core::vector3df CSceneCollisionManager::collideWithWorld(s32 recursionDepth,
 
 	//------------------ collide with world
 
-	// get all triangles with which we might collide
-	core::aabbox3d<f32> box(colData.R3Position);
-	box.addInternalPoint(colData.R3Position + colData.R3Velocity);
-	box.MinEdge -= colData.eRadius;
-	box.MaxEdge += colData.eRadius;
+	core::array<core::triangle3df>& triangles = colData.buffers->Triangles;
+	core::array<SCollisionTriangleRange>& triangleInfo = colData.buffers->TriangleInfo;
 
-	s32 totalTriangleCnt = colData.selector->getTriangleCount();
-	Triangles.set_used(totalTriangleCnt);
-
-	core::matrix4 scaleMatrix;
-	scaleMatrix.setScale(
-			core::vector3df(1.0f / colData.eRadius.X,
-					1.0f / colData.eRadius.Y,
-					1.0f / colData.eRadius.Z));
-
-	irr::core::array<SCollisionTriangleRange> outTriangleInfo;
-	s32 triangleCnt = 0;
-	colData.selector->getTriangles(Triangles.pointer(), totalTriangleCnt, triangleCnt, box, &scaleMatrix, true, &outTriangleInfo);
+	// The box only depends on the movement before any sliding, so the
+	// triangles of the first step are kept for the following ones.
+	if (recursionDepth == 0)
+	{
+		// get all triangles with which we might collide
+		core::aabbox3d<f32> box(colData.R3Position);
+		box.addInternalPoint(colData.R3Position + colData.R3Velocity);
+		box.MinEdge -= colData.eRadius;
+		box.MaxEdge += colData.eRadius;
+
+		s32 totalTriangleCnt = colData.selector->getTriangleCount();
+		triangles.set_used(totalTriangleCnt);
+
+		core::matrix4 scaleMatrix;
+		scaleMatrix.setScale(
+				core::vector3df(1.0f / colData.eRadius.X,
+						1.0f / colData.eRadius.Y,
+						1.0f / colData.eRadius.Z));
+
+		triangleInfo.set_used(0);
+		colData.triangleCount = 0;
+		colData.selector->getTriangles(triangles.pointer(), totalTriangleCnt, colData.triangleCount, box, &scaleMatrix, true, &triangleInfo);
+	}
 
 	// Find closest intersection
 	irr::s32 nearestTriangleIndex = -1;
-	for (s32 i=0; i<triangleCnt; ++i)
+	for (s32 i=0; i<colData.triangleCount; ++i)
 	{
-		if(testTriangleIntersection(&colData, Triangles[i]))
+		if(testTriangleIntersection(&colData, triangles[i]))
 		{
 			nearestTriangleIndex = i;
 		}
 	}
 	if ( nearestTriangleIndex >= 0 )
 	{
-		for ( irr::u32 t=0; t<outTriangleInfo.size(); ++t )
+		for ( irr::u32 t=0; t<triangleInfo.size(); ++t )
 		{
-			if ( outTriangleInfo[t].isIndexInRange(nearestTriangleIndex) )
+			if ( triangleInfo[t].isIndexInRange(nearestTriangleIndex) )
 			{
-				colData.node = outTriangleInfo[t].SceneNode;
+				colData.node = triangleInfo[t].SceneNode;
 				break;
 			}
 		}
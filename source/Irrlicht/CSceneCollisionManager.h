@@ -19,6 +19,14 @@ namespace scene
 	{
 	public:
 
+		//! Triangles found by a collision query
+		/** Each thread testing collisions needs its own buffers. */
+		struct SCollisionBuffers
+		{
+			core::array<core::triangle3df> Triangles;
+			core::array<SCollisionTriangleRange> TriangleInfo;
+		};
+
 		//! constructor
 		CSceneCollisionManager(ISceneManager* smanager, video::IVideoDriver* driver);
 
@@ -59,6 +67,27 @@ namespace scene
 			f32 slidingSpeed,
 			const core::vector3df& gravityDirectionAndSpeed) _IRR_OVERRIDE_;
 
+		//! Like getCollisionResultPosition, but uses the given buffers.
+		/** Only reads the selector, so several threads can call it
+		with their own buffers once the selector is up to date. */
+		core::vector3df getCollisionResultPosition(
+			SCollisionBuffers& buffers,
+			ITriangleSelector* selector,
+			const core::vector3df &ellipsoidPosition,
+			const core::vector3df& ellipsoidRadius,
+			const core::vector3df& ellipsoidDirectionAndSpeed,
+			core::triangle3df& triout,
+			core::vector3df& hitPosition,
+			bool& outFalling,
+			ISceneNode*& outNode,
+			f32 slidingSpeed,
+			const core::vector3df& gravityDirectionAndSpeed);
+
+		//! Moves the nodes of many collision response animators at once.
+		virtual void animateCollisionResponses(
+			const core::array<ISceneNodeAnimatorCollisionResponse*>& animators,
+			u32 timeMs, bool parallel=true) _IRR_OVERRIDE_;
+
 		//! Returns a 3d ray which would go through the 2d screen coordinates.
 		virtual core::line3d<f32> getRayFromScreenCoordinates(
 			const core::position2d<s32> & pos, const ICameraSceneNode* camera = 0) _IRR_OVERRIDE_;
@@ -115,6 +144,10 @@ namespace scene
 			f32 slidingSpeed;
 
 			ITriangleSelector* selector;
+
+			//! triangles found for the first step, also used for the slides
+			SCollisionBuffers* buffers;
+			s32 triangleCount;
 		};
 
 		//! Tests the current collision data against an individual triangle.
@@ -126,7 +159,8 @@ namespace scene
 			const core::triangle3df& triangle);
 
 		//! recursive method for doing collision response
-		core::vector3df collideEllipsoidWithWorld(ITriangleSelector* selector,
+		core::vector3df collideEllipsoidWithWorld(SCollisionBuffers& buffers,
+			ITriangleSelector* selector,
 			const core::vector3df &position,
 			const core::vector3df& radius,  const core::vector3df& velocity,
 			f32 slidingSpeed,
@@ -142,7 +176,7 @@ namespace scene
 
 		ISceneManager* SceneManager;
 		video::IVideoDriver* Driver;
-		core::array<core::triangle3df> Triangles; // triangle buffer
+		SCollisionBuffers Buffers; // triangle buffers for calls from the main thread
 	};
 
 
@@ -0,0 +1,245 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_SCENE_LOADER_
+
+#include "CSceneLoaderIrrBinary.h"
+#include "SIrrBinarySceneStructs.h"
+#include "ISceneNodeAnimatorFactory.h"
+#include "ISceneUserDataSerializer.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "IFileSystem.h"
+#include "IMemoryReadFile.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	inline u32 toHostEndian(u32 value)
+	{
+#ifdef __BIG_ENDIAN__
+		return os::Byteswap::byteswap(value);
+#else
+		return value;
+#endif
+	}
+}
+
+//! Constructor
+CSceneLoaderIrrBinary::CSceneLoaderIrrBinary(ISceneManager *smgr, io::IFileSystem* fs)
+ : SceneManager(smgr), FileSystem(fs), Attributes(0)
+{
+}
+
+
+//! Returns true if the class might be able to load this file.
+bool CSceneLoaderIrrBinary::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension(filename, "irrb");
+}
+
+
+//! Returns true if the class might be able to load this file.
+bool CSceneLoaderIrrBinary::isALoadableFileFormat(io::IReadFile *file) const
+{
+	if (!file)
+		return false;
+
+	const long pos = file->getPos();
+	u32 magic = 0;
+	const bool ok = file->read(&magic, sizeof(u32)) == sizeof(u32);
+	file->seek(pos);
+
+	return ok && toHostEndian(magic) == IRRB_SCENE_MAGIC;
+}
+
+
+//! Loads the scene into the scene manager.
+bool CSceneLoaderIrrBinary::loadScene(io::IReadFile* file, ISceneUserDataSerializer* userDataSerializer,
+	ISceneNode* rootNode)
+{
+	if (!file)
+	{
+		os::Printer::log("Unable to open scene file", ELL_ERROR);
+		return false;
+	}
+
+	const long fileSize = file->getSize() - file->getPos();
+	if (fileSize < (long)sizeof(SIrrBinarySceneHeader))
+	{
+		os::Printer::log("Binary scene file is too small", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	// memory files are used in place, all others are read with a single call
+	const u32* fileData = 0;
+	if (file->getType() == io::ERFT_MEMORY_READ_FILE && file->getPos() == 0)
+	{
+		const void* buffer = static_cast<io::IMemoryReadFile*>(file)->getBuffer();
+		if (((size_t)buffer & 3) == 0)
+			fileData = static_cast<const u32*>(buffer);
+	}
+	if (!fileData)
+	{
+		FileBuffer.set_used((u32)(fileSize+3)/4);
+		if (file->read(FileBuffer.pointer(), (size_t)fileSize) != (size_t)fileSize)
+		{
+			os::Printer::log("Could not read binary scene file", file->getFileName(), ELL_ERROR);
+			FileBuffer.clear();
+			return false;
+		}
+		fileData = FileBuffer.const_pointer();
+	}
+
+	SIrrBinarySceneHeader header;
+	u32* headerWords = reinterpret_cast<u32*>(&header);
+	for (u32 i=0; i<sizeof(header)/sizeof(u32); ++i)
+		headerWords[i] = toHostEndian(fileData[i]);
+
+	const u32 size = (u32)fileSize;
+	if (header.Magic != IRRB_SCENE_MAGIC || header.Version != IRRB_SCENE_VERSION ||
+		(header.StringTableOffset & 3) || (header.NodeDataOffset & 3) ||
+		header.StringTableOffset > size ||
+		header.StringCount > (size - header.StringTableOffset) / sizeof(u32) ||
+		header.StringDataSize > size - header.StringTableOffset - header.StringCount*sizeof(u32) ||
+		header.NodeDataOffset > size ||
+		header.NodeDataSize > (size - header.NodeDataOffset) / sizeof(u32))
+	{
+		os::Printer::log("Binary scene file has an invalid or unsupported header", file->getFileName(), ELL_ERROR);
+		FileBuffer.clear();
+		return false;
+	}
+
+	const u32* stringOffsets = fileData + header.StringTableOffset/sizeof(u32);
+	Reader.setData(stringOffsets, header.StringCount,
+		reinterpret_cast<const c8*>(stringOffsets + header.StringCount), header.StringDataSize,
+		fileData + header.NodeDataOffset/sizeof(u32), header.NodeDataSize);
+
+	Attributes = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
+
+	// TODO: COLLADA_CREATE_SCENE_INSTANCES can be removed when the COLLADA loader is a scene loader
+	bool oldColladaSingleMesh = SceneManager->getParameters()->getAttributeAsBool(COLLADA_CREATE_SCENE_INSTANCES);
+	SceneManager->getParameters()->setAttribute(COLLADA_CREATE_SCENE_INSTANCES, false);
+
+	const bool success = readSceneNode(rootNode, userDataSerializer);
+
+	// restore old collada parameters
+	SceneManager->getParameters()->setAttribute(COLLADA_CREATE_SCENE_INSTANCES, oldColladaSingleMesh);
+
+	if (!success)
+		os::Printer::log("Binary scene file is corrupt", file->getFileName(), ELL_ERROR);
+
+	// clean up
+	Attributes->drop();
+	Attributes = 0;
+	Reader.setData(0, 0, 0, 0, 0, 0);
+	FileBuffer.clear();
+
+	return success;
+}
+
+
+//! Reads a node record and all its children
+bool CSceneLoaderIrrBinary::readSceneNode(ISceneNode* parent, ISceneUserDataSerializer* userDataSerializer)
+{
+	scene::ISceneNode* node = 0;
+
+	const u32 typeIndex = Reader.readWord();
+	if (typeIndex == io::IRR_BINARY_NO_STRING)
+	{
+		// the scene root, or the node we load into
+		node = parent ? parent : SceneManager->getRootSceneNode();
+	}
+	else
+	{
+		const c8* typeName = Reader.getString(typeIndex);
+		if (!typeName)
+			return false;
+
+		// children of nodes which couldn't be created are skipped, like in .irr files
+		if (parent)
+		{
+			node = SceneManager->addSceneNode(typeName, parent);
+			if (!node)
+				os::Printer::log("Could not create scene node of unknown type", typeName);
+		}
+	}
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	// properties
+	if (!Reader.readAttributes(Attributes))
+		return false;
+	if (node)
+		node->deserializeAttributes(Attributes);
+
+	// materials
+	const u32 materialCount = Reader.readWord();
+	for (u32 i=0; i<materialCount && !Reader.failed(); ++i)
+	{
+		if (!Reader.readAttributes(Attributes))
+			return false;
+		if (node && driver && node->getMaterialCount() > i)
+			driver->fillMaterialStructureFromAttributes(node->getMaterial(i), Attributes);
+	}
+
+	// animators
+	const u32 animatorCount = Reader.readWord();
+	for (u32 i=0; i<animatorCount && !Reader.failed(); ++i)
+	{
+		if (!Reader.readAttributes(Attributes))
+			return false;
+		if (node)
+		{
+			const core::stringc typeName = Attributes->getAttributeAsString("Type");
+			ISceneNodeAnimator* anim = SceneManager->createSceneNodeAnimator(typeName.c_str(), node);
+			if (anim)
+			{
+				anim->deserializeAttributes(Attributes);
+				anim->drop();
+			}
+		}
+	}
+
+	// user data, gets own attributes as the serializer might keep them
+	if (Reader.readWord())
+	{
+		io::IAttributes* userData = FileSystem->createEmptyAttributes(driver);
+		const bool ok = Reader.readAttributes(userData);
+		if (ok && node && userDataSerializer)
+			userDataSerializer->OnReadUserData(node, userData);
+		userData->drop();
+		if (!ok)
+			return false;
+	}
+
+	// children
+	const u32 childCount = Reader.readWord();
+	for (u32 i=0; i<childCount && !Reader.failed(); ++i)
+	{
+		if (!readSceneNode(node, userDataSerializer))
+			return false;
+	}
+
+	if (Reader.failed())
+		return false;
+
+	if (node && userDataSerializer)
+		userDataSerializer->OnCreateNode(node);
+
+	return true;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_IRR_BINARY_SCENE_LOADER_
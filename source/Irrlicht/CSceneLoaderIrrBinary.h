@@ -0,0 +1,67 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_LOADER_IRR_BINARY_H_INCLUDED__
+#define __C_SCENE_LOADER_IRR_BINARY_H_INCLUDED__
+
+#include "ISceneLoader.h"
+#include "CIrrBinaryAttributes.h"
+
+namespace irr
+{
+
+namespace io
+{
+	class IFileSystem;
+}
+
+namespace scene
+{
+
+class ISceneManager;
+
+//! Class which can load binary .irrb scenes written by CSceneWriterIrrBinary.
+/** The file is read with a single read call and attributes are created
+directly from their binary values without any text parsing. */
+class CSceneLoaderIrrBinary : public virtual ISceneLoader
+{
+public:
+
+	//! Constructor
+	CSceneLoaderIrrBinary(ISceneManager *smgr, io::IFileSystem* fs);
+
+	//! Returns true if the class might be able to load this file.
+	virtual bool isALoadableFileExtension(const io::path& filename) const _IRR_OVERRIDE_;
+
+	//! Returns true if the class might be able to load this file.
+	virtual bool isALoadableFileFormat(io::IReadFile *file) const _IRR_OVERRIDE_;
+
+	//! Loads the scene into the scene manager.
+	virtual bool loadScene(io::IReadFile* file,
+		ISceneUserDataSerializer* userDataSerializer=0,
+		ISceneNode* rootNode=0) _IRR_OVERRIDE_;
+
+private:
+
+	//! Reads a node record and all its children
+	bool readSceneNode(ISceneNode* parent, ISceneUserDataSerializer* userDataSerializer);
+
+	ISceneManager* SceneManager;
+	io::IFileSystem* FileSystem;
+
+	io::CIrrBinaryReader Reader;
+
+	//! used when the file is not in memory already
+	core::array<u32> FileBuffer;
+
+	//! reused for nodes, materials and animators
+	io::IAttributes* Attributes;
+};
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
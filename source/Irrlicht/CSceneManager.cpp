@@ -30,6 +30,10 @@
 #include "CIrrMeshFileLoader.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#include "CIrrBinaryMeshFileLoader.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_BSP_LOADER_
 #include "CBSPMeshFileLoader.h"
 #endif
@@ -117,6 +121,8 @@
 
 #ifdef _IRR_COMPILE_WITH_IRR_SCENE_LOADER_
 #include "CSceneLoaderIrr.h"
+#include "CSceneLoaderIrrBinary.h"
+#include "CSceneWriterIrrBinary.h"
 #endif
 
 #ifdef _IRR_COMPILE_WITH_COLLADA_WRITER_
@@ -127,6 +133,10 @@
 #include "CIrrMeshWriter.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+#include "CIrrBinaryMeshWriter.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_STL_WRITER_
 #include "CSTLMeshWriter.h"
 #endif
@@ -182,15 +192,20 @@
 #endif // _IRR_COMPILE_WITH_WATER_SURFACE_SCENENODE_
 #ifdef _IRR_COMPILE_WITH_TERRAIN_SCENENODE_
 #include "CTerrainSceneNode.h"
+#include "CTiledTerrainSceneNode.h"
 #endif // _IRR_COMPILE_WITH_TERRAIN_SCENENODE_
 #include "CEmptySceneNode.h"
+#include "CStaticBatchSceneNode.h"
+#include "CTransformHierarchy.h"
 #include "CTextSceneNode.h"
 #include "CQuake3ShaderSceneNode.h"
+#include "CQ3LevelSceneNode.h"
 #include "CVolumeLightSceneNode.h"
 
 #include "CDefaultSceneNodeFactory.h"
 
 #include "CSceneCollisionManager.h"
+#include "COcclusionCuller.h"
 #include "CTriangleSelector.h"
 #include "COctreeTriangleSelector.h"
 #include "CTriangleBBSelector.h"
@@ -224,10 +239,11 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 		gui::ICursorControl* cursorControl, IMeshCache* cache,
 		gui::IGUIEnvironment* gui)
 : ISceneNode(0, 0), Driver(driver), FileSystem(fs), GUIEnvironment(gui),
-	CursorControl(cursorControl), CollisionManager(0),
+	CursorControl(cursorControl), CollisionManager(0), OcclusionCuller(0),
 	ActiveCamera(0), ShadowColor(150,0,0,0), AmbientLight(0,0,0,0), Parameters(0),
 	MeshCache(cache), CurrentRenderPass(ESNRP_NONE), LightManager(0),
-	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type")
+	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type"),
+	SpatialIndexFrame(0), SpatialIndexCulling(false)
 {
 	#ifdef _DEBUG
 	ISceneManager::setDebugName("CSceneManager ISceneManager");
@@ -259,10 +275,14 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	Parameters = new io::CAttributes();
 	Parameters->setAttribute(DEBUG_NORMAL_LENGTH, 1.f);
 	Parameters->setAttribute(DEBUG_NORMAL_COLOR, video::SColor(255, 34, 221, 221));
+	AllowZWriteOnTransparentHandle = Parameters->getAttributeHandle(ALLOW_ZWRITE_ON_TRANSPARENT);
 
 	// create collision manager
 	CollisionManager = new CSceneCollisionManager(this, Driver);
 
+	// create occlusion culler
+	OcclusionCuller = new COcclusionCuller();
+
 	// create geometry creator
 	GeometryCreator = new CGeometryCreator();
 
@@ -314,6 +334,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	#ifdef _IRR_COMPILE_WITH_IRR_MESH_LOADER_
 	MeshLoaderList.push_back(new CIrrMeshFileLoader(this, FileSystem));
 	#endif
+	#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+	MeshLoaderList.push_back(new CIrrBinaryMeshFileLoader(this));
+	#endif
 	#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
 	MeshLoaderList.push_back(new CBSPMeshFileLoader(this, FileSystem));
 	#endif
@@ -345,6 +368,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	#ifdef _IRR_COMPILE_WITH_IRR_SCENE_LOADER_
 	SceneLoaderList.push_back(new CSceneLoaderIrr(this, FileSystem));
 	#endif
+	#ifdef _IRR_COMPILE_WITH_IRR_BINARY_SCENE_LOADER_
+	SceneLoaderList.push_back(new CSceneLoaderIrrBinary(this, FileSystem));
+	#endif
 
 	// factories
 	ISceneNodeFactory* factory = new CDefaultSceneNodeFactory(this);
@@ -370,6 +396,7 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 			getProfiler().add(EPID_SM_RENDER_TRANSPARENT, L"transp.nodes", L"Irrlicht scene");
 			getProfiler().add(EPID_SM_RENDER_EFFECT, L"effectnodes", L"Irrlicht scene");
 			getProfiler().add(EPID_SM_REGISTER, L"reg.render.node", L"Irrlicht scene");
+			getProfiler().add(EPID_SM_SPATIAL_INDEX, L"spatial index", L"Irrlicht scene");
 		}
  	)
 }
@@ -395,6 +422,10 @@ CSceneManager::~CSceneManager()
 	if (CollisionManager)
 		CollisionManager->drop();
 
+	if (OcclusionCuller)
+		OcclusionCuller->drop();
+	OcclusionCuller = 0;
+
 	if (GeometryCreator)
 		GeometryCreator->drop();
 
@@ -482,6 +513,25 @@ IAnimatedMesh* CSceneManager::getUncachedMesh(io::IReadFile* file, const io::pat
 {
 	IAnimatedMesh* msh = 0;
 
+#if defined(_IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_) && defined(_IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_)
+	// try the binary mesh cache first
+	const io::path binaryCacheName = getBinaryMeshCacheName(filename);
+	const u32 sourceSize = (u32)file->getSize();
+	u32 sourceHash = 0;
+	if (!binaryCacheName.empty())
+	{
+		sourceHash = getBinaryMeshCacheSourceHash(file);
+		msh = loadBinaryMeshCache(binaryCacheName, sourceSize, sourceHash);
+		if (msh)
+		{
+			MeshCache->addMesh(cachename, msh);
+			msh->drop();
+			os::Printer::log("Loaded mesh from binary cache", binaryCacheName, ELL_DEBUG);
+			return msh;
+		}
+	}
+#endif
+
 	// iterate the list in reverse order so user-added loaders can override the built-in ones
 	s32 count = MeshLoaderList.size();
 	for (s32 i=count-1; i>=0; --i)
@@ -505,7 +555,111 @@ IAnimatedMesh* CSceneManager::getUncachedMesh(io::IReadFile* file, const io::pat
 	else
 		os::Printer::log("Loaded mesh", filename, ELL_DEBUG);
 
+#if defined(_IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_) && defined(_IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_)
+	if (msh && !binaryCacheName.empty())
+		writeBinaryMeshCache(binaryCacheName, msh, sourceSize, sourceHash);
+#endif
+
+	return msh;
+}
+
+
+//! returns name of the binary cache file for a mesh file or an empty path when there is none
+io::path CSceneManager::getBinaryMeshCacheName(const io::path& filename) const
+{
+	const io::path cachePath = Parameters->getAttributeAsString(MESH_BINARY_CACHE_PATH);
+	if (cachePath.empty() || core::hasFileExtension(filename, "irrbin"))
+		return io::path();
+
+	// meshes with equal names in different directories must not share a cache file
+	const io::path absolute = FileSystem->getAbsolutePath(filename);
+	u32 hash = 2166136261u;
+	for (u32 i=0; i<absolute.size(); ++i)
+		hash = (hash ^ (u32)absolute[i]) * 16777619u;
+
+	io::path name(cachePath);
+	if (name.lastChar() != '/' && name.lastChar() != '\\')
+		name.append('/');
+	name += FileSystem->getFileBasename(filename);
+	name += "_";
+	name += core::stringc(hash);
+	name += ".irrbin";
+	return name;
+}
+
+
+//! returns the FNV-1a hash of the content of a mesh file, so edited files don't match an old cache of the same size
+u32 CSceneManager::getBinaryMeshCacheSourceHash(io::IReadFile* file) const
+{
+	u32 hash = 2166136261u;
+	u8 buffer[4096];
+
+	file->seek(0);
+	size_t read;
+	while ((read = file->read(buffer, sizeof(buffer))) > 0)
+	{
+		for (size_t i=0; i<read; ++i)
+			hash = (hash ^ buffer[i]) * 16777619u;
+	}
+	file->seek(0);
+
+	return hash;
+}
+
+
+//! loads a mesh from the binary cache, returns 0 when there is no matching cache file
+IAnimatedMesh* CSceneManager::loadBinaryMeshCache(const io::path& cacheName, u32 sourceSize, u32 sourceHash)
+{
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+	if (!FileSystem->existFile(cacheName))
+		return 0;
+
+	io::IReadFile* file = FileSystem->createAndOpenFile(cacheName);
+	if (!file)
+		return 0;
+
+	IAnimatedMesh* msh = 0;
+	u32 cachedSourceSize = 0;
+	u32 cachedSourceHash = 0;
+	if (CIrrBinaryMeshFileLoader::readSource(file, cachedSourceSize, cachedSourceHash) &&
+		cachedSourceSize == sourceSize && cachedSourceHash == sourceHash)
+	{
+		file->seek(0);
+		CIrrBinaryMeshFileLoader loader(this);
+		msh = loader.createMesh(file);
+	}
+	else
+		os::Printer::log("Binary mesh cache is outdated", cacheName, ELL_DEBUG);
+
+	file->drop();
 	return msh;
+#else
+	return 0;
+#endif
+}
+
+
+//! writes a loaded mesh to the binary cache
+void CSceneManager::writeBinaryMeshCache(const io::path& cacheName, IAnimatedMesh* mesh, u32 sourceSize, u32 sourceHash)
+{
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+	// only frame based animations can't be stored, and scene instances from collada files would get lost
+	if ((mesh->getMeshType() != EAMT_SKINNED && mesh->getFrameCount() > 1) ||
+		Parameters->getAttributeAsBool(COLLADA_CREATE_SCENE_INSTANCES))
+		return;
+
+	io::IWriteFile* file = FileSystem->createAndWriteFile(cacheName);
+	if (!file)
+	{
+		os::Printer::log("Could not write binary mesh cache", cacheName, ELL_WARNING);
+		return;
+	}
+
+	CIrrBinaryMeshWriter writer(Driver);
+	writer.setSource(sourceSize, sourceHash);
+	writer.writeMesh(file, mesh, Parameters->getAttributeAsBool(MESH_BINARY_CACHE_COMPRESSED) ? EMWF_WRITE_COMPRESSED : EMWF_NONE);
+	file->drop();
+#endif
 }
 
 //! returns the video driver
@@ -598,6 +752,27 @@ IMeshSceneNode* CSceneManager::addQuake3SceneNode(const IMeshBuffer* meshBuffer,
 }
 
 
+//! Adds a scene node which draws a quake3 level using its potentially visible set
+IQ3LevelSceneNode* CSceneManager::addQ3LevelSceneNode(IQ3LevelMesh* mesh,
+					ISceneNode* parent, s32 id)
+{
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+	if (!mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	CQ3LevelSceneNode* node = new CQ3LevelSceneNode(mesh, parent, this, id);
+	node->drop();
+
+	return node;
+#else
+	return 0;
+#endif
+}
+
+
 //! adds Volume Lighting Scene Node.
 //! the returned pointer must not be dropped.
 IVolumeLightSceneNode* CSceneManager::addVolumeLightSceneNode(
@@ -757,6 +932,28 @@ IOctreeSceneNode* CSceneManager::addOctreeSceneNode(IMesh* mesh, ISceneNode* par
 }
 
 
+//! Merges the meshes of static scene nodes with equal materials.
+IStaticBatchSceneNode* CSceneManager::createStaticBatch(ISceneNode* root, f32 cellSize, s32 id)
+{
+	if (!root)
+		root = this;
+
+	CStaticBatchSceneNode* node = new CStaticBatchSceneNode(this, this, id, cellSize);
+	node->addSourceNodes(root);
+	node->rebuild();
+	node->drop();
+
+	return node;
+}
+
+
+//! Creates flat storage for the transformations of a scene node tree.
+ITransformHierarchy* CSceneManager::createTransformHierarchy(ISceneNode* root)
+{
+	return new CTransformHierarchy(root ? root : this);
+}
+
+
 //! Adds a camera scene node to the tree and sets it as active camera.
 //! \param position: Position of the space relative to its parent where the camera will be placed.
 //! \param lookat: Position where the camera will look at. Also known as target.
@@ -998,6 +1195,29 @@ ITerrainSceneNode* CSceneManager::addTerrainSceneNode(
 }
 
 
+//! Adds a terrain scene node which loads heightmap tiles around the camera.
+ITiledTerrainSceneNode* CSceneManager::addTiledTerrainSceneNode(
+	const io::path& heightmapPattern, const io::path& texturePattern,
+	u32 tileCountX, u32 tileCountZ, s32 tileSize,
+	ISceneNode* parent, s32 id,
+	const core::vector3df& position,
+	const core::vector3df& scale,
+	s32 maxLOD, E_TERRAIN_PATCH_SIZE patchSize)
+{
+#ifdef _IRR_COMPILE_WITH_TERRAIN_SCENENODE_
+	if (!parent)
+		parent = this;
+
+	CTiledTerrainSceneNode* node = new CTiledTerrainSceneNode(heightmapPattern, texturePattern,
+		tileCountX, tileCountZ, tileSize, parent, this, id, position, scale, maxLOD, patchSize);
+	node->drop();
+	return node;
+#else
+	return 0;
+#endif // _IRR_COMPILE_WITH_TERRAIN_SCENENODE_
+}
+
+
 //! Adds an empty scene node.
 ISceneNode* CSceneManager::addEmptySceneNode(ISceneNode* parent, s32 id)
 {
@@ -1252,12 +1472,6 @@ bool CSceneManager::isCulled(const ISceneNode* node) const
 	}
 	bool result = false;
 
-	// has occlusion query information
-	if (node->getAutomaticCulling() & scene::EAC_OCC_QUERY)
-	{
-		result = (Driver->getOcclusionQueryResult(const_cast<ISceneNode*>(node))==0);
-	}
-
 	// can be seen by a bounding box ?
 	if (!result && (node->getAutomaticCulling() & scene::EAC_BOX))
 	{
@@ -1285,15 +1499,13 @@ bool CSceneManager::isCulled(const ISceneNode* node) const
 	// can be seen by cam pyramid planes ?
 	if (!result && (node->getAutomaticCulling() & scene::EAC_FRUSTUM_BOX))
 	{
-		SViewFrustum frust = *cam->getViewFrustum();
-
-		//transform the frustum to the node's current absolute transformation
-		core::matrix4 invTrans(node->getAbsoluteTransformation(), core::matrix4::EM4CONST_INVERSE);
-		//invTrans.makeInverse();
-		frust.transform(invTrans);
+		const SViewFrustum& frust = *cam->getViewFrustum();
 
+		//transform the box edges to world space, cheaper than inverting
+		//the node's transformation and transforming the frustum with it
 		core::vector3df edges[8];
 		node->getBoundingBox().getEdges(edges);
+		node->getAbsoluteTransformation().transformVects(edges, edges, 8);
 
 		for (s32 i=0; i<scene::SViewFrustum::VF_PLANE_COUNT; ++i)
 		{
@@ -1315,10 +1527,155 @@ bool CSceneManager::isCulled(const ISceneNode* node) const
 		}
 	}
 
+	// hidden behind other geometry ?
+	if (!result)
+		result = isOccluded(node);
+
 	return result;
 }
 
 
+//! returns if a node is hidden by occlusion queries or the occlusion culler
+bool CSceneManager::isOccluded(const ISceneNode* node) const
+{
+	// has occlusion query information
+	if ((node->getAutomaticCulling() & scene::EAC_OCC_QUERY) &&
+		Driver->getOcclusionQueryResult(const_cast<ISceneNode*>(node))==0)
+		return true;
+
+	// behind the occluders in the depth buffer of the occlusion culler
+	if ((node->getAutomaticCulling() & scene::EAC_OCC_SOFTWARE) &&
+		OcclusionCuller->isOccluded(node->getTransformedBoundingBox()))
+		return true;
+
+	return false;
+}
+
+
+//! Enables culling with a spatial index of the scene nodes.
+void CSceneManager::setSpatialIndexCulling(bool enable)
+{
+	if (!enable)
+		clearSpatialIndex();
+	SpatialIndexCulling = enable;
+}
+
+
+//! returns if a node which registers for rendering is culled
+bool CSceneManager::isCulledForRendering(ISceneNode* node)
+{
+	if (!SpatialIndexCulling || !ActiveCamera ||
+		!(node->getAutomaticCulling() & (EAC_BOX | EAC_FRUSTUM_BOX | EAC_FRUSTUM_SPHERE)))
+		return isCulled(node);
+
+	const core::matrix4& transform = node->getAbsoluteTransformation();
+	const core::aabbox3df& box = node->getBoundingBox();
+
+	s32 id = node->getSpatialIndexId();
+	if (id < 0 || id >= (s32)SpatialIndexEntries.size() || SpatialIndexEntries[id].Node != node)
+	{
+		core::aabbox3df worldBox(box);
+		transform.transformBoxEx(worldBox);
+
+		SSpatialIndexEntry e;
+		e.Node = node;
+		e.TransformVersion = node->getTransformVersion();
+		e.Box = box;
+		e.Proxy = SpatialIndex.createProxy(worldBox, node);
+
+		// not part of the frustum query of this frame, tested on its own
+		e.VisibleFrame = SpatialIndexFrame;
+		e.Inside = false;
+
+		node->grab();
+		id = SpatialIndexEntries.size();
+		node->setSpatialIndexId(id);
+		SpatialIndexEntries.push_back(e);
+	}
+
+	SSpatialIndexEntry& e = SpatialIndexEntries[id];
+	e.RegisteredFrame = SpatialIndexFrame;
+
+	// moved or animated after the frustum query
+	if (e.TransformVersion != node->getTransformVersion() || e.Box != box)
+	{
+		e.TransformVersion = node->getTransformVersion();
+		e.Box = box;
+
+		core::aabbox3df worldBox(box);
+		transform.transformBoxEx(worldBox);
+		SpatialIndex.moveProxy(e.Proxy, worldBox);
+
+		e.VisibleFrame = SpatialIndexFrame;
+		e.Inside = false;
+	}
+
+	if (e.VisibleFrame != SpatialIndexFrame)
+		return true;
+
+	if (!e.Inside)
+		return isCulled(node);
+
+	// completely inside of the view frustum, only occlusion can cull it
+	return isOccluded(node);
+}
+
+
+//! updates the spatial index before the nodes register for rendering
+void CSceneManager::updateSpatialIndex()
+{
+	IRR_PROFILE(CProfileScope p1(EPID_SM_SPATIAL_INDEX);)
+
+	// nodes which did not register in the last frame may have been removed
+	for (u32 i=0; i<SpatialIndexEntries.size(); )
+	{
+		if (SpatialIndexEntries[i].RegisteredFrame != SpatialIndexFrame)
+			removeSpatialIndexEntry(i);
+		else
+			++i;
+	}
+
+	++SpatialIndexFrame;
+
+	if (ActiveCamera)
+	{
+		SSpatialIndexVisitor visitor(SpatialIndexEntries, SpatialIndexFrame);
+		SpatialIndex.query(*ActiveCamera->getViewFrustum(), visitor);
+	}
+}
+
+
+//! removes an entry from the spatial index
+void CSceneManager::removeSpatialIndexEntry(u32 index)
+{
+	SSpatialIndexEntry& e = SpatialIndexEntries[index];
+	SpatialIndex.destroyProxy(e.Proxy);
+	e.Node->setSpatialIndexId(-1);
+	e.Node->drop();
+
+	const u32 last = SpatialIndexEntries.size() - 1;
+	if (index != last)
+	{
+		e = SpatialIndexEntries[last];
+		e.Node->setSpatialIndexId(index);
+	}
+	SpatialIndexEntries.erase(last);
+}
+
+
+//! removes all nodes from the spatial index
+void CSceneManager::clearSpatialIndex()
+{
+	for (u32 i=0; i<SpatialIndexEntries.size(); ++i)
+	{
+		SpatialIndexEntries[i].Node->setSpatialIndexId(-1);
+		SpatialIndexEntries[i].Node->drop();
+	}
+	SpatialIndexEntries.clear();
+	SpatialIndex.clear();
+}
+
+
 //! registers a node for rendering it at a specific time.
 u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDER_PASS pass)
 {
@@ -1349,7 +1706,7 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 	case ESNRP_LIGHT:
 		// TODO: Point Light culling..
 		// Lighting model in irrlicht has to be redone..
-		//if (!isCulled(node))
+		//if (!isCulledForRendering(node))
 		{
 			LightList.push_back(node);
 			taken = 1;
@@ -1361,28 +1718,28 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 		taken = 1;
 		break;
 	case ESNRP_SOLID:
-		if (!isCulled(node))
+		if (!isCulledForRendering(node))
 		{
 			SolidNodeList.push_back(node);
 			taken = 1;
 		}
 		break;
 	case ESNRP_TRANSPARENT:
-		if (!isCulled(node))
+		if (!isCulledForRendering(node))
 		{
 			TransparentNodeList.push_back(TransparentNodeEntry(node, camWorldPos));
 			taken = 1;
 		}
 		break;
 	case ESNRP_TRANSPARENT_EFFECT:
-		if (!isCulled(node))
+		if (!isCulledForRendering(node))
 		{
 			TransparentEffectNodeList.push_back(TransparentNodeEntry(node, camWorldPos));
 			taken = 1;
 		}
 		break;
 	case ESNRP_AUTOMATIC:
-		if (!isCulled(node))
+		if (!isCulledForRendering(node))
 		{
 			const u32 count = node->getMaterialCount();
 
@@ -1410,7 +1767,7 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 		}
 		break;
 	case ESNRP_SHADOW:
-		if (!isCulled(node))
+		if (!isCulledForRendering(node))
 		{
 			ShadowNodeList.push_back(node);
 			taken = 1;
@@ -1473,8 +1830,8 @@ void CSceneManager::drawAll()
 	Driver->setTransform ( video::ETS_WORLD, core::IdentityMatrix );
 	for (i=video::ETS_COUNT-1; i>=video::ETS_TEXTURE_0; --i)
 		Driver->setTransform ( (video::E_TRANSFORMATION_STATE)i, core::IdentityMatrix );
-	// TODO: This should not use an attribute here but a real parameter when necessary (too slow!)
-	Driver->setAllowZWriteOnTransparent(Parameters->getAttributeAsBool(ALLOW_ZWRITE_ON_TRANSPARENT));
+	// handle only does a name lookup again when parameters were added or removed
+	Driver->setAllowZWriteOnTransparent(Parameters->getAttributeAsBool(AllowZWriteOnTransparentHandle));
 
 	// do animations and other stuff.
 	IRR_PROFILE(getProfiler().start(EPID_SM_ANIMATE));
@@ -1494,6 +1851,12 @@ void CSceneManager::drawAll()
 	}
 	IRR_PROFILE(getProfiler().stop(EPID_SM_RENDER_CAMERAS));
 
+	if (SpatialIndexCulling)
+		updateSpatialIndex();
+
+	// render the occluders before nodes test against them
+	OcclusionCuller->update(ActiveCamera);
+
 	// let all nodes register themselves
 	OnRegisterSceneNode();
 
@@ -1535,7 +1898,8 @@ void CSceneManager::drawAll()
 			if (ActiveCamera)
 				camWorldPos = ActiveCamera->getAbsolutePosition();
 
-			core::array<DistanceNodeEntry> SortedLights;
+			core::array<DistanceNodeEntry, core::irrAllocatorArena<DistanceNodeEntry> > SortedLights;
+			SortedLights.getAllocator().setArena(&FrameArena);
 			SortedLights.set_used(LightList.size());
 			for (s32 light = (s32)LightList.size() - 1; light >= 0; --light)
 				SortedLights[light].setNodeAndDistanceFromPosition(LightList[light], camWorldPos);
@@ -1731,6 +2095,12 @@ void CSceneManager::drawAll()
 	LightList.set_used(0);
 	clearDeletionList();
 
+#ifdef _IRR_SCENEMANAGER_DEBUG
+	Parameters->setAttribute("frame_arena_allocations", (s32) FrameArena.getAllocationCount());
+	Parameters->setAttribute("frame_arena_heap_allocations", (s32) FrameArena.getHeapAllocationCount());
+#endif
+	FrameArena.reset();
+
 	CurrentRenderPass = ESNRP_NONE;
 }
 
@@ -1908,6 +2278,13 @@ ISceneCollisionManager* CSceneManager::getSceneCollisionManager()
 }
 
 
+//! Returns a pointer to the occlusion culler.
+IOcclusionCuller* CSceneManager::getOcclusionCuller()
+{
+	return OcclusionCuller;
+}
+
+
 //! Returns a pointer to the mesh manipulator.
 IMeshManipulator* CSceneManager::getMeshManipulator()
 {
@@ -2125,6 +2502,9 @@ bool CSceneManager::postEventFromUser(const SEvent& event)
 //! Removes all children of this scene node
 void CSceneManager::removeAll()
 {
+	clearSpatialIndex();
+	if (OcclusionCuller)
+		OcclusionCuller->removeAllOccluders();
 	ISceneNode::removeAll();
 	setActiveCamera(0);
 	// Make sure the driver is reset, might need a more complex method at some point
@@ -2268,6 +2648,14 @@ bool CSceneManager::saveScene(io::IWriteFile* file, ISceneUserDataSerializer* us
 		return false;
 	}
 
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_SCENE_WRITER_
+	if (core::hasFileExtension(file->getFileName(), "irrb"))
+	{
+		CSceneWriterIrrBinary writer(this, this, FileSystem);
+		return writer.writeScene(file, FileSystem->getFileDir(FileSystem->getAbsolutePath(file->getFileName())), userDataSerializer, node);
+	}
+#endif
+
 	bool result=false;
 	io::IXMLWriter* writer = FileSystem->createXMLWriter(file);
 	if (!writer)
@@ -2579,6 +2967,9 @@ void CSceneManager::deserializeAttributes(io::IAttributes* in, io::SAttributeRea
 	DebugDataVisible = scene::EDS_OFF;
 	IsDebugObject = false;
 
+	// the members above are written directly, so the cached transformation
+	// has to be marked outdated before it is recalculated
+	setTransformationChanged();
 	updateAbsolutePosition();
 }
 
@@ -2662,6 +3053,12 @@ IMeshWriter* CSceneManager::createMeshWriter(EMESH_WRITER_TYPE type)
 #else
 		return 0;
 #endif // _IRR_COMPILE_WITH_GLTF_WRITER_
+	case EMWT_IRR_BINARY_MESH:
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+		return new CIrrBinaryMeshWriter(Driver);
+#else
+		return 0;
+#endif
 
 	}
 
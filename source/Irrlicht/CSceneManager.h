@@ -13,6 +13,7 @@
 #include "IMeshLoader.h"
 #include "CAttributes.h"
 #include "ILightManager.h"
+#include "CDynamicAABBTree.h"
 
 namespace irr
 {
@@ -129,6 +130,13 @@ namespace scene
 		virtual IOctreeSceneNode* addOctreeSceneNode(IMesh* mesh, ISceneNode* parent=0,
 			s32 id=-1, s32 minimalPolysPerNode=128, bool alsoAddIfMeshPointerZero=false) _IRR_OVERRIDE_;
 
+		//! Merges the meshes of static scene nodes with equal materials.
+		virtual IStaticBatchSceneNode* createStaticBatch(ISceneNode* root=0,
+			f32 cellSize=500.f, s32 id=-1) _IRR_OVERRIDE_;
+
+		//! Creates flat storage for the transformations of a scene node tree.
+		virtual ITransformHierarchy* createTransformHierarchy(ISceneNode* root=0) _IRR_OVERRIDE_;
+
 		//! Adds a camera scene node to the tree and sets it as active camera.
 		//! \param position: Position of the space relative to its parent where the camera will be placed.
 		//! \param lookat: Position where the camera will look at. Also known as target.
@@ -203,6 +211,10 @@ namespace scene
 		virtual IMeshSceneNode* addQuake3SceneNode(const IMeshBuffer* meshBuffer, const quake3::IShader * shader,
 			ISceneNode* parent=0, s32 id=-1) _IRR_OVERRIDE_;
 
+		//! Adds a scene node which draws a quake3 level using its potentially visible set.
+		virtual IQ3LevelSceneNode* addQ3LevelSceneNode(IQ3LevelMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1) _IRR_OVERRIDE_;
+
 
 		//! Adds a Hill Plane mesh to the mesh pool. The mesh is
 		//! generated on the fly and looks like a plane with some hills
@@ -269,6 +281,15 @@ namespace scene
 			s32 maxLOD=4, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,s32 smoothFactor=0,
 			bool addAlsoIfHeightmapEmpty=false) _IRR_OVERRIDE_;
 
+		//! Adds a terrain scene node which loads heightmap tiles around the camera.
+		virtual ITiledTerrainSceneNode* addTiledTerrainSceneNode(
+			const io::path& heightmapPattern, const io::path& texturePattern,
+			u32 tileCountX, u32 tileCountZ, s32 tileSize,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f,1.0f,1.0f),
+			s32 maxLOD=5, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17) _IRR_OVERRIDE_;
+
 		//! Adds a dummy transformation scene node to the scene graph.
 		virtual IDummyTransformationSceneNode* addDummyTransformationSceneNode(
 			ISceneNode* parent=0, s32 id=-1) _IRR_OVERRIDE_;
@@ -399,6 +420,9 @@ namespace scene
 		//! Returns a pointer to the scene collision manager.
 		virtual ISceneCollisionManager* getSceneCollisionManager() _IRR_OVERRIDE_;
 
+		//! Returns a pointer to the occlusion culler.
+		virtual IOcclusionCuller* getOcclusionCuller() _IRR_OVERRIDE_;
+
 		//! Returns a pointer to the mesh manipulator.
 		virtual IMeshManipulator* getMeshManipulator() _IRR_OVERRIDE_;
 
@@ -531,11 +555,48 @@ namespace scene
 		//! returns if node is culled
 		virtual bool isCulled(const ISceneNode* node) const _IRR_OVERRIDE_;
 
+		//! Enables culling with a spatial index of the scene nodes.
+		virtual void setSpatialIndexCulling(bool enable) _IRR_OVERRIDE_;
+
+		//! Returns if culling with a spatial index of the scene nodes is enabled.
+		virtual bool getSpatialIndexCulling() const _IRR_OVERRIDE_ { return SpatialIndexCulling; }
+
+		//! Returns how many scene nodes are in the spatial index.
+		virtual u32 getSpatialIndexNodeCount() const _IRR_OVERRIDE_ { return SpatialIndexEntries.size(); }
+
 	private:
 
+		//! returns if a node is hidden by occlusion queries or the occlusion culler
+		bool isOccluded(const ISceneNode* node) const;
+
+		//! returns if a node which registers for rendering is culled, uses the spatial index when enabled
+		bool isCulledForRendering(ISceneNode* node);
+
+		//! removes nodes which were not registered in the last frame and
+		//! tests the spatial index against the frustum of the active camera
+		void updateSpatialIndex();
+
+		//! removes an entry from the spatial index
+		void removeSpatialIndexEntry(u32 index);
+
+		//! removes all nodes from the spatial index
+		void clearSpatialIndex();
+
 		// load and create a mesh which we know already isn't in the cache and put it in there
 		IAnimatedMesh* getUncachedMesh(io::IReadFile* file, const io::path& filename, const io::path& cachename);
 
+		//! returns name of the binary cache file for a mesh file or an empty path when there is none
+		io::path getBinaryMeshCacheName(const io::path& filename) const;
+
+		//! returns the hash of the content of a mesh file, stored in its binary cache
+		u32 getBinaryMeshCacheSourceHash(io::IReadFile* file) const;
+
+		//! loads a mesh from the binary cache, returns 0 when there is no matching cache file
+		IAnimatedMesh* loadBinaryMeshCache(const io::path& cacheName, u32 sourceSize, u32 sourceHash);
+
+		//! writes a loaded mesh to the binary cache
+		void writeBinaryMeshCache(const io::path& cacheName, IAnimatedMesh* mesh, u32 sourceSize, u32 sourceHash);
+
 		//! clears the deletion list
 		void clearDeletionList();
 
@@ -606,6 +667,44 @@ namespace scene
 			f64 Distance;
 		};
 
+		//! scene node in the spatial index
+		struct SSpatialIndexEntry
+		{
+			ISceneNode* Node;
+
+			//! transformation version and box the proxy was last updated with
+			u32 TransformVersion;
+			core::aabbox3df Box;
+
+			s32 Proxy;
+
+			//! last frame in which the node registered for rendering
+			u32 RegisteredFrame;
+
+			//! last frame in which the proxy was found in the view frustum
+			u32 VisibleFrame;
+
+			//! if the proxy was completely inside of the view frustum
+			bool Inside;
+		};
+
+		//! marks the entries found by the frustum query
+		struct SSpatialIndexVisitor
+		{
+			SSpatialIndexVisitor(core::array<SSpatialIndexEntry>& entries, u32 frame)
+				: Entries(entries), Frame(frame) {}
+
+			void operator()(s32 proxy, void* userData, bool inside)
+			{
+				SSpatialIndexEntry& e = Entries[((ISceneNode*)userData)->getSpatialIndexId()];
+				e.VisibleFrame = Frame;
+				e.Inside = inside;
+			}
+
+			core::array<SSpatialIndexEntry>& Entries;
+			u32 Frame;
+		};
+
 		//! video driver
 		video::IVideoDriver* Driver;
 
@@ -621,6 +720,9 @@ namespace scene
 		//! collision manager
 		ISceneCollisionManager* CollisionManager;
 
+		//! software occlusion culling
+		IOcclusionCuller* OcclusionCuller;
+
 		//! render pass lists
 		core::array<ISceneNode*> CameraList;
 		core::array<ISceneNode*> LightList;
@@ -630,6 +732,9 @@ namespace scene
 		core::array<TransparentNodeEntry> TransparentNodeList;
 		core::array<TransparentNodeEntry> TransparentEffectNodeList;
 
+		//! memory for temporary arrays of drawAll, reset at its end
+		core::irrMemoryArena FrameArena;
+
 		core::array<IMeshLoader*> MeshLoaderList;
 		core::array<ISceneLoader*> SceneLoaderList;
 		core::array<ISceneNode*> DeletionList;
@@ -647,6 +752,9 @@ namespace scene
 		// NOTE: Attributes are slow and should only be used for debug-info and not in release
 		io::CAttributes* Parameters;
 
+		//! Pre-resolved handle for ALLOW_ZWRITE_ON_TRANSPARENT which is read every frame
+		io::SAttributeHandle AllowZWriteOnTransparentHandle;
+
 		//! Mesh cache
 		IMeshCache* MeshCache;
 
@@ -663,6 +771,12 @@ namespace scene
 		const core::stringw IRR_XML_FORMAT_NODE_ATTR_TYPE;
 
 		IGeometryCreator* GeometryCreator;
+
+		//! bounding volume tree of the nodes which registered for rendering
+		CDynamicAABBTree SpatialIndex;
+		core::array<SSpatialIndexEntry> SpatialIndexEntries;
+		u32 SpatialIndexFrame;
+		bool SpatialIndexCulling;
 	};
 
 } // end namespace video
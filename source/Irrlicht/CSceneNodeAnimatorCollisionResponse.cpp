@@ -22,6 +22,7 @@ CSceneNodeAnimatorCollisionResponse::CSceneNodeAnimatorCollisionResponse(
 		const core::vector3df& ellipsoidTranslation,
 		f32 slidingSpeed)
 : Radius(ellipsoidRadius), Gravity(gravityPerSecond), Translation(ellipsoidTranslation),
+	StepSeconds(0.f), StepFalling(false), SkipNextAnimation(false),
 	World(world), Object(object), SceneManager(scenemanager), LastTime(0),
 	SlidingSpeed(slidingSpeed), CollisionNode(0), CollisionCallback(0),
 	Falling(false), IsCamera(false), AnimateCameraTarget(true), CollisionOccurred(false),
@@ -139,14 +140,45 @@ ITriangleSelector* CSceneNodeAnimatorCollisionResponse::getWorld() const
 
 void CSceneNodeAnimatorCollisionResponse::animateNode(ISceneNode* node, u32 timeMs)
 {
-	CollisionOccurred = false;
+	// already moved by ISceneCollisionManager::animateCollisionResponses
+	if (SkipNextAnimation)
+	{
+		SkipNextAnimation = false;
+		if (node == Object && timeMs == LastTime)
+			return;
+	}
 
 	if (node != Object)
 		setNode(node);
 
-	if(!Object || !World)
+	if (!beginStep(timeMs))
 		return;
 
+	if ( AnimateCameraTarget )
+	{
+		// TODO: divide SlidingSpeed by frame time
+
+		CollisionResultPosition
+			= SceneManager->getSceneCollisionManager()->getCollisionResultPosition(
+				World, LastPosition-Translation,
+				Radius, StepVelocity, CollisionTriangle, CollisionPoint, StepFalling,
+				CollisionNode, SlidingSpeed, FallingVelocity*StepSeconds);
+	}
+
+	endStep();
+}
+
+
+//! Starts a step, returns false when there is nothing to do
+bool CSceneNodeAnimatorCollisionResponse::beginStep(u32 timeMs, bool batched)
+{
+	CollisionOccurred = false;
+
+	if(!Object || !World)
+		return false;
+
+	SkipNextAnimation = batched;
+
 	// trigger reset
 	if ( timeMs == 0 )
 	{
@@ -164,39 +196,53 @@ void CSceneNodeAnimatorCollisionResponse::animateNode(ISceneNode* node, u32 time
 		FirstUpdate = false;
 	}
 
-	const f32 diffSec = (f32)(timeMs - LastTime)*0.001f;
+	StepSeconds = (f32)(timeMs - LastTime)*0.001f;
 	LastTime = timeMs;
 
 	CollisionResultPosition = Object->getPosition();
-	core::vector3df vel = CollisionResultPosition - LastPosition;
+	StepVelocity = CollisionResultPosition - LastPosition;
 
-	FallingVelocity += Gravity * diffSec;
+	FallingVelocity += Gravity * StepSeconds;
 
 	CollisionTriangle = RefTriangle;
 	CollisionPoint = core::vector3df();
 	CollisionResultPosition = core::vector3df();
 	CollisionNode = 0;
+	StepFalling = false;
 
 	// core::vector3df force = vel + FallingVelocity;
 
+	return true;
+}
+
+
+//! Tests the step against the world, only changes the animator and the buffers
+void CSceneNodeAnimatorCollisionResponse::collide(CSceneCollisionManager* collisionManager,
+		CSceneCollisionManager::SCollisionBuffers& buffers)
+{
 	if ( AnimateCameraTarget )
 	{
-		// TODO: divide SlidingSpeed by frame time
-
-		bool f = false;
 		CollisionResultPosition
-			= SceneManager->getSceneCollisionManager()->getCollisionResultPosition(
+			= collisionManager->getCollisionResultPosition(buffers,
 				World, LastPosition-Translation,
-				Radius, vel, CollisionTriangle, CollisionPoint, f,
-				CollisionNode, SlidingSpeed, FallingVelocity*diffSec);
+				Radius, StepVelocity, CollisionTriangle, CollisionPoint, StepFalling,
+				CollisionNode, SlidingSpeed, FallingVelocity*StepSeconds);
+	}
+}
 
+
+//! Calls the collision callback and moves the node
+void CSceneNodeAnimatorCollisionResponse::endStep()
+{
+	if ( AnimateCameraTarget )
+	{
 		CollisionOccurred = (CollisionTriangle != RefTriangle);
 
 		CollisionResultPosition += Translation;
 
-		if ( diffSec > 0 )	// don't change the state when there was no time
+		if ( StepSeconds > 0 )	// don't change the state when there was no time
 		{
-			if (f)//CollisionTriangle == RefTriangle)
+			if (StepFalling)//CollisionTriangle == RefTriangle)
 			{
 				Falling = true;
 			}
@@ -220,7 +266,7 @@ void CSceneNodeAnimatorCollisionResponse::animateNode(ISceneNode* node, u32 time
 	// move camera target
 	if (AnimateCameraTarget && IsCamera)
 	{
-		const core::vector3df pdiff = Object->getPosition() - LastPosition - vel;
+		const core::vector3df pdiff = Object->getPosition() - LastPosition - StepVelocity;
 		ICameraSceneNode* cam = (ICameraSceneNode*)Object;
 		cam->setTarget(cam->getTarget() + pdiff);
 	}
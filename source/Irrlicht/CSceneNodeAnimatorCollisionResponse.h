@@ -6,6 +6,7 @@
 #define __C_SCENE_NODE_ANIMATOR_COLLISION_RESPONSE_H_INCLUDED__
 
 #include "ISceneNodeAnimatorCollisionResponse.h"
+#include "CSceneCollisionManager.h"
 
 namespace irr
 {
@@ -119,6 +120,19 @@ namespace scene
 		*/
 		virtual void setCollisionCallback(ICollisionCallback* callback) _IRR_OVERRIDE_;
 
+		// The steps of animateNode(), CSceneCollisionManager::animateCollisionResponses()
+		// runs collide() of many animators in parallel
+
+		//! Starts a step, returns false when there is nothing to do
+		/** \param batched The next animateNode() with the same time is skipped. */
+		bool beginStep(u32 timeMs, bool batched=false);
+
+		//! Tests the step against the world, only changes the animator and the buffers
+		void collide(CSceneCollisionManager* collisionManager, CSceneCollisionManager::SCollisionBuffers& buffers);
+
+		//! Calls the collision callback and moves the node
+		void endStep();
+
 	private:
 
 		void setNode(ISceneNode* node);
@@ -131,6 +145,14 @@ namespace scene
 		core::vector3df LastPosition;
 		core::triangle3df RefTriangle;
 
+		// state of the current step
+		core::vector3df StepVelocity;
+		f32 StepSeconds;
+		bool StepFalling;
+
+		//! set by animateCollisionResponses, the next animateNode with the same time does nothing
+		bool SkipNextAnimation;
+
 		ITriangleSelector* World;
 		ISceneNode* Object;
 		ISceneManager* SceneManager;
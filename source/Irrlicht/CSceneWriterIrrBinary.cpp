@@ -0,0 +1,180 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_SCENE_WRITER_
+
+#include "CSceneWriterIrrBinary.h"
+#include "SIrrBinarySceneStructs.h"
+#include "ISceneManager.h"
+#include "ISceneNode.h"
+#include "ISceneNodeAnimator.h"
+#include "ISceneUserDataSerializer.h"
+#include "IVideoDriver.h"
+#include "IFileSystem.h"
+#include "IWriteFile.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Constructor
+CSceneWriterIrrBinary::CSceneWriterIrrBinary(ISceneManager* smgr, ISceneNode* sceneRoot, io::IFileSystem* fs)
+ : SceneManager(smgr), SceneRoot(sceneRoot), FileSystem(fs)
+{
+}
+
+
+//! Writes the scene below node
+bool CSceneWriterIrrBinary::writeScene(io::IWriteFile* file, const io::path& currentPath,
+		ISceneUserDataSerializer* userDataSerializer, ISceneNode* node)
+{
+	if (!file)
+		return false;
+
+	if (!node)
+		node = SceneRoot;
+
+	CurrentPath = currentPath;
+	if (!CurrentPath.empty())
+	{
+		Options.Filename = CurrentPath.c_str();
+		Options.Flags |= io::EARWF_USE_RELATIVE_PATHS;
+	}
+
+	Writer.clear();
+	writeSceneNode(node, userDataSerializer, true);
+	Writer.finish();
+
+	const core::array<u32>& stringOffsets = Writer.getStringOffsets();
+	const core::array<c8>& stringData = Writer.getStringData();
+	const core::array<u32>& data = Writer.getData();
+
+	SIrrBinarySceneHeader header;
+	header.Magic = IRRB_SCENE_MAGIC;
+	header.Version = IRRB_SCENE_VERSION;
+	header.StringCount = stringOffsets.size();
+	header.StringTableOffset = sizeof(SIrrBinarySceneHeader);
+	header.StringDataSize = stringData.size();
+	header.NodeDataOffset = header.StringTableOffset + header.StringCount*sizeof(u32) + header.StringDataSize;
+	header.NodeDataSize = data.size();
+
+#ifdef __BIG_ENDIAN__
+	u32* headerWords = reinterpret_cast<u32*>(&header);
+	for (u32 i=0; i<sizeof(header)/sizeof(u32); ++i)
+		headerWords[i] = os::Byteswap::byteswap(headerWords[i]);
+#endif
+
+	size_t written = file->write(&header, sizeof(header));
+	if (!stringOffsets.empty())
+		written += file->write(stringOffsets.const_pointer(), stringOffsets.size()*sizeof(u32));
+	if (!stringData.empty())
+		written += file->write(stringData.const_pointer(), stringData.size());
+	if (!data.empty())
+		written += file->write(data.const_pointer(), data.size()*sizeof(u32));
+
+	const size_t expected = sizeof(header) + (stringOffsets.size()+data.size())*sizeof(u32) + stringData.size();
+	if (written != expected)
+	{
+		os::Printer::log("Could not write binary scene file", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	return true;
+}
+
+
+//! writes a node record and all its children
+void CSceneWriterIrrBinary::writeSceneNode(ISceneNode* node, ISceneUserDataSerializer* userDataSerializer, bool init)
+{
+	ISceneNode* tmpNode = node;
+
+	if (init)
+	{
+		Writer.writeWord(io::IRR_BINARY_NO_STRING);
+		node = SceneRoot;
+	}
+	else
+		Writer.writeWord(Writer.addString(SceneManager->getSceneNodeTypeName(node->getType())));
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	// properties
+	io::IAttributes* attr = FileSystem->createEmptyAttributes(driver);
+	node->serializeAttributes(attr, &Options);
+	Writer.writeAttributes(attr);
+
+	// materials
+	const u32 materialCount = driver ? node->getMaterialCount() : 0;
+	Writer.writeWord(materialCount);
+	for (u32 i=0; i<materialCount; ++i)
+	{
+		io::IAttributes* materialAttr = driver->createAttributesFromMaterial(node->getMaterial(i), &Options);
+		Writer.writeAttributes(materialAttr);
+		materialAttr->drop();
+	}
+
+	// animators
+	const ISceneNodeAnimatorList& animators = node->getAnimators();
+	Writer.writeWord(animators.size());
+	ISceneNodeAnimatorList::ConstIterator ait = animators.begin();
+	for (; ait != animators.end(); ++ait)
+	{
+		attr->clear();
+		attr->addString("Type", SceneManager->getAnimatorTypeName((*ait)->getType()));
+		(*ait)->serializeAttributes(attr);
+		Writer.writeAttributes(attr);
+	}
+
+	attr->drop();
+
+	// user data
+	io::IAttributes* userData = userDataSerializer ? userDataSerializer->createUserData(node) : 0;
+	Writer.writeWord(userData ? 1 : 0);
+	if (userData)
+	{
+		Writer.writeAttributes(userData);
+		userData->drop();
+	}
+
+	// reset to actual root node
+	if (init)
+		node = tmpNode;
+
+	// children, the child count is patched once it's known as debug objects are skipped
+	const u32 childCountPos = Writer.getPosition();
+	Writer.writeWord(0);
+	u32 childCount = 0;
+
+	if (init && node != SceneRoot)
+	{
+		if (!node->isDebugObject())
+		{
+			writeSceneNode(node, userDataSerializer);
+			++childCount;
+		}
+	}
+	else
+	{
+		ISceneNodeList::ConstIterator it = node->getChildren().begin();
+		for (; it != node->getChildren().end(); ++it)
+		{
+			if ((*it)->isDebugObject())
+				continue;
+			writeSceneNode(*it, userDataSerializer);
+			++childCount;
+		}
+	}
+
+	Writer.setWord(childCountPos, childCount);
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_IRR_BINARY_SCENE_WRITER_
@@ -0,0 +1,62 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_WRITER_IRR_BINARY_H_INCLUDED__
+#define __C_SCENE_WRITER_IRR_BINARY_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#include "IAttributeExchangingObject.h"
+#include "CIrrBinaryAttributes.h"
+
+namespace irr
+{
+namespace io
+{
+	class IFileSystem;
+	class IWriteFile;
+} // end namespace io
+
+namespace scene
+{
+	class ISceneManager;
+	class ISceneNode;
+	class ISceneUserDataSerializer;
+
+//! Writes scenes into the binary .irrb format, see SIrrBinarySceneStructs.h
+/** Contains the same data as .irr files written by ISceneManager::saveScene,
+but attributes are stored as typed binary values and all strings are
+collected in a shared string table. */
+class CSceneWriterIrrBinary
+{
+public:
+
+	//! Constructor
+	/** \param smgr Scene manager of the scene.
+	\param sceneRoot The scene manager as scene node, it's attributes are
+	written for the scene root. */
+	CSceneWriterIrrBinary(ISceneManager* smgr, ISceneNode* sceneRoot, io::IFileSystem* fs);
+
+	//! Writes the scene below node, or the full scene when node is 0 or the scene root.
+	bool writeScene(io::IWriteFile* file, const io::path& currentPath,
+		ISceneUserDataSerializer* userDataSerializer=0, ISceneNode* node=0);
+
+private:
+
+	//! writes a node record and all its children
+	void writeSceneNode(ISceneNode* node, ISceneUserDataSerializer* userDataSerializer, bool init=false);
+
+	ISceneManager* SceneManager;
+	ISceneNode* SceneRoot;
+	io::IFileSystem* FileSystem;
+
+	io::path CurrentPath;
+	io::SAttributeReadWriteOptions Options;
+
+	io::CIrrBinaryWriter Writer;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
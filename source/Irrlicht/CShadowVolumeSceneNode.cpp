@@ -26,7 +26,7 @@ CShadowVolumeSceneNode::CShadowVolumeSceneNode(const IMesh* shadowMesh, ISceneNo
 		ISceneManager* mgr, s32 id, bool zfailmethod, f32 infinity)
 : IShadowVolumeSceneNode(parent, mgr, id),
 	ShadowMesh(0), IndexCount(0), VertexCount(0), ShadowVolumesUsed(0),
-	Infinity(infinity), UseZFailMethod(zfailmethod)
+	MeshVersion(1), Infinity(infinity), UseZFailMethod(zfailmethod)
 {
 	#ifdef _DEBUG
 	setDebugName("CShadowVolumeSceneNode");
@@ -44,44 +44,28 @@ CShadowVolumeSceneNode::~CShadowVolumeSceneNode()
 }
 
 
-void CShadowVolumeSceneNode::createShadowVolume(const core::vector3df& light, bool isDirectional)
+void CShadowVolumeSceneNode::createShadowVolume(SShadowVolume& volume, bool isDirectional)
 {
-	SShadowVolume* svp = 0;
-	core::aabbox3d<f32>* bb = 0;
+	// builds the shadow volume from scratch. Only reads the shared mesh
+	// copy, so volumes of several lights can be built at the same time.
+	core::array<core::vector3df>* svp = &volume.Triangles;
+	const core::vector3df& light = volume.Light;
 
-	// builds the shadow volume and adds it to the shadow volume list.
-
-	if (ShadowVolumes.size() > ShadowVolumesUsed)
-	{
-		// get the next unused buffer
-
-		svp = &ShadowVolumes[ShadowVolumesUsed];
-		svp->set_used(0);
-
-		bb = &ShadowBBox[ShadowVolumesUsed];
-	}
-	else
-	{
-		ShadowVolumes.push_back(SShadowVolume());
-		svp = &ShadowVolumes.getLast();
-
-		ShadowBBox.push_back(core::aabbox3d<f32>());
-		bb = &ShadowBBox.getLast();
-	}
+	svp->set_used(0);
 	svp->reallocate(IndexCount*5);
-	++ShadowVolumesUsed;
 
 	// We use triangle lists
-	Edges.set_used(IndexCount*2);
+	volume.Edges.set_used(IndexCount*2);
+	volume.FaceData.set_used(IndexCount/3);
 	u32 numEdges = 0;
 
-	numEdges=createEdgesAndCaps(light, svp, bb);
+	numEdges=createEdgesAndCaps(volume);
 
 	// for all edges add the near->far quads
 	for (u32 i=0; i<numEdges; ++i)
 	{
-		const core::vector3df &v1 = Vertices[Edges[2*i+0]];
-		const core::vector3df &v2 = Vertices[Edges[2*i+1]];
+		const core::vector3df &v1 = Vertices[volume.Edges[2*i+0]];
+		const core::vector3df &v2 = Vertices[volume.Edges[2*i+1]];
 		const core::vector3df v3(v1+(v1 - light).normalize()*Infinity);
 		const core::vector3df v4(v2+(v2 - light).normalize()*Infinity);
 
@@ -104,9 +88,13 @@ void CShadowVolumeSceneNode::createShadowVolume(const core::vector3df& light, bo
 #define IRR_USE_ADJACENCY
 #define IRR_USE_REVERSE_EXTRUDED
 
-u32 CShadowVolumeSceneNode::createEdgesAndCaps(const core::vector3df& light,
-					SShadowVolume* svp, core::aabbox3d<f32>* bb)
+u32 CShadowVolumeSceneNode::createEdgesAndCaps(SShadowVolume& volume)
 {
+	const core::vector3df& light = volume.Light;
+	core::array<core::vector3df>* svp = &volume.Triangles;
+	core::aabbox3d<f32>* bb = &volume.BBox;
+	core::array<u16>& Edges = volume.Edges;
+	core::array<bool>& FaceData = volume.FaceData;
 	u32 numEdges=0;
 	const u32 faceCount = IndexCount / 3;
 
@@ -217,47 +205,65 @@ void CShadowVolumeSceneNode::setShadowMesh(const IMesh* mesh)
 		ShadowMesh->grab();
 		Box = ShadowMesh->getBoundingBox();
 	}
+	// force a new copy of the mesh with the next update
+	BufferStates.clear();
 }
 
 
-void CShadowVolumeSceneNode::updateShadowVolumes()
+bool CShadowVolumeSceneNode::updateMeshCopy()
 {
-	const u32 oldIndexCount = IndexCount;
-	const u32 oldVertexCount = VertexCount;
-
 	const IMesh* const mesh = ShadowMesh;
-	if (!mesh)
-		return;
+	const u32 bufcnt = mesh->getMeshBufferCount();
 
-	// create as much shadow volumes as there are lights but
-	// do not ignore the max light settings.
-	const u32 lightCount = SceneManager->getVideoDriver()->getDynamicLightCount();
-	if (!lightCount)
-		return;
+	// Animated meshes flag their buffers dirty when the frame changes,
+	// so the change ids tell if the copy is still valid.
+	bool changed = (BufferStates.size() != bufcnt);
+	bool indicesChanged = changed;
+	u32 i;
 
-	// calculate total amount of vertices and indices
+	for (i=0; i<bufcnt && !indicesChanged; ++i)
+	{
+		const IMeshBuffer* buf = mesh->getMeshBuffer(i);
+		const SBufferState& state = BufferStates[i];
+		if (state.Buffer != buf ||
+			state.ChangedIndex != buf->getChangedID_Index() ||
+			state.IndexCount != buf->getIndexCount() ||
+			state.VertexCount != buf->getVertexCount())
+			indicesChanged = true;
+		else if (state.ChangedVertex != buf->getChangedID_Vertex())
+			changed = true;
+	}
 
-	VertexCount = 0;
-	IndexCount = 0;
-	ShadowVolumesUsed = 0;
+	if (!changed && !indicesChanged)
+		return false;
+
+	// calculate total amount of vertices and indices
 
-	u32 i;
 	u32 totalVertices = 0;
 	u32 totalIndices = 0;
-	const u32 bufcnt = mesh->getMeshBufferCount();
 
+	BufferStates.set_used(bufcnt);
 	for (i=0; i<bufcnt; ++i)
 	{
 		const IMeshBuffer* buf = mesh->getMeshBuffer(i);
-		totalIndices += buf->getIndexCount();
-		totalVertices += buf->getVertexCount();
+		SBufferState& state = BufferStates[i];
+		state.Buffer = buf;
+		state.ChangedVertex = buf->getChangedID_Vertex();
+		state.ChangedIndex = buf->getChangedID_Index();
+		state.VertexCount = buf->getVertexCount();
+		state.IndexCount = buf->getIndexCount();
+
+		totalIndices += state.IndexCount;
+		totalVertices += state.VertexCount;
 	}
 
 	// allocate memory if necessary
 
 	Vertices.set_used(totalVertices);
 	Indices.set_used(totalIndices);
-	FaceData.set_used(totalIndices / 3);
+
+	VertexCount = 0;
+	IndexCount = 0;
 
 	// copy mesh
 	for (i=0; i<bufcnt; ++i)
@@ -275,15 +281,38 @@ void CShadowVolumeSceneNode::updateShadowVolumes()
 	}
 
 	// recalculate adjacency if necessary
-	if (oldVertexCount != VertexCount || oldIndexCount != IndexCount)
+	if (indicesChanged)
 		calculateAdjacency();
 
+	++MeshVersion;
+	return true;
+}
+
+
+void CShadowVolumeSceneNode::updateShadowVolumes()
+{
+	DirtyVolumes.set_used(0);
+
+	const IMesh* const mesh = ShadowMesh;
+	if (!mesh)
+		return;
+
+	// create as much shadow volumes as there are lights but
+	// do not ignore the max light settings.
+	const u32 lightCount = SceneManager->getVideoDriver()->getDynamicLightCount();
+	if (!lightCount)
+		return;
+
+	updateMeshCopy();
+
+	ShadowVolumesUsed = 0;
+
 	core::matrix4 mat = Parent->getAbsoluteTransformation();
 	mat.makeInverse();
 	const core::vector3df parentpos = Parent->getAbsolutePosition();
 
 	// TODO: Only correct for point lights.
-	for (i=0; i<lightCount; ++i)
+	for (u32 i=0; i<lightCount; ++i)
 	{
 		const video::SLight& dl = SceneManager->getVideoDriver()->getDynamicLight(i);
 		core::vector3df lpos = dl.Position;
@@ -291,9 +320,29 @@ void CShadowVolumeSceneNode::updateShadowVolumes()
 			fabs((lpos - parentpos).getLengthSQ()) <= (dl.Radius*dl.Radius*4.0f))
 		{
 			mat.transformVect(lpos);
-			createShadowVolume(lpos);
+
+			if (ShadowVolumes.size() == ShadowVolumesUsed)
+				ShadowVolumes.push_back(SShadowVolume());
+
+			// keep the volume while neither the light moved relative
+			// to the mesh nor the mesh changed
+			SShadowVolume& volume = ShadowVolumes[ShadowVolumesUsed];
+			if (volume.MeshVersion != MeshVersion || !volume.Light.equals(lpos))
+			{
+				volume.Light = lpos;
+				volume.MeshVersion = MeshVersion;
+				DirtyVolumes.push_back(ShadowVolumesUsed);
+			}
+			++ShadowVolumesUsed;
 		}
 	}
+
+	const s32 dirtyCount = (s32)DirtyVolumes.size();
+#ifdef _OPENMP
+	#pragma omp parallel for if (dirtyCount > 1)
+#endif
+	for (s32 i=0; i<dirtyCount; ++i)
+		createShadowVolume(ShadowVolumes[DirtyVolumes[i]]);
 }
 
 
@@ -317,29 +366,37 @@ void CShadowVolumeSceneNode::render()
 
 	driver->setTransform(video::ETS_WORLD, Parent->getAbsoluteTransformation());
 
+	const ICameraSceneNode* camera = UseZFailMethod ? SceneManager->getActiveCamera() : 0;
+	SViewFrustum frust;
+	core::vector3df cameraPos;
+	if (camera)
+	{
+		// the frustum in mesh space is the same for all volumes
+		frust = *camera->getViewFrustum();
+
+		core::matrix4 invTrans(Parent->getAbsoluteTransformation(), core::matrix4::EM4CONST_INVERSE);
+		frust.transform(invTrans);
+		cameraPos = camera->getPosition();
+	}
+
 	for (u32 i=0; i<ShadowVolumesUsed; ++i)
 	{
 		bool drawShadow = true;
 
-		if (UseZFailMethod && SceneManager->getActiveCamera())
+		if (camera)
 		{
 			// Disable shadows drawing, when back cap is behind of ZFar plane.
 
-			SViewFrustum frust = *SceneManager->getActiveCamera()->getViewFrustum();
-
-			core::matrix4 invTrans(Parent->getAbsoluteTransformation(), core::matrix4::EM4CONST_INVERSE);
-			frust.transform(invTrans);
-
 			core::vector3df edges[8];
-			ShadowBBox[i].getEdges(edges);
+			ShadowVolumes[i].BBox.getEdges(edges);
 
 			core::vector3df largestEdge = edges[0];
-			f32 maxDistance = core::vector3df(SceneManager->getActiveCamera()->getPosition() - edges[0]).getLength();
+			f32 maxDistance = core::vector3df(cameraPos - edges[0]).getLength();
 			f32 curDistance = 0.f;
 
 			for(int j = 1; j < 8; ++j)
 			{
-				curDistance = core::vector3df(SceneManager->getActiveCamera()->getPosition() - edges[j]).getLength();
+				curDistance = core::vector3df(cameraPos - edges[j]).getLength();
 
 				if(curDistance > maxDistance)
 				{
@@ -353,7 +410,7 @@ void CShadowVolumeSceneNode::render()
 		}
 
 		if(drawShadow)
-			driver->drawStencilShadowVolume(ShadowVolumes[i], UseZFailMethod, DebugDataVisible);
+			driver->drawStencilShadowVolume(ShadowVolumes[i].Triangles, UseZFailMethod, DebugDataVisible);
 		else
 		{
 			core::array<core::vector3df> triangles;
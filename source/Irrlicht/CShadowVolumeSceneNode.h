@@ -6,11 +6,13 @@
 #define __C_SHADOW_VOLUME_SCENE_NODE_H_INCLUDED__
 
 #include "IShadowVolumeSceneNode.h"
+#include "irrArray.h"
 
 namespace irr
 {
 namespace scene
 {
+	class IMeshBuffer;
 
 	//! Scene node for rendering a shadow volume into a stencil buffer.
 	class CShadowVolumeSceneNode : public IShadowVolumeSceneNode
@@ -33,6 +35,9 @@ namespace scene
 		/** Called each render cycle from Animated Mesh SceneNode render method. */
 		virtual void updateShadowVolumes() _IRR_OVERRIDE_;
 
+		//! Returns how many shadow volumes the last update had to rebuild.
+		virtual u32 getRebuiltVolumeCount() const _IRR_OVERRIDE_ { return DirtyVolumes.size(); }
+
 		//! pre render method
 		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
 
@@ -47,10 +52,40 @@ namespace scene
 
 	private:
 
-		typedef core::array<core::vector3df> SShadowVolume;
-
-		void createShadowVolume(const core::vector3df& pos, bool isDirectional=false);
-		u32 createEdgesAndCaps(const core::vector3df& light, SShadowVolume* svp, core::aabbox3d<f32>* bb);
+		//! shadow volume of a light, kept until the light or the mesh changes
+		struct SShadowVolume
+		{
+			SShadowVolume() : MeshVersion(0) {}
+
+			core::array<core::vector3df> Triangles;
+			// back cap bounding box
+			core::aabbox3d<f32> BBox;
+			// light position in mesh space the volume was built for
+			core::vector3df Light;
+			// version of the copied mesh the volume was built from
+			u32 MeshVersion;
+			// scratch data, one set per volume so volumes can be built in parallel
+			core::array<u16> Edges;
+			// tells if face is front facing
+			core::array<bool> FaceData;
+		};
+
+		//! state of a mesh buffer when it was copied
+		struct SBufferState
+		{
+			const IMeshBuffer* Buffer;
+			u32 ChangedVertex;
+			u32 ChangedIndex;
+			u32 VertexCount;
+			u32 IndexCount;
+		};
+
+		void createShadowVolume(SShadowVolume& volume, bool isDirectional=false);
+		u32 createEdgesAndCaps(SShadowVolume& volume);
+
+		//! Copies the mesh if it changed since the last update.
+		/** \return True if the copy was updated. */
+		bool updateMeshCopy();
 
 		//! Generates adjacency information based on mesh indices.
 		void calculateAdjacency();
@@ -59,22 +94,20 @@ namespace scene
 
 		// a shadow volume for every light
 		core::array<SShadowVolume> ShadowVolumes;
+		// volumes which have to be rebuilt in this update
+		core::array<u32> DirtyVolumes;
 
-		// a back cap bounding box for every light
-		core::array<core::aabbox3d<f32> > ShadowBBox;
-
+		core::array<SBufferState> BufferStates;
 		core::array<core::vector3df> Vertices;
 		core::array<u16> Indices;
 		core::array<u16> Adjacency;
-		core::array<u16> Edges;
-		// tells if face is front facing
-		core::array<bool> FaceData;
 
 		const scene::IMesh* ShadowMesh;
 
 		u32 IndexCount;
 		u32 VertexCount;
 		u32 ShadowVolumesUsed;
+		u32 MeshVersion;
 
 		f32 Infinity;
 
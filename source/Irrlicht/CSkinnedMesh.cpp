@@ -569,20 +569,28 @@ void CSkinnedMesh::skinJoint(SJoint *joint, SJoint *parentJoint)
 		core::matrix4 jointVertexPull(core::matrix4::EM4CONST_NOTHING);
 		jointVertexPull.setbyproduct(joint->GlobalAnimatedMatrix, joint->GlobalInversedMatrix);
 
-		core::vector3df thisVertexMove, thisNormalMove;
-
 		core::array<scene::SSkinMeshBuffer*> &buffersUsed=*SkinningBuffers;
 
+		// Pull all vertices of this joint at once...
+		const u32 weightCount = joint->Weights.size();
+		SkinnedPositions.set_used(weightCount);
+		for (u32 i=0; i<weightCount; ++i)
+			SkinnedPositions[i] = joint->Weights[i].StaticPos;
+		jointVertexPull.transformVects(SkinnedPositions.pointer(), SkinnedPositions.pointer(), weightCount);
+
+		if (AnimateNormals)
+		{
+			SkinnedNormals.set_used(weightCount);
+			for (u32 i=0; i<weightCount; ++i)
+				SkinnedNormals[i] = joint->Weights[i].StaticNormal;
+			jointVertexPull.rotateVects(SkinnedNormals.pointer(), SkinnedNormals.pointer(), weightCount);
+		}
+
 		//Skin Vertices Positions and Normals...
-		for (u32 i=0; i<joint->Weights.size(); ++i)
+		for (u32 i=0; i<weightCount; ++i)
 		{
 			SWeight& weight = joint->Weights[i];
-
-			// Pull this vertex...
-			jointVertexPull.transformVect(thisVertexMove, weight.StaticPos);
-
-			if (AnimateNormals)
-				jointVertexPull.rotateVect(thisNormalMove, weight.StaticNormal);
+			const core::vector3df& thisVertexMove = SkinnedPositions[i];
 
 			if (! (*(weight.Moved)) )
 			{
@@ -591,7 +599,7 @@ void CSkinnedMesh::skinJoint(SJoint *joint, SJoint *parentJoint)
 				buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Pos = thisVertexMove * weight.strength;
 
 				if (AnimateNormals)
-					buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Normal = thisNormalMove * weight.strength;
+					buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Normal = SkinnedNormals[i] * weight.strength;
 
 				//*(weight._Pos) = thisVertexMove * weight.strength;
 			}
@@ -600,7 +608,7 @@ void CSkinnedMesh::skinJoint(SJoint *joint, SJoint *parentJoint)
 				buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Pos += thisVertexMove * weight.strength;
 
 				if (AnimateNormals)
-					buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Normal += thisNormalMove * weight.strength;
+					buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Normal += SkinnedNormals[i] * weight.strength;
 
 				//*(weight._Pos) += thisVertexMove * weight.strength;
 			}
@@ -192,6 +192,10 @@ private:
 
 		core::array< core::array<bool> > Vertices_Moved;
 
+		//! Weight positions and normals of the joint which is skinned, transformed as one batch
+		core::array<core::vector3df> SkinnedPositions;
+		core::array<core::vector3df> SkinnedNormals;
+
 		core::aabbox3d<f32> BoundingBox;
 
 		f32 EndFrame;
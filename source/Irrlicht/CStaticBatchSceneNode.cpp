@@ -0,0 +1,433 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CStaticBatchSceneNode.h"
+#include "ISceneManager.h"
+#include "IMeshSceneNode.h"
+#include "ICameraSceneNode.h"
+#include "IVideoDriver.h"
+#include "IMaterialRenderer.h"
+#include "CMeshBuffer.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+
+// merged buffers use 16 bit indices
+const u32 MaxBatchVertices = 65535;
+
+inline void transformVertex(video::S3DVertex& v, const core::matrix4& m)
+{
+	m.transformVect(v.Pos);
+	m.rotateVect(v.Normal);
+	v.Normal.normalize();
+}
+
+inline void transformVertex(video::S3DVertex2TCoords& v, const core::matrix4& m)
+{
+	transformVertex((video::S3DVertex&)v, m);
+}
+
+inline void transformVertex(video::S3DVertexTangents& v, const core::matrix4& m)
+{
+	transformVertex((video::S3DVertex&)v, m);
+	m.rotateVect(v.Tangent);
+	v.Tangent.normalize();
+	m.rotateVect(v.Binormal);
+	v.Binormal.normalize();
+}
+
+template <class T>
+void appendTransformed(IMeshBuffer* batch, const IMeshBuffer* mb, const core::matrix4& m)
+{
+	CMeshBuffer<T>* dst = static_cast<CMeshBuffer<T>*>(batch);
+
+	const u32 base = dst->Vertices.size();
+	const T* v = (const T*)mb->getVertices();
+	const u32 vcount = mb->getVertexCount();
+	dst->Vertices.reallocate(base + vcount);
+	for (u32 i=0; i<vcount; ++i)
+	{
+		T vertex(v[i]);
+		transformVertex(vertex, m);
+		dst->Vertices.push_back(vertex);
+		if (base == 0 && i == 0)
+			dst->BoundingBox.reset(vertex.Pos);
+		else
+			dst->BoundingBox.addInternalPoint(vertex.Pos);
+	}
+
+	const u16* indices = mb->getIndices();
+	const u32 icount = mb->getIndexCount();
+	dst->Indices.reallocate(dst->Indices.size() + icount);
+	for (u32 i=0; i<icount; ++i)
+		dst->Indices.push_back((u16)(indices[i] + base));
+}
+
+} // end anonymous namespace
+
+
+//! constructor
+CStaticBatchSceneNode::CStaticBatchSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id, f32 cellSize)
+: IStaticBatchSceneNode(parent, mgr, id), CellSize(cellSize > 0.f ? cellSize : 1.f), DrawnBatches(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CStaticBatchSceneNode");
+	#endif
+
+	// the batches are made from other nodes, so they are not saved
+	setIsDebugObject(true);
+	setAutomaticCulling(scene::EAC_OFF);
+}
+
+
+//! destructor
+CStaticBatchSceneNode::~CStaticBatchSceneNode()
+{
+	while (Sources.size())
+		releaseSource(Sources.size()-1, true);
+	clearBatches();
+}
+
+
+//! Collects the nodes which can be batched below root.
+void CStaticBatchSceneNode::addSourceNodes(ISceneNode* root)
+{
+	if (!root || root == this)
+		return;
+
+	if (canBatch(root))
+	{
+		SSource source;
+		source.Node = static_cast<IMeshSceneNode*>(root);
+		source.Node->updateAbsolutePosition();
+		source.Transform = source.Node->getAbsoluteTransformation();
+		source.Node->grab();
+		Sources.push_back(source);
+		return;
+	}
+
+	const ISceneNodeList& children = root->getChildren();
+	ISceneNodeList::ConstIterator it = children.begin();
+	for (; it != children.end(); ++it)
+		addSourceNodes(*it);
+}
+
+
+//! checks if a node can be batched
+bool CStaticBatchSceneNode::canBatch(ISceneNode* node) const
+{
+	const ESCENE_NODE_TYPE type = node->getType();
+	if (type != ESNT_MESH && type != ESNT_OCTREE && type != ESNT_CUBE && type != ESNT_SPHERE)
+		return false;
+
+	if (!node->isTrulyVisible() || !node->getChildren().empty() || !node->getAnimators().empty())
+		return false;
+
+	const IMesh* mesh = static_cast<IMeshSceneNode*>(node)->getMesh();
+	if (!mesh || !mesh->getMeshBufferCount())
+		return false;
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		if (mb->getIndexType() != video::EIT_16BIT || mb->getVertexCount() > MaxBatchVertices)
+			return false;
+
+		// transparent buffers have to be sorted by distance
+		const video::SMaterial& material = node->getMaterial(i);
+		const video::IMaterialRenderer* rnd = driver ? driver->getMaterialRenderer(material.MaterialType) : 0;
+		if ((rnd && rnd->isTransparent()) || material.isTransparent())
+			return false;
+	}
+
+	return true;
+}
+
+
+//! returns the grid cell of a mesh buffer of a source
+core::vector3di CStaticBatchSceneNode::getCell(const SSource& source, const IMeshBuffer* mb) const
+{
+	core::aabbox3df box(mb->getBoundingBox());
+	source.Transform.transformBoxEx(box);
+	const core::vector3df center = box.getCenter() / CellSize;
+	return core::vector3di(core::floor32(center.X), core::floor32(center.Y), core::floor32(center.Z));
+}
+
+
+//! adds the buffers of a source to the batches
+void CStaticBatchSceneNode::addToBatches(const SSource& source, const core::array<core::vector3di>* cells)
+{
+	const IMesh* mesh = source.Node->getMesh();
+	if (!mesh)
+		return;
+
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		if (!mb->getVertexCount() || !mb->getIndexCount())
+			continue;
+
+		const core::vector3di cell = getCell(source, mb);
+		if (cells && cells->linear_search(cell) == -1)
+			continue;
+
+		const video::SMaterial& material = source.Node->getMaterial(i);
+		const video::E_VERTEX_TYPE vertexType = mb->getVertexType();
+
+		// find a batch of the cell with the same material and room left
+		SBatch* batch = 0;
+		for (u32 b=Batches.size(); b>0; --b)
+		{
+			SBatch& candidate = Batches[b-1];
+			if (candidate.Cell == cell &&
+				candidate.Buffer->getVertexType() == vertexType &&
+				candidate.Buffer->getVertexCount() + mb->getVertexCount() <= MaxBatchVertices &&
+				candidate.Material == material)
+			{
+				batch = &candidate;
+				break;
+			}
+		}
+
+		if (!batch)
+		{
+			IMeshBuffer* buffer = 0;
+			switch (vertexType)
+			{
+			case video::EVT_STANDARD:
+				buffer = new SMeshBuffer();
+				break;
+			case video::EVT_2TCOORDS:
+				buffer = new SMeshBufferLightMap();
+				break;
+			case video::EVT_TANGENTS:
+				buffer = new SMeshBufferTangents();
+				break;
+			default:
+				break;
+			}
+			if (!buffer)
+				continue;
+
+			buffer->getMaterial() = material;
+			buffer->setHardwareMappingHint(EHM_STATIC);
+
+			SBatch newBatch;
+			newBatch.Cell = cell;
+			newBatch.Material = material;
+			newBatch.Buffer = buffer;
+			Batches.push_back(newBatch);
+			batch = &Batches.getLast();
+		}
+
+		switch (vertexType)
+		{
+		case video::EVT_STANDARD:
+			appendTransformed<video::S3DVertex>(batch->Buffer, mb, source.Transform);
+			break;
+		case video::EVT_2TCOORDS:
+			appendTransformed<video::S3DVertex2TCoords>(batch->Buffer, mb, source.Transform);
+			break;
+		case video::EVT_TANGENTS:
+			appendTransformed<video::S3DVertexTangents>(batch->Buffer, mb, source.Transform);
+			break;
+		default:
+			break;
+		}
+
+		batch->Buffer->setDirty();
+	}
+}
+
+
+//! Rebuilds all batches from the current state of the source nodes.
+void CStaticBatchSceneNode::rebuild()
+{
+	clearBatches();
+
+	for (u32 i=0; i<Sources.size(); ++i)
+	{
+		Sources[i].Node->updateAbsolutePosition();
+		Sources[i].Transform = Sources[i].Node->getAbsoluteTransformation();
+		Sources[i].Node->setVisible(false);
+		addToBatches(Sources[i], 0);
+	}
+
+	updateBoundingBox();
+}
+
+
+//! rebuilds the batches of some cells
+void CStaticBatchSceneNode::rebuildCells(const core::array<core::vector3di>& cells)
+{
+	for (u32 b=0; b<Batches.size(); )
+	{
+		if (cells.linear_search(Batches[b].Cell) != -1)
+		{
+			Batches[b].Buffer->drop();
+			Batches.erase(b);
+		}
+		else
+			++b;
+	}
+
+	for (u32 i=0; i<Sources.size(); ++i)
+		addToBatches(Sources[i], &cells);
+
+	updateBoundingBox();
+}
+
+
+//! adds the cells of a source to the list, if not yet in it
+void CStaticBatchSceneNode::collectCells(const SSource& source, core::array<core::vector3di>& cells) const
+{
+	const IMesh* mesh = source.Node->getMesh();
+	if (!mesh)
+		return;
+
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		const core::vector3di cell = getCell(source, mesh->getMeshBuffer(i));
+		if (cells.linear_search(cell) == -1)
+			cells.push_back(cell);
+	}
+}
+
+
+//! releases a source and makes the node visible again
+void CStaticBatchSceneNode::releaseSource(u32 index, bool makeVisible)
+{
+	if (makeVisible)
+		Sources[index].Node->setVisible(true);
+	Sources[index].Node->drop();
+	Sources.erase(index);
+}
+
+
+//! Takes a node out of the batches and makes it visible again.
+bool CStaticBatchSceneNode::removeSourceNode(ISceneNode* node)
+{
+	for (u32 i=0; i<Sources.size(); ++i)
+	{
+		if (Sources[i].Node == node)
+		{
+			core::array<core::vector3di> cells;
+			collectCells(Sources[i], cells);
+			releaseSource(i, true);
+			rebuildCells(cells);
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//! Checks if source nodes moved
+void CStaticBatchSceneNode::OnAnimate(u32 timeMs)
+{
+	core::array<core::vector3di> cells;
+
+	for (u32 i=0; i<Sources.size(); )
+	{
+		IMeshSceneNode* node = Sources[i].Node;
+
+		// nodes removed from the scene are dropped, moved nodes are
+		// drawn on their own again
+		bool release = !node->getParent();
+		if (!release)
+		{
+			node->updateAbsolutePosition();
+			release = node->getAbsoluteTransformation() != Sources[i].Transform;
+		}
+
+		if (release)
+		{
+			collectCells(Sources[i], cells);
+			releaseSource(i, node->getParent() != 0);
+		}
+		else
+			++i;
+	}
+
+	if (cells.size())
+		rebuildCells(cells);
+
+	ISceneNode::OnAnimate(timeMs);
+}
+
+
+//! pre render event
+void CStaticBatchSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Batches.size())
+		SceneManager->registerNodeForRendering(this, ESNRP_SOLID);
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! renders the node.
+void CStaticBatchSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	DrawnBatches = 0;
+
+	if (!driver || !camera)
+		return;
+
+	// the batches are in world space
+	driver->setTransform(video::ETS_WORLD, core::IdentityMatrix);
+
+	const SViewFrustum* frustum = camera->getViewFrustum();
+
+	for (u32 i=0; i<Batches.size(); ++i)
+	{
+		const core::aabbox3df& box = Batches[i].Buffer->getBoundingBox();
+
+		bool visible = true;
+		for (u32 p=0; p<SViewFrustum::VF_PLANE_COUNT && visible; ++p)
+			visible = box.classifyPlaneRelation(frustum->planes[p]) != core::ISREL3D_FRONT;
+		if (!visible)
+			continue;
+
+		driver->setMaterial(Batches[i].Material);
+		driver->drawMeshBuffer(Batches[i].Buffer);
+		++DrawnBatches;
+	}
+}
+
+
+void CStaticBatchSceneNode::clearBatches()
+{
+	for (u32 i=0; i<Batches.size(); ++i)
+		Batches[i].Buffer->drop();
+	Batches.clear();
+	Box.reset(0,0,0);
+}
+
+
+void CStaticBatchSceneNode::updateBoundingBox()
+{
+	if (Batches.empty())
+	{
+		Box.reset(0,0,0);
+		return;
+	}
+
+	Box = Batches[0].Buffer->getBoundingBox();
+	for (u32 i=1; i<Batches.size(); ++i)
+		Box.addInternalBox(Batches[i].Buffer->getBoundingBox());
+}
+
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,110 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_STATIC_BATCH_SCENE_NODE_H_INCLUDED__
+#define __C_STATIC_BATCH_SCENE_NODE_H_INCLUDED__
+
+#include "IStaticBatchSceneNode.h"
+#include "SMaterial.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+	class IMeshSceneNode;
+	class IMeshBuffer;
+
+	//! Scene node which draws the merged meshes of static scene nodes.
+	class CStaticBatchSceneNode : public IStaticBatchSceneNode
+	{
+	public:
+
+		//! constructor
+		CStaticBatchSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id, f32 cellSize);
+
+		//! destructor
+		virtual ~CStaticBatchSceneNode();
+
+		//! Collects the nodes which can be batched below root.
+		void addSourceNodes(ISceneNode* root);
+
+		//! Rebuilds all batches from the current state of the source nodes.
+		virtual void rebuild() _IRR_OVERRIDE_;
+
+		//! Takes a node out of the batches and makes it visible again.
+		virtual bool removeSourceNode(ISceneNode* node) _IRR_OVERRIDE_;
+
+		//! Returns the number of batched scene nodes.
+		virtual u32 getSourceNodeCount() const _IRR_OVERRIDE_ { return Sources.size(); }
+
+		//! Returns the number of merged mesh buffers.
+		virtual u32 getBatchCount() const _IRR_OVERRIDE_ { return Batches.size(); }
+
+		//! Returns how many merged mesh buffers were drawn in the last frame.
+		virtual u32 getDrawnBatchCount() const _IRR_OVERRIDE_ { return DrawnBatches; }
+
+		//! Checks if source nodes moved
+		virtual void OnAnimate(u32 timeMs) _IRR_OVERRIDE_;
+
+		//! pre render event
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
+		//! renders the node.
+		virtual void render() _IRR_OVERRIDE_;
+
+		//! returns the axis aligned bounding box of this node
+		virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_ { return Box; }
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_STATIC_BATCH; }
+
+	private:
+
+		struct SSource
+		{
+			IMeshSceneNode* Node;
+			// transformation the node was batched with
+			core::matrix4 Transform;
+		};
+
+		struct SBatch
+		{
+			core::vector3di Cell;
+			video::SMaterial Material;
+			IMeshBuffer* Buffer;
+		};
+
+		//! checks if a node can be batched
+		bool canBatch(ISceneNode* node) const;
+
+		//! returns the grid cell of a mesh buffer of a source
+		core::vector3di getCell(const SSource& source, const IMeshBuffer* mb) const;
+
+		//! adds the buffers of a source to the batches, only those in the given cells if cells is not 0
+		void addToBatches(const SSource& source, const core::array<core::vector3di>* cells);
+
+		//! rebuilds the batches of some cells
+		void rebuildCells(const core::array<core::vector3di>& cells);
+
+		//! adds the cells of a source to the list, if not yet in it
+		void collectCells(const SSource& source, core::array<core::vector3di>& cells) const;
+
+		//! releases a source and makes the node visible again
+		void releaseSource(u32 index, bool makeVisible);
+
+		void clearBatches();
+		void updateBoundingBox();
+
+		core::array<SSource> Sources;
+		core::array<SBatch> Batches;
+		core::aabbox3d<f32> Box;
+		f32 CellSize;
+		u32 DrawnBatches;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
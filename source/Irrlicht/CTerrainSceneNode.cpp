@@ -40,6 +40,7 @@ namespace scene
 			const core::vector3df& scale)
 	: ITerrainSceneNode(parent, mgr, id, position, rotation, scale),
 	TerrainData(patchSize, maxLOD, position, rotation, scale), RenderBuffer(0),
+	PendingIndexBuffer(0), PendingPatch(-1), PatchesPerFrame(0),
 	VerticesToRender(0), IndicesToRender(0), DynamicSelectorUpdate(false),
 	OverrideDistanceThreshold(false), UseDefaultRotationPivot(true), ForceRecalculation(true),
 	FixedBorderLOD(-1),
@@ -75,6 +76,9 @@ namespace scene
 
 		if (RenderBuffer)
 			RenderBuffer->drop();
+
+		if (PendingIndexBuffer)
+			PendingIndexBuffer->drop();
 	}
 
 
@@ -595,6 +599,13 @@ namespace scene
 		cameraUp.normalize();
 		const f32 CameraFOV = SceneManager->getActiveCamera()->getFOV();
 
+		// finish a running incremental update before starting the next one
+		if (PendingPatch >= 0 && !ForceRecalculation)
+		{
+			continueIndicesCalculations();
+			return;
+		}
+
 		// Only check on the Camera's Y Rotation
 		if (!ForceRecalculation)
 		{
@@ -634,20 +645,26 @@ namespace scene
 
 		const core::vector3df cameraPosition = camera->getAbsolutePosition();
 
-		const SViewFrustum* frustum = camera->getViewFrustum();
+		const core::aabbox3df& frustumBox = camera->getViewFrustum()->getBoundingBox();
 
 		// Determine each patches LOD based on distance from camera (and whether or not they are in
-		// the view frustum).
+		// the view frustum). They are used once the new indices are generated.
 		const s32 count = TerrainData.PatchCount * TerrainData.PatchCount;
+		PendingLODs.set_used(count);
+		s32* lods = PendingLODs.pointer();
+
+#ifdef _OPENMP
+		#pragma omp parallel for if(count >= 256)
+#endif
 		for (s32 j = 0; j < count; ++j)
 		{
-			if (frustum->getBoundingBox().intersectsWithBox(TerrainData.Patches[j].BoundingBox))
+			if (frustumBox.intersectsWithBox(TerrainData.Patches[j].BoundingBox))
 			{
 				const f32 distance = cameraPosition.getDistanceFromSQ(TerrainData.Patches[j].Center);
 
 				if ( FixedBorderLOD >= 0 )
 				{
-					TerrainData.Patches[j].CurrentLOD = FixedBorderLOD;
+					lods[j] = core::min_(FixedBorderLOD, TerrainData.MaxLOD - 1);
 					if (j < TerrainData.PatchCount 
 						|| j >= (count - TerrainData.PatchCount) 
 						|| (j % TerrainData.PatchCount) == 0 
@@ -655,20 +672,20 @@ namespace scene
 						continue;
 				}
 
-				TerrainData.Patches[j].CurrentLOD = 0;
+				lods[j] = 0;
 
 				for (s32 i = TerrainData.MaxLOD - 1; i>0; --i)
 				{
 					if (distance >= TerrainData.LODDistanceThreshold[i])
 					{
-						TerrainData.Patches[j].CurrentLOD = i;
+						lods[j] = i;
 						break;
 					}
 				}
 			}
 			else
 			{
-				TerrainData.Patches[j].CurrentLOD = -1;
+				lods[j] = -1;
 			}
 		}
 	}
@@ -676,54 +693,73 @@ namespace scene
 
 	void CTerrainSceneNode::preRenderIndicesCalculations()
 	{
-		scene::IIndexBuffer& indexBuffer = RenderBuffer->getIndexBuffer();
-		IndicesToRender = 0;
-		indexBuffer.set_used(0);
+		// Each patch gets its range of the index buffer, so they can be generated independently.
+		const s32 count = TerrainData.PatchCount * TerrainData.PatchCount;
+		PendingOffsets.set_used(count + 1);
 
-		s32 index = 0;
-		// Then generate the indices for all patches that are visible.
-		for (s32 i = 0; i < TerrainData.PatchCount; ++i)
+		u32 indexCount = 0;
+		for (s32 j = 0; j < count; ++j)
 		{
-			for (s32 j = 0; j < TerrainData.PatchCount; ++j)
-			{
-				if (TerrainData.Patches[index].CurrentLOD >= 0)
-				{
-					s32 x = 0;
-					s32 z = 0;
+			PendingOffsets[j] = indexCount;
+			if (PendingLODs[j] >= 0)
+				indexCount += IndexTemplates[PendingLODs[j]].size();
+		}
+		PendingOffsets[count] = indexCount;
 
-					// calculate the step we take this patch, based on the patches current LOD
-					const s32 step = 1 << TerrainData.Patches[index].CurrentLOD;
+		if (PatchesPerFrame == 0)
+		{
+			scene::IIndexBuffer& indexBuffer = RenderBuffer->getIndexBuffer();
+			indexBuffer.set_used(indexCount);
+			generatePendingIndices(indexBuffer, 0, count);
+			applyPendingIndices();
+			return;
+		}
 
-					// Loop through patch and generate indices
-					while (z < TerrainData.CalcPatchSize)
-					{
-						const s32 index11 = getIndex(j, i, index, x, z);
-						const s32 index21 = getIndex(j, i, index, x + step, z);
-						const s32 index12 = getIndex(j, i, index, x, z + step);
-						const s32 index22 = getIndex(j, i, index, x + step, z + step);
-
-						indexBuffer.push_back(index12);
-						indexBuffer.push_back(index11);
-						indexBuffer.push_back(index22);
-						indexBuffer.push_back(index22);
-						indexBuffer.push_back(index11);
-						indexBuffer.push_back(index21);
-						IndicesToRender+=6;
-
-						// increment index position horizontally
-						x += step;
-
-						// we've hit an edge
-						if (x >= TerrainData.CalcPatchSize)
-						{
-							x = 0;
-							z += step;
-						}
-					}
-				}
-				++index;
-			}
+		// generate into a second buffer while the current indices are still rendered
+		if (!PendingIndexBuffer)
+			PendingIndexBuffer = new CIndexBuffer(RenderBuffer->getIndexBuffer().getType());
+		else if (PendingIndexBuffer->getType() != RenderBuffer->getIndexBuffer().getType())
+		{
+			PendingIndexBuffer->set_used(0);
+			PendingIndexBuffer->setType(RenderBuffer->getIndexBuffer().getType());
 		}
+		PendingIndexBuffer->set_used(indexCount);
+
+		PendingPatch = 0;
+		continueIndicesCalculations();
+	}
+
+
+	void CTerrainSceneNode::continueIndicesCalculations()
+	{
+		const s32 count = TerrainData.PatchCount * TerrainData.PatchCount;
+		const s32 end = core::min_(PendingPatch + (s32)PatchesPerFrame, count);
+
+		generatePendingIndices(*PendingIndexBuffer, PendingPatch, end);
+		PendingPatch = end;
+
+		if (PendingPatch < count)
+			return;
+
+		PendingPatch = -1;
+
+		scene::IIndexBuffer& indexBuffer = RenderBuffer->getIndexBuffer();
+		const u32 indexCount = PendingOffsets[count];
+		indexBuffer.set_used(indexCount);
+		if (indexCount)
+			memcpy(indexBuffer.pointer(), PendingIndexBuffer->pointer(), indexCount * indexBuffer.stride());
+
+		applyPendingIndices();
+	}
+
+
+	void CTerrainSceneNode::applyPendingIndices()
+	{
+		const s32 count = TerrainData.PatchCount * TerrainData.PatchCount;
+		for (s32 j = 0; j < count; ++j)
+			TerrainData.Patches[j].CurrentLOD = PendingLODs[j];
+
+		IndicesToRender = PendingOffsets[count];
 
 		RenderBuffer->setDirty(EBT_INDEX);
 
@@ -735,6 +771,110 @@ namespace scene
 	}
 
 
+	void CTerrainSceneNode::generatePendingIndices(IIndexBuffer& indexBuffer, s32 begin, s32 end) const
+	{
+		if (indexBuffer.getType() == video::EIT_32BIT)
+			generatePendingIndices(static_cast<u32*>(indexBuffer.pointer()), begin, end);
+		else
+			generatePendingIndices(static_cast<u16*>(indexBuffer.pointer()), begin, end);
+	}
+
+
+	template <class T>
+	void CTerrainSceneNode::generatePendingIndices(T* indices, s32 begin, s32 end) const
+	{
+		const s32* lods = PendingLODs.const_pointer();
+
+#ifdef _OPENMP
+		#pragma omp parallel for schedule(dynamic) if(end - begin >= 16)
+#endif
+		for (s32 index = begin; index < end; ++index)
+		{
+			const s32 lod = lods[index];
+			if (lod < 0)
+				continue;
+
+			const SPatch& patch = TerrainData.Patches[index];
+			const s32 patchX = index % TerrainData.PatchCount;
+			const s32 patchZ = index / TerrainData.PatchCount;
+			T* out = indices + PendingOffsets[index];
+
+			// borders only need stitching next to patches with a lower resolution
+			const bool stitch =
+				(patch.Top && lods[patch.Top - TerrainData.Patches] > lod) ||
+				(patch.Bottom && lods[patch.Bottom - TerrainData.Patches] > lod) ||
+				(patch.Left && lods[patch.Left - TerrainData.Patches] > lod) ||
+				(patch.Right && lods[patch.Right - TerrainData.Patches] > lod);
+
+			if (!stitch)
+			{
+				const u32 first = (patchZ * TerrainData.Size + patchX) * TerrainData.CalcPatchSize;
+				const core::array<u32>& indexTemplate = IndexTemplates[lod];
+				for (u32 i = 0; i < indexTemplate.size(); ++i)
+					out[i] = (T)(first + indexTemplate[i]);
+				continue;
+			}
+
+			// calculate the step we take this patch, based on the patches current LOD
+			const s32 step = 1 << lod;
+
+			for (s32 z = 0; z < TerrainData.CalcPatchSize; z += step)
+			{
+				for (s32 x = 0; x < TerrainData.CalcPatchSize; x += step)
+				{
+					const u32 index11 = getIndex(patchX, patchZ, index, x, z, lods);
+					const u32 index21 = getIndex(patchX, patchZ, index, x + step, z, lods);
+					const u32 index12 = getIndex(patchX, patchZ, index, x, z + step, lods);
+					const u32 index22 = getIndex(patchX, patchZ, index, x + step, z + step, lods);
+
+					*out++ = (T)index12;
+					*out++ = (T)index11;
+					*out++ = (T)index22;
+					*out++ = (T)index22;
+					*out++ = (T)index11;
+					*out++ = (T)index21;
+				}
+			}
+		}
+	}
+
+
+	//! create the index templates of unstitched patches for all LODs
+	void CTerrainSceneNode::createIndexTemplates()
+	{
+		IndexTemplates.set_used(0);
+		IndexTemplates.reallocate(TerrainData.MaxLOD);
+
+		for (s32 lod = 0; lod < TerrainData.MaxLOD; ++lod)
+		{
+			IndexTemplates.push_back(core::array<u32>());
+			core::array<u32>& indexTemplate = IndexTemplates.getLast();
+
+			const s32 step = 1 << lod;
+			const s32 quads = TerrainData.CalcPatchSize / step;
+			indexTemplate.reallocate(quads * quads * 6);
+
+			for (s32 z = 0; z < TerrainData.CalcPatchSize; z += step)
+			{
+				for (s32 x = 0; x < TerrainData.CalcPatchSize; x += step)
+				{
+					const u32 index11 = z * TerrainData.Size + x;
+					const u32 index21 = index11 + step;
+					const u32 index12 = index11 + step * TerrainData.Size;
+					const u32 index22 = index12 + step;
+
+					indexTemplate.push_back(index12);
+					indexTemplate.push_back(index11);
+					indexTemplate.push_back(index22);
+					indexTemplate.push_back(index22);
+					indexTemplate.push_back(index11);
+					indexTemplate.push_back(index21);
+				}
+			}
+		}
+	}
+
+
 	//! Render the scene node
 	void CTerrainSceneNode::render()
 	{
@@ -1045,47 +1185,46 @@ namespace scene
 
 	//! used to get the indices when generating index data for patches at varying levels of detail.
 	u32 CTerrainSceneNode::getIndex(const s32 PatchX, const s32 PatchZ,
-					const s32 PatchIndex, u32 vX, u32 vZ) const
+					const s32 PatchIndex, u32 vX, u32 vZ, const s32* lods) const
 	{
+		const SPatch& patch = TerrainData.Patches[PatchIndex];
+		const s32 lod = lods ? lods[PatchIndex] : patch.CurrentLOD;
+
 		// top border
 		if (vZ == 0)
 		{
-			if (TerrainData.Patches[PatchIndex].Top &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Top->CurrentLOD &&
-				(vX % (1 << TerrainData.Patches[PatchIndex].Top->CurrentLOD)) != 0 )
+			const s32 topLOD = patch.Top ? (lods ? lods[patch.Top - TerrainData.Patches] : patch.Top->CurrentLOD) : -1;
+			if (patch.Top && lod < topLOD && (vX % (1 << topLOD)) != 0 )
 			{
-				vX -= vX % (1 << TerrainData.Patches[PatchIndex].Top->CurrentLOD);
+				vX -= vX % (1 << topLOD);
 			}
 		}
 		else
 		if (vZ == (u32)TerrainData.CalcPatchSize) // bottom border
 		{
-			if (TerrainData.Patches[PatchIndex].Bottom &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Bottom->CurrentLOD &&
-				(vX % (1 << TerrainData.Patches[PatchIndex].Bottom->CurrentLOD)) != 0)
+			const s32 bottomLOD = patch.Bottom ? (lods ? lods[patch.Bottom - TerrainData.Patches] : patch.Bottom->CurrentLOD) : -1;
+			if (patch.Bottom && lod < bottomLOD && (vX % (1 << bottomLOD)) != 0)
 			{
-				vX -= vX % (1 << TerrainData.Patches[PatchIndex].Bottom->CurrentLOD);
+				vX -= vX % (1 << bottomLOD);
 			}
 		}
 
 		// left border
 		if (vX == 0)
 		{
-			if (TerrainData.Patches[PatchIndex].Left &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Left->CurrentLOD &&
-				(vZ % (1 << TerrainData.Patches[PatchIndex].Left->CurrentLOD)) != 0)
+			const s32 leftLOD = patch.Left ? (lods ? lods[patch.Left - TerrainData.Patches] : patch.Left->CurrentLOD) : -1;
+			if (patch.Left && lod < leftLOD && (vZ % (1 << leftLOD)) != 0)
 			{
-				vZ -= vZ % (1 << TerrainData.Patches[PatchIndex].Left->CurrentLOD);
+				vZ -= vZ % (1 << leftLOD);
 			}
 		}
 		else
 		if (vX == (u32)TerrainData.CalcPatchSize) // right border
 		{
-			if (TerrainData.Patches[PatchIndex].Right &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Right->CurrentLOD &&
-				(vZ % (1 << TerrainData.Patches[PatchIndex].Right->CurrentLOD)) != 0)
+			const s32 rightLOD = patch.Right ? (lods ? lods[patch.Right - TerrainData.Patches] : patch.Right->CurrentLOD) : -1;
+			if (patch.Right && lod < rightLOD && (vZ % (1 << rightLOD)) != 0)
 			{
-				vZ -= vZ % (1 << TerrainData.Patches[PatchIndex].Right->CurrentLOD);
+				vZ -= vZ % (1 << rightLOD);
 			}
 		}
 
@@ -1255,6 +1394,11 @@ namespace scene
 			delete [] TerrainData.Patches;
 
 		TerrainData.Patches = new SPatch[TerrainData.PatchCount * TerrainData.PatchCount];
+
+		// a running incremental update belongs to the old patches
+		PendingPatch = -1;
+
+		createIndexTemplates();
 	}
 
 
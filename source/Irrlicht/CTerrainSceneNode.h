@@ -208,6 +208,12 @@ namespace scene
 			FixedBorderLOD = borderLOD;
 		}
 
+		//! Spread index updates over several frames.
+		virtual void setIncrementalIndexUpdate(u32 patchesPerFrame=0) _IRR_OVERRIDE_
+		{
+			PatchesPerFrame = patchesPerFrame;
+		}
+
 		//! Returns type of the scene node
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ {return ESNT_TERRAIN;}
 
@@ -270,8 +276,25 @@ namespace scene
 		void preRenderLODCalculations();
 		void preRenderIndicesCalculations();
 
+		//! generate the pending indices for some more patches, swaps buffers when done
+		void continueIndicesCalculations();
+
+		//! makes the pending indices and LODs the current ones
+		void applyPendingIndices();
+
+		//! generate the pending indices for the patches [begin, end)
+		void generatePendingIndices(IIndexBuffer& indexBuffer, s32 begin, s32 end) const;
+
+		template <class T>
+		void generatePendingIndices(T* indices, s32 begin, s32 end) const;
+
+		//! create the index templates of unstitched patches for all LODs
+		void createIndexTemplates();
+
 		//! get indices when generating index data for patches at varying levels of detail.
-		u32 getIndex(const s32 PatchX, const s32 PatchZ, const s32 PatchIndex, u32 vX, u32 vZ) const;
+		/** \param lods LODs of all patches, uses the CurrentLOD of the patches when 0 */
+		u32 getIndex(const s32 PatchX, const s32 PatchZ, const s32 PatchIndex, u32 vX, u32 vZ,
+				const s32* lods=0) const;
 
 		//! smooth the terrain
 		void smoothTerrain(IDynamicMeshBuffer* mb, s32 smoothFactor);
@@ -302,6 +325,18 @@ namespace scene
 
 		IDynamicMeshBuffer *RenderBuffer;
 
+		//! indices of a patch for each LOD relative to its first vertex, if no border needs stitching
+		core::array<core::array<u32> > IndexTemplates;
+		//! LODs of the patches the pending indices are generated for
+		core::array<s32> PendingLODs;
+		//! offsets of the patches in the pending indices, the last one is the index count
+		core::array<u32> PendingOffsets;
+		//! second index buffer for incremental updates
+		IIndexBuffer* PendingIndexBuffer;
+		//! next patch of an incremental update, -1 when none is running
+		s32 PendingPatch;
+		u32 PatchesPerFrame;
+
 		u32 VerticesToRender;
 		u32 IndicesToRender;
 
@@ -225,6 +225,44 @@ s32 CTerrainTriangleSelector::getTriangleCount() const
 }
 
 
+//! Gets a box around all triangles of this selector.
+bool CTerrainTriangleSelector::getBoundingBox(core::aabbox3df& outBox, bool useNodeTransform) const
+{
+	if (!TrianglePatches.NumPatches)
+		return false;
+
+	// The terrain node moves its vertices instead of rendering with its
+	// transformation, so the patches are already transformed.
+	outBox = TrianglePatches.TrianglePatchArray[0].Box;
+	for (s32 i=1; i<TrianglePatches.NumPatches; ++i)
+		outBox.addInternalBox(TrianglePatches.TrianglePatchArray[i].Box);
+
+	if (!useNodeTransform && SceneNode)
+	{
+		// undo CTerrainSceneNode::applyTransformation
+		const CTerrainSceneNode* terrain = static_cast<const CTerrainSceneNode*>(SceneNode);
+		const core::vector3df& pivot = terrain->TerrainData.RotationPivot;
+		const core::vector3df& scale = terrain->TerrainData.Scale;
+
+		core::matrix4 toPivot;
+		toPivot.setTranslation(-pivot);
+		core::matrix4 rotation;
+		rotation.setRotationDegrees(terrain->TerrainData.Rotation);
+		core::matrix4 fromPivot;
+		fromPivot.setTranslation(pivot - terrain->TerrainData.Position);
+		core::matrix4 mat;
+		mat.setScale(core::vector3df(core::reciprocal(scale.X), core::reciprocal(scale.Y), core::reciprocal(scale.Z)));
+
+		mat *= fromPivot;
+		mat *= rotation;
+		mat *= toPivot;
+		mat.transformBoxEx(outBox);
+	}
+
+	return true;
+}
+
+
 ISceneNode* CTerrainTriangleSelector::getSceneNodeForTriangle(
 		u32 triangleIndex) const
 {
@@ -57,6 +57,9 @@ public:
 	//! Returns amount of all available triangles in this selector
 	virtual s32 getTriangleCount() const _IRR_OVERRIDE_;
 
+	//! Gets a box around all triangles of this selector.
+	virtual bool getBoundingBox(core::aabbox3df& outBox, bool useNodeTransform) const _IRR_OVERRIDE_;
+
 	//! Return the scene node associated with a given triangle.
 	virtual ISceneNode* getSceneNodeForTriangle(u32 triangleIndex) const _IRR_OVERRIDE_;
 
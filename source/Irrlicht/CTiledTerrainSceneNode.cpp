@@ -0,0 +1,390 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CTiledTerrainSceneNode.h"
+
+#ifdef _IRR_COMPILE_WITH_TERRAIN_SCENENODE_
+
+#include "ITerrainSceneNode.h"
+#include "ICameraSceneNode.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "IFileSystem.h"
+#include "IMesh.h"
+#include "S3DVertex.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CTiledTerrainSceneNode::CTiledTerrainSceneNode(const io::path& heightmapPattern, const io::path& texturePattern,
+		u32 tileCountX, u32 tileCountZ, s32 tileSize,
+		ISceneNode* parent, ISceneManager* mgr, s32 id,
+		const core::vector3df& position, const core::vector3df& scale,
+		s32 maxLOD, E_TERRAIN_PATCH_SIZE patchSize)
+	: ITiledTerrainSceneNode(parent, mgr, id, position, core::vector3df(0,0,0), scale),
+	HeightmapPattern(heightmapPattern), TexturePattern(texturePattern),
+	TileCountX(tileCountX), TileCountZ(tileCountZ), TileSize(tileSize),
+	MaxLOD(maxLOD), PatchSize(patchSize), LoadRadius(1), TilesPerFrame(1),
+	MemoryBudget(0), ResidentMemory(0), LastTextureMemory(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CTiledTerrainSceneNode");
+	#endif
+
+	MissingTiles.set_used(TileCountX * TileCountZ);
+	for (u32 i=0; i<MissingTiles.size(); ++i)
+		MissingTiles[i] = false;
+
+	setAutomaticCulling(scene::EAC_OFF);
+}
+
+
+//! destructor
+CTiledTerrainSceneNode::~CTiledTerrainSceneNode()
+{
+	removeAllTiles();
+}
+
+
+//! loads missing tiles and removes far away ones
+void CTiledTerrainSceneNode::OnRegisterSceneNode()
+{
+	if (!IsVisible)
+		return;
+
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (camera)
+		updateTiles(camera->getAbsolutePosition(), TilesPerFrame);
+
+	// all tiles use the material of this node, but keep their own texture
+	for (u32 i=0; i<Tiles.size(); ++i)
+	{
+		video::SMaterial& material = Tiles[i].Node->getMaterial(0);
+		material = Material;
+		if (Tiles[i].Texture)
+			material.setTexture(0, Tiles[i].Texture);
+	}
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! Removes a child from this scene node.
+bool CTiledTerrainSceneNode::removeChild(ISceneNode* child)
+{
+	for (u32 i=0; i<Tiles.size(); ++i)
+	{
+		if (Tiles[i].Node == child)
+		{
+			removeTile(i);
+			break;
+		}
+	}
+
+	return ITiledTerrainSceneNode::removeChild(child);
+}
+
+
+//! Removes all children of this scene node, including all tiles.
+void CTiledTerrainSceneNode::removeAll()
+{
+	removeAllTiles();
+	ITiledTerrainSceneNode::removeAll();
+}
+
+
+//! Returns the terrain node of a tile.
+ITerrainSceneNode* CTiledTerrainSceneNode::getTile(s32 x, s32 z) const
+{
+	for (u32 i=0; i<Tiles.size(); ++i)
+	{
+		if (Tiles[i].X == x && Tiles[i].Z == z)
+			return Tiles[i].Node;
+	}
+	return 0;
+}
+
+
+//! Get height of a point of the terrain.
+f32 CTiledTerrainSceneNode::getHeight(f32 x, f32 z) const
+{
+	s32 tileX, tileZ;
+	getTilePosition(core::vector3df(x, 0.f, z), tileX, tileZ);
+
+	const ITerrainSceneNode* tile = getTile(tileX, tileZ);
+	return tile ? tile->getHeight(x, z) : -FLT_MAX;
+}
+
+
+//! Loads the tiles around a position right away.
+void CTiledTerrainSceneNode::loadTilesAround(const core::vector3df& position)
+{
+	updateTiles(position, 0xffffffff);
+}
+
+
+//! loads and removes tiles for a camera position
+void CTiledTerrainSceneNode::updateTiles(const core::vector3df& position, u32 maxLoads)
+{
+	s32 centerX, centerZ;
+	getTilePosition(position, centerX, centerZ);
+
+	// Remove tiles which are too far away. Only tiles outside of radius+1
+	// are removed, so moving back and forth over a tile border doesn't
+	// load and remove the same tiles again and again.
+	const s32 keepRadius = (s32)LoadRadius + 1;
+	for (s32 i=(s32)Tiles.size()-1; i>=0; --i)
+	{
+		if (core::abs_(Tiles[i].X - centerX) > keepRadius ||
+			core::abs_(Tiles[i].Z - centerZ) > keepRadius)
+			removeChild(Tiles[i].Node);
+	}
+
+	// load missing tiles ring by ring, so closer ones come first
+	u32 loads = 0;
+	for (s32 ring=0; ring<=(s32)LoadRadius; ++ring)
+	{
+		for (s32 z=centerZ-ring; z<=centerZ+ring; ++z)
+		{
+			for (s32 x=centerX-ring; x<=centerX+ring; ++x)
+			{
+				if (core::abs_(x-centerX) != ring && core::abs_(z-centerZ) != ring)
+					continue;
+				if (x < 0 || z < 0 || x >= (s32)TileCountX || z >= (s32)TileCountZ)
+					continue;
+				if (MissingTiles[z*TileCountX + x] || getTile(x, z))
+					continue;
+
+				if (loads >= maxLoads)
+					return;
+				if (MemoryBudget && ResidentMemory + getTileGeometryMemory() + LastTextureMemory > MemoryBudget)
+					return;
+
+				if (!loadTile(x, z))
+					MissingTiles[z*TileCountX + x] = true;
+				++loads;
+			}
+		}
+	}
+}
+
+
+//! loads a tile, returns false if it doesn't exist or couldn't be loaded
+bool CTiledTerrainSceneNode::loadTile(s32 x, s32 z)
+{
+	io::IFileSystem* fileSystem = SceneManager->getFileSystem();
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	const io::path heightmap = getTileFileName(HeightmapPattern, x, z);
+	if (!fileSystem->existFile(heightmap))
+		return false;
+
+	// Tiles are children of this node, but the terrain node uses the
+	// position and scale it was created with as absolute values.
+	const core::vector3df scale = AbsoluteTransformation.getScale();
+	const core::vector3df offset((f32)((TileSize-1)*x), 0.f, (f32)((TileSize-1)*z));
+	const core::vector3df position = getAbsolutePosition() + offset * scale;
+
+	ITerrainSceneNode* node = SceneManager->addTerrainSceneNode(heightmap, this, -1,
+		position, core::vector3df(0,0,0), scale, video::SColor(255,255,255,255),
+		MaxLOD, PatchSize);
+	if (!node)
+		return false;
+
+	if (node->getMesh()->getMeshBufferCount() == 0 ||
+		node->getMesh()->getMeshBuffer(0)->getVertexCount() != (u32)(TileSize*TileSize))
+	{
+		os::Printer::log("Terrain tile has the wrong size", heightmap, ELL_WARNING);
+		ITiledTerrainSceneNode::removeChild(node);
+		return false;
+	}
+
+	// keep the relative transformation consistent with the terrain
+	node->ISceneNode::setPosition(offset);
+	node->ISceneNode::setScale(core::vector3df(1.f, 1.f, 1.f));
+	node->updateAbsolutePosition();
+
+	// neighbouring tiles don't know each other, full detail at the borders avoids cracks
+	node->setFixedBorderLOD(0);
+	// tiles are recreated from the patterns, so they are not written to scene files
+	node->setIsDebugObject(true);
+
+	STile tile;
+	tile.X = x;
+	tile.Z = z;
+	tile.Node = node;
+	tile.Texture = 0;
+	tile.Memory = getTileGeometryMemory();
+
+	if (!TexturePattern.empty())
+	{
+		const io::path textureName = getTileFileName(TexturePattern, x, z);
+		const u32 textureCount = driver->getTextureCount();
+		if (fileSystem->existFile(textureName))
+			tile.Texture = driver->getTexture(textureName);
+		if (tile.Texture)
+		{
+			// the texture can be shared with other tiles or nodes
+			tile.Texture->grab();
+			if (driver->getTextureCount() > textureCount)
+				LoadedTextures.push_back(tile.Texture);
+			LastTextureMemory = tile.Texture->getPitch() * tile.Texture->getSize().Height;
+			tile.Memory += LastTextureMemory;
+		}
+	}
+
+	Tiles.push_back(tile);
+	ResidentMemory += tile.Memory;
+	recalculateBoundingBox();
+
+	return true;
+}
+
+
+//! removes a loaded tile
+void CTiledTerrainSceneNode::removeTile(u32 index)
+{
+	video::ITexture* texture = Tiles[index].Texture;
+	if (texture)
+	{
+		Tiles[index].Node->getMaterial(0).setTexture(0, 0);
+
+		bool lastTile = true;
+		for (u32 i=0; i<Tiles.size() && lastTile; ++i)
+			lastTile = (i == index || Tiles[i].Texture != texture);
+
+		// Textures loaded for the tiles are freed with their last tile,
+		// unless they are used by something else than the driver cache.
+		const s32 loaded = LoadedTextures.linear_search(texture);
+		if (loaded >= 0 && lastTile)
+		{
+			LoadedTextures.erase(loaded);
+			if (texture->getReferenceCount() == 2)
+				SceneManager->getVideoDriver()->removeTexture(texture);
+		}
+		texture->drop();
+	}
+	ResidentMemory -= Tiles[index].Memory;
+	Tiles.erase(index);
+	recalculateBoundingBox();
+}
+
+
+//! removes all tiles and forgets which ones failed to load
+void CTiledTerrainSceneNode::removeAllTiles()
+{
+	while (!Tiles.empty())
+		removeChild(Tiles.getLast().Node);
+
+	for (u32 i=0; i<MissingTiles.size(); ++i)
+		MissingTiles[i] = false;
+}
+
+
+//! returns the tile a position is in, can be outside the grid
+void CTiledTerrainSceneNode::getTilePosition(const core::vector3df& position, s32& x, s32& z) const
+{
+	const core::vector3df scale = AbsoluteTransformation.getScale();
+	const core::vector3df local = position - getAbsolutePosition();
+	const f32 tileWidth = (f32)(TileSize-1) * scale.X;
+	const f32 tileDepth = (f32)(TileSize-1) * scale.Z;
+
+	x = tileWidth > 0.f ? core::floor32(local.X / tileWidth) : 0;
+	z = tileDepth > 0.f ? core::floor32(local.Z / tileDepth) : 0;
+}
+
+
+//! replaces {x} and {z} in a file name pattern
+io::path CTiledTerrainSceneNode::getTileFileName(const io::path& pattern, s32 x, s32 z) const
+{
+	io::path name(pattern);
+	name.replace(io::path("{x}"), io::path(x));
+	name.replace(io::path("{z}"), io::path(z));
+	return name;
+}
+
+
+//! memory of a tile without its texture
+u32 CTiledTerrainSceneNode::getTileGeometryMemory() const
+{
+	// the terrain keeps the vertices twice, in its mesh and in the render buffer
+	const u32 vertexCount = TileSize*TileSize;
+	const u32 indexSize = vertexCount > 65536 ? sizeof(u32) : sizeof(u16);
+	return vertexCount * sizeof(video::S3DVertex2TCoords) * 2 +
+		(TileSize-1) * (TileSize-1) * 6 * indexSize;
+}
+
+
+void CTiledTerrainSceneNode::recalculateBoundingBox()
+{
+	// tile boxes are absolute, the box of this node is relative to it
+	core::matrix4 absinv(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE);
+
+	for (u32 i=0; i<Tiles.size(); ++i)
+	{
+		core::aabbox3df box(Tiles[i].Node->getBoundingBox());
+		absinv.transformBoxEx(box);
+		if (i == 0)
+			BoundingBox = box;
+		else
+			BoundingBox.addInternalBox(box);
+	}
+
+	if (Tiles.empty())
+		BoundingBox.reset(0.f, 0.f, 0.f);
+}
+
+
+//! Writes attributes of the scene node.
+void CTiledTerrainSceneNode::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
+{
+	ITiledTerrainSceneNode::serializeAttributes(out, options);
+
+	out->addString("HeightmapPattern", HeightmapPattern.c_str());
+	out->addString("TexturePattern", TexturePattern.c_str());
+	out->addInt("TileCountX", TileCountX);
+	out->addInt("TileCountZ", TileCountZ);
+	out->addInt("TileSize", TileSize);
+	out->addInt("MaxLOD", MaxLOD);
+	out->addInt("PatchSize", PatchSize);
+	out->addInt("LoadRadius", LoadRadius);
+	out->addInt("TilesPerFrame", TilesPerFrame);
+	out->addInt("MemoryBudget", MemoryBudget);
+}
+
+
+//! Reads attributes of the scene node.
+void CTiledTerrainSceneNode::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options)
+{
+	// loaded tiles don't fit to new patterns or sizes
+	removeAllTiles();
+
+	HeightmapPattern = in->getAttributeAsString("HeightmapPattern", HeightmapPattern);
+	TexturePattern = in->getAttributeAsString("TexturePattern", TexturePattern);
+	TileCountX = in->getAttributeAsInt("TileCountX", TileCountX);
+	TileCountZ = in->getAttributeAsInt("TileCountZ", TileCountZ);
+	TileSize = in->getAttributeAsInt("TileSize", TileSize);
+	MaxLOD = in->getAttributeAsInt("MaxLOD", MaxLOD);
+	PatchSize = (E_TERRAIN_PATCH_SIZE)in->getAttributeAsInt("PatchSize", PatchSize);
+	LoadRadius = in->getAttributeAsInt("LoadRadius", LoadRadius);
+	TilesPerFrame = in->getAttributeAsInt("TilesPerFrame", TilesPerFrame);
+	MemoryBudget = in->getAttributeAsInt("MemoryBudget", MemoryBudget);
+
+	MissingTiles.set_used(TileCountX * TileCountZ);
+	for (u32 i=0; i<MissingTiles.size(); ++i)
+		MissingTiles[i] = false;
+
+	ITiledTerrainSceneNode::deserializeAttributes(in, options);
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_TERRAIN_SCENENODE_
+
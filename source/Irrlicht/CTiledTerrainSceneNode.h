@@ -0,0 +1,161 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_TILED_TERRAIN_SCENE_NODE_H_INCLUDED__
+#define __C_TILED_TERRAIN_SCENE_NODE_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_TERRAIN_SCENENODE_
+
+#include "ITiledTerrainSceneNode.h"
+#include "ETerrainElements.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace video
+{
+	class ITexture;
+}
+namespace scene
+{
+
+	//! Terrain which loads and removes heightmap tiles around the camera.
+	class CTiledTerrainSceneNode : public ITiledTerrainSceneNode
+	{
+	public:
+
+		//! constructor
+		CTiledTerrainSceneNode(const io::path& heightmapPattern, const io::path& texturePattern,
+			u32 tileCountX, u32 tileCountZ, s32 tileSize,
+			ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position, const core::vector3df& scale,
+			s32 maxLOD, E_TERRAIN_PATCH_SIZE patchSize);
+
+		//! destructor
+		virtual ~CTiledTerrainSceneNode();
+
+		//! loads missing tiles and removes far away ones
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
+		//! the tiles render themselves
+		virtual void render() _IRR_OVERRIDE_ {}
+
+		//! returns the bounding box of all loaded tiles
+		virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_ { return BoundingBox; }
+
+		//! returns the material used for all tiles
+		virtual video::SMaterial& getMaterial(u32 i) _IRR_OVERRIDE_ { return Material; }
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const _IRR_OVERRIDE_ { return 1; }
+
+		//! Removes a child from this scene node.
+		virtual bool removeChild(ISceneNode* child) _IRR_OVERRIDE_;
+
+		//! Removes all children of this scene node, including all tiles.
+		virtual void removeAll() _IRR_OVERRIDE_;
+
+		//! Sets how many tiles around the tile of the camera are loaded.
+		virtual void setLoadRadius(u32 radius) _IRR_OVERRIDE_ { LoadRadius = radius; }
+
+		//! Returns how many tiles around the tile of the camera are loaded.
+		virtual u32 getLoadRadius() const _IRR_OVERRIDE_ { return LoadRadius; }
+
+		//! Sets how many tiles are loaded at most per frame.
+		virtual void setTilesPerFrame(u32 count) _IRR_OVERRIDE_ { TilesPerFrame = count; }
+
+		//! Sets the maximal memory used by loaded tiles in bytes.
+		virtual void setMemoryBudget(u32 bytes) _IRR_OVERRIDE_ { MemoryBudget = bytes; }
+
+		//! Returns the memory used by all loaded tiles in bytes.
+		virtual u32 getResidentMemory() const _IRR_OVERRIDE_ { return ResidentMemory; }
+
+		//! Returns the number of loaded tiles.
+		virtual u32 getResidentTileCount() const _IRR_OVERRIDE_ { return Tiles.size(); }
+
+		//! Returns the terrain node of a tile.
+		virtual ITerrainSceneNode* getTile(s32 x, s32 z) const _IRR_OVERRIDE_;
+
+		//! Get height of a point of the terrain.
+		virtual f32 getHeight(f32 x, f32 z) const _IRR_OVERRIDE_;
+
+		//! Loads the tiles around a position right away.
+		virtual void loadTilesAround(const core::vector3df& position) _IRR_OVERRIDE_;
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_TILED_TERRAIN; }
+
+		//! Writes attributes of the scene node.
+		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const _IRR_OVERRIDE_;
+
+		//! Reads attributes of the scene node.
+		virtual void deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options=0) _IRR_OVERRIDE_;
+
+	private:
+
+		struct STile
+		{
+			s32 X;
+			s32 Z;
+			ITerrainSceneNode* Node;
+			video::ITexture* Texture;
+			u32 Memory;
+		};
+
+		//! loads and removes tiles for a camera position
+		void updateTiles(const core::vector3df& position, u32 maxLoads);
+
+		//! loads a tile, returns false if it doesn't exist or couldn't be loaded
+		bool loadTile(s32 x, s32 z);
+
+		//! removes a loaded tile
+		void removeTile(u32 index);
+
+		//! removes all tiles and forgets which ones failed to load
+		void removeAllTiles();
+
+		//! returns the tile a position is in, can be outside the grid
+		void getTilePosition(const core::vector3df& position, s32& x, s32& z) const;
+
+		//! replaces {x} and {z} in a file name pattern
+		io::path getTileFileName(const io::path& pattern, s32 x, s32 z) const;
+
+		//! memory of a tile without its texture
+		u32 getTileGeometryMemory() const;
+
+		void recalculateBoundingBox();
+
+		core::array<STile> Tiles;
+		//! textures which were loaded for tiles, they are removed from the driver cache with their last tile
+		core::array<video::ITexture*> LoadedTextures;
+		//! tiles which couldn't be loaded, one flag per tile of the grid
+		core::array<bool> MissingTiles;
+
+		io::path HeightmapPattern;
+		io::path TexturePattern;
+		u32 TileCountX;
+		u32 TileCountZ;
+		s32 TileSize;
+		s32 MaxLOD;
+		E_TERRAIN_PATCH_SIZE PatchSize;
+
+		u32 LoadRadius;
+		u32 TilesPerFrame;
+		u32 MemoryBudget;
+		u32 ResidentMemory;
+		//! texture memory of the last loaded tile, used to estimate the next one
+		u32 LastTextureMemory;
+
+		video::SMaterial Material;
+		core::aabbox3d<f32> BoundingBox;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_TERRAIN_SCENENODE_
+
+#endif
+
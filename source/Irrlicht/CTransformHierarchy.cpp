@@ -0,0 +1,217 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CTransformHierarchy.h"
+#include "ISceneNode.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CTransformHierarchy::CTransformHierarchy(ISceneNode* root)
+	: Root(root), RootParentVersion(0), UpdatedNodes(0), StructureChanged(true)
+{
+	#ifdef _DEBUG
+	setDebugName("CTransformHierarchy");
+	#endif
+
+	Root->grab();
+	rebuild();
+}
+
+
+//! destructor
+CTransformHierarchy::~CTransformHierarchy()
+{
+	// removed nodes are already taken out, so only the current tree is cleared
+	Root->clearTransformHandles(this);
+	Root->drop();
+}
+
+
+//! Rebuilds the node order from the scene graph.
+void CTransformHierarchy::rebuild()
+{
+	Nodes.set_used(0);
+	Parents.set_used(0);
+	Subtrees.set_used(0);
+	StructureChanged = false;
+
+	if (Root->getTransformHierarchy() && Root->getTransformHierarchy() != this)
+	{
+		os::Printer::log("Root of the transform hierarchy is already part of another one.", ELL_WARNING);
+		Changes.set_used(0);
+		RelativeTransformations.set_used(0);
+		AbsoluteTransformations.set_used(0);
+		return;
+	}
+
+	Root->setTransformHandle(this, 0);
+	Nodes.push_back(Root);
+	Parents.push_back(-1);
+
+	// each child of the root starts a subtree, which can be updated on its own
+	ISceneNodeList::ConstIterator it = Root->getChildren().begin();
+	for (; it != Root->getChildren().end(); ++it)
+	{
+		ITransformHierarchy* hierarchy = (*it)->getTransformHierarchy();
+		if (hierarchy && hierarchy != this)
+			continue;
+
+		Subtrees.push_back(Nodes.size());
+		addNode(*it, 0);
+	}
+	Subtrees.push_back(Nodes.size());
+
+	// everything is calculated on the next update
+	const u32 count = Nodes.size();
+	RelativeTransformations.set_used(count);
+	AbsoluteTransformations.set_used(count);
+	Changes.set_used(count);
+	for (u32 i=0; i<count; ++i)
+		Changes[i] = EC_RELATIVE;
+}
+
+
+//! appends a node and its children in depth first order
+void CTransformHierarchy::addNode(ISceneNode* node, s32 parent)
+{
+	const s32 handle = (s32)Nodes.size();
+	node->setTransformHandle(this, handle);
+	Nodes.push_back(node);
+	Parents.push_back(parent);
+
+	ISceneNodeList::ConstIterator it = node->getChildren().begin();
+	for (; it != node->getChildren().end(); ++it)
+	{
+		ITransformHierarchy* hierarchy = (*it)->getTransformHierarchy();
+		if (!hierarchy || hierarchy == this)
+			addNode(*it, handle);
+	}
+}
+
+
+//! Recalculates the absolute transformations of all changed nodes and their children.
+void CTransformHierarchy::update()
+{
+	if (StructureChanged)
+		rebuild();
+
+	UpdatedNodes = 0;
+	if (Nodes.empty())
+		return;
+
+	// the root follows its parent, which is not part of the hierarchy
+	const ISceneNode* rootParent = Root->getParent();
+	const u32 parentVersion = rootParent ? rootParent->getTransformVersion() : 0;
+	if (parentVersion != RootParentVersion && Changes[0] == EC_NONE)
+		Changes[0] = EC_ABSOLUTE;
+	RootParentVersion = parentVersion;
+
+	UpdatedNodes = updateRange(0, 1);
+
+	// subtrees only depend on the root, which is done
+	const s32 count = (s32)Subtrees.size() - 1;
+	u32 updated = 0;
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) reduction(+:updated) if (Nodes.size() >= 4096)
+#endif
+	for (s32 i=0; i<count; ++i)
+		updated += updateRange(Subtrees[i], Subtrees[i+1]);
+	UpdatedNodes += updated;
+
+	for (u32 i=0; i<Changes.size(); ++i)
+		Changes[i] = EC_NONE;
+}
+
+
+//! updates the nodes in [begin, end), their parents are already up to date
+u32 CTransformHierarchy::updateRange(u32 begin, u32 end)
+{
+	u32 updated = 0;
+
+	for (u32 i=begin; i<end; ++i)
+	{
+		const s32 parent = Parents[i];
+
+		// parents come first, so their changes are already known
+		if (Changes[i] == EC_NONE)
+		{
+			if (parent < 0 || Changes[parent] == EC_NONE)
+				continue;
+			Changes[i] = EC_ABSOLUTE;
+		}
+
+		ISceneNode* node = Nodes[i];
+		if (Changes[i] == EC_RELATIVE)
+			RelativeTransformations[i] = node->getRelativeTransformation();
+
+		if (parent >= 0)
+			AbsoluteTransformations[i].setbyproduct(AbsoluteTransformations[parent], RelativeTransformations[i]);
+		else if (node->getParent())
+			AbsoluteTransformations[i].setbyproduct(node->getParent()->getAbsoluteTransformation(), RelativeTransformations[i]);
+		else
+			AbsoluteTransformations[i] = RelativeTransformations[i];
+
+		node->setAbsoluteTransformation(AbsoluteTransformations[i]);
+		++updated;
+	}
+
+	return updated;
+}
+
+
+//! Returns the node of a handle.
+ISceneNode* CTransformHierarchy::getNode(s32 handle) const
+{
+	if (handle < 0 || handle >= (s32)Nodes.size())
+		return 0;
+
+	return Nodes[handle];
+}
+
+
+//! Returns the handle of the parent of a node, or -1 for the root.
+s32 CTransformHierarchy::getParentHandle(s32 handle) const
+{
+	if (handle < 0 || handle >= (s32)Parents.size())
+		return -1;
+
+	return Parents[handle];
+}
+
+
+//! Returns the relative transformation of a node as of the last update().
+const core::matrix4& CTransformHierarchy::getRelativeTransformation(s32 handle) const
+{
+	if (handle < 0 || handle >= (s32)RelativeTransformations.size())
+		return core::IdentityMatrix;
+
+	return RelativeTransformations[handle];
+}
+
+
+//! Returns the absolute transformation of a node as of the last update().
+const core::matrix4& CTransformHierarchy::getAbsoluteTransformation(s32 handle) const
+{
+	if (handle < 0 || handle >= (s32)AbsoluteTransformations.size())
+		return core::IdentityMatrix;
+
+	return AbsoluteTransformations[handle];
+}
+
+
+//! Called by a node of the hierarchy when its relative transformation changed.
+void CTransformHierarchy::setNodeChanged(s32 handle)
+{
+	if (handle >= 0 && handle < (s32)Changes.size())
+		Changes[handle] = EC_RELATIVE;
+}
+
+
+} // end namespace scene
+} // end namespace irr
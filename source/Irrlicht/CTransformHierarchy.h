@@ -0,0 +1,100 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_TRANSFORM_HIERARCHY_H_INCLUDED__
+#define __C_TRANSFORM_HIERARCHY_H_INCLUDED__
+
+#include "ITransformHierarchy.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Stores the transformations of a scene node tree in parent before child order.
+	class CTransformHierarchy : public ITransformHierarchy
+	{
+	public:
+
+		//! constructor
+		CTransformHierarchy(ISceneNode* root);
+
+		//! destructor
+		virtual ~CTransformHierarchy();
+
+		//! Recalculates the absolute transformations of all changed nodes and their children.
+		virtual void update() _IRR_OVERRIDE_;
+
+		//! Rebuilds the node order from the scene graph.
+		virtual void rebuild() _IRR_OVERRIDE_;
+
+		//! Returns the root node of the hierarchy.
+		virtual ISceneNode* getRoot() const _IRR_OVERRIDE_ { return Root; }
+
+		//! Returns the number of nodes in the hierarchy, including the root.
+		virtual u32 getNodeCount() const _IRR_OVERRIDE_ { return Nodes.size(); }
+
+		//! Returns the node of a handle.
+		virtual ISceneNode* getNode(s32 handle) const _IRR_OVERRIDE_;
+
+		//! Returns the handle of the parent of a node, or -1 for the root.
+		virtual s32 getParentHandle(s32 handle) const _IRR_OVERRIDE_;
+
+		//! Returns the relative transformation of a node as of the last update().
+		virtual const core::matrix4& getRelativeTransformation(s32 handle) const _IRR_OVERRIDE_;
+
+		//! Returns the absolute transformation of a node as of the last update().
+		virtual const core::matrix4& getAbsoluteTransformation(s32 handle) const _IRR_OVERRIDE_;
+
+		//! Returns how many absolute transformations the last update() recalculated.
+		virtual u32 getUpdatedNodeCount() const _IRR_OVERRIDE_ { return UpdatedNodes; }
+
+		//! Called by a node of the hierarchy when its relative transformation changed.
+		virtual void setNodeChanged(s32 handle) _IRR_OVERRIDE_;
+
+		//! Called by a node of the hierarchy when children were added or removed.
+		virtual void setStructureChanged() _IRR_OVERRIDE_ { StructureChanged = true; }
+
+	private:
+
+		//! what has to be recalculated for a node
+		enum E_CHANGE
+		{
+			EC_NONE = 0,
+			//! parent's absolute transformation changed
+			EC_ABSOLUTE,
+			//! relative transformation changed
+			EC_RELATIVE
+		};
+
+		//! appends a node and its children in depth first order
+		void addNode(ISceneNode* node, s32 parent);
+
+		//! updates the nodes in [begin, end), their parents are already up to date
+		u32 updateRange(u32 begin, u32 end);
+
+		ISceneNode* Root;
+
+		// structure of arrays, sorted in depth first order
+		core::array<ISceneNode*> Nodes;
+		core::array<s32> Parents;
+		core::array<core::matrix4> RelativeTransformations;
+		core::array<core::matrix4> AbsoluteTransformations;
+		//! E_CHANGE of each node, set by setNodeChanged and cleared by update
+		core::array<u8> Changes;
+
+		//! first handle of each subtree below the root, and the end
+		core::array<u32> Subtrees;
+
+		//! transformation version of the parent of the root used in the last update
+		u32 RootParentVersion;
+		u32 UpdatedNodes;
+		bool StructureChanged;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
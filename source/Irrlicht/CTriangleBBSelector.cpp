@@ -18,7 +18,10 @@ CTriangleBBSelector::CTriangleBBSelector(ISceneNode* node)
 	setDebugName("CTriangleBBSelector");
 	#endif
 
-	Triangles.set_used(12); // a box has 12 triangles.
+	// a box has 12 triangles, they match the empty BoundingBox until the node box is known
+	Triangles.reallocate(12);
+	for (u32 i=0; i<12; ++i)
+		Triangles.push_back(core::triangle3df());
 }
 
 //! Gets all triangles.
@@ -53,12 +56,24 @@ void CTriangleBBSelector::getTriangles(core::triangle3df* triangles,
 	return CTriangleSelector::getTriangles(triangles, arraySize, outTriangleCount, line, transform, useNodeTransform, outTriangleInfo);
 }
 
+//! Gets a box around all triangles of this selector.
+bool CTriangleBBSelector::getBoundingBox(core::aabbox3df& outBox, bool useNodeTransform) const
+{
+	fillTriangles();
+	return CTriangleSelector::getBoundingBox(outBox, useNodeTransform);
+}
+
 void CTriangleBBSelector::fillTriangles() const
 {
 	if (SceneNode)
 	{
-		// construct triangles
+		// only write when the box changed, so the selector can be queried from several threads
 		const core::aabbox3d<f32>& box = SceneNode->getBoundingBox();
+		if (box == BoundingBox)
+			return;
+		BoundingBox = box;
+
+		// construct triangles
 		core::vector3df edges[8];
 		box.getEdges(edges);
 
@@ -36,6 +36,9 @@ public:
 		const core::matrix4* transform, bool useNodeTransform, 
 		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const _IRR_OVERRIDE_;
 
+	//! Gets a box around all triangles of this selector.
+	virtual bool getBoundingBox(core::aabbox3df& outBox, bool useNodeTransform) const _IRR_OVERRIDE_;
+
 protected:
 	void fillTriangles() const;
 
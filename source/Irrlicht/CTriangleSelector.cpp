@@ -60,7 +60,7 @@ CTriangleSelector::CTriangleSelector(const IMeshBuffer* meshBuffer, irr::u32 mat
 }
 
 CTriangleSelector::CTriangleSelector(IAnimatedMeshSceneNode* node, bool separateMeshbuffers)
-: SceneNode(node), AnimatedNode(node), LastMeshFrame(0)
+: SceneNode(node), MeshBuffer(0), MaterialIndex(0), AnimatedNode(node), LastMeshFrame(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CTriangleSelector");
@@ -69,15 +69,16 @@ CTriangleSelector::CTriangleSelector(IAnimatedMeshSceneNode* node, bool separate
 	if (!AnimatedNode)
 		return;
 
-	IAnimatedMesh* animatedMesh = AnimatedNode->getMesh();
-	if (!animatedMesh)
-		return;
-
 	LastMeshFrame = (u32)AnimatedNode->getFrameNr();
-	IMesh* mesh = animatedMesh->getMesh(LastMeshFrame);
+	IMesh* mesh = getAnimatedNodeMesh();
 
 	if (mesh)
+	{
 		createFromMesh(mesh, separateMeshbuffers);
+
+		// the triangles move, so the hierarchy is kept up to date instead of rebuilding it
+		buildBoundingHierarchy();
+	}
 }
 
 
@@ -85,6 +86,10 @@ void CTriangleSelector::createFromMesh(const IMesh* mesh, bool createBufferRange
 {
 	BufferRanges.clear();
 	Triangles.clear();
+	BufferStates.clear();
+	BoundingNodes.clear();
+	BoundingTriangles.clear();
+	BoundingBox.reset(0.f, 0.f, 0.f);
 
 	const u32 cnt = mesh->getMeshBufferCount();
 	u32 totalFaceCount = 0;
@@ -156,12 +161,33 @@ void CTriangleSelector::updateFromMesh(const IMesh* mesh) const
 	u32 meshBuffers = mesh->getMeshBufferCount();
 	u32 triangleCount = 0;
 
+	// Animated meshes often only change some of their meshbuffers, so we
+	// remember which state each one had and skip those which didn't change.
+	bool layoutChanged = BufferStates.size() != meshBuffers;
+	for (u32 i = 0; i < meshBuffers && !layoutChanged; ++i)
+		layoutChanged = BufferStates[i].TriangleCount != mesh->getMeshBuffer(i)->getIndexCount() / 3;
+
+	if ( layoutChanged )
+	{
+		BufferStates.set_used(meshBuffers);
+		for (u32 i = 0; i < meshBuffers; ++i)
+		{
+			SBufferState& state = BufferStates[i];
+			state.MeshBuffer = 0;
+			state.TriangleStart = triangleCount;
+			state.TriangleCount = mesh->getMeshBuffer(i)->getIndexCount() / 3;
+			state.FirstNode = 0;
+			state.NodeCount = 0;
+			triangleCount += state.TriangleCount;
+		}
+		Triangles.set_used(triangleCount);
+	}
+
+	bool changed = false;
 	for (u32 i = 0; i < meshBuffers; ++i)
 	{
 		IMeshBuffer* buf = mesh->getMeshBuffer(i);
-		u32 idxCnt = buf->getIndexCount();
-		u32 vertexPitch = getVertexPitchFromType(buf->getVertexType());
-		u8* vertices = (u8*)buf->getVertices();
+		SBufferState& state = BufferStates[i];
 
 		const core::matrix4* bufferTransform = 0;
 		if ( skinnnedMesh )
@@ -171,6 +197,24 @@ void CTriangleSelector::updateFromMesh(const IMesh* mesh) const
 				bufferTransform = 0;
 		}
 
+		if ( state.MeshBuffer == buf
+			&& state.ChangedID_Vertex == buf->getChangedID_Vertex()
+			&& state.ChangedID_Index == buf->getChangedID_Index()
+			&& (!skinnnedMesh || state.Transformation == ((scene::SSkinMeshBuffer*)buf)->Transformation) )
+			continue;
+
+		state.MeshBuffer = buf;
+		state.ChangedID_Vertex = buf->getChangedID_Vertex();
+		state.ChangedID_Index = buf->getChangedID_Index();
+		if ( skinnnedMesh )
+			state.Transformation = ((scene::SSkinMeshBuffer*)buf)->Transformation;
+		changed = true;
+
+		triangleCount = state.TriangleStart;
+		u32 idxCnt = buf->getIndexCount();
+		u32 vertexPitch = getVertexPitchFromType(buf->getVertexType());
+		u8* vertices = (u8*)buf->getVertices();
+
 		switch ( buf->getIndexType() )
 		{
 			case video::EIT_16BIT:
@@ -186,10 +230,34 @@ void CTriangleSelector::updateFromMesh(const IMesh* mesh) const
 			}
 			break;
 		}
+
+		if ( state.NodeCount )
+			refitBoundingHierarchy(i);
 	}
 
+	if ( layoutChanged && !BoundingNodes.empty() )
+		buildBoundingHierarchy();
+	else if ( !changed )
+		return;
+
 	// Update bounding box
-	updateBoundingBox();
+	if ( BoundingNodes.empty() )
+		updateBoundingBox();
+	else
+	{
+		bool first = true;
+		for (u32 i = 0; i < BufferStates.size(); ++i)
+		{
+			if ( !BufferStates[i].NodeCount )
+				continue;
+			const core::aabbox3df& box = BoundingNodes[BufferStates[i].FirstNode].Box;
+			if ( first )
+				BoundingBox = box;
+			else
+				BoundingBox.addInternalBox(box);
+			first = false;
+		}
+	}
 }
 
 void CTriangleSelector::updateFromMeshBuffer(const IMeshBuffer* meshBuffer) const
@@ -237,25 +305,185 @@ void CTriangleSelector::updateBoundingBox() const
 	}
 }
 
+void CTriangleSelector::buildBoundingHierarchy() const
+{
+	BoundingNodes.set_used(0);
+	BoundingTriangles.set_used(Triangles.size());
+
+	core::array<core::vector3df> centers(Triangles.size());
+	for (u32 i=0; i < Triangles.size(); ++i)
+	{
+		const core::triangle3df& tri = Triangles[i];
+		centers.push_back((tri.pointA + tri.pointB + tri.pointC) / 3.f);
+		BoundingTriangles[i] = i;
+	}
+
+	// One hierarchy per meshbuffer, so changed meshbuffers can be refitted on their own
+	for (u32 i=0; i < BufferStates.size(); ++i)
+	{
+		SBufferState& state = BufferStates[i];
+		state.FirstNode = BoundingNodes.size();
+		if ( state.TriangleCount )
+			buildBoundingNode(state.TriangleStart, state.TriangleStart + state.TriangleCount, centers);
+		state.NodeCount = BoundingNodes.size() - state.FirstNode;
+	}
+
+	if ( BoundingNodes.empty() )
+		updateBoundingBox();
+}
+
+u32 CTriangleSelector::buildBoundingNode(u32 begin, u32 end, const core::array<core::vector3df>& centers) const
+{
+	const u32 index = BoundingNodes.size();
+	BoundingNodes.push_back(SBoundingNode());
+
+	core::aabbox3df box(Triangles[BoundingTriangles[begin]].pointA);
+	core::aabbox3df centerBox(centers[BoundingTriangles[begin]]);
+	for (u32 i=begin; i < end; ++i)
+	{
+		const core::triangle3df& tri = Triangles[BoundingTriangles[i]];
+		box.addInternalPoint(tri.pointA);
+		box.addInternalPoint(tri.pointB);
+		box.addInternalPoint(tri.pointC);
+		centerBox.addInternalPoint(centers[BoundingTriangles[i]]);
+	}
+	BoundingNodes[index].Box = box;
+
+	const u32 maxLeafTriangles = 8;
+	if ( end - begin <= maxLeafTriangles )
+	{
+		BoundingNodes[index].Index = begin;
+		BoundingNodes[index].Count = end - begin;
+		return index;
+	}
+
+	// split at the middle of the longest axis of the triangle centers
+	const core::vector3df extent = centerBox.getExtent();
+	const u32 axis = (extent.X >= extent.Y && extent.X >= extent.Z) ? 0 : (extent.Y >= extent.Z ? 1 : 2);
+	const f32 split = (&centerBox.MinEdge.X)[axis] + (&extent.X)[axis] * 0.5f;
+
+	u32 middle = begin;
+	for (u32 i=begin; i < end; ++i)
+	{
+		if ( (&centers[BoundingTriangles[i]].X)[axis] < split )
+		{
+			core::swap(BoundingTriangles[i], BoundingTriangles[middle]);
+			++middle;
+		}
+	}
+
+	// all centers on one side, just split the list in two
+	if ( middle == begin || middle == end )
+		middle = begin + (end - begin) / 2;
+
+	buildBoundingNode(begin, middle, centers);
+	const u32 second = buildBoundingNode(middle, end, centers);
+
+	BoundingNodes[index].Index = second;
+	BoundingNodes[index].Count = 0;
+	return index;
+}
+
+void CTriangleSelector::refitBoundingHierarchy(u32 buffer) const
+{
+	const SBufferState& state = BufferStates[buffer];
+
+	// children come after their parents, so going backwards updates them first
+	for (s32 n = (s32)(state.FirstNode + state.NodeCount) - 1; n >= (s32)state.FirstNode; --n)
+	{
+		SBoundingNode& node = BoundingNodes[n];
+		if ( node.Count )
+		{
+			node.Box.reset(Triangles[BoundingTriangles[node.Index]].pointA);
+			for (u32 i = node.Index; i < node.Index + node.Count; ++i)
+			{
+				const core::triangle3df& tri = Triangles[BoundingTriangles[i]];
+				node.Box.addInternalPoint(tri.pointA);
+				node.Box.addInternalPoint(tri.pointB);
+				node.Box.addInternalPoint(tri.pointC);
+			}
+		}
+		else
+		{
+			node.Box = BoundingNodes[n + 1].Box;
+			node.Box.addInternalBox(BoundingNodes[node.Index].Box);
+		}
+	}
+}
+
+void CTriangleSelector::getTrianglesFromNode(u32 node, core::triangle3df* triangles, s32 arraySize,
+		s32& triangleCount, const core::aabbox3d<f32>& box, const core::matrix4& transform) const
+{
+	const SBoundingNode& n = BoundingNodes[node];
+	if ( triangleCount == arraySize || !n.Box.intersectsWithBox(box) )
+		return;
+
+	if ( n.Count )
+	{
+		for (u32 i = n.Index; i < n.Index + n.Count; ++i)
+		{
+			const core::triangle3df& tri = Triangles[BoundingTriangles[i]];
+
+			// This isn't an accurate test, but it's fast, and the
+			// API contract doesn't guarantee complete accuracy.
+			if (tri.isTotalOutsideBox(box))
+				continue;
+
+			triangles[triangleCount] = tri;
+			transform.transformVect(triangles[triangleCount].pointA);
+			transform.transformVect(triangles[triangleCount].pointB);
+			transform.transformVect(triangles[triangleCount].pointC);
+
+			++triangleCount;
+			if (triangleCount == arraySize)
+				return;
+		}
+	}
+	else
+	{
+		getTrianglesFromNode(node + 1, triangles, arraySize, triangleCount, box, transform);
+		getTrianglesFromNode(n.Index, triangles, arraySize, triangleCount, box, transform);
+	}
+}
+
 void CTriangleSelector::update(void) const
 {
 	if (!AnimatedNode)
 		return; //< harmless no-op
 
+	const IAnimatedMesh* animatedMesh = AnimatedNode->getMesh();
+	if (!animatedMesh)
+		return;
+
+	// Skinned meshes can change without a new frame number, e.g. by joint
+	// control or blending. Their buffers are checked by updateFromMesh,
+	// which skips the unchanged ones.
 	const u32 currentFrame = (u32)AnimatedNode->getFrameNr();
-	if (currentFrame == LastMeshFrame)
+	if (currentFrame == LastMeshFrame && animatedMesh->getMeshType() != EAMT_SKINNED)
 		return; //< Nothing to do
 
 	LastMeshFrame = currentFrame;
-	IAnimatedMesh * animatedMesh = AnimatedNode->getMesh();
 
-	if (animatedMesh)
-	{
-		IMesh * mesh = animatedMesh->getMesh(LastMeshFrame);
+	IMesh * mesh = getAnimatedNodeMesh();
+	if (mesh)
+		updateFromMesh(mesh);
+}
 
-		if (mesh)
-			updateFromMesh(mesh);
-	}
+
+//! Returns the mesh of the animated node at its current frame
+IMesh* CTriangleSelector::getAnimatedNodeMesh() const
+{
+	IAnimatedMesh* animatedMesh = AnimatedNode->getMesh();
+	if (!animatedMesh)
+		return 0;
+
+	// The node skins its skinned mesh in place when it is animated, so the
+	// buffers already hold the positions it renders. Animating the mesh
+	// again would repeat the skinning and the joint updates of the node.
+	if (animatedMesh->getMeshType() == EAMT_SKINNED)
+		return animatedMesh;
+
+	return animatedMesh->getMesh((s32)AnimatedNode->getFrameNr());
 }
 
 
@@ -278,12 +506,9 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 	if (SceneNode&&useNodeTransform)
 		mat *= SceneNode->getAbsoluteTransformation();
 
-	for (u32 i=0; i<cnt; ++i)
-	{
-		mat.transformVect( triangles[i].pointA, Triangles[i].pointA );
-		mat.transformVect( triangles[i].pointB, Triangles[i].pointB );
-		mat.transformVect( triangles[i].pointC, Triangles[i].pointC );
-	}
+	// triangles are just 3 points each, so transform them as one array
+	if (cnt)
+		mat.transformVects(&triangles[0].pointA, &Triangles[0].pointA, cnt*3);
 
 	if ( outTriangleInfo )
 	{
@@ -366,7 +591,42 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 	s32 triangleCount = 0;
 	const u32 cnt = Triangles.size();
 
-	if ( outTriangleInfo && !BufferRanges.empty() )
+	if ( !BoundingNodes.empty() )
+	{
+		// walk the hierarchy of each meshbuffer, skipping whole parts of the mesh
+		for (u32 i=0; i < BufferStates.size() && triangleCount < arraySize; ++i)
+		{
+			if ( !BufferStates[i].NodeCount )
+				continue;
+
+			const s32 rangeStart = triangleCount;
+			getTrianglesFromNode(BufferStates[i].FirstNode, triangles, arraySize, triangleCount, tBox, mat);
+
+			if ( outTriangleInfo && !BufferRanges.empty() && triangleCount > rangeStart )
+			{
+				SCollisionTriangleRange triRange;
+				triRange.RangeStart = rangeStart;
+				triRange.RangeSize = triangleCount - rangeStart;
+				triRange.Selector = const_cast<CTriangleSelector*>(this);
+				triRange.SceneNode = SceneNode;
+				triRange.MeshBuffer = BufferRanges[i].MeshBuffer;
+				triRange.MaterialIndex = BufferRanges[i].MaterialIndex;
+				outTriangleInfo->push_back(triRange);
+			}
+		}
+
+		if ( outTriangleInfo && BufferRanges.empty() )
+		{
+			SCollisionTriangleRange triRange;
+			triRange.RangeSize = triangleCount;
+			triRange.Selector = const_cast<CTriangleSelector*>(this);
+			triRange.SceneNode = SceneNode;
+			triRange.MeshBuffer = MeshBuffer;
+			triRange.MaterialIndex = MaterialIndex;
+			outTriangleInfo->push_back(triRange);
+		}
+	}
+	else if ( outTriangleInfo && !BufferRanges.empty() )
 	{
 		irr::u32 activeRange = 0;
 		SCollisionTriangleRange triRange;
@@ -471,6 +731,20 @@ s32 CTriangleSelector::getTriangleCount() const
 }
 
 
+//! Gets a box around all triangles of this selector.
+bool CTriangleSelector::getBoundingBox(core::aabbox3df& outBox, bool useNodeTransform) const
+{
+	// Update my triangles if necessary
+	update();
+
+	outBox = BoundingBox;
+	if (SceneNode && useNodeTransform)
+		SceneNode->getAbsoluteTransformation().transformBoxEx(outBox);
+
+	return true;
+}
+
+
 /* Get the number of TriangleSelectors that are part of this one.
 Only useful for MetaTriangleSelector others return 1
 */
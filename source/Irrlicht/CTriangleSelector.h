@@ -58,6 +58,9 @@ public:
 	//! Returns amount of all available triangles in this selector
 	virtual s32 getTriangleCount() const _IRR_OVERRIDE_;
 
+	//! Gets a box around all triangles of this selector.
+	virtual bool getBoundingBox(core::aabbox3df& outBox, bool useNodeTransform) const _IRR_OVERRIDE_;
+
 	//! Return the scene node associated with a given triangle.
 	virtual ISceneNode* getSceneNodeForTriangle(u32 triangleIndex) const _IRR_OVERRIDE_ { return SceneNode; }
 
@@ -86,13 +89,59 @@ protected:
 	//! Update bounding box from triangles
 	void updateBoundingBox() const;
 
+	//! Builds the bounding volume hierarchies of all meshbuffers
+	void buildBoundingHierarchy() const;
+
+	//! Adds a node for the triangles [begin, end) of BoundingTriangles, returns its index
+	u32 buildBoundingNode(u32 begin, u32 end, const core::array<core::vector3df>& centers) const;
+
+	//! Recalculates the boxes of the hierarchy of a meshbuffer after its triangles moved
+	void refitBoundingHierarchy(u32 buffer) const;
+
+	//! Collects the triangles of a hierarchy node and its children which may touch the box
+	void getTrianglesFromNode(u32 node, core::triangle3df* triangles, s32 arraySize,
+		s32& triangleCount, const core::aabbox3d<f32>& box, const core::matrix4& transform) const;
+
 	//! Update the triangle selector, which will only have an effect if it
 	//! was built from an animated mesh and that mesh's frame has changed
 	//! since the last time it was updated.
 	virtual void update(void) const;
 
+	//! Returns the mesh of the animated node at its current frame
+	IMesh* getAnimatedNodeMesh() const;
+
 	irr::core::array<SCollisionTriangleRange> BufferRanges;
 
+	//! Meshbuffer state the triangles were last updated with
+	struct SBufferState
+	{
+		const IMeshBuffer* MeshBuffer;
+		core::matrix4 Transformation;
+		u32 ChangedID_Vertex;
+		u32 ChangedID_Index;
+		u32 TriangleStart;
+		u32 TriangleCount;
+		//! root of the bounding volume hierarchy of the buffer and number of nodes
+		u32 FirstNode;
+		u32 NodeCount;
+	};
+
+	//! Node of a bounding volume hierarchy, children come after their parent
+	struct SBoundingNode
+	{
+		core::aabbox3df Box;
+		//! first entry in BoundingTriangles for leaves, second child for inner nodes
+		u32 Index;
+		//! number of triangles of a leaf, 0 for inner nodes
+		u32 Count;
+	};
+
+	mutable core::array<SBufferState> BufferStates;
+
+	// Only built for animated meshes, its boxes are refitted when meshbuffers change
+	mutable core::array<SBoundingNode> BoundingNodes;
+	mutable core::array<u32> BoundingTriangles;
+
 	ISceneNode* SceneNode;
 	mutable core::array<core::triangle3df> Triangles; // (mutable for CTriangleBBSelector)
 	mutable core::aabbox3df BoundingBox; // Allows for trivial rejection
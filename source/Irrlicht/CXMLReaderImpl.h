@@ -24,6 +24,10 @@ namespace io
 
 
 //! implementation of the IrrXMLReader
+/** The parser works in-situ on the text buffer. Names and values are not
+copied into strings but terminated inside the buffer, and xml special
+characters are only replaced when a value is requested. All returned strings
+therefore stay valid until the next call to read(). */
 template<class char_type, class superclass>
 class CXMLReaderImpl : public IIrrXMLReader<char_type, superclass>
 {
@@ -32,8 +36,12 @@ public:
 	//! Constructor
 	CXMLReaderImpl(IFileReadCallBack* callback, bool deleteCallBack = true)
 		: IgnoreWhitespaceText(true), TextData(0), P(0), TextBegin(0), TextSize(0), CurrentNodeType(EXN_NONE),
-		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII), IsEmptyElement(false)
+		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII), NodeName(0), NodeNameDecoded(true),
+		RestorePos(0), RestoreChar(L'\0'), IsEmptyElement(false)
 	{
+		EmptyString[0] = L'\0';
+		NodeName = EmptyString;
+
 		if (!callback)
 			return;
 
@@ -68,6 +76,13 @@ public:
 	//! \return Returns false, if there was no further node.
 	virtual bool read() _IRR_OVERRIDE_
 	{
+		// put back the character which was replaced to terminate the last text node
+		if (RestorePos)
+		{
+			*RestorePos = RestoreChar;
+			RestorePos = 0;
+		}
+
 		// if not end reached, parse the node
 		if (P && ((unsigned int)(P - TextBegin) < TextSize - 1) && (*P != 0))
 		{
@@ -98,7 +113,7 @@ public:
 		if ((u32)idx >= Attributes.size())
 			return 0;
 
-		return Attributes[idx].Name.c_str();
+		return Attributes[idx].Name;
 	}
 
 
@@ -108,7 +123,7 @@ public:
 		if ((unsigned int)idx >= Attributes.size())
 			return 0;
 
-		return Attributes[idx].Value.c_str();
+		return getDecodedValue(Attributes[idx]);
 	}
 
 
@@ -119,7 +134,7 @@ public:
 		if (!attr)
 			return 0;
 
-		return attr->Value.c_str();
+		return getDecodedValue(*attr);
 	}
 
 
@@ -128,9 +143,9 @@ public:
 	{
 		const SAttribute* attr = getAttributeByName(name);
 		if (!attr)
-			return EmptyString.c_str();
+			return EmptyString;
 
-		return attr->Value.c_str();
+		return getDecodedValue(*attr);
 	}
 
 
@@ -142,8 +157,7 @@ public:
 		if (!attr)
 			return defaultNotFound;
 
-		core::stringc c(attr->Value.c_str());
-		return core::strtol10(c.c_str());
+		return parseInt(getDecodedValue(*attr));
 	}
 
 
@@ -154,8 +168,7 @@ public:
 		if (!attrvalue)
 			return defaultNotFound;
 
-		core::stringc c(attrvalue);
-		return core::strtol10(c.c_str());
+		return parseInt(attrvalue);
 	}
 
 
@@ -166,8 +179,7 @@ public:
 		if (!attr)
 			return defaultNotFound;
 
-		core::stringc c = attr->Value.c_str();
-		return core::fast_atof(c.c_str());
+		return parseFloat(getDecodedValue(*attr));
 	}
 
 
@@ -178,22 +190,27 @@ public:
 		if (!attrvalue)
 			return defaultNotFound;
 
-		core::stringc c = attrvalue;
-		return core::fast_atof(c.c_str());
+		return parseFloat(attrvalue);
 	}
 
 
 	//! Returns the name of the current node.
 	virtual const char_type* getNodeName() const _IRR_OVERRIDE_
 	{
-		return NodeName.c_str();
+		if (!NodeNameDecoded)
+		{
+			replaceSpecialCharacters(NodeName);
+			NodeNameDecoded = true;
+		}
+
+		return NodeName;
 	}
 
 
 	//! Returns data of the current node.
 	virtual const char_type* getNodeData() const _IRR_OVERRIDE_
 	{
-		return NodeName.c_str();
+		return getNodeName();
 	}
 
 
@@ -278,9 +295,13 @@ private:
 				return false;
 		}
 
-		// set current text to the parsed text, and replace xml special characters
-		core::string<char_type> s(start, (int)(end - start));
-		NodeName = replaceSpecialCharacters(s);
+		// set current text to the parsed text, xml special characters are replaced on request.
+		// end is the '<' of the next node, so it has to be restored before parsing continues.
+		RestorePos = end;
+		RestoreChar = *end;
+		*end = L'\0';
+		NodeName = start;
+		NodeNameDecoded = false;
 
 		// current XML node type is text
 		CurrentNodeType = EXN_TEXT;
@@ -294,6 +315,8 @@ private:
 	void ignoreDefinition()
 	{
 		CurrentNodeType = EXN_UNKNOWN;
+		NodeName = EmptyString;
+		NodeNameDecoded = true;
 
 		// move until end marked with '>' reached
 		while(*P != L'>')
@@ -326,7 +349,9 @@ private:
 		}
 
 		P -= 3;
-		NodeName = core::string<char_type>(pCommentBegin+2, (int)(P - pCommentBegin-2));
+		*P = L'\0';
+		NodeName = pCommentBegin+2;
+		NodeNameDecoded = true;
 		P += 3;
 	}
 
@@ -336,16 +361,16 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
 
 		// find name
-		const char_type* startName = P;
+		char_type* startName = P;
 
 		// find end of element
 		while(*P != L'>' && !isWhiteSpace(*P))
 			++P;
 
-		const char_type* endName = P;
+		char_type* endName = P;
 
 		// find Attributes
 		while(*P != L'>')
@@ -359,12 +384,12 @@ private:
 					// we've got an attribute
 
 					// read the attribute names
-					const char_type* attributeNameBegin = P;
+					char_type* attributeNameBegin = P;
 
 					while(!isWhiteSpace(*P) && *P != L'=')
 						++P;
 
-					const char_type* attributeNameEnd = P;
+					char_type* attributeNameEnd = P;
 					++P;
 
 					// read the attribute value
@@ -378,7 +403,7 @@ private:
 					const char_type attributeQuoteChar = *P;
 
 					++P;
-					const char_type* attributeValueBegin = P;
+					char_type* attributeValueBegin = P;
 
 					while(*P != attributeQuoteChar && *P)
 						++P;
@@ -386,17 +411,17 @@ private:
 					if (!*P) // malformatted xml file
 						return;
 
-					const char_type* attributeValueEnd = P;
+					char_type* attributeValueEnd = P;
 					++P;
 
-					SAttribute attr;
-					attr.Name = core::string<char_type>(attributeNameBegin,
-						(int)(attributeNameEnd - attributeNameBegin));
-
-					core::string<char_type> s(attributeValueBegin,
-						(int)(attributeValueEnd - attributeValueBegin));
+					// both ends are behind P now, so they can be terminated in place
+					*attributeNameEnd = L'\0';
+					*attributeValueEnd = L'\0';
 
-					attr.Value = replaceSpecialCharacters(s);
+					SAttribute attr;
+					attr.Name = attributeNameBegin;
+					attr.Value = attributeValueBegin;
+					attr.Decoded = false;
 					Attributes.push_back(attr);
 				}
 				else
@@ -417,7 +442,10 @@ private:
 			endName--;
 		}
 
-		NodeName = core::string<char_type>(startName, (int)(endName - startName));
+		// endName is the '>', '/' or a whitespace at the latest, which were all parsed already
+		*endName = L'\0';
+		NodeName = startName;
+		NodeNameDecoded = true;
 
 		++P;
 	}
@@ -428,15 +456,17 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT_END;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
 
 		++P;
-		const char_type* pBeginClose = P;
+		char_type* pBeginClose = P;
 
 		while(*P != L'>')
 			++P;
 
-		NodeName = core::string<char_type>(pBeginClose, (int)(P - pBeginClose));
+		*P = L'\0';
+		NodeName = pBeginClose;
+		NodeNameDecoded = true;
 		++P;
 	}
 
@@ -447,6 +477,8 @@ private:
 			return false;
 
 		CurrentNodeType = EXN_CDATA;
+		NodeName = EmptyString;
+		NodeNameDecoded = true;
 
 		// skip '<![CDATA['
 		int count=0;
@@ -476,19 +508,22 @@ private:
 		}
 
 		if ( cDataEnd )
-			NodeName = core::string<char_type>(cDataBegin, (int)(cDataEnd - cDataBegin));
-		else
-			NodeName = "";
+		{
+			*cDataEnd = L'\0';
+			NodeName = cDataBegin;
+		}
 
 		return true;
 	}
 
 
-	// structure for storing attribute-name pairs
+	// structure for storing attribute-name pairs.
+	// Both point into the text buffer.
 	struct SAttribute
 	{
-		core::string<char_type> Name;
-		core::string<char_type> Value;
+		char_type* Name;
+		char_type* Value;
+		mutable bool Decoded;	// xml special characters in Value have been replaced
 	};
 
 	// finds a current attribute by name, returns 0 if not found
@@ -497,64 +532,104 @@ private:
 		if (!name)
 			return 0;
 
-		core::string<char_type> n = name;
-
 		for (int i=0; i<(int)Attributes.size(); ++i)
-			if (Attributes[i].Name == n)
+		{
+			const char_type* a = Attributes[i].Name;
+			const char_type* b = name;
+			while (*a && *a == *b)
+			{
+				++a;
+				++b;
+			}
+			if (*a == *b)
 				return &Attributes[i];
+		}
 
 		return 0;
 	}
 
-	// replaces xml special characters in a string and creates a new one
-	core::string<char_type> replaceSpecialCharacters(
-		core::string<char_type>& origstr)
+	// returns the attribute value with xml special characters replaced
+	const char_type* getDecodedValue(const SAttribute& attr) const
 	{
-		int pos = origstr.findFirst(L'&');
-		int oldPos = 0;
+		if (!attr.Decoded)
+		{
+			replaceSpecialCharacters(attr.Value);
+			attr.Decoded = true;
+		}
+
+		return attr.Value;
+	}
 
-		if (pos == -1)
-			return origstr;
+	// replaces xml special characters inside a zero terminated string.
+	// The result is never longer than the original, so this works in place.
+	void replaceSpecialCharacters(char_type* str) const
+	{
+		char_type* src = str;
+		while (*src && *src != L'&')
+			++src;
 
-		core::string<char_type> newstr;
+		if (!*src)
+			return;
 
-		while(pos != -1 && pos < (int)origstr.size()-2)
+		char_type* dst = src;
+		while (*src)
 		{
-			// check if it is one of the special characters
-
-			int specialChar = -1;
-			for (int i=0; i<(int)SpecialCharacters.size(); ++i)
+			if (*src == L'&')
 			{
-				const char_type* p = &origstr.c_str()[pos]+1;
-
-				if (equalsn(&SpecialCharacters[i][1], p, SpecialCharacters[i].size()-1))
+				// check if it is one of the special characters
+				int specialChar = -1;
+				for (int i=0; i<(int)SpecialCharacters.size(); ++i)
 				{
-					specialChar = i;
-					break;
+					if (equalsn(&SpecialCharacters[i][1], src+1, SpecialCharacters[i].size()-1))
+					{
+						specialChar = i;
+						break;
+					}
 				}
-			}
 
-			if (specialChar != -1)
-			{
-				newstr.append(origstr.subString(oldPos, pos - oldPos));
-				newstr.append(SpecialCharacters[specialChar][0]);
-				pos += SpecialCharacters[specialChar].size();
-			}
-			else
-			{
-				newstr.append(origstr.subString(oldPos, pos - oldPos + 1));
-				pos += 1;
+				if (specialChar != -1)
+				{
+					*dst++ = SpecialCharacters[specialChar][0];
+					src += SpecialCharacters[specialChar].size();
+					continue;
+				}
 			}
 
-			// find next &
-			oldPos = pos;
-			pos = origstr.findNext(L'&', pos);
+			*dst++ = *src++;
 		}
+		*dst = L'\0';
+	}
 
-		if (oldPos < (int)origstr.size()-1)
-			newstr.append(origstr.subString(oldPos, origstr.size()-oldPos));
+	// parses an integer without creating a string copy for char readers
+	static int parseInt(const char_type* value)
+	{
+		if (sizeof(char_type) == 1)
+			return core::strtol10((const c8*)value);
 
-		return newstr;
+		c8 buffer[64];
+		toNumberBuffer(value, buffer, sizeof(buffer));
+		return core::strtol10(buffer);
+	}
+
+	// parses a float without creating a string copy for char readers
+	static float parseFloat(const char_type* value)
+	{
+		if (sizeof(char_type) == 1)
+			return core::fast_atof((const c8*)value);
+
+		c8 buffer[64];
+		toNumberBuffer(value, buffer, sizeof(buffer));
+		return core::fast_atof(buffer);
+	}
+
+	// copies a number from a wide string into a small ascii buffer.
+	// Longer strings than the buffer are never valid numbers anyway.
+	static void toNumberBuffer(const char_type* value, c8* buffer, u32 bufferSize)
+	{
+		u32 i=0;
+		for (; i<bufferSize-1 && value[i]; ++i)
+			buffer[i] = (c8)value[i];
+		buffer[i] = 0;
 	}
 
 
@@ -733,7 +808,7 @@ private:
 
 
 	//! returns true if a character is whitespace
-	inline bool isWhiteSpace(char_type c)
+	inline bool isWhiteSpace(char_type c) const
 	{
 		return (c==' ' || c=='\t' || c=='\n' || c=='\r');
 	}
@@ -756,7 +831,7 @@ private:
 
 
 	//! compares the first n characters of the strings
-	bool equalsn(const char_type* str1, const char_type* str2, int len)
+	bool equalsn(const char_type* str1, const char_type* str2, int len) const
 	{
 		int i;
 		for(i=0; str1[i] && str2[i] && i < len; ++i)
@@ -803,8 +878,12 @@ private:
 	ETEXT_FORMAT SourceFormat;   // source format of the xml file
 	ETEXT_FORMAT TargetFormat;   // output format of this parser
 
-	core::string<char_type> NodeName;    // name of the node currently in - also used for text
-	core::string<char_type> EmptyString; // empty string to be returned by getSafe() methods
+	char_type* NodeName;                 // name of the node currently in - also used for text. Points into the text buffer.
+	mutable bool NodeNameDecoded;        // xml special characters in NodeName have been replaced
+	char_type EmptyString[1];            // empty string to be returned by getSafe() methods
+
+	char_type* RestorePos;     // position which was set to 0 to terminate the current text node
+	char_type RestoreChar;     // original character at RestorePos
 
 	bool IsEmptyElement;       // is the currently parsed node empty?
 
@@ -408,7 +408,9 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 		return false;
 	}
 
-	Buffer = new c8[size];
+	// 0-terminated, so numbers at the end of the buffer can be parsed in place
+	Buffer = new c8[size+1];
+	Buffer[size] = 0;
 
 	//! read all into memory
 	if (file->read(Buffer, size) != static_cast<size_t>(size))
@@ -26,6 +26,7 @@ namespace irr
 		EPID_SM_RENDER_TRANSPARENT,
 		EPID_SM_RENDER_EFFECT,
 		EPID_SM_REGISTER,
+		EPID_SM_SPATIAL_INDEX,
 
 		//! octrees
 		EPID_OC_RENDER,
@@ -14,15 +14,26 @@
 /**
 	Flags for Octree
 */
-//! bypass full invisible/visible test
-#define OCTREE_PARENTTEST
+//! Nodes are not split any further below this depth
+#define OCTREE_MAX_DEPTH 16
 
 namespace irr
 {
 
 //! template octree.
 /** T must be a vertex type which has a member
-called .Pos, which is a core::vertex3df position. */
+called .Pos, which is a core::vertex3df position.
+
+The tree is a loose octree: a triangle is stored in the child which
+contains its center, as long as it doesn't stick out of that child by more
+than half the child size. So less triangles stay in large nodes close to the
+root.
+
+After construction the nodes are stored in depth first order. The indices of
+each mesh chunk are sorted in the same order, so the indices of a node and
+all its children are one continuous range which can be copied at once.
+Node boxes are also kept as structure of arrays, so the children of a node
+are tested against a frustum plane in one loop. */
 template <class T>
 class Octree
 {
@@ -60,7 +71,7 @@ public:
 
 	//! Constructor
 	Octree(const core::array<SMeshChunk>& meshes, s32 minimalPolysPerNode=128) :
-		IndexData(0), IndexDataCount(meshes.size()), NodeCount(0)
+		IndexData(0), IndexDataCount(meshes.size()), NodeCount(0), LastQuery(EOQ_NONE)
 	{
 		IndexData = new SIndexData[IndexDataCount];
 
@@ -82,27 +93,54 @@ public:
 		}
 
 		// create tree
-		Root = new OctreeNode(NodeCount, 0, meshes, indexChunks, minimalPolysPerNode);
+		u32 nodeCount = 0;
+		OctreeNode* root = new OctreeNode(nodeCount, 0, meshes, indexChunks, minimalPolysPerNode);
+		flatten(root, nodeCount);
+		delete root;
 	}
 
 	//! returns all ids of polygons partially or fully enclosed
 	//! by this bounding box.
-	void calculatePolys(const core::aabbox3d<f32>& box)
+	/** \return false if the result is still the one of the last call */
+	bool calculatePolys(const core::aabbox3d<f32>& box)
 	{
-		for (u32 i=0; i!=IndexDataCount; ++i)
-			IndexData[i].CurrentSize = 0;
+		if (LastQuery == EOQ_BOX && LastBox == box)
+			return false;
+
+		LastQuery = EOQ_BOX;
+		LastBox = box;
 
-		Root->getPolys(box, IndexData, 0);
+		beginQuery();
+		if (NodeCount)
+			getPolys(box, 0);
+		endQuery();
+		return true;
 	}
 
 	//! returns all ids of polygons partially or fully enclosed
 	//! by a view frustum.
-	void calculatePolys(const scene::SViewFrustum& frustum)
+	/** \return false if the result is still the one of the last call,
+	which happens when neither the camera nor the node moved. */
+	bool calculatePolys(const scene::SViewFrustum& frustum)
 	{
-		for (u32 i=0; i!=IndexDataCount; ++i)
-			IndexData[i].CurrentSize = 0;
+		if (LastQuery == EOQ_FRUSTUM && isSameFrustum(frustum))
+			return false;
+
+		LastQuery = EOQ_FRUSTUM;
+		for (u32 i=0; i!=scene::SViewFrustum::VF_PLANE_COUNT; ++i)
+			LastPlanes[i] = frustum.planes[i];
 
-		Root->getPolys(frustum, IndexData, 0);
+		beginQuery();
+		if (NodeCount)
+		{
+			// the root is child slot 0
+			u32 rootPlanes;
+			const u32 allPlanes = (1 << scene::SViewFrustum::VF_PLANE_COUNT) - 1;
+			if (!classifyChildren(0, 1, frustum, allPlanes, &rootPlanes))
+				getPolys(frustum, 0, rootPlanes);
+		}
+		endQuery();
+		return true;
 	}
 
 	const SIndexData* getIndexData() const
@@ -124,7 +162,8 @@ public:
 	void getBoundingBoxes(const core::aabbox3d<f32>& box,
 		core::array< const core::aabbox3d<f32>* >&outBoxes) const
 	{
-		Root->getBoundingBoxes(box, outBoxes);
+		if (NodeCount)
+			getBoundingBoxes(box, outBoxes, 0);
 	}
 
 	//! destructor
@@ -134,11 +173,10 @@ public:
 			delete [] IndexData[i].Indices;
 
 		delete [] IndexData;
-		delete Root;
 	}
 
 private:
-	// private inner class
+	// private inner class, only used to build the tree
 	class OctreeNode
 	{
 	public:
@@ -199,14 +237,19 @@ private:
 
 			// calculate all children
 			core::aabbox3d<f32> box;
+			core::aabbox3d<f32> looseBox;
 			core::array<u16> keepIndices;
 
-			if (totalPrimitives > minimalPolysPerNode && !Box.isEmpty())
+			if (totalPrimitives > minimalPolysPerNode && !Box.isEmpty() && Depth < OCTREE_MAX_DEPTH)
 			for (u32 ch=0; ch!=8; ++ch)
 			{
 				box.reset(middle);
 				box.addInternalPoint(edges[ch]);
 
+				const core::vector3df halfExtent = box.getExtent() * 0.5f;
+				looseBox.MinEdge = box.MinEdge - halfExtent;
+				looseBox.MaxEdge = box.MaxEdge + halfExtent;
+
 				// create indices for child
 				bool added = false;
 				core::array<SIndexChunk>* cindexChunks = new core::array<SIndexChunk>;
@@ -219,9 +262,14 @@ private:
 
 					for (u32 t=0; t<(*indices)[i].Indices.size(); t+=3)
 					{
-						if (box.isPointInside(allmeshdata[i].Vertices[(*indices)[i].Indices[t]].Pos) &&
-							box.isPointInside(allmeshdata[i].Vertices[(*indices)[i].Indices[t+1]].Pos) &&
-							box.isPointInside(allmeshdata[i].Vertices[(*indices)[i].Indices[t+2]].Pos))
+						const core::vector3df& a = allmeshdata[i].Vertices[(*indices)[i].Indices[t]].Pos;
+						const core::vector3df& b = allmeshdata[i].Vertices[(*indices)[i].Indices[t+1]].Pos;
+						const core::vector3df& c = allmeshdata[i].Vertices[(*indices)[i].Indices[t+2]].Pos;
+
+						if (box.isPointInside((a+b+c)/3.f) &&
+							looseBox.isPointInside(a) &&
+							looseBox.isPointInside(b) &&
+							looseBox.isPointInside(c))
 						{
 							tic.Indices.push_back((*indices)[i].Indices[t]);
 							tic.Indices.push_back((*indices)[i].Indices[t+1]);
@@ -262,118 +310,293 @@ private:
 				delete Children[i];
 		}
 
-		// returns all ids of polygons partially or full enclosed
-		// by this bounding box.
-		void getPolys(const core::aabbox3d<f32>& box, SIndexData* idxdata, u32 parentTest ) const
+		core::aabbox3df Box;
+		core::array<SIndexChunk>* IndexData;
+		OctreeNode* Children[8];
+		u32 Depth;
+	};
+
+	enum E_OCTREE_QUERY
+	{
+		EOQ_NONE,
+		EOQ_BOX,
+		EOQ_FRUSTUM
+	};
+
+	//! stores the tree in depth first order
+	void flatten(const OctreeNode* root, u32 nodeCount)
+	{
+		Boxes.reallocate(nodeCount);
+		SubtreeEnd.reallocate(nodeCount);
+		FirstChild.reallocate(nodeCount);
+		ChildCount.reallocate(nodeCount);
+		IndexStart.reallocate((nodeCount+1) * IndexDataCount);
+		Indices.reallocate(IndexDataCount);
+		for (u32 m=0; m<IndexDataCount; ++m)
+			Indices.push_back(core::array<u16>());
+		PendingBegin.set_used(IndexDataCount);
+		PendingEnd.set_used(IndexDataCount);
+
+		addChildSlot(root->Box, 0);
+		addNode(root);
+
+		// end of the ranges of the last node
+		for (u32 m=0; m<IndexDataCount; ++m)
+			IndexStart.push_back(Indices[m].size());
+
+		NodeCount = Boxes.size();
+	}
+
+	//! adds a node and its children, returns the node index
+	u32 addNode(const OctreeNode* node)
+	{
+		const u32 n = Boxes.size();
+		Boxes.push_back(node->Box);
+		SubtreeEnd.push_back(0);
+		FirstChild.push_back(0);
+		ChildCount.push_back(0);
+
+		for (u32 m=0; m<IndexDataCount; ++m)
 		{
-#if defined (OCTREE_PARENTTEST )
-			// if not full inside
-			if ( parentTest != 2 )
+			IndexStart.push_back(Indices[m].size());
+
+			if (node->IndexData && m < node->IndexData->size())
 			{
-				// partially inside ?
-				if (!Box.intersectsWithBox(box))
-					return;
+				const core::array<u16>& src = (*node->IndexData)[m].Indices;
+				for (u32 i=0; i<src.size(); ++i)
+					Indices[m].push_back(src[i]);
+			}
+		}
+
+		u32 children[8];
+		u32 count = 0;
+		for (u32 ch=0; ch!=8; ++ch)
+		{
+			if (node->Children[ch])
+				children[count++] = addNode(node->Children[ch]);
+		}
 
-				// fully inside ?
-				parentTest = Box.isFullInside(box)?2:1;
+		// children of a node get consecutive slots, so they are tested together
+		FirstChild[n] = SlotNode.size();
+		ChildCount[n] = count;
+		for (u32 i=0; i<count; ++i)
+			addChildSlot(Boxes[children[i]], children[i]);
+
+		SubtreeEnd[n] = Boxes.size();
+		return n;
+	}
+
+	void addChildSlot(const core::aabbox3df& box, u32 node)
+	{
+		SlotNode.push_back(node);
+		SlotMinX.push_back(box.MinEdge.X);
+		SlotMinY.push_back(box.MinEdge.Y);
+		SlotMinZ.push_back(box.MinEdge.Z);
+		SlotMaxX.push_back(box.MaxEdge.X);
+		SlotMaxY.push_back(box.MaxEdge.Y);
+		SlotMaxZ.push_back(box.MaxEdge.Z);
+	}
+
+	//! Classifies consecutive child slots against the frustum planes in planeMask.
+	/** \return A bit for every box which is outside of the frustum.
+	clipMasks receives the planes which still cut each box, boxes without
+	any plane left are fully inside. */
+	u32 classifyChildren(u32 first, u32 count, const scene::SViewFrustum& frustum,
+		u32 planeMask, u32* clipMasks) const
+	{
+		f32 nearDist[8];
+		f32 farDist[8];
+		u32 outside = 0;
+		u32 k;
+
+		for (k=0; k<count; ++k)
+			clipMasks[k] = 0;
+
+		for (u32 p=0; p!=scene::SViewFrustum::VF_PLANE_COUNT; ++p)
+		{
+			if (!(planeMask & (1 << p)))
+				continue;
+
+			const core::plane3df& plane = frustum.planes[p];
+
+			// corners furthest behind and in front of the plane
+			const f32* nearX = plane.Normal.X > 0.f ? &SlotMinX[first] : &SlotMaxX[first];
+			const f32* nearY = plane.Normal.Y > 0.f ? &SlotMinY[first] : &SlotMaxY[first];
+			const f32* nearZ = plane.Normal.Z > 0.f ? &SlotMinZ[first] : &SlotMaxZ[first];
+			const f32* farX = plane.Normal.X > 0.f ? &SlotMaxX[first] : &SlotMinX[first];
+			const f32* farY = plane.Normal.Y > 0.f ? &SlotMaxY[first] : &SlotMinY[first];
+			const f32* farZ = plane.Normal.Z > 0.f ? &SlotMaxZ[first] : &SlotMinZ[first];
+
+			// no dependencies between the boxes, so this loop vectorizes
+			for (k=0; k<count; ++k)
+			{
+				nearDist[k] = plane.Normal.X*nearX[k] + plane.Normal.Y*nearY[k] + plane.Normal.Z*nearZ[k] + plane.D;
+				farDist[k] = plane.Normal.X*farX[k] + plane.Normal.Y*farY[k] + plane.Normal.Z*farZ[k] + plane.D;
 			}
-#else
-			if (Box.intersectsWithBox(box))
-#endif
+
+			for (k=0; k<count; ++k)
 			{
-				const u32 cnt = IndexData->size();
-				u32 i; // new ISO for scoping problem in some compilers
+				if (nearDist[k] > 0.f)
+					outside |= 1 << k;
+				else if (farDist[k] > 0.f)
+					clipMasks[k] |= 1 << p;
+			}
+		}
 
-				for (i=0; i<cnt; ++i)
-				{
-					const s32 idxcnt = (*IndexData)[i].Indices.size();
+		return outside;
+	}
 
-					if (idxcnt)
-					{
-						memcpy(&idxdata[i].Indices[idxdata[i].CurrentSize],
-							&(*IndexData)[i].Indices[0], idxcnt * sizeof(s16));
-						idxdata[i].CurrentSize += idxcnt;
-					}
-				}
+	//! adds the polygons of a visible node, planeMask are the planes which still cut it
+	void getPolys(const scene::SViewFrustum& frustum, u32 node, u32 planeMask)
+	{
+		// fully inside, no further checks for the children needed
+		if (!planeMask)
+		{
+			addRange(node, SubtreeEnd[node]);
+			return;
+		}
 
-				for (i=0; i!=8; ++i)
-					if (Children[i])
-						Children[i]->getPolys(box, idxdata,parentTest);
-			}
+		addRange(node, node+1);
+
+		const u32 first = FirstChild[node];
+		const u32 count = ChildCount[node];
+		if (!count)
+			return;
+
+		u32 clipMasks[8];
+		const u32 outside = classifyChildren(first, count, frustum, planeMask, clipMasks);
+
+		for (u32 k=0; k<count; ++k)
+		{
+			if (!(outside & (1 << k)))
+				getPolys(frustum, SlotNode[first+k], clipMasks[k]);
 		}
+	}
+
+	//! adds the polygons of all nodes which intersect a box
+	void getPolys(const core::aabbox3d<f32>& box, u32 node)
+	{
+		const core::aabbox3df& nodeBox = Boxes[node];
+		if (!nodeBox.intersectsWithBox(box))
+			return;
 
-		// returns all ids of polygons partially or full enclosed
-		// by the view frustum.
-		void getPolys(const scene::SViewFrustum& frustum, SIndexData* idxdata,u32 parentTest) const
+		if (nodeBox.isFullInside(box))
 		{
-			u32 i; // new ISO for scoping problem in some compilers
+			addRange(node, SubtreeEnd[node]);
+			return;
+		}
 
-			// if parent is fully inside, no further check for the children is needed
-#if defined (OCTREE_PARENTTEST )
-			if ( parentTest != 2 )
-#endif
-			{
-#if defined (OCTREE_PARENTTEST )
-				parentTest = 2;
-#endif
-				for (i=0; i!=scene::SViewFrustum::VF_PLANE_COUNT; ++i)
-				{
-					core::EIntersectionRelation3D r = Box.classifyPlaneRelation(frustum.planes[i]);
-					if ( r == core::ISREL3D_FRONT )
-						return;
-#if defined (OCTREE_PARENTTEST )
-					if ( r == core::ISREL3D_CLIPPED )
-						parentTest = 1;	// must still check children
-#endif
-				}
-			}
+		addRange(node, node+1);
 
+		const u32 end = FirstChild[node] + ChildCount[node];
+		for (u32 s=FirstChild[node]; s<end; ++s)
+			getPolys(box, SlotNode[s]);
+	}
 
-			const u32 cnt = IndexData->size();
+	void getBoundingBoxes(const core::aabbox3d<f32>& box,
+		core::array< const core::aabbox3d<f32>* >&outBoxes, u32 node) const
+	{
+		if (Boxes[node].intersectsWithBox(box))
+		{
+			outBoxes.push_back(&Boxes[node]);
 
-			for (i=0; i!=cnt; ++i)
-			{
-				s32 idxcnt = (*IndexData)[i].Indices.size();
+			const u32 end = FirstChild[node] + ChildCount[node];
+			for (u32 s=FirstChild[node]; s<end; ++s)
+				getBoundingBoxes(box, outBoxes, SlotNode[s]);
+		}
+	}
 
-				if (idxcnt)
-				{
-					memcpy(&idxdata[i].Indices[idxdata[i].CurrentSize],
-						&(*IndexData)[i].Indices[0], idxcnt * sizeof(s16));
-					idxdata[i].CurrentSize += idxcnt;
-				}
-			}
+	bool isSameFrustum(const scene::SViewFrustum& frustum) const
+	{
+		for (u32 i=0; i!=scene::SViewFrustum::VF_PLANE_COUNT; ++i)
+		{
+			if (LastPlanes[i].Normal != frustum.planes[i].Normal ||
+				LastPlanes[i].D != frustum.planes[i].D)
+				return false;
+		}
+		return true;
+	}
 
-			for (i=0; i!=8; ++i)
-				if (Children[i])
-					Children[i]->getPolys(frustum, idxdata,parentTest);
+	void beginQuery()
+	{
+		for (u32 m=0; m!=IndexDataCount; ++m)
+		{
+			IndexData[m].CurrentSize = 0;
+			PendingBegin[m] = 0;
+			PendingEnd[m] = 0;
 		}
+	}
 
-		//! for debug purposes only, collects the bounding boxes of the node
-		void getBoundingBoxes(const core::aabbox3d<f32>& box,
-			core::array< const core::aabbox3d<f32>* >&outBoxes) const
+	void endQuery()
+	{
+		for (u32 m=0; m!=IndexDataCount; ++m)
+			flush(m);
+	}
+
+	//! adds the indices of the nodes first to end-1
+	/** Neighbouring ranges are merged and copied together later. */
+	void addRange(u32 first, u32 end)
+	{
+		const u32* begins = &IndexStart[first * IndexDataCount];
+		const u32* ends = &IndexStart[end * IndexDataCount];
+
+		for (u32 m=0; m!=IndexDataCount; ++m)
 		{
-			if (Box.intersectsWithBox(box))
-			{
-				outBoxes.push_back(&Box);
+			if (begins[m] == ends[m])
+				continue;
 
-				for (u32 i=0; i!=8; ++i)
-					if (Children[i])
-						Children[i]->getBoundingBoxes(box, outBoxes);
+			if (begins[m] != PendingEnd[m])
+			{
+				flush(m);
+				PendingBegin[m] = begins[m];
 			}
+			PendingEnd[m] = ends[m];
 		}
+	}
 
-	private:
-
-		core::aabbox3df Box;
-		core::array<SIndexChunk>* IndexData;
-		OctreeNode* Children[8];
-		u32 Depth;
-	};
+	void flush(u32 m)
+	{
+		const u32 count = PendingEnd[m] - PendingBegin[m];
+		if (count)
+		{
+			memcpy(&IndexData[m].Indices[IndexData[m].CurrentSize],
+				Indices[m].const_pointer() + PendingBegin[m], count * sizeof(u16));
+			IndexData[m].CurrentSize += count;
+		}
+		PendingBegin[m] = PendingEnd[m];
+	}
 
-	OctreeNode* Root;
 	SIndexData* IndexData;
 	u32 IndexDataCount;
 	u32 NodeCount;
+
+	// nodes in depth first order
+	core::array<core::aabbox3df> Boxes;
+	core::array<u32> SubtreeEnd;
+	core::array<u32> FirstChild;
+	core::array<u32> ChildCount;
+
+	// indices of each mesh chunk sorted by node, and where each node starts
+	core::array< core::array<u16> > Indices;
+	core::array<u32> IndexStart;
+
+	// child slots, the boxes as structure of arrays
+	core::array<u32> SlotNode;
+	core::array<f32> SlotMinX;
+	core::array<f32> SlotMinY;
+	core::array<f32> SlotMinZ;
+	core::array<f32> SlotMaxX;
+	core::array<f32> SlotMaxY;
+	core::array<f32> SlotMaxZ;
+
+	// range of each mesh chunk which is not copied yet
+	core::array<u32> PendingBegin;
+	core::array<u32> PendingEnd;
+
+	// last query, its result is still in IndexData
+	E_OCTREE_QUERY LastQuery;
+	core::aabbox3df LastBox;
+	core::plane3df LastPlanes[scene::SViewFrustum::VF_PLANE_COUNT];
 };
 
 } // end namespace
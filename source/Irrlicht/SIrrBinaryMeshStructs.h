@@ -0,0 +1,95 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Layout of binary .irrbin mesh files, shared by CIrrBinaryMeshFileLoader and CIrrBinaryMeshWriter.
+//
+// The file starts with a SIrrBinaryMeshHeader followed by PayloadSize bytes. The payload is
+// zlib compressed when IRRBIN_FLAG_COMPRESSED is set. Uncompressed it contains little endian
+// 32 bit words:
+//   string table: StringCount byte offsets into the string data, followed by
+//                 StringDataSize bytes of zero terminated utf-8 strings (padded to 4 bytes)
+//   mesh data:    DataSize words
+//
+// mesh data:
+//   E_ANIMATED_MESH_TYPE, skinned flag (0 or 1), animation speed
+//   bounding box (6 floats)
+//   mesh buffer count, followed by one mesh buffer record per buffer
+//   for skinned meshes: joint count, followed by one joint record per joint
+//
+// mesh buffer record:
+//   material attribute block (as created by IVideoDriver::createAttributesFromMaterial)
+//   E_VERTEX_TYPE, E_INDEX_TYPE, E_PRIMITIVE_TYPE
+//   E_HARDWARE_MAPPING for vertices and for indices
+//   vertex count, index count, bounding box (6 floats)
+//   for skinned meshes: transformation (16 floats)
+//   vertices as they are laid out in memory (S3DVertex, S3DVertex2TCoords or S3DVertexTangents)
+//   indices as they are laid out in memory, 16 bit indices padded to full words
+//
+// joint record:
+//   name (string index), local matrix, global inversed matrix, offset matrix (16 floats each)
+//   child count, followed by joint indices
+//   attached mesh count, followed by mesh buffer indices
+//   position key count, followed by keys (frame, x, y, z)
+//   scale key count, followed by keys (frame, x, y, z)
+//   rotation key count, followed by keys (frame, x, y, z, w)
+//   weight count, followed by weights (buffer id, vertex id, strength)
+//
+// Attribute blocks are written by io::CIrrBinaryWriter, see CIrrBinaryAttributes.h.
+
+#ifndef __S_IRR_BINARY_MESH_STRUCTS_H_INCLUDED__
+#define __S_IRR_BINARY_MESH_STRUCTS_H_INCLUDED__
+
+#include "irrTypes.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! First word in every binary mesh file
+const u32 IRRBIN_MESH_MAGIC = MAKE_IRR_ID('i','r','b','n');
+
+//! Increase whenever the layout changes
+const u32 IRRBIN_MESH_VERSION = 2;
+
+//! Flags in SIrrBinaryMeshHeader::Flags
+enum E_IRRBIN_MESH_FLAGS
+{
+	//! Payload is zlib compressed
+	IRRBIN_FLAG_COMPRESSED = 0x1
+};
+
+//! Header at the beginning of binary mesh files
+struct SIrrBinaryMeshHeader
+{
+	u32 Magic;
+	u32 Version;
+
+	//! Combination of E_IRRBIN_MESH_FLAGS
+	u32 Flags;
+
+	//! Size of the file the mesh was loaded from, 0 if unknown. Used to detect outdated mesh caches.
+	u32 SourceSize;
+
+	//! FNV-1a hash of the content of the file the mesh was loaded from, 0 if unknown.
+	u32 SourceHash;
+
+	//! Number of strings in the string table
+	u32 StringCount;
+
+	//! Size of the string data behind the string offsets in bytes
+	u32 StringDataSize;
+
+	//! Size of the mesh data in words
+	u32 DataSize;
+
+	//! Size of the payload in the file in bytes
+	u32 PayloadSize;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
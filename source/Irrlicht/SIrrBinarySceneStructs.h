@@ -0,0 +1,64 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Layout of binary .irrb scene files, shared by CSceneLoaderIrrBinary and CSceneWriterIrrBinary.
+//
+// The file is a sequence of little endian 32 bit words:
+//   SIrrBinarySceneHeader
+//   string table: StringCount byte offsets into the string data, followed by
+//                 StringDataSize bytes of zero terminated utf-8 strings (padded to 4 bytes)
+//   node data:    one node record for the scene root
+//
+// node record:
+//   type name (string index, IRR_BINARY_NO_STRING for the scene root)
+//   attribute block with the node attributes
+//   material count, followed by one attribute block per material
+//   animator count, followed by one attribute block per animator (containing "Type")
+//   user data flag (0 or 1), followed by an attribute block if set
+//   child count, followed by one node record per child
+//
+// Attribute blocks are written by io::CIrrBinaryWriter, see CIrrBinaryAttributes.h.
+
+#ifndef __S_IRR_BINARY_SCENE_STRUCTS_H_INCLUDED__
+#define __S_IRR_BINARY_SCENE_STRUCTS_H_INCLUDED__
+
+#include "irrTypes.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! First word in every binary scene file
+const u32 IRRB_SCENE_MAGIC = MAKE_IRR_ID('i','r','r','b');
+
+//! Increase whenever the layout changes
+const u32 IRRB_SCENE_VERSION = 1;
+
+//! Header at the beginning of binary scene files
+struct SIrrBinarySceneHeader
+{
+	u32 Magic;
+	u32 Version;
+
+	//! Number of strings in the string table
+	u32 StringCount;
+
+	//! Byte offset of the string table from the start of the file
+	u32 StringTableOffset;
+
+	//! Size of the string data behind the string offsets in bytes
+	u32 StringDataSize;
+
+	//! Byte offset of the root node record from the start of the file
+	u32 NodeDataOffset;
+
+	//! Size of all node records in words
+	u32 NodeDataSize;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -67,6 +67,109 @@ private:
 
 };
 
+/** Test that moving many nodes at once with animateCollisionResponses gives the
+	same positions as animating them one after another, and that a meta selector
+	only skips selectors which have no triangles in the queried box. */
+static bool batchedCollisionResponse(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL);
+	assert_log(device);
+	if(!device)
+		return false;
+
+	ISceneManager * smgr = device->getSceneManager();
+	IMetaTriangleSelector * world = smgr->createMetaTriangleSelector();
+
+	// a floor with a grid of pillars
+	IMeshSceneNode * floor = smgr->addCubeSceneNode(1.f, 0, -1, vector3df(100, -5, 100), vector3df(0, 0, 0), vector3df(220, 1, 220));
+	ITriangleSelector * selector = smgr->createTriangleSelector(floor->getMesh(), floor);
+	world->addTriangleSelector(selector);
+	selector->drop();
+
+	for (s32 x=0; x<10; ++x)
+		for (s32 z=0; z<10; ++z)
+		{
+			IMeshSceneNode * pillar = smgr->addCubeSceneNode(8.f, 0, -1, vector3df(x*20.f, 0, z*20.f));
+			selector = smgr->createTriangleSelector(pillar->getMesh(), pillar);
+			world->addTriangleSelector(selector);
+			selector->drop();
+		}
+
+	smgr->drawAll();
+
+	bool result = true;
+
+	// the broadphase must find the same triangles as asking every selector
+	array<triangle3df> triangles;
+	triangles.set_used(world->getTriangleCount());
+	for (s32 i=0; i<20; ++i)
+	{
+		const aabbox3df box(vector3df(i*9.f, -3, i*7.f), vector3df(i*9.f+15.f, 3, i*7.f+25.f));
+		s32 found = 0;
+		world->getTriangles(triangles.pointer(), triangles.size(), found, box);
+
+		s32 expected = 0;
+		for (u32 j=0; j<world->getSelectorCount(); ++j)
+		{
+			s32 count = 0;
+			world->getSelector(j)->getTriangles(triangles.pointer(), triangles.size(), count, box);
+			expected += count;
+		}
+		result &= (found == expected);
+	}
+
+	// two equal groups of nodes, one is moved one by one, the other at once
+	array<ISceneNode*> nodes[2];
+	array<ISceneNodeAnimatorCollisionResponse*> animators[2];
+	for (u32 g=0; g<2; ++g)
+	{
+		for (s32 i=0; i<40; ++i)
+		{
+			ISceneNode * node = smgr->addEmptySceneNode();
+			node->setPosition(vector3df((i%8)*23.f+5.f, 8.f, (i/8)*31.f+3.f));
+			nodes[g].push_back(node);
+			animators[g].push_back(smgr->createCollisionResponseAnimator(world, node,
+				vector3df(3, 5, 3), vector3df(0, -50.f, 0)));
+		}
+	}
+
+	for (u32 step=1; step<=30; ++step)
+	{
+		const u32 time = 1000 + step*20;
+		for (u32 i=0; i<nodes[0].size(); ++i)
+		{
+			const vector3df move((f32)(i%3)-1.f, 0, (f32)(i%5)*0.5f);
+			nodes[0][i]->setPosition(nodes[0][i]->getPosition() + move);
+			nodes[1][i]->setPosition(nodes[1][i]->getPosition() + move);
+			animators[0][i]->animateNode(nodes[0][i], time);
+		}
+		smgr->getSceneCollisionManager()->animateCollisionResponses(animators[1], time);
+
+		for (u32 i=0; i<nodes[0].size(); ++i)
+			result &= nodes[0][i]->getPosition() == nodes[1][i]->getPosition()
+				&& animators[0][i]->isFalling() == animators[1][i]->isFalling();
+	}
+
+	// the floor stops the nodes
+	for (u32 i=0; i<nodes[1].size(); ++i)
+		result &= nodes[1][i]->getPosition().Y > -5.f;
+
+	for (u32 g=0; g<2; ++g)
+		for (u32 i=0; i<animators[g].size(); ++i)
+			animators[g][i]->drop();
+	world->drop();
+
+	if (!result)
+		logTestString("Batched collision response differs from single animators.\n");
+	assert_log(result);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 /** Test that collision response animator will reset itself when removed from a
 	scene node, so that the scene node can then be moved without the animator
 	jumping it back again. */
@@ -193,6 +296,7 @@ bool collisionResponseAnimator(void)
 	device->drop();
 
 	result &= expectedCollisionCallbackPositions;
+	result &= batchedCollisionResponse();
 	return result;
 }
 
@@ -281,10 +281,144 @@ bool test_strtol(void)
 	return true;
 }
 
+//! Compare fast_atof() with atof() for many random numbers in the formats found in mesh files.
+static bool test_fast_atof_random(void)
+{
+	const char* formats[] = { "%f", "%.9g", "%.17g", "%.4e" };
+	u32 failed = 0;
+	c8 buffer[64];
+
+	srand(42);
+	for (u32 i=0; i<200000; ++i)
+	{
+		const f64 scale = pow(10.0, (f64)(rand()%60 - 30));
+		const f64 value = ((f64)rand() / RAND_MAX - 0.5) * scale;
+		snprintf_irr(buffer, sizeof(buffer), formats[i%4], value);
+
+		const f32 fastValue = fast_atof(buffer);
+		const f32 atofValue = (f32)atof(buffer);
+		// atof() rounds to double first, so it may be a bit away itself
+		if (!equalsByUlp(fastValue, atofValue, 1))
+		{
+			if (failed < 10)
+				logTestString("String '%s' fast_atof %.9g atof %.9g\n", buffer, fastValue, atofValue);
+			++failed;
+		}
+	}
+
+	if (failed)
+		logTestString("*** ERROR - fast_atof differs from atof for %u numbers ***\n\n", failed);
+
+	return failed == 0;
+}
+
+//! Test the in place tokenizer helpers.
+static bool test_tokenizer(void)
+{
+	const c8* text = "v  1.5 -2\t3e2 x 4\r\n\nf 1/2/3";
+	const c8* const end = text + strlen(text);
+	bool result = true;
+
+	const c8* p = skipToken(text, end);
+	f32 values[5];
+	for (u32 i=0; i<5; ++i)
+		p = fast_atof_token(p, end, values[i], false);
+	result &= values[0] == 1.5f && values[1] == -2.f && values[2] == 300.f;
+	result &= values[3] == 0.f && values[4] == 4.f;
+	// missing values on a line are 0, and don't move to the next line
+	f32 missing = 1.f;
+	p = fast_atof_token(p, end, missing, false);
+	result &= missing == 0.f && *p == '\r';
+
+	p = skipWhitespace(p, end);
+	result &= equalsToken(p, end, "f") && !equalsToken(p, end, "fa") && !equalsToken(p+2, end, "1");
+	result &= findLineEnd(p, end) == end;
+	result &= skipToken(p+2, end) == end;
+
+	// ends which aren't 0-terminated
+	result &= skipWhitespace(text+1, text+2) == text+2;
+	result &= skipToken(text, text+1) == text+1;
+
+	// overflow detection must not be fooled by wrapped values
+	result &= strtoul10("4294967295") == 0xffffffff;
+	result &= strtoul10("5000000000") == 0xffffffff;
+	result &= strtoul10("42949672950") == 0xffffffff;
+
+	if (!result)
+		logTestString("*** ERROR - tokenizer failed ***\n\n");
+
+	return result;
+}
+
+//! Load a large generated obj file from memory, to check the loader and to measure throughput.
+static bool test_obj_throughput(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return false;
+
+#ifdef _DEBUG
+	const u32 VERTEX_COUNT = 100000;
+#else
+	const u32 VERTEX_COUNT = 2000000;
+#endif
+
+	// vertices with mixed formatting and line endings, and a single face referencing some of them
+	core::array<c8> obj;
+	obj.reallocate(VERTEX_COUNT*40);
+	c8 line[128];
+	for (u32 i=0; i<VERTEX_COUNT; ++i)
+	{
+		// all values are exact in the text, so they can be compared after loading
+		const s32 length = snprintf_irr(line, sizeof(line), (i&1) ? "v %f %.9g %.3e\n" : "v  %f\t%.9g %.3e \r\n",
+			(f64)i, -(i*0.25), (i%1000)*0.5);
+		for (s32 c=0; c<length; ++c)
+			obj.push_back(line[c]);
+	}
+	const s32 faceLength = snprintf_irr(line, sizeof(line), "vn 0 1 0\nvt 0.5 0.25\nf 1/1/1 %u//1 -1/1/1\n", VERTEX_COUNT/2+1);
+	for (s32 c=0; c<faceLength; ++c)
+		obj.push_back(line[c]);
+
+	io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(obj.const_pointer(), obj.size(), "throughput.obj");
+	ITimer* timer = device->getTimer();
+	const u32 then = timer->getRealTime();
+	scene::IAnimatedMesh* mesh = device->getSceneManager()->getMesh(file);
+	const u32 loadTime = timer->getRealTime() - then;
+	file->drop();
+
+	logTestString("Loading obj file with %u vertices (%u bytes) took %u ms\n", VERTEX_COUNT, obj.size(), loadTime);
+
+	bool result = mesh && mesh->getMeshBufferCount() == 1 && mesh->getMeshBuffer(0)->getVertexCount() == 3;
+	if (result)
+	{
+		// handedness is changed by the loader
+		const scene::IMeshBuffer* mb = mesh->getMeshBuffer(0);
+		const u32 mid = VERTEX_COUNT/2;
+		const u32 last = VERTEX_COUNT-1;
+		result &= mb->getPosition(0) == core::vector3df(0.f, 0.f, 0.f);
+		result &= mb->getPosition(1) == core::vector3df(-(f32)mid, -(mid*0.25f), (mid%1000)*0.5f);
+		result &= mb->getPosition(2) == core::vector3df(-(f32)last, -(last*0.25f), (last%1000)*0.5f);
+		result &= mb->getNormal(0) == core::vector3df(0.f, 1.f, 0.f);
+		result &= mb->getTCoords(1) == core::vector2df(0.f, 0.f);
+		result &= mb->getTCoords(2) == core::vector2df(0.5f, 0.75f);
+	}
+	if (!result)
+		logTestString("*** ERROR - generated obj file not loaded correctly ***\n\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 bool fast_atof(void)
 {
 	bool ok = true;
 	ok &= test_fast_atof() ;
+	ok &= test_fast_atof_random();
+	ok &= test_tokenizer();
 	ok &= test_strtol();
+	ok &= test_obj_throughput();
 	return ok;
 }
@@ -0,0 +1,193 @@
+#include "testUtils.h"
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+
+namespace
+{
+
+s32 getStat(video::IVideoDriver* driver, const c8* name)
+{
+	return driver->getDriverAttributes().getAttributeAsInt(name);
+}
+
+// A triangle which wants to be stored in a hardware buffer
+scene::SMeshBuffer* createTriangle()
+{
+	scene::SMeshBuffer* mb = new scene::SMeshBuffer();
+	mb->Vertices.push_back(video::S3DVertex(-1,-1,0, 0,0,-1, video::SColor(255,255,255,255), 0,1));
+	mb->Vertices.push_back(video::S3DVertex(0,1,0, 0,0,-1, video::SColor(255,255,255,255), 0.5f,0));
+	mb->Vertices.push_back(video::S3DVertex(1,-1,0, 0,0,-1, video::SColor(255,255,255,255), 1,1));
+	mb->Indices.push_back(0);
+	mb->Indices.push_back(1);
+	mb->Indices.push_back(2);
+	mb->recalculateBoundingBox();
+	mb->setHardwareMappingHint(scene::EHM_STATIC);
+	return mb;
+}
+
+// Draws the buffer in a frame of the driver and returns the lookups which searched
+s32 drawFrame(video::IVideoDriver* driver, scene::IMeshBuffer* mb, u32 draws)
+{
+	// each device has its own context, activate it for the hardware buffers
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0),
+		1.f, 0, driver->getExposedVideoData());
+	driver->setMaterial(mb->getMaterial());
+	driver->setTransform(video::ETS_WORLD, matrix4());
+	for (u32 i=0; i<draws; ++i)
+		driver->drawMeshBuffer(mb);
+	driver->endScene();
+	return getStat(driver, "BufferLinkSearches");
+}
+
+// Removes the hardware buffer with the context of the driver active
+void removeBuffer(video::IVideoDriver* driver, scene::IMeshBuffer* mb)
+{
+	driver->beginScene(0, video::SColor(255,0,0,0), 1.f, 0, driver->getExposedVideoData());
+	driver->removeHardwareBuffer(mb);
+	driver->endScene();
+}
+
+// The meshbuffer stores the link of the driver, so drawing it needs no search
+bool testBufferLink(video::E_DRIVER_TYPE driverType)
+{
+	IrrlichtDevice* device = createDevice(driverType, dimension2du(160, 120));
+	if (!device)
+		return true; // No error if device does not exist
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->setMinHardwareBufferVertexCount(0);
+	// only drivers with vertex buffer objects create links
+	const bool links = driverType != video::EDT_NULL &&
+		driver->queryFeature(video::EVDF_VERTEX_BUFFER_OBJECT);
+
+	scene::SMeshBuffer* mb = createTriangle();
+
+	bool result = drawFrame(driver, mb, 3) == 0;
+	result &= getStat(driver, "BufferLinkLookups") == 3;
+	result &= (mb->getHWBufferLink() != 0) == links;
+
+	// the same link is used in the next frame
+	void* link = mb->getHWBufferLink();
+	result &= drawFrame(driver, mb, 2) == 0;
+	result &= getStat(driver, "BufferLinkLookups") == 2;
+	result &= mb->getHWBufferLink() == link;
+
+	// buffers without a mapping hint are not looked up
+	mb->setHardwareMappingHint(scene::EHM_NEVER);
+	result &= drawFrame(driver, mb, 2) == 0;
+	result &= getStat(driver, "BufferLinkLookups") == 0;
+	mb->setHardwareMappingHint(scene::EHM_STATIC);
+
+	removeBuffer(driver, mb);
+	result &= mb->getHWBufferLink() == 0;
+
+	// a new link is created and removed with all others
+	result &= drawFrame(driver, mb, 1) == 0;
+	result &= (mb->getHWBufferLink() != 0) == links;
+	driver->removeAllHardwareBuffers();
+	result &= mb->getHWBufferLink() == 0;
+
+	if (!result)
+		logTestString("Hardware buffer links of %ls failed.\n", driver->getName());
+
+	mb->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	assert_log(result);
+
+	return result;
+}
+
+// Only one driver can store its link in the meshbuffer, the other one searches its own links
+bool testSharedBuffer()
+{
+	IrrlichtDevice* device1 = createDevice(video::EDT_OPENGL, dimension2du(160, 120));
+	if (!device1)
+		return true; // No error if device does not exist
+	IrrlichtDevice* device2 = createDevice(video::EDT_OPENGL, dimension2du(160, 120));
+	if (!device2)
+	{
+		device1->closeDevice();
+		device1->run();
+		device1->drop();
+		return true;
+	}
+
+	video::IVideoDriver* driver1 = device1->getVideoDriver();
+	video::IVideoDriver* driver2 = device2->getVideoDriver();
+
+	bool result = true;
+	if (driver1->queryFeature(video::EVDF_VERTEX_BUFFER_OBJECT) &&
+		driver2->queryFeature(video::EVDF_VERTEX_BUFFER_OBJECT))
+	{
+		driver1->setMinHardwareBufferVertexCount(0);
+		driver2->setMinHardwareBufferVertexCount(0);
+		scene::SMeshBuffer* mb = createTriangle();
+
+		result &= drawFrame(driver1, mb, 1) == 0;
+		void* link1 = mb->getHWBufferLink();
+		result &= link1 != 0;
+
+		// the second driver creates its link without storing it
+		result &= drawFrame(driver2, mb, 1) == 0;
+		result &= mb->getHWBufferLink() == link1;
+		result &= drawFrame(driver2, mb, 2) == 2;
+		result &= getStat(driver2, "BufferLinkLookups") == 2;
+		result &= drawFrame(driver1, mb, 2) == 0;
+
+		// the second driver doesn't remove the link of the first one
+		removeBuffer(driver2, mb);
+		result &= mb->getHWBufferLink() == link1;
+		result &= drawFrame(driver2, mb, 1) == 0;
+
+		// once the first link is removed, the second driver stores its own
+		removeBuffer(driver1, mb);
+		result &= mb->getHWBufferLink() == 0;
+		result &= drawFrame(driver2, mb, 1) == 1;
+		void* link2 = mb->getHWBufferLink();
+		result &= link2 != 0 && link2 != link1;
+		result &= drawFrame(driver2, mb, 2) == 0;
+
+		// and the first driver has to search now
+		result &= drawFrame(driver1, mb, 1) == 0;
+		result &= drawFrame(driver1, mb, 1) == 1;
+		result &= mb->getHWBufferLink() == link2;
+
+		removeBuffer(driver2, mb);
+		result &= mb->getHWBufferLink() == 0;
+		removeBuffer(driver1, mb);
+		result &= mb->getHWBufferLink() == 0;
+
+		mb->drop();
+
+		if (!result)
+			logTestString("Hardware buffer shared by two drivers failed.\n");
+	}
+
+	device2->closeDevice();
+	device2->run();
+	device2->drop();
+	device1->closeDevice();
+	device1->run();
+	device1->drop();
+
+	assert_log(result);
+
+	return result;
+}
+
+}
+
+//! Tests the hardware buffer links stored in the meshbuffers
+bool hardwareBufferLinks()
+{
+	bool result = testBufferLink(video::EDT_NULL);
+	result &= testBufferLink(video::EDT_OPENGL);
+	result &= testSharedBuffer();
+	return result;
+}
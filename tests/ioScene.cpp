@@ -66,6 +66,9 @@ static bool saveScene(void)
 	smgr->saveScene("results/scene2.irr", 0, node3);
 	result &= xmlCompareFiles(device->getFileSystem(), "results/scene2.irr", "media/scene2.irr");
 
+	logTestString("Test scene.irrb");
+	result &= smgr->saveScene("results/scene.irrb");
+
 	device->closeDevice();
 	device->run();
 	device->drop();
@@ -124,9 +127,34 @@ static bool loadScene(void)
 	return result;
 }
 
+// Loads the binary scene written by saveScene and writes it as .irr again, which must not change anything.
+static bool binaryScene(void)
+{
+	IrrlichtDevice *device = createDevice( EDT_NULL, dimension2d<u32>(160, 120), 32);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager * smgr = device->getSceneManager();
+
+	bool result = smgr->loadScene("results/scene.irrb");
+	if (!result)
+		logTestString("Loading binary scene failed.\n");
+
+	result &= smgr->saveScene("results/scene_irrb.irr");
+	result &= xmlCompareFiles(device->getFileSystem(), "results/scene_irrb.irr", "media/scene.irr");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 bool ioScene(void)
 {
 	bool result = saveScene();
+	result &= binaryScene();
 	result &= loadScene();
 	return result;
 }
@@ -163,6 +163,63 @@ static bool testSort()
 	return true;
 }
 
+static bool testArenaAlloc()
+{
+	bool result = true;
+	core::irrMemoryArena arena(1024);
+
+	for (u32 frame=0; frame<3; ++frame)
+	{
+		{
+			core::array<int, core::irrAllocatorArena<int> > arr;
+			arr.getAllocator().setArena(&arena);
+			for (int i=0; i<1000; ++i)
+				arr.push_back(i);
+			for (int i=0; i<1000; ++i)
+				result &= arr[i] == i;
+
+			// copies use the heap
+			core::array<int, core::irrAllocatorArena<int> > copy(arr);
+			result &= copy.size() == 1000 && copy[999] == 999;
+		}
+		arena.reset();
+	}
+
+	// the first frame needs several blocks, after the reset one is enough
+	const u32 allocations = arena.getAllocationCount();
+	const u32 heapAllocations = arena.getHeapAllocationCount();
+	logTestString("arena: %u allocations, %u from heap\n", allocations, heapAllocations);
+	result &= heapAllocations < allocations / 3;
+
+	{
+		core::array<int, core::irrAllocatorArena<int> > arr;
+		arr.getAllocator().setArena(&arena);
+		for (int i=0; i<1000; ++i)
+			arr.push_back(i);
+	}
+	result &= arena.getHeapAllocationCount() == heapAllocations;
+
+	assert_log( result );
+
+	return result;
+}
+
+static bool testSqrtStrategy()
+{
+	core::array<int> arr;
+	arr.setAllocStrategy(core::ALLOC_STRATEGY_SQRT);
+	for (int i=0; i<1000; ++i)
+		arr.push_back(i);
+
+	bool result = arr.size() == 1000 && arr.allocated_size() < 1100;
+	for (int i=0; i<1000; ++i)
+		result &= arr[i] == i;
+
+	assert_log( result );
+
+	return result;
+}
+
 // Test the functionality of core::array
 bool testIrrArray(void)
 {
@@ -174,6 +231,8 @@ bool testIrrArray(void)
 	allExpected &= testSwap();
 	allExpected &= testErase();
 	allExpected &= testSort();
+	allExpected &= testArenaAlloc();
+	allExpected &= testSqrtStrategy();
 
 	if(allExpected)
 		logTestString("\nAll tests passed\n");
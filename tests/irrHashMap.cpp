@@ -0,0 +1,168 @@
+#include "testUtils.h"
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+
+static bool testInsertRemove()
+{
+	bool result = true;
+
+	core::hash_map<int, int> map;
+	for (int i=0; i<1000; ++i)
+		result &= map.insert(i, 1000-i);
+	result &= !map.insert(10, 0);
+	result &= map.size() == 1000;
+
+	for (int i=0; i<1000; i+=2)
+		result &= map.remove(i);
+	result &= !map.remove(0);
+	result &= map.size() == 500;
+
+	for (int i=0; i<1000; ++i)
+	{
+		const int* v = map.find(i);
+		result &= (i%2) ? (v && *v == 1000-i) : !v;
+	}
+
+	map.set(1, 5);
+	map[2] = 7;
+	map[3] += 1;
+	result &= *map.find(1) == 5 && *map.find(2) == 7 && *map.find(3) == 998;
+
+	u32 count = 0;
+	for (core::hash_map<int, int>::Iterator it = map.getIterator(); !it.atEnd(); ++it)
+	{
+		result &= (it.getKey() == 2) || (it.getKey()%2 == 1);
+		++count;
+	}
+	result &= count == map.size();
+
+	map.clear();
+	result &= map.empty() && !map.find(1);
+
+	assert_log( result );
+
+	return result;
+}
+
+static bool testCopySwap()
+{
+	bool result = true;
+
+	core::hash_map<core::stringc, core::stringc> map1, map2;
+	for (int i=0; i<100; ++i)
+		map1[core::stringc(i)] = core::stringc(i*2);
+	map2.insert("a", "b");
+
+	core::hash_map<core::stringc, core::stringc> copy(map1);
+	copy.remove("5");
+	result &= copy.size() == 99 && map1.size() == 100;
+	result &= map1.find("5") && *map1.find("5") == "10";
+
+	map1.swap(map2);
+	result &= map1.size() == 1 && *map1.find("a") == "b";
+	result &= map2.size() == 100 && *map2.find("99") == "198";
+
+	assert_log( result );
+
+	return result;
+}
+
+static bool testSet()
+{
+	bool result = true;
+
+	int values[100];
+	core::hash_set<int*> set;
+	for (int i=0; i<100; ++i)
+		result &= set.insert(&values[i]);
+	result &= !set.insert(&values[0]);
+	result &= set.size() == 100;
+
+	for (int i=0; i<100; ++i)
+		result &= set.contains(&values[i]);
+	result &= !set.contains(0);
+
+	result &= set.remove(&values[50]);
+	result &= !set.contains(&values[50]);
+
+	u32 count = 0;
+	for (core::hash_set<int*>::ConstIterator it = set.getConstIterator(); !it.atEnd(); ++it)
+		++count;
+	result &= count == 99;
+
+	io::path name("media/Test.png");
+	core::hash_set<io::path> paths;
+	paths.insert(name);
+	result &= paths.contains("media/Test.png") && !paths.contains("media/test.png");
+
+	assert_log( result );
+
+	return result;
+}
+
+// Test the functionality of core::hash_map and core::hash_set
+bool testIrrHashMap(void)
+{
+	bool success = true;
+
+	success &= testInsertRemove();
+	success &= testCopySwap();
+	success &= testSet();
+
+	if(success)
+		logTestString("\nAll tests passed\n");
+	else
+		logTestString("\nFAIL!\n");
+
+	return success;
+}
+
+// Logs insertion and lookup times of hash_map and map, never fails
+bool irrHashMapSpeed(void)
+{
+#ifndef _DEBUG	// timings are meaningless in debug builds
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return true;
+	ITimer* timer = device->getTimer();
+
+	const u32 COUNT = 100000;
+	core::array<core::stringc> keys(COUNT);
+	for (u32 i=0; i<COUNT; ++i)
+		keys.push_back(core::stringc("media/file") + core::stringc(i*7919));
+
+	u32 then = timer->getRealTime();
+	core::hash_map<core::stringc, u32> hashMap;
+	for (u32 i=0; i<COUNT; ++i)
+		hashMap.insert(keys[i], i);
+	const u32 hashInsertTime = timer->getRealTime() - then;
+
+	then += hashInsertTime;
+	u32 found = 0;
+	for (u32 i=0; i<COUNT; ++i)
+		found += hashMap.find(keys[i]) ? 1 : 0;
+	const u32 hashFindTime = timer->getRealTime() - then;
+
+	then += hashFindTime;
+	core::map<core::stringc, u32> treeMap;
+	for (u32 i=0; i<COUNT; ++i)
+		treeMap.insert(keys[i], i);
+	const u32 treeInsertTime = timer->getRealTime() - then;
+
+	then += treeInsertTime;
+	for (u32 i=0; i<COUNT; ++i)
+		found += treeMap.find(keys[i]) ? 1 : 0;
+	const u32 treeFindTime = timer->getRealTime() - then;
+
+	logTestString("Speed test with %u keys (found %u)\n    hash_map insert = %u\n    hash_map find = %u\n    map insert = %u\n    map find = %u\n",
+		COUNT, found, hashInsertTime, hashFindTime, treeInsertTime, treeFindTime);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+#endif // #ifndef _DEBUG
+
+	return true;
+}
@@ -57,6 +57,42 @@ static bool testSwap()
 	return result;
 }
 
+static bool testPoolAlloc()
+{
+	bool result = true;
+
+	core::list<int, core::irrAllocatorPool> list1, list2;
+	for (int i=0; i<200; ++i)
+		list1.push_back(i);
+	for (int i=0; i<10; ++i)
+		list2.push_front(i);
+
+	// erase every second element and add them again, freed nodes are reused
+	core::list<int, core::irrAllocatorPool>::Iterator it = list1.begin();
+	while (it != list1.end())
+	{
+		it = list1.erase(it);
+		if (it != list1.end())
+			++it;
+	}
+	for (int i=0; i<100; ++i)
+		list1.push_back(i);
+	result &= list1.size() == 200;
+	result &= list1.getAllocator().getAllocationCount() == 300;
+	result &= list1.getAllocator().getHeapAllocationCount() == 4;
+
+	list1.swap(list2);
+	result &= list1.size() == 10 && *list1.begin() == 9;
+	result &= list2.size() == 200 && *list2.begin() == 1 && *list2.getLast() == 99;
+
+	list1.clear();
+	list2.clear();
+
+	assert_log( result );
+
+	return result;
+}
+
 // Test the functionality of core::list
 bool testIrrList(void)
 {
@@ -66,6 +102,7 @@ bool testIrrList(void)
 	constIteratorCompileTest(compileThisList);
 
 	success &= testSwap();
+	success &= testPoolAlloc();
 
 	if(success)
 		logTestString("\nAll tests passed\n");
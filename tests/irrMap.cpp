@@ -48,12 +48,45 @@ static bool testSwap()
 	return result;
 }
 
+static bool testPoolAlloc()
+{
+	bool result = true;
+
+	core::map<int, int, core::irrAllocatorPool> map1, map2;
+	for (int i=0; i<1000; ++i)
+		map1.insert(i, 1000-i);
+	for (int i=0; i<1000; i+=2)
+		map1.remove(i);
+	for (int i=0; i<10; ++i)
+		map2.insert(i, i);
+
+	result &= !map1.insert(1, 0);
+	result &= map1.size() == 500;
+	for (int i=0; i<1000; ++i)
+	{
+		core::map<int, int, core::irrAllocatorPool>::Node* node = map1.find(i);
+		result &= (i%2) ? (node && node->getValue() == 1000-i) : !node;
+	}
+	logTestString("pool: %u allocations, %u from heap\n",
+		map1.getAllocator().getAllocationCount(), map1.getAllocator().getHeapAllocationCount());
+	result &= map1.getAllocator().getHeapAllocationCount() < map1.getAllocator().getAllocationCount() / 32;
+
+	map1.swap(map2);
+	result &= map1.size() == 10 && map2.size() == 500;
+	result &= map1.find(5) != 0 && map2.find(999) != 0;
+
+	assert_log( result );
+
+	return result;
+}
+
 // Test the functionality of core::list
 bool testIrrMap(void)
 {
 	bool success = true;
 
 	success &= testSwap();
+	success &= testPoolAlloc();
 
 	if(success)
 		logTestString("\nAll tests passed\n");
@@ -333,6 +333,52 @@ bool testErase()
 	return true;
 }
 
+// strings with small string optimization work like the others
+bool testSmallAlloc()
+{
+	typedef core::string<c8, core::irrAllocatorSmall<c8, 16> > smallstring;
+
+	bool result = true;
+	smallstring small;
+	core::stringc normal;
+	for (u32 i=0; i<40; ++i)
+	{
+		small += (c8)('a' + i%26);
+		normal += (c8)('a' + i%26);
+		result &= small == normal.c_str();
+		result &= small.size() == normal.size();
+
+		// short strings need no heap memory
+		if (i < 15)
+			result &= small.getAllocator().getHeapAllocationCount() == 0;
+	}
+	result &= small.getAllocator().getHeapAllocationCount() > 0;
+
+	smallstring sub = small.subString(2, 5);
+	result &= sub == "cdefg";
+	sub = small;
+	result &= sub == normal.c_str();
+	sub = "short";
+	result &= sub == "short" && sub.size() == 5;
+	sub = sub.subString(1, 3);
+	result &= sub == "hor";
+	sub.append(smallstring("hor"));
+	result &= sub == "horhor";
+
+	core::stringc converted(sub);
+	result &= converted == "horhor";
+
+	core::array<smallstring> arr;
+	for (u32 i=0; i<50; ++i)
+		arr.push_back(smallstring(i));
+	for (u32 i=0; i<50; ++i)
+		result &= arr[i] == core::stringc(i).c_str();
+
+	assert_log( result );
+
+	return result;
+}
+
 // Test the functionality of irrString
 /** Validation is done with assert_log() against expected results. */
 bool testIrrString(void)
@@ -406,6 +452,9 @@ bool testIrrString(void)
 	logTestString("test erase functions\n");
 	allExpected &= testErase();
 
+	logTestString("test small string allocator\n");
+	allExpected &= testSmallAlloc();
+
 	if(allExpected)
 		logTestString("\nAll tests passed\n");
 	else
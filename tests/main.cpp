@@ -55,6 +55,7 @@ int main(int argumentCount, char * arguments[])
 	// Now the simple tests without device
 	TEST(testIrrArray);
 	TEST(testIrrMap);
+	TEST(testIrrHashMap);
 	TEST(testIrrList);
 	TEST(exports);
 	TEST(irrCoreEquals);
@@ -70,6 +71,7 @@ int main(int argumentCount, char * arguments[])
     TEST(color);
 	TEST(testTriangle3d);
 	TEST(vectorPositionDimension2d);
+	TEST(octreeQueries);
 	// file system checks (with null driver)
 	TEST(filesystem);
 	TEST(archiveReader);
@@ -83,13 +85,23 @@ int main(int argumentCount, char * arguments[])
 	TEST(removeCustomAnimator);
 	TEST(sceneCollisionManager);
 	TEST(sceneNodeAnimator);
+	TEST(sceneNodeTransform);
+	TEST(spatialIndexCulling);
+	TEST(softwareOcclusion);
+	TEST(staticBatch);
+	TEST(streamBuffer);
+	TEST(particleSystem);
+	TEST(renderStateCache);
+	TEST(hardwareBufferLinks);
 	TEST(meshLoaders);
+	TEST(irrHashMapSpeed);
 	TEST(testTimer);
 	TEST(testCoreutil);
 	// software drivers only
 	TEST(softwareDevice);
 	TEST(b3dAnimation);
 	TEST(burningsVideo);
+	TEST(shadowVolumeCache);
 	TEST(billboards);
 	TEST(createImage);
 	TEST(cursorSetVisible);
@@ -98,6 +110,7 @@ int main(int argumentCount, char * arguments[])
 	TEST(makeColorKeyTexture);
 	TEST(md2Animation);
 	TEST(meshTransform);
+	TEST(meshWelding);
 	TEST(skinnedMesh);
 	TEST(testGeometryCreator);
 	TEST(writeImageToFile);
@@ -127,6 +140,7 @@ int main(int argumentCount, char * arguments[])
 //	TEST(stencilShadow);
 	// q3 maps are slow
 	TEST(planeMatrix);
+	TEST(q3LevelSceneNode);
 	TEST(terrainSceneNode);
 	TEST(lightMaps);
 	TEST(triangleSelector);
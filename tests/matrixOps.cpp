@@ -449,6 +449,274 @@ void calltest()
 	f1 = f1+f2+f3+f4+*pf1+*pf2; // getting rid of unused variable warnings.
 }
 
+
+// Compare the batch transformations with the single ones
+bool batchTransformations(void)
+{
+	bool result = true;
+	matrix4 m;
+	m.setRotationDegrees(vector3df(10.f, 20.f, 30.f));
+	m.setTranslation(vector3df(1.f, 2.f, 3.f));
+	m.setScale(vector3df(2.f, 1.f, 0.5f));
+
+	vector3df in[5] = { vector3df(1.f, 2.f, 3.f), vector3df(-1.f, 0.f, 5.f),
+		vector3df(7.f, 8.f, 9.f), vector3df(0.f, 0.f, 0.f), vector3df(3.f, -3.f, 3.f) };
+	vector3df out[5];
+	m.transformVects(out, in, 5);
+	for (u32 i=0; i<5; ++i)
+	{
+		vector3df v;
+		m.transformVect(v, in[i]);
+		result &= v.equals(out[i]);
+	}
+
+	m.rotateVects(out, in, 5);
+	for (u32 i=0; i<5; ++i)
+	{
+		vector3df v;
+		m.rotateVect(v, in[i]);
+		result &= v.equals(out[i]);
+	}
+
+	// in place
+	m.transformVects(in, in, 5);
+	m.transformVect(out[0], vector3df(3.f, -3.f, 3.f));
+	result &= in[4].equals(out[0]);
+
+	aabbox3df boxes[2] = { aabbox3df(-1.f, -2.f, -3.f, 1.f, 2.f, 3.f), aabbox3df(5.f, 5.f, 5.f, 6.f, 7.f, 8.f) };
+	aabbox3df single[2] = { boxes[0], boxes[1] };
+	m.transformBoxesEx(boxes, 2);
+	for (u32 i=0; i<2; ++i)
+	{
+		m.transformBoxEx(single[i]);
+		result &= single[i].MinEdge.equals(boxes[i].MinEdge);
+		result &= single[i].MaxEdge.equals(boxes[i].MaxEdge);
+	}
+
+	plane3df planes[2] = { plane3df(vector3df(0.f, 0.f, 1.f), vector3df(0.f, 1.f, 0.f)),
+		plane3df(vector3df(1.f, 2.f, 3.f), vector3df(1.f, 1.f, 0.f).normalize()) };
+	plane3df singlePlanes[2] = { planes[0], planes[1] };
+	m.transformPlanes(planes, 2);
+	for (u32 i=0; i<2; ++i)
+	{
+		m.transformPlane(singlePlanes[i]);
+		result &= singlePlanes[i].Normal.equals(planes[i].Normal);
+		result &= core::equals(singlePlanes[i].D, planes[i].D, 0.0001f);
+	}
+
+	f32 v4in[4] = { 1.f, 2.f, 3.f, 1.f };
+	f32 v4out[4];
+	m.transformVec4(v4out, v4in);
+	m.transformVect(out[0], vector3df(1.f, 2.f, 3.f));
+	result &= out[0].equals(vector3df(v4out[0], v4out[1], v4out[2]));
+	result &= core::equals(v4out[3], 1.f);
+
+	if (!result)
+		logTestString("Batch transformations failed\n");
+	return result;
+}
+
+// Compares larger batches with the single transformations, the SSE2 code
+// can differ by rounding. The counts are no multiples of 4, so the scalar
+// code handles the remainder.
+bool batchTolerance(void)
+{
+	bool result = true;
+	srand(2);
+	const u32 COUNT = 103;
+	for (u32 k=0; k<20; ++k)
+	{
+		matrix4 m;
+		m.setRotationDegrees(vector3df((f32)(rand()%360), (f32)(rand()%360), (f32)(rand()%360)));
+		m.setTranslation(vector3df((f32)(rand()%200-100), (f32)(rand()%200-100), (f32)(rand()%200-100)));
+		m.setScale(vector3df(0.5f + (rand()%30)*0.1f, 0.5f + (rand()%30)*0.1f, 0.5f + (rand()%30)*0.1f));
+
+		// one more, so the batch can start at an unaligned element
+		core::array<vector3df> in;
+		in.set_used(COUNT+1);
+		for (u32 i=0; i<=COUNT; ++i)
+			in[i].set((f32)(rand()%2000-1000) / 10.f, (f32)(rand()%2000-1000) / 10.f, (f32)(rand()%2000-1000) / 10.f);
+
+		core::array<vector3df> out;
+		out.set_used(COUNT);
+		m.transformVects(out.pointer(), in.pointer()+1, COUNT);
+		for (u32 i=0; i<COUNT; ++i)
+		{
+			vector3df v;
+			m.transformVect(v, in[i+1]);
+			result &= v.equals(out[i], 0.0001f);
+		}
+
+		m.rotateVects(out.pointer(), in.pointer()+1, COUNT);
+		for (u32 i=0; i<COUNT; ++i)
+		{
+			vector3df v;
+			m.rotateVect(v, in[i+1]);
+			result &= v.equals(out[i], 0.0001f);
+		}
+
+		// in place
+		out = in;
+		m.transformVects(out.pointer(), out.pointer(), COUNT);
+		for (u32 i=0; i<COUNT; ++i)
+		{
+			vector3df v;
+			m.transformVect(v, in[i]);
+			result &= v.equals(out[i], 0.0001f);
+		}
+		result &= out[COUNT] == in[COUNT];
+
+		core::array<aabbox3df> boxes;
+		core::array<plane3df> planes;
+		for (u32 i=0; i<COUNT; ++i)
+		{
+			aabbox3df box(in[i]);
+			box.addInternalPoint(in[i+1]);
+			boxes.push_back(box);
+			// includes a zero normal, which is not normalized
+			planes.push_back(plane3df(in[i], (i == 5) ? vector3df(0.f, 0.f, 0.f) : (in[i+1]-in[i]).normalize()));
+		}
+		const core::array<aabbox3df> singleBoxes(boxes);
+		const core::array<plane3df> singlePlanes(planes);
+
+		m.transformBoxesEx(boxes.pointer(), COUNT);
+		for (u32 i=0; i<COUNT; ++i)
+		{
+			aabbox3df box(singleBoxes[i]);
+			m.transformBoxEx(box);
+			result &= box.MinEdge.equals(boxes[i].MinEdge, 0.0001f);
+			result &= box.MaxEdge.equals(boxes[i].MaxEdge, 0.0001f);
+		}
+
+		m.transformPlanes(planes.pointer(), COUNT);
+		for (u32 i=0; i<COUNT; ++i)
+		{
+			plane3df plane(singlePlanes[i]);
+			m.transformPlane(plane);
+			result &= plane.Normal.equals(planes[i].Normal, 0.0001f);
+			result &= core::equals(plane.D, planes[i].D, 0.001f);
+		}
+	}
+
+	if (!result)
+		logTestString("Batch transformations differ from single ones\n");
+	return result;
+}
+
+// The inverse multiplied with the matrix has to be the identity
+bool inverse(void)
+{
+	bool result = true;
+	srand(1);
+	for (u32 k=0; k<1000; ++k)
+	{
+		matrix4 m;
+		for (u32 i=0; i<16; ++i)
+			m[i] = (f32)(rand()%2000-1000) / 100.f;
+
+		matrix4 inv;
+		if (!m.getInverse(inv))
+			continue;
+
+		const matrix4 p = m * inv;
+		for (u32 i=0; i<16; ++i)
+		{
+			if (!core::equals(p[i], (i%5==0) ? 1.f : 0.f, 0.01f))
+			{
+				logTestString("Inverse failed for matrix %u\n", k);
+				result = false;
+				break;
+			}
+		}
+	}
+
+	matrix4 singular(matrix4::EM4CONST_NOTHING);
+	for (u32 i=0; i<16; ++i)
+		singular[i] = (f32)(i%4);
+	matrix4 inv;
+	result &= !singular.getInverse(inv);
+
+	return result;
+}
+
+// Logs the time of single and batch transformations, never fails
+bool speed(void)
+{
+#ifndef _DEBUG	// timings are meaningless in debug builds
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return true;
+	ITimer* timer = device->getTimer();
+
+	const u32 COUNT = 100000;
+	core::array<vector3df> in;
+	in.set_used(COUNT);
+	for (u32 i=0; i<COUNT; ++i)
+		in[i].set((f32)i, (f32)(i%100), (f32)(i%7));
+	core::array<vector3df> out;
+	out.set_used(COUNT);
+
+	matrix4 m;
+	m.setRotationDegrees(vector3df(10.f, 20.f, 30.f));
+	m.setTranslation(vector3df(1.f, 2.f, 3.f));
+
+	u32 then = timer->getRealTime();
+	for (u32 k=0; k<10; ++k)
+		for (u32 i=0; i<COUNT; ++i)
+			m.transformVect(out[i], in[i]);
+	const u32 singleTime = timer->getRealTime() - then;
+
+	then += singleTime;
+	for (u32 k=0; k<10; ++k)
+		m.transformVects(out.pointer(), in.pointer(), COUNT);
+	const u32 batchTime = timer->getRealTime() - then;
+
+	then += batchTime;
+	matrix4 inv;
+	for (u32 i=0; i<COUNT; ++i)
+	{
+		m[12] = (f32)i;
+		m.getInverse(inv);
+	}
+	const u32 inverseTime = timer->getRealTime() - then;
+
+	then += inverseTime;
+	for (u32 k=0; k<10; ++k)
+		m.rotateVects(out.pointer(), in.pointer(), COUNT);
+	const u32 rotateTime = timer->getRealTime() - then;
+
+	core::array<aabbox3df> boxes;
+	for (u32 i=0; i<COUNT/10; ++i)
+		boxes.push_back(aabbox3df(in[i], in[i]+vector3df(1.f, 2.f, 3.f)));
+
+	then = timer->getRealTime();
+	for (u32 k=0; k<10; ++k)
+		for (u32 i=0; i<boxes.size(); ++i)
+			m.transformBoxEx(boxes[i]);
+	const u32 singleBoxTime = timer->getRealTime() - then;
+
+	then += singleBoxTime;
+	for (u32 k=0; k<10; ++k)
+		m.transformBoxesEx(boxes.pointer(), boxes.size());
+	const u32 batchBoxTime = timer->getRealTime() - then;
+
+#if defined(_IRR_USE_SSE2_)
+	const c8* const kernels = "SSE2";
+#else
+	const c8* const kernels = "scalar";
+#endif
+	logTestString("Matrix speed test (%s)\n    transformVect time = %u\n    transformVects time = %u\n    rotateVects time = %u\n"
+		"    transformBoxEx time = %u\n    transformBoxesEx time = %u\n    getInverse time = %u\n",
+		kernels, singleTime, batchTime, rotateTime, singleBoxTime, batchBoxTime, inverseTime);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+#endif // #ifndef _DEBUG
+
+	return true;
+}
+
 }
 
 bool matrixOps(void)
@@ -460,6 +728,10 @@ bool matrixOps(void)
 	result &= isOrthogonal();
 	result &= transformations();
 	result &= setRotationAxis();
+	result &= batchTransformations();
+	result &= batchTolerance();
+	result &= inverse();
+	result &= speed();
 	return result;
 }
 
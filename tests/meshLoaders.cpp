@@ -5,6 +5,208 @@
 
 using namespace irr;
 
+// Loads a mesh twice with the binary mesh cache enabled, the second time it comes from the .irrbin file.
+static bool binaryMeshCache(void)
+{
+	const core::dimension2d<u32> size(160, 120);
+	scene::ISkinnedMesh* meshes[2] = { 0, 0 };
+	IrrlichtDevice* devices[2] = { 0, 0 };
+
+	bool result = true;
+	for (u32 i=0; i<2; ++i)
+	{
+		devices[i] = createDevice(video::EDT_NULL, size, 32);
+		assert_log(devices[i]);
+		if (!devices[i])
+			return false;
+
+		scene::ISceneManager * smgr = devices[i]->getSceneManager();
+		smgr->getParameters()->setAttribute(scene::MESH_BINARY_CACHE_PATH, "results");
+		scene::IAnimatedMesh* mesh = smgr->getMesh("../media/ninja.b3d");
+		if (!mesh || mesh->getMeshType() != scene::EAMT_SKINNED)
+		{
+			logTestString("Loading mesh with binary mesh cache failed.\n");
+			result = false;
+			break;
+		}
+		meshes[i] = (scene::ISkinnedMesh*)mesh;
+	}
+
+	if (result)
+	{
+		result &= meshes[0]->getMeshBufferCount() == meshes[1]->getMeshBufferCount();
+		result &= meshes[0]->getJointCount() == meshes[1]->getJointCount();
+		result &= meshes[0]->getFrameCount() == meshes[1]->getFrameCount();
+		result &= meshes[0]->getBoundingBox() == meshes[1]->getBoundingBox();
+		for (u32 b=0; result && b<meshes[0]->getMeshBufferCount(); ++b)
+		{
+			const scene::IMeshBuffer* mb0 = meshes[0]->getMeshBuffer(b);
+			const scene::IMeshBuffer* mb1 = meshes[1]->getMeshBuffer(b);
+			result &= mb0->getVertexCount() == mb1->getVertexCount();
+			result &= mb0->getIndexCount() == mb1->getIndexCount();
+			// textures belong to different drivers, so only their names can be compared
+			const video::ITexture* tex0 = mb0->getMaterial().getTexture(0);
+			const video::ITexture* tex1 = mb1->getMaterial().getTexture(0);
+			result &= mb0->getMaterial().MaterialType == mb1->getMaterial().MaterialType;
+			result &= (!tex0 && !tex1) || (tex0 && tex1 && tex0->getName().getPath() == tex1->getName().getPath());
+			for (u32 v=0; result && v<mb0->getVertexCount(); ++v)
+				result &= mb0->getPosition(v) == mb1->getPosition(v);
+		}
+		if (!result)
+			logTestString("Mesh loaded from binary mesh cache differs.\n");
+	}
+
+	for (u32 i=0; i<2; ++i)
+	{
+		if (devices[i])
+		{
+			devices[i]->closeDevice();
+			devices[i]->run();
+			devices[i]->drop();
+		}
+	}
+
+	return result;
+}
+
+static void writeTextFile(io::IFileSystem* fs, const io::path& name, const c8* text)
+{
+	io::IWriteFile* file = fs->createAndWriteFile(name);
+	if (file)
+	{
+		file->write(text, strlen(text));
+		file->drop();
+	}
+}
+
+// A binary mesh cache is replaced when the mesh file is edited, also when its size stays the same.
+static bool binaryMeshCacheOutdated(void)
+{
+	const c8* const texts[2] = {
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n",
+		"v 0 0 0\nv 2 0 0\nv 0 1 0\nf 1 2 3\n" };
+
+	bool result = true;
+	for (u32 i=0; i<2; ++i)
+	{
+		IrrlichtDevice* device = createDevice(video::EDT_NULL, core::dimension2d<u32>(160, 120));
+		assert_log(device);
+		if (!device)
+			return false;
+
+		writeTextFile(device->getFileSystem(), "results/binaryMeshCache.obj", texts[i]);
+
+		scene::ISceneManager* smgr = device->getSceneManager();
+		smgr->getParameters()->setAttribute(scene::MESH_BINARY_CACHE_PATH, "results");
+		scene::IAnimatedMesh* mesh = smgr->getMesh("results/binaryMeshCache.obj");
+		result &= mesh && core::equals(mesh->getBoundingBox().MaxEdge.X, (f32)(i+1));
+
+		device->closeDevice();
+		device->run();
+		device->drop();
+	}
+
+	if (!result)
+		logTestString("Outdated binary mesh cache was loaded.\n");
+
+	return result;
+}
+
+// Truncated .irrbin files with consistent headers, or with counts larger than the data, must fail
+// to load without reading outside of the data.
+static bool binaryMeshTruncated(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, core::dimension2d<u32>(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	io::IFileSystem* fs = device->getFileSystem();
+
+	scene::ISkinnedMesh* mesh = smgr->createSkinnedMesh();
+	scene::SSkinMeshBuffer* buffer = mesh->addMeshBuffer();
+	buffer->Vertices_Standard.push_back(video::S3DVertex(0,0,0, 0,0,-1, 0xffffffff, 0,0));
+	buffer->Vertices_Standard.push_back(video::S3DVertex(1,0,0, 0,0,-1, 0xffffffff, 1,0));
+	buffer->Vertices_Standard.push_back(video::S3DVertex(0,1,0, 0,0,-1, 0xffffffff, 0,1));
+	for (u16 i=0; i<3; ++i)
+		buffer->Indices.push_back(i);
+	buffer->recalculateBoundingBox();
+	scene::ISkinnedMesh::SJoint* root = mesh->addJoint(0);
+	root->Name = "root";
+	for (u32 i=0; i<4; ++i)
+		mesh->addJoint(root)->Name = core::stringc("joint") + core::stringc(i);
+	mesh->finalize();
+
+	core::array<u8> data;
+	data.set_used(65536);
+	io::IWriteFile* file = fs->createMemoryWriteFile(data.pointer(), data.size(), "truncated.irrbin");
+	scene::IMeshWriter* writer = smgr->createMeshWriter(scene::EMWT_IRR_BINARY_MESH);
+	bool result = writer && writer->writeMesh(file, mesh);
+	const u32 fileSize = (u32)file->getPos();
+	if (writer)
+		writer->drop();
+	file->drop();
+	mesh->drop();
+
+	// words of SIrrBinaryMeshHeader, the data is at the end of the payload
+	const u32 headerWords = 9;
+	const u32 dataSizeWord = 7;
+	const u32 payloadSizeWord = 8;
+	const u32 dataSize = reinterpret_cast<const u32*>(data.const_pointer())[dataSizeWord];
+	result &= fileSize > headerWords*4 + dataSize*4;
+
+	core::array<u8> truncated;
+	for (u32 cut=0; result && cut<dataSize; ++cut)
+	{
+		truncated.set_used(fileSize - cut*4);
+		memcpy(truncated.pointer(), data.const_pointer(), truncated.size());
+		u32* header = reinterpret_cast<u32*>(truncated.pointer());
+		header[dataSizeWord] -= cut;
+		header[payloadSizeWord] -= cut*4;
+
+		io::IReadFile* input = fs->createMemoryReadFile(truncated.const_pointer(), truncated.size(), "truncated.irrbin");
+		scene::IAnimatedMesh* loaded = smgr->getMesh(input);
+		input->drop();
+
+		// only the complete file is loaded
+		if (cut == 0)
+		{
+			result &= loaded && loaded->getMeshType() == scene::EAMT_SKINNED &&
+				static_cast<scene::ISkinnedMesh*>(loaded)->getJointCount() == 5;
+			smgr->getMeshCache()->clear();
+		}
+		else
+			result &= !loaded;
+	}
+
+	if (!result)
+		logTestString("Truncated .irrbin file was not rejected.\n");
+
+	// the file ends with the counts of attached meshes, position, scale and
+	// rotation keys and weights of the last joint, which has none of them
+	for (u32 count=0; result && count<5; ++count)
+	{
+		truncated.set_used(fileSize);
+		memcpy(truncated.pointer(), data.const_pointer(), fileSize);
+		reinterpret_cast<u32*>(truncated.pointer())[fileSize/4 - 5 + count] = 1000;
+
+		io::IReadFile* input = fs->createMemoryReadFile(truncated.const_pointer(), truncated.size(), "oversized.irrbin");
+		scene::IAnimatedMesh* loaded = smgr->getMesh(input);
+		input->drop();
+
+		result &= !loaded;
+		if (!result)
+			logTestString("Count %u of the last joint was too large, but the .irrbin file was not rejected.\n", count);
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 // Tests mesh loading features and the mesh cache.
 /** This won't test render results. Currently, not all mesh loaders are tested. */
 bool meshLoaders(void)
@@ -33,5 +235,9 @@ bool meshLoaders(void)
 	device->run();
 	device->drop();
 
+	result &= binaryMeshCache();
+	result &= binaryMeshCacheOutdated();
+	result &= binaryMeshTruncated();
+
 	return result;
 }
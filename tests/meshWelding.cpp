@@ -0,0 +1,144 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+
+namespace
+{
+
+// the old quadratic search, to check the vertex count of the welded mesh
+u32 countWeldedVertices(const scene::IMeshBuffer* mb, f32 tolerance)
+{
+	const video::S3DVertex* v = (const video::S3DVertex*)mb->getVertices();
+	u32 count = 0;
+	for (u32 i=0; i<mb->getVertexCount(); ++i)
+	{
+		bool found = false;
+		for (u32 j=0; j<i && !found; ++j)
+		{
+			found = v[i].Pos.equals(v[j].Pos, tolerance) &&
+				v[i].Normal.equals(v[j].Normal, tolerance) &&
+				v[i].TCoords.equals(v[j].TCoords) &&
+				(v[i].Color == v[j].Color);
+		}
+		if (!found)
+			++count;
+	}
+	return count;
+}
+
+// sum of all triangle corners, which stays the same when triangles are reordered
+core::vector3df sumTriangles(const scene::IMesh* mesh)
+{
+	core::vector3df sum;
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		const scene::IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		const u16* indices = mb->getIndices();
+		for (u32 i=0; i<mb->getIndexCount(); ++i)
+			sum += mb->getPosition(indices[i]);
+	}
+	return sum;
+}
+
+u32 countVertices(const scene::IMesh* mesh)
+{
+	u32 count = 0;
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+		count += mesh->getMeshBuffer(b)->getVertexCount();
+	return count;
+}
+
+u32 countIndices(const scene::IMesh* mesh)
+{
+	u32 count = 0;
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+		count += mesh->getMeshBuffer(b)->getIndexCount();
+	return count;
+}
+
+bool testMesh(IrrlichtDevice* device, const io::path& filename)
+{
+	scene::ISceneManager* smgr = device->getSceneManager();
+	scene::IMeshManipulator* manipulator = smgr->getMeshManipulator();
+	ITimer* timer = device->getTimer();
+
+	scene::IAnimatedMesh* amesh = smgr->getMesh(filename);
+	if (!amesh)
+	{
+		logTestString("Could not load %s.\n", filename.c_str());
+		return false;
+	}
+
+	scene::IMesh* unique = manipulator->createMeshUniquePrimitives(amesh->getMesh(0));
+
+	u32 then = timer->getRealTime();
+	scene::IMesh* welded = manipulator->createMeshWelded(unique);
+	const u32 weldTime = timer->getRealTime() - then;
+
+	then += weldTime;
+	scene::IMesh* forsyth = manipulator->createForsythOptimizedMesh(welded);
+	const u32 forsythTime = timer->getRealTime() - then;
+
+	then += forsythTime;
+	scene::IMesh* fetch = manipulator->createVertexFetchOptimizedMesh(forsyth);
+	const u32 fetchTime = timer->getRealTime() - then;
+
+	logTestString("%s: %u vertices welded to %u\n    weld time = %u\n    forsyth time = %u\n    vertex fetch time = %u\n",
+		filename.c_str(), countVertices(unique), countVertices(welded), weldTime, forsythTime, fetchTime);
+
+	bool result = true;
+
+	// the welded buffers have the same vertices as with a full search
+	for (u32 b=0; b<unique->getMeshBufferCount(); ++b)
+	{
+		const scene::IMeshBuffer* mb = unique->getMeshBuffer(b);
+		if (mb->getVertexType() == video::EVT_STANDARD &&
+			countWeldedVertices(mb, core::ROUNDING_ERROR_f32) != welded->getMeshBuffer(b)->getVertexCount())
+		{
+			logTestString("Buffer %u was not welded completely.\n", b);
+			result = false;
+		}
+	}
+
+	// reordering keeps all triangles
+	const u32 indexCount = countIndices(welded);
+	const core::vector3df sum = sumTriangles(welded);
+	result &= countIndices(forsyth) == indexCount;
+	result &= countIndices(fetch) == indexCount;
+	result &= sumTriangles(forsyth).equals(sum, 0.01f);
+	result &= sumTriangles(fetch).equals(sum, 0.01f);
+	result &= countVertices(fetch) <= countVertices(welded);
+
+	unique->drop();
+	welded->drop();
+	forsyth->drop();
+	fetch->drop();
+
+	return result;
+}
+
+} // end anonymous namespace
+
+//! Tests welding and optimizing meshes with the mesh manipulator and logs the timings
+bool meshWelding()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return false;
+
+	bool result = testMesh(device, "../media/sydney.md2");
+	result &= testMesh(device, "../media/room.3ds");
+	result &= testMesh(device, "../media/dwarf.x");
+
+	if (!result)
+		logTestString("Mesh welding failed.\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
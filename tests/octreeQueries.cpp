@@ -0,0 +1,189 @@
+#include "testUtils.h"
+#include <irrlicht.h>
+// the octree is a template used by the octree scene node and selector
+#include "../source/Irrlicht/Octree.h"
+
+using namespace irr;
+using namespace core;
+
+namespace
+{
+
+typedef Octree<video::S3DVertex> COctree;
+
+// Deterministic random numbers, so failures can be reproduced
+class CRandom
+{
+public:
+	CRandom() : Seed(1) {}
+
+	f32 frand(f32 range)
+	{
+		Seed = Seed * 1103515245 + 12345;
+		return (f32)((Seed >> 8) & 0xffff) / 65535.f * range;
+	}
+
+private:
+	u32 Seed;
+};
+
+// Triangles with their own vertices, so the first index identifies them
+void createTriangles(COctree::SMeshChunk& chunk, CRandom& random, u32 count)
+{
+	for (u32 t=0; t<count; ++t)
+	{
+		const vector3df center(random.frand(200.f)-100.f, random.frand(200.f)-100.f, random.frand(200.f)-100.f);
+		for (u32 v=0; v<3; ++v)
+		{
+			video::S3DVertex vertex;
+			vertex.Pos = center + vector3df(random.frand(10.f)-5.f, random.frand(10.f)-5.f, random.frand(10.f)-5.f);
+			chunk.Vertices.push_back(vertex);
+			chunk.Indices.push_back((u16)(t*3+v));
+		}
+	}
+}
+
+bool isOutside(const scene::SViewFrustum& frustum, const vector3df* pos)
+{
+	for (u32 p=0; p<scene::SViewFrustum::VF_PLANE_COUNT; ++p)
+	{
+		// vertices close to a plane are left out, the tree rounds differently
+		const plane3df& plane = frustum.planes[p];
+		if (plane.getDistanceTo(pos[0]) > -0.001f &&
+			plane.getDistanceTo(pos[1]) > -0.001f &&
+			plane.getDistanceTo(pos[2]) > -0.001f)
+			return true;
+	}
+	return false;
+}
+
+bool isOutside(const aabbox3df& box, const vector3df* pos)
+{
+	aabbox3df triangleBox(pos[0]);
+	triangleBox.addInternalPoint(pos[1]);
+	triangleBox.addInternalPoint(pos[2]);
+	triangleBox.MinEdge -= vector3df(0.001f, 0.001f, 0.001f);
+	triangleBox.MaxEdge += vector3df(0.001f, 0.001f, 0.001f);
+	return !triangleBox.intersectsWithBox(box);
+}
+
+// Compares the result of the last query with a linear scan over all
+// triangles. The tree may return more triangles, but every one only once,
+// and none which the scan found visible may be missing.
+template <class Q>
+bool compareWithScan(const COctree& tree, const array<COctree::SMeshChunk>& chunks,
+	const Q& query, u32& visible, u32& returned)
+{
+	bool result = true;
+
+	for (u32 m=0; m<chunks.size(); ++m)
+	{
+		const COctree::SIndexData& data = tree.getIndexData()[m];
+		const u32 triangleCount = chunks[m].Indices.size() / 3;
+		array<u32> found;
+		found.set_used(triangleCount);
+		for (u32 t=0; t<triangleCount; ++t)
+			found[t] = 0;
+
+		for (s32 i=0; i<data.CurrentSize; i+=3)
+		{
+			const u32 t = data.Indices[i] / 3;
+			result &= data.Indices[i+1] == t*3+1 && data.Indices[i+2] == t*3+2;
+			++found[t];
+			++returned;
+		}
+
+		for (u32 t=0; t<triangleCount; ++t)
+		{
+			const vector3df pos[3] = { chunks[m].Vertices[t*3].Pos,
+				chunks[m].Vertices[t*3+1].Pos, chunks[m].Vertices[t*3+2].Pos };
+			result &= found[t] <= 1;
+			if (!isOutside(query, pos))
+			{
+				result &= found[t] == 1;
+				++visible;
+			}
+		}
+	}
+
+	return result;
+}
+
+} // end anonymous namespace
+
+// Tests the polygons found by the loose octree against a linear scan
+bool octreeQueries(void)
+{
+	array<COctree::SMeshChunk> chunks;
+	chunks.push_back(COctree::SMeshChunk());
+	chunks.push_back(COctree::SMeshChunk());
+	chunks[1].MaterialId = 1;
+
+	CRandom random;
+	createTriangles(chunks[0], random, 3000);
+	createTriangles(chunks[1], random, 2000);
+	const u32 triangleCount = 5000;
+
+	COctree tree(chunks, 32);
+	bool result = tree.getNodeCount() > 1;
+
+	const aabbox3df boxes[] = {
+		aabbox3df(-200,-200,-200, 200,200,200),
+		aabbox3df(-10,-10,-10, 10,10,10),
+		aabbox3df(0,-100,-100, 100,100,100),
+		aabbox3df(50,50,50, 52,52,52),
+		aabbox3df(300,300,300, 400,400,400)
+	};
+
+	for (u32 b=0; b<sizeof(boxes)/sizeof(boxes[0]); ++b)
+	{
+		result &= tree.calculatePolys(boxes[b]);
+		u32 visible = 0;
+		u32 returned = 0;
+		result &= compareWithScan(tree, chunks, boxes[b], visible, returned);
+		if (b == 0)
+			result &= returned == triangleCount;
+		else
+			result &= returned < triangleCount;
+		if (!result)
+			logTestString("Box %u: %u of %u triangles visible, %u returned\n", b, visible, triangleCount, returned);
+	}
+
+	// the same box again keeps the last result
+	result &= !tree.calculatePolys(boxes[4]);
+	result &= tree.calculatePolys(boxes[3]);
+
+	const vector3df cameras[][2] = {
+		{ vector3df(0,0,-600), vector3df(0,0,0) },
+		{ vector3df(0,0,0), vector3df(1,0,0) },
+		{ vector3df(-50,80,-20), vector3df(60,-30,40) },
+		{ vector3df(100,100,100), vector3df(0,0,0) },
+		{ vector3df(0,0,300), vector3df(0,0,400) }
+	};
+
+	for (u32 c=0; c<sizeof(cameras)/sizeof(cameras[0]); ++c)
+	{
+		matrix4 projection;
+		projection.buildProjectionMatrixPerspectiveFovLH(PI/4.f, 4.f/3.f, 1.f, 1000.f);
+		matrix4 view;
+		view.buildCameraLookAtMatrixLH(cameras[c][0], cameras[c][1], vector3df(0,1,0));
+		const scene::SViewFrustum frustum(projection * view, true);
+
+		result &= tree.calculatePolys(frustum);
+		u32 visible = 0;
+		u32 returned = 0;
+		result &= compareWithScan(tree, chunks, frustum, visible, returned);
+		if (c == 0)
+			result &= returned == triangleCount;
+		else
+			result &= returned < triangleCount;
+		if (!result)
+			logTestString("Frustum %u: %u of %u triangles visible, %u returned\n", c, visible, triangleCount, returned);
+
+		result &= !tree.calculatePolys(frustum);
+	}
+
+	assert_log( result );
+
+	return result;
+}
@@ -0,0 +1,136 @@
+#include "testUtils.h"
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+
+namespace
+{
+
+// Affector which only works on the particle copy, it pushes all particles
+// along the x axis
+class CPushAffector : public scene::IParticleAffector
+{
+public:
+	CPushAffector() : Calls(0) {}
+
+	virtual void affect(u32 now, scene::SParticle* particlearray, u32 count)
+	{
+		++Calls;
+		for (u32 i=0; i<count; ++i)
+			particlearray[i].vector.X += 0.01f;
+	}
+
+	virtual scene::E_PARTICLE_AFFECTOR_TYPE getType() const
+	{
+		return scene::EPAT_NONE;
+	}
+
+	u32 Calls;
+};
+
+void updateParticles(IrrlichtDevice* device, u32 time)
+{
+	device->getTimer()->setTime(time);
+	device->getVideoDriver()->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	device->getSceneManager()->drawAll();
+	device->getVideoDriver()->endScene();
+}
+
+} // end anonymous namespace
+
+// More particles than 16 bit indices can address are drawn completely
+static bool testManyParticles(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	smgr->addCameraSceneNode(0, vector3df(0,0,-50), vector3df(0,0,0));
+
+	scene::IParticleSystemSceneNode* ps = smgr->addParticleSystemSceneNode(false);
+	scene::IParticleEmitter* emitter = ps->createBoxEmitter(aabbox3df(-5,-5,-5,5,5,5),
+		vector3df(0,0,0), 20000, 20000, video::SColor(255,255,255,255), video::SColor(255,255,255,255),
+		10000, 10000);
+	ps->setEmitter(emitter);
+	emitter->drop();
+
+	updateParticles(device, 1000);
+	// emits 20000 particles, which need 80000 vertices
+	updateParticles(device, 2000);
+
+	const u32 primitives = driver->getPrimitiveCountDrawn();
+	const bool result = primitives > 65536/4*2 && (primitives % 2) == 0;
+	if (!result)
+		logTestString("Particles drew %u primitives\n", primitives);
+
+	smgr->clear();
+
+	assert_log( result );
+
+	return result;
+}
+
+// Affectors implementing only affect() run in order with the built-in ones
+static bool testCustomAffector(IrrlichtDevice* device)
+{
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	smgr->addCameraSceneNode(0, vector3df(0,0,-50), vector3df(0,0,0));
+
+	scene::IParticleSystemSceneNode* ps = smgr->addParticleSystemSceneNode(false);
+	scene::IParticleEmitter* emitter = ps->createBoxEmitter(aabbox3df(0,0,0,0,0,0),
+		vector3df(0,0,0), 100, 100, video::SColor(255,255,255,255), video::SColor(255,255,255,255),
+		5000, 5000, 0, dimension2df(5.f,5.f), dimension2df(5.f,5.f));
+	ps->setEmitter(emitter);
+	emitter->drop();
+
+	scene::IParticleAffector* affector = ps->createGravityAffector(vector3df(0,-0.01f,0), 1);
+	ps->addAffector(affector);
+	affector->drop();
+
+	CPushAffector* push = new CPushAffector();
+	ps->addAffector(push);
+
+	affector = ps->createFadeOutParticleAffector();
+	ps->addAffector(affector);
+	affector->drop();
+
+	updateParticles(device, 1000);
+	updateParticles(device, 1100);
+	updateParticles(device, 1200);
+
+	// Particles of the second update fell down by gravity, all were pushed
+	// to the right by the custom affector. The box grows by half the
+	// particle size.
+	const aabbox3df& box = ps->getBoundingBox();
+	bool result = push->Calls == 2;
+	result &= equals(box.MinEdge.X, -1.5f, 0.01f) && equals(box.MaxEdge.X, 4.5f, 0.01f);
+	result &= equals(box.MinEdge.Y, -3.5f, 0.01f) && equals(box.MaxEdge.Y, 2.5f, 0.01f);
+	if (!result)
+		logTestString("Custom affector called %u times, box %f %f %f - %f %f %f\n", push->Calls,
+			box.MinEdge.X, box.MinEdge.Y, box.MinEdge.Z, box.MaxEdge.X, box.MaxEdge.Y, box.MaxEdge.Z);
+
+	push->drop();
+	smgr->clear();
+
+	assert_log( result );
+
+	return result;
+}
+
+bool particleSystem(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	if (!device)
+		return true;
+
+	bool result = true;
+	result &= testManyParticles(device);
+	result &= testCustomAffector(device);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,161 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+
+namespace
+{
+
+//! Draws some frames and returns the time they needed
+u32 drawFrames(IrrlichtDevice* device, u32 frames)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	const u32 start = device->getTimer()->getRealTime();
+
+	for (u32 i=0; i<frames; ++i)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+		device->getSceneManager()->drawAll();
+		driver->endScene();
+	}
+
+	return device->getTimer()->getRealTime() - start;
+}
+
+//! Checks the face counters of the node with and without the potentially visible set
+bool pvsCulling(IrrlichtDevice* device, scene::IQ3LevelSceneNode* node)
+{
+	scene::ISceneManager* smgr = device->getSceneManager();
+	scene::ICameraSceneNode* camera = smgr->getActiveCamera();
+
+	bool result = true;
+
+	// the start position of example 02 is inside the level
+	camera->setPosition(core::vector3df(0,0,0));
+	camera->setTarget(core::vector3df(0,0,100));
+	drawFrames(device, 1);
+
+	const u32 consideredPVS = node->getConsideredFaceCount();
+	const u32 drawnPVS = node->getDrawnFaceCount();
+	result &= node->getCameraCluster() >= 0;
+	result &= drawnPVS > 0 && drawnPVS <= consideredPVS;
+
+	node->setPVSCulling(false);
+	drawFrames(device, 1);
+	const u32 consideredAll = node->getConsideredFaceCount();
+	result &= consideredPVS < consideredAll;
+	result &= drawnPVS <= node->getDrawnFaceCount();
+
+	// without frustum culling all potentially visible faces are drawn
+	node->setPVSCulling(true);
+	node->setFrustumCulling(false);
+	drawFrames(device, 1);
+	result &= node->getConsideredFaceCount() == consideredPVS;
+	result &= node->getDrawnFaceCount() == consideredPVS;
+	node->setFrustumCulling(true);
+
+	// outside of the level nothing can be culled by the visibility data
+	camera->setPosition(core::vector3df(0,10000,0));
+	drawFrames(device, 1);
+	result &= node->getCameraCluster() == -1;
+	result &= node->getConsideredFaceCount() == consideredAll;
+
+	if (!result)
+		logTestString("PVS culling failed, considered %u of %u faces, drew %u.\n",
+			consideredPVS, consideredAll, drawnPVS);
+
+	return result;
+}
+
+//! Compares the octree scene node with the pvs scene node on the map of example 02
+void benchmark(IrrlichtDevice* device, scene::IAnimatedMesh* mesh, scene::IQ3LevelSceneNode* node)
+{
+	scene::ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ICameraSceneNode* camera = smgr->getActiveCamera();
+
+	scene::ISceneNode* octree = smgr->addOctreeSceneNode(mesh->getMesh(scene::quake3::E_Q3_MESH_GEOMETRY), 0, -1, 1024);
+	if (!octree)
+		return;
+	octree->setPosition(node->getPosition());
+
+	const core::vector3df positions[] =
+	{
+		core::vector3df(0,0,0),
+		core::vector3df(0,50,-250),
+		core::vector3df(200,0,250)
+	};
+	const u32 frames = 50;
+
+	for (u32 i=0; i<sizeof(positions)/sizeof(positions[0]); ++i)
+	{
+		camera->setPosition(positions[i]);
+		camera->setTarget(positions[i] + core::vector3df(0,0,100));
+
+		octree->setVisible(true);
+		node->setVisible(false);
+		const u32 octreeTime = drawFrames(device, frames);
+		const u32 octreePrimitives = driver->getPrimitiveCountDrawn();
+
+		octree->setVisible(false);
+		node->setVisible(true);
+		const u32 pvsTime = drawFrames(device, frames);
+		const u32 pvsPrimitives = driver->getPrimitiveCountDrawn();
+
+		logTestString("q3 level at (%.0f,%.0f,%.0f): octree %u primitives %u ms, "
+			"pvs %u primitives %u ms, %u of %u faces drawn\n",
+			positions[i].X, positions[i].Y, positions[i].Z,
+			octreePrimitives, octreeTime, pvsPrimitives, pvsTime,
+			node->getDrawnFaceCount(), node->getConsideredFaceCount());
+	}
+
+	octree->remove();
+}
+
+} // end anonymous namespace
+
+
+//! Tests the scene node which culls quake3 levels with their potentially visible set
+bool q3LevelSceneNode()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, core::dimension2d<u32>(160, 120));
+	if (!device)
+		return true; // No error if device does not exist
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	device->getFileSystem()->addFileArchive("../media/map-20kdm2.pk3");
+	scene::IAnimatedMesh* mesh = smgr->getMesh("20kdm2.bsp");
+	if (!mesh || mesh->getMeshType() != scene::EAMT_BSP)
+	{
+		logTestString("Could not load 20kdm2.bsp.\n");
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	scene::IQ3LevelMesh* level = (scene::IQ3LevelMesh*)mesh;
+	bool result = !level->getLeafs().empty();
+
+	scene::IQ3LevelSceneNode* node = smgr->addQ3LevelSceneNode(level);
+	result &= node != 0;
+
+	if (node)
+	{
+		node->setPosition(core::vector3df(-1300,-144,-1249));
+		smgr->addCameraSceneNode();
+
+		result &= pvsCulling(device, node);
+		benchmark(device, mesh, node);
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,313 @@
+#include "testUtils.h"
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+
+static s32 getStat(video::IVideoDriver* driver, const c8* name)
+{
+	return driver->getDriverAttributes().getAttributeAsInt(name);
+}
+
+// Render states which are already set are skipped and counted per frame
+static bool testRedundantStates(video::E_DRIVER_TYPE driverType)
+{
+	IrrlichtDevice* device = createDevice(driverType, dimension2du(160, 120));
+	if (!device)
+		return true; // No error if device does not exist
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	smgr->addCameraSceneNode(0, vector3df(0,0,-40), vector3df(0,0,0));
+
+	scene::ISceneNode* cube = smgr->addCubeSceneNode(10.f, 0, -1, vector3df(-10,0,0));
+	cube->setMaterialFlag(video::EMF_LIGHTING, false);
+
+	scene::ISceneNode* sphere = smgr->addSphereSceneNode(5.f, 16, 0, -1, vector3df(10,0,0));
+	sphere->setMaterialFlag(video::EMF_LIGHTING, false);
+	sphere->setMaterialFlag(video::EMF_WIREFRAME, true);
+
+	s32 issued[3];
+	s32 skipped[3];
+	for (u32 frame=0; frame<3; ++frame)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+		smgr->drawAll();
+		// the 2d drawing resets all states of the next 3d material
+		driver->draw2DRectangle(video::SColor(255,255,255,255), recti(0,0,10,10));
+		driver->endScene();
+
+		issued[frame] = getStat(driver, "StateCallsIssued");
+		skipped[frame] = getStat(driver, "StateCallsSkipped");
+	}
+
+	bool result = true;
+	if (driverType == video::EDT_OPENGL)
+	{
+		result &= issued[0] > 0;
+		// the same frame does not send more states than the one before
+		result &= issued[2] <= issued[1];
+		result &= skipped[2] > 0;
+	}
+	else
+	{
+		// only counted by the OpenGL driver
+		for (u32 frame=0; frame<3; ++frame)
+			result &= issued[frame] == 0 && skipped[frame] == 0;
+	}
+
+	if (!result)
+		logTestString("State calls issued %d %d %d, skipped %d %d %d\n",
+			issued[0], issued[1], issued[2], skipped[0], skipped[1], skipped[2]);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	assert_log( result );
+
+	return result;
+}
+
+// Sets the pixel color from a uniform, the value is changed between draw calls
+class CColorCallback : public video::IShaderConstantSetCallBack
+{
+public:
+	CColorCallback() : ColorID(-1)
+	{
+		setColor(video::SColorf(0.f, 0.f, 0.f));
+	}
+
+	virtual void OnSetConstants(video::IMaterialRendererServices* services, s32 userData)
+	{
+		if (ColorID == -1)
+			ColorID = services->getPixelShaderConstantID("Color");
+		services->setPixelShaderConstant(ColorID, Color, 4);
+	}
+
+	void setColor(const video::SColorf& color)
+	{
+		Color[0] = color.r;
+		Color[1] = color.g;
+		Color[2] = color.b;
+		Color[3] = color.a;
+	}
+
+private:
+	s32 ColorID;
+	f32 Color[4];
+};
+
+// Draws a quad covering the given pixels with identity transformations
+static void drawQuad(video::IVideoDriver* driver, const recti& rect, video::SColor color, f32 z=0.f)
+{
+	const dimension2du& size = driver->getScreenSize();
+	const f32 left = -1.f + 2.f * rect.UpperLeftCorner.X / size.Width;
+	const f32 right = -1.f + 2.f * rect.LowerRightCorner.X / size.Width;
+	const f32 top = 1.f - 2.f * rect.UpperLeftCorner.Y / size.Height;
+	const f32 bottom = 1.f - 2.f * rect.LowerRightCorner.Y / size.Height;
+
+	const video::S3DVertex vertices[4] = {
+		video::S3DVertex(left, top, z, 0.f, 0.f, -1.f, color, 0.f, 0.f),
+		video::S3DVertex(right, top, z, 0.f, 0.f, -1.f, color, 1.f, 0.f),
+		video::S3DVertex(right, bottom, z, 0.f, 0.f, -1.f, color, 1.f, 1.f),
+		video::S3DVertex(left, bottom, z, 0.f, 0.f, -1.f, color, 0.f, 1.f) };
+	const u16 indices[6] = { 0,1,2, 0,2,3 };
+
+	driver->drawIndexedTriangleList(vertices, 4, indices, 2);
+}
+
+static bool checkPixel(const video::IImage* image, const recti& rect, video::SColor expected, const c8* name)
+{
+	const position2di center = rect.getCenter();
+	const video::SColor color = image->getPixel(center.X, center.Y);
+
+	const bool result = abs_((s32)color.getRed() - (s32)expected.getRed()) <= 8 &&
+		abs_((s32)color.getGreen() - (s32)expected.getGreen()) <= 8 &&
+		abs_((s32)color.getBlue() - (s32)expected.getBlue()) <= 8;
+	if (!result)
+		logTestString("%s: expected %u %u %u, got %u %u %u\n", name, expected.getRed(), expected.getGreen(),
+			expected.getBlue(), color.getRed(), color.getGreen(), color.getBlue());
+
+	return result;
+}
+
+// Minified checker texels are either mixed to gray or taken as they are
+static bool checkFiltered(const video::IImage* image, const recti& rect, bool filtered, const c8* name)
+{
+	const position2di center = rect.getCenter();
+	const u32 red = image->getPixel(center.X, center.Y).getRed();
+
+	const bool result = filtered == (red > 64 && red < 192);
+	if (!result)
+		logTestString("%s: expected %s texels, got %u\n", name, filtered ? "filtered" : "unfiltered", red);
+
+	return result;
+}
+
+// States which were changed since they were cached are sent to OpenGL again,
+// checked by reading back the drawn pixels
+static bool testChangedStates(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_OPENGL, dimension2du(160, 120), 32);
+	if (!device)
+		return true; // No error if device does not exist
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, false);
+	video::IImage* image = driver->createImage(video::ECF_A8R8G8B8, dimension2du(16, 16));
+	for (u32 y=0; y<16; ++y)
+		for (u32 x=0; x<16; ++x)
+			image->setPixel(x, y, ((x+y) & 1) ? video::SColor(255,255,255,255) : video::SColor(255,0,0,0));
+	video::ITexture* checker = driver->addTexture("checker", image);
+	image->drop();
+
+	video::IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
+	CColorCallback* callback = new CColorCallback();
+	s32 uniformMaterial = -1;
+	if (gpu && driver->queryFeature(video::EVDF_ARB_GLSL))
+	{
+		uniformMaterial = gpu->addHighLevelShaderMaterial(
+			"void main(void)\n { gl_Position = ftransform(); }",
+			"uniform vec4 Color;\n void main(void)\n { gl_FragColor = Color; }",
+			callback);
+	}
+
+	const video::SColor white(255,255,255,255);
+	const video::SColor black(255,0,0,0);
+	const video::SColor red(255,255,0,0);
+	const video::SColor green(255,0,255,0);
+	const recti rect2D(150,110,158,118);
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, black);
+
+	driver->setTransform(video::ETS_PROJECTION, IdentityMatrix);
+	driver->setTransform(video::ETS_VIEW, IdentityMatrix);
+	driver->setTransform(video::ETS_WORLD, IdentityMatrix);
+
+	// 2d drawing disables the depth test, it is enabled by a material
+	// changed after 2d drawing and again by the same material after the
+	// next 2d drawing
+	video::SMaterial material;
+	material.Lighting = false;
+	material.BackfaceCulling = false;
+	material.ZBuffer = video::ECFN_DISABLED;
+	driver->setMaterial(material);
+	drawQuad(driver, recti(4,4,12,12), red);
+	drawQuad(driver, recti(4,4,12,12), white, 0.5f);
+
+	driver->draw2DRectangle(white, rect2D);
+	material.ZBuffer = video::ECFN_LESSEQUAL;
+	driver->setMaterial(material);
+	drawQuad(driver, recti(16,4,24,12), red);
+	drawQuad(driver, recti(16,4,24,12), white, 0.5f);
+
+	driver->draw2DRectangle(white, rect2D);
+	driver->setMaterial(material);
+	drawQuad(driver, recti(28,4,36,12), red);
+	drawQuad(driver, recti(28,4,36,12), white, 0.5f);
+
+	// the ambient color is set again after it followed the vertex colors
+	driver->setAmbientLight(video::SColorf(1.f, 1.f, 1.f, 1.f));
+	material.Lighting = true;
+	material.ColorMaterial = video::ECM_NONE;
+	material.AmbientColor = green;
+	material.DiffuseColor = black;
+	material.SpecularColor = black;
+	material.EmissiveColor = black;
+	driver->setMaterial(material);
+	drawQuad(driver, recti(4,20,12,28), red);
+	material.ColorMaterial = video::ECM_AMBIENT;
+	driver->setMaterial(material);
+	drawQuad(driver, recti(16,20,24,28), red);
+	material.ColorMaterial = video::ECM_NONE;
+	driver->setMaterial(material);
+	drawQuad(driver, recti(28,20,36,28), red);
+
+	// changing only the filter mode updates the minification filter
+	material = video::SMaterial();
+	material.Lighting = false;
+	material.BackfaceCulling = false;
+	material.UseMipMaps = false;
+	material.setTexture(0, checker);
+	material.TextureLayer[0].BilinearFilter = false;
+	driver->setMaterial(material);
+	drawQuad(driver, recti(4,36,12,44), white);
+	material.TextureLayer[0].BilinearFilter = true;
+	driver->setMaterial(material);
+	drawQuad(driver, recti(16,36,24,44), white);
+	material.TextureLayer[0].BilinearFilter = false;
+	material.TextureLayer[0].TrilinearFilter = true;
+	driver->setMaterial(material);
+	drawQuad(driver, recti(28,36,36,44), white);
+	material.TextureLayer[0].TrilinearFilter = false;
+	driver->setMaterial(material);
+	drawQuad(driver, recti(40,36,48,44), white);
+
+	// uniforms are sent again with a new value
+	if (uniformMaterial != -1)
+	{
+		material = video::SMaterial();
+		material.Lighting = false;
+		material.BackfaceCulling = false;
+		material.MaterialType = (video::E_MATERIAL_TYPE)uniformMaterial;
+		driver->setMaterial(material);
+		callback->setColor(video::SColorf(1.f, 0.f, 0.f));
+		drawQuad(driver, recti(4,52,12,60), white);
+		callback->setColor(video::SColorf(0.f, 1.f, 0.f));
+		drawQuad(driver, recti(16,52,24,60), white);
+		callback->setColor(video::SColorf(1.f, 0.f, 0.f));
+		drawQuad(driver, recti(28,52,36,60), white);
+	}
+
+	driver->endScene();
+
+	bool result = false;
+	video::IImage* screenshot = driver->createScreenShot(video::ECF_A8R8G8B8);
+	if (screenshot)
+	{
+		result = checkPixel(screenshot, recti(4,4,12,12), white, "Depth test disabled");
+		result &= checkPixel(screenshot, recti(16,4,24,12), red, "Depth test after 2d");
+		result &= checkPixel(screenshot, recti(28,4,36,12), red, "Depth test after second 2d");
+
+		result &= checkPixel(screenshot, recti(4,20,12,28), green, "Ambient color");
+		result &= checkPixel(screenshot, recti(16,20,24,28), red, "Ambient vertex color");
+		result &= checkPixel(screenshot, recti(28,20,36,28), green, "Ambient color after vertex color");
+
+		result &= checkFiltered(screenshot, recti(4,36,12,44), false, "Nearest filter");
+		result &= checkFiltered(screenshot, recti(16,36,24,44), true, "Bilinear filter");
+		result &= checkFiltered(screenshot, recti(28,36,36,44), true, "Trilinear filter");
+		result &= checkFiltered(screenshot, recti(40,36,48,44), false, "Nearest filter after trilinear");
+
+		if (uniformMaterial != -1)
+		{
+			result &= checkPixel(screenshot, recti(4,52,12,60), red, "Uniform");
+			result &= checkPixel(screenshot, recti(16,52,24,60), green, "Changed uniform");
+			result &= checkPixel(screenshot, recti(28,52,36,60), red, "Uniform changed back");
+		}
+
+		screenshot->drop();
+	}
+
+	callback->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	assert_log( result );
+
+	return result;
+}
+
+bool renderStateCache(void)
+{
+	bool result = true;
+	result &= testRedundantStates(video::EDT_NULL);
+	result &= testRedundantStates(video::EDT_OPENGL);
+	result &= testChangedStates();
+
+	return result;
+}
@@ -0,0 +1,269 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+// Calculates the absolute transformation from scratch, like it was done before caching
+matrix4 referenceTransformation(const ISceneNode* node)
+{
+	matrix4 mat;
+	mat.setRotationDegrees(node->getRotation());
+	mat.setTranslation(node->getPosition());
+	if (node->getScale() != vector3df(1.f,1.f,1.f))
+	{
+		matrix4 smat;
+		smat.setScale(node->getScale());
+		mat *= smat;
+	}
+
+	if (node->getParent() && node->getParent()->getParent())
+		return referenceTransformation(node->getParent()) * mat;
+	return mat;
+}
+
+bool compareTransformations(const array<ISceneNode*>& nodes)
+{
+	for (u32 i=0; i<nodes.size(); ++i)
+	{
+		if (nodes[i]->getAbsoluteTransformation() != referenceTransformation(nodes[i]))
+		{
+			logTestString("Absolute transformation of node %u differs\n", i);
+			return false;
+		}
+	}
+	return true;
+}
+
+void animate(ISceneManager* smgr, u32 time)
+{
+	smgr->getRootSceneNode()->OnAnimate(time);
+}
+
+// Adds trees of 100 nodes, 3 levels deep
+void addTrees(ISceneNode* root, u32 count, array<ISceneNode*>& nodes)
+{
+	ISceneManager* smgr = root->getSceneManager();
+	for (u32 t=0; t<count; ++t)
+	{
+		ISceneNode* a = smgr->addEmptySceneNode(root);
+		a->setRotation(vector3df((f32)(t%360), 0, 0));
+		nodes.push_back(a);
+		for (u32 j=0; j<9; ++j)
+		{
+			ISceneNode* b = smgr->addEmptySceneNode(a);
+			b->setPosition(vector3df(0, (f32)j, 0));
+			nodes.push_back(b);
+			for (u32 k=0; k<10; ++k)
+			{
+				ISceneNode* c = smgr->addEmptySceneNode(b);
+				c->setRotation(vector3df(0, (f32)(k*36), 0));
+				nodes.push_back(c);
+			}
+		}
+	}
+}
+
+bool transformHierarchy(IrrlichtDevice* device)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	ISceneNode* root = smgr->addEmptySceneNode();
+	array<ISceneNode*> nodes;
+	addTrees(root, 10, nodes);
+
+	ITransformHierarchy* hierarchy = smgr->createTransformHierarchy(root);
+	bool result = hierarchy->getNodeCount() == 1001;
+
+	hierarchy->update();
+	result &= hierarchy->getUpdatedNodeCount() == 1001;
+	result &= compareTransformations(nodes);
+
+	hierarchy->update();
+	result &= hierarchy->getUpdatedNodeCount() == 0;
+
+	// a moved node updates its subtree, in the arrays and in the nodes
+	nodes[1]->setPosition(vector3df(5.f, 0, 0));
+	hierarchy->update();
+	result &= hierarchy->getUpdatedNodeCount() == 11;
+	result &= compareTransformations(nodes);
+	const s32 handle = nodes[2]->getTransformHandle();
+	result &= hierarchy->getNode(handle) == nodes[2];
+	result &= hierarchy->getNode(hierarchy->getParentHandle(handle)) == nodes[1];
+	result &= hierarchy->getAbsoluteTransformation(handle) == nodes[2]->getAbsoluteTransformation();
+
+	// nothing is left for OnAnimate
+	const u32 version = nodes[2]->getTransformVersion();
+	animate(smgr, 0);
+	result &= nodes[2]->getTransformVersion() == version;
+
+	// the root follows its parent
+	root->setPosition(vector3df(0, 0, 10.f));
+	hierarchy->update();
+	result &= hierarchy->getUpdatedNodeCount() == 1001;
+	result &= compareTransformations(nodes);
+
+	// reparented and removed nodes
+	nodes[150]->setParent(nodes[0]);
+	ISceneNode* removed = nodes[301];
+	removed->grab();
+	removed->remove();
+	hierarchy->update();
+	result &= removed->getTransformHierarchy() == 0 && removed->getTransformHandle() == -1;
+	result &= hierarchy->getNodeCount() == 1001 - 11;
+	removed->drop();
+	nodes.erase(301, 11);
+	result &= compareTransformations(nodes);
+
+	hierarchy->drop();
+	result &= nodes[0]->getTransformHierarchy() == 0;
+	root->remove();
+
+	if (!result)
+		logTestString("Transform hierarchy test failed.\n");
+
+	return result;
+}
+
+// Logs the time of the recursive and the flat update of 100000 nodes, never fails
+void hierarchySpeed(IrrlichtDevice* device)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	ISceneNode* root = smgr->addEmptySceneNode();
+	array<ISceneNode*> nodes;
+	addTrees(root, 1000, nodes);
+	animate(smgr, 0);
+
+	const u32 FRAMES = 20;
+	u32 times[4];
+	for (u32 pass=0; pass<2; ++pass)
+	{
+		ITransformHierarchy* hierarchy = pass ? smgr->createTransformHierarchy(root) : 0;
+		if (hierarchy)
+			hierarchy->update();
+
+		for (u32 step=0; step<2; ++step)
+		{
+			// all nodes or every 97th node moves
+			const u32 stride = step ? 97 : 1;
+			const u32 then = timer->getRealTime();
+			for (u32 f=0; f<FRAMES; ++f)
+			{
+				for (u32 i=0; i<nodes.size(); i+=stride)
+					nodes[i]->setPosition(vector3df((f32)f, (f32)i, 0));
+				if (hierarchy)
+					hierarchy->update();
+				else
+					root->OnAnimate(f);
+			}
+			times[pass*2+step] = timer->getRealTime() - then;
+		}
+
+		if (hierarchy)
+			hierarchy->drop();
+	}
+	root->remove();
+
+	logTestString("Transformation update of %u nodes in %u frames\n    all moving: recursive = %u, hierarchy = %u\n    1%% moving: recursive = %u, hierarchy = %u\n",
+		nodes.size(), FRAMES, times[0], times[2], times[1], times[3]);
+}
+
+}
+
+//! Tests that only changed transformations are recalculated and that the results stay the same
+bool sceneNodeTransform()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2d<u32>(160, 120));
+	if (!device)
+		return true; // No error if device does not exist
+
+	ISceneManager* smgr = device->getSceneManager();
+
+	// 4 levels deep trees with 4 children per node
+	IRandomizer* random = device->getRandomizer();
+	array<ISceneNode*> nodes;
+	for (u32 i=0; i<340; ++i)
+	{
+		ISceneNode* parent = i < 4 ? 0 : nodes[i/4 - 1];
+		ISceneNode* node = smgr->addEmptySceneNode(parent);
+		node->setPosition(vector3df((f32)(random->rand()%200-100), (f32)(random->rand()%200-100), (f32)(random->rand()%200-100)));
+		node->setRotation(vector3df((f32)(random->rand()%360), (f32)(random->rand()%360), (f32)(random->rand()%360)));
+		if (i%3 == 0)
+			node->setScale(vector3df(0.5f + (random->rand()%10)*0.1f, 1.f, 2.f));
+		nodes.push_back(node);
+	}
+
+	animate(smgr, 0);
+	bool result = compareTransformations(nodes);
+
+	// nothing changed, nothing is recalculated
+	array<u32> versions;
+	for (u32 i=0; i<nodes.size(); ++i)
+		versions.push_back(nodes[i]->getTransformVersion());
+	animate(smgr, 10);
+	for (u32 i=0; i<nodes.size(); ++i)
+		result &= nodes[i]->getTransformVersion() == versions[i];
+
+	// moving a node updates its subtree only
+	nodes[1]->setRotation(vector3df(10.f, 20.f, 30.f));
+	nodes[7]->setScale(vector3df(3.f, 3.f, 3.f));
+	animate(smgr, 20);
+	result &= compareTransformations(nodes);
+	result &= nodes[1]->getTransformVersion() != versions[1];
+	result &= nodes[8]->getTransformVersion() != versions[8];	// child of nodes[1]
+	result &= nodes[7]->getTransformVersion() != versions[7];
+	result &= nodes[35]->getTransformVersion() != versions[35];	// child of nodes[7]
+	result &= nodes[0]->getTransformVersion() == versions[0];
+	result &= nodes[2]->getTransformVersion() == versions[2];
+	result &= nodes[12]->getTransformVersion() == versions[12];	// child of nodes[2]
+
+	// reparenting uses the transformation of the new parent
+	nodes[20]->setParent(nodes[3]);
+	animate(smgr, 30);
+	result &= compareTransformations(nodes);
+
+	nodes[20]->setParent(smgr->getRootSceneNode());
+	animate(smgr, 40);
+	result &= compareTransformations(nodes);
+
+	// dummy transformation nodes changed through the matrix reference
+	IDummyTransformationSceneNode* dummy = smgr->addDummyTransformationSceneNode();
+	ISceneNode* child = smgr->addEmptySceneNode(dummy);
+	child->setPosition(vector3df(1.f, 2.f, 3.f));
+	animate(smgr, 50);
+	dummy->getRelativeTransformationMatrix().setTranslation(vector3df(10.f, 0, 0));
+	animate(smgr, 60);
+	result &= child->getAbsolutePosition().equals(vector3df(11.f, 2.f, 3.f));
+
+	// reading the scene attributes resets the root transformation
+	ISceneNode* root = smgr->getRootSceneNode();
+	root->setPosition(vector3df(100.f, 0, 0));
+	root->updateAbsolutePosition();
+	animate(smgr, 70);
+	io::IAttributes* attributes = device->getFileSystem()->createEmptyAttributes();
+	root->deserializeAttributes(attributes);
+	attributes->drop();
+	result &= root->getAbsoluteTransformation().isIdentity();
+	animate(smgr, 80);
+	result &= compareTransformations(nodes);
+
+	if (!result)
+		logTestString("Scene node transformation test failed.\n");
+
+	result &= transformHierarchy(device);
+	hierarchySpeed(device);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	assert_log(result);
+
+	return result;
+}
@@ -334,6 +334,61 @@ bool stringSerialization(io::IFileSystem * fs)
 	return true;
 }
 
+// Name lookups and handles have to stay valid when attributes get added and removed
+bool attributeLookup(io::IFileSystem * fs)
+{
+	io::IAttributes* attr = fs->createEmptyAttributes();
+
+	io::SAttributeHandle handle = attr->getAttributeHandle("Value50");
+	COMPARE(attr->findAttribute(handle), -1);
+	COMPARE(attr->getAttributeAsInt(handle, -7), -7);
+
+	for ( s32 i=0; i<100; ++i )
+	{
+		core::stringc name("Value");
+		name += i;
+		attr->addInt(name.c_str(), i);
+	}
+
+	for ( s32 i=0; i<100; ++i )
+	{
+		core::stringc name("Value");
+		name += i;
+		COMPARE(attr->findAttribute(name.c_str()), i);
+		COMPARE(attr->getAttributeAsInt(name.c_str()), i);
+	}
+	COMPARE(attr->findAttribute("Value100"), -1);
+
+	// handle resolves attributes added after its creation
+	COMPARE(attr->getAttributeAsInt(handle), 50);
+
+	// removing an attribute moves the following ones
+	attr->setAttribute("Value10", (const c8*)0);
+	COMPARE(attr->getAttributeCount(), 99);
+	COMPARE(attr->findAttribute("Value10"), -1);
+	COMPARE(attr->findAttribute("Value11"), 10);
+	COMPARE(attr->findAttribute(handle), 49);
+	COMPARE(attr->getAttributeAsInt(handle), 50);
+
+	// first attribute with a name wins, as before
+	attr->addInt("Value20", 1000);
+	COMPARE(attr->getAttributeAsInt("Value20"), 20);
+
+	io::SAttributeHandle boolHandle = attr->getAttributeHandle("ValBool");
+	attr->addBool("ValBool", true);
+	COMPARE(attr->getAttributeAsBool(boolHandle), true);
+	attr->setAttribute("ValBool", false);
+	COMPARE(attr->getAttributeAsBool(boolHandle, true), false);
+
+	attr->clear();
+	COMPARE(attr->findAttribute("Value11"), -1);
+	COMPARE(attr->getAttributeAsFloat(handle, 2.f), 2.f);
+
+	attr->drop();
+
+	return true;
+}
+
 bool serializeAttributes()
 {
 	bool result = true;
@@ -370,6 +425,12 @@ bool serializeAttributes()
 		logTestString("stringSerialization failed in %s:%d\n", __FILE__, __LINE__ );
 	}
 
+	result &= attributeLookup(fs);
+	if ( !result )
+	{
+		logTestString("attributeLookup failed in %s:%d\n", __FILE__, __LINE__ );
+	}
+
 	device->closeDevice();
 	device->run();
 	device->drop();
@@ -0,0 +1,76 @@
+#include "testUtils.h"
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+
+namespace
+{
+
+u32 drawFrame(IrrlichtDevice* device, scene::IShadowVolumeSceneNode* shadow)
+{
+	device->getVideoDriver()->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH | video::ECBF_STENCIL, video::SColor(255,0,0,0));
+	device->getSceneManager()->drawAll();
+	device->getVideoDriver()->endScene();
+	return shadow->getRebuiltVolumeCount();
+}
+
+} // end anonymous namespace
+
+// Shadow volumes are kept while nothing changes, and rebuilt when the
+// light moves relative to the mesh or the mesh changes
+bool shadowVolumeCache(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_BURNINGSVIDEO, dimension2du(160, 120), 16, false, true);
+	if (!device)
+		return true; // No error if device does not exist
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	if (!device->getVideoDriver()->queryFeature(video::EVDF_STENCIL_BUFFER))
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return true;
+	}
+
+	smgr->addCameraSceneNode(0, vector3df(0,30,-40), vector3df(0,0,0));
+
+	scene::IMesh* mesh = smgr->getGeometryCreator()->createCubeMesh(vector3df(10,10,10));
+	scene::IMeshSceneNode* node = smgr->addMeshSceneNode(mesh);
+	mesh->drop();
+	scene::IShadowVolumeSceneNode* shadow = node->addShadowVolumeSceneNode();
+
+	scene::ILightSceneNode* light = smgr->addLightSceneNode(0, vector3df(10,30,10));
+	light->setRadius(500.f);
+
+	bool result = shadow != 0;
+	if (shadow)
+	{
+		result &= drawFrame(device, shadow) == 1;
+		result &= drawFrame(device, shadow) == 0;
+
+		light->setPosition(vector3df(-10,30,10));
+		result &= drawFrame(device, shadow) == 1;
+		result &= drawFrame(device, shadow) == 0;
+
+		// moving the node moves the light in mesh space
+		node->setPosition(vector3df(5,0,0));
+		result &= drawFrame(device, shadow) == 1;
+		result &= drawFrame(device, shadow) == 0;
+
+		scene::IMeshBuffer* buffer = mesh->getMeshBuffer(0);
+		buffer->getPosition(0).Y += 1.f;
+		buffer->setDirty(scene::EBT_VERTEX);
+		result &= drawFrame(device, shadow) == 1;
+		result &= drawFrame(device, shadow) == 0;
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	assert_log( result );
+
+	return result;
+}
@@ -0,0 +1,105 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+
+//! Tests culling of nodes behind occluders with the software occlusion culler
+bool softwareOcclusion()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, core::dimension2d<u32>(160, 120));
+	if (!device)
+		return true; // No error if device does not exist
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::IOcclusionCuller* culler = smgr->getOcclusionCuller();
+
+	smgr->addCameraSceneNode(0, core::vector3df(0,0,0), core::vector3df(0,0,100));
+
+	// a wall in front of the camera
+	scene::IMeshSceneNode* wall = smgr->addCubeSceneNode(10.f, 0, -1,
+		core::vector3df(0,0,100), core::vector3df(0,0,0), core::vector3df(10,4,1));
+	bool result = culler->addOccluder(wall);
+	result &= culler->getOccluderCount() == 1;
+
+	// nodes behind, in front of and beside the wall
+	const core::vector3df positions[] =
+	{
+		core::vector3df(0,0,200),
+		core::vector3df(-30,10,300),
+		core::vector3df(0,0,50),
+		core::vector3df(150,0,200),
+		core::vector3df(45,0,400)
+	};
+	const bool hidden[] = { true, true, false, false, true };
+	const u32 count = sizeof(positions) / sizeof(positions[0]);
+
+	scene::ISceneNode* nodes[count];
+	for (u32 i=0; i<count; ++i)
+	{
+		nodes[i] = smgr->addCubeSceneNode(5.f, 0, -1, positions[i]);
+		nodes[i]->setAutomaticCulling(scene::EAC_FRUSTUM_BOX | scene::EAC_OCC_SOFTWARE);
+	}
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	smgr->drawAll();
+	driver->endScene();
+
+	result &= culler->getRasterizedTriangleCount() > 0;
+
+	// only the hidden nodes were culled by the occlusion culler
+	u32 expectedOccluded = 0;
+	for (u32 i=0; i<count; ++i)
+	{
+		if (hidden[i])
+			++expectedOccluded;
+		if (smgr->isCulled(nodes[i]) != hidden[i])
+		{
+			logTestString("Node %u at (%.0f,%.0f,%.0f) is wrongly %s.\n", i,
+				positions[i].X, positions[i].Y, positions[i].Z, hidden[i] ? "visible" : "culled");
+			result = false;
+		}
+	}
+	result &= culler->getOccludedCount() == expectedOccluded * 2;
+
+	// invisible occluders hide nothing
+	wall->setVisible(false);
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	smgr->drawAll();
+	driver->endScene();
+
+	result &= culler->getRasterizedTriangleCount() == 0;
+	result &= !smgr->isCulled(nodes[0]);
+
+	culler->removeOccluder(wall);
+	result &= culler->getOccluderCount() == 0;
+
+	// occluders removed from the scene are released, nodes behind them are visible again
+	wall->setVisible(true);
+	result &= culler->addOccluder(wall);
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	smgr->drawAll();
+	driver->endScene();
+
+	result &= smgr->isCulled(nodes[0]);
+
+	wall->remove();
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	smgr->drawAll();
+	driver->endScene();
+
+	result &= culler->getOccluderCount() == 0;
+	result &= culler->getRasterizedTriangleCount() == 0;
+	result &= !smgr->isCulled(nodes[0]);
+
+	if (!result)
+		logTestString("Software occlusion culling failed.\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,163 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+
+namespace
+{
+
+//! A box which counts how often it was drawn
+class CCountingSceneNode : public scene::ISceneNode
+{
+public:
+	CCountingSceneNode(scene::ISceneNode* parent, scene::ISceneManager* mgr, const core::vector3df& position)
+		: scene::ISceneNode(parent, mgr, -1, position), Box(-1,-1,-1,1,1,1), Drawn(0)
+	{
+		setAutomaticCulling(scene::EAC_FRUSTUM_BOX);
+	}
+
+	virtual void OnRegisterSceneNode()
+	{
+		if (IsVisible)
+			SceneManager->registerNodeForRendering(this);
+		ISceneNode::OnRegisterSceneNode();
+	}
+
+	virtual void render()
+	{
+		++Drawn;
+	}
+
+	virtual const core::aabbox3d<f32>& getBoundingBox() const
+	{
+		return Box;
+	}
+
+	core::aabbox3df Box;
+	u32 Drawn;
+};
+
+//! Draws a frame and returns a bit for every node which was drawn
+core::array<bool> drawFrame(scene::ISceneManager* smgr, const core::array<CCountingSceneNode*>& nodes)
+{
+	for (u32 i=0; i<nodes.size(); ++i)
+		nodes[i]->Drawn = 0;
+
+	smgr->getVideoDriver()->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	smgr->drawAll();
+	smgr->getVideoDriver()->endScene();
+
+	core::array<bool> drawn;
+	for (u32 i=0; i<nodes.size(); ++i)
+		drawn.push_back(nodes[i]->Drawn != 0);
+	return drawn;
+}
+
+//! Draws two frames and compares the drawn nodes with those which are not culled by isCulled
+bool compareCulling(scene::ISceneManager* smgr, const core::array<CCountingSceneNode*>& nodes, const char* step)
+{
+	bool result = true;
+
+	// the first frame after a change tests changed nodes on their own,
+	// the second one finds them in the spatial index
+	for (u32 frame=0; frame<2; ++frame)
+	{
+		const core::array<bool> drawn = drawFrame(smgr, nodes);
+
+		u32 visible = 0;
+		for (u32 i=0; i<nodes.size(); ++i)
+		{
+			const bool expected = !smgr->isCulled(nodes[i]);
+			if (expected)
+				++visible;
+			result &= drawn[i] == expected;
+		}
+
+		result &= visible != 0 && visible != nodes.size();
+		if (!result)
+		{
+			logTestString("Spatial index culling differs %s, %u of %u nodes visible.\n", step, visible, nodes.size());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+} // end anonymous namespace
+
+
+//! Tests that culling with the spatial index of the scene manager draws the same nodes as the per node tests
+bool spatialIndexCulling()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, core::dimension2d<u32>(160, 120));
+	if (!device)
+		return true; // No error if device does not exist
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode(0, core::vector3df(0,0,0), core::vector3df(0,0,100));
+	camera->setFarValue(300.f);
+
+	// a grid of nodes around the camera, some attached to a moving parent
+	scene::ISceneNode* group = smgr->addEmptySceneNode();
+	group->setAutomaticCulling(scene::EAC_OFF);
+	core::array<CCountingSceneNode*> nodes;
+	for (s32 x=-10; x<10; ++x)
+	{
+		for (s32 z=-10; z<10; ++z)
+		{
+			scene::ISceneNode* parent = ((x+z) & 3) ? smgr->getRootSceneNode() : group;
+			CCountingSceneNode* node = new CCountingSceneNode(parent, smgr, core::vector3df(x*20.f, (z%3)*10.f, z*20.f));
+			nodes.push_back(node);
+			node->drop();
+		}
+	}
+
+	smgr->setSpatialIndexCulling(true);
+	bool result = compareCulling(smgr, nodes, "for a static scene");
+	result &= smgr->getSpatialIndexNodeCount() == nodes.size();
+
+	// moved nodes are updated in the index
+	group->setPosition(core::vector3df(0,0,150));
+	result &= compareCulling(smgr, nodes, "after moving nodes");
+
+	camera->setTarget(core::vector3df(-100,0,0));
+	result &= compareCulling(smgr, nodes, "after turning the camera");
+
+	nodes[0]->Box = core::aabbox3df(-1000,-1,-1,1000,1,1);
+	result &= compareCulling(smgr, nodes, "after changing a bounding box");
+
+	// the index releases removed nodes once a frame was drawn without them
+	CCountingSceneNode* removed = nodes.getLast();
+	removed->grab();
+	removed->remove();
+	nodes.erase(nodes.size()-1);
+	drawFrame(smgr, nodes);
+	result &= removed->getReferenceCount() == 2;
+	drawFrame(smgr, nodes);
+	result &= removed->getReferenceCount() == 1;
+	result &= removed->getSpatialIndexId() == -1;
+	removed->drop();
+	result &= smgr->getSpatialIndexNodeCount() == nodes.size();
+
+	// invisible nodes leave the index
+	group->setVisible(false);
+	drawFrame(smgr, nodes);
+	drawFrame(smgr, nodes);
+	result &= smgr->getSpatialIndexNodeCount() < nodes.size();
+
+	smgr->setSpatialIndexCulling(false);
+	result &= smgr->getSpatialIndexNodeCount() == 0;
+
+	if (!result)
+		logTestString("Spatial index culling failed.\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,101 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+
+//! Tests merging static mesh scene nodes into batches by material and cell
+bool staticBatch()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, core::dimension2d<u32>(160, 120));
+	if (!device)
+		return true; // No error if device does not exist
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	smgr->addCameraSceneNode(0, core::vector3df(90,0,-200), core::vector3df(90,0,100));
+
+	// 10x10 cubes with the same material in 2x2 cells
+	scene::ISceneNode* cubes[100];
+	for (u32 i=0; i<100; ++i)
+	{
+		cubes[i] = smgr->addCubeSceneNode(10.f, 0, -1,
+			core::vector3df((f32)(i%10)*20.f, 0, 100.f+(i/10)*20.f));
+	}
+
+	// a cube with another material gets its own batch
+	scene::ISceneNode* red = smgr->addCubeSceneNode(10.f, 0, -1, core::vector3df(0,20,100));
+	red->getMaterial(0).DiffuseColor.set(255,255,0,0);
+
+	// transparent and animated nodes are not batched
+	scene::ISceneNode* transparent = smgr->addCubeSceneNode(10.f, 0, -1, core::vector3df(0,40,100));
+	transparent->setMaterialType(video::EMT_TRANSPARENT_ADD_COLOR);
+	scene::ISceneNode* animated = smgr->addCubeSceneNode(10.f, 0, -1, core::vector3df(0,60,100));
+	scene::ISceneNodeAnimator* anim = smgr->createRotationAnimator(core::vector3df(0,1,0));
+	animated->addAnimator(anim);
+	anim->drop();
+
+	scene::IStaticBatchSceneNode* batch = smgr->createStaticBatch(0, 100.f);
+	bool result = batch != 0;
+	if (!batch)
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	result &= batch->getSourceNodeCount() == 101;
+	result &= batch->getBatchCount() == 5;
+	result &= !cubes[0]->isVisible() && !red->isVisible();
+	result &= transparent->isVisible() && animated->isVisible();
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	smgr->drawAll();
+	driver->endScene();
+
+	result &= batch->getDrawnBatchCount() == 5;
+
+	// a moved node is drawn on its own again
+	cubes[0]->setPosition(core::vector3df(0,0,-50));
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	smgr->drawAll();
+	driver->endScene();
+
+	result &= batch->getSourceNodeCount() == 100;
+	result &= batch->getBatchCount() == 5;
+	result &= cubes[0]->isVisible();
+
+	// removing the only node of a batch removes the batch
+	result &= batch->removeSourceNode(red);
+	result &= !batch->removeSourceNode(red);
+	result &= red->isVisible();
+	result &= batch->getBatchCount() == 4;
+
+	// removed nodes are dropped from the batches
+	cubes[1]->remove();
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	smgr->drawAll();
+	driver->endScene();
+
+	result &= batch->getSourceNodeCount() == 98;
+
+	// batches behind the camera are culled
+	smgr->getActiveCamera()->setTarget(core::vector3df(90,0,-300));
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	smgr->drawAll();
+	driver->endScene();
+
+	result &= batch->getDrawnBatchCount() == 0;
+
+	if (!result)
+		logTestString("Static batching failed.\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
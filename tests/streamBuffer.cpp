@@ -0,0 +1,195 @@
+#include "testUtils.h"
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+
+static s32 getStat(video::IVideoDriver* driver, const c8* name)
+{
+	return driver->getDriverAttributes().getAttributeAsInt(name);
+}
+
+// Allocations are aligned, drawn like client memory, and counted per frame
+static bool testAllocation(video::IVideoDriver* driver)
+{
+	bool result = true;
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+
+	const video::SStreamAllocation vertices = driver->allocateStream(video::ESB_VERTEX, 3*sizeof(video::S3DVertex));
+	const video::SStreamAllocation indices = driver->allocateStream(video::ESB_INDEX, 3*sizeof(u16));
+	result &= vertices.Data && vertices.Offset == 0 && vertices.Size == 3*sizeof(video::S3DVertex);
+	result &= indices.Data && indices.Offset == 0 && indices.Buffer == video::ESB_INDEX;
+
+	video::S3DVertex* v = static_cast<video::S3DVertex*>(vertices.Data);
+	v[0] = video::S3DVertex(0,0,0, 0,0,-1, 0xffffffff, 0,0);
+	v[1] = video::S3DVertex(1,0,0, 0,0,-1, 0xffffffff, 1,0);
+	v[2] = video::S3DVertex(0,1,0, 0,0,-1, 0xffffffff, 0,1);
+	u16* i = static_cast<u16*>(indices.Data);
+	i[0] = 0;
+	i[1] = 1;
+	i[2] = 2;
+	driver->drawStreamedPrimitiveList(vertices, 3, indices, 1);
+
+	// the next index allocation starts 4 byte aligned
+	const video::SStreamAllocation more = driver->allocateStream(video::ESB_INDEX, 2);
+	result &= more.Data && more.Offset == 8;
+
+	driver->setStreamBufferSize(video::ESB_VERTEX, 1024);
+	result &= !driver->allocateStream(video::ESB_VERTEX, 2000).Data;
+	result &= !driver->allocateStream(video::ESB_VERTEX, 0).Data;
+
+	driver->endScene();
+	result &= driver->getPrimitiveCountDrawn() == 1;
+	// counted are all allocations of the frame, also from before the resize
+	result &= getStat(driver, "StreamedBytes") == 3*sizeof(video::S3DVertex) + 8 + 4;
+	result &= getStat(driver, "StreamWaits") == 0;
+	result &= getStat(driver, "StreamOrphans") == 0;
+
+	assert_log( result );
+
+	return result;
+}
+
+// The ring waits for data still used by the GPU, and gets a new buffer when
+// a single frame fills it up
+static bool testRing(video::IVideoDriver* driver)
+{
+	bool result = true;
+
+	driver->setStreamBufferSize(video::ESB_VERTEX, 1024);
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	for (u32 i=0; i<3; ++i)
+		result &= driver->allocateStream(video::ESB_VERTEX, 300).Offset == i*300;
+	driver->endScene();
+	result &= getStat(driver, "StreamedBytes") == 900;
+
+	// does not fit behind the last frame, which the GPU is still working on
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	result &= driver->allocateStream(video::ESB_VERTEX, 300).Offset == 0;
+	driver->endScene();
+	result &= getStat(driver, "StreamWaits") == 1;
+
+	// some frames in flight fit into the ring
+	s32 waits = 0;
+	for (u32 frame=0; frame<10; ++frame)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+		result &= driver->allocateStream(video::ESB_VERTEX, 200).Data != 0;
+		driver->endScene();
+		waits += getStat(driver, "StreamWaits");
+		result &= getStat(driver, "StreamOrphans") == 0;
+	}
+	result &= waits == 0;
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	for (u32 i=0; i<4; ++i)
+		result &= driver->allocateStream(video::ESB_VERTEX, 300).Data != 0;
+	driver->endScene();
+	result &= getStat(driver, "StreamOrphans") == 1;
+
+	assert_log( result );
+
+	return result;
+}
+
+// Particles are written to the vertex stream, with all vertex members as
+// the stream still holds data of older draw calls
+static bool testParticles(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	const u32 streamSize = 1024*1024;
+	driver->setStreamBufferSize(video::ESB_VERTEX, streamSize);
+	smgr->addCameraSceneNode(0, core::vector3df(0,0,-50), core::vector3df(0,0,0));
+
+	scene::IParticleSystemSceneNode* ps = smgr->addParticleSystemSceneNode(false);
+	scene::IParticleEmitter* emitter = ps->createBoxEmitter(core::aabbox3df(-5,-5,-5,5,5,5),
+		core::vector3df(0,0.01f,0), 100, 100);
+	ps->setEmitter(emitter);
+	emitter->drop();
+
+	s32 streamed = 0;
+	for (u32 frame=0; frame<5; ++frame)
+	{
+		device->getTimer()->setTime(1000 + frame*100);
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+		smgr->drawAll();
+		driver->endScene();
+		streamed = getStat(driver, "StreamedBytes");
+	}
+
+	bool result = streamed > 0 && (streamed % (4*sizeof(video::S3DVertex))) == 0;
+	if (!result)
+		logTestString("Particles streamed %d bytes\n", streamed);
+
+	// fill the whole stream with garbage, the next frame starts at its beginning
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	video::SStreamAllocation garbage = driver->allocateStream(video::ESB_VERTEX, streamSize);
+	if (garbage.Data)
+		memset(garbage.Data, 0x7f, streamSize);
+	driver->endScene();
+
+	// the particles are allocated directly behind the marker
+	device->getTimer()->setTime(1500);
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	const video::SStreamAllocation marker = driver->allocateStream(video::ESB_VERTEX, sizeof(video::S3DVertex));
+	smgr->drawAll();
+	driver->endScene();
+
+	streamed = getStat(driver, "StreamedBytes") - (s32)sizeof(video::S3DVertex);
+	result &= marker.Data && streamed > 0;
+	if (result)
+	{
+		const video::S3DVertex* v = reinterpret_cast<const video::S3DVertex*>(
+			static_cast<const u8*>(marker.Data) + sizeof(video::S3DVertex));
+		const u32 quads = streamed / (4*sizeof(video::S3DVertex));
+		const vector2df tcoords[4] = { vector2df(0,0), vector2df(0,1), vector2df(1,1), vector2df(1,0) };
+
+		for (u32 i=0; i<quads*4; ++i)
+		{
+			const bool valid = v[i].TCoords == tcoords[i%4] &&
+				v[i].Normal == v[i-i%4].Normal && equals(v[i].Normal.getLength(), 1.f) &&
+				v[i].Pos.X > -10.f && v[i].Pos.X < 10.f;
+			if (!valid)
+			{
+				logTestString("Particle vertex %u has texture coordinates %f %f, normal %f %f %f, position %f %f %f\n",
+					i, v[i].TCoords.X, v[i].TCoords.Y, v[i].Normal.X, v[i].Normal.Y, v[i].Normal.Z,
+					v[i].Pos.X, v[i].Pos.Y, v[i].Pos.Z);
+				result = false;
+				break;
+			}
+		}
+	}
+	else
+		logTestString("Particles streamed %d bytes behind the marker\n", streamed);
+
+	smgr->clear();
+
+	assert_log( result );
+
+	return result;
+}
+
+// Test the streaming buffer emulation of the null driver
+bool streamBuffer(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	if (!device)
+		return true;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	bool result = true;
+	result &= testAllocation(driver);
+	result &= testRing(driver);
+	result &= testParticles(device);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
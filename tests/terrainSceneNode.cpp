@@ -117,12 +117,188 @@ bool terrainGaps()
 	return result;
 }
 
+// incremental index updates have to end up with the same indices as immediate ones
+bool terrainIncrementalUpdate()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2d<u32>(160, 120));
+	if (!device)
+		return true;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	scene::ITerrainSceneNode* terrains[2];
+	for (u32 i = 0; i < 2; ++i)
+	{
+		terrains[i] = smgr->addTerrainSceneNode("../media/terrain-heightmap.bmp");
+		terrains[i]->setScale(core::vector3df(40.f, .1f, 40.f));
+	}
+	terrains[1]->setIncrementalIndexUpdate(16);
+
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode();
+	camera->setPosition(terrains[0]->getBoundingBox().getCenter() + vector3df(0.f, 100.f, 0.f));
+	camera->setTarget(terrains[0]->getBoundingBox().MaxEdge);
+	camera->setFarValue(20000.f);
+
+	// the first update of the incremental node is finished after some frames
+	bool result = true;
+	for (u32 frame = 0; frame < 30; ++frame)
+	{
+		device->run();
+		smgr->drawAll();
+		if (frame == 0)
+			result &= terrains[0]->getIndexCount() != 0 && terrains[1]->getIndexCount() == 0;
+	}
+
+	result &= terrains[0]->getIndexCount() == terrains[1]->getIndexCount();
+
+	const scene::IMeshBuffer* mb0 = terrains[0]->getRenderBuffer();
+	const scene::IMeshBuffer* mb1 = terrains[1]->getRenderBuffer();
+	result &= mb0->getIndexType() == mb1->getIndexType();
+	if (result)
+	{
+		const u32 size = terrains[0]->getIndexCount() * (mb0->getIndexType() == video::EIT_32BIT ? 4 : 2);
+		result &= memcmp(mb0->getIndices(), mb1->getIndices(), size) == 0;
+	}
+
+	if (!result)
+		logTestString("Incremental terrain index update differs from immediate update.\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+// writes 17x17 images named <prefix><x>_<z>.bmp
+void writeTileImages(video::IVideoDriver* driver, const io::path& prefix, s32 countX, s32 countZ)
+{
+	for (s32 z = 0; z < countZ; ++z)
+	{
+		for (s32 x = 0; x < countX; ++x)
+		{
+			video::IImage* image = driver->createImage(video::ECF_R8G8B8, dimension2du(17, 17));
+			image->fill(video::SColor(255, x*20, x*20, z*20));
+			io::path name(prefix);
+			name += x;
+			name += "_";
+			name += z;
+			name += ".bmp";
+			driver->writeImageToFile(image, name);
+			image->drop();
+		}
+	}
+}
+
+// tiles are loaded around the camera and removed when it moves away
+bool terrainTiles()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2d<u32>(160, 120));
+	if (!device)
+		return true;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	// 4x4 tiles, only the first three rows exist
+	writeTileImages(driver, "results/terrainTile_", 4, 3);
+
+	scene::ITiledTerrainSceneNode* terrain = smgr->addTiledTerrainSceneNode(
+		"results/terrainTile_{x}_{z}.bmp", "", 4, 4, 17, 0, -1,
+		vector3df(0.f, 0.f, 0.f), vector3df(10.f, 1.f, 10.f), 4, scene::ETPS_17);
+
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode();
+	camera->setPosition(vector3df(80.f, 100.f, 80.f));
+
+	// one tile per frame, the camera tile first
+	bool result = true;
+	device->run();
+	smgr->drawAll();
+	result &= terrain->getResidentTileCount() == 1 && terrain->getTile(0, 0) != 0;
+
+	for (u32 i = 0; i < 5; ++i)
+		smgr->drawAll();
+	result &= terrain->getResidentTileCount() == 4 && terrain->getResidentMemory() != 0;
+	result &= equals(terrain->getHeight(85.f, 85.f), 0.f);
+
+	// tile (1,1) is still near enough to be kept, row 3 doesn't exist
+	camera->setPosition(vector3df(500.f, 100.f, 500.f));
+	terrain->loadTilesAround(camera->getPosition());
+	result &= terrain->getResidentTileCount() == 3 && !terrain->getTile(0, 0) &&
+		terrain->getTile(1, 1) && terrain->getTile(3, 2) && !terrain->getTile(3, 3);
+
+	// going back removes tile (3,2), but the budget is too small for another tile
+	const u32 budget = terrain->getResidentMemory() / 3 * 2;
+	terrain->setMemoryBudget(budget);
+	camera->setPosition(vector3df(80.f, 100.f, 80.f));
+	smgr->drawAll();
+	result &= terrain->getResidentMemory() == budget && !terrain->getTile(0, 0);
+
+	if (!result)
+		logTestString("Tiled terrain did not load or remove the expected tiles.\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+// textures loaded for tiles are removed from the driver cache with their tile
+bool terrainTileTextures()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2d<u32>(160, 120));
+	if (!device)
+		return true;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	writeTileImages(driver, "results/terrainTextureTile_", 3, 1);
+	writeTileImages(driver, "results/terrainTileTexture_", 3, 1);
+
+	// the texture of tile (2,0) is used by the application as well
+	video::ITexture* used = driver->getTexture("results/terrainTileTexture_2_0.bmp");
+	const u32 textureCount = driver->getTextureCount();
+
+	scene::ITiledTerrainSceneNode* terrain = smgr->addTiledTerrainSceneNode(
+		"results/terrainTextureTile_{x}_{z}.bmp", "results/terrainTileTexture_{x}_{z}.bmp", 3, 1, 17, 0, -1,
+		vector3df(0.f, 0.f, 0.f), vector3df(10.f, 1.f, 10.f), 4, scene::ETPS_17);
+	terrain->setLoadRadius(0);
+
+	terrain->loadTilesAround(vector3df(80.f, 0.f, 80.f));
+	bool result = terrain->getResidentTileCount() == 1 && driver->getTextureCount() == textureCount + 1;
+
+	// tile (0,0) is paged out together with its texture
+	terrain->loadTilesAround(vector3df(400.f, 0.f, 80.f));
+	result &= terrain->getResidentTileCount() == 1 && terrain->getTile(2, 0) != 0;
+	result &= driver->getTextureCount() == textureCount;
+	io::IFileSystem* fs = device->getFileSystem();
+	result &= !driver->findTexture(fs->getAbsolutePath("results/terrainTileTexture_0_0.bmp"));
+
+	// the texture of the application stays
+	terrain->loadTilesAround(vector3df(80.f, 0.f, 80.f));
+	result &= terrain->getResidentTileCount() == 1 && terrain->getTile(0, 0) != 0;
+	result &= driver->getTextureCount() == textureCount + 1;
+	result &= used && driver->findTexture(fs->getAbsolutePath("results/terrainTileTexture_2_0.bmp")) == used;
+
+	if (!result)
+		logTestString("Tiled terrain did not free the expected textures, %u of %u left.\n",
+			driver->getTextureCount(), textureCount);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
 }
 
 bool terrainSceneNode()
 {
 	bool result = terrainRecalc();
 	result &= terrainGaps();
+	result &= terrainIncrementalUpdate();
+	result &= terrainTiles();
+	result &= terrainTileTextures();
 	return result;
 }
 
@@ -148,6 +148,63 @@ bool attributeValues(irr::io::IFileSystem * fs)
 	return result;
 }
 
+// Special characters are replaced in place when values are requested.
+// Names and values must stay intact until the next read(), also when text nodes follow.
+bool specialCharacters(irr::io::IFileSystem * fs)
+{
+	const c8 xml[] = "<root a=\"x&amp;y\" b=\"&lt;&gt;&quot;&apos;\" c=\"&\" f=\"-1.5\">"
+		"one &amp; two<e/>&lt;three&gt;</root>";
+
+	io::IReadFile* file = fs->createMemoryReadFile(xml, sizeof(xml)-1, "special.xml");
+	io::IXMLReaderUTF8* reader = fs->createXMLReaderUTF8(file);
+	file->drop();
+	if (!reader)
+	{
+		logTestString("Could not create XML reader.\n");
+		return false;
+	}
+
+	core::array< core::stringc > texts;
+	bool result = true;
+	while (reader->read())
+	{
+		if (reader->getNodeType() == io::EXN_ELEMENT && core::stringc("root") == reader->getNodeName())
+		{
+			// request twice to make sure nothing gets replaced a second time
+			for ( u32 i=0; i<2; ++i )
+			{
+				result &= core::stringc("x&y") == reader->getAttributeValue("a");
+				result &= core::stringc("<>\"'") == reader->getAttributeValue(1);
+				result &= core::stringc("&") == reader->getAttributeValueSafe("c");
+				result &= core::equals(reader->getAttributeValueAsFloat("f"), -1.5f);
+				result &= reader->getAttributeValueAsInt(3) == -1;
+			}
+			result &= core::stringc("root") == reader->getNodeName();
+		}
+		else if (reader->getNodeType() == io::EXN_TEXT)
+		{
+			texts.push_back(reader->getNodeData());
+		}
+		else if (reader->getNodeType() == io::EXN_ELEMENT_END)
+		{
+			result &= core::stringc("root") == reader->getNodeName();
+		}
+	}
+	reader->drop();
+
+	result &= texts.size() == 2;
+	if ( result )
+	{
+		result &= texts[0] == "one & two";
+		result &= texts[1] == "<three>";
+	}
+
+	if ( !result )
+		logTestString("special characters not replaced correctly in %s:%d\n", __FILE__, __LINE__);
+
+	return result;
+}
+
 /** Tests for XML handling */
 bool testXML(void)
 {
@@ -161,6 +218,8 @@ bool testXML(void)
 	result &= cdata(device->getFileSystem());
 	logTestString("Test XML reader attribute support.\n");
 	result &= attributeValues(device->getFileSystem());	
+	logTestString("Test XML reader special characters.\n");
+	result &= specialCharacters(device->getFileSystem());
 
 	device->closeDevice();
 	device->run();
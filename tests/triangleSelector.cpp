@@ -284,6 +284,155 @@ bool triangle()
 
 	return result;
 }
+
+//! Tests that a selector of an animated node follows the animation
+bool animatedSelector()
+{
+	IrrlichtDevice *device = createDevice(video::EDT_NULL);
+	if (!device)
+		return true;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	scene::IAnimatedMeshSceneNode* ninja = smgr->addAnimatedMeshSceneNode(smgr->getMesh("../media/ninja.b3d"));
+	if (!ninja)
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+	ninja->setAnimationSpeed(0.f);
+
+	bool result = true;
+	scene::ITriangleSelector* selector = smgr->createTriangleSelector(ninja, true);
+	const s32 count = selector->getTriangleCount();
+	core::array<core::triangle3df> triangles(count);
+	triangles.set_used(count);
+	core::array<core::triangle3df> expected(count);
+	expected.set_used(count);
+
+	const f32 frames[] = { 0.f, 10.f, 11.f, 40.f, 3.f };
+	for (u32 f=0; f<sizeof(frames)/sizeof(frames[0]); ++f)
+	{
+		ninja->setCurrentFrame(frames[f]);
+		// the node skins its mesh when it is animated, selectors use the skinned vertices
+		ninja->OnAnimate(1000 + f*100);
+
+		// a new selector gets all triangles of the current frame
+		scene::ITriangleSelector* fresh = smgr->createTriangleSelector(ninja, true);
+		s32 expectedCount = 0;
+		fresh->getTriangles(expected.pointer(), count, expectedCount, 0, false, 0);
+		fresh->drop();
+
+		s32 found = 0;
+		selector->getTriangles(triangles.pointer(), count, found, 0, false, 0);
+		result &= found == expectedCount;
+		for (s32 i=0; i<found && result; ++i)
+			result &= triangles[i].pointA.equals(expected[i].pointA)
+				&& triangles[i].pointB.equals(expected[i].pointB)
+				&& triangles[i].pointC.equals(expected[i].pointC);
+
+		// box queries have to return the same triangles as checking each one
+		const core::aabbox3df box(-2.f, 0.f, -2.f, 2.f, 3.f, 2.f);
+		s32 inside = 0;
+		for (s32 i=0; i<expectedCount; ++i)
+			if (!expected[i].isTotalOutsideBox(box))
+				++inside;
+
+		core::array<scene::SCollisionTriangleRange> ranges;
+		selector->getTriangles(triangles.pointer(), count, found, box, 0, false, &ranges);
+		result &= found == inside;
+
+		s32 rangeTriangles = 0;
+		for (u32 i=0; i<ranges.size(); ++i)
+			rangeTriangles += ranges[i].RangeSize;
+		result &= rangeTriangles == found;
+		for (s32 i=0; i<found; ++i)
+			result &= !triangles[i].isTotalOutsideBox(box);
+
+		if (!result)
+		{
+			logTestString("Animated selector differs at frame %f\n", frames[f]);
+			break;
+		}
+	}
+
+	// queries don't animate the node again, the triangles change once the node is animated
+	if (result)
+	{
+		ninja->setCurrentFrame(40.f);
+		s32 found = 0;
+		selector->getTriangles(triangles.pointer(), count, found, 0, false, 0);
+		bool unchanged = true;
+		for (s32 i=0; i<found && unchanged; ++i)
+			unchanged = triangles[i].pointA.equals(expected[i].pointA);
+		result &= unchanged;
+
+		ninja->OnAnimate(2000);
+		selector->getTriangles(triangles.pointer(), count, found, 0, false, 0);
+		bool moved = false;
+		for (s32 i=0; i<found && !moved; ++i)
+			moved = !triangles[i].pointA.equals(expected[i].pointA);
+		result &= moved;
+
+		if (!result)
+			logTestString("Animated selector did not use the vertices of the animated node\n");
+	}
+
+	selector->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+//! Tests the box of a terrain selector with and without the node transformation
+bool terrainSelectorBox()
+{
+	IrrlichtDevice *device = createDevice(video::EDT_NULL);
+	if (!device)
+		return true;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	scene::ITerrainSceneNode* terrain = smgr->addTerrainSceneNode("../media/terrain-heightmap.bmp", 0, -1,
+		core::vector3df(100.f, -20.f, 50.f), core::vector3df(0,0,0), core::vector3df(2.f, 0.5f, 3.f));
+	if (!terrain)
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	scene::ITriangleSelector* selector = smgr->createTerrainTriangleSelector(terrain);
+
+	// the vertices of the terrain are already transformed
+	core::aabbox3df world;
+	bool result = selector->getBoundingBox(world, true);
+	result &= world.MinEdge.equals(terrain->getBoundingBox().MinEdge) &&
+		world.MaxEdge.equals(terrain->getBoundingBox().MaxEdge);
+
+	// without rotation only position and scale have to be undone
+	core::aabbox3df box;
+	result &= selector->getBoundingBox(box, false);
+	const core::vector3df minEdge = (world.MinEdge - core::vector3df(100.f, -20.f, 50.f)) / core::vector3df(2.f, 0.5f, 3.f);
+	const core::vector3df maxEdge = (world.MaxEdge - core::vector3df(100.f, -20.f, 50.f)) / core::vector3df(2.f, 0.5f, 3.f);
+	result &= box.MinEdge.equals(minEdge, 0.01f) && box.MaxEdge.equals(maxEdge, 0.01f);
+	result &= core::equals(box.MinEdge.X, 0.f, 0.01f) && core::equals(box.MinEdge.Z, 0.f, 0.01f);
+	if (!result)
+		logTestString("Terrain selector box without node transformation %f %f %f - %f %f %f\n",
+			box.MinEdge.X, box.MinEdge.Y, box.MinEdge.Z, box.MaxEdge.X, box.MaxEdge.Y, box.MaxEdge.Z);
+
+	selector->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
 }
 
 // Tests need not be accurate, as we just need to include at least
@@ -295,6 +444,8 @@ bool triangleSelector(void)
 
 	result &= octree();
 	result &= triangle();
+	result &= animatedSelector();
+	result &= terrainSelectorBox();
 
 	return result;
 }